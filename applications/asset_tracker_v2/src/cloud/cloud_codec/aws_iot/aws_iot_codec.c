@@ -16,6 +16,7 @@
 #include "json_helpers.h"
 #include "json_common.h"
 #include "json_protocol_names.h"
+#include "compact_batch.h"
 
 #include <zephyr/logging/log.h>
 LOG_MODULE_REGISTER(cloud_codec, CONFIG_CLOUD_CODEC_LOG_LEVEL);
@@ -544,6 +545,13 @@ int cloud_codec_encode_batch_data(struct cloud_codec_data *output,
 	char *buffer;
 	bool object_added = false;
 
+	if (IS_ENABLED(CONFIG_CLOUD_CODEC_COMPACT_BATCH)) {
+		return compact_batch_cloud_codec_encode(output, gnss_buf, sensor_buf, ui_buf,
+							impact_buf, bat_buf, gnss_buf_count,
+							sensor_buf_count, ui_buf_count,
+							impact_buf_count, bat_buf_count);
+	}
+
 	cJSON *root_obj = cJSON_CreateObject();
 
 	if (root_obj == NULL) {
@@ -15,6 +15,7 @@
 #include <cJSON_os.h>
 #include <zephyr/net/net_ip.h>
 #include <modem/lte_lc.h>
+#include <date_time.h>
 #if defined(CONFIG_LOCATION)
 #include <modem/location.h>
 #endif
@@ -43,6 +44,45 @@ extern "C" {
  */
 #define CLOUD_GNSS_HEADING_ACC_LIMIT (float)60.0
 
+/** Timestamps at or above this value (2020-01-01) are already in UNIX time. This is the case for
+ *  samples read back from the persistent data store. An uptime in milliseconds never gets there.
+ */
+#define CLOUD_CODEC_UNIX_TIME_MIN_MS 1577836800000LL
+
+/**
+ * @brief Convert a sample timestamp from uptime to UNIX time in milliseconds.
+ *
+ * Timestamps that are already in UNIX time are left as they are.
+ *
+ * @param[in, out] ts Pointer to the timestamp.
+ *
+ * @return 0 on success, otherwise a negative error code from
+ *         date_time_uptime_to_unix_time_ms().
+ */
+static inline int cloud_codec_ts_to_unix_time_ms(int64_t *ts)
+{
+	if (*ts >= CLOUD_CODEC_UNIX_TIME_MIN_MS) {
+		return 0;
+	}
+
+	return date_time_uptime_to_unix_time_ms(ts);
+}
+
+/**
+ * @brief Scale a floating point value to an integer, rounding half away from zero.
+ *
+ * @param[in] value Value to scale.
+ * @param[in] factor Scale factor.
+ *
+ * @return Scaled value.
+ */
+static inline int64_t cloud_codec_scaled(double value, double factor)
+{
+	value *= factor;
+
+	return (int64_t)(value < 0 ? value - 0.5 : value + 0.5);
+}
+
 /** @brief Structure containing battery data published to cloud. */
 struct cloud_data_battery {
 	/** Battery fuel gauge percentage. */
@@ -0,0 +1,663 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+
+#include "cloud_codec.h"
+#include "compact_batch.h"
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(compact_batch, CONFIG_CLOUD_CODEC_LOG_LEVEL);
+
+/* CBOR major types used by the format. */
+#define CBOR_MAJOR_UINT		0
+#define CBOR_MAJOR_BSTR		2
+#define CBOR_MAJOR_ARRAY	4
+
+/* Number of items in the top level array. */
+#define ARRAY_ITEMS		7
+
+/* Maximum length of a CBOR head and of a LEB128 varint holding 64 bits. */
+#define CBOR_HEAD_LEN_MAX	9
+#define VARINT_LEN_MAX		10
+
+enum section {
+	SECTION_GNSS,
+	SECTION_SENSORS,
+	SECTION_UI,
+	SECTION_IMPACT,
+	SECTION_BATTERY,
+	SECTION_COUNT,
+};
+
+/* Maximum number of fields in a sample, including the timestamp. */
+#define FIELDS_MAX		7
+
+static const uint8_t section_fields[SECTION_COUNT] = {
+	[SECTION_GNSS] = 7,
+	[SECTION_SENSORS] = 5,
+	[SECTION_UI] = 2,
+	[SECTION_IMPACT] = 2,
+	[SECTION_BATTERY] = 2,
+};
+
+/* Output buffer. Writes past the end are only counted, so that a writer without a buffer
+ * can be used to get the length of an encoding.
+ */
+struct writer {
+	uint8_t *buf;
+	size_t size;
+	size_t len;
+};
+
+struct reader {
+	const uint8_t *buf;
+	size_t len;
+	size_t pos;
+};
+
+static size_t *section_count(struct compact_batch *batch, enum section section)
+{
+	switch (section) {
+	case SECTION_GNSS:
+		return &batch->gnss_count;
+	case SECTION_SENSORS:
+		return &batch->sensors_count;
+	case SECTION_UI:
+		return &batch->ui_count;
+	case SECTION_IMPACT:
+		return &batch->impact_count;
+	case SECTION_BATTERY:
+		return &batch->bat_count;
+	default:
+		__ASSERT_NO_MSG(false);
+		return NULL;
+	}
+}
+
+static int64_t *sample_ts(struct compact_batch *batch, enum section section, size_t i)
+{
+	switch (section) {
+	case SECTION_GNSS:
+		return &batch->gnss[i].gnss_ts;
+	case SECTION_SENSORS:
+		return &batch->sensors[i].env_ts;
+	case SECTION_UI:
+		return &batch->ui[i].btn_ts;
+	case SECTION_IMPACT:
+		return &batch->impact[i].ts;
+	case SECTION_BATTERY:
+		return &batch->bat[i].bat_ts;
+	default:
+		__ASSERT_NO_MSG(false);
+		return NULL;
+	}
+}
+
+static bool sample_queued(const struct compact_batch *batch, enum section section, size_t i)
+{
+	switch (section) {
+	case SECTION_GNSS:
+		return batch->gnss[i].queued;
+	case SECTION_SENSORS:
+		return batch->sensors[i].queued;
+	case SECTION_UI:
+		return batch->ui[i].queued;
+	case SECTION_IMPACT:
+		return batch->impact[i].queued;
+	case SECTION_BATTERY:
+		return batch->bat[i].queued;
+	default:
+		return false;
+	}
+}
+
+static void sample_dequeue(struct compact_batch *batch, enum section section, size_t i)
+{
+	switch (section) {
+	case SECTION_GNSS:
+		batch->gnss[i].queued = false;
+		break;
+	case SECTION_SENSORS:
+		batch->sensors[i].queued = false;
+		break;
+	case SECTION_UI:
+		batch->ui[i].queued = false;
+		break;
+	case SECTION_IMPACT:
+		batch->impact[i].queued = false;
+		break;
+	case SECTION_BATTERY:
+		batch->bat[i].queued = false;
+		break;
+	default:
+		break;
+	}
+}
+
+/* Get the scaled fields of a sample, in the order of the format. */
+static void sample_fields_get(const struct compact_batch *batch, enum section section, size_t i,
+			      int64_t *fields)
+{
+	switch (section) {
+	case SECTION_GNSS: {
+		const struct cloud_data_gnss *gnss = &batch->gnss[i];
+
+		fields[0] = gnss->gnss_ts;
+		fields[1] = cloud_codec_scaled(gnss->pvt.lat, 1e7);
+		fields[2] = cloud_codec_scaled(gnss->pvt.lon, 1e7);
+		fields[3] = cloud_codec_scaled(gnss->pvt.alt, 10);
+		fields[4] = cloud_codec_scaled(gnss->pvt.acc, 10);
+		fields[5] = cloud_codec_scaled(gnss->pvt.spd, 100);
+		fields[6] = cloud_codec_scaled(gnss->pvt.hdg, 10);
+		break;
+	}
+	case SECTION_SENSORS: {
+		const struct cloud_data_sensors *sensors = &batch->sensors[i];
+
+		fields[0] = sensors->env_ts;
+		fields[1] = cloud_codec_scaled(sensors->temperature, 100);
+		fields[2] = cloud_codec_scaled(sensors->humidity, 100);
+		/* Kilopascal to pascal. */
+		fields[3] = cloud_codec_scaled(sensors->pressure, 1000);
+		fields[4] = sensors->bsec_air_quality;
+		break;
+	}
+	case SECTION_UI:
+		fields[0] = batch->ui[i].btn_ts;
+		fields[1] = batch->ui[i].btn;
+		break;
+	case SECTION_IMPACT:
+		fields[0] = batch->impact[i].ts;
+		fields[1] = cloud_codec_scaled(batch->impact[i].magnitude, 100);
+		break;
+	case SECTION_BATTERY:
+		fields[0] = batch->bat[i].bat_ts;
+		fields[1] = batch->bat[i].bat;
+		break;
+	default:
+		break;
+	}
+}
+
+static void sample_fields_set(struct compact_batch *batch, enum section section, size_t i,
+			      const int64_t *fields)
+{
+	switch (section) {
+	case SECTION_GNSS: {
+		struct cloud_data_gnss *gnss = &batch->gnss[i];
+
+		*gnss = (struct cloud_data_gnss) {
+			.gnss_ts = fields[0],
+			.pvt = {
+				.lat = fields[1] / 1e7,
+				.lon = fields[2] / 1e7,
+				.alt = fields[3] / 10.0f,
+				.acc = fields[4] / 10.0f,
+				.spd = fields[5] / 100.0f,
+				.hdg = fields[6] / 10.0f,
+			},
+			.queued = true,
+		};
+		break;
+	}
+	case SECTION_SENSORS:
+		batch->sensors[i] = (struct cloud_data_sensors) {
+			.env_ts = fields[0],
+			.temperature = fields[1] / 100.0,
+			.humidity = fields[2] / 100.0,
+			.pressure = fields[3] / 1000.0,
+			.bsec_air_quality = fields[4],
+			.queued = true,
+		};
+		break;
+	case SECTION_UI:
+		batch->ui[i] = (struct cloud_data_ui) {
+			.btn_ts = fields[0],
+			.btn = fields[1],
+			.queued = true,
+		};
+		break;
+	case SECTION_IMPACT:
+		batch->impact[i] = (struct cloud_data_impact) {
+			.ts = fields[0],
+			.magnitude = fields[1] / 100.0,
+			.queued = true,
+		};
+		break;
+	case SECTION_BATTERY:
+		batch->bat[i] = (struct cloud_data_battery) {
+			.bat_ts = fields[0],
+			.bat = fields[1],
+			.queued = true,
+		};
+		break;
+	default:
+		break;
+	}
+}
+
+static void byte_put(struct writer *w, uint8_t byte)
+{
+	if (w->len < w->size) {
+		w->buf[w->len] = byte;
+	}
+
+	w->len++;
+}
+
+static void cbor_head_put(struct writer *w, uint8_t major, uint64_t value)
+{
+	int len;
+
+	if (value < 24) {
+		byte_put(w, (major << 5) | value);
+		return;
+	} else if (value <= UINT8_MAX) {
+		byte_put(w, (major << 5) | 24);
+		len = 1;
+	} else if (value <= UINT16_MAX) {
+		byte_put(w, (major << 5) | 25);
+		len = 2;
+	} else if (value <= UINT32_MAX) {
+		byte_put(w, (major << 5) | 26);
+		len = 4;
+	} else {
+		byte_put(w, (major << 5) | 27);
+		len = 8;
+	}
+
+	while (len--) {
+		byte_put(w, value >> (8 * len));
+	}
+}
+
+static void uvarint_put(struct writer *w, uint64_t value)
+{
+	while (value >= 0x80) {
+		byte_put(w, (value & 0x7f) | 0x80);
+		value >>= 7;
+	}
+
+	byte_put(w, value);
+}
+
+static void svarint_put(struct writer *w, int64_t value)
+{
+	/* Zigzag encoding maps small negative and positive values to small unsigned values. */
+	uvarint_put(w, ((uint64_t)value << 1) ^ (uint64_t)(value >> 63));
+}
+
+static void section_encode(struct writer *w, struct compact_batch *batch,
+			   enum section section, size_t count, int64_t base_ts)
+{
+	size_t size = *section_count(batch, section);
+	int64_t prev[FIELDS_MAX] = { base_ts };
+	int64_t fields[FIELDS_MAX];
+
+	uvarint_put(w, count);
+
+	for (size_t i = 0; i < size; i++) {
+		if (!sample_queued(batch, section, i)) {
+			continue;
+		}
+
+		sample_fields_get(batch, section, i, fields);
+
+		for (size_t k = 0; k < section_fields[section]; k++) {
+			svarint_put(w, fields[k] - prev[k]);
+			prev[k] = fields[k];
+		}
+	}
+}
+
+size_t compact_batch_size_max(const struct compact_batch *batch)
+{
+	const size_t counts[SECTION_COUNT] = {
+		[SECTION_GNSS] = batch->gnss_count,
+		[SECTION_SENSORS] = batch->sensors_count,
+		[SECTION_UI] = batch->ui_count,
+		[SECTION_IMPACT] = batch->impact_count,
+		[SECTION_BATTERY] = batch->bat_count,
+	};
+	size_t size = 3 * CBOR_HEAD_LEN_MAX;
+
+	for (enum section section = 0; section < SECTION_COUNT; section++) {
+		size += CBOR_HEAD_LEN_MAX + VARINT_LEN_MAX +
+			counts[section] * section_fields[section] * VARINT_LEN_MAX;
+	}
+
+	return size;
+}
+
+int compact_batch_encode(struct compact_batch *batch, uint8_t *buf, size_t buf_size,
+			 size_t *len)
+{
+	struct writer w = { .buf = buf, .size = buf_size };
+	size_t queued[SECTION_COUNT] = { 0 };
+	size_t total = 0;
+	int64_t base_ts = INT64_MAX;
+	int err;
+
+	for (enum section section = 0; section < SECTION_COUNT; section++) {
+		size_t count = *section_count(batch, section);
+
+		for (size_t i = 0; i < count; i++) {
+			int64_t *ts = sample_ts(batch, section, i);
+
+			if (!sample_queued(batch, section, i)) {
+				continue;
+			}
+
+			err = cloud_codec_ts_to_unix_time_ms(ts);
+			if (err) {
+				LOG_ERR("cloud_codec_ts_to_unix_time_ms, error: %d", err);
+				return err;
+			}
+
+			base_ts = MIN(base_ts, *ts);
+			queued[section]++;
+			total++;
+		}
+	}
+
+	if (total == 0) {
+		return -ENODATA;
+	}
+
+	cbor_head_put(&w, CBOR_MAJOR_ARRAY, ARRAY_ITEMS);
+	cbor_head_put(&w, CBOR_MAJOR_UINT, COMPACT_BATCH_VERSION);
+	cbor_head_put(&w, CBOR_MAJOR_UINT, base_ts);
+
+	for (enum section section = 0; section < SECTION_COUNT; section++) {
+		struct writer length = { 0 };
+
+		if (queued[section] == 0) {
+			cbor_head_put(&w, CBOR_MAJOR_BSTR, 0);
+			continue;
+		}
+
+		/* A dry run gives the length of the byte string. */
+		section_encode(&length, batch, section, queued[section], base_ts);
+
+		cbor_head_put(&w, CBOR_MAJOR_BSTR, length.len);
+		section_encode(&w, batch, section, queued[section], base_ts);
+	}
+
+	if (w.len > buf_size) {
+		return -ENOMEM;
+	}
+
+	for (enum section section = 0; section < SECTION_COUNT; section++) {
+		size_t count = *section_count(batch, section);
+
+		for (size_t i = 0; i < count; i++) {
+			sample_dequeue(batch, section, i);
+		}
+	}
+
+	*len = w.len;
+
+	return 0;
+}
+
+static int byte_get(struct reader *r, uint8_t *byte)
+{
+	if (r->pos >= r->len) {
+		return -EBADMSG;
+	}
+
+	*byte = r->buf[r->pos++];
+
+	return 0;
+}
+
+static int cbor_head_get(struct reader *r, uint8_t major, uint64_t *value)
+{
+	uint8_t initial;
+	uint8_t byte;
+	int len;
+	int err;
+
+	err = byte_get(r, &initial);
+	if (err) {
+		return err;
+	}
+
+	if ((initial >> 5) != major) {
+		return -EBADMSG;
+	}
+
+	switch (initial & 0x1f) {
+	case 24:
+		len = 1;
+		break;
+	case 25:
+		len = 2;
+		break;
+	case 26:
+		len = 4;
+		break;
+	case 27:
+		len = 8;
+		break;
+	default:
+		if ((initial & 0x1f) >= 24) {
+			return -EBADMSG;
+		}
+
+		*value = initial & 0x1f;
+		return 0;
+	}
+
+	*value = 0;
+
+	while (len--) {
+		err = byte_get(r, &byte);
+		if (err) {
+			return err;
+		}
+
+		*value = (*value << 8) | byte;
+	}
+
+	return 0;
+}
+
+static int uvarint_get(struct reader *r, uint64_t *value)
+{
+	uint8_t byte;
+	int err;
+
+	*value = 0;
+
+	for (int shift = 0; shift < 64; shift += 7) {
+		err = byte_get(r, &byte);
+		if (err) {
+			return err;
+		}
+
+		*value |= (uint64_t)(byte & 0x7f) << shift;
+
+		if (!(byte & 0x80)) {
+			return 0;
+		}
+	}
+
+	return -EBADMSG;
+}
+
+static int svarint_get(struct reader *r, int64_t *value)
+{
+	uint64_t zigzag;
+	int err;
+
+	err = uvarint_get(r, &zigzag);
+	if (err) {
+		return err;
+	}
+
+	*value = (int64_t)(zigzag >> 1) ^ -(int64_t)(zigzag & 1);
+
+	return 0;
+}
+
+static int section_decode(struct reader *r, struct compact_batch *batch, enum section section,
+			  int64_t base_ts)
+{
+	size_t *capacity = section_count(batch, section);
+	int64_t fields[FIELDS_MAX] = { base_ts };
+	struct reader sub;
+	uint64_t len;
+	uint64_t count;
+	int64_t delta;
+	int err;
+
+	err = cbor_head_get(r, CBOR_MAJOR_BSTR, &len);
+	if (err) {
+		return err;
+	}
+
+	if (len > r->len - r->pos) {
+		return -EBADMSG;
+	}
+
+	sub = (struct reader) { .buf = &r->buf[r->pos], .len = len };
+	r->pos += len;
+
+	if (len == 0) {
+		*capacity = 0;
+		return 0;
+	}
+
+	err = uvarint_get(&sub, &count);
+	if (err) {
+		return err;
+	}
+
+	if (count > *capacity) {
+		return -ENOMEM;
+	}
+
+	for (size_t i = 0; i < count; i++) {
+		for (size_t k = 0; k < section_fields[section]; k++) {
+			err = svarint_get(&sub, &delta);
+			if (err) {
+				return err;
+			}
+
+			fields[k] += delta;
+		}
+
+		sample_fields_set(batch, section, i, fields);
+	}
+
+	if (sub.pos != sub.len) {
+		return -EBADMSG;
+	}
+
+	*capacity = count;
+
+	return 0;
+}
+
+int compact_batch_decode(const uint8_t *buf, size_t len, struct compact_batch *batch)
+{
+	struct reader r = { .buf = buf, .len = len };
+	uint64_t items;
+	uint64_t version;
+	uint64_t base_ts;
+	int err;
+
+	err = cbor_head_get(&r, CBOR_MAJOR_ARRAY, &items);
+	if (err) {
+		return err;
+	}
+
+	err = cbor_head_get(&r, CBOR_MAJOR_UINT, &version);
+	if (err) {
+		return err;
+	}
+
+	if (version != COMPACT_BATCH_VERSION) {
+		return -ENOTSUP;
+	}
+
+	if (items != ARRAY_ITEMS) {
+		return -EBADMSG;
+	}
+
+	err = cbor_head_get(&r, CBOR_MAJOR_UINT, &base_ts);
+	if (err) {
+		return err;
+	}
+
+	for (enum section section = 0; section < SECTION_COUNT; section++) {
+		err = section_decode(&r, batch, section, base_ts);
+		if (err) {
+			return err;
+		}
+	}
+
+	if (r.pos != r.len) {
+		return -EBADMSG;
+	}
+
+	return 0;
+}
+
+int compact_batch_cloud_codec_encode(struct cloud_codec_data *output,
+				     struct cloud_data_gnss *gnss_buf,
+				     struct cloud_data_sensors *sensor_buf,
+				     struct cloud_data_ui *ui_buf,
+				     struct cloud_data_impact *impact_buf,
+				     struct cloud_data_battery *bat_buf,
+				     size_t gnss_buf_count,
+				     size_t sensor_buf_count,
+				     size_t ui_buf_count,
+				     size_t impact_buf_count,
+				     size_t bat_buf_count)
+{
+	struct compact_batch batch = {
+		.gnss = gnss_buf,
+		.sensors = sensor_buf,
+		.ui = ui_buf,
+		.impact = impact_buf,
+		.bat = bat_buf,
+		.gnss_count = gnss_buf_count,
+		.sensors_count = sensor_buf_count,
+		.ui_count = ui_buf_count,
+		.impact_count = impact_buf_count,
+		.bat_count = bat_buf_count,
+	};
+	size_t size = compact_batch_size_max(&batch);
+	size_t len;
+	uint8_t *buf;
+	int err;
+
+	buf = k_malloc(size);
+	if (buf == NULL) {
+		LOG_ERR("Failed to allocate memory for compact batch");
+		return -ENOMEM;
+	}
+
+	err = compact_batch_encode(&batch, buf, size, &len);
+	if (err) {
+		if (err != -ENODATA) {
+			LOG_ERR("compact_batch_encode, error: %d", err);
+		}
+
+		k_free(buf);
+		return err;
+	}
+
+	LOG_DBG("Encoded compact batch, %zu bytes", len);
+
+	output->buf = (char *)buf;
+	output->len = len;
+
+	return 0;
+}
@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/**@file
+ *
+ * @brief   Compact batch encoding of buffered samples.
+ *
+ * A compact batch is a CBOR array with a shared header followed by one byte string per
+ * data type:
+ *
+ *	[ version, base_ts, gnss, sensors, ui, impact, battery ]
+ *
+ * - version: Unsigned integer, COMPACT_BATCH_VERSION.
+ * - base_ts: Unsigned integer, the lowest timestamp in the batch. UNIX milliseconds.
+ * - gnss, sensors, ui, impact, battery: Byte strings, empty if there are no samples of the type.
+ *
+ * Each byte string holds an unsigned LEB128 varint with the number of samples, followed by the
+ * samples. Every field of a sample is encoded as the zigzag LEB128 varint of its difference to
+ * the same field of the previous sample of the type. For the first sample, the timestamp
+ * difference is taken to base_ts and the other fields to zero. Fields are scaled to integers
+ * and encoded in the following order:
+ *
+ * - GNSS: ts (ms), lat (1e-7 deg), lon (1e-7 deg), alt (dm), acc (dm), spd (cm/s), hdg (0.1 deg).
+ * - Sensors: ts (ms), temperature (0.01 C), humidity (0.01 %), pressure (Pa), air quality.
+ * - UI: ts (ms), button number.
+ * - Impact: ts (ms), magnitude (0.01 G).
+ * - Battery: ts (ms), battery level.
+ *
+ * Fields that are not listed, such as GNSS altitude and speed accuracy, are not encoded.
+ */
+
+#ifndef COMPACT_BATCH_H__
+#define COMPACT_BATCH_H__
+
+#include <zephyr/kernel.h>
+
+#include "cloud_codec.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Version of the compact batch format. */
+#define COMPACT_BATCH_VERSION 1
+
+/** @brief Sample buffers of a compact batch.
+ *
+ *  When encoding, the counts are the sizes of the buffers, and only queued entries are encoded.
+ *  When decoding, the counts are the capacities of the buffers on input, and the number of
+ *  decoded samples on output.
+ */
+struct compact_batch {
+	struct cloud_data_gnss *gnss;
+	struct cloud_data_sensors *sensors;
+	struct cloud_data_ui *ui;
+	struct cloud_data_impact *impact;
+	struct cloud_data_battery *bat;
+	size_t gnss_count;
+	size_t sensors_count;
+	size_t ui_count;
+	size_t impact_count;
+	size_t bat_count;
+};
+
+/** @brief Get the size of a buffer that is large enough for any encoding of a batch.
+ *
+ *  @param[in] batch Batch to encode.
+ *
+ *  @return Buffer size in bytes.
+ */
+size_t compact_batch_size_max(const struct compact_batch *batch);
+
+/** @brief Encode the queued samples of a batch.
+ *
+ *  Timestamps are converted to UNIX time in place, and the queued flag of each encoded sample is
+ *  cleared.
+ *
+ *  @param[in, out] batch Batch to encode.
+ *  @param[out] buf Buffer for the encoded batch.
+ *  @param[in] buf_size Size of buf.
+ *  @param[out] len Length of the encoded batch.
+ *
+ *  @return 0 on success. -ENODATA if no samples are queued, -ENOMEM if buf is too small,
+ *          otherwise a negative error code is returned.
+ */
+int compact_batch_encode(struct compact_batch *batch, uint8_t *buf, size_t buf_size,
+			 size_t *len);
+
+/** @brief Decode a compact batch.
+ *
+ *  Reference decoder for the compact batch format. Decoded samples are queued.
+ *
+ *  @param[in] buf Encoded batch.
+ *  @param[in] len Length of buf.
+ *  @param[in, out] batch Buffers to decode into.
+ *
+ *  @return 0 on success. -ENOMEM if a buffer is too small, -EBADMSG if the input is malformed,
+ *          -ENOTSUP if the format version is not supported.
+ */
+int compact_batch_decode(const uint8_t *buf, size_t len, struct compact_batch *batch);
+
+/** @brief Encode a batch in the format of cloud_codec_encode_batch_data().
+ *
+ *  Modem data is not part of the compact batch format and is left queued.
+ *  The output buffer is allocated with k_malloc().
+ *
+ *  @return 0 on success, -ENODATA if no samples are queued, otherwise a negative error code
+ *          is returned.
+ */
+int compact_batch_cloud_codec_encode(struct cloud_codec_data *output,
+				     struct cloud_data_gnss *gnss_buf,
+				     struct cloud_data_sensors *sensor_buf,
+				     struct cloud_data_ui *ui_buf,
+				     struct cloud_data_impact *impact_buf,
+				     struct cloud_data_battery *bat_buf,
+				     size_t gnss_buf_count,
+				     size_t sensor_buf_count,
+				     size_t ui_buf_count,
+				     size_t impact_buf_count,
+				     size_t bat_buf_count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* COMPACT_BATCH_H__ */
@@ -70,9 +70,9 @@ int json_common_modem_static_data_add(cJSON *parent,
 		return -ENODATA;
 	}
 
-	err = date_time_uptime_to_unix_time_ms(&data->ts);
+	err = cloud_codec_ts_to_unix_time_ms(&data->ts);
 	if (err) {
-		LOG_ERR("date_time_uptime_to_unix_time_ms, error: %d", err);
+		LOG_ERR("cloud_codec_ts_to_unix_time_ms, error: %d", err);
 		return err;
 	}
 
@@ -153,9 +153,9 @@ int json_common_modem_dynamic_data_add(cJSON *parent,
 		return -ENODATA;
 	}
 
-	err = date_time_uptime_to_unix_time_ms(&data->ts);
+	err = cloud_codec_ts_to_unix_time_ms(&data->ts);
 	if (err) {
-		LOG_ERR("date_time_uptime_to_unix_time_ms, error: %d", err);
+		LOG_ERR("cloud_codec_ts_to_unix_time_ms, error: %d", err);
 		return err;
 	}
 
@@ -258,9 +258,9 @@ int json_common_sensor_data_add(cJSON *parent,
 		return -ENODATA;
 	}
 
-	err = date_time_uptime_to_unix_time_ms(&data->env_ts);
+	err = cloud_codec_ts_to_unix_time_ms(&data->env_ts);
 	if (err) {
-		LOG_ERR("date_time_uptime_to_unix_time_ms, error: %d", err);
+		LOG_ERR("cloud_codec_ts_to_unix_time_ms, error: %d", err);
 		return err;
 	}
 
@@ -336,9 +336,9 @@ int json_common_gnss_data_add(cJSON *parent,
 		return -ENODATA;
 	}
 
-	err = date_time_uptime_to_unix_time_ms(&data->gnss_ts);
+	err = cloud_codec_ts_to_unix_time_ms(&data->gnss_ts);
 	if (err) {
-		LOG_ERR("date_time_uptime_to_unix_time_ms, error: %d", err);
+		LOG_ERR("cloud_codec_ts_to_unix_time_ms, error: %d", err);
 		return err;
 	}
 
@@ -425,9 +425,9 @@ int json_common_ui_data_add(cJSON *parent,
 		return -ENODATA;
 	}
 
-	err = date_time_uptime_to_unix_time_ms(&data->btn_ts);
+	err = cloud_codec_ts_to_unix_time_ms(&data->btn_ts);
 	if (err) {
-		LOG_ERR("date_time_uptime_to_unix_time_ms, error: %d", err);
+		LOG_ERR("cloud_codec_ts_to_unix_time_ms, error: %d", err);
 		return err;
 	}
 
@@ -476,9 +476,9 @@ int json_common_impact_data_add(cJSON *parent,
 		return -ENODATA;
 	}
 
-	err = date_time_uptime_to_unix_time_ms(&data->ts);
+	err = cloud_codec_ts_to_unix_time_ms(&data->ts);
 	if (err) {
-		LOG_ERR("date_time_uptime_to_unix_time_ms, error: %d", err);
+		LOG_ERR("cloud_codec_ts_to_unix_time_ms, error: %d", err);
 		return err;
 	}
 
@@ -533,9 +533,9 @@ int json_common_neighbor_cells_data_add(cJSON *parent,
 	}
 
 
-	err = date_time_uptime_to_unix_time_ms(&data->ts);
+	err = cloud_codec_ts_to_unix_time_ms(&data->ts);
 	if (err) {
-		LOG_ERR("date_time_uptime_to_unix_time_ms, error: %d", err);
+		LOG_ERR("cloud_codec_ts_to_unix_time_ms, error: %d", err);
 		cJSON_Delete(root);
 		return err;
 	}
@@ -714,9 +714,9 @@ int json_common_wifi_ap_data_add(cJSON *parent,
 	}
 
 
-	err = date_time_uptime_to_unix_time_ms(&data->ts);
+	err = cloud_codec_ts_to_unix_time_ms(&data->ts);
 	if (err) {
-		LOG_ERR("date_time_uptime_to_unix_time_ms, error: %d", err);
+		LOG_ERR("cloud_codec_ts_to_unix_time_ms, error: %d", err);
 		cJSON_Delete(root);
 		return err;
 	}
@@ -975,9 +975,9 @@ int json_common_battery_data_add(cJSON *parent,
 		return -ENODATA;
 	}
 
-	err = date_time_uptime_to_unix_time_ms(&data->bat_ts);
+	err = cloud_codec_ts_to_unix_time_ms(&data->bat_ts);
 	if (err) {
-		LOG_ERR("date_time_uptime_to_unix_time_ms, error: %d", err);
+		LOG_ERR("cloud_codec_ts_to_unix_time_ms, error: %d", err);
 		return err;
 	}
 
@@ -611,7 +611,7 @@ int lwm2m_codec_helpers_set_gnss_data(struct cloud_data_gnss *gnss)
 	double acc = (double) gnss->pvt.acc;
 	double spd = (double) gnss->pvt.spd;
 
-	err = date_time_uptime_to_unix_time_ms(&gnss->gnss_ts);
+	err = cloud_codec_ts_to_unix_time_ms(&gnss->gnss_ts);
 	if (err) {
 		return err;
 	}
@@ -819,7 +819,7 @@ int lwm2m_codec_helpers_set_sensor_data(struct cloud_data_sensors *sensor)
 		return -ENODATA;
 	}
 
-	err = date_time_uptime_to_unix_time_ms(&sensor->env_ts);
+	err = cloud_codec_ts_to_unix_time_ms(&sensor->env_ts);
 	if (err) {
 		return err;
 	}
@@ -876,7 +876,7 @@ int lwm2m_codec_helpers_set_user_interface_data(struct cloud_data_ui *user_inter
 		return -EINVAL;
 	}
 
-	err = date_time_uptime_to_unix_time_ms(&user_interface->btn_ts);
+	err = cloud_codec_ts_to_unix_time_ms(&user_interface->btn_ts);
 	if (err) {
 		return err;
 	}
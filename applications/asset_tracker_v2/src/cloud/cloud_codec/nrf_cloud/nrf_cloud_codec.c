@@ -82,9 +82,9 @@ static int add_meta_data(cJSON *parent, const char *app_id, int64_t *timestamp,
 
 	if (timestamp != NULL) {
 		if (convert_time) {
-			err = date_time_uptime_to_unix_time_ms(timestamp);
+			err = cloud_codec_ts_to_unix_time_ms(timestamp);
 			if (err) {
-				LOG_ERR("date_time_uptime_to_unix_time_ms, error: %d", err);
+				LOG_ERR("cloud_codec_ts_to_unix_time_ms, error: %d", err);
 				return err;
 			}
 		}
@@ -173,9 +173,9 @@ static int add_pvt_data(cJSON *parent, struct cloud_data_gnss *gnss)
 		return -ENOMEM;
 	}
 
-	err = date_time_uptime_to_unix_time_ms(&gnss->gnss_ts);
+	err = cloud_codec_ts_to_unix_time_ms(&gnss->gnss_ts);
 	if (err) {
-		LOG_WRN("date_time_uptime_to_unix_time_ms, error: %d", err);
+		LOG_WRN("cloud_codec_ts_to_unix_time_ms, error: %d", err);
 	} else {
 		gnss_pvt.ts_ms = gnss->gnss_ts;
 	}
@@ -202,9 +202,9 @@ static int modem_dynamic_data_add(struct cloud_data_modem_dynamic *data, cJSON *
 		return -ENODATA;
 	}
 
-	err = date_time_uptime_to_unix_time_ms(&data->ts);
+	err = cloud_codec_ts_to_unix_time_ms(&data->ts);
 	if (err) {
-		LOG_ERR("date_time_uptime_to_unix_time_ms, error: %d", err);
+		LOG_ERR("cloud_codec_ts_to_unix_time_ms, error: %d", err);
 		return err;
 	}
 
@@ -510,9 +510,9 @@ static int add_batch_data(cJSON *array, enum batch_data_type type, void *buf, si
 				break;
 			}
 
-			err = date_time_uptime_to_unix_time_ms(&data[i].env_ts);
+			err = cloud_codec_ts_to_unix_time_ms(&data[i].env_ts);
 			if (err) {
-				LOG_ERR("date_time_uptime_to_unix_time_ms, error: %d", err);
+				LOG_ERR("cloud_codec_ts_to_unix_time_ms, error: %d", err);
 				return -EOVERFLOW;
 			}
 
@@ -579,9 +579,9 @@ static int add_batch_data(cJSON *array, enum batch_data_type type, void *buf, si
 				break;
 			}
 
-			err = date_time_uptime_to_unix_time_ms(&data[i].ts);
+			err = cloud_codec_ts_to_unix_time_ms(&data[i].ts);
 			if (err) {
-				LOG_ERR("date_time_uptime_to_unix_time_ms, error: %d", err);
+				LOG_ERR("cloud_codec_ts_to_unix_time_ms, error: %d", err);
 				return -EOVERFLOW;
 			}
 
@@ -0,0 +1,661 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/drivers/flash.h>
+#include <zephyr/fs/fcb.h>
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/sys/util.h>
+#include <date_time.h>
+
+#include "data_store.h"
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(data_store, CONFIG_DATA_STORE_LOG_LEVEL);
+
+#if defined(CONFIG_PARTITION_MANAGER_ENABLED)
+#define DATA_STORE_AREA_ID FIXED_PARTITION_ID(DATA_STORE)
+#else
+#define DATA_STORE_AREA_ID FIXED_PARTITION_ID(data_store_partition)
+#endif
+
+#define DATA_STORE_MAGIC 0xda7a5702
+#define DATA_STORE_VERSION 1
+
+enum record_type {
+	RECORD_TYPE_COMMIT = 1,
+	RECORD_TYPE_GNSS,
+	RECORD_TYPE_SENSORS,
+	RECORD_TYPE_UI,
+	RECORD_TYPE_IMPACT,
+	RECORD_TYPE_BATTERY,
+};
+
+/* The timestamp is in UNIX time, otherwise it is the uptime of the boot that wrote it. */
+#define RECORD_FLAG_UNIX_TIME BIT(0)
+
+/* Fixed-size record. Floating point values are stored as scaled integers, with the scale given
+ * next to each field. Values out of range saturate.
+ */
+struct record {
+	uint32_t seq;
+	int64_t ts;
+	uint8_t type;
+	uint8_t flags;
+	union {
+		struct {
+			int32_t lat;		/* 1e-7 degrees */
+			int32_t lon;		/* 1e-7 degrees */
+			int16_t alt;		/* m */
+			uint16_t acc;		/* dm */
+			uint16_t alt_acc;	/* dm */
+			uint16_t spd;		/* cm/s */
+			uint16_t spd_acc;	/* cm/s */
+			uint16_t hdg;		/* 0.01 degrees */
+			uint16_t hdg_acc;	/* 0.01 degrees */
+		} __packed gnss;
+		struct {
+			int16_t temperature;	/* 0.01 degrees Celsius */
+			uint16_t humidity;	/* 0.01 % */
+			uint32_t pressure;	/* Pa */
+			int16_t bsec_air_quality;
+		} __packed sensors;
+		struct {
+			int32_t btn;
+		} __packed ui;
+		struct {
+			uint16_t magnitude;	/* 0.01 G */
+		} __packed impact;
+		struct {
+			uint16_t bat;
+		} __packed bat;
+		struct {
+			/* All records up to and including this sequence number are sent. */
+			uint32_t seq;
+		} __packed commit;
+	} __packed data;
+} __packed;
+
+BUILD_ASSERT(sizeof(struct record) == 36, "Record layout changed, bump DATA_STORE_VERSION");
+
+static struct flash_sector store_sectors[CONFIG_ASSET_TRACKER_V2_DATA_STORE_FLASH_SECTORS];
+static struct fcb store_fcb;
+
+/* Sequence number of the next record. */
+static uint32_t next_seq;
+/* First sequence number written in this boot. Uptime timestamps of older records are void. */
+static uint32_t boot_seq;
+/* Highest sequence number marked as sent. */
+static uint32_t sent_seq;
+/* Last entry known to be sent, reading continues after it. Start of the log if not set. */
+static struct fcb_entry read_loc;
+/* Number of unsent samples. */
+static size_t unsent_count;
+
+/* Last batch read, not yet committed. */
+static struct {
+	bool pending;
+	struct fcb_entry loc;
+	uint32_t seq;
+	size_t count;
+} batch;
+
+static bool is_initialized;
+
+static int64_t scale(double value, double factor, int64_t min, int64_t max)
+{
+	return CLAMP(cloud_codec_scaled(value, factor), min, max);
+}
+
+static bool record_is_unsent(const struct record *rec)
+{
+	if (rec->type == RECORD_TYPE_COMMIT || rec->seq <= sent_seq) {
+		return false;
+	}
+
+	/* The uptime of an earlier boot cannot be converted to UNIX time. */
+	if (!(rec->flags & RECORD_FLAG_UNIX_TIME) && rec->seq < boot_seq) {
+		return false;
+	}
+
+	return true;
+}
+
+static int record_read(const struct flash_area *fap, const struct fcb_entry *loc,
+		       struct record *rec)
+{
+	if (loc->fe_data_len != sizeof(*rec)) {
+		return -EBADMSG;
+	}
+
+	return flash_area_read(fap, FCB_ENTRY_FA_DATA_OFF((*loc)), rec, sizeof(*rec));
+}
+
+static int unsent_walk_cb(struct fcb_entry_ctx *loc_ctx, void *arg)
+{
+	size_t *count = arg;
+	struct record rec;
+
+	if (record_read(loc_ctx->fap, &loc_ctx->loc, &rec) == 0 && record_is_unsent(&rec)) {
+		(*count)++;
+	}
+
+	return 0;
+}
+
+static int record_append(struct record *rec, bool drop_oldest);
+
+static int commit_append(uint32_t seq)
+{
+	struct record rec = {
+		.type = RECORD_TYPE_COMMIT,
+		.data.commit.seq = seq,
+	};
+
+	return record_append(&rec, false);
+}
+
+/* Erase the oldest sector to make room, dropping any unsent samples in it. */
+static int oldest_sector_drop(void)
+{
+	struct flash_sector *oldest = store_fcb.f_oldest;
+	size_t lost = 0;
+	int err;
+
+	err = fcb_walk(&store_fcb, oldest, unsent_walk_cb, &lost);
+	if (err) {
+		LOG_ERR("fcb_walk, error: %d", err);
+		return err;
+	}
+
+	err = fcb_rotate(&store_fcb);
+	if (err) {
+		LOG_ERR("fcb_rotate, error: %d", err);
+		return err;
+	}
+
+	if (read_loc.fe_sector == oldest) {
+		memset(&read_loc, 0, sizeof(read_loc));
+	}
+
+	if (batch.pending && batch.loc.fe_sector == oldest) {
+		batch.pending = false;
+	}
+
+	unsent_count -= MIN(lost, unsent_count);
+
+	if (lost) {
+		LOG_WRN("Data store full, %zu unsent samples dropped", lost);
+	}
+
+	/* The sector may have held the latest commit record, write it again so that
+	 * samples that are already sent are not sent again after a reset.
+	 */
+	if (sent_seq) {
+		return commit_append(sent_seq);
+	}
+
+	return 0;
+}
+
+static int record_append(struct record *rec, bool drop_oldest)
+{
+	struct fcb_entry loc;
+	int err;
+
+	rec->seq = next_seq;
+
+	err = fcb_append(&store_fcb, sizeof(*rec), &loc);
+	if (err == -ENOSPC && drop_oldest) {
+		err = oldest_sector_drop();
+		if (err) {
+			return err;
+		}
+
+		rec->seq = next_seq;
+
+		err = fcb_append(&store_fcb, sizeof(*rec), &loc);
+	}
+
+	if (err == -ENOSPC) {
+		return err;
+	} else if (err) {
+		LOG_ERR("fcb_append, error: %d", err);
+		return err;
+	}
+
+	err = flash_area_write(store_fcb.fap, FCB_ENTRY_FA_DATA_OFF(loc), rec, sizeof(*rec));
+	if (err) {
+		LOG_ERR("flash_area_write, error: %d", err);
+		return err;
+	}
+
+	/* The entry is only valid once its CRC has been written. */
+	err = fcb_append_finish(&store_fcb, &loc);
+	if (err) {
+		LOG_ERR("fcb_append_finish, error: %d", err);
+		return err;
+	}
+
+	next_seq++;
+
+	return 0;
+}
+
+static int sample_append(struct record *rec, int64_t ts)
+{
+	int err;
+
+	if (!is_initialized) {
+		return -EPERM;
+	}
+
+	if (ts >= CLOUD_CODEC_UNIX_TIME_MIN_MS ||
+	    (date_time_is_valid() && date_time_uptime_to_unix_time_ms(&ts) == 0)) {
+		rec->flags |= RECORD_FLAG_UNIX_TIME;
+	}
+
+	rec->ts = ts;
+
+	err = record_append(rec, true);
+	if (err) {
+		return err;
+	}
+
+	unsent_count++;
+
+	return 0;
+}
+
+int data_store_gnss_add(const struct cloud_data_gnss *data)
+{
+	struct record rec = {
+		.type = RECORD_TYPE_GNSS,
+		.data.gnss = {
+			.lat = scale(data->pvt.lat, 1e7, INT32_MIN, INT32_MAX),
+			.lon = scale(data->pvt.lon, 1e7, INT32_MIN, INT32_MAX),
+			.alt = scale(data->pvt.alt, 1, INT16_MIN, INT16_MAX),
+			.acc = scale(data->pvt.acc, 10, 0, UINT16_MAX),
+			.alt_acc = scale(data->pvt.alt_acc, 10, 0, UINT16_MAX),
+			.spd = scale(data->pvt.spd, 100, 0, UINT16_MAX),
+			.spd_acc = scale(data->pvt.spd_acc, 100, 0, UINT16_MAX),
+			.hdg = scale(data->pvt.hdg, 100, 0, UINT16_MAX),
+			.hdg_acc = scale(data->pvt.hdg_acc, 100, 0, UINT16_MAX),
+		},
+	};
+
+	if (!IS_ENABLED(CONFIG_DATA_GNSS_BUFFER_STORE)) {
+		return 0;
+	}
+
+	return sample_append(&rec, data->gnss_ts);
+}
+
+int data_store_sensors_add(const struct cloud_data_sensors *data)
+{
+	struct record rec = {
+		.type = RECORD_TYPE_SENSORS,
+		.data.sensors = {
+			.temperature = scale(data->temperature, 100, INT16_MIN, INT16_MAX),
+			.humidity = scale(data->humidity, 100, 0, UINT16_MAX),
+			.pressure = scale(data->pressure, 1000, 0, UINT32_MAX),
+			.bsec_air_quality = CLAMP(data->bsec_air_quality, INT16_MIN, INT16_MAX),
+		},
+	};
+
+	if (!IS_ENABLED(CONFIG_DATA_SENSOR_BUFFER_STORE)) {
+		return 0;
+	}
+
+	return sample_append(&rec, data->env_ts);
+}
+
+int data_store_ui_add(const struct cloud_data_ui *data)
+{
+	struct record rec = {
+		.type = RECORD_TYPE_UI,
+		.data.ui.btn = data->btn,
+	};
+
+	if (!IS_ENABLED(CONFIG_DATA_UI_BUFFER_STORE)) {
+		return 0;
+	}
+
+	return sample_append(&rec, data->btn_ts);
+}
+
+int data_store_impact_add(const struct cloud_data_impact *data)
+{
+	struct record rec = {
+		.type = RECORD_TYPE_IMPACT,
+		.data.impact.magnitude = scale(data->magnitude, 100, 0, UINT16_MAX),
+	};
+
+	return sample_append(&rec, data->ts);
+}
+
+int data_store_battery_add(const struct cloud_data_battery *data)
+{
+	struct record rec = {
+		.type = RECORD_TYPE_BATTERY,
+		.data.bat.bat = data->bat,
+	};
+
+	if (!IS_ENABLED(CONFIG_DATA_BATTERY_BUFFER_STORE)) {
+		return 0;
+	}
+
+	return sample_append(&rec, data->bat_ts);
+}
+
+/* Decode a record into the next free entry of its type. Returns -ENOMEM if there is none. */
+static int record_to_batch(const struct record *rec, struct data_store_batch *out)
+{
+	switch (rec->type) {
+	case RECORD_TYPE_GNSS: {
+		struct cloud_data_gnss *gnss = &out->gnss[out->gnss_count];
+
+		if (out->gnss_count == ARRAY_SIZE(out->gnss)) {
+			return -ENOMEM;
+		}
+
+		gnss->gnss_ts = rec->ts;
+		gnss->pvt.lat = rec->data.gnss.lat / 1e7;
+		gnss->pvt.lon = rec->data.gnss.lon / 1e7;
+		gnss->pvt.alt = rec->data.gnss.alt;
+		gnss->pvt.acc = rec->data.gnss.acc / 10.0f;
+		gnss->pvt.alt_acc = rec->data.gnss.alt_acc / 10.0f;
+		gnss->pvt.spd = rec->data.gnss.spd / 100.0f;
+		gnss->pvt.spd_acc = rec->data.gnss.spd_acc / 100.0f;
+		gnss->pvt.hdg = rec->data.gnss.hdg / 100.0f;
+		gnss->pvt.hdg_acc = rec->data.gnss.hdg_acc / 100.0f;
+		gnss->queued = true;
+		out->gnss_count++;
+		break;
+	}
+	case RECORD_TYPE_SENSORS: {
+		struct cloud_data_sensors *sensors = &out->sensors[out->sensors_count];
+
+		if (out->sensors_count == ARRAY_SIZE(out->sensors)) {
+			return -ENOMEM;
+		}
+
+		sensors->env_ts = rec->ts;
+		sensors->temperature = rec->data.sensors.temperature / 100.0;
+		sensors->humidity = rec->data.sensors.humidity / 100.0;
+		sensors->pressure = rec->data.sensors.pressure / 1000.0;
+		sensors->bsec_air_quality = rec->data.sensors.bsec_air_quality;
+		sensors->queued = true;
+		out->sensors_count++;
+		break;
+	}
+	case RECORD_TYPE_UI: {
+		struct cloud_data_ui *ui = &out->ui[out->ui_count];
+
+		if (out->ui_count == ARRAY_SIZE(out->ui)) {
+			return -ENOMEM;
+		}
+
+		ui->btn_ts = rec->ts;
+		ui->btn = rec->data.ui.btn;
+		ui->queued = true;
+		out->ui_count++;
+		break;
+	}
+	case RECORD_TYPE_IMPACT: {
+		struct cloud_data_impact *impact = &out->impact[out->impact_count];
+
+		if (out->impact_count == ARRAY_SIZE(out->impact)) {
+			return -ENOMEM;
+		}
+
+		impact->ts = rec->ts;
+		impact->magnitude = rec->data.impact.magnitude / 100.0;
+		impact->queued = true;
+		out->impact_count++;
+		break;
+	}
+	case RECORD_TYPE_BATTERY: {
+		struct cloud_data_battery *bat = &out->bat[out->bat_count];
+
+		if (out->bat_count == ARRAY_SIZE(out->bat)) {
+			return -ENOMEM;
+		}
+
+		bat->bat_ts = rec->ts;
+		bat->bat = rec->data.bat.bat;
+		bat->queued = true;
+		out->bat_count++;
+		break;
+	}
+	default:
+		/* Unknown record types are skipped. */
+		break;
+	}
+
+	return 0;
+}
+
+int data_store_batch_read(struct data_store_batch *out)
+{
+	struct fcb_entry loc = read_loc;
+	struct fcb_entry last = read_loc;
+	uint32_t last_seq = sent_seq;
+	struct record rec;
+	size_t count = 0;
+	int err;
+
+	if (!is_initialized) {
+		return -EPERM;
+	}
+
+	memset(out, 0, sizeof(*out));
+	batch.pending = false;
+
+	while ((err = fcb_getnext(&store_fcb, &loc)) == 0) {
+		if (record_read(store_fcb.fap, &loc, &rec)) {
+			last = loc;
+			continue;
+		}
+
+		if (record_is_unsent(&rec)) {
+			if (record_to_batch(&rec, out) == -ENOMEM) {
+				break;
+			}
+
+			count++;
+		}
+
+		last = loc;
+		last_seq = MAX(last_seq, rec.seq);
+	}
+
+	if (err && err != -ENOTSUP) {
+		LOG_ERR("fcb_getnext, error: %d", err);
+		return err;
+	}
+
+	if (count == 0) {
+		/* Only sent or void records were passed, no need to commit them. */
+		read_loc = last;
+		return 0;
+	}
+
+	batch.pending = true;
+	batch.loc = last;
+	batch.seq = last_seq;
+	batch.count = count;
+
+	return count;
+}
+
+int data_store_batch_commit(void)
+{
+	int err;
+
+	if (!is_initialized) {
+		return -EPERM;
+	}
+
+	if (!batch.pending) {
+		return 0;
+	}
+
+	/* Sectors before the one holding the end of the batch only contain sent samples.
+	 * Erase them first to make room for the commit record. If the device resets before
+	 * the commit record is written, some samples may be sent twice, but none are lost.
+	 */
+	while (store_fcb.f_oldest != batch.loc.fe_sector &&
+	       store_fcb.f_oldest != store_fcb.f_active.fe_sector) {
+		if (read_loc.fe_sector == store_fcb.f_oldest) {
+			memset(&read_loc, 0, sizeof(read_loc));
+		}
+
+		err = fcb_rotate(&store_fcb);
+		if (err) {
+			LOG_ERR("fcb_rotate, error: %d", err);
+			return err;
+		}
+	}
+
+	/* Never drop unsent samples to make room for a commit record. If the log is full,
+	 * the sent position is only kept in RAM until the next commit, or until the oldest
+	 * sector is dropped for a new sample, which writes the commit record again.
+	 */
+	err = commit_append(batch.seq);
+	if (err == -ENOSPC) {
+		LOG_DBG("No room for commit record, deferred");
+	} else if (err) {
+		return err;
+	}
+
+	sent_seq = batch.seq;
+	unsent_count -= MIN(batch.count, unsent_count);
+
+	read_loc = batch.loc;
+	batch.pending = false;
+
+	LOG_DBG("Sent up to sequence number %u, %zu samples left", sent_seq, unsent_count);
+
+	return 0;
+}
+
+size_t data_store_count(void)
+{
+	return unsent_count;
+}
+
+static int state_recover(void)
+{
+	struct fcb_entry loc = { 0 };
+	struct record rec;
+	bool empty = true;
+	int err;
+
+	/* Find the next sequence number and the latest commit record. */
+	while ((err = fcb_getnext(&store_fcb, &loc)) == 0) {
+		if (record_read(store_fcb.fap, &loc, &rec)) {
+			continue;
+		}
+
+		next_seq = empty ? rec.seq + 1 : MAX(next_seq, rec.seq + 1);
+		empty = false;
+
+		if (rec.type == RECORD_TYPE_COMMIT) {
+			sent_seq = MAX(sent_seq, rec.data.commit.seq);
+		}
+	}
+
+	if (err != -ENOTSUP) {
+		return err;
+	}
+
+	boot_seq = next_seq;
+
+	/* Count what is left to send. */
+	memset(&loc, 0, sizeof(loc));
+
+	while (fcb_getnext(&store_fcb, &loc) == 0) {
+		if (record_read(store_fcb.fap, &loc, &rec) == 0 && record_is_unsent(&rec)) {
+			unsent_count++;
+		}
+	}
+
+	return 0;
+}
+
+int data_store_init(void)
+{
+	const struct flash_area *fap;
+	const struct flash_parameters *fparam;
+	uint32_t sector_cnt = ARRAY_SIZE(store_sectors);
+	int err;
+
+	err = flash_area_open(DATA_STORE_AREA_ID, &fap);
+	if (err) {
+		LOG_ERR("flash_area_open, error: %d", err);
+		return err;
+	}
+
+	fparam = flash_get_parameters(flash_area_get_device(fap));
+
+	err = flash_area_get_sectors(DATA_STORE_AREA_ID, &sector_cnt, store_sectors);
+	if (err) {
+		LOG_ERR("flash_area_get_sectors, error: %d", err);
+		goto exit;
+	}
+
+	if (sector_cnt < 2) {
+		LOG_ERR("The data store partition must span at least two sectors");
+		err = -EINVAL;
+		goto exit;
+	}
+
+	memset(&store_fcb, 0, sizeof(store_fcb));
+	store_fcb.f_magic = DATA_STORE_MAGIC;
+	store_fcb.f_version = DATA_STORE_VERSION;
+	store_fcb.f_erase_value = fparam->erase_value;
+	store_fcb.f_sector_cnt = sector_cnt;
+	store_fcb.f_sectors = store_sectors;
+
+	next_seq = 1;
+	sent_seq = 0;
+	unsent_count = 0;
+	memset(&read_loc, 0, sizeof(read_loc));
+	memset(&batch, 0, sizeof(batch));
+
+	err = fcb_init(DATA_STORE_AREA_ID, &store_fcb);
+	if (err) {
+		LOG_WRN("fcb_init, error: %d, erasing data store", err);
+
+		err = flash_area_erase(fap, 0, fap->fa_size);
+		if (err) {
+			LOG_ERR("flash_area_erase, error: %d", err);
+			goto exit;
+		}
+
+		err = fcb_init(DATA_STORE_AREA_ID, &store_fcb);
+		if (err) {
+			LOG_ERR("fcb_init, error: %d", err);
+			goto exit;
+		}
+	}
+
+	err = state_recover();
+	if (err) {
+		LOG_ERR("Failed to read data store, error: %d", err);
+		goto exit;
+	}
+
+	is_initialized = true;
+
+	LOG_DBG("Data store initialized, %zu unsent samples", unsent_count);
+
+exit:
+	flash_area_close(fap);
+	return err;
+}
@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/**@file
+ *
+ * @brief   Persistent data store for Asset Tracker v2
+ *
+ * Samples are appended as fixed-size records to a flash circular buffer (FCB). Each record is
+ * committed with the FCB CRC, so a record that was being written when the device reset is
+ * skipped. Samples that have been handed over to the cloud module are marked as sent by a
+ * commit record, and sectors that only contain sent samples are erased.
+ */
+
+#ifndef DATA_STORE_H__
+#define DATA_STORE_H__
+
+#include <zephyr/kernel.h>
+
+#include "cloud/cloud_codec/cloud_codec.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Samples read from the data store, laid out for cloud_codec_encode_batch_data(). */
+struct data_store_batch {
+	struct cloud_data_gnss gnss[CONFIG_ASSET_TRACKER_V2_DATA_STORE_BATCH_ENTRIES];
+	struct cloud_data_sensors sensors[CONFIG_ASSET_TRACKER_V2_DATA_STORE_BATCH_ENTRIES];
+	struct cloud_data_ui ui[CONFIG_ASSET_TRACKER_V2_DATA_STORE_BATCH_ENTRIES];
+	struct cloud_data_impact impact[CONFIG_ASSET_TRACKER_V2_DATA_STORE_BATCH_ENTRIES];
+	struct cloud_data_battery bat[CONFIG_ASSET_TRACKER_V2_DATA_STORE_BATCH_ENTRIES];
+	size_t gnss_count;
+	size_t sensors_count;
+	size_t ui_count;
+	size_t impact_count;
+	size_t bat_count;
+};
+
+/** @brief Initialize the data store and recover its state from flash.
+ *
+ *  @return Zero on success, otherwise a negative error code is returned.
+ */
+int data_store_init(void);
+
+/** @brief Append a sample to the data store.
+ *
+ *  The sample timestamp is stored as UNIX time if the date time library has a valid time,
+ *  otherwise as uptime. Samples with an uptime timestamp are discarded after a reset.
+ *  If the data store is full, the oldest sector is erased to make room.
+ *
+ *  @param[in] data Sample to append.
+ *
+ *  @return Zero on success, otherwise a negative error code is returned.
+ */
+int data_store_gnss_add(const struct cloud_data_gnss *data);
+int data_store_sensors_add(const struct cloud_data_sensors *data);
+int data_store_ui_add(const struct cloud_data_ui *data);
+int data_store_impact_add(const struct cloud_data_impact *data);
+int data_store_battery_add(const struct cloud_data_battery *data);
+
+/** @brief Read the oldest unsent samples into a batch.
+ *
+ *  Reading stops when the log is exhausted or when the array of a data type in the batch is
+ *  full. The samples are not marked as sent until data_store_batch_commit() is called.
+ *  Calling this function again without a commit reads the same samples.
+ *
+ *  @param[out] batch Batch to fill. Entries that are filled in are queued.
+ *
+ *  @return Number of samples read, zero if there are no unsent samples, otherwise a negative
+ *          error code is returned.
+ */
+int data_store_batch_read(struct data_store_batch *batch);
+
+/** @brief Mark the samples of the last batch read as sent.
+ *
+ *  @return Zero on success, otherwise a negative error code is returned.
+ */
+int data_store_batch_commit(void);
+
+/** @brief Get the number of unsent samples in the data store.
+ *
+ *  @return Number of unsent samples.
+ */
+size_t data_store_count(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DATA_STORE_H__ */
@@ -13,6 +13,9 @@
 #endif
 
 #include "cloud/cloud_codec/cloud_codec.h"
+#if defined(CONFIG_ASSET_TRACKER_V2_DATA_STORE)
+#include "data_store.h"
+#endif
 
 #define MODULE data_module
 
@@ -446,6 +449,14 @@ static int setup(void)
 	}
 
 	date_time_register_handler(date_time_event_handler);
+
+#if defined(CONFIG_ASSET_TRACKER_V2_DATA_STORE)
+	/* Samples are kept in the RAM ringbuffers if the data store is unavailable. */
+	err = data_store_init();
+	if (err) {
+		LOG_ERR("data_store_init, error: %d", err);
+	}
+#endif
 	return 0;
 }
 
@@ -527,6 +538,153 @@ static void data_send(enum data_module_event_type event,
 	memset(data, 0, sizeof(struct cloud_codec_data));
 }
 
+#if defined(CONFIG_ASSET_TRACKER_V2_DATA_STORE)
+/* Move samples that have not been sent from the ringbuffers to the data store. Entries that
+ * cannot be stored are left queued in the ringbuffers.
+ */
+static void data_store_queued_move(void)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(gnss_buf); i++) {
+		if (gnss_buf[i].queued && !data_store_gnss_add(&gnss_buf[i])) {
+			gnss_buf[i].queued = false;
+		}
+	}
+
+	for (size_t i = 0; i < ARRAY_SIZE(sensors_buf); i++) {
+		if (sensors_buf[i].queued && !data_store_sensors_add(&sensors_buf[i])) {
+			sensors_buf[i].queued = false;
+		}
+	}
+
+	for (size_t i = 0; i < ARRAY_SIZE(ui_buf); i++) {
+		if (ui_buf[i].queued && !data_store_ui_add(&ui_buf[i])) {
+			ui_buf[i].queued = false;
+		}
+	}
+
+	for (size_t i = 0; i < ARRAY_SIZE(impact_buf); i++) {
+		if (impact_buf[i].queued && !data_store_impact_add(&impact_buf[i])) {
+			impact_buf[i].queued = false;
+		}
+	}
+
+	for (size_t i = 0; i < ARRAY_SIZE(bat_buf); i++) {
+		if (bat_buf[i].queued && !data_store_battery_add(&bat_buf[i])) {
+			bat_buf[i].queued = false;
+		}
+	}
+}
+
+/* Send samples kept in the data store in batches, oldest first. */
+static void data_store_send(void)
+{
+	int err;
+	struct cloud_codec_data codec = { 0 };
+	static struct data_store_batch batch;
+
+	if (!date_time_is_valid()) {
+		/* Samples from this boot are timestamped with uptime, and cannot be converted to
+		 * UNIX time yet.
+		 */
+		return;
+	}
+
+	for (int i = 0; i < CONFIG_ASSET_TRACKER_V2_DATA_STORE_BATCHES_PER_UPDATE; i++) {
+		err = data_store_batch_read(&batch);
+		if (err < 0) {
+			LOG_ERR("data_store_batch_read, error: %d", err);
+			return;
+		} else if (err == 0) {
+			LOG_DBG("Data store is empty");
+			return;
+		}
+
+		/* Modem data is not kept in the data store. */
+		err = cloud_codec_encode_batch_data(&codec,
+						    batch.gnss,
+						    batch.sensors,
+						    &modem_stat,
+						    modem_dyn_buf,
+						    batch.ui,
+						    batch.impact,
+						    batch.bat,
+						    batch.gnss_count,
+						    batch.sensors_count,
+						    0,
+						    0,
+						    batch.ui_count,
+						    batch.impact_count,
+						    batch.bat_count);
+		switch (err) {
+		case 0:
+			LOG_DBG("Data store batch encoded successfully");
+			data_send(DATA_EVT_DATA_SEND_BATCH, &codec);
+			break;
+		case -ENODATA:
+			LOG_DBG("Nothing to encode in data store batch");
+			break;
+		case -ENOTSUP:
+			LOG_DBG("Encoding of batch data not supported");
+			return;
+		default:
+			LOG_ERR("Error batch-encoding data store samples: %d", err);
+			SEND_ERROR(data, DATA_EVT_ERROR, err);
+			return;
+		}
+
+		/* The samples have been handed over to the cloud module. */
+		err = data_store_batch_commit();
+		if (err) {
+			LOG_ERR("data_store_batch_commit, error: %d", err);
+			return;
+		}
+	}
+
+	LOG_DBG("%zu samples left in data store", data_store_count());
+}
+#else
+static void data_store_queued_move(void)
+{
+}
+
+static void data_store_send(void)
+{
+}
+#endif /* CONFIG_ASSET_TRACKER_V2_DATA_STORE */
+
+/* Modem data is not part of compact batch messages. Send the modem data that is still queued
+ * in regular messages, so that it is not held back until the next regular update.
+ */
+static void modem_data_flush(void)
+{
+	int err;
+	struct cloud_codec_data codec = { 0 };
+	struct cloud_data_gnss gnss = { 0 };
+	struct cloud_data_sensors sensors = { 0 };
+	struct cloud_data_ui ui = { 0 };
+	struct cloud_data_impact impact = { 0 };
+	struct cloud_data_battery bat = { 0 };
+
+	if (!IS_ENABLED(CONFIG_CLOUD_CODEC_COMPACT_BATCH) || !date_time_is_valid()) {
+		return;
+	}
+
+	for (size_t i = 0; i < ARRAY_SIZE(modem_dyn_buf); i++) {
+		/* Queued static modem data is included in the first message. */
+		err = cloud_codec_encode_data(&codec, &gnss, &sensors, &modem_stat,
+					      &modem_dyn_buf[i], &ui, &impact, &bat);
+		if (err == -ENODATA) {
+			continue;
+		} else if (err) {
+			LOG_ERR("Error encoding queued modem data: %d", err);
+			SEND_ERROR(data, DATA_EVT_ERROR, err);
+			return;
+		}
+
+		data_send(DATA_EVT_DATA_SEND, &codec);
+	}
+}
+
 /* This function allocates buffer on the heap, which needs to be freed after use. */
 static void data_encode(void)
 {
@@ -649,6 +807,9 @@ static void data_encode(void)
 			SEND_ERROR(data, DATA_EVT_ERROR, err);
 			return;
 		}
+
+		modem_data_flush();
+		data_store_send();
 	}
 }
 
@@ -948,6 +1109,10 @@ static void on_cloud_state_disconnected(struct data_msg_data *msg)
 {
 	if (IS_EVENT(msg, cloud, CLOUD_EVT_CONNECTED)) {
 		state_set(STATE_CLOUD_CONNECTED);
+
+		/* Send the data that was queued and stored while disconnected. */
+		modem_data_flush();
+		data_store_send();
 		return;
 	}
 
@@ -955,6 +1120,15 @@ static void on_cloud_state_disconnected(struct data_msg_data *msg)
 	    IS_ENABLED(CONFIG_NRF_CLOUD_MQTT)) {
 		config_send();
 	}
+
+	/* Samples cannot be sent while disconnected, keep them in the data store until they
+	 * can.
+	 */
+	if (IS_EVENT(msg, data, DATA_EVT_DATA_READY) ||
+	    IS_EVENT(msg, data, DATA_EVT_UI_DATA_READY) ||
+	    IS_EVENT(msg, data, DATA_EVT_IMPACT_DATA_READY)) {
+		data_store_queued_move();
+	}
 }
 
 /* Message handler for STATE_CLOUD_CONNECTED. */
@@ -962,6 +1136,12 @@ static void on_cloud_state_connected(struct data_msg_data *msg)
 {
 	if (IS_EVENT(msg, data, DATA_EVT_DATA_READY)) {
 		data_encode();
+
+		/* Samples that are still queued were not sent, either because the date time is
+		 * not valid, sending was not granted or encoding failed. Keep them in the data
+		 * store until they can be sent.
+		 */
+		data_store_queued_move();
 		return;
 	}
 
@@ -972,11 +1152,13 @@ static void on_cloud_state_connected(struct data_msg_data *msg)
 
 	if (IS_EVENT(msg, data, DATA_EVT_UI_DATA_READY)) {
 		data_ui_send();
+		data_store_queued_move();
 		return;
 	}
 
 	if (IS_EVENT(msg, data, DATA_EVT_IMPACT_DATA_READY)) {
 		data_impact_send();
+		data_store_queued_move();
 		return;
 	}
 
@@ -1031,6 +1213,7 @@ static void on_all_states(struct data_msg_data *msg)
 	}
 
 	if (IS_EVENT(msg, util, UTIL_EVT_SHUTDOWN_REQUEST)) {
+		data_store_queued_move();
 		/* The module doesn't have anything to shut down and can
 		 * report back immediately.
 		 */
@@ -0,0 +1,369 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <unity.h>
+#include <zephyr/kernel.h>
+#include <string.h>
+#include <math.h>
+#include <cJSON.h>
+#include <date_time.h>
+
+#include "cloud_codec.h"
+#include "compact_batch.h"
+#include "json_common.h"
+#include "json_protocol_names.h"
+
+#define TRACE_LEN 30
+
+/* UNIX time of the first sample in the traces. */
+#define TRACE_START_MS 1718000000000LL
+
+/* Offset added to uptime by the date_time mock. */
+#define UPTIME_OFFSET_MS 1718000000000LL
+
+static struct cloud_data_gnss gnss[TRACE_LEN];
+static struct cloud_data_sensors sensors[TRACE_LEN];
+static struct cloud_data_ui ui[TRACE_LEN];
+static struct cloud_data_impact impact[TRACE_LEN];
+static struct cloud_data_battery bat[TRACE_LEN];
+
+static struct cloud_data_gnss gnss_dec[TRACE_LEN];
+static struct cloud_data_sensors sensors_dec[TRACE_LEN];
+static struct cloud_data_ui ui_dec[TRACE_LEN];
+static struct cloud_data_impact impact_dec[TRACE_LEN];
+static struct cloud_data_battery bat_dec[TRACE_LEN];
+
+static uint8_t buf[4096];
+static uint32_t rand_state;
+
+/* The unity_main is not declared in any header file. It is only defined in the generated test
+ * runner because of ncs' unity configuration. It is therefore declared here to avoid a compiler
+ * warning.
+ */
+extern int unity_main(void);
+
+int date_time_uptime_to_unix_time_ms(int64_t *uptime)
+{
+	*uptime += UPTIME_OFFSET_MS;
+
+	return 0;
+}
+
+/* Deterministic noise in the range [-1, 1]. */
+static double noise(void)
+{
+	rand_state = rand_state * 1103515245 + 12345;
+
+	return ((rand_state >> 16) & 0x7fff) / 16383.5 - 1.0;
+}
+
+/* GNSS fixes of a device moving along a road, and the sensor and battery samples taken
+ * together with them, with a jittered sampling interval.
+ */
+static void trace_generate(int64_t interval_ms, double speed, size_t len)
+{
+	double lat = 63.4210;
+	double lon = 10.4375;
+	double hdg = 45.0;
+	int64_t ts = TRACE_START_MS;
+
+	memset(gnss, 0, sizeof(gnss));
+	memset(sensors, 0, sizeof(sensors));
+	memset(ui, 0, sizeof(ui));
+	memset(impact, 0, sizeof(impact));
+	memset(bat, 0, sizeof(bat));
+	rand_state = 1;
+
+	for (size_t i = 0; i < len; i++) {
+		double dist = speed * interval_ms / 1000.0;
+
+		hdg += 10.0 * noise();
+		lat += dist * cos(hdg * M_PI / 180.0) / 111320.0;
+		lon += dist * sin(hdg * M_PI / 180.0) / (111320.0 * cos(lat * M_PI / 180.0));
+
+		gnss[i] = (struct cloud_data_gnss) {
+			.gnss_ts = ts,
+			.pvt = {
+				.lat = lat,
+				.lon = lon,
+				.alt = 52.3 + 3.0 * noise(),
+				.acc = 9.0 + 4.0 * noise(),
+				.spd = speed + 0.5 * noise(),
+				.hdg = hdg < 0 ? hdg + 360.0 : hdg,
+			},
+			.queued = true,
+		};
+
+		sensors[i] = (struct cloud_data_sensors) {
+			.env_ts = ts + 120,
+			.temperature = 21.4 + 0.3 * noise(),
+			.humidity = 45.2 + 0.8 * noise(),
+			.pressure = 101.325 + 0.01 * noise(),
+			.bsec_air_quality = (int)(50 + 5 * noise()),
+			.queued = true,
+		};
+
+		bat[i] = (struct cloud_data_battery) {
+			.bat = 87 - i / 10,
+			.bat_ts = ts + 150,
+			.queued = true,
+		};
+
+		ts += interval_ms + (int64_t)(500 * noise());
+	}
+}
+
+static struct compact_batch batch_get(size_t len)
+{
+	return (struct compact_batch) {
+		.gnss = gnss,
+		.sensors = sensors,
+		.ui = ui,
+		.impact = impact,
+		.bat = bat,
+		.gnss_count = len,
+		.sensors_count = len,
+		.ui_count = len,
+		.impact_count = len,
+		.bat_count = len,
+	};
+}
+
+static struct compact_batch batch_dec_get(void)
+{
+	return (struct compact_batch) {
+		.gnss = gnss_dec,
+		.sensors = sensors_dec,
+		.ui = ui_dec,
+		.impact = impact_dec,
+		.bat = bat_dec,
+		.gnss_count = TRACE_LEN,
+		.sensors_count = TRACE_LEN,
+		.ui_count = TRACE_LEN,
+		.impact_count = TRACE_LEN,
+		.bat_count = TRACE_LEN,
+	};
+}
+
+/* Length of the current JSON batch encoding of the queued GNSS, sensor and battery samples. */
+static size_t json_len(size_t len)
+{
+	static struct cloud_data_gnss gnss_copy[TRACE_LEN];
+	static struct cloud_data_sensors sensors_copy[TRACE_LEN];
+	static struct cloud_data_battery bat_copy[TRACE_LEN];
+	cJSON *root_obj = cJSON_CreateObject();
+	char *buffer;
+	size_t buffer_len;
+
+	TEST_ASSERT_NOT_NULL(root_obj);
+
+	/* Encoding clears the queued flags, encode copies. */
+	memcpy(gnss_copy, gnss, sizeof(gnss));
+	memcpy(sensors_copy, sensors, sizeof(sensors));
+	memcpy(bat_copy, bat, sizeof(bat));
+
+	TEST_ASSERT_EQUAL(0, json_common_batch_data_add(root_obj, JSON_COMMON_GNSS, gnss_copy,
+							len, DATA_GNSS));
+	TEST_ASSERT_EQUAL(0, json_common_batch_data_add(root_obj, JSON_COMMON_SENSOR,
+							sensors_copy, len, DATA_ENVIRONMENTALS));
+	TEST_ASSERT_EQUAL(0, json_common_batch_data_add(root_obj, JSON_COMMON_BATTERY, bat_copy,
+							len, DATA_BATTERY));
+
+	buffer = cJSON_PrintUnformatted(root_obj);
+	TEST_ASSERT_NOT_NULL(buffer);
+
+	buffer_len = strlen(buffer);
+
+	cJSON_FreeString(buffer);
+	cJSON_Delete(root_obj);
+
+	return buffer_len;
+}
+
+static void size_report(const char *trace, int64_t interval_ms, double speed)
+{
+	struct compact_batch batch;
+	size_t samples = 3 * TRACE_LEN;
+	size_t json;
+	size_t len;
+
+	trace_generate(interval_ms, speed, TRACE_LEN);
+	json = json_len(TRACE_LEN);
+
+	batch = batch_get(TRACE_LEN);
+	TEST_ASSERT_EQUAL(0, compact_batch_encode(&batch, buf, sizeof(buf), &len));
+
+	printk("%s: %zu samples, JSON %zu bytes (%zu per sample), compact %zu bytes "
+	       "(%zu.%zu per sample)\n", trace, samples, json, json / samples, len,
+	       len / samples, (10 * len / samples) % 10);
+
+	TEST_ASSERT_LESS_THAN(json / 5, len);
+}
+
+void setUp(void)
+{
+	memset(gnss_dec, 0, sizeof(gnss_dec));
+	memset(sensors_dec, 0, sizeof(sensors_dec));
+	memset(ui_dec, 0, sizeof(ui_dec));
+	memset(impact_dec, 0, sizeof(impact_dec));
+	memset(bat_dec, 0, sizeof(bat_dec));
+}
+
+void tearDown(void)
+{
+}
+
+void test_round_trip(void)
+{
+	struct compact_batch batch;
+	struct compact_batch dec = batch_dec_get();
+	size_t len;
+
+	trace_generate(60 * MSEC_PER_SEC, 1.4, TRACE_LEN);
+
+	ui[0] = (struct cloud_data_ui) { .btn = 2, .btn_ts = TRACE_START_MS + 500, .queued = true };
+	impact[0] = (struct cloud_data_impact) {
+		.magnitude = 12.34,
+		.ts = TRACE_START_MS + 700,
+		.queued = true,
+	};
+
+	batch = batch_get(TRACE_LEN);
+	TEST_ASSERT_EQUAL(0, compact_batch_encode(&batch, buf, sizeof(buf), &len));
+	TEST_ASSERT_EQUAL(0, compact_batch_decode(buf, len, &dec));
+
+	TEST_ASSERT_EQUAL(TRACE_LEN, dec.gnss_count);
+	TEST_ASSERT_EQUAL(TRACE_LEN, dec.sensors_count);
+	TEST_ASSERT_EQUAL(1, dec.ui_count);
+	TEST_ASSERT_EQUAL(1, dec.impact_count);
+	TEST_ASSERT_EQUAL(TRACE_LEN, dec.bat_count);
+
+	for (size_t i = 0; i < TRACE_LEN; i++) {
+		TEST_ASSERT_TRUE(gnss_dec[i].queued);
+		TEST_ASSERT_EQUAL_INT64(gnss[i].gnss_ts, gnss_dec[i].gnss_ts);
+		TEST_ASSERT_DOUBLE_WITHIN(1e-7, gnss[i].pvt.lat, gnss_dec[i].pvt.lat);
+		TEST_ASSERT_DOUBLE_WITHIN(1e-7, gnss[i].pvt.lon, gnss_dec[i].pvt.lon);
+		TEST_ASSERT_FLOAT_WITHIN(0.05, gnss[i].pvt.alt, gnss_dec[i].pvt.alt);
+		TEST_ASSERT_FLOAT_WITHIN(0.05, gnss[i].pvt.acc, gnss_dec[i].pvt.acc);
+		TEST_ASSERT_FLOAT_WITHIN(0.005, gnss[i].pvt.spd, gnss_dec[i].pvt.spd);
+		TEST_ASSERT_FLOAT_WITHIN(0.05, gnss[i].pvt.hdg, gnss_dec[i].pvt.hdg);
+
+		TEST_ASSERT_EQUAL_INT64(sensors[i].env_ts, sensors_dec[i].env_ts);
+		TEST_ASSERT_DOUBLE_WITHIN(0.005, sensors[i].temperature,
+					  sensors_dec[i].temperature);
+		TEST_ASSERT_DOUBLE_WITHIN(0.005, sensors[i].humidity, sensors_dec[i].humidity);
+		TEST_ASSERT_DOUBLE_WITHIN(0.0005, sensors[i].pressure, sensors_dec[i].pressure);
+		TEST_ASSERT_EQUAL(sensors[i].bsec_air_quality, sensors_dec[i].bsec_air_quality);
+
+		TEST_ASSERT_EQUAL_INT64(bat[i].bat_ts, bat_dec[i].bat_ts);
+		TEST_ASSERT_EQUAL(bat[i].bat, bat_dec[i].bat);
+	}
+
+	TEST_ASSERT_EQUAL(2, ui_dec[0].btn);
+	TEST_ASSERT_EQUAL_INT64(TRACE_START_MS + 500, ui_dec[0].btn_ts);
+	TEST_ASSERT_DOUBLE_WITHIN(0.005, 12.34, impact_dec[0].magnitude);
+	TEST_ASSERT_EQUAL_INT64(TRACE_START_MS + 700, impact_dec[0].ts);
+}
+
+void test_only_queued_samples_are_encoded(void)
+{
+	struct compact_batch batch;
+	struct compact_batch dec = batch_dec_get();
+	size_t len;
+
+	trace_generate(60 * MSEC_PER_SEC, 1.4, 4);
+	gnss[1].queued = false;
+
+	batch = batch_get(4);
+	TEST_ASSERT_EQUAL(0, compact_batch_encode(&batch, buf, sizeof(buf), &len));
+	TEST_ASSERT_EQUAL(0, compact_batch_decode(buf, len, &dec));
+
+	TEST_ASSERT_EQUAL(3, dec.gnss_count);
+	TEST_ASSERT_EQUAL_INT64(gnss[2].gnss_ts, gnss_dec[1].gnss_ts);
+
+	/* Encoded samples are no longer queued. */
+	for (size_t i = 0; i < 4; i++) {
+		TEST_ASSERT_FALSE(gnss[i].queued);
+		TEST_ASSERT_FALSE(sensors[i].queued);
+		TEST_ASSERT_FALSE(bat[i].queued);
+	}
+
+	TEST_ASSERT_EQUAL(-ENODATA, compact_batch_encode(&batch, buf, sizeof(buf), &len));
+}
+
+void test_uptime_is_converted(void)
+{
+	struct cloud_data_ui sample = { .btn = 1, .btn_ts = 1000, .queued = true };
+	struct compact_batch batch = { .ui = &sample, .ui_count = 1 };
+	struct compact_batch dec = batch_dec_get();
+	size_t len;
+
+	TEST_ASSERT_EQUAL(0, compact_batch_encode(&batch, buf, sizeof(buf), &len));
+	TEST_ASSERT_EQUAL(0, compact_batch_decode(buf, len, &dec));
+
+	TEST_ASSERT_EQUAL(1, dec.ui_count);
+	TEST_ASSERT_EQUAL(0, dec.gnss_count);
+	TEST_ASSERT_EQUAL_INT64(1000 + UPTIME_OFFSET_MS, ui_dec[0].btn_ts);
+}
+
+void test_buffer_too_small(void)
+{
+	struct compact_batch batch;
+	size_t len;
+
+	trace_generate(60 * MSEC_PER_SEC, 1.4, TRACE_LEN);
+
+	batch = batch_get(TRACE_LEN);
+	TEST_ASSERT_EQUAL(-ENOMEM, compact_batch_encode(&batch, buf, 32, &len));
+
+	/* Nothing is dequeued if encoding fails. */
+	TEST_ASSERT_TRUE(gnss[0].queued);
+
+	TEST_ASSERT_LESS_OR_EQUAL(compact_batch_size_max(&batch), sizeof(buf));
+	TEST_ASSERT_EQUAL(0, compact_batch_encode(&batch, buf, compact_batch_size_max(&batch),
+						  &len));
+}
+
+void test_decode_malformed(void)
+{
+	struct compact_batch batch;
+	struct compact_batch dec;
+	size_t len;
+
+	trace_generate(60 * MSEC_PER_SEC, 1.4, 4);
+
+	batch = batch_get(4);
+	TEST_ASSERT_EQUAL(0, compact_batch_encode(&batch, buf, sizeof(buf), &len));
+
+	for (size_t i = 0; i < len; i++) {
+		dec = batch_dec_get();
+		TEST_ASSERT_EQUAL(-EBADMSG, compact_batch_decode(buf, i, &dec));
+	}
+
+	dec = batch_dec_get();
+	dec.gnss_count = 3;
+	TEST_ASSERT_EQUAL(-ENOMEM, compact_batch_decode(buf, len, &dec));
+
+	/* Second byte is the version. */
+	buf[1] = COMPACT_BATCH_VERSION + 1;
+	dec = batch_dec_get();
+	TEST_ASSERT_EQUAL(-ENOTSUP, compact_batch_decode(buf, len, &dec));
+}
+
+void test_size_versus_json(void)
+{
+	size_report("Walking, 1 min interval", 60 * MSEC_PER_SEC, 1.4);
+	size_report("Driving, 1 min interval", 60 * MSEC_PER_SEC, 15.0);
+	size_report("Driving, 10 s interval", 10 * MSEC_PER_SEC, 15.0);
+	size_report("Stationary, 1 h interval", 60 * 60 * MSEC_PER_SEC, 0.0);
+}
+
+int main(void)
+{
+	(void)unity_main();
+
+	return 0;
+}
@@ -0,0 +1,280 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <unity.h>
+#include <zephyr/kernel.h>
+#include <zephyr/storage/flash_map.h>
+
+#include "cmock_date_time.h"
+
+#include "data_store.h"
+
+#define BATCH_ENTRIES CONFIG_ASSET_TRACKER_V2_DATA_STORE_BATCH_ENTRIES
+
+/* Offset between uptime and UNIX time used when the time is valid. */
+#define UNIX_TIME_OFFSET_MS 1700000000000LL
+
+static struct data_store_batch batch;
+static bool time_valid;
+
+static int uptime_to_unix_time_ms_stub(int64_t *uptime, int cmock_num_calls)
+{
+	*uptime += UNIX_TIME_OFFSET_MS;
+
+	return 0;
+}
+
+static bool date_time_is_valid_stub(int cmock_num_calls)
+{
+	return time_valid;
+}
+
+static struct cloud_data_gnss gnss_sample(int i)
+{
+	return (struct cloud_data_gnss) {
+		.gnss_ts = 1000 + i,
+		.pvt = {
+			.lat = 63.4210 + i * 0.0001,
+			.lon = 10.4375 - i * 0.0001,
+			.acc = 12.3,
+			.alt = 52.0,
+			.alt_acc = 4.5,
+			.spd = 1.25,
+			.spd_acc = 0.5,
+			.hdg = 271.5,
+			.hdg_acc = 75.0,
+		},
+		.queued = true,
+	};
+}
+
+static void store_gnss(int count)
+{
+	for (int i = 0; i < count; i++) {
+		struct cloud_data_gnss sample = gnss_sample(i);
+
+		TEST_ASSERT_EQUAL(0, data_store_gnss_add(&sample));
+	}
+}
+
+void setUp(void)
+{
+	const struct flash_area *fap;
+
+	TEST_ASSERT_EQUAL(0, flash_area_open(FIXED_PARTITION_ID(data_store_partition), &fap));
+	TEST_ASSERT_EQUAL(0, flash_area_erase(fap, 0, fap->fa_size));
+	flash_area_close(fap);
+
+	time_valid = false;
+	__cmock_date_time_is_valid_Stub(date_time_is_valid_stub);
+	__cmock_date_time_uptime_to_unix_time_ms_Stub(uptime_to_unix_time_ms_stub);
+
+	TEST_ASSERT_EQUAL(0, data_store_init());
+	TEST_ASSERT_EQUAL(0, data_store_count());
+}
+
+void tearDown(void)
+{
+}
+
+void test_empty_store(void)
+{
+	TEST_ASSERT_EQUAL(0, data_store_batch_read(&batch));
+	TEST_ASSERT_EQUAL(0, data_store_batch_commit());
+}
+
+void test_samples_round_trip(void)
+{
+	struct cloud_data_gnss gnss = gnss_sample(0);
+	struct cloud_data_sensors sensors = {
+		.env_ts = 2000,
+		.temperature = 21.37,
+		.humidity = 45.5,
+		.pressure = 101.325,
+		.bsec_air_quality = -1,
+		.queued = true,
+	};
+	struct cloud_data_ui ui = { .btn = 2, .btn_ts = 3000, .queued = true };
+	struct cloud_data_impact impact = { .magnitude = 12.34, .ts = 4000, .queued = true };
+	struct cloud_data_battery bat = { .bat = 87, .bat_ts = 5000, .queued = true };
+
+	TEST_ASSERT_EQUAL(0, data_store_gnss_add(&gnss));
+	TEST_ASSERT_EQUAL(0, data_store_sensors_add(&sensors));
+	TEST_ASSERT_EQUAL(0, data_store_ui_add(&ui));
+	TEST_ASSERT_EQUAL(0, data_store_impact_add(&impact));
+	TEST_ASSERT_EQUAL(0, data_store_battery_add(&bat));
+	TEST_ASSERT_EQUAL(5, data_store_count());
+
+	TEST_ASSERT_EQUAL(5, data_store_batch_read(&batch));
+
+	TEST_ASSERT_EQUAL(1, batch.gnss_count);
+	TEST_ASSERT_TRUE(batch.gnss[0].queued);
+	TEST_ASSERT_EQUAL_INT64(gnss.gnss_ts, batch.gnss[0].gnss_ts);
+	TEST_ASSERT_DOUBLE_WITHIN(1e-7, gnss.pvt.lat, batch.gnss[0].pvt.lat);
+	TEST_ASSERT_DOUBLE_WITHIN(1e-7, gnss.pvt.lon, batch.gnss[0].pvt.lon);
+	TEST_ASSERT_FLOAT_WITHIN(0.5, gnss.pvt.alt, batch.gnss[0].pvt.alt);
+	TEST_ASSERT_FLOAT_WITHIN(0.05, gnss.pvt.acc, batch.gnss[0].pvt.acc);
+	TEST_ASSERT_FLOAT_WITHIN(0.05, gnss.pvt.alt_acc, batch.gnss[0].pvt.alt_acc);
+	TEST_ASSERT_FLOAT_WITHIN(0.005, gnss.pvt.spd, batch.gnss[0].pvt.spd);
+	TEST_ASSERT_FLOAT_WITHIN(0.005, gnss.pvt.spd_acc, batch.gnss[0].pvt.spd_acc);
+	TEST_ASSERT_FLOAT_WITHIN(0.005, gnss.pvt.hdg, batch.gnss[0].pvt.hdg);
+	TEST_ASSERT_FLOAT_WITHIN(0.005, gnss.pvt.hdg_acc, batch.gnss[0].pvt.hdg_acc);
+
+	TEST_ASSERT_EQUAL(1, batch.sensors_count);
+	TEST_ASSERT_EQUAL_INT64(sensors.env_ts, batch.sensors[0].env_ts);
+	TEST_ASSERT_DOUBLE_WITHIN(0.005, sensors.temperature, batch.sensors[0].temperature);
+	TEST_ASSERT_DOUBLE_WITHIN(0.005, sensors.humidity, batch.sensors[0].humidity);
+	TEST_ASSERT_DOUBLE_WITHIN(0.0005, sensors.pressure, batch.sensors[0].pressure);
+	TEST_ASSERT_EQUAL(-1, batch.sensors[0].bsec_air_quality);
+
+	TEST_ASSERT_EQUAL(1, batch.ui_count);
+	TEST_ASSERT_EQUAL(ui.btn, batch.ui[0].btn);
+	TEST_ASSERT_EQUAL_INT64(ui.btn_ts, batch.ui[0].btn_ts);
+
+	TEST_ASSERT_EQUAL(1, batch.impact_count);
+	TEST_ASSERT_DOUBLE_WITHIN(0.005, impact.magnitude, batch.impact[0].magnitude);
+	TEST_ASSERT_EQUAL_INT64(impact.ts, batch.impact[0].ts);
+
+	TEST_ASSERT_EQUAL(1, batch.bat_count);
+	TEST_ASSERT_EQUAL(bat.bat, batch.bat[0].bat);
+	TEST_ASSERT_EQUAL_INT64(bat.bat_ts, batch.bat[0].bat_ts);
+
+	TEST_ASSERT_EQUAL(0, data_store_batch_commit());
+	TEST_ASSERT_EQUAL(0, data_store_count());
+	TEST_ASSERT_EQUAL(0, data_store_batch_read(&batch));
+}
+
+void test_unix_time_when_valid(void)
+{
+	time_valid = true;
+	store_gnss(1);
+
+	TEST_ASSERT_EQUAL(1, data_store_batch_read(&batch));
+	TEST_ASSERT_EQUAL_INT64(1000 + UNIX_TIME_OFFSET_MS, batch.gnss[0].gnss_ts);
+	TEST_ASSERT_TRUE(batch.gnss[0].gnss_ts >= CLOUD_CODEC_UNIX_TIME_MIN_MS);
+}
+
+void test_batch_is_limited_per_type(void)
+{
+	struct cloud_data_battery bat = { .bat = 50, .bat_ts = 9000, .queued = true };
+
+	store_gnss(BATCH_ENTRIES + 2);
+	TEST_ASSERT_EQUAL(0, data_store_battery_add(&bat));
+
+	/* Reading stops at the first GNSS sample that does not fit, the battery sample
+	 * after it is left for the next batch to keep the log in order.
+	 */
+	TEST_ASSERT_EQUAL(BATCH_ENTRIES, data_store_batch_read(&batch));
+	TEST_ASSERT_EQUAL(BATCH_ENTRIES, batch.gnss_count);
+	TEST_ASSERT_EQUAL(0, batch.bat_count);
+	TEST_ASSERT_EQUAL(0, data_store_batch_commit());
+
+	TEST_ASSERT_EQUAL(3, data_store_batch_read(&batch));
+	TEST_ASSERT_EQUAL(2, batch.gnss_count);
+	TEST_ASSERT_EQUAL_INT64(1000 + BATCH_ENTRIES, batch.gnss[0].gnss_ts);
+	TEST_ASSERT_EQUAL(1, batch.bat_count);
+	TEST_ASSERT_EQUAL(0, data_store_batch_commit());
+
+	TEST_ASSERT_EQUAL(0, data_store_count());
+}
+
+void test_uncommitted_batch_is_read_again(void)
+{
+	store_gnss(2);
+
+	TEST_ASSERT_EQUAL(2, data_store_batch_read(&batch));
+	TEST_ASSERT_EQUAL(2, data_store_batch_read(&batch));
+	TEST_ASSERT_EQUAL_INT64(1000, batch.gnss[0].gnss_ts);
+	TEST_ASSERT_EQUAL(2, data_store_count());
+}
+
+void test_state_is_recovered_after_reset(void)
+{
+	time_valid = true;
+	store_gnss(3);
+
+	TEST_ASSERT_EQUAL(3, data_store_batch_read(&batch));
+	TEST_ASSERT_EQUAL(0, data_store_batch_commit());
+
+	store_gnss(2);
+
+	/* A batch that was read but not committed must be sent again after a reset. */
+	TEST_ASSERT_EQUAL(2, data_store_batch_read(&batch));
+
+	TEST_ASSERT_EQUAL(0, data_store_init());
+	TEST_ASSERT_EQUAL(2, data_store_count());
+	TEST_ASSERT_EQUAL(2, data_store_batch_read(&batch));
+	TEST_ASSERT_EQUAL_INT64(1000 + UNIX_TIME_OFFSET_MS, batch.gnss[0].gnss_ts);
+	TEST_ASSERT_EQUAL(0, data_store_batch_commit());
+
+	TEST_ASSERT_EQUAL(0, data_store_init());
+	TEST_ASSERT_EQUAL(0, data_store_count());
+}
+
+void test_uptime_samples_are_void_after_reset(void)
+{
+	store_gnss(2);
+
+	time_valid = true;
+	store_gnss(1);
+
+	TEST_ASSERT_EQUAL(0, data_store_init());
+	TEST_ASSERT_EQUAL(1, data_store_count());
+	TEST_ASSERT_EQUAL(1, data_store_batch_read(&batch));
+	TEST_ASSERT_EQUAL_INT64(1000 + UNIX_TIME_OFFSET_MS, batch.gnss[0].gnss_ts);
+}
+
+void test_full_store_drops_oldest(void)
+{
+	const struct flash_area *fap;
+	int added = 0;
+	int read;
+	int total = 0;
+	size_t stored;
+	int64_t newest_ts = 0;
+
+	TEST_ASSERT_EQUAL(0, flash_area_open(FIXED_PARTITION_ID(data_store_partition), &fap));
+
+	/* Write more samples than the partition holds. */
+	while (added < 2 * fap->fa_size / 36) {
+		struct cloud_data_gnss sample = gnss_sample(added);
+
+		TEST_ASSERT_EQUAL(0, data_store_gnss_add(&sample));
+		added++;
+	}
+
+	printk("Partition of %ld bytes holds %zu of %d samples\n",
+	       (long)fap->fa_size, data_store_count(), added);
+	flash_area_close(fap);
+
+	stored = data_store_count();
+	TEST_ASSERT_LESS_THAN(added, stored);
+
+	/* The newest samples are kept, and commit records do not push out unsent ones. */
+	while ((read = data_store_batch_read(&batch)) > 0) {
+		total += read;
+		newest_ts = batch.gnss[batch.gnss_count - 1].gnss_ts;
+		TEST_ASSERT_EQUAL(0, data_store_batch_commit());
+	}
+
+	TEST_ASSERT_EQUAL(0, read);
+	TEST_ASSERT_EQUAL(stored, total);
+	TEST_ASSERT_EQUAL_INT64(1000 + added - 1, newest_ts);
+	TEST_ASSERT_EQUAL(0, data_store_count());
+}
+
+/* It is required to be added to each test. That is because unity's
+ * main may return nonzero, while zephyr's main currently must
+ * return 0 in all cases (other values are reserved).
+ */
+extern int unity_main(void);
+
+int main(void)
+{
+	(void)unity_main();
+
+	return 0;
+}
@@ -10,6 +10,8 @@
 
 #include <zephyr/logging/log.h>
 
+#include <algorithm>
+
 LOG_MODULE_DECLARE(app, CONFIG_CHIP_APP_LOG_LEVEL);
 
 using namespace Nrf;
@@ -127,7 +129,7 @@ CHIP_ERROR AddMatterDevices(MatterBridgedDevice::DeviceType deviceTypes[], uint8
 			    uint16_t endpointIds[] = nullptr)
 {
 	VerifyOrReturnError(provider != nullptr, CHIP_ERROR_INVALID_ARGUMENT, LOG_ERR("No valid data provider!"));
-	chip::Platform::UniquePtr<BridgedDeviceDataProvider> providerPtr(provider);
+	DeviceUniquePtr<BridgedDeviceDataProvider> providerPtr(provider);
 	VerifyOrReturnError(count <= BridgeManager::kMaxBridgedDevicesPerProvider, CHIP_ERROR_BUFFER_TOO_SMALL,
 			    LOG_ERR("Trying to add too many endpoints for single provider device."));
 
@@ -160,7 +162,7 @@ CHIP_ERROR AddMatterDevices(MatterBridgedDevice::DeviceType deviceTypes[], uint8
 	/* Not all requested devices were created successfully, delete all previously created objects and return. */
 	if (err != CHIP_NO_ERROR) {
 		for (uint8_t i = 0; i < addedDevicesCount; i++) {
-			chip::Platform::Delete(newBridgedDevices[i]);
+			DeleteDevice(newBridgedDevices[i]);
 		}
 		return err;
 	}
@@ -213,7 +215,7 @@ CHIP_ERROR BluetoothDeviceConnected(bool success, void *context)
 	BluetoothConnectionContext *ctx = reinterpret_cast<BluetoothConnectionContext *>(context);
 
 	if (!success) {
-		chip::Platform::Delete(ctx->provider);
+		DeleteDevice(ctx->provider);
 		chip::Platform::Delete(ctx);
 		return CHIP_ERROR_INTERNAL;
 	}
@@ -228,84 +230,92 @@ CHIP_ERROR BluetoothDeviceConnected(bool success, void *context)
 
 	return err;
 }
-} // namespace
 
-BleBridgedDeviceFactory::BridgedDeviceFactory &BleBridgedDeviceFactory::GetBridgedDeviceFactory()
+/* The pools are shared by all device and data provider types, so their blocks fit the largest of them. */
+constexpr size_t kDeviceBlockSize = std::max({
+	sizeof(MatterBridgedDevice),
+#ifdef CONFIG_BRIDGE_HUMIDITY_SENSOR_BRIDGED_DEVICE
+	sizeof(HumiditySensorDevice),
+#endif
+#ifdef CONFIG_BRIDGE_ONOFF_LIGHT_BRIDGED_DEVICE
+	sizeof(OnOffLightDevice),
+#endif
+#ifdef CONFIG_BRIDGE_TEMPERATURE_SENSOR_BRIDGED_DEVICE
+	sizeof(TemperatureSensorDevice),
+#endif
+#ifdef CONFIG_BRIDGE_GENERIC_SWITCH_BRIDGED_DEVICE
+	sizeof(GenericSwitchDevice),
+#endif
+#ifdef CONFIG_BRIDGE_ONOFF_LIGHT_SWITCH_BRIDGED_DEVICE
+	sizeof(OnOffLightSwitchDevice),
+#endif
+});
+
+constexpr size_t kProviderBlockSize = std::max({
+	sizeof(BridgedDeviceDataProvider),
+#if defined(CONFIG_BRIDGE_ONOFF_LIGHT_BRIDGED_DEVICE) && (defined(CONFIG_BRIDGE_GENERIC_SWITCH_BRIDGED_DEVICE) ||      \
+							  defined(CONFIG_BRIDGE_ONOFF_LIGHT_SWITCH_BRIDGED_DEVICE))
+	sizeof(BleLBSDataProvider),
+#endif
+#if defined(CONFIG_BRIDGE_TEMPERATURE_SENSOR_BRIDGED_DEVICE) && defined(CONFIG_BRIDGE_HUMIDITY_SENSOR_BRIDGED_DEVICE)
+	sizeof(BleEnvironmentalDataProvider),
+#endif
+});
+
+/* A Bluetooth LE bridged device has one data provider, shared by all its endpoints. */
+DevicePool<kDeviceBlockSize, CONFIG_BRIDGE_MAX_DYNAMIC_ENDPOINTS_NUMBER> sDevicePool;
+DevicePool<kProviderBlockSize, CONFIG_BRIDGE_MAX_BRIDGED_DEVICES_NUMBER> sProviderPool;
+
+template <typename T> MatterBridgedDevice *CreateBridgedDevice(const char *nodeLabel)
 {
-	auto checkLabel = [](const char *nodeLabel) {
-		/* If node label is provided it must fit the maximum defined length */
-		if (!nodeLabel || (nodeLabel && (strlen(nodeLabel) < MatterBridgedDevice::kNodeLabelSize))) {
-			return true;
-		}
-		return false;
-	};
+	/* If node label is provided it must fit the maximum defined length */
+	if (nodeLabel && strlen(nodeLabel) >= MatterBridgedDevice::kNodeLabelSize) {
+		return nullptr;
+	}
 
-	static BridgedDeviceFactory sBridgedDeviceFactory{
+	return sDevicePool.New<T>(nodeLabel);
+}
+
+template <typename T>
+BridgedDeviceDataProvider *CreateDataProvider(BleBridgedDeviceFactory::UpdateAttributeCallback updateClb,
+					      BleBridgedDeviceFactory::InvokeCommandCallback commandClb)
+{
+	return sProviderPool.New<T>(updateClb, commandClb);
+}
+} // namespace
+
+const BleBridgedDeviceFactory::BridgedDeviceFactory &BleBridgedDeviceFactory::GetBridgedDeviceFactory()
+{
+	static const BridgedDeviceFactory sBridgedDeviceFactory{
 #ifdef CONFIG_BRIDGE_HUMIDITY_SENSOR_BRIDGED_DEVICE
-		{ MatterBridgedDevice::DeviceType::HumiditySensor,
-		  [checkLabel](const char *nodeLabel) -> MatterBridgedDevice * {
-			  if (!checkLabel(nodeLabel)) {
-				  return nullptr;
-			  }
-			  return chip::Platform::New<HumiditySensorDevice>(nodeLabel);
-		  } },
+		{ MatterBridgedDevice::DeviceType::HumiditySensor, CreateBridgedDevice<HumiditySensorDevice> },
 #endif
 #ifdef CONFIG_BRIDGE_ONOFF_LIGHT_BRIDGED_DEVICE
-		{ MatterBridgedDevice::DeviceType::OnOffLight,
-		  [checkLabel](const char *nodeLabel) -> MatterBridgedDevice * {
-			  if (!checkLabel(nodeLabel)) {
-				  return nullptr;
-			  }
-			  return chip::Platform::New<OnOffLightDevice>(nodeLabel);
-		  } },
+		{ MatterBridgedDevice::DeviceType::OnOffLight, CreateBridgedDevice<OnOffLightDevice> },
 #endif
 #ifdef CONFIG_BRIDGE_TEMPERATURE_SENSOR_BRIDGED_DEVICE
-		{ MatterBridgedDevice::DeviceType::TemperatureSensor,
-		  [checkLabel](const char *nodeLabel) -> MatterBridgedDevice * {
-			  if (!checkLabel(nodeLabel)) {
-				  return nullptr;
-			  }
-			  return chip::Platform::New<TemperatureSensorDevice>(nodeLabel);
-		  } },
+		{ MatterBridgedDevice::DeviceType::TemperatureSensor, CreateBridgedDevice<TemperatureSensorDevice> },
 #endif
 #ifdef CONFIG_BRIDGE_GENERIC_SWITCH_BRIDGED_DEVICE
-		{ MatterBridgedDevice::DeviceType::GenericSwitch,
-		  [checkLabel](const char *nodeLabel) -> MatterBridgedDevice * {
-			  if (!checkLabel(nodeLabel)) {
-				  return nullptr;
-			  }
-			  return chip::Platform::New<GenericSwitchDevice>(nodeLabel);
-		  } },
+		{ MatterBridgedDevice::DeviceType::GenericSwitch, CreateBridgedDevice<GenericSwitchDevice> },
 #endif
 #ifdef CONFIG_BRIDGE_ONOFF_LIGHT_SWITCH_BRIDGED_DEVICE
-		{ MatterBridgedDevice::DeviceType::OnOffLightSwitch,
-		  [checkLabel](const char *nodeLabel) -> MatterBridgedDevice * {
-			  if (!checkLabel(nodeLabel)) {
-				  return nullptr;
-			  }
-			  return chip::Platform::New<OnOffLightSwitchDevice>(nodeLabel);
-		  } },
+		{ MatterBridgedDevice::DeviceType::OnOffLightSwitch, CreateBridgedDevice<OnOffLightSwitchDevice> },
 #endif
 	};
 	return sBridgedDeviceFactory;
 }
 
-BleBridgedDeviceFactory::BleDataProviderFactory &BleBridgedDeviceFactory::GetDataProviderFactory()
+const BleBridgedDeviceFactory::BleDataProviderFactory &BleBridgedDeviceFactory::GetDataProviderFactory()
 {
-	static BleDataProviderFactory sDeviceDataProvider
+	static const BleDataProviderFactory sDeviceDataProvider
 	{
 #if defined(CONFIG_BRIDGE_ONOFF_LIGHT_BRIDGED_DEVICE) && (defined(CONFIG_BRIDGE_GENERIC_SWITCH_BRIDGED_DEVICE) ||      \
 							  defined(CONFIG_BRIDGE_ONOFF_LIGHT_SWITCH_BRIDGED_DEVICE))
-		{ ServiceUuid::LedButtonService,
-		  [](UpdateAttributeCallback updateClb, InvokeCommandCallback commandClb) {
-			  return chip::Platform::New<BleLBSDataProvider>(updateClb, commandClb);
-		  } },
+		{ ServiceUuid::LedButtonService, CreateDataProvider<BleLBSDataProvider> },
 #endif
 #if defined(CONFIG_BRIDGE_TEMPERATURE_SENSOR_BRIDGED_DEVICE) && defined(CONFIG_BRIDGE_HUMIDITY_SENSOR_BRIDGED_DEVICE)
-			{ ServiceUuid::EnvironmentalSensorService,
-			  [](UpdateAttributeCallback updateClb, InvokeCommandCallback commandClb) {
-				  return chip::Platform::New<BleEnvironmentalDataProvider>(updateClb, commandClb);
-			  } },
+			{ ServiceUuid::EnvironmentalSensorService, CreateDataProvider<BleEnvironmentalDataProvider> },
 #endif
 	};
 	return sDeviceDataProvider;
@@ -353,7 +363,7 @@ CHIP_ERROR BleBridgedDeviceFactory::CreateDevice(int deviceType, bt_addr_le_t bt
 
 exit:
 	if (err != CHIP_NO_ERROR) {
-		chip::Platform::Delete(provider);
+		DeleteDevice(provider);
 	}
 
 	return err;
@@ -412,7 +422,7 @@ CHIP_ERROR BleBridgedDeviceFactory::CreateDevice(uint16_t uuid, bt_addr_le_t btA
 
 exit:
 	if (err != CHIP_NO_ERROR) {
-		chip::Platform::Delete(provider);
+		DeleteDevice(provider);
 	}
 
 	return err;
@@ -52,6 +52,7 @@ static constexpr EmberAfDeviceType kBridgedGenericSwitchDeviceTypes[] = {
 };
 
 static constexpr uint8_t kSwitchDataVersionSize = ArraySize(genericSwitchClusters);
+static_assert(kSwitchDataVersionSize <= MatterBridgedDevice::kMaxDataVersionSize);
 
 GenericSwitchDevice::GenericSwitchDevice(const char *nodeLabel) : MatterBridgedDevice(nodeLabel)
 {
@@ -59,7 +60,6 @@ GenericSwitchDevice::GenericSwitchDevice(const char *nodeLabel) : MatterBridgedD
 	mEp = &bridgedGenericSwitchEndpoint;
 	mDeviceTypeList = kBridgedGenericSwitchDeviceTypes;
 	mDeviceTypeListSize = ARRAY_SIZE(kBridgedGenericSwitchDeviceTypes);
-	mDataVersion = static_cast<DataVersion *>(chip::Platform::MemoryAlloc(sizeof(DataVersion) * mDataVersionSize));
 }
 
 CHIP_ERROR GenericSwitchDevice::HandleRead(ClusterId clusterId, AttributeId attributeId, uint8_t *buffer,
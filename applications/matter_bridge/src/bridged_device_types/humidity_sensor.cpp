@@ -47,6 +47,7 @@ static constexpr EmberAfDeviceType kBridgedHumidityDeviceTypes[] = {
 };
 
 static constexpr uint8_t kHumidityDataVersionSize = ArraySize(bridgedHumidityClusters);
+static_assert(kHumidityDataVersionSize <= MatterBridgedDevice::kMaxDataVersionSize);
 
 HumiditySensorDevice::HumiditySensorDevice(const char *nodeLabel) : MatterBridgedDevice(nodeLabel)
 {
@@ -54,7 +55,6 @@ HumiditySensorDevice::HumiditySensorDevice(const char *nodeLabel) : MatterBridge
 	mEp = &bridgedHumidityEndpoint;
 	mDeviceTypeList = kBridgedHumidityDeviceTypes;
 	mDeviceTypeListSize = ARRAY_SIZE(kBridgedHumidityDeviceTypes);
-	mDataVersion = static_cast<DataVersion *>(chip::Platform::MemoryAlloc(sizeof(DataVersion) * mDataVersionSize));
 }
 
 CHIP_ERROR HumiditySensorDevice::HandleRead(ClusterId clusterId, AttributeId attributeId, uint8_t *buffer,
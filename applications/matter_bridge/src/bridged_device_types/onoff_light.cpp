@@ -92,6 +92,7 @@ static constexpr EmberAfDeviceType kBridgedOnOffDeviceTypes[] = {
 };
 
 static constexpr uint8_t kLightDataVersionSize = ArraySize(bridgedLightClusters);
+static_assert(kLightDataVersionSize <= MatterBridgedDevice::kMaxDataVersionSize);
 
 OnOffLightDevice::OnOffLightDevice(const char *nodeLabel) : MatterBridgedDevice(nodeLabel)
 {
@@ -99,7 +100,6 @@ OnOffLightDevice::OnOffLightDevice(const char *nodeLabel) : MatterBridgedDevice(
 	mEp = &bridgedLightEndpoint;
 	mDeviceTypeList = kBridgedOnOffDeviceTypes;
 	mDeviceTypeListSize = ARRAY_SIZE(kBridgedOnOffDeviceTypes);
-	mDataVersion = static_cast<DataVersion *>(chip::Platform::MemoryAlloc(sizeof(DataVersion) * mDataVersionSize));
 }
 
 CHIP_ERROR OnOffLightDevice::HandleRead(ClusterId clusterId, AttributeId attributeId, uint8_t *buffer,
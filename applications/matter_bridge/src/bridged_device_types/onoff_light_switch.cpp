@@ -65,6 +65,7 @@ static constexpr EmberAfDeviceType kBridgedLightSwitchDeviceTypes[] = {
 };
 
 static constexpr uint8_t kLightSwitchDataVersionSize = ArraySize(bridgedLightSwitchClusters);
+static_assert(kLightSwitchDataVersionSize <= MatterBridgedDevice::kMaxDataVersionSize);
 
 OnOffLightSwitchDevice::OnOffLightSwitchDevice(const char *nodeLabel) : MatterBridgedDevice(nodeLabel)
 {
@@ -72,7 +73,6 @@ OnOffLightSwitchDevice::OnOffLightSwitchDevice(const char *nodeLabel) : MatterBr
 	mEp = &bridgedLightSwitchEndpoint;
 	mDeviceTypeList = kBridgedLightSwitchDeviceTypes;
 	mDeviceTypeListSize = ARRAY_SIZE(kBridgedLightSwitchDeviceTypes);
-	mDataVersion = static_cast<DataVersion *>(chip::Platform::MemoryAlloc(sizeof(DataVersion) * mDataVersionSize));
 }
 
 CHIP_ERROR OnOffLightSwitchDevice::HandleRead(ClusterId clusterId, AttributeId attributeId, uint8_t *buffer,
@@ -43,6 +43,7 @@ static constexpr EmberAfDeviceType kBridgedTemperatureDeviceTypes[] = {
 };
 
 static constexpr uint8_t kTemperatureDataVersionSize = ArraySize(bridgedTemperatureClusters);
+static_assert(kTemperatureDataVersionSize <= MatterBridgedDevice::kMaxDataVersionSize);
 
 TemperatureSensorDevice::TemperatureSensorDevice(const char *nodeLabel) : MatterBridgedDevice(nodeLabel)
 {
@@ -50,7 +51,6 @@ TemperatureSensorDevice::TemperatureSensorDevice(const char *nodeLabel) : Matter
 	mEp = &bridgedTemperatureEndpoint;
 	mDeviceTypeList = kBridgedTemperatureDeviceTypes;
 	mDeviceTypeListSize = ARRAY_SIZE(kBridgedTemperatureDeviceTypes);
-	mDataVersion = static_cast<DataVersion *>(chip::Platform::MemoryAlloc(sizeof(DataVersion) * mDataVersionSize));
 }
 
 CHIP_ERROR TemperatureSensorDevice::HandleRead(ClusterId clusterId, AttributeId attributeId, uint8_t *buffer,
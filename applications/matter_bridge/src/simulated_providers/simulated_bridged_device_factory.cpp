@@ -10,6 +10,8 @@
 
 #include <zephyr/logging/log.h>
 
+#include <algorithm>
+
 LOG_MODULE_DECLARE(app, CONFIG_CHIP_APP_LOG_LEVEL);
 
 namespace
@@ -58,100 +60,111 @@ CHIP_ERROR StoreDevice(Nrf::MatterBridgedDevice *device, Nrf::BridgedDeviceDataP
 
 	return CHIP_NO_ERROR;
 }
-} /* namespace */
 
-SimulatedBridgedDeviceFactory::BridgedDeviceFactory &SimulatedBridgedDeviceFactory::GetBridgedDeviceFactory()
+/* The pools are shared by all device and data provider types, so their blocks fit the largest of them. */
+constexpr size_t kDeviceBlockSize = std::max({
+	sizeof(Nrf::MatterBridgedDevice),
+#ifdef CONFIG_BRIDGE_ONOFF_LIGHT_BRIDGED_DEVICE
+	sizeof(OnOffLightDevice),
+#endif
+#ifdef CONFIG_BRIDGE_GENERIC_SWITCH_BRIDGED_DEVICE
+	sizeof(GenericSwitchDevice),
+#endif
+#ifdef CONFIG_BRIDGE_ONOFF_LIGHT_SWITCH_BRIDGED_DEVICE
+	sizeof(OnOffLightSwitchDevice),
+#endif
+#ifdef CONFIG_BRIDGE_TEMPERATURE_SENSOR_BRIDGED_DEVICE
+	sizeof(TemperatureSensorDevice),
+#endif
+#ifdef CONFIG_BRIDGE_HUMIDITY_SENSOR_BRIDGED_DEVICE
+	sizeof(HumiditySensorDevice),
+#endif
+});
+
+constexpr size_t kProviderBlockSize = std::max({
+	sizeof(Nrf::BridgedDeviceDataProvider),
+#ifdef CONFIG_BRIDGE_ONOFF_LIGHT_BRIDGED_DEVICE
+	sizeof(SimulatedOnOffLightDataProvider),
+#endif
+#ifdef CONFIG_BRIDGE_GENERIC_SWITCH_BRIDGED_DEVICE
+	sizeof(SimulatedGenericSwitchDataProvider),
+#endif
+#ifdef CONFIG_BRIDGE_ONOFF_LIGHT_SWITCH_BRIDGED_DEVICE
+	sizeof(SimulatedOnOffLightSwitchDataProvider),
+#endif
+#ifdef CONFIG_BRIDGE_TEMPERATURE_SENSOR_BRIDGED_DEVICE
+	sizeof(SimulatedTemperatureSensorDataProvider),
+#endif
+#ifdef CONFIG_BRIDGE_HUMIDITY_SENSOR_BRIDGED_DEVICE
+	sizeof(SimulatedHumiditySensorDataProvider),
+#endif
+});
+
+/* Each simulated bridged device has one endpoint and one data provider. */
+Nrf::DevicePool<kDeviceBlockSize, CONFIG_BRIDGE_MAX_DYNAMIC_ENDPOINTS_NUMBER> sDevicePool;
+Nrf::DevicePool<kProviderBlockSize, CONFIG_BRIDGE_MAX_BRIDGED_DEVICES_NUMBER> sProviderPool;
+
+template <typename T> Nrf::MatterBridgedDevice *CreateBridgedDevice(const char *nodeLabel)
 {
-	auto checkLabel = [](const char *nodeLabel) {
-		/* If node label is provided it must fit the maximum defined length */
-		if (!nodeLabel || (nodeLabel && (strlen(nodeLabel) < Nrf::MatterBridgedDevice::kNodeLabelSize))) {
-			return true;
-		}
-		return false;
-	};
+	/* If node label is provided it must fit the maximum defined length */
+	if (nodeLabel && strlen(nodeLabel) >= Nrf::MatterBridgedDevice::kNodeLabelSize) {
+		return nullptr;
+	}
+
+	return sDevicePool.New<T>(nodeLabel);
+}
 
-	static BridgedDeviceFactory sBridgedDeviceFactory{
+template <typename T>
+Nrf::BridgedDeviceDataProvider *CreateDataProvider(SimulatedBridgedDeviceFactory::UpdateAttributeCallback updateClb,
+						   SimulatedBridgedDeviceFactory::InvokeCommandCallback commandClb)
+{
+	return sProviderPool.New<T>(updateClb, commandClb);
+}
+} /* namespace */
+
+const SimulatedBridgedDeviceFactory::BridgedDeviceFactory &SimulatedBridgedDeviceFactory::GetBridgedDeviceFactory()
+{
+	static const BridgedDeviceFactory sBridgedDeviceFactory{
 #ifdef CONFIG_BRIDGE_ONOFF_LIGHT_BRIDGED_DEVICE
-		{ Nrf::MatterBridgedDevice::DeviceType::OnOffLight,
-		  [checkLabel](const char *nodeLabel) -> Nrf::MatterBridgedDevice * {
-			  if (!checkLabel(nodeLabel)) {
-				  return nullptr;
-			  }
-			  return chip::Platform::New<OnOffLightDevice>(nodeLabel);
-		  } },
+		{ Nrf::MatterBridgedDevice::DeviceType::OnOffLight, CreateBridgedDevice<OnOffLightDevice> },
 #endif
 #ifdef CONFIG_BRIDGE_GENERIC_SWITCH_BRIDGED_DEVICE
-		{ Nrf::MatterBridgedDevice::DeviceType::GenericSwitch,
-		  [checkLabel](const char *nodeLabel) -> Nrf::MatterBridgedDevice * {
-			  if (!checkLabel(nodeLabel)) {
-				  return nullptr;
-			  }
-			  return chip::Platform::New<GenericSwitchDevice>(nodeLabel);
-		  } },
+		{ Nrf::MatterBridgedDevice::DeviceType::GenericSwitch, CreateBridgedDevice<GenericSwitchDevice> },
 #endif
 #ifdef CONFIG_BRIDGE_ONOFF_LIGHT_SWITCH_BRIDGED_DEVICE
-		{ Nrf::MatterBridgedDevice::DeviceType::OnOffLightSwitch,
-		  [checkLabel](const char *nodeLabel) -> Nrf::MatterBridgedDevice * {
-			  if (!checkLabel(nodeLabel)) {
-				  return nullptr;
-			  }
-			  return chip::Platform::New<OnOffLightSwitchDevice>(nodeLabel);
-		  } },
+		{ Nrf::MatterBridgedDevice::DeviceType::OnOffLightSwitch, CreateBridgedDevice<OnOffLightSwitchDevice> },
 #endif
 #ifdef CONFIG_BRIDGE_TEMPERATURE_SENSOR_BRIDGED_DEVICE
-		{ Nrf::MatterBridgedDevice::DeviceType::TemperatureSensor,
-		  [checkLabel](const char *nodeLabel) -> Nrf::MatterBridgedDevice * {
-			  if (!checkLabel(nodeLabel)) {
-				  return nullptr;
-			  }
-			  return chip::Platform::New<TemperatureSensorDevice>(nodeLabel);
-		  } },
+		{ Nrf::MatterBridgedDevice::DeviceType::TemperatureSensor, CreateBridgedDevice<TemperatureSensorDevice> },
 #endif
 #ifdef CONFIG_BRIDGE_HUMIDITY_SENSOR_BRIDGED_DEVICE
-		{ Nrf::MatterBridgedDevice::DeviceType::HumiditySensor,
-		  [checkLabel](const char *nodeLabel) -> Nrf::MatterBridgedDevice * {
-			  if (!checkLabel(nodeLabel)) {
-				  return nullptr;
-			  }
-			  return chip::Platform::New<HumiditySensorDevice>(nodeLabel);
-		  } },
+		{ Nrf::MatterBridgedDevice::DeviceType::HumiditySensor, CreateBridgedDevice<HumiditySensorDevice> },
 #endif
 	};
 	return sBridgedDeviceFactory;
 }
 
-SimulatedBridgedDeviceFactory::SimulatedDataProviderFactory &SimulatedBridgedDeviceFactory::GetDataProviderFactory()
+const SimulatedBridgedDeviceFactory::SimulatedDataProviderFactory &SimulatedBridgedDeviceFactory::GetDataProviderFactory()
 {
-	static SimulatedDataProviderFactory sDeviceDataProvider{
+	static const SimulatedDataProviderFactory sDeviceDataProvider{
 #ifdef CONFIG_BRIDGE_ONOFF_LIGHT_BRIDGED_DEVICE
-		{ Nrf::MatterBridgedDevice::DeviceType::OnOffLight,
-		  [](UpdateAttributeCallback updateClb, InvokeCommandCallback commandClb) {
-			  return chip::Platform::New<SimulatedOnOffLightDataProvider>(updateClb, commandClb);
-		  } },
+		{ Nrf::MatterBridgedDevice::DeviceType::OnOffLight, CreateDataProvider<SimulatedOnOffLightDataProvider> },
 #endif
 #ifdef CONFIG_BRIDGE_GENERIC_SWITCH_BRIDGED_DEVICE
 		{ Nrf::MatterBridgedDevice::DeviceType::GenericSwitch,
-		  [](UpdateAttributeCallback updateClb, InvokeCommandCallback commandClb) {
-			  return chip::Platform::New<SimulatedGenericSwitchDataProvider>(updateClb, commandClb);
-		  } },
+		  CreateDataProvider<SimulatedGenericSwitchDataProvider> },
 #endif
 #ifdef CONFIG_BRIDGE_ONOFF_LIGHT_SWITCH_BRIDGED_DEVICE
 		{ Nrf::MatterBridgedDevice::DeviceType::OnOffLightSwitch,
-		  [](UpdateAttributeCallback updateClb, InvokeCommandCallback commandClb) {
-			  return chip::Platform::New<SimulatedOnOffLightSwitchDataProvider>(updateClb, commandClb);
-		  } },
+		  CreateDataProvider<SimulatedOnOffLightSwitchDataProvider> },
 #endif
 #ifdef CONFIG_BRIDGE_TEMPERATURE_SENSOR_BRIDGED_DEVICE
 		{ Nrf::MatterBridgedDevice::DeviceType::TemperatureSensor,
-		  [](UpdateAttributeCallback updateClb, InvokeCommandCallback commandClb) {
-			  return chip::Platform::New<SimulatedTemperatureSensorDataProvider>(updateClb, commandClb);
-		  } },
+		  CreateDataProvider<SimulatedTemperatureSensorDataProvider> },
 #endif
 #ifdef CONFIG_BRIDGE_HUMIDITY_SENSOR_BRIDGED_DEVICE
 		{ Nrf::MatterBridgedDevice::DeviceType::HumiditySensor,
-		  [](UpdateAttributeCallback updateClb, InvokeCommandCallback commandClb) {
-			  return chip::Platform::New<SimulatedHumiditySensorDataProvider>(updateClb, commandClb);
-		  } },
+		  CreateDataProvider<SimulatedHumiditySensorDataProvider> },
 #endif
 	};
 	return sDeviceDataProvider;
@@ -175,6 +188,7 @@ CHIP_ERROR SimulatedBridgedDeviceFactory::CreateDevice(int deviceType, const cha
 
 	if (!newBridgedDevice) {
 		LOG_ERR("Cannot allocate Matter device of given type");
+		Nrf::DeleteDevice(provider);
 		return CHIP_ERROR_NO_MEMORY;
 	}
 
@@ -386,9 +386,15 @@ CHIP_ERROR AppTask::Init()
 
 	/* Initialize timers */
 	k_timer_init(
-		&sMeasurementsTimer, [](k_timer *) { Nrf::PostTask([] { MeasurementsTimerHandler(); }); }, nullptr);
+		&sMeasurementsTimer,
+		[](k_timer *) {
+			Nrf::PostTask([] { MeasurementsTimerHandler(); }, Nrf::TaskPriority::Low,
+				      reinterpret_cast<Nrf::TaskCoalescingKey>(&MeasurementsTimerHandler));
+		},
+		nullptr);
 	k_timer_init(
-		&sIdentifyTimer, [](k_timer *) { Nrf::PostTask([] { IdentifyTimerHandler(); }); }, nullptr);
+		&sIdentifyTimer, [](k_timer *) { Nrf::PostTask([] { IdentifyTimerHandler(); }, Nrf::TaskPriority::High); },
+		nullptr);
 	k_timer_start(&sMeasurementsTimer, K_MSEC(kMeasurementsIntervalMs), K_MSEC(kMeasurementsIntervalMs));
 
 	return Nrf::Matter::StartServer();
@@ -24,6 +24,84 @@ static struct sw_codec_config m_config;
 static struct sample_rate_converter_ctx encoder_converters[AUDIO_CH_NUM];
 static struct sample_rate_converter_ctx decoder_converters[AUDIO_CH_NUM];
 
+/* Decoder buffers. These are reused for every frame and are not cleared, as every frame
+ * overwrites the part that is read from them.
+ */
+static struct {
+	/* Decoded mono frames, at the decoder sample rate. */
+	char mono[AUDIO_CH_NUM][PCM_NUM_BYTES_MONO];
+	/* Mono frames converted to the system sample rate. */
+	char converted[AUDIO_CH_NUM][PCM_NUM_BYTES_MONO];
+	/* Interleaved stereo output. */
+	char stereo[PCM_NUM_BYTES_STEREO];
+} dec_bufs;
+
+#if (CONFIG_SW_CODEC_DECODE_STATS)
+#define DECODE_STATS_INTERVAL_NUM 1000
+
+static struct {
+	uint32_t frames;
+	uint64_t cycles_total;
+	uint32_t cycles_max;
+} decode_stats;
+
+static void decode_stats_update(uint32_t cycles)
+{
+	decode_stats.frames++;
+	decode_stats.cycles_total += cycles;
+	decode_stats.cycles_max = MAX(decode_stats.cycles_max, cycles);
+
+	if (decode_stats.frames == DECODE_STATS_INTERVAL_NUM) {
+		LOG_INF("Decode: avg %u cycles (%u us), max %u cycles (%u us)",
+			(uint32_t)(decode_stats.cycles_total / decode_stats.frames),
+			k_cyc_to_us_floor32(decode_stats.cycles_total / decode_stats.frames),
+			decode_stats.cycles_max, k_cyc_to_us_floor32(decode_stats.cycles_max));
+
+		memset(&decode_stats, 0, sizeof(decode_stats));
+	}
+}
+#else
+static void decode_stats_update(uint32_t cycles)
+{
+	ARG_UNUSED(cycles);
+}
+#endif /* (CONFIG_SW_CODEC_DECODE_STATS) */
+
+/**
+ * @brief	Interleave two mono streams into one stereo stream.
+ *
+ * @details	Each sample is written once, so the output buffer does not need to be cleared
+ *		beforehand. A channel without input is filled with zeros.
+ *
+ * @param[in]	input_left	Samples for the left channel, or NULL for silence.
+ * @param[in]	input_right	Samples for the right channel, or NULL for silence.
+ * @param[in]	input_size	Number of bytes in each of the inputs.
+ * @param[out]	output		Interleaved output. Must be of size 2 * @p input_size.
+ */
+static void pcm_interleave(void const *const input_left, void const *const input_right,
+			   size_t input_size, void *output)
+{
+	if (IS_ENABLED(CONFIG_AUDIO_BIT_DEPTH_16)) {
+		int16_t const *left = input_left;
+		int16_t const *right = input_right;
+		int16_t *out = output;
+
+		for (size_t i = 0; i < input_size / sizeof(int16_t); i++) {
+			*out++ = left ? left[i] : 0;
+			*out++ = right ? right[i] : 0;
+		}
+	} else {
+		int32_t const *left = input_left;
+		int32_t const *right = input_right;
+		int32_t *out = output;
+
+		for (size_t i = 0; i < input_size / sizeof(int32_t); i++) {
+			*out++ = left ? left[i] : 0;
+			*out++ = right ? right[i] : 0;
+		}
+	}
+}
+
 /**
  * @brief	Converts the sample rate of the uncompressed audio stream if needed.
  *
@@ -194,119 +272,72 @@ int sw_codec_decode(uint8_t const *const encoded_data, size_t encoded_size, bool
 	}
 
 	int ret;
+	uint32_t start_cycles = 0;
 
-	static char pcm_data_stereo[PCM_NUM_BYTES_STEREO];
-
-	char decoded_data_mono[AUDIO_CH_NUM][PCM_NUM_BYTES_MONO] = {0};
-	char decoded_data_mono_system_sample_rate[AUDIO_CH_NUM][PCM_NUM_BYTES_MONO] = {0};
+	if (IS_ENABLED(CONFIG_SW_CODEC_DECODE_STATS)) {
+		start_cycles = k_cycle_get_32();
+	}
 
-	size_t pcm_size_stereo = 0;
 	size_t pcm_size_mono = 0;
-	size_t decoded_data_size = 0;
+	uint16_t decoded_data_size = 0;
 
 	switch (m_config.sw_codec) {
 	case SW_CODEC_LC3: {
 #if (CONFIG_SW_CODEC_LC3)
-		char *pcm_in_data_ptrs[m_config.decoder.channel_mode];
+		char *pcm_in_data_ptrs[AUDIO_CH_NUM] = {NULL};
 
-		switch (m_config.decoder.channel_mode) {
-		case SW_CODEC_MONO: {
-			if (bad_frame && IS_ENABLED(CONFIG_SW_CODEC_OVERRIDE_PLC)) {
-				memset(decoded_data_mono[AUDIO_CH_L], 0, PCM_NUM_BYTES_MONO);
-				decoded_data_size = PCM_NUM_BYTES_MONO;
-			} else {
-				ret = sw_codec_lc3_dec_run(
-					encoded_data, encoded_size, LC3_PCM_NUM_BYTES_MONO, 0,
-					decoded_data_mono[AUDIO_CH_L],
-					(uint16_t *)&decoded_data_size, bad_frame);
-				if (ret) {
-					return ret;
-				}
-
-				ret = sw_codec_sample_rate_convert(
-					&decoder_converters[AUDIO_CH_L],
-					m_config.decoder.sample_rate_hz,
-					CONFIG_AUDIO_SAMPLE_RATE_HZ, decoded_data_mono[AUDIO_CH_L],
-					decoded_data_size,
-					decoded_data_mono_system_sample_rate[AUDIO_CH_L],
-					&pcm_in_data_ptrs[AUDIO_CH_L], &pcm_size_mono);
-				if (ret) {
-					LOG_ERR("Sample rate conversion failed for mono: %d", ret);
-					return ret;
-				}
-			}
+		if ((m_config.decoder.channel_mode != SW_CODEC_MONO) &&
+		    (m_config.decoder.channel_mode != SW_CODEC_STEREO)) {
+			LOG_ERR("Unsupported channel mode for decoder: %d",
+				m_config.decoder.channel_mode);
+			return -ENODEV;
+		}
 
-			/* For now, i2s is only stereo, so in order to send
-			 * just one channel, we need to insert 0 for the
-			 * other channel
-			 */
-			ret = pscm_zero_pad(pcm_in_data_ptrs[AUDIO_CH_L], pcm_size_mono,
-					    m_config.decoder.audio_ch, CONFIG_AUDIO_BIT_DEPTH_BITS,
-					    pcm_data_stereo, &pcm_size_stereo);
-			if (ret) {
-				return ret;
-			}
+		if ((m_config.decoder.channel_mode == SW_CODEC_MONO) &&
+		    (m_config.decoder.audio_ch >= AUDIO_CH_NUM)) {
+			LOG_ERR("Invalid audio channel for decoder: %d", m_config.decoder.audio_ch);
+			return -EINVAL;
+		}
+
+		if (bad_frame && IS_ENABLED(CONFIG_SW_CODEC_OVERRIDE_PLC)) {
+			memset(dec_bufs.stereo, 0, PCM_NUM_BYTES_STEREO);
+
+			*decoded_size = PCM_NUM_BYTES_STEREO;
+			*decoded_data = dec_bufs.stereo;
 			break;
 		}
-		case SW_CODEC_STEREO: {
-			if (bad_frame && IS_ENABLED(CONFIG_SW_CODEC_OVERRIDE_PLC)) {
-				memset(decoded_data_mono[AUDIO_CH_L], 0, PCM_NUM_BYTES_MONO);
-				memset(decoded_data_mono[AUDIO_CH_R], 0, PCM_NUM_BYTES_MONO);
-				decoded_data_size = PCM_NUM_BYTES_MONO;
-			} else {
-				/* Decode left channel */
-				ret = sw_codec_lc3_dec_run(
-					encoded_data, encoded_size / 2, LC3_PCM_NUM_BYTES_MONO,
-					AUDIO_CH_L, decoded_data_mono[AUDIO_CH_L],
-					(uint16_t *)&decoded_data_size, bad_frame);
-				if (ret) {
-					return ret;
-				}
-
-				/* Decode right channel */
-				ret = sw_codec_lc3_dec_run(
-					(encoded_data + (encoded_size / 2)), encoded_size / 2,
-					LC3_PCM_NUM_BYTES_MONO, AUDIO_CH_R,
-					decoded_data_mono[AUDIO_CH_R],
-					(uint16_t *)&decoded_data_size, bad_frame);
-				if (ret) {
-					return ret;
-				}
-
-				for (int i = 0; i < m_config.decoder.channel_mode; ++i) {
-					ret = sw_codec_sample_rate_convert(
-						&decoder_converters[i],
-						m_config.decoder.sample_rate_hz,
-						CONFIG_AUDIO_SAMPLE_RATE_HZ, decoded_data_mono[i],
-						decoded_data_size,
-						decoded_data_mono_system_sample_rate[i],
-						&pcm_in_data_ptrs[i], &pcm_size_mono);
-					if (ret) {
-						LOG_ERR("Sample rate conversion failed for channel "
-							"%d : %d",
-							i, ret);
-						return ret;
-					}
-				}
+
+		for (int i = 0; i < m_config.decoder.channel_mode; i++) {
+			enum audio_channel ch = (m_config.decoder.channel_mode == SW_CODEC_MONO)
+							? m_config.decoder.audio_ch
+							: i;
+			size_t frame_size = encoded_size / m_config.decoder.channel_mode;
+
+			ret = sw_codec_lc3_dec_run(encoded_data + (i * frame_size), frame_size,
+						   LC3_PCM_NUM_BYTES_MONO, i, dec_bufs.mono[i],
+						   &decoded_data_size, bad_frame);
+			if (ret) {
+				return ret;
 			}
 
-			ret = pscm_combine(pcm_in_data_ptrs[AUDIO_CH_L],
-					   pcm_in_data_ptrs[AUDIO_CH_R], pcm_size_mono,
-					   CONFIG_AUDIO_BIT_DEPTH_BITS, pcm_data_stereo,
-					   &pcm_size_stereo);
+			ret = sw_codec_sample_rate_convert(
+				&decoder_converters[i], m_config.decoder.sample_rate_hz,
+				CONFIG_AUDIO_SAMPLE_RATE_HZ, dec_bufs.mono[i], decoded_data_size,
+				dec_bufs.converted[i], &pcm_in_data_ptrs[ch], &pcm_size_mono);
 			if (ret) {
+				LOG_ERR("Sample rate conversion failed for channel %d: %d", i, ret);
 				return ret;
 			}
-			break;
-		}
-		default:
-			LOG_ERR("Unsupported channel mode for decoder: %d",
-				m_config.decoder.channel_mode);
-			return -ENODEV;
 		}
 
-		*decoded_size = pcm_size_stereo;
-		*decoded_data = pcm_data_stereo;
+		/* For now, I2S is only stereo. In mono mode, the channel without data is filled
+		 * with zeros in the same pass.
+		 */
+		pcm_interleave(pcm_in_data_ptrs[AUDIO_CH_L], pcm_in_data_ptrs[AUDIO_CH_R],
+			       pcm_size_mono, dec_bufs.stereo);
+
+		*decoded_size = pcm_size_mono * 2;
+		*decoded_data = dec_bufs.stereo;
 #endif /* (CONFIG_SW_CODEC_LC3) */
 		break;
 	}
@@ -314,6 +345,11 @@ int sw_codec_decode(uint8_t const *const encoded_data, size_t encoded_size, bool
 		LOG_ERR("Unsupported codec: %d", m_config.sw_codec);
 		return -ENODEV;
 	}
+
+	if (IS_ENABLED(CONFIG_SW_CODEC_DECODE_STATS)) {
+		decode_stats_update(k_cycle_get_32() - start_cycles);
+	}
+
 	return 0;
 }
 
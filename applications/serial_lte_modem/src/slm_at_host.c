@@ -40,6 +40,7 @@ enum slm_operation_mode {
 static struct slm_at_backend at_backend;
 static enum slm_operation_mode at_mode;
 static slm_datamode_handler_t datamode_handler;
+static bool datamode_stream; /* Data mode handler accepts data in arbitrary chunks. */
 static int datamode_handler_result;
 uint16_t slm_datamode_time_limit; /* Send trigger by time in data mode */
 K_MUTEX_DEFINE(mutex_mode); /* Protects the operation mode variables. */
@@ -109,6 +110,7 @@ static bool exit_datamode(void)
 			(void)datamode_handler(DATAMODE_EXIT, NULL, 0, SLM_DATAMODE_FLAGS_NONE);
 		}
 		datamode_handler = NULL;
+		datamode_stream = false;
 
 		k_mutex_lock(&mutex_data, K_FOREVER);
 		ring_buf_reset(&data_rb);
@@ -190,6 +192,55 @@ static void write_data_buf(const uint8_t *buf, size_t len)
 	}
 }
 
+/* Lock mutex_data, before calling.
+ * Hand the data directly to a stream data mode handler, when there is enough of it.
+ * The data stays in the UART RX buffer, which is held until the handler returns.
+ */
+static void write_data(const uint8_t *buf, size_t len)
+{
+	int size_sent;
+	bool stream;
+
+	k_mutex_lock(&mutex_mode, K_FOREVER);
+	stream = datamode_stream;
+	k_mutex_unlock(&mutex_mode);
+
+	if (!stream || CONFIG_SLM_DATAMODE_ZERO_COPY_MIN_SIZE == 0 ||
+	    len < CONFIG_SLM_DATAMODE_ZERO_COPY_MIN_SIZE) {
+		write_data_buf(buf, len);
+		return;
+	}
+
+	/* Send the buffered data first to keep the order. */
+	if (!ring_buf_is_empty(&data_rb)) {
+		raw_send(SLM_DATAMODE_FLAGS_MORE_DATA);
+	}
+
+	LOG_HEXDUMP_DBG(buf, MIN(len, HEXDUMP_LIMIT), "RX");
+	k_mutex_lock(&mutex_mode, K_FOREVER);
+	if (datamode_handler) {
+		size_sent = datamode_handler(DATAMODE_SEND, buf, len, SLM_DATAMODE_FLAGS_NONE);
+	} else {
+		LOG_WRN("no handler, %d dropped", len);
+		size_sent = len;
+	}
+	k_mutex_unlock(&mutex_mode);
+
+	if (size_sent < 0) {
+		LOG_WRN("Raw send failed, %d dropped", len);
+		size_sent = len;
+	} else if (size_sent == 0) {
+		size_sent = len;
+	}
+
+#if defined(CONFIG_SLM_DATAMODE_URC)
+	rsp_send("\r\n#XDATAMODE: %d\r\n", size_sent);
+#endif
+
+	/* Buffer what the handler did not take. */
+	write_data_buf(buf + size_sent, len - size_sent);
+}
+
 static void raw_send_scheduled(struct k_work *work)
 {
 	ARG_UNUSED(work);
@@ -257,7 +308,7 @@ static size_t raw_rx_handler(const uint8_t *buf, const size_t len)
 		write_data_buf(slm_quit_str, prev_quit_str_match_count);
 
 		/* Write data from buf until the start of the possible (partial) quit_str. */
-		write_data_buf(buf, processed - quit_str_match_count);
+		write_data(buf, processed - quit_str_match_count);
 	} else {
 		/* Nothing to write this round.*/
 	}
@@ -762,7 +813,7 @@ void data_send(const uint8_t *data, size_t len)
 	slm_at_send_indicate(data, len, false, true);
 }
 
-int enter_datamode(slm_datamode_handler_t handler)
+static int datamode_enter(slm_datamode_handler_t handler, bool stream)
 {
 	k_mutex_lock(&mutex_mode, K_FOREVER);
 
@@ -777,6 +828,7 @@ int enter_datamode(slm_datamode_handler_t handler)
 	k_mutex_unlock(&mutex_data);
 
 	datamode_handler = handler;
+	datamode_stream = stream;
 	if (slm_datamode_time_limit == 0) {
 		if (slm_uart_baudrate > 0) {
 			slm_datamode_time_limit = CONFIG_SLM_UART_RX_BUF_SIZE * (8 + 1 + 1) * 1000 /
@@ -794,6 +846,16 @@ int enter_datamode(slm_datamode_handler_t handler)
 	return 0;
 }
 
+int enter_datamode(slm_datamode_handler_t handler)
+{
+	return datamode_enter(handler, false);
+}
+
+int enter_datamode_stream(slm_datamode_handler_t handler)
+{
+	return datamode_enter(handler, true);
+}
+
 bool in_datamode(void)
 {
 	return (get_slm_mode() == SLM_DATA_MODE);
@@ -810,6 +872,7 @@ bool exit_datamode_handler(int result)
 			(void)datamode_handler(DATAMODE_EXIT, NULL, 0, SLM_DATAMODE_FLAGS_NONE);
 		}
 		datamode_handler = NULL;
+		datamode_stream = false;
 		datamode_handler_result = result;
 		ret = true;
 
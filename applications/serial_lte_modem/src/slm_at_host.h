@@ -130,6 +130,20 @@ void data_send(const uint8_t *data, size_t len);
  */
 int enter_datamode(slm_datamode_handler_t handler);
 
+/**
+ * @brief Request SLM AT host to enter data mode for a stream
+ *
+ * Same as @ref enter_datamode, but the data may be split or merged freely
+ * before it is given to the handler. Large chunks of data are given to the
+ * handler directly from the UART RX buffer, without copying.
+ *
+ * @param handler Data mode handler provided by requesting module
+ *
+ * @retval 0 If the operation was successful.
+ *         Otherwise, a (negative) error code is returned.
+ */
+int enter_datamode_stream(slm_datamode_handler_t handler);
+
 /**
  * @brief Check whether SLM AT host is in data mode
  *
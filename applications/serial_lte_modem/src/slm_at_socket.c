@@ -1467,6 +1467,8 @@ static int handle_at_send(enum at_cmd_type cmd_type, const struct at_param_list
 				return err;
 			}
 			err = do_send(data, size);
+		} else if (sock.type == SOCK_STREAM) {
+			err = enter_datamode_stream(socket_datamode_callback);
 		} else {
 			err = enter_datamode(socket_datamode_callback);
 		}
@@ -784,7 +784,7 @@ static int handle_at_tcp_send(enum at_cmd_type cmd_type, const struct at_param_l
 			}
 			err = do_tcp_send(data, size);
 		} else {
-			err = enter_datamode(tcp_datamode_callback);
+			err = enter_datamode_stream(tcp_datamode_callback);
 		}
 		break;
 
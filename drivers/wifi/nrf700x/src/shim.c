@@ -30,6 +30,134 @@ LOG_MODULE_REGISTER(wifi_nrf, CONFIG_WIFI_NRF700X_LOG_LEVEL);
 
 struct zep_shim_intr_priv *intr_priv;
 
+struct nwb {
+	unsigned char *data;
+	unsigned char *tail;
+	int len;
+	int headroom;
+	void *next;
+	void *priv;
+	int iftype;
+	void *ifaddr;
+	void *dev;
+	int hostbuffer;
+	void *cleanup_ctx;
+	void (*cleanup_cb)();
+	unsigned char priority;
+	bool chksum_done;
+};
+
+#ifdef CONFIG_NRF_WIFI_SHIM_MEM_POOLS
+/* Network buffers in flight: RX buffers handed to the RPU plus the
+ * maximum number of aggregated TX frames the RPU can own at a time.
+ */
+#define SHIM_NBUF_POOL_SIZE (CONFIG_NRF700X_RX_NUM_BUFS + \
+			     CONFIG_NRF700X_MAX_TX_TOKENS * CONFIG_NRF700X_MAX_TX_AGGREGATION + \
+			     CONFIG_NRF_WIFI_SHIM_NBUF_POOL_EXTRA)
+
+/* Every queued network buffer sits on a linked list node. */
+#define SHIM_LLIST_NODE_POOL_SIZE (SHIM_NBUF_POOL_SIZE + \
+				   CONFIG_NRF_WIFI_SHIM_LLIST_NODE_POOL_EXTRA)
+
+struct zep_shim_mem_pool {
+	const char *name;
+	struct k_mem_slab *slab;
+	size_t block_size;
+	unsigned int num_blocks;
+	atomic_t max_used;
+	atomic_t alloc_fails;
+};
+
+#define SHIM_MEM_POOL_DEFINE(_name, _block_size, _num_blocks)                        \
+	K_MEM_SLAB_DEFINE_STATIC(shim_slab_##_name, WB_UP(_block_size), (_num_blocks),  \
+				 sizeof(void *));                                       \
+	static struct zep_shim_mem_pool shim_pool_##_name = {                          \
+		.name = #_name,                                                        \
+		.slab = &shim_slab_##_name,                                            \
+		.block_size = WB_UP(_block_size),                                      \
+		.num_blocks = (_num_blocks),                                           \
+	}
+
+SHIM_MEM_POOL_DEFINE(llist_node, sizeof(struct zep_shim_llist_node), SHIM_LLIST_NODE_POOL_SIZE);
+SHIM_MEM_POOL_DEFINE(llist, sizeof(struct zep_shim_llist), CONFIG_NRF_WIFI_SHIM_LLIST_POOL_SIZE);
+SHIM_MEM_POOL_DEFINE(spinlock, sizeof(struct k_sem), CONFIG_NRF_WIFI_SHIM_SPINLOCK_POOL_SIZE);
+SHIM_MEM_POOL_DEFINE(nbuf, sizeof(struct nwb), SHIM_NBUF_POOL_SIZE);
+#ifdef CONFIG_NRF_WIFI_SHIM_NBUF_DATA_POOL
+SHIM_MEM_POOL_DEFINE(nbuf_data, CONFIG_NRF_WIFI_SHIM_NBUF_DATA_POOL_BLOCK_SIZE,
+		     CONFIG_NRF_WIFI_SHIM_NBUF_DATA_POOL_SIZE);
+#endif /* CONFIG_NRF_WIFI_SHIM_NBUF_DATA_POOL */
+
+static struct zep_shim_mem_pool *const shim_pools[] = {
+	&shim_pool_llist_node,
+	&shim_pool_llist,
+	&shim_pool_spinlock,
+	&shim_pool_nbuf,
+#ifdef CONFIG_NRF_WIFI_SHIM_NBUF_DATA_POOL
+	&shim_pool_nbuf_data,
+#endif /* CONFIG_NRF_WIFI_SHIM_NBUF_DATA_POOL */
+};
+
+static void *zep_shim_pool_zalloc(struct zep_shim_mem_pool *pool, size_t size)
+{
+	void *block;
+	atomic_val_t used;
+	atomic_val_t max_used;
+
+	if (k_mem_slab_alloc(pool->slab, &block, K_NO_WAIT) != 0) {
+		atomic_inc(&pool->alloc_fails);
+		return k_calloc(size, sizeof(char));
+	}
+
+	used = k_mem_slab_num_used_get(pool->slab);
+
+	do {
+		max_used = atomic_get(&pool->max_used);
+	} while (used > max_used && !atomic_cas(&pool->max_used, max_used, used));
+
+	memset(block, 0, size);
+
+	return block;
+}
+
+static void zep_shim_pool_free(struct zep_shim_mem_pool *pool, void *block)
+{
+	char *addr = block;
+
+	if (addr >= pool->slab->buffer &&
+	    addr < pool->slab->buffer + pool->num_blocks * pool->block_size) {
+		k_mem_slab_free(pool->slab, block);
+	} else {
+		k_free(block);
+	}
+}
+
+int zep_shim_mem_pool_stats_get(unsigned int idx, struct zep_shim_mem_pool_stats *stats)
+{
+	const struct zep_shim_mem_pool *pool;
+
+	if (idx >= ARRAY_SIZE(shim_pools)) {
+		return -ENOENT;
+	}
+
+	pool = shim_pools[idx];
+
+	stats->name = pool->name;
+	stats->block_size = pool->block_size;
+	stats->num_blocks = pool->num_blocks;
+	stats->num_used = k_mem_slab_num_used_get(pool->slab);
+	stats->max_used = atomic_get(&pool->max_used);
+	stats->alloc_fails = atomic_get(&pool->alloc_fails);
+
+	return 0;
+}
+
+#define SHIM_POOL_ZALLOC(_name, _size) zep_shim_pool_zalloc(&shim_pool_##_name, (_size))
+#define SHIM_POOL_FREE(_name, _block) zep_shim_pool_free(&shim_pool_##_name, (_block))
+#else
+#define SHIM_POOL_ZALLOC(_name, _size) k_calloc((_size), sizeof(char))
+#define SHIM_POOL_FREE(_name, _block) k_free(_block)
+#endif /* CONFIG_NRF_WIFI_SHIM_MEM_POOLS */
+
 static void *zep_shim_mem_alloc(size_t size)
 {
 	size = (size + 4) & 0xfffffffc;
@@ -122,7 +250,7 @@ static void *zep_shim_spinlock_alloc(void)
 {
 	struct k_sem *lock = NULL;
 
-	lock = k_malloc(sizeof(*lock));
+	lock = SHIM_POOL_ZALLOC(spinlock, sizeof(*lock));
 
 	if (!lock) {
 		LOG_ERR("%s: Unable to allocate memory for spinlock", __func__);
@@ -133,7 +261,7 @@ static void *zep_shim_spinlock_alloc(void)
 
 static void zep_shim_spinlock_free(void *lock)
 {
-	k_free(lock);
+	SHIM_POOL_FREE(spinlock, lock);
 }
 
 static void zep_shim_spinlock_init(void *lock)
@@ -194,36 +322,27 @@ static int zep_shim_pr_err(const char *fmt, va_list args)
 	return 0;
 }
 
-struct nwb {
-	unsigned char *data;
-	unsigned char *tail;
-	int len;
-	int headroom;
-	void *next;
-	void *priv;
-	int iftype;
-	void *ifaddr;
-	void *dev;
-	int hostbuffer;
-	void *cleanup_ctx;
-	void (*cleanup_cb)();
-	unsigned char priority;
-	bool chksum_done;
-};
-
 static void *zep_shim_nbuf_alloc(unsigned int size)
 {
 	struct nwb *nwb;
 
-	nwb = (struct nwb *)k_calloc(sizeof(struct nwb), sizeof(char));
+	nwb = (struct nwb *)SHIM_POOL_ZALLOC(nbuf, sizeof(struct nwb));
 
 	if (!nwb)
 		return NULL;
 
+#ifdef CONFIG_NRF_WIFI_SHIM_NBUF_DATA_POOL
+	if (size <= CONFIG_NRF_WIFI_SHIM_NBUF_DATA_POOL_BLOCK_SIZE) {
+		nwb->priv = SHIM_POOL_ZALLOC(nbuf_data, size);
+	} else {
+		nwb->priv = k_calloc(size, sizeof(char));
+	}
+#else
 	nwb->priv = k_calloc(size, sizeof(char));
+#endif /* CONFIG_NRF_WIFI_SHIM_NBUF_DATA_POOL */
 
 	if (!nwb->priv) {
-		k_free(nwb);
+		SHIM_POOL_FREE(nbuf, nwb);
 		return NULL;
 	}
 
@@ -242,9 +361,13 @@ static void zep_shim_nbuf_free(void *nbuf)
 
 	nwb = nbuf;
 
-	k_free(((struct nwb *)nbuf)->priv);
+#ifdef CONFIG_NRF_WIFI_SHIM_NBUF_DATA_POOL
+	SHIM_POOL_FREE(nbuf_data, nwb->priv);
+#else
+	k_free(nwb->priv);
+#endif /* CONFIG_NRF_WIFI_SHIM_NBUF_DATA_POOL */
 
-	k_free(nbuf);
+	SHIM_POOL_FREE(nbuf, nwb);
 }
 
 static void zep_shim_nbuf_headroom_res(void *nbuf, unsigned int size)
@@ -445,7 +568,7 @@ static void *zep_shim_llist_node_alloc(void)
 {
 	struct zep_shim_llist_node *llist_node = NULL;
 
-	llist_node = k_calloc(sizeof(*llist_node), sizeof(char));
+	llist_node = SHIM_POOL_ZALLOC(llist_node, sizeof(*llist_node));
 
 	if (!llist_node) {
 		LOG_ERR("%s: Unable to allocate memory for linked list node", __func__);
@@ -459,7 +582,7 @@ static void *zep_shim_llist_node_alloc(void)
 
 static void zep_shim_llist_node_free(void *llist_node)
 {
-	k_free(llist_node);
+	SHIM_POOL_FREE(llist_node, llist_node);
 }
 
 static void *zep_shim_llist_node_data_get(void *llist_node)
@@ -484,7 +607,7 @@ static void *zep_shim_llist_alloc(void)
 {
 	struct zep_shim_llist *llist = NULL;
 
-	llist = k_calloc(sizeof(*llist), sizeof(char));
+	llist = SHIM_POOL_ZALLOC(llist, sizeof(*llist));
 
 	if (!llist) {
 		LOG_ERR("%s: Unable to allocate memory for linked list", __func__);
@@ -495,7 +618,7 @@ static void *zep_shim_llist_alloc(void)
 
 static void zep_shim_llist_free(void *llist)
 {
-	k_free(llist);
+	SHIM_POOL_FREE(llist, llist);
 }
 
 static void zep_shim_llist_init(void *llist)
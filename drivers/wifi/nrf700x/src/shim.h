@@ -55,6 +55,36 @@ struct zep_shim_llist {
 	unsigned int len;
 };
 
+#ifdef CONFIG_NRF_WIFI_SHIM_MEM_POOLS
+/**
+ * struct zep_shim_mem_pool_stats - Usage statistics of a shim memory pool.
+ * @name: Name of the pool.
+ * @block_size: Size of a single block in bytes.
+ * @num_blocks: Total number of blocks in the pool.
+ * @num_used: Number of blocks currently allocated.
+ * @max_used: Highest number of blocks allocated at the same time.
+ * @alloc_fails: Number of allocations that found the pool exhausted and
+ *               had to fall back to the system heap.
+ */
+struct zep_shim_mem_pool_stats {
+	const char *name;
+	size_t block_size;
+	unsigned int num_blocks;
+	unsigned int num_used;
+	unsigned int max_used;
+	unsigned int alloc_fails;
+};
+
+/**
+ * zep_shim_mem_pool_stats_get() - Get the statistics of a shim memory pool.
+ * @idx: Index of the pool, starting from 0.
+ * @stats: Statistics of the pool.
+ *
+ * Return: 0 on success, -ENOENT if there is no pool with the given index.
+ */
+int zep_shim_mem_pool_stats_get(unsigned int idx, struct zep_shim_mem_pool_stats *stats);
+#endif /* CONFIG_NRF_WIFI_SHIM_MEM_POOLS */
+
 void *net_pkt_to_nbuf(struct net_pkt *pkt);
 void *net_pkt_from_nbuf(void *iface, void *frm);
 #if defined(CONFIG_NRF700X_RAW_DATA_RX) || defined(CONFIG_NRF700X_PROMISC_DATA_RX)
@@ -13,6 +13,7 @@
 #include "fmac_util.h"
 #include "fmac_main.h"
 #include "wifi_util.h"
+#include "shim.h"
 
 extern struct nrf_wifi_drv_priv_zep rpu_drv_priv_zep;
 struct nrf_wifi_ctx_zep *ctx = &rpu_drv_priv_zep.rpu_ctx_zep;
@@ -435,6 +436,33 @@ static int nrf_wifi_util_show_vers(const struct shell *shell,
 	return status;
 }
 
+#ifdef CONFIG_NRF_WIFI_SHIM_MEM_POOLS
+static int nrf_wifi_util_mem_pool_stats(const struct shell *shell,
+					size_t argc,
+					const char *argv[])
+{
+	struct zep_shim_mem_pool_stats stats;
+	unsigned int i;
+
+	shell_fprintf(shell, SHELL_INFO,
+		      "%-12s %6s %6s %6s %6s %6s\n",
+		      "pool", "size", "total", "used", "max", "fails");
+
+	for (i = 0; zep_shim_mem_pool_stats_get(i, &stats) == 0; i++) {
+		shell_fprintf(shell, SHELL_INFO,
+			      "%-12s %6zu %6u %6u %6u %6u\n",
+			      stats.name,
+			      stats.block_size,
+			      stats.num_blocks,
+			      stats.num_used,
+			      stats.max_used,
+			      stats.alloc_fails);
+	}
+
+	return 0;
+}
+#endif /* CONFIG_NRF_WIFI_SHIM_MEM_POOLS */
+
 #ifndef CONFIG_NRF700X_RADIO_TEST
 static int nrf_wifi_util_dump_rpu_stats(const struct shell *shell,
 					size_t argc,
@@ -940,6 +968,15 @@ SHELL_STATIC_SUBCMD_SET_CREATE(
 		      1,
 		      1),
 #endif /* CONFIG_NRF700X_RADIO_TEST */
+#ifdef CONFIG_NRF_WIFI_SHIM_MEM_POOLS
+	SHELL_CMD_ARG(mem_pool_stats,
+		      NULL,
+		      "Display usage, high-water mark and allocation failures\n"
+		      "of the OS shim memory pools",
+		      nrf_wifi_util_mem_pool_stats,
+		      1,
+		      0),
+#endif /* CONFIG_NRF_WIFI_SHIM_MEM_POOLS */
 	SHELL_SUBCMD_SET_END);
 
 
@@ -13,6 +13,7 @@ extern "C" {
 
 #include <stdbool.h>
 #include <fw_info.h>
+#include <bl_crypto.h>
 #include <zephyr/types.h>
 
 /** @defgroup bl_validation Bootloader firmware validation
@@ -57,6 +58,80 @@ bool bl_validate_firmware_available(void);
 bool bl_validate_firmware_local(uint32_t fw_address,
 				const struct fw_info *fwinfo);
 
+/** Context for validating firmware while it is read or copied in chunks.
+ *
+ * @details The members are internal to the library.
+ */
+struct bl_validate_stream_ctx {
+	/** Hash context for the firmware digest. */
+	bl_sha256_ctx_t sha_ctx;
+	/** Firmware info of the firmware, NULL if not initialized. */
+	const struct fw_info *fw_info;
+	/** Validation info of the firmware. */
+	const void *fw_val_info;
+	/** Number of bytes of the firmware that have been hashed. */
+	uint32_t hashed_len;
+};
+
+/** Start validating firmware in chunks.
+ *
+ * @details This runs the same checks as @ref bl_validate_firmware on the
+ *          firmware info and validation info at @p fw_src_address. The digest
+ *          is then computed over the chunks passed to
+ *          @ref bl_validate_firmware_stream_update, and checked in
+ *          @ref bl_validate_firmware_stream_finalize.
+ *
+ *          This allows the firmware to be validated while it is copied to
+ *          @p fw_dst_address, by passing each chunk as it is read from
+ *          @p fw_src_address.
+ *
+ * @note This function is only available to the bootloader.
+ *
+ * @param[out] ctx             Validation context.
+ * @param[in]  fw_dst_address  Address where the firmware will be written.
+ * @param[in]  fw_src_address  Address of the firmware to be validated.
+ *
+ * @retval 0        On success.
+ * @retval -EINVAL  If @p ctx is NULL, or if the firmware info or validation
+ *                  info is invalid.
+ * @return Any error code from @ref bl_crypto_init or @ref bl_sha256_init.
+ */
+int bl_validate_firmware_stream_init(struct bl_validate_stream_ctx *ctx,
+				     uint32_t fw_dst_address,
+				     uint32_t fw_src_address);
+
+/** Add the next chunk of the firmware to the digest.
+ *
+ * @details Chunks must be passed in order, starting at the beginning of the
+ *          firmware. Data beyond the end of the firmware, such as the
+ *          validation info, is ignored.
+ *
+ * @note This function is only available to the bootloader.
+ *
+ * @param[in,out] ctx       Validation context.
+ * @param[in]     data      Next chunk of the firmware.
+ * @param[in]     data_len  Length of @p data.
+ *
+ * @retval 0        On success.
+ * @retval -EINVAL  If @p ctx is NULL or not initialized.
+ * @return Any error code from @ref bl_sha256_update.
+ */
+int bl_validate_firmware_stream_update(struct bl_validate_stream_ctx *ctx,
+				       const uint8_t *data, uint32_t data_len);
+
+/** Check the digest, and the signature if configured, of the firmware.
+ *
+ * @details The context must be initialized again before it can be reused.
+ *
+ * @note This function is only available to the bootloader.
+ *
+ * @param[in,out] ctx  Validation context.
+ *
+ * @retval true   if the whole firmware was passed and is valid
+ * @retval false  if the firmware is incomplete or invalid
+ */
+bool bl_validate_firmware_stream_finalize(struct bl_validate_stream_ctx *ctx);
+
 
 /**
  * @brief Structure describing the BL_VALIDATE_FW EXT_API.
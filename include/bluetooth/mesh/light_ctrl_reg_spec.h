@@ -37,10 +37,38 @@ extern "C" {
 struct bt_mesh_light_ctrl_reg_spec {
 	/** Common regulator context. */
 	struct bt_mesh_light_ctrl_reg reg;
+#if defined(CONFIG_BT_MESH_LIGHT_CTRL_REG_SPEC_FIXED_POINT)
+	/** Node in the list of running regulators. */
+	sys_snode_t node;
+	/** Internal integral sum, in Q16.16 fixed-point format. */
+	int64_t i;
+	/** Last regulator output. */
+	float output;
+/** @cond INTERNAL_HIDDEN */
+	/* Fixed-point copies of the floating point inputs of the regulator, and the values
+	 * they were converted from. They are only converted again when the inputs change.
+	 */
+	struct bt_mesh_light_ctrl_reg_cfg cfg;
+	int64_t kp_up;
+	int64_t kp_down;
+	int64_t ki_up;
+	int64_t ki_down;
+	int64_t accuracy;
+	uint32_t measured_raw;
+	int64_t measured;
+	uint32_t target_raw;
+	int64_t target;
+	uint32_t prev_target_raw;
+	int64_t prev_target;
+	/* The error was within the accuracy band in the last step. */
+	bool idle;
+/** @endcond */
+#else
 	/** Regulator step timer. */
 	struct k_work_delayable timer;
 	/** Internal integral sum. */
 	float i;
+#endif
 	/** Regulator enabled flag. */
 	bool enabled;
 	/* If true, internal integral sum can be negative until it becomes positive. */
@@ -124,6 +124,30 @@ const void *pcd_cmd_data_ptr_get(void);
  */
 int pcd_fw_copy(const struct device *fdev);
 
+/** @brief Callback for the data copied by @ref pcd_fw_copy_cb.
+ *
+ * @param buf    Next chunk of the DFU image, before it is written.
+ * @param len    Length of the chunk.
+ * @param offset Offset of the chunk within the DFU image.
+ *
+ * @retval 0 to continue the transfer, negative errno code to abort it.
+ */
+typedef int (*pcd_fw_copy_cb_t)(const uint8_t *buf, size_t len, size_t offset);
+
+/** @brief Perform the DFU image transfer, passing the copied data to a
+ *	   callback.
+ *
+ * Same as @ref pcd_fw_copy, but every chunk of the DFU image is passed to
+ * @p cb, in order, before it is written. This allows the image to be
+ * validated while it is copied, without reading it again.
+ *
+ * @param fdev The flash device to transfer the DFU image to.
+ * @param cb   Callback for the copied data, or NULL.
+ *
+ * @retval non-negative integer on success, negative errno code on failure.
+ */
+int pcd_fw_copy_cb(const struct device *fdev, pcd_fw_copy_cb_t cb);
+
 #ifdef CONFIG_PCD_READ_NETCORE_APP_VERSION
 /** @brief Set up the PCD command structure and point the data buffer to version
  *
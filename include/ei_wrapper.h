@@ -58,6 +58,17 @@ size_t ei_wrapper_get_frame_size(void);
 size_t ei_wrapper_get_window_size(void);
 
 
+/** Get the size of the input slice.
+ *
+ * In continuous mode, every prediction processes one slice of the input
+ * window. Otherwise, the slice size is equal to the window size.
+ *
+ * @return Size of the input slice, expressed as a number of floating-point
+ *         values.
+ */
+size_t ei_wrapper_get_slice_size(void);
+
+
 /** Get input data sampling frequency of the classifier.
  *
  * @return The sampling frequency in Hz.
@@ -118,6 +129,12 @@ int ei_wrapper_clear_data(bool *cancelled);
  * If there is not enough data in the input buffer, the prediction start is
  * delayed until the missing data is added.
  *
+ * In continuous mode (@kconfig{CONFIG_EI_WRAPPER_CONTINUOUS}), the first
+ * prediction after the data is cleared must be started with no shift. Every
+ * following prediction must shift the input window by exactly one slice (see
+ * @ref ei_wrapper_get_slice_size), so that the slices are processed back to
+ * back. Otherwise, the function returns -EINVAL.
+ *
  * @param[in] window_shift  Number of windows the input window is shifted before
  *                          prediction.
  * @param[in] frame_shift   Number of frames the input window is shifted before
@@ -23,6 +23,24 @@
 extern "C" {
 #endif
 
+/**
+ * Entry ID reserved by the emergency data storage when
+ * @kconfig{CONFIG_EMDS_FLUSH} is enabled.
+ */
+#define EMDS_FLUSH_MARKER_ID 0xFFFF
+
+/**
+ * @struct emds_flush_state
+ *
+ * Flush state of an entry, used internally by @ref emds_flush.
+ */
+struct emds_flush_state {
+	/** Checksum of the data when the entry was last checked. */
+	uint32_t crc;
+	/** Flush flags. */
+	uint8_t flags;
+};
+
 /**
  * @struct emds_entry
  *
@@ -35,6 +53,10 @@ struct emds_entry {
 	uint8_t *data;
 	/** Length of data that will be stored. */
 	size_t len;
+#if defined(CONFIG_EMDS_FLUSH) || defined(__DOXYGEN__)
+	/** Flush state of the entry. */
+	struct emds_flush_state *flush;
+#endif
 };
 
 /**
@@ -46,6 +68,10 @@ struct emds_entry {
 struct emds_dynamic_entry {
 	struct emds_entry entry;
 	sys_snode_t node;
+#if defined(CONFIG_EMDS_FLUSH) || defined(__DOXYGEN__)
+	/** Flush state of the entry. */
+	struct emds_flush_state flush_state;
+#endif
 };
 
 /**
@@ -60,10 +86,14 @@ struct emds_dynamic_entry {
  * This creates a variable _name prepended by emds_.
  */
 #define EMDS_STATIC_ENTRY_DEFINE(_name, _id, _data, _len)                      \
+	IF_ENABLED(CONFIG_EMDS_FLUSH,                                          \
+		   (static struct emds_flush_state emds_flush_##_name;))       \
 	static const STRUCT_SECTION_ITERABLE(emds_entry, emds_##_name) = {     \
 		.id = _id,                                                     \
 		.data = (uint8_t *)_data,                                      \
 		.len = _len,                                                   \
+		IF_ENABLED(CONFIG_EMDS_FLUSH,                                  \
+			   (.flush = &emds_flush_##_name,))                    \
 	}
 
 /**
@@ -130,11 +160,43 @@ int emds_entry_add(struct emds_dynamic_entry *entry);
  * with MPSL, make sure to uninitialize the MPSL before this function is called.
  * Otherwise, an assertion may be triggered by the exit of the function.
  *
+ * If @kconfig{CONFIG_EMDS_FLUSH} is enabled, entries that have been written by
+ * @ref emds_flush and have not changed since are skipped.
+ *
  * @retval 0 Success
  * @retval -ERRNO errno code if error
  */
 int emds_store(void);
 
+/**
+ * @brief Write unchanged entries to the emergency data storage ahead of time.
+ *
+ * Writes the entries whose data has not changed since the previous call to
+ * this function, and that have not already been written, through the flash
+ * driver. @ref emds_store then only has to write the entries that have changed
+ * since, which shortens the time it needs with interrupts locked.
+ *
+ * Entries are compared using a checksum of their data. Flushing only stops
+ * when the remaining space is needed for a worst case @ref emds_store, so
+ * calling this function never makes the store fail.
+ *
+ * Flushed entries are only loaded by @ref emds_load if @ref emds_store has
+ * completed after them. Otherwise, @ref emds_load ignores them and loads the
+ * entries of the last completed store.
+ *
+ * This function can be called after @ref emds_prepare, from a thread, for
+ * example when the system is idle. If @kconfig{CONFIG_EMDS_FLUSH_INTERVAL} is
+ * not zero, it is also called periodically from a thread with the lowest
+ * application priority.
+ *
+ * @retval 0 Success
+ * @retval -ECANCELED The storage is not prepared, or the store has started.
+ * @retval -ENOMEM Not enough space left for flushing more entries.
+ * @retval -ENOTSUP @kconfig{CONFIG_EMDS_FLUSH} is not enabled.
+ * @retval -ERRNO errno code if error
+ */
+int emds_flush(void);
+
 /**
  * @brief Load all static data from the emergency data storage.
  *
@@ -180,10 +242,24 @@ int emds_prepare(void);
  * registered in the entries. This value is dependent on the chip used, and
  * should be checked against the chip datasheet.
  *
+ * This is the worst case, where all entries have changed since they were
+ * flushed.
+ *
  * @return Time needed to store all data (in microseconds).
  */
 uint32_t emds_store_time_get(void);
 
+/**
+ * @brief Estimate the time needed to store the data that has not been flushed.
+ *
+ * Estimate how much time it takes to store the entries that have not been
+ * written by @ref emds_flush, or that have changed since. Without
+ * @kconfig{CONFIG_EMDS_FLUSH}, this is the same as @ref emds_store_time_get.
+ *
+ * @return Time needed to store the current data (in microseconds).
+ */
+uint32_t emds_store_time_current_get(void);
+
 /**
  * @brief Calculate the size needed to store the registered data.
  *
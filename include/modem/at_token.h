@@ -0,0 +1,201 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef AT_TOKEN_H__
+#define AT_TOKEN_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <zephyr/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file at_token.h
+ *
+ * @defgroup at_token AT response tokenizer
+ * @{
+ * @brief Zero-allocation, in-place tokenizer for AT responses and notifications.
+ *
+ * The tokenizer splits one line of an AT response or notification into tokens in a single
+ * pass. Tokens are views into the original string, stored in an array that is provided by the
+ * caller. Nothing is copied and no memory is allocated. Integer values are parsed only when
+ * they are read.
+ *
+ * The string must remain valid and unmodified for as long as the tokens are in use.
+ */
+
+/** @brief Token types. */
+enum at_token_type {
+	/** Invalid token. */
+	AT_TOKEN_TYPE_INVALID,
+	/** Response or notification prefix, for example "+CEREG". */
+	AT_TOKEN_TYPE_PREFIX,
+	/** Decimal integer. */
+	AT_TOKEN_TYPE_INT,
+	/** Quoted string. The view does not include the quotes. */
+	AT_TOKEN_TYPE_QUOTED_STRING,
+	/** Unquoted string that is not a decimal integer. */
+	AT_TOKEN_TYPE_STRING,
+	/** Array. The view does not include the parentheses. */
+	AT_TOKEN_TYPE_ARRAY,
+	/** Empty parameter. */
+	AT_TOKEN_TYPE_EMPTY,
+};
+
+/** @brief Token, a view into the tokenized string. */
+struct at_token {
+	/** Start of the token. */
+	const char *start;
+	/** Length of the token. */
+	uint16_t len;
+	/** Token type, @ref at_token_type. */
+	uint8_t type;
+};
+
+/**
+ * @brief Tokenize one line of an AT response or notification.
+ *
+ * If the line starts with a response or notification prefix, such as "+CEREG" or "%NCELLMEAS",
+ * the first token is the prefix and the rest are the parameters that follow it. Otherwise,
+ * the whole line is returned as a single string token.
+ *
+ * Leading CR and LF characters are skipped. Tokenizing stops at the end of the line.
+ *
+ * @param str        AT response or notification as a null-terminated string.
+ * @param tokens     Array where the tokens are stored.
+ * @param num_tokens Number of elements in @p tokens.
+ * @param count      Number of tokens stored in @p tokens.
+ * @param remainder  Where tokenizing stopped. On success, this is the start of the next line,
+ *                   for example a result code or another notification. If @c -E2BIG is
+ *                   returned, this is the first parameter that was not tokenized, and
+ *                   tokenizing can be continued with @ref at_token_params_parse. Can be NULL.
+ *
+ * @retval 0 If the operation was successful.
+ * @retval -E2BIG   The line has more tokens than fit in @p tokens. The first @p num_tokens
+ *                  tokens are valid.
+ * @retval -EBADMSG The line is malformed. The tokens before the malformed one are valid.
+ * @retval -EINVAL  One or more of the supplied parameters are invalid.
+ */
+int at_token_line_parse(const char *str, struct at_token *tokens, size_t num_tokens,
+			size_t *count, const char **remainder);
+
+/**
+ * @brief Continue tokenizing the parameters of an AT response line.
+ *
+ * Parameters are tokenized in the same way as in @ref at_token_line_parse, starting from
+ * @p str, which must be the remainder returned when @c -E2BIG was returned. This allows long
+ * responses to be processed in fixed-size windows of tokens.
+ *
+ * @param str        Start of the next parameter.
+ * @param tokens     Array where the tokens are stored.
+ * @param num_tokens Number of elements in @p tokens.
+ * @param count      Number of tokens stored in @p tokens.
+ * @param remainder  Where tokenizing stopped, as in @ref at_token_line_parse. Can be NULL.
+ *
+ * @retval 0 If the operation was successful.
+ * @retval -E2BIG   The line has more tokens than fit in @p tokens.
+ * @retval -EBADMSG The line is malformed.
+ * @retval -EINVAL  One or more of the supplied parameters are invalid.
+ */
+int at_token_params_parse(const char *str, struct at_token *tokens, size_t num_tokens,
+			  size_t *count, const char **remainder);
+
+/**
+ * @brief Get the value of an integer token as a 16-bit signed integer.
+ *
+ * @param[in]  token Token.
+ * @param[out] value Parsed value.
+ *
+ * @retval 0 If the operation was successful.
+ * @retval -EINVAL The token is not an integer, or the value is out of range.
+ */
+int at_token_short_get(const struct at_token *token, int16_t *value);
+
+/**
+ * @brief Get the value of an integer token as a 16-bit unsigned integer.
+ *
+ * @param[in]  token Token.
+ * @param[out] value Parsed value.
+ *
+ * @retval 0 If the operation was successful.
+ * @retval -EINVAL The token is not an integer, or the value is out of range.
+ */
+int at_token_ushort_get(const struct at_token *token, uint16_t *value);
+
+/**
+ * @brief Get the value of an integer token as a 32-bit signed integer.
+ *
+ * @param[in]  token Token.
+ * @param[out] value Parsed value.
+ *
+ * @retval 0 If the operation was successful.
+ * @retval -EINVAL The token is not an integer, or the value is out of range.
+ */
+int at_token_int_get(const struct at_token *token, int32_t *value);
+
+/**
+ * @brief Get the value of an integer token as a 64-bit signed integer.
+ *
+ * @param[in]  token Token.
+ * @param[out] value Parsed value.
+ *
+ * @retval 0 If the operation was successful.
+ * @retval -EINVAL The token is not an integer, or the value is out of range.
+ */
+int at_token_int64_get(const struct at_token *token, int64_t *value);
+
+/**
+ * @brief Get the value of a string token that holds an unsigned integer.
+ *
+ * This is used for parameters such as cell IDs, which are reported as hexadecimal strings,
+ * and timer values, which are reported as binary strings. Unquoted digits, which are
+ * tokenized as integers, are accepted as well.
+ *
+ * @param[in]  token Token.
+ * @param[in]  base  Base of the integer, from 2 to 16.
+ * @param[out] value Parsed value.
+ *
+ * @retval 0 If the operation was successful.
+ * @retval -EINVAL The token is not a string or an integer, is empty, has characters that
+ *                 are not digits in @p base, or the value is out of range.
+ */
+int at_token_string_uint_get(const struct at_token *token, int base, uint32_t *value);
+
+/**
+ * @brief Copy the value of a string or prefix token.
+ *
+ * The string is not null-terminated.
+ *
+ * @param[in]     token Token.
+ * @param[out]    value Buffer where the string is copied.
+ * @param[in,out] len   Size of @p value on input, length of the string on output.
+ *
+ * @retval 0 If the operation was successful.
+ * @retval -ENOMEM The string does not fit in @p value.
+ * @retval -EINVAL The token is not a string or a prefix.
+ */
+int at_token_string_get(const struct at_token *token, char *value, size_t *len);
+
+/**
+ * @brief Check if a string or prefix token is equal to a string.
+ *
+ * @param token Token.
+ * @param str   Null-terminated string to compare against.
+ *
+ * @return true if the token is a string or a prefix, and it is equal to @p str.
+ */
+bool at_token_equals(const struct at_token *token, const char *str);
+
+/** @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AT_TOKEN_H__ */
@@ -212,6 +212,21 @@ struct location_data_details_wifi {
 	uint16_t ap_count;
 };
 
+/** Location details for the location cache. */
+struct location_data_details_cache {
+	/** Whether the location was returned from the cache. */
+	bool hit;
+	/**
+	 * Similarity in percent of the radio environment to the one of the returned cached
+	 * location. Zero if the location was not returned from the cache.
+	 */
+	uint8_t similarity;
+	/** Number of location requests answered from the cache since initialization. */
+	uint32_t hit_count;
+	/** Number of location requests not answered from the cache since initialization. */
+	uint32_t miss_count;
+};
+
 /**
  * Location details.
  *
@@ -242,6 +257,10 @@ struct location_data_details {
 	/** Location details for Wi-Fi. */
 	struct location_data_details_wifi wifi;
 #endif
+#if defined(CONFIG_LOCATION_CACHE)
+	/** Location details for the location cache. Filled for cellular and Wi-Fi methods. */
+	struct location_data_details_cache cache;
+#endif
 };
 #endif
 
@@ -190,6 +190,14 @@ struct download_client {
 		bool connection_close;
 		/** Is using ranged query. */
 		bool ranged;
+		/** Number of range requests sent and not yet received in full. */
+		uint8_t in_flight;
+		/** Offset of the first byte that has not been requested yet. */
+		size_t request_offset;
+		/** Number of payload bytes left in the current response. */
+		size_t payload_left;
+		/** Number of bytes in the buffer that follow the current fragment. */
+		size_t overflow;
 	} http;
 
 	struct {
@@ -310,6 +310,19 @@ static inline void nrf_profiler_log_send(struct log_event_buf *buf,
 				     uint16_t event_type_id) {}
 #endif
 
+/** @brief Get the number of profiled events that were dropped.
+ *
+ * Events are dropped only when they are staged and the staging ring buffer
+ * overflows. See @kconfig{CONFIG_NRF_PROFILER_NORDIC_STAGING}.
+ *
+ * @return Number of events dropped since the Profiler was initialized.
+ */
+#ifdef CONFIG_NRF_PROFILER
+uint32_t nrf_profiler_dropped_events_count(void);
+#else
+static inline uint32_t nrf_profiler_dropped_events_count(void) {return 0; }
+#endif
+
 
 /**
  * @}
@@ -0,0 +1,455 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <ctype.h>
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/types.h>
+
+#include <modem/at_token.h>
+#include "at_utils.h"
+
+static inline bool is_end_of_line(char chr)
+{
+	return is_lfcr(chr) || is_terminated(chr);
+}
+
+static inline const char *skip_spaces(const char *str)
+{
+	while (*str == ' ') {
+		str++;
+	}
+
+	return str;
+}
+
+static inline const char *skip_lfcr(const char *str)
+{
+	while (is_lfcr(*str)) {
+		str++;
+	}
+
+	return str;
+}
+
+static bool is_int(const char *str, size_t len)
+{
+	size_t i = 0;
+
+	if ((len > 0) && ((str[0] == '-') || (str[0] == '+'))) {
+		i++;
+	}
+
+	if (i == len) {
+		return false;
+	}
+
+	for (; i < len; i++) {
+		if (!isdigit((int)str[i])) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static int token_set(struct at_token *token, const char *start, const char *end,
+		     enum at_token_type type)
+{
+	if ((end - start) > UINT16_MAX) {
+		return -EBADMSG;
+	}
+
+	token->start = start;
+	token->len = end - start;
+	token->type = type;
+
+	return 0;
+}
+
+/* Parses the parameter starting at str into token. Returns a pointer to the separator or end of
+ * line that follows the parameter, or NULL if the parameter is malformed.
+ */
+static const char *param_parse(const char *str, struct at_token *token)
+{
+	const char *start;
+	const char *end;
+	enum at_token_type type;
+
+	str = skip_spaces(str);
+
+	if (is_dblquote(*str)) {
+		start = ++str;
+
+		while (!is_dblquote(*str) && !is_terminated(*str)) {
+			str++;
+		}
+
+		if (is_terminated(*str)) {
+			return NULL;
+		}
+
+		end = str++;
+		type = AT_TOKEN_TYPE_QUOTED_STRING;
+	} else if (is_array_start(*str)) {
+		start = ++str;
+
+		while (!is_array_stop(*str) && !is_terminated(*str)) {
+			str++;
+		}
+
+		if (is_terminated(*str)) {
+			return NULL;
+		}
+
+		end = str++;
+		type = AT_TOKEN_TYPE_ARRAY;
+	} else {
+		start = str;
+
+		while ((*str != AT_PARAM_SEPARATOR) && !is_end_of_line(*str)) {
+			str++;
+		}
+
+		end = str;
+
+		while ((end > start) && (*(end - 1) == ' ')) {
+			end--;
+		}
+
+		if (end == start) {
+			type = AT_TOKEN_TYPE_EMPTY;
+		} else if (is_int(start, end - start)) {
+			type = AT_TOKEN_TYPE_INT;
+		} else {
+			type = AT_TOKEN_TYPE_STRING;
+		}
+	}
+
+	str = skip_spaces(str);
+
+	if ((*str != AT_PARAM_SEPARATOR) && !is_end_of_line(*str)) {
+		return NULL;
+	}
+
+	if (token_set(token, start, end, type)) {
+		return NULL;
+	}
+
+	return str;
+}
+
+/* Tokenizes parameters into tokens, starting at index *count. */
+static int params_tokenize(const char *str, struct at_token *tokens, size_t num_tokens,
+			   size_t *count, const char **remainder)
+{
+	const char *next;
+	size_t i = *count;
+	int err = 0;
+
+	while (true) {
+		if (i == num_tokens) {
+			err = -E2BIG;
+			break;
+		}
+
+		next = param_parse(str, &tokens[i]);
+		if (next == NULL) {
+			err = -EBADMSG;
+			break;
+		}
+
+		i++;
+		str = next;
+
+		if (*str != AT_PARAM_SEPARATOR) {
+			str = skip_lfcr(str);
+			break;
+		}
+
+		str++;
+	}
+
+	*count = i;
+
+	if (remainder) {
+		*remainder = str;
+	}
+
+	return err;
+}
+
+int at_token_line_parse(const char *str, struct at_token *tokens, size_t num_tokens,
+			size_t *count, const char **remainder)
+{
+	const char *start;
+	int err;
+
+	if ((str == NULL) || (tokens == NULL) || (num_tokens == 0) || (count == NULL)) {
+		return -EINVAL;
+	}
+
+	*count = 0;
+
+	str = skip_lfcr(str);
+	start = str;
+
+	if (!is_notification(*str)) {
+		/* Without a prefix, the whole line is a single string. */
+		while (!is_end_of_line(*str)) {
+			str++;
+		}
+
+		err = token_set(&tokens[0], start, str,
+				(str == start) ? AT_TOKEN_TYPE_EMPTY : AT_TOKEN_TYPE_STRING);
+		if (err) {
+			return err;
+		}
+
+		*count = 1;
+
+		if (remainder) {
+			*remainder = skip_lfcr(str);
+		}
+
+		return 0;
+	}
+
+	/* The prefix runs up to the response separator, for example "%XT3412" in
+	 * "%XT3412: 360", or to the end of the line if there are no parameters.
+	 */
+	while ((*str != AT_RSP_SEPARATOR) && !is_end_of_line(*str)) {
+		str++;
+	}
+
+	err = token_set(&tokens[0], start, str, AT_TOKEN_TYPE_PREFIX);
+	if (err) {
+		return err;
+	}
+
+	*count = 1;
+
+	if (*str == AT_RSP_SEPARATOR) {
+		str = skip_spaces(str + 1);
+	}
+
+	if (is_end_of_line(*str)) {
+		if (remainder) {
+			*remainder = skip_lfcr(str);
+		}
+
+		return 0;
+	}
+
+	return params_tokenize(str, tokens, num_tokens, count, remainder);
+}
+
+int at_token_params_parse(const char *str, struct at_token *tokens, size_t num_tokens,
+			  size_t *count, const char **remainder)
+{
+	if ((str == NULL) || (tokens == NULL) || (num_tokens == 0) || (count == NULL)) {
+		return -EINVAL;
+	}
+
+	*count = 0;
+
+	return params_tokenize(str, tokens, num_tokens, count, remainder);
+}
+
+static int int_parse(const struct at_token *token, int64_t min, int64_t max, int64_t *value)
+{
+	const char *str;
+	size_t len;
+	bool negative = false;
+	uint64_t magnitude = 0;
+	int64_t result;
+
+	if ((token == NULL) || (value == NULL) || (token->type != AT_TOKEN_TYPE_INT)) {
+		return -EINVAL;
+	}
+
+	str = token->start;
+	len = token->len;
+
+	if ((*str == '-') || (*str == '+')) {
+		negative = (*str == '-');
+		str++;
+		len--;
+	}
+
+	for (size_t i = 0; i < len; i++) {
+		uint8_t digit = str[i] - '0';
+
+		if (magnitude > (UINT64_MAX - digit) / 10) {
+			return -EINVAL;
+		}
+
+		magnitude = magnitude * 10 + digit;
+	}
+
+	if (negative) {
+		if (magnitude > (uint64_t)INT64_MAX + 1) {
+			return -EINVAL;
+		}
+
+		result = (magnitude == (uint64_t)INT64_MAX + 1) ? INT64_MIN : -(int64_t)magnitude;
+	} else {
+		if (magnitude > INT64_MAX) {
+			return -EINVAL;
+		}
+
+		result = magnitude;
+	}
+
+	if ((result < min) || (result > max)) {
+		return -EINVAL;
+	}
+
+	*value = result;
+
+	return 0;
+}
+
+int at_token_short_get(const struct at_token *token, int16_t *value)
+{
+	int64_t tmp;
+	int err;
+
+	if (value == NULL) {
+		return -EINVAL;
+	}
+
+	err = int_parse(token, INT16_MIN, INT16_MAX, &tmp);
+	if (err) {
+		return err;
+	}
+
+	*value = (int16_t)tmp;
+
+	return 0;
+}
+
+int at_token_ushort_get(const struct at_token *token, uint16_t *value)
+{
+	int64_t tmp;
+	int err;
+
+	if (value == NULL) {
+		return -EINVAL;
+	}
+
+	err = int_parse(token, 0, UINT16_MAX, &tmp);
+	if (err) {
+		return err;
+	}
+
+	*value = (uint16_t)tmp;
+
+	return 0;
+}
+
+int at_token_int_get(const struct at_token *token, int32_t *value)
+{
+	int64_t tmp;
+	int err;
+
+	if (value == NULL) {
+		return -EINVAL;
+	}
+
+	err = int_parse(token, INT32_MIN, INT32_MAX, &tmp);
+	if (err) {
+		return err;
+	}
+
+	*value = (int32_t)tmp;
+
+	return 0;
+}
+
+int at_token_int64_get(const struct at_token *token, int64_t *value)
+{
+	return int_parse(token, INT64_MIN, INT64_MAX, value);
+}
+
+int at_token_string_uint_get(const struct at_token *token, int base, uint32_t *value)
+{
+	uint32_t result = 0;
+
+	if ((token == NULL) || (value == NULL) || (base < 2) || (base > 16)) {
+		return -EINVAL;
+	}
+
+	if (((token->type != AT_TOKEN_TYPE_QUOTED_STRING) &&
+	     (token->type != AT_TOKEN_TYPE_STRING) &&
+	     (token->type != AT_TOKEN_TYPE_INT)) ||
+	    (token->len == 0)) {
+		return -EINVAL;
+	}
+
+	for (size_t i = 0; i < token->len; i++) {
+		char chr = token->start[i];
+		uint8_t digit;
+
+		if (isdigit((int)chr)) {
+			digit = chr - '0';
+		} else if (isxdigit((int)chr)) {
+			digit = toupper((int)chr) - 'A' + 10;
+		} else {
+			return -EINVAL;
+		}
+
+		if ((digit >= base) || (result > (UINT32_MAX - digit) / base)) {
+			return -EINVAL;
+		}
+
+		result = result * base + digit;
+	}
+
+	*value = result;
+
+	return 0;
+}
+
+int at_token_string_get(const struct at_token *token, char *value, size_t *len)
+{
+	if ((token == NULL) || (value == NULL) || (len == NULL)) {
+		return -EINVAL;
+	}
+
+	if ((token->type != AT_TOKEN_TYPE_QUOTED_STRING) &&
+	    (token->type != AT_TOKEN_TYPE_STRING) &&
+	    (token->type != AT_TOKEN_TYPE_PREFIX)) {
+		return -EINVAL;
+	}
+
+	if (*len < token->len) {
+		return -ENOMEM;
+	}
+
+	memcpy(value, token->start, token->len);
+	*len = token->len;
+
+	return 0;
+}
+
+bool at_token_equals(const struct at_token *token, const char *str)
+{
+	if ((token == NULL) || (str == NULL)) {
+		return false;
+	}
+
+	if ((token->type != AT_TOKEN_TYPE_QUOTED_STRING) &&
+	    (token->type != AT_TOKEN_TYPE_STRING) &&
+	    (token->type != AT_TOKEN_TYPE_PREFIX)) {
+		return false;
+	}
+
+	return (strlen(str) == token->len) && (memcmp(token->start, str, token->len) == 0);
+}
@@ -25,6 +25,18 @@ BUILD_ASSERT(CONFIG_EI_WRAPPER_THREAD_STACK_SIZE > 0);
 #define THREAD_PRIORITY 	CONFIG_EI_WRAPPER_THREAD_PRIORITY
 #define DEBUG_MODE		IS_ENABLED(CONFIG_EI_WRAPPER_DEBUG_MODE)
 
+#ifdef CONFIG_EI_WRAPPER_CONTINUOUS
+/* In continuous mode the library keeps features of the previous slices and
+ * only the newest slice of the window is passed for DSP processing.
+ */
+#define INPUT_SLICE_SIZE	(INPUT_WINDOW_SIZE / EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW)
+
+BUILD_ASSERT(INPUT_WINDOW_SIZE % EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW == 0);
+BUILD_ASSERT(INPUT_SLICE_SIZE % INPUT_FRAME_SIZE == 0);
+#else
+#define INPUT_SLICE_SIZE	INPUT_WINDOW_SIZE
+#endif /* CONFIG_EI_WRAPPER_CONTINUOUS */
+
 enum state {
 	STATE_DISABLED,
 	STATE_WAITING_FOR_DATA,
@@ -51,6 +63,8 @@ static struct data_buffer ei_input;
 static ei_impulse_result_t ei_result;
 static int cur_res_idx;
 static ei_wrapper_result_ready_cb user_cb;
+static atomic_t continuous_reset = ATOMIC_INIT(true);
+static atomic_t continuous_started;
 
 
 BUILD_ASSERT(DATA_BUFFER_SIZE > INPUT_WINDOW_SIZE);
@@ -70,7 +84,7 @@ static size_t buf_calc_free_space(const struct data_buffer *b)
 {
 	if (b->wait_data_size > 0) {
 		return b->wait_data_size + ARRAY_SIZE(b->buf) -
-		       INPUT_WINDOW_SIZE - 1;
+		       INPUT_SLICE_SIZE - 1;
 	}
 
 	return ARRAY_SIZE(b->buf) - buf_get_collected_data_count(b) - 1;
@@ -162,7 +176,7 @@ static int buf_append(struct data_buffer *b, const float *data, size_t len,
 static void buf_get(const struct data_buffer *b, float *b_res, size_t offset,
 		    size_t len)
 {
-	__ASSERT_NO_MSG((offset + len) <= INPUT_WINDOW_SIZE);
+	__ASSERT_NO_MSG((offset + len) <= INPUT_SLICE_SIZE);
 
 	/* Processing index cannot change while processing is done. */
 	__ASSERT_NO_MSG(b->state == STATE_PROCESSING);
@@ -207,7 +221,7 @@ static int buf_processing_move(struct data_buffer *b, size_t move,
 		b->process_idx -= ARRAY_SIZE(b->buf);
 	}
 
-	size_t processing_end_move = move + INPUT_WINDOW_SIZE;
+	size_t processing_end_move = move + INPUT_SLICE_SIZE;
 
 	if (processing_end_move > max_move) {
 		b->wait_data_size = processing_end_move - max_move;
@@ -236,6 +250,11 @@ size_t ei_wrapper_get_window_size(void)
 	return INPUT_WINDOW_SIZE;
 }
 
+size_t ei_wrapper_get_slice_size(void)
+{
+	return INPUT_SLICE_SIZE;
+}
+
 size_t ei_wrapper_get_classifier_frequency(void)
 {
 	return INPUT_FREQUENCY;
@@ -275,7 +294,15 @@ int ei_wrapper_add_data(const float *data, size_t data_size)
 
 int ei_wrapper_clear_data(bool *cancelled)
 {
-	return buf_cleanup(&ei_input, cancelled);
+	int err = buf_cleanup(&ei_input, cancelled);
+
+	if (!err) {
+		/* Features cached for the previous slices are no longer valid. */
+		atomic_set(&continuous_reset, true);
+		atomic_set(&continuous_started, false);
+	}
+
+	return err;
 }
 
 int ei_wrapper_start_prediction(size_t window_shift, size_t frame_shift)
@@ -283,9 +310,19 @@ int ei_wrapper_start_prediction(size_t window_shift, size_t frame_shift)
 	size_t sample_shift = window_shift * ei_wrapper_get_window_size() +
 			      frame_shift * ei_wrapper_get_frame_size();
 
+	if (IS_ENABLED(CONFIG_EI_WRAPPER_CONTINUOUS) &&
+	    (sample_shift != (atomic_get(&continuous_started) ? INPUT_SLICE_SIZE : 0))) {
+		/* Slices must be processed back to back, and each of them only once. */
+		return -EINVAL;
+	}
+
 	bool process_buf;
 	int err = buf_processing_move(&ei_input, sample_shift, &process_buf);
 
+	if (!err) {
+		atomic_set(&continuous_started, true);
+	}
+
 	if (!err && process_buf) {
 		k_sem_give(&ei_sem);
 	}
@@ -309,6 +346,20 @@ static void processing_finished(int err)
 	user_cb(err);
 }
 
+static EI_IMPULSE_ERROR run_impulse(signal_t *features_signal)
+{
+#ifdef CONFIG_EI_WRAPPER_CONTINUOUS
+	if (atomic_clear(&continuous_reset)) {
+		run_classifier_init();
+	}
+
+	return run_classifier_continuous(features_signal, &ei_result, DEBUG_MODE,
+					 IS_ENABLED(CONFIG_EI_WRAPPER_CONTINUOUS_MAF));
+#else
+	return run_classifier(features_signal, &ei_result, DEBUG_MODE);
+#endif /* CONFIG_EI_WRAPPER_CONTINUOUS */
+}
+
 static void edge_impulse_thread_fn(void)
 {
 	signal_t features_signal;
@@ -317,16 +368,19 @@ static void edge_impulse_thread_fn(void)
 	while (true) {
 		k_sem_take(&ei_sem, K_FOREVER);
 
+		/* The library reads the features straight from the ring buffer,
+		 * only for the part of the window that is processed.
+		 */
 		features_signal.get_data = &raw_feature_get_data;
-		features_signal.total_length = INPUT_WINDOW_SIZE;
+		features_signal.total_length = INPUT_SLICE_SIZE;
 
 		if (IS_ENABLED(CONFIG_EI_WRAPPER_PROFILING)) {
 			start_time = k_uptime_get();
 		}
 
 		/* Invoke the impulse. */
-		EI_IMPULSE_ERROR err = run_classifier(&features_signal,
-						      &ei_result, DEBUG_MODE);
+		EI_IMPULSE_ERROR err = run_impulse(&features_signal);
+
 		if (IS_ENABLED(CONFIG_EI_WRAPPER_PROFILING)) {
 			int64_t delta = k_uptime_delta(&start_time);
 
@@ -336,6 +390,11 @@ static void edge_impulse_thread_fn(void)
 				ei_result.timing.dsp,
 				ei_result.timing.classification,
 				ei_result.timing.anomaly);
+#ifdef CONFIG_EI_WRAPPER_CONTINUOUS
+			LOG_INF("dsp per slice: %dms (%zu values, %d slices per window)",
+				ei_result.timing.dsp, (size_t)INPUT_SLICE_SIZE,
+				EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW);
+#endif /* CONFIG_EI_WRAPPER_CONTINUOUS */
 		}
 
 		if (err) {
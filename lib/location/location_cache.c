@@ -0,0 +1,462 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/byteorder.h>
+#include <modem/location.h>
+
+#if defined(CONFIG_LOCATION_CACHE_SETTINGS)
+#include <zephyr/settings/settings.h>
+#include <date_time.h>
+#endif
+
+#include "location_cache.h"
+
+LOG_MODULE_DECLARE(location, CONFIG_LOCATION_LOG_LEVEL);
+
+#define SETTINGS_NAME "location_cache"
+
+/* Weak signals fade more and are more often missing from a scan, so the similarity is
+ * weighted by signal strength.
+ */
+#define WIFI_RSSI_FLOOR		-100
+#define NCELL_RSRP_MAX		97
+
+/* Fingerprints only hold the strongest access points and neighbor cells, so a transmitter
+ * that is missing from a full fingerprint may just have been left out from it. It is only
+ * counted as a difference if its signal is clearly stronger than the weakest one kept, in dB.
+ */
+#define TRUNCATION_MARGIN	6
+
+struct cache_entry {
+	struct location_cache_fingerprint fingerprint;
+	double latitude;
+	double longitude;
+	float accuracy;
+	/* Time when the location was acquired, in seconds */
+	int64_t timestamp;
+	/* Value of use_counter when the entry was last used, zero for a free entry */
+	uint32_t last_used;
+};
+
+static struct cache_entry entries[CONFIG_LOCATION_CACHE_SIZE];
+static uint32_t use_counter;
+static uint32_t hit_cnt;
+static uint32_t miss_cnt;
+
+#if defined(CONFIG_LOCATION_CACHE_SETTINGS)
+static int settings_set(const char *key, size_t len_rd, settings_read_cb read_cb, void *cb_arg)
+{
+	struct cache_entry entry;
+	unsigned long idx;
+	char *end;
+
+	if (!key) {
+		return -EINVAL;
+	}
+
+	idx = strtoul(key, &end, 10);
+	if (end == key || *end != '\0' || idx >= ARRAY_SIZE(entries) ||
+	    len_rd != sizeof(entry)) {
+		/* Stored with a different cache configuration */
+		LOG_DBG("Ignoring stored location cache entry %s", key);
+		return 0;
+	}
+
+	if (read_cb(cb_arg, &entry, len_rd) != len_rd) {
+		return -EIO;
+	}
+
+	entries[idx] = entry;
+	use_counter = MAX(use_counter, entry.last_used);
+
+	return 0;
+}
+
+SETTINGS_STATIC_HANDLER_DEFINE(location_cache, SETTINGS_NAME, NULL, settings_set, NULL, NULL);
+
+static void entry_key_get(char *key, size_t len, int idx)
+{
+	snprintk(key, len, SETTINGS_NAME "/%d", idx);
+}
+
+static void entry_store(int idx)
+{
+	char key[sizeof(SETTINGS_NAME) + 4];
+	int err;
+
+	entry_key_get(key, sizeof(key), idx);
+
+	err = settings_save_one(key, &entries[idx], sizeof(entries[idx]));
+	if (err) {
+		LOG_WRN("Failed to store location cache entry, error: %d", err);
+	}
+}
+
+static void entry_store_delete(int idx)
+{
+	char key[sizeof(SETTINGS_NAME) + 4];
+
+	entry_key_get(key, sizeof(key), idx);
+
+	(void)settings_delete(key);
+}
+#endif /* CONFIG_LOCATION_CACHE_SETTINGS */
+
+static bool cache_time_get(int64_t *now)
+{
+#if defined(CONFIG_LOCATION_CACHE_SETTINGS)
+	int64_t time_ms;
+
+	/* Stored entries outlive the uptime, so they are timestamped with the UTC time */
+	if (date_time_now(&time_ms)) {
+		return false;
+	}
+	*now = time_ms / MSEC_PER_SEC;
+#else
+	*now = k_uptime_get() / MSEC_PER_SEC;
+#endif
+	return true;
+}
+
+static bool entry_expired(const struct cache_entry *entry, int64_t now)
+{
+	return now < entry->timestamp || now - entry->timestamp >= CONFIG_LOCATION_CACHE_TTL;
+}
+
+static uint32_t ap_weight(int8_t rssi)
+{
+	return CLAMP(rssi - WIFI_RSSI_FLOOR, 1, -WIFI_RSSI_FLOOR);
+}
+
+static uint32_t ncell_weight(int16_t rsrp)
+{
+	/* RSRP is given as an index, where a larger value is a stronger signal */
+	return (rsrp >= 0 && rsrp <= NCELL_RSRP_MAX) ? rsrp + 1 : 1;
+}
+
+/* Access point or neighbor cell. The key identifies the transmitter. */
+struct transmitter {
+	uint64_t key;
+	uint32_t weight;
+};
+
+/* Weighted Jaccard similarity of two transmitter sets sorted by weight, in percent.
+ * A set is full when it holds as many transmitters as a fingerprint can.
+ */
+static uint32_t transmitter_similarity(const struct transmitter *a, int a_cnt, bool a_full,
+				       const struct transmitter *b, int b_cnt, bool b_full)
+{
+	bool matched[MAX(CONFIG_LOCATION_CACHE_WIFI_AP_CNT, CONFIG_LOCATION_CACHE_NCELL_CNT)] = { 0 };
+	uint32_t matched_cnt = 0;
+	uint32_t min_sum = 0;
+	uint32_t max_sum = 0;
+	uint32_t truncated_sum = 0;
+	int j;
+
+	for (int i = 0; i < a_cnt; i++) {
+		for (j = 0; j < b_cnt; j++) {
+			if (!matched[j] && a[i].key == b[j].key) {
+				break;
+			}
+		}
+
+		if (j < b_cnt) {
+			matched[j] = true;
+			matched_cnt++;
+			min_sum += MIN(a[i].weight, b[j].weight);
+			max_sum += MAX(a[i].weight, b[j].weight);
+		} else {
+			max_sum += a[i].weight;
+			if (b_full && a[i].weight <= b[b_cnt - 1].weight + TRUNCATION_MARGIN) {
+				truncated_sum += a[i].weight;
+			}
+		}
+	}
+
+	for (j = 0; j < b_cnt; j++) {
+		if (!matched[j]) {
+			max_sum += b[j].weight;
+			if (a_full && b[j].weight <= a[a_cnt - 1].weight + TRUNCATION_MARGIN) {
+				truncated_sum += b[j].weight;
+			}
+		}
+	}
+
+	/* Transmitters that may have been left out are only ignored when most of the others
+	 * match. Otherwise two unrelated sets of equally weak transmitters would look alike.
+	 */
+	if (2 * matched_cnt >= MIN(a_cnt, b_cnt)) {
+		max_sum -= truncated_sum;
+	}
+
+	return min_sum ? 100 * min_sum / max_sum : 0;
+}
+
+static uint32_t wifi_similarity(const struct location_cache_fingerprint *a,
+				const struct location_cache_fingerprint *b)
+{
+	struct transmitter a_aps[CONFIG_LOCATION_CACHE_WIFI_AP_CNT];
+	struct transmitter b_aps[CONFIG_LOCATION_CACHE_WIFI_AP_CNT];
+
+	for (int i = 0; i < a->ap_cnt; i++) {
+		a_aps[i].key = sys_get_be48(a->aps[i].mac);
+		a_aps[i].weight = ap_weight(a->aps[i].rssi);
+	}
+	for (int i = 0; i < b->ap_cnt; i++) {
+		b_aps[i].key = sys_get_be48(b->aps[i].mac);
+		b_aps[i].weight = ap_weight(b->aps[i].rssi);
+	}
+
+	return transmitter_similarity(a_aps, a->ap_cnt, a->ap_cnt == ARRAY_SIZE(a->aps),
+				      b_aps, b->ap_cnt, b->ap_cnt == ARRAY_SIZE(b->aps));
+}
+
+/* Serving cell match and similarity of the neighbor cell sets, in percent */
+static uint32_t cell_similarity(const struct location_cache_fingerprint *a,
+				const struct location_cache_fingerprint *b)
+{
+	struct transmitter a_ncells[CONFIG_LOCATION_CACHE_NCELL_CNT];
+	struct transmitter b_ncells[CONFIG_LOCATION_CACHE_NCELL_CNT];
+	uint32_t serving;
+
+	serving = (a->cell_id == b->cell_id && a->tac == b->tac &&
+		   a->mcc == b->mcc && a->mnc == b->mnc) ? 100 : 0;
+
+	if (a->ncell_cnt == 0 && b->ncell_cnt == 0) {
+		return serving;
+	}
+
+	for (int i = 0; i < a->ncell_cnt; i++) {
+		a_ncells[i].key = ((uint64_t)a->ncells[i].earfcn << 16) | a->ncells[i].phys_cell_id;
+		a_ncells[i].weight = ncell_weight(a->ncells[i].rsrp);
+	}
+	for (int i = 0; i < b->ncell_cnt; i++) {
+		b_ncells[i].key = ((uint64_t)b->ncells[i].earfcn << 16) | b->ncells[i].phys_cell_id;
+		b_ncells[i].weight = ncell_weight(b->ncells[i].rsrp);
+	}
+
+	return (serving +
+		transmitter_similarity(a_ncells, a->ncell_cnt,
+				       a->ncell_cnt == ARRAY_SIZE(a->ncells),
+				       b_ncells, b->ncell_cnt,
+				       b->ncell_cnt == ARRAY_SIZE(b->ncells))) / 2;
+}
+
+uint8_t location_cache_similarity(const struct location_cache_fingerprint *a,
+				  const struct location_cache_fingerprint *b)
+{
+	bool wifi = a->ap_cnt > 0;
+	bool cell = a->cell_id != LTE_LC_CELL_EUTRAN_ID_INVALID;
+
+	/* A location acquired with Wi-Fi is much more accurate than one acquired with cellular
+	 * data only, so fingerprints are only compared with ones of the same kind.
+	 */
+	if (wifi != (b->ap_cnt > 0) || cell != (b->cell_id != LTE_LC_CELL_EUTRAN_ID_INVALID)) {
+		return 0;
+	}
+
+	if (wifi && cell) {
+		/* Access points are weighted more, because the serving cell of a stationary
+		 * device may change on reselection.
+		 */
+		return (3 * wifi_similarity(a, b) + cell_similarity(a, b)) / 4;
+	} else if (wifi) {
+		return wifi_similarity(a, b);
+	} else if (cell) {
+		return cell_similarity(a, b);
+	}
+
+	return 0;
+}
+
+void location_cache_fingerprint_make(struct location_cache_fingerprint *fingerprint,
+				     const struct lte_lc_cells_info *cell_data,
+				     const struct wifi_scan_info *wifi_data)
+{
+	const struct lte_lc_ncell *ncell;
+	int i;
+
+	memset(fingerprint, 0, sizeof(*fingerprint));
+	fingerprint->cell_id = LTE_LC_CELL_EUTRAN_ID_INVALID;
+
+	if (cell_data != NULL && cell_data->current_cell.id != LTE_LC_CELL_EUTRAN_ID_INVALID) {
+		fingerprint->cell_id = cell_data->current_cell.id;
+		fingerprint->tac = cell_data->current_cell.tac;
+		fingerprint->mcc = cell_data->current_cell.mcc;
+		fingerprint->mnc = cell_data->current_cell.mnc;
+
+		/* Keep the strongest neighbor cells, sorted by signal strength */
+		for (int n = 0; n < cell_data->ncells_count; n++) {
+			ncell = &cell_data->neighbor_cells[n];
+
+			i = fingerprint->ncell_cnt;
+			if (i == ARRAY_SIZE(fingerprint->ncells)) {
+				if (ncell_weight(ncell->rsrp) <=
+				    ncell_weight(fingerprint->ncells[i - 1].rsrp)) {
+					continue;
+				}
+				i--;
+			} else {
+				fingerprint->ncell_cnt++;
+			}
+
+			for (; i > 0 && ncell_weight(fingerprint->ncells[i - 1].rsrp) <
+					ncell_weight(ncell->rsrp); i--) {
+				fingerprint->ncells[i] = fingerprint->ncells[i - 1];
+			}
+
+			fingerprint->ncells[i].earfcn = ncell->earfcn;
+			fingerprint->ncells[i].phys_cell_id = ncell->phys_cell_id;
+			fingerprint->ncells[i].rsrp = ncell->rsrp;
+		}
+	}
+
+	if (wifi_data != NULL) {
+		/* Scan results are sorted by signal strength */
+		fingerprint->ap_cnt = MIN(wifi_data->cnt, ARRAY_SIZE(fingerprint->aps));
+
+		for (i = 0; i < fingerprint->ap_cnt; i++) {
+			memcpy(fingerprint->aps[i].mac, wifi_data->ap_info[i].mac,
+			       WIFI_MAC_ADDR_LEN);
+			fingerprint->aps[i].rssi = wifi_data->ap_info[i].rssi;
+		}
+	}
+}
+
+int location_cache_get(const struct location_cache_fingerprint *fingerprint,
+		       struct location_data *location, uint8_t *similarity)
+{
+	struct cache_entry *best = NULL;
+	uint8_t best_similarity = 0;
+	uint8_t entry_similarity;
+	int64_t now;
+
+	if (!cache_time_get(&now)) {
+		miss_cnt++;
+		return -ENOENT;
+	}
+
+	for (int i = 0; i < ARRAY_SIZE(entries); i++) {
+		if (entries[i].last_used == 0) {
+			continue;
+		}
+
+		if (entry_expired(&entries[i], now)) {
+			entries[i].last_used = 0;
+			continue;
+		}
+
+		entry_similarity = location_cache_similarity(fingerprint, &entries[i].fingerprint);
+		if (entry_similarity > best_similarity) {
+			best = &entries[i];
+			best_similarity = entry_similarity;
+		}
+	}
+
+	if (best == NULL || best_similarity < CONFIG_LOCATION_CACHE_SIMILARITY_THRESHOLD) {
+		LOG_DBG("Location cache miss, best similarity %d%%", best_similarity);
+		miss_cnt++;
+		return -ENOENT;
+	}
+
+	/* The use is not stored to settings to avoid a flash write on every hit */
+	best->last_used = ++use_counter;
+
+	location->latitude = best->latitude;
+	location->longitude = best->longitude;
+	location->accuracy = best->accuracy * 100 / best_similarity;
+	*similarity = best_similarity;
+
+	LOG_DBG("Location cache hit, similarity %d%%, age %lld s",
+		best_similarity, (long long)(now - best->timestamp));
+	hit_cnt++;
+
+	return 0;
+}
+
+void location_cache_put(const struct location_cache_fingerprint *fingerprint,
+			const struct location_data *location)
+{
+	struct cache_entry *entry = NULL;
+	int64_t now;
+	int idx = 0;
+
+	if (!cache_time_get(&now)) {
+		LOG_DBG("No valid time, location not cached");
+		return;
+	}
+
+	/* Use a free or an expired entry, or replace the least recently used one */
+	for (int i = 0; i < ARRAY_SIZE(entries); i++) {
+		if (entries[i].last_used == 0 || entry_expired(&entries[i], now)) {
+			idx = i;
+			break;
+		}
+		if (entries[i].last_used < entries[idx].last_used) {
+			idx = i;
+		}
+	}
+
+	entry = &entries[idx];
+	entry->fingerprint = *fingerprint;
+	entry->latitude = location->latitude;
+	entry->longitude = location->longitude;
+	entry->accuracy = location->accuracy;
+	entry->timestamp = now;
+	entry->last_used = ++use_counter;
+
+#if defined(CONFIG_LOCATION_CACHE_SETTINGS)
+	entry_store(idx);
+#endif
+}
+
+void location_cache_stats_get(uint32_t *hits, uint32_t *misses)
+{
+	*hits = hit_cnt;
+	*misses = miss_cnt;
+}
+
+void location_cache_clear(void)
+{
+	for (int i = 0; i < ARRAY_SIZE(entries); i++) {
+		entries[i].last_used = 0;
+#if defined(CONFIG_LOCATION_CACHE_SETTINGS)
+		/* Expired entries are only freed in RAM, so every slot is deleted */
+		entry_store_delete(i);
+#endif
+	}
+}
+
+int location_cache_init(void)
+{
+	int err = 0;
+
+	memset(entries, 0, sizeof(entries));
+	use_counter = 0;
+	hit_cnt = 0;
+	miss_cnt = 0;
+
+#if defined(CONFIG_LOCATION_CACHE_SETTINGS)
+	err = settings_subsys_init();
+	if (err) {
+		LOG_ERR("Settings init failed, error: %d", err);
+		return err;
+	}
+
+	err = settings_load_subtree(SETTINGS_NAME);
+	if (err) {
+		LOG_ERR("Cannot load cached locations, error: %d", err);
+	}
+#endif
+
+	return err;
+}
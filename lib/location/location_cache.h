@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef LOCATION_CACHE_H
+#define LOCATION_CACHE_H
+
+#include <modem/location.h>
+#include <modem/lte_lc.h>
+#include <net/wifi_location_common.h>
+
+/** Wi-Fi access point of a radio fingerprint. */
+struct location_cache_ap {
+	uint8_t mac[WIFI_MAC_ADDR_LEN];
+	int8_t rssi;
+};
+
+/** Neighbor cell of a radio fingerprint. */
+struct location_cache_ncell {
+	uint32_t earfcn;
+	uint16_t phys_cell_id;
+	int16_t rsrp;
+};
+
+/**
+ * Compact description of the radio environment in which a location was acquired.
+ *
+ * Contains the serving cell and the strongest neighbor cells, and the strongest
+ * Wi-Fi access points.
+ */
+struct location_cache_fingerprint {
+	/** Serving cell ID, LTE_LC_CELL_EUTRAN_ID_INVALID if there was no cellular data. */
+	uint32_t cell_id;
+	uint32_t tac;
+	uint16_t mcc;
+	uint16_t mnc;
+	uint8_t ncell_cnt;
+	uint8_t ap_cnt;
+	struct location_cache_ncell ncells[CONFIG_LOCATION_CACHE_NCELL_CNT];
+	struct location_cache_ap aps[CONFIG_LOCATION_CACHE_WIFI_AP_CNT];
+};
+
+/**
+ * @brief Make a radio fingerprint from scan results.
+ *
+ * @param[out] fingerprint Fingerprint.
+ * @param[in] cell_data Cellular scan results, or NULL.
+ * @param[in] wifi_data Wi-Fi scan results sorted by signal strength, or NULL.
+ */
+void location_cache_fingerprint_make(struct location_cache_fingerprint *fingerprint,
+				     const struct lte_lc_cells_info *cell_data,
+				     const struct wifi_scan_info *wifi_data);
+
+/**
+ * @brief Compare two radio fingerprints.
+ *
+ * @return Similarity in percent. Fingerprints that do not contain the same kinds of
+ *         radio data, cellular and Wi-Fi, have no similarity.
+ */
+uint8_t location_cache_similarity(const struct location_cache_fingerprint *a,
+				  const struct location_cache_fingerprint *b);
+
+/**
+ * @brief Look up a cached location for a radio fingerprint.
+ *
+ * The accuracy of the returned location is widened by the dissimilarity of the fingerprints.
+ *
+ * @param[in] fingerprint Fingerprint of the current radio environment.
+ * @param[out] location Location. Only latitude, longitude and accuracy are set.
+ * @param[out] similarity Similarity of the fingerprint of the cached location in percent.
+ *
+ * @retval 0 A cached location was found.
+ * @retval -ENOENT No cached location with a similar enough fingerprint.
+ */
+int location_cache_get(const struct location_cache_fingerprint *fingerprint,
+		       struct location_data *location, uint8_t *similarity);
+
+/**
+ * @brief Store a location acquired from a location service.
+ *
+ * Replaces an expired or the least recently used entry if the cache is full.
+ *
+ * @param[in] fingerprint Fingerprint of the radio environment.
+ * @param[in] location Location.
+ */
+void location_cache_put(const struct location_cache_fingerprint *fingerprint,
+			const struct location_data *location);
+
+/**
+ * @brief Get the number of cache hits and misses since initialization.
+ */
+void location_cache_stats_get(uint32_t *hits, uint32_t *misses);
+
+/**
+ * @brief Remove all cached locations.
+ */
+void location_cache_clear(void);
+
+/**
+ * @brief Initialize the cache and load the stored locations if persistence is enabled.
+ *
+ * @return Zero on success, negative errno code if loading the stored locations failed.
+ */
+int location_cache_init(void);
+
+#endif /* LOCATION_CACHE_H */
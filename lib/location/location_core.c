@@ -618,6 +618,13 @@ static void location_core_event_details_get(struct location_event_data *event)
 		}
 
 		location_method_api_get(loc_req_info.current_method)->details_get(details);
+#if defined(CONFIG_LOCATION_CACHE)
+		/* The combined method fills the cache details itself */
+		if (loc_req_info.current_method == LOCATION_METHOD_CELLULAR ||
+		    loc_req_info.current_method == LOCATION_METHOD_WIFI) {
+			method_cloud_location_cache_details_get(details);
+		}
+#endif
 
 		details->elapsed_time_method = (uint32_t)
 			(k_uptime_get() - loc_req_info.elapsed_time_method_start_timestamp);
@@ -15,6 +15,7 @@
 #include "location_utils.h"
 #include "scan_cellular.h"
 #include "scan_wifi.h"
+#include "location_cache.h"
 #include "cloud_service/cloud_service.h"
 
 LOG_MODULE_DECLARE(location, CONFIG_LOCATION_LOG_LEVEL);
@@ -40,6 +41,12 @@ static bool running;
 static K_SEM_DEFINE(wifi_scan_ready, 0, 1);
 #endif
 
+#if defined(CONFIG_LOCATION_CACHE)
+/* Whether the location of the current request was returned from the cache */
+static bool cache_hit;
+static uint8_t cache_similarity;
+#endif
+
 static void method_cloud_location_positioning_work_fn(struct k_work *work)
 {
 	struct method_cloud_location_start_work_args *work_data =
@@ -105,6 +112,23 @@ static void method_cloud_location_positioning_work_fn(struct k_work *work)
 		.service = (cell_config != NULL) ? cell_config->service : wifi_config->service,
 		.timeout_ms = SYS_FOREVER_MS
 	};
+#if defined(CONFIG_LOCATION_CACHE)
+	struct location_cache_fingerprint fingerprint;
+
+	/* A device that has not moved gets its location without a request to the cloud.
+	 * LTE connection is not needed either.
+	 */
+	location_cache_fingerprint_make(&fingerprint, scan_cellular_info, scan_wifi_info);
+	if (location_cache_get(&fingerprint, &location, &cache_similarity) == 0) {
+		cache_hit = true;
+		location_utils_systime_to_location_datetime(&location_result.datetime);
+		location_result.latitude = location.latitude;
+		location_result.longitude = location.longitude;
+		location_result.accuracy = location.accuracy;
+		location_core_event_cb(&location_result);
+		goto end;
+	}
+#endif
 
 	if (IS_ENABLED(CONFIG_NRF_MODEM_LIB) && !location_utils_is_lte_available()) {
 		/* Not worth to start trying to fetch the location over LTE.
@@ -138,6 +162,9 @@ static void method_cloud_location_positioning_work_fn(struct k_work *work)
 		location_result.latitude = location.latitude;
 		location_result.longitude = location.longitude;
 		location_result.accuracy = location.accuracy;
+#if defined(CONFIG_LOCATION_CACHE)
+		location_cache_put(&fingerprint, &location);
+#endif
 		location_core_event_cb(&location_result);
 	}
 
@@ -191,6 +218,10 @@ int method_cloud_location_get(const struct location_request_info *request)
 	}
 
 	method_cloud_location_start_work.locreq_timeout_uptime = request->timeout_uptime;
+#if defined(CONFIG_LOCATION_CACHE)
+	cache_hit = false;
+	cache_similarity = 0;
+#endif
 	k_work_submit_to_queue(
 		location_core_work_queue_get(),
 		&method_cloud_location_start_work.work_item);
@@ -209,8 +240,20 @@ void method_cloud_location_details_get(struct location_data_details *details)
 #if defined(CONFIG_LOCATION_METHOD_WIFI)
 	scan_wifi_details_get(details);
 #endif
+#if defined(CONFIG_LOCATION_CACHE)
+	method_cloud_location_cache_details_get(details);
+#endif
+}
+
+#if defined(CONFIG_LOCATION_CACHE)
+void method_cloud_location_cache_details_get(struct location_data_details *details)
+{
+	details->cache.hit = cache_hit;
+	details->cache.similarity = cache_similarity;
+	location_cache_stats_get(&details->cache.hit_count, &details->cache.miss_count);
 }
 #endif
+#endif
 
 int method_cloud_location_init(void)
 {
@@ -219,6 +262,10 @@ int method_cloud_location_init(void)
 #if !defined(CONFIG_LOCATION_SERVICE_EXTERNAL)
 	cloud_service_init();
 #endif
+#if defined(CONFIG_LOCATION_CACHE)
+	/* The cache works without the stored locations, so a failure is only logged */
+	(void)location_cache_init();
+#endif
 
 	return 0;
 }
@@ -12,6 +12,9 @@ int method_cloud_location_init(void);
 int method_cloud_location_cancel(void);
 #if defined(CONFIG_LOCATION_DATA_DETAILS)
 void method_cloud_location_details_get(struct location_data_details *details);
+#if defined(CONFIG_LOCATION_CACHE)
+void method_cloud_location_cache_details_get(struct location_data_details *details);
+#endif
 #endif
 
 #endif /* METHOD_CLOUD_LOCATION_H */
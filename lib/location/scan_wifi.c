@@ -16,15 +16,25 @@
 #include "location_core.h"
 #include "location_utils.h"
 #include "cloud_service/cloud_service.h"
+#include "wifi_ap_collector.h"
 
 LOG_MODULE_DECLARE(location, CONFIG_LOCATION_LOG_LEVEL);
 
 static struct net_if *wifi_iface;
 static struct net_mgmt_event_callback scan_wifi_net_mgmt_cb;
 
-static struct wifi_scan_result scan_results[CONFIG_LOCATION_METHOD_WIFI_SCANNING_RESULTS_MAX_CNT];
+#define SCAN_WIFI_FILTERS								\
+	((IS_ENABLED(CONFIG_LOCATION_METHOD_WIFI_SCANNING_FILTER_LOCAL_MAC) ?		\
+		WIFI_AP_COLLECTOR_FILTER_LOCAL_MAC : 0) |				\
+	 (IS_ENABLED(CONFIG_LOCATION_METHOD_WIFI_SCANNING_FILTER_HIDDEN_SSID) ?		\
+		WIFI_AP_COLLECTOR_FILTER_HIDDEN_SSID : 0))
+
+/* Keeps the strongest unique access points when a scan finds more than fit to the buffer */
+WIFI_AP_COLLECTOR_DEFINE(scan_results, CONFIG_LOCATION_METHOD_WIFI_SCANNING_RESULTS_MAX_CNT,
+			 SCAN_WIFI_FILTERS);
+
 static struct wifi_scan_info scan_wifi_info = {
-	.ap_info = scan_results,
+	.ap_info = scan_results_aps,
 };
 static struct k_sem *scan_wifi_ready;
 
@@ -36,6 +46,11 @@ K_WORK_DELAYABLE_DEFINE(scan_wifi_timeout_work, scan_wifi_timeout_work_fn);
 
 struct wifi_scan_info *scan_wifi_results_get(void)
 {
+	/* Results are handed to the cloud service strongest first, so a service truncating
+	 * the list keeps the most useful access points.
+	 */
+	wifi_ap_collector_sort(&scan_results);
+
 	if (scan_wifi_info.cnt  <= 1) {
 		if (scan_wifi_info.cnt == 1) {
 			/* Following statement seems to be true at least with HERE
@@ -105,6 +120,7 @@ void scan_wifi_execute(int32_t timeout, struct k_sem *wifi_scan_ready)
 
 	LOG_DBG("Triggering start of Wi-Fi scanning");
 
+	wifi_ap_collector_reset(&scan_results);
 	scan_wifi_info.cnt = 0;
 
 	__ASSERT_NO_MSG(wifi_iface != NULL);
@@ -133,25 +149,30 @@ void scan_wifi_execute(int32_t timeout, struct k_sem *wifi_scan_ready)
 static void scan_wifi_result_handle(struct net_mgmt_event_callback *cb)
 {
 	const struct wifi_scan_result *entry = (const struct wifi_scan_result *)cb->info;
-	struct wifi_scan_result *current;
+	int ret;
 
-	if (scan_wifi_info.cnt < CONFIG_LOCATION_METHOD_WIFI_SCANNING_RESULTS_MAX_CNT) {
-		current = &scan_wifi_info.ap_info[scan_wifi_info.cnt];
-		*current = *entry;
-		scan_wifi_info.cnt++;
+	ret = wifi_ap_collector_add(&scan_results, entry);
+	scan_wifi_info.cnt = scan_results.cnt;
 
-		LOG_DBG("scan result #%d stored: ssid %s, channel %d,"
+	switch (ret) {
+	case 0:
+		LOG_DBG("scan result stored: ssid %s, channel %d, rssi %d,"
 			" mac %02x:%02x:%02x:%02x:%02x:%02x",
-				scan_wifi_info.cnt,
-				current->ssid,
-				current->channel,
-				current->mac[0], current->mac[1], current->mac[2],
-				current->mac[3], current->mac[4], current->mac[5]);
-	} else {
-		LOG_WRN("Scanning result (mac %02x:%02x:%02x:%02x:%02x:%02x) "
-			"did not fit to result buffer - dropping it",
+				entry->ssid,
+				entry->channel,
+				entry->rssi,
+				entry->mac[0], entry->mac[1], entry->mac[2],
+				entry->mac[3], entry->mac[4], entry->mac[5]);
+		break;
+	case -ENOSPC:
+		LOG_DBG("Scanning result (mac %02x:%02x:%02x:%02x:%02x:%02x) "
+			"weaker than stored results - dropping it",
 				entry->mac[0], entry->mac[1], entry->mac[2],
 				entry->mac[3], entry->mac[4], entry->mac[5]);
+		break;
+	default:
+		/* Duplicate with no stronger signal, or filtered out */
+		break;
 	}
 }
 
@@ -162,7 +183,10 @@ static void scan_wifi_done_handle(struct net_mgmt_event_callback *cb)
 	if (status->status) {
 		LOG_WRN("Wi-Fi scan request failed (%d)", status->status);
 	} else {
-		LOG_DBG("Scan request done with %d Wi-Fi APs", scan_wifi_info.cnt);
+		LOG_DBG("Scan request done with %d Wi-Fi APs "
+			"(%d dropped, %d duplicates, %d filtered)",
+			scan_wifi_info.cnt, scan_results.dropped_cnt,
+			scan_results.duplicate_cnt, scan_results.filtered_cnt);
 	}
 
 	k_sem_give(scan_wifi_ready);
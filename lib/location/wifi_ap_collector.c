@@ -0,0 +1,240 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <errno.h>
+#include <zephyr/kernel.h>
+
+#include "wifi_ap_collector.h"
+
+/* Individual/group bit is bit 0 and universal/local bit is bit 1 of the first octet. */
+#define MAC_LOCALLY_ADMINISTERED BIT(1)
+
+static bool ap_filtered(const struct wifi_ap_collector *collector,
+			const struct wifi_scan_result *entry)
+{
+	if ((collector->filters & WIFI_AP_COLLECTOR_FILTER_LOCAL_MAC) &&
+	    (entry->mac[0] & MAC_LOCALLY_ADMINISTERED)) {
+		return true;
+	}
+
+	if ((collector->filters & WIFI_AP_COLLECTOR_FILTER_HIDDEN_SSID) &&
+	    (entry->ssid_length == 0 || entry->ssid[0] == '\0')) {
+		return true;
+	}
+
+	return false;
+}
+
+/* FNV-1a */
+static uint16_t mac_home_slot(const struct wifi_ap_collector *collector, const uint8_t *mac)
+{
+	uint32_t hash = 2166136261U;
+
+	for (int i = 0; i < WIFI_MAC_ADDR_LEN; i++) {
+		hash ^= mac[i];
+		hash *= 16777619U;
+	}
+
+	return hash % collector->table_size;
+}
+
+/* Returns the slot holding the given MAC address, or the empty slot where it would be inserted.
+ * The table is never full, so the probe sequence always ends.
+ */
+static uint16_t table_slot_find(const struct wifi_ap_collector *collector, const uint8_t *mac)
+{
+	uint16_t slot = mac_home_slot(collector, mac);
+
+	while (collector->table[slot] != 0 &&
+	       memcmp(collector->aps[collector->table[slot] - 1].mac, mac,
+		      WIFI_MAC_ADDR_LEN) != 0) {
+		slot = (slot + 1) % collector->table_size;
+	}
+
+	return slot;
+}
+
+/* Removes the entry from a slot and shifts the entries following it in the same probe sequence
+ * backwards, so that no tombstones are needed.
+ */
+static void table_slot_remove(struct wifi_ap_collector *collector, uint16_t slot)
+{
+	uint16_t next = slot;
+	uint16_t home;
+
+	collector->table[slot] = 0;
+
+	while (true) {
+		next = (next + 1) % collector->table_size;
+		if (collector->table[next] == 0) {
+			return;
+		}
+
+		home = mac_home_slot(collector, collector->aps[collector->table[next] - 1].mac);
+
+		/* The entry can fill the hole unless its home slot lies cyclically in
+		 * (slot, next].
+		 */
+		if ((slot < next && (home <= slot || home > next)) ||
+		    (slot > next && (home <= slot && home > next))) {
+			collector->table[slot] = collector->table[next];
+			collector->table[next] = 0;
+			slot = next;
+		}
+	}
+}
+
+static int8_t heap_rssi(const struct wifi_ap_collector *collector, uint16_t pos)
+{
+	return collector->aps[collector->heap[pos]].rssi;
+}
+
+static void heap_swap(struct wifi_ap_collector *collector, uint16_t a, uint16_t b)
+{
+	uint16_t tmp = collector->heap[a];
+
+	collector->heap[a] = collector->heap[b];
+	collector->heap[b] = tmp;
+	collector->heap_pos[collector->heap[a]] = a;
+	collector->heap_pos[collector->heap[b]] = b;
+}
+
+static void heap_sift_up(struct wifi_ap_collector *collector, uint16_t pos)
+{
+	uint16_t parent;
+
+	while (pos > 0) {
+		parent = (pos - 1) / 2;
+		if (heap_rssi(collector, parent) <= heap_rssi(collector, pos)) {
+			break;
+		}
+		heap_swap(collector, parent, pos);
+		pos = parent;
+	}
+}
+
+static void heap_sift_down(struct wifi_ap_collector *collector, uint16_t pos)
+{
+	uint16_t child;
+	uint16_t min;
+
+	while (true) {
+		min = pos;
+		child = 2 * pos + 1;
+
+		if (child < collector->cnt &&
+		    heap_rssi(collector, child) < heap_rssi(collector, min)) {
+			min = child;
+		}
+		child++;
+		if (child < collector->cnt &&
+		    heap_rssi(collector, child) < heap_rssi(collector, min)) {
+			min = child;
+		}
+		if (min == pos) {
+			break;
+		}
+		heap_swap(collector, pos, min);
+		pos = min;
+	}
+}
+
+void wifi_ap_collector_reset(struct wifi_ap_collector *collector)
+{
+	memset(collector->table, 0, collector->table_size * sizeof(collector->table[0]));
+	collector->cnt = 0;
+	collector->sorted = false;
+	collector->dropped_cnt = 0;
+	collector->duplicate_cnt = 0;
+	collector->filtered_cnt = 0;
+}
+
+int wifi_ap_collector_add(struct wifi_ap_collector *collector,
+			  const struct wifi_scan_result *entry)
+{
+	uint16_t slot;
+	uint16_t idx;
+
+	if (collector->sorted) {
+		return -EBUSY;
+	}
+
+	if (ap_filtered(collector, entry)) {
+		collector->filtered_cnt++;
+		return -EPERM;
+	}
+
+	slot = table_slot_find(collector, entry->mac);
+	if (collector->table[slot] != 0) {
+		idx = collector->table[slot] - 1;
+		collector->duplicate_cnt++;
+
+		if (entry->rssi <= collector->aps[idx].rssi) {
+			return -EALREADY;
+		}
+
+		/* A stronger signal can only move the entry further from the heap root */
+		collector->aps[idx] = *entry;
+		heap_sift_down(collector, collector->heap_pos[idx]);
+		return 0;
+	}
+
+	if (collector->cnt < collector->max_cnt) {
+		idx = collector->cnt;
+		collector->aps[idx] = *entry;
+		collector->table[slot] = idx + 1;
+		collector->heap[collector->cnt] = idx;
+		collector->heap_pos[idx] = collector->cnt;
+		collector->cnt++;
+		heap_sift_up(collector, collector->cnt - 1);
+		return 0;
+	}
+
+	collector->dropped_cnt++;
+
+	idx = collector->heap[0];
+	if (entry->rssi <= collector->aps[idx].rssi) {
+		return -ENOSPC;
+	}
+
+	/* Replace the weakest access point. It must leave the hash table before its entry is
+	 * overwritten, and the slot of the new one is looked up again because the removal
+	 * may have shifted the probe sequence.
+	 */
+	table_slot_remove(collector, table_slot_find(collector, collector->aps[idx].mac));
+	slot = table_slot_find(collector, entry->mac);
+
+	collector->aps[idx] = *entry;
+	collector->table[slot] = idx + 1;
+	heap_sift_down(collector, 0);
+
+	return 0;
+}
+
+void wifi_ap_collector_sort(struct wifi_ap_collector *collector)
+{
+	struct wifi_scan_result tmp;
+	int j;
+
+	/* Insertion sort is run once per scan on a short array, so it is cheaper than a heap sort
+	 * followed by permuting the entries. Being stable, it keeps the result deterministic for
+	 * access points with an equal signal strength.
+	 */
+	for (int i = 1; i < collector->cnt; i++) {
+		if (collector->aps[i].rssi <= collector->aps[i - 1].rssi) {
+			continue;
+		}
+
+		tmp = collector->aps[i];
+		for (j = i - 1; j >= 0 && collector->aps[j].rssi < tmp.rssi; j--) {
+			collector->aps[j + 1] = collector->aps[j];
+		}
+		collector->aps[j + 1] = tmp;
+	}
+
+	collector->sorted = true;
+}
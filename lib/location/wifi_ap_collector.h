@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef WIFI_AP_COLLECTOR_H
+#define WIFI_AP_COLLECTOR_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <zephyr/sys/util.h>
+#include <zephyr/net/wifi_mgmt.h>
+
+/** Ignore access points with a locally administered MAC address. */
+#define WIFI_AP_COLLECTOR_FILTER_LOCAL_MAC	BIT(0)
+/** Ignore access points that do not broadcast their SSID. */
+#define WIFI_AP_COLLECTOR_FILTER_HIDDEN_SSID	BIT(1)
+
+/**
+ * Collects the strongest unique access points of a Wi-Fi scan into a bounded buffer.
+ *
+ * The stored entries are ordered as a min-heap on RSSI through the heap index array,
+ * so that a new result only needs to be compared against the weakest stored access point.
+ * An open addressing hash table on the MAC address finds duplicates without walking
+ * the stored entries.
+ */
+struct wifi_ap_collector {
+	/** Stored access points. Entries do not move while collecting. */
+	struct wifi_scan_result *aps;
+	/** Min-heap on RSSI, holds indexes to aps. */
+	uint16_t *heap;
+	/** Position of each entry of aps in the heap. */
+	uint16_t *heap_pos;
+	/** Hash table on MAC address, holds indexes to aps plus one, zero for an empty slot. */
+	uint16_t *table;
+	/** Size of aps, heap and heap_pos. */
+	uint16_t max_cnt;
+	/** Size of table. */
+	uint16_t table_size;
+	/** Number of stored access points. */
+	uint16_t cnt;
+	/** WIFI_AP_COLLECTOR_FILTER_* flags. */
+	uint8_t filters;
+	/** Entries have been sorted and no longer form a heap. */
+	bool sorted;
+	/** Number of results dropped because stronger ones filled the buffer. */
+	uint16_t dropped_cnt;
+	/** Number of results seen again with the same MAC address. */
+	uint16_t duplicate_cnt;
+	/** Number of results ignored because of the filters. */
+	uint16_t filtered_cnt;
+};
+
+/* The hash table is kept at most half full so that probe sequences stay short. */
+#define WIFI_AP_COLLECTOR_TABLE_SIZE(_max_cnt) (2 * (_max_cnt) + 1)
+
+/**
+ * Statically define a collector with storage for a given number of access points.
+ *
+ * @param _name Name of the collector.
+ * @param _max_cnt Maximum number of access points kept.
+ * @param _filters WIFI_AP_COLLECTOR_FILTER_* flags.
+ */
+#define WIFI_AP_COLLECTOR_DEFINE(_name, _max_cnt, _filters)				\
+	BUILD_ASSERT((_max_cnt) > 0 && (_max_cnt) < UINT16_MAX / 2);			\
+	static struct wifi_scan_result _name##_aps[_max_cnt];				\
+	static uint16_t _name##_heap[_max_cnt];						\
+	static uint16_t _name##_heap_pos[_max_cnt];					\
+	static uint16_t _name##_table[WIFI_AP_COLLECTOR_TABLE_SIZE(_max_cnt)];		\
+	static struct wifi_ap_collector _name = {					\
+		.aps = _name##_aps,							\
+		.heap = _name##_heap,							\
+		.heap_pos = _name##_heap_pos,						\
+		.table = _name##_table,							\
+		.max_cnt = (_max_cnt),							\
+		.table_size = WIFI_AP_COLLECTOR_TABLE_SIZE(_max_cnt),			\
+		.filters = (_filters),							\
+	}
+
+/**
+ * Empty the collector for a new scan.
+ *
+ * @param collector Collector.
+ */
+void wifi_ap_collector_reset(struct wifi_ap_collector *collector);
+
+/**
+ * Offer a scan result to the collector.
+ *
+ * If the access point is already stored, the stored entry is replaced when the new result
+ * has a stronger signal. If the collector is full, the weakest stored access point is
+ * replaced when the new result has a stronger signal.
+ *
+ * @param collector Collector.
+ * @param entry Scan result.
+ *
+ * @retval 0 The result was stored.
+ * @retval -EALREADY The access point is already stored with an equal or stronger signal.
+ * @retval -ENOSPC The collector is full of access points with an equal or stronger signal.
+ * @retval -EPERM The result was ignored because of the filters.
+ * @retval -EBUSY The collector has been sorted and must be reset first.
+ */
+int wifi_ap_collector_add(struct wifi_ap_collector *collector,
+			  const struct wifi_scan_result *entry);
+
+/**
+ * Sort the stored access points by signal strength, strongest first.
+ *
+ * No results can be added after sorting until the collector is reset.
+ *
+ * @param collector Collector.
+ */
+void wifi_ap_collector_sort(struct wifi_ap_collector *collector);
+
+#endif /* WIFI_AP_COLLECTOR_H */
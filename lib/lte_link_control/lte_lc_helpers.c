@@ -12,8 +12,7 @@
 #include <stdio.h>
 #include <zephyr/device.h>
 #include <modem/lte_lc.h>
-#include <modem/at_cmd_parser.h>
-#include <modem/at_params.h>
+#include <modem/at_token.h>
 #include <zephyr/logging/log.h>
 
 #include "lte_lc_helpers.h"
@@ -131,28 +130,83 @@ void event_handler_list_dispatch(const struct lte_lc_evt *const evt)
 }
 
 
-/* Converts integer on string format to integer type.
- * Returns zero on success, otherwise negative error on failure.
+/* Number of tokens in the window of a token reader. */
+#define TOKEN_READER_WINDOW 16
+
+/* Sequential reader of the tokens of an AT response line. The line is tokenized in fixed-size
+ * windows, so that notifications such as %NCELLMEAS, which can have hundreds of parameters,
+ * are parsed with a small, constant stack footprint. Tokens must be read in increasing
+ * index order.
+ */
+struct token_reader {
+	struct at_token tokens[TOKEN_READER_WINDOW];
+	/* Index of the first token in the window. */
+	size_t base;
+	/* Number of tokens in the window. */
+	size_t count;
+	/* Start of the parameters that are not yet tokenized. */
+	const char *remainder;
+	/* Whether the line has more tokens than the window. */
+	bool more;
+};
+
+/* Returns the token at index, or NULL if the line has fewer tokens. The token getters return
+ * -EINVAL for a NULL token.
  */
-static int string_param_to_int(struct at_param_list *resp_list,
-			       size_t idx, int *output, int base)
+static const struct at_token *token_get(const struct at_token *tokens, size_t count,
+					size_t index)
+{
+	return index < count ? &tokens[index] : NULL;
+}
+
+static int token_reader_init(struct token_reader *reader, const char *at_response)
 {
 	int err;
-	char str_buf[16];
-	size_t len = sizeof(str_buf);
 
-	err = at_params_string_get(resp_list, idx, str_buf, &len);
-	if (err) {
+	err = at_token_line_parse(at_response, reader->tokens, ARRAY_SIZE(reader->tokens),
+				  &reader->count, &reader->remainder);
+	if (err && err != -E2BIG) {
 		return err;
 	}
 
-	str_buf[len] = '\0';
+	reader->base = 0;
+	reader->more = (err == -E2BIG);
 
-	if (string_to_int(str_buf, base, output)) {
-		return -ENODATA;
+	return 0;
+}
+
+/* Returns the token at index, or NULL if the line has fewer tokens or the token has already
+ * been passed.
+ */
+static const struct at_token *token_reader_get(struct token_reader *reader, size_t index)
+{
+	int err;
+
+	while (index >= reader->base + reader->count) {
+		if (!reader->more) {
+			return NULL;
+		}
+
+		reader->base += reader->count;
+
+		err = at_token_params_parse(reader->remainder, reader->tokens,
+					    ARRAY_SIZE(reader->tokens), &reader->count,
+					    &reader->remainder);
+		if (err && err != -E2BIG) {
+			LOG_ERR("Could not tokenize AT response, error: %d", err);
+			reader->count = 0;
+			reader->more = false;
+			return NULL;
+		}
+
+		reader->more = (err == -E2BIG);
 	}
 
-	return 0;
+	if (index < reader->base) {
+		return NULL;
+	}
+
+	return &reader->tokens[index - reader->base];
 }
 
 /* Get Paging Time Window multiplier for the LTE mode.
@@ -168,7 +222,7 @@ static void get_ptw_multiplier(enum lte_lc_lte_mode lte_mode, float *ptw_multipl
 	}
 }
 
-static int get_edrx_value(enum lte_lc_lte_mode lte_mode, uint8_t idx, float *edrx_value)
+static int get_edrx_value(enum lte_lc_lte_mode lte_mode, uint32_t idx, float *edrx_value)
 {
 	uint16_t multiplier = 0;
 
@@ -243,17 +297,17 @@ bool response_is_valid(const char *response, size_t response_len,
 	return true;
 }
 
-/* Get network registration status from CEREG response list.
+/* Get network registration status from CEREG response tokens.
  * Returns the (positive) registration value if it's found, otherwise a negative
  * error code.
  */
-static int get_nw_reg_status(struct at_param_list *list, bool is_notif)
+static int get_nw_reg_status(const struct at_token *tokens, size_t count, bool is_notif)
 {
 	int err, reg_status;
 	size_t reg_status_index = is_notif ? AT_CEREG_REG_STATUS_INDEX :
 					     AT_CEREG_READ_REG_STATUS_INDEX;
 
-	err = at_params_int_get(list, reg_status_index, &reg_status);
+	err = at_token_int_get(token_get(tokens, count, reg_status_index), &reg_status);
 	if (err) {
 		return err;
 	}
@@ -298,35 +352,27 @@ int string_to_int(const char *str_buf, int base, int *output)
 int parse_edrx(const char *at_response, struct lte_lc_edrx_cfg *cfg)
 {
 	int err, tmp_int;
-	uint8_t idx;
-	struct at_param_list resp_list = {0};
-	char tmp_buf[5];
-	size_t len = sizeof(tmp_buf) - 1;
+	uint32_t idx;
+	struct at_token tokens[AT_CEDRXP_PARAMS_COUNT_MAX];
+	const struct at_token *token;
+	size_t count;
 	float ptw_multiplier;
 
 	if ((at_response == NULL) || (cfg == NULL)) {
 		return -EINVAL;
 	}
 
-	err = at_params_list_init(&resp_list, AT_CEDRXP_PARAMS_COUNT_MAX);
-	if (err) {
-		LOG_ERR("Could not init AT params list, error: %d", err);
-		return err;
-	}
-
-	/* Parse response and populate AT parameter list */
-	err = at_parser_params_from_str(at_response,
-					NULL,
-					&resp_list);
+	/* Tokenize the response in place */
+	err = at_token_line_parse(at_response, tokens, ARRAY_SIZE(tokens), &count, NULL);
 	if (err) {
 		LOG_ERR("Could not parse eDRX response, error: %d", err);
-		goto clean_exit;
+		return err;
 	}
 
-	err = at_params_int_get(&resp_list, AT_CEDRXP_ACTT_INDEX, &tmp_int);
+	err = at_token_int_get(token_get(tokens, count, AT_CEDRXP_ACTT_INDEX), &tmp_int);
 	if (err) {
 		LOG_ERR("Failed to get LTE mode, error: %d", err);
-		goto clean_exit;
+		return err;
 	}
 
 	/* The access technology indicators 4 for LTE-M and 5 for NB-IoT are
@@ -344,43 +390,41 @@ int parse_edrx(const char *at_response, struct lte_lc_edrx_cfg *cfg)
 		cfg->edrx = 0;
 		cfg->ptw = 0;
 
-		err = 0;
-		goto clean_exit;
+		return 0;
 	} else if (cfg->mode == 0xFFFFFFFF) {
-		err = -ENODATA;
-		goto clean_exit;
+		return -ENODATA;
 	}
 
-	err = at_params_string_get(&resp_list, AT_CEDRXP_NW_EDRX_INDEX,
-				   tmp_buf, &len);
-	if (err) {
-		LOG_ERR("Failed to get eDRX configuration, error: %d", err);
-		goto clean_exit;
+	token = token_get(tokens, count, AT_CEDRXP_NW_EDRX_INDEX);
+	if ((token == NULL) || (token->type != AT_TOKEN_TYPE_QUOTED_STRING)) {
+		LOG_ERR("Failed to get eDRX configuration");
+		return -EINVAL;
 	}
 
 	/* Workaround for +CEDRXRDP response handling. The AcT-type is handled differently in the
 	 * +CEDRXRDP response, so use of eDRX needs to be determined based on the eDRX value
 	 * parameter.
 	 */
-	if (len == 0) {
+	if (token->len == 0) {
 		/* Network provided eDRX value is empty, eDRX is not used. */
 		cfg->mode = LTE_LC_LTE_MODE_NONE;
 		cfg->edrx = 0;
 		cfg->ptw = 0;
 
-		err = 0;
-		goto clean_exit;
+		return 0;
 	}
 
-	tmp_buf[len] = '\0';
-
 	/* The eDRX value is a multiple of 10.24 seconds, except for the
 	 * special case of idx == 0 for LTE-M, where the value is 5.12 seconds.
 	 * The variable idx is used to map to the entry of index idx in
 	 * Figure 10.5.5.32/3GPP TS 24.008, table for eDRX in S1 mode, and
 	 * note 4 and 5 are taken into account.
 	 */
-	idx = strtoul(tmp_buf, NULL, 2);
+	err = at_token_string_uint_get(token, 2, &idx);
+	if (err) {
+		LOG_ERR("Failed to parse eDRX configuration, error: %d", err);
+		return err;
+	}
 
 	/* Get Paging Time Window multiplier for the LTE mode.
 	 * Multiplier is 1.28 s for LTE-M, and 2.56 s for NB-IoT, derived from
@@ -391,28 +435,21 @@ int parse_edrx(const char *at_response, struct lte_lc_edrx_cfg *cfg)
 	err = get_edrx_value(cfg->mode, idx, &cfg->edrx);
 	if (err) {
 		LOG_ERR("Failed to get eDRX value, error; %d", err);
-		goto clean_exit;
+		return err;
 	}
 
-	len = sizeof(tmp_buf) - 1;
-
-	err = at_params_string_get(&resp_list, AT_CEDRXP_NW_PTW_INDEX,
-				   tmp_buf, &len);
+	err = at_token_string_uint_get(token_get(tokens, count, AT_CEDRXP_NW_PTW_INDEX), 2, &idx);
 	if (err) {
 		LOG_ERR("Failed to get PTW configuration, error: %d", err);
-		goto clean_exit;
+		return err;
 	}
 
-	tmp_buf[len] = '\0';
-
 	/* Value can be a maximum of 15, as there are 16 entries in the table
 	 * for paging time window (both for LTE-M and NB1).
 	 */
-	idx = strtoul(tmp_buf, NULL, 2);
 	if (idx > 15) {
 		LOG_ERR("Invalid PTW lookup index: %d", idx);
-		err = -EINVAL;
-		goto clean_exit;
+		return -EINVAL;
 	}
 
 	/* The Paging Time Window is different for LTE-M and NB-IoT:
@@ -429,10 +466,7 @@ int parse_edrx(const char *at_response, struct lte_lc_edrx_cfg *cfg)
 		(int)cfg->ptw,
 		(int)(100 * (cfg->ptw - (int)cfg->ptw)));
 
-clean_exit:
-	at_params_list_free(&resp_list);
-
-	return err;
+	return 0;
 }
 
 /* Different values in the T3324 lookup table. */
@@ -657,28 +691,21 @@ int parse_rrc_mode(const char *at_response,
 		   size_t mode_index)
 {
 	int err, temp_mode;
-	struct at_param_list resp_list = {0};
+	struct at_token tokens[AT_CSCON_PARAMS_COUNT_MAX];
+	size_t count;
 
-	err = at_params_list_init(&resp_list, AT_CSCON_PARAMS_COUNT_MAX);
-	if (err) {
-		LOG_ERR("Could not init AT params list, error: %d", err);
-		return err;
-	}
-
-	/* Parse CSCON response and populate AT parameter list */
-	err = at_parser_params_from_str(at_response,
-					NULL,
-					&resp_list);
+	/* Tokenize the CSCON response in place */
+	err = at_token_line_parse(at_response, tokens, ARRAY_SIZE(tokens), &count, NULL);
 	if (err) {
 		LOG_ERR("Could not parse +CSCON response, error: %d", err);
-		goto clean_exit;
+		return err;
 	}
 
 	/* Get the RRC mode from the response */
-	err = at_params_int_get(&resp_list, mode_index, &temp_mode);
+	err = at_token_int_get(token_get(tokens, count, mode_index), &temp_mode);
 	if (err) {
 		LOG_ERR("Could not get signalling mode, error: %d", err);
-		goto clean_exit;
+		return err;
 	}
 
 	/* Check if the parsed value maps to a valid registration status */
@@ -688,13 +715,10 @@ int parse_rrc_mode(const char *at_response,
 		*mode = LTE_LC_RRC_MODE_CONNECTED;
 	} else {
 		LOG_ERR("Invalid signalling mode: %d", temp_mode);
-		err = -EINVAL;
+		return -EINVAL;
 	}
 
-clean_exit:
-	at_params_list_free(&resp_list);
-
-	return err;
+	return 0;
 }
 
 int parse_cereg(const char *at_response,
@@ -705,51 +729,30 @@ int parse_cereg(const char *at_response,
 		struct lte_lc_psm_cfg *psm_cfg)
 {
 	int err, status;
-	struct at_param_list resp_list;
-	char str_buf[10];
-	char  response_prefix[sizeof(AT_CEREG_RESPONSE_PREFIX)] = {0};
-	size_t response_prefix_len = sizeof(response_prefix);
-	size_t len = sizeof(str_buf) - 1;
-
-	err = at_params_list_init(&resp_list, AT_CEREG_PARAMS_COUNT_MAX);
-	if (err) {
-		LOG_ERR("Could not init AT params list, error: %d", err);
-		return err;
-	}
+	struct at_token tokens[AT_CEREG_PARAMS_COUNT_MAX];
+	size_t count;
+	uint32_t tmp;
 
-	/* Parse CEREG response and populate AT parameter list */
-	err = at_parser_params_from_str(at_response,
-					NULL,
-					&resp_list);
+	/* Tokenize the CEREG response in place */
+	err = at_token_line_parse(at_response, tokens, ARRAY_SIZE(tokens), &count, NULL);
 	if (err) {
 		LOG_ERR("Could not parse AT+CEREG response, error: %d", err);
-		goto clean_exit;
+		return err;
 	}
 
 	/* Check if AT command response starts with +CEREG */
-	err = at_params_string_get(&resp_list,
-				   AT_RESPONSE_PREFIX_INDEX,
-				   response_prefix,
-				   &response_prefix_len);
-	if (err) {
-		LOG_ERR("Could not get response prefix, error: %d", err);
-		goto clean_exit;
-	}
-
-	if (!response_is_valid(response_prefix, response_prefix_len,
-			       AT_CEREG_RESPONSE_PREFIX)) {
+	if (!at_token_equals(&tokens[AT_RESPONSE_PREFIX_INDEX], AT_CEREG_RESPONSE_PREFIX)) {
 		/* The unsolicited response is not a CEREG response, ignore it.
 		 */
 		LOG_DBG("Not a valid CEREG response");
-		goto clean_exit;
+		return 0;
 	}
 
 	/* Get network registration status */
-	status = get_nw_reg_status(&resp_list, is_notif);
+	status = get_nw_reg_status(tokens, count, is_notif);
 	if (status < 0) {
 		LOG_ERR("Could not get registration status, error: %d", status);
-		err = status;
-		goto clean_exit;
+		return status;
 	}
 
 	if (reg_status) {
@@ -760,34 +763,31 @@ int parse_cereg(const char *at_response,
 
 
 	if (cell && (status != LTE_LC_NW_REG_UICC_FAIL) &&
-	    (at_params_valid_count_get(&resp_list) > AT_CEREG_CELL_ID_INDEX)) {
+	    (count > AT_CEREG_CELL_ID_INDEX)) {
 		/* Parse tracking area code */
-		err = at_params_string_get(
-				&resp_list,
-				is_notif ? AT_CEREG_TAC_INDEX :
-					   AT_CEREG_READ_TAC_INDEX,
-				str_buf, &len);
+		err = at_token_string_uint_get(
+				token_get(tokens, count,
+					  is_notif ? AT_CEREG_TAC_INDEX :
+						     AT_CEREG_READ_TAC_INDEX),
+				16, &tmp);
 		if (err) {
 			LOG_DBG("Could not get tracking area code, error: %d", err);
 			cell->tac = LTE_LC_CELL_TAC_INVALID;
 		} else {
-			str_buf[len] = '\0';
-			cell->tac = strtoul(str_buf, NULL, 16);
+			cell->tac = tmp;
 		}
 
 		/* Parse cell ID */
-		len = sizeof(str_buf) - 1;
-
-		err = at_params_string_get(&resp_list,
-				is_notif ? AT_CEREG_CELL_ID_INDEX :
-					   AT_CEREG_READ_CELL_ID_INDEX,
-				str_buf, &len);
+		err = at_token_string_uint_get(
+				token_get(tokens, count,
+					  is_notif ? AT_CEREG_CELL_ID_INDEX :
+						     AT_CEREG_READ_CELL_ID_INDEX),
+				16, &tmp);
 		if (err) {
 			LOG_DBG("Could not get cell ID, error: %d", err);
 			cell->id = LTE_LC_CELL_EUTRAN_ID_INVALID;
 		} else {
-			str_buf[len] = '\0';
-			cell->id = strtoul(str_buf, NULL, 16);
+			cell->id = tmp;
 		}
 	} else if (cell) {
 		cell->tac = LTE_LC_CELL_TAC_INVALID;
@@ -798,19 +798,13 @@ int parse_cereg(const char *at_response,
 		int mode;
 
 		/* Get currently active LTE mode. */
-		err = at_params_int_get(&resp_list,
-				is_notif ? AT_CEREG_ACT_INDEX :
-					   AT_CEREG_READ_ACT_INDEX,
-				&mode);
+		err = at_token_int_get(token_get(tokens, count,
+						 is_notif ? AT_CEREG_ACT_INDEX :
+							    AT_CEREG_READ_ACT_INDEX),
+				       &mode);
 		if (err) {
 			LOG_DBG("LTE mode not found, error code: %d", err);
 			*lte_mode = LTE_LC_LTE_MODE_NONE;
-
-			/* This is not an error that should be returned, as it's
-			 * expected in some situations that LTE mode is not
-			 * available.
-			 */
-			err = 0;
 		} else {
 			*lte_mode = mode;
 
@@ -819,15 +813,15 @@ int parse_cereg(const char *at_response,
 	}
 
 	/* Check PSM parameters only if we are connected */
-	if ((*reg_status != LTE_LC_NW_REG_REGISTERED_HOME) &&
-	    (*reg_status != LTE_LC_NW_REG_REGISTERED_ROAMING)) {
-		goto clean_exit;
+	if ((status != LTE_LC_NW_REG_REGISTERED_HOME) &&
+	    (status != LTE_LC_NW_REG_REGISTERED_ROAMING)) {
+		return 0;
 	}
 
 	if (psm_cfg != NULL) {
 		char active_time_str[9] = {0};
 		char tau_ext_str[9] = {0};
-		int str_len = 8;
+		size_t str_len = sizeof(active_time_str) - 1;
 		int err_active_time;
 		int err_tau;
 
@@ -835,10 +829,10 @@ int parse_cereg(const char *at_response,
 		psm_cfg->tau = -1;
 
 		/* Get active time */
-		err_active_time = at_params_string_get(
-				&resp_list,
-				is_notif ? AT_CEREG_ACTIVE_TIME_INDEX :
-					   AT_CEREG_READ_ACTIVE_TIME_INDEX,
+		err_active_time = at_token_string_get(
+				token_get(tokens, count,
+					  is_notif ? AT_CEREG_ACTIVE_TIME_INDEX :
+						     AT_CEREG_READ_ACTIVE_TIME_INDEX),
 				active_time_str, &str_len);
 		if (err_active_time) {
 			LOG_DBG("Active time not found, error: %d", err_active_time);
@@ -847,10 +841,12 @@ int parse_cereg(const char *at_response,
 		}
 
 		/* Get Periodic-TAU-ext */
-		err_tau = at_params_string_get(
-				&resp_list,
-				is_notif ? AT_CEREG_TAU_INDEX :
-					   AT_CEREG_READ_TAU_INDEX,
+		str_len = sizeof(tau_ext_str) - 1;
+
+		err_tau = at_token_string_get(
+				token_get(tokens, count,
+					  is_notif ? AT_CEREG_TAU_INDEX :
+						     AT_CEREG_READ_TAU_INDEX),
 				tau_ext_str, &str_len);
 		if (err_tau) {
 			LOG_DBG("TAU not found, error: %d", err_tau);
@@ -871,52 +867,44 @@ int parse_cereg(const char *at_response,
 		/* The notification does not always contain PSM parameters,
 		 * so this is not considered an error
 		 */
-		err = 0;
 	}
 
-clean_exit:
-	at_params_list_free(&resp_list);
-
-	return err;
+	return 0;
 }
 
 int parse_xt3412(const char *at_response, uint64_t *time)
 {
 	int err;
-	struct at_param_list resp_list = {0};
+	int64_t value;
+	struct at_token tokens[AT_XT3412_PARAMS_COUNT_MAX];
+	size_t count;
 
 	if (time == NULL || at_response == NULL) {
 		return -EINVAL;
 	}
 
-	err = at_params_list_init(&resp_list, AT_XT3412_PARAMS_COUNT_MAX);
-	if (err) {
-		LOG_ERR("Could not init AT params list, error: %d", err);
-		return err;
-	}
-
-	/* Parse XT3412 response and populate AT parameter list */
-	err = at_parser_params_from_str(at_response, NULL, &resp_list);
+	/* Tokenize the XT3412 response in place */
+	err = at_token_line_parse(at_response, tokens, ARRAY_SIZE(tokens), &count, NULL);
 	if (err) {
 		LOG_ERR("Could not parse %%XT3412 response, error: %d", err);
-		goto clean_exit;
+		return err;
 	}
 
 	/* Get the remaining time of T3412 from the response */
-	err = at_params_int64_get(&resp_list, AT_XT3412_TIME_INDEX, time);
+	err = at_token_int64_get(token_get(tokens, count, AT_XT3412_TIME_INDEX), &value);
 	if (err) {
 		LOG_ERR("Could not get time until next TAU, error: %d", err);
-		goto clean_exit;
+		return err;
 	}
 
-	if ((*time > T3412_MAX) || *time < 0) {
+	if ((value > T3412_MAX) || (value < 0)) {
 		LOG_WRN("Parsed time parameter not within valid range");
-		err = -EINVAL;
+		return -EINVAL;
 	}
 
-clean_exit:
-	at_params_list_free(&resp_list);
-	return err;
+	*time = value;
+
+	return 0;
 }
 
 uint32_t neighborcell_count_get(const char *at_response)
@@ -948,89 +936,65 @@ uint32_t neighborcell_count_get(const char *at_response)
  *	     The ncells_count indicates how many neighbor cells were parsed
  *	     into the neighbor_cells array.
  * Returns 1 on measurement failure
- * Returns -E2BIG if not all cells were parsed due to memory limitations
  * Returns otherwise a negative error code.
  */
 int parse_ncellmeas(const char *at_response, struct lte_lc_cells_info *cells)
 {
-	int err, status, tmp, len;
-	struct at_param_list resp_list;
-	char  response_prefix[sizeof(AT_NCELLMEAS_RESPONSE_PREFIX)] = {0};
-	size_t response_prefix_len = sizeof(response_prefix);
+	int err, status, tmp;
+	uint32_t tmp_uint;
+	int64_t tmp_int64;
+	struct token_reader reader;
+	size_t len;
 	char tmp_str[7];
-	bool incomplete = false;
-	/* Count the actual number of parameters in the AT response before
-	 * allocating heap for it. This may save quite a bit of heap as the
-	 * worst case scenario is 96 elements.
-	 * 3 is added to account for the parameters that do not have a trailng
-	 * comma.
-	 */
-	size_t param_count = get_char_frequency(at_response, ',') + 3;
 
 	cells->ncells_count = 0;
 	cells->current_cell.id = LTE_LC_CELL_EUTRAN_ID_INVALID;
 
-	err = at_params_list_init(&resp_list, param_count);
+	/* The response is tokenized in place, in windows of a few tokens at a time, as the
+	 * worst case scenario is 96 parameters.
+	 */
+	err = token_reader_init(&reader, at_response);
 	if (err) {
-		LOG_ERR("Could not init AT params list, error: %d", err);
-		return err;
-	}
-
-	err = at_parser_params_from_str(at_response,
-					NULL,
-					&resp_list);
-	if (err && err != -E2BIG) {
 		LOG_ERR("Could not parse AT%%NCELLMEAS response, error: %d", err);
-		goto clean_exit;
-	} else if (err == -E2BIG) {
-		incomplete = true;
-	}
-
-	err = at_params_string_get(&resp_list,
-				   AT_RESPONSE_PREFIX_INDEX,
-				   response_prefix,
-				   &response_prefix_len);
-	if (err) {
-		LOG_ERR("Could not get response prefix, error: %d", err);
-		goto clean_exit;
+		return err;
 	}
 
-	if (!response_is_valid(response_prefix, response_prefix_len,
-			       AT_NCELLMEAS_RESPONSE_PREFIX)) {
+	if (!at_token_equals(token_reader_get(&reader, AT_RESPONSE_PREFIX_INDEX),
+			     AT_NCELLMEAS_RESPONSE_PREFIX)) {
 		/* The unsolicited response is not a NCELLMEAS response, ignore it. */
 		LOG_DBG("Not a valid NCELLMEAS response");
-		goto clean_exit;
+		return 0;
 	}
 
 	/* Status code. */
-	err = at_params_int_get(&resp_list, AT_NCELLMEAS_STATUS_INDEX, &status);
+	err = at_token_int_get(token_reader_get(&reader, AT_NCELLMEAS_STATUS_INDEX), &status);
 	if (err) {
-		goto clean_exit;
+		return err;
 	}
 
 	if (status != AT_NCELLMEAS_STATUS_VALUE_SUCCESS) {
-		err = 1;
-		goto clean_exit;
+		return 1;
 	}
 
 	/* Current cell ID. */
-	err = string_param_to_int(&resp_list, AT_NCELLMEAS_CELL_ID_INDEX, &tmp, 16);
+	err = at_token_string_uint_get(token_reader_get(&reader, AT_NCELLMEAS_CELL_ID_INDEX), 16,
+				       &tmp_uint);
 	if (err) {
-		goto clean_exit;
+		return err;
 	}
 
-	if (tmp > LTE_LC_CELL_EUTRAN_ID_MAX) {
-		tmp = LTE_LC_CELL_EUTRAN_ID_INVALID;
+	if (tmp_uint > LTE_LC_CELL_EUTRAN_ID_MAX) {
+		tmp_uint = LTE_LC_CELL_EUTRAN_ID_INVALID;
 	}
-	cells->current_cell.id = tmp;
+	cells->current_cell.id = tmp_uint;
 
 	/* PLMN */
-	len = sizeof(tmp_str);
+	len = sizeof(tmp_str) - 1;
 
-	err = at_params_string_get(&resp_list, AT_NCELLMEAS_PLMN_INDEX,
-				   tmp_str, &len);
+	err = at_token_string_get(token_reader_get(&reader, AT_NCELLMEAS_PLMN_INDEX),
+				  tmp_str, &len);
 	if (err) {
-		goto clean_exit;
+		return err;
 	}
 
 	tmp_str[len] = '\0';
@@ -1040,7 +1004,7 @@ int parse_ncellmeas(const char *at_response, struct lte_lc_cells_info *cells)
 	 */
 	err = string_to_int(&tmp_str[3], 10, &cells->current_cell.mnc);
 	if (err) {
-		goto clean_exit;
+		return err;
 	}
 
 	/* Null-terminated MCC, read and store it. */
@@ -1048,163 +1012,153 @@ int parse_ncellmeas(const char *at_response, struct lte_lc_cells_info *cells)
 
 	err = string_to_int(tmp_str, 10, &cells->current_cell.mcc);
 	if (err) {
-		goto clean_exit;
+		return err;
 	}
 
 	/* Tracking area code. */
-	err = string_param_to_int(&resp_list, AT_NCELLMEAS_TAC_INDEX, &tmp, 16);
+	err = at_token_string_uint_get(token_reader_get(&reader, AT_NCELLMEAS_TAC_INDEX), 16,
+				       &cells->current_cell.tac);
 	if (err) {
-		goto clean_exit;
+		return err;
 	}
 
-	cells->current_cell.tac = tmp;
-
 	/* Timing advance */
-	err = at_params_int_get(&resp_list, AT_NCELLMEAS_TIMING_ADV_INDEX,
-				&tmp);
+	err = at_token_int_get(token_reader_get(&reader, AT_NCELLMEAS_TIMING_ADV_INDEX), &tmp);
 	if (err) {
-		goto clean_exit;
+		return err;
 	}
 
 	cells->current_cell.timing_advance = tmp;
 
 	/* EARFCN */
-	err = at_params_int_get(&resp_list, AT_NCELLMEAS_EARFCN_INDEX,
-				&cells->current_cell.earfcn);
+	err = at_token_int_get(token_reader_get(&reader, AT_NCELLMEAS_EARFCN_INDEX), &tmp);
 	if (err) {
-		goto clean_exit;
+		return err;
 	}
 
+	cells->current_cell.earfcn = tmp;
+
 	/* Physical cell ID. */
-	err = at_params_short_get(&resp_list, AT_NCELLMEAS_PHYS_CELL_ID_INDEX,
-				&cells->current_cell.phys_cell_id);
+	err = at_token_ushort_get(token_reader_get(&reader, AT_NCELLMEAS_PHYS_CELL_ID_INDEX),
+				  &cells->current_cell.phys_cell_id);
 	if (err) {
-		goto clean_exit;
+		return err;
 	}
 
 	/* RSRP */
-	err = at_params_int_get(&resp_list, AT_NCELLMEAS_RSRP_INDEX, &tmp);
+	err = at_token_short_get(token_reader_get(&reader, AT_NCELLMEAS_RSRP_INDEX),
+				 &cells->current_cell.rsrp);
 	if (err) {
-		goto clean_exit;
+		return err;
 	}
 
-	cells->current_cell.rsrp = tmp;
-
 	/* RSRQ */
-	err = at_params_int_get(&resp_list, AT_NCELLMEAS_RSRQ_INDEX, &tmp);
+	err = at_token_short_get(token_reader_get(&reader, AT_NCELLMEAS_RSRQ_INDEX),
+				 &cells->current_cell.rsrq);
 	if (err) {
-		goto clean_exit;
+		return err;
 	}
 
-	cells->current_cell.rsrq = tmp;
-
 	/* Measurement time. */
-	err = at_params_int64_get(&resp_list, AT_NCELLMEAS_MEASUREMENT_TIME_INDEX,
-				  &cells->current_cell.measurement_time);
+	err = at_token_int64_get(token_reader_get(&reader, AT_NCELLMEAS_MEASUREMENT_TIME_INDEX),
+				 &tmp_int64);
 	if (err) {
-		goto clean_exit;
+		return err;
 	}
 
+	cells->current_cell.measurement_time = tmp_int64;
+
 	/* Neighbor cell count. */
 	cells->ncells_count = neighborcell_count_get(at_response);
 
-	/* Starting from modem firmware v1.3.1, timing advance measurement time
-	 * information is added as the last parameter in the response.
-	 */
-	size_t ta_meas_time_index = AT_NCELLMEAS_PRE_NCELLS_PARAMS_COUNT +
-			cells->ncells_count * AT_NCELLMEAS_N_PARAMS_COUNT;
-
-	if (at_params_valid_count_get(&resp_list) > ta_meas_time_index) {
-		err = at_params_int64_get(&resp_list, ta_meas_time_index,
-					  &cells->current_cell.timing_advance_meas_time);
-		if (err) {
-			goto clean_exit;
-		}
-	} else {
-		cells->current_cell.timing_advance_meas_time = 0;
-	}
-
-	if ((cells->ncells_count == 0) || (cells->neighbor_cells == NULL)) {
-		goto clean_exit;
-	}
-
 	/* Neighboring cells. */
-	for (size_t i = 0; i < cells->ncells_count; i++) {
+	for (size_t i = 0; (cells->neighbor_cells != NULL) && (i < cells->ncells_count); i++) {
 		size_t start_idx = AT_NCELLMEAS_PRE_NCELLS_PARAMS_COUNT +
 				   i * AT_NCELLMEAS_N_PARAMS_COUNT;
 
 		/* EARFCN */
-		err = at_params_int_get(&resp_list,
-					start_idx + AT_NCELLMEAS_N_EARFCN_INDEX,
-					&cells->neighbor_cells[i].earfcn);
+		err = at_token_int_get(token_reader_get(&reader,
+							start_idx + AT_NCELLMEAS_N_EARFCN_INDEX),
+				       &tmp);
 		if (err) {
-			goto clean_exit;
+			return err;
 		}
 
+		cells->neighbor_cells[i].earfcn = tmp;
+
 		/* Physical cell ID. */
-		err = at_params_short_get(&resp_list,
-					  start_idx + AT_NCELLMEAS_N_PHYS_CELL_ID_INDEX,
+		err = at_token_ushort_get(token_reader_get(&reader,
+							   start_idx +
+							   AT_NCELLMEAS_N_PHYS_CELL_ID_INDEX),
 					  &cells->neighbor_cells[i].phys_cell_id);
 		if (err) {
-			goto clean_exit;
+			return err;
 		}
 
 		/* RSRP */
-		err = at_params_int_get(&resp_list,
-					start_idx + AT_NCELLMEAS_N_RSRP_INDEX,
-					&tmp);
+		err = at_token_short_get(token_reader_get(&reader,
+							  start_idx + AT_NCELLMEAS_N_RSRP_INDEX),
+					 &cells->neighbor_cells[i].rsrp);
 		if (err) {
-			goto clean_exit;
+			return err;
 		}
 
-		cells->neighbor_cells[i].rsrp = tmp;
-
 		/* RSRQ */
-		err = at_params_int_get(&resp_list,
-					start_idx + AT_NCELLMEAS_N_RSRQ_INDEX,
-					&tmp);
+		err = at_token_short_get(token_reader_get(&reader,
+							  start_idx + AT_NCELLMEAS_N_RSRQ_INDEX),
+					 &cells->neighbor_cells[i].rsrq);
 		if (err) {
-			goto clean_exit;
+			return err;
 		}
 
-		cells->neighbor_cells[i].rsrq = tmp;
-
 		/* Time difference. */
-		err = at_params_int_get(&resp_list,
-					start_idx + AT_NCELLMEAS_N_TIME_DIFF_INDEX,
-					&cells->neighbor_cells[i].time_diff);
+		err = at_token_int_get(token_reader_get(&reader,
+							start_idx + AT_NCELLMEAS_N_TIME_DIFF_INDEX),
+				       &cells->neighbor_cells[i].time_diff);
 		if (err) {
-			goto clean_exit;
+			return err;
 		}
 	}
 
-	if (incomplete) {
-		err = -E2BIG;
-	}
+	/* Starting from modem firmware v1.3.1, timing advance measurement time
+	 * information is added as the last parameter in the response.
+	 */
+	size_t ta_meas_time_index = AT_NCELLMEAS_PRE_NCELLS_PARAMS_COUNT +
+			cells->ncells_count * AT_NCELLMEAS_N_PARAMS_COUNT;
+	const struct at_token *ta_meas_time = token_reader_get(&reader, ta_meas_time_index);
 
-clean_exit:
-	at_params_list_free(&resp_list);
+	if (ta_meas_time != NULL) {
+		err = at_token_int64_get(ta_meas_time, &tmp_int64);
+		if (err) {
+			return err;
+		}
 
-	return err;
+		cells->current_cell.timing_advance_meas_time = tmp_int64;
+	} else {
+		cells->current_cell.timing_advance_meas_time = 0;
+	}
+
+	return 0;
 }
 
 int parse_ncellmeas_gci(struct lte_lc_ncellmeas_params *params,
 	const char *at_response, struct lte_lc_cells_info *cells)
 {
-	struct at_param_list resp_list;
+	struct token_reader reader;
 	struct lte_lc_ncell *ncells = NULL;
-	int err, status, tmp_int, len;
+	int err, status, tmp_int;
+	uint32_t tmp_uint;
+	int64_t tmp_int64;
 	int16_t tmp_short;
-	char response_prefix[sizeof(AT_NCELLMEAS_RESPONSE_PREFIX)] = {0};
-	size_t response_prefix_len = sizeof(response_prefix);
+	size_t len;
 	char tmp_str[7];
 	bool incomplete = false;
 	int curr_index;
 	size_t i = 0, j = 0, k = 0;
 
-	/* Count the actual number of parameters in the AT response before
-	 * allocating heap for it. This may save quite a bit of heap as the
-	 * worst case scenario is 96 elements.
+	/* Count the number of parameters in the AT response to know where the last cell
+	 * can start. The response is tokenized in windows, so the total count is not
+	 * known up front.
 	 * 3 is added to account for the parameters that do not have a trailing
 	 * comma.
 	 */
@@ -1239,54 +1193,30 @@ int parse_ncellmeas_gci(struct lte_lc_ncellmeas_params *params,
 	 *	[,<n_earfcn2>,<n_phys_cell_id2>,<n_rsrp2>,<n_rsrq2>,<time_diff2>]...]...
 	 */
 
-	err = at_params_list_init(&resp_list, param_count);
+	err = token_reader_init(&reader, at_response);
 	if (err) {
-		LOG_ERR("Could not init AT params list for cell_list, error: %d", err);
-		goto clean_exit;
-	}
-
-	err = at_parser_params_from_str(at_response, NULL, &resp_list);
-	if (err && err != -E2BIG) {
 		LOG_ERR("Could not parse AT%%NCELLMEAS response, error: %d", err);
-		goto clean_exit;
-	} else if (err == -E2BIG) {
-		/* Returns -E2BIG if the buffers set by CONFIG_LTE_NEIGHBOR_CELLS_MAX
-		 * are too small for the modem response. The associated data is still valid,
-		 * but not complete.
-		 */
-		incomplete = true;
-		LOG_WRN("E2BIG was returned, continue. param_count %d, err %d, str %s",
-			param_count, err, at_response);
-	}
-
-	err = at_params_string_get(&resp_list,
-				   AT_RESPONSE_PREFIX_INDEX,
-				   response_prefix,
-				   &response_prefix_len);
-	if (err) {
-		LOG_ERR("Could not get response prefix, error: %d", err);
-		goto clean_exit;
+		return err;
 	}
 
-	if (!response_is_valid(response_prefix, response_prefix_len,
-			       AT_NCELLMEAS_RESPONSE_PREFIX)) {
+	if (!at_token_equals(token_reader_get(&reader, AT_RESPONSE_PREFIX_INDEX),
+			     AT_NCELLMEAS_RESPONSE_PREFIX)) {
 		/* The unsolicited response is not a NCELLMEAS response, ignore it. */
 		LOG_ERR("Not a valid NCELLMEAS response");
-		goto clean_exit;
+		return 0;
 	}
 
 	/* Status code. */
 	curr_index = AT_NCELLMEAS_STATUS_INDEX;
-	err = at_params_int_get(&resp_list, curr_index, &status);
+	err = at_token_int_get(token_reader_get(&reader, curr_index), &status);
 	if (err) {
 		LOG_DBG("Cannot parse NCELLMEAS status");
-		goto clean_exit;
+		return err;
 	}
 
 	if (status == AT_NCELLMEAS_STATUS_VALUE_FAIL) {
-		err = 1;
 		LOG_DBG("NCELLMEAS status %d", status);
-		goto clean_exit;
+		return 1;
 	} else if (status == AT_NCELLMEAS_STATUS_VALUE_INCOMPLETE) {
 		LOG_WRN("NCELLMEAS measurements interrupted; results incomplete");
 	}
@@ -1297,34 +1227,36 @@ int parse_ncellmeas_gci(struct lte_lc_ncellmeas_params *params,
 		struct lte_lc_cell parsed_cell;
 		bool is_serving_cell;
 		uint8_t parsed_ncells_count;
+		size_t to_be_parsed_ncell_count = 0;
 
 		/* <cell_id>  */
 		curr_index++;
-		err = string_param_to_int(&resp_list, curr_index, &tmp_int, 16);
+		err = at_token_string_uint_get(token_reader_get(&reader, curr_index), 16,
+					       &tmp_uint);
 		if (err) {
 			LOG_ERR("Could not parse cell_id, index %d, i %d error: %d",
 				curr_index, i, err);
-			goto clean_exit;
+			return err;
 		}
 
-		if (tmp_int > LTE_LC_CELL_EUTRAN_ID_MAX) {
-			LOG_WRN("cell_id = %d which is > LTE_LC_CELL_EUTRAN_ID_MAX; "
-				"marking invalid", tmp_int);
-			tmp_int = LTE_LC_CELL_EUTRAN_ID_INVALID;
+		if (tmp_uint > LTE_LC_CELL_EUTRAN_ID_MAX) {
+			LOG_WRN("cell_id = %u which is > LTE_LC_CELL_EUTRAN_ID_MAX; "
+				"marking invalid", tmp_uint);
+			tmp_uint = LTE_LC_CELL_EUTRAN_ID_INVALID;
 		}
-		parsed_cell.id = tmp_int;
+		parsed_cell.id = tmp_uint;
 
 		/* <plmn> */
-		len = sizeof(tmp_str);
+		len = sizeof(tmp_str) - 1;
 
 		curr_index++;
-		err = at_params_string_get(&resp_list, curr_index, tmp_str, &len);
+		err = at_token_string_get(token_reader_get(&reader, curr_index), tmp_str, &len);
 		if (err) {
 			LOG_ERR("Could not parse plmn, error: %d", err);
-			goto clean_exit;
+			return err;
 		}
-		/* A successful call to `at_params_string_get` guarantees `len` to be set to
-		 * a value lower than the totalt size of `tmp_str`.
+		/* A successful call to `at_token_string_get` guarantees `len` to be set to
+		 * a value lower than the total size of `tmp_str`.
 		 */
 		tmp_str[len] = '\0';
 
@@ -1334,7 +1266,7 @@ int parse_ncellmeas_gci(struct lte_lc_ncellmeas_params *params,
 		err = string_to_int(&tmp_str[3], 10, &parsed_cell.mnc);
 		if (err) {
 			LOG_ERR("string_to_int, error: %d", err);
-			goto clean_exit;
+			return err;
 		}
 
 		/* Null-terminated MCC, read and store it. */
@@ -1343,97 +1275,98 @@ int parse_ncellmeas_gci(struct lte_lc_ncellmeas_params *params,
 		err = string_to_int(tmp_str, 10, &parsed_cell.mcc);
 		if (err) {
 			LOG_ERR("string_to_int, error: %d", err);
-			goto clean_exit;
+			return err;
 		}
 
 		/* <tac> */
 		curr_index++;
-		err = string_param_to_int(&resp_list, curr_index, &tmp_int, 16);
+		err = at_token_string_uint_get(token_reader_get(&reader, curr_index), 16,
+					       &parsed_cell.tac);
 		if (err) {
 			LOG_ERR("Could not parse tracking_area_code in i %d, error: %d", i, err);
-			goto clean_exit;
+			return err;
 		}
-		parsed_cell.tac = tmp_int;
 
 		/* <ta> */
 		curr_index++;
-		err = at_params_int_get(&resp_list, curr_index, &tmp_int);
+		err = at_token_int_get(token_reader_get(&reader, curr_index), &tmp_int);
 		if (err) {
 			LOG_ERR("Could not parse timing_advance, error: %d", err);
-			goto clean_exit;
+			return err;
 		}
 		parsed_cell.timing_advance = tmp_int;
 
 		/* <ta_meas_time> */
 		curr_index++;
-		err = at_params_int64_get(&resp_list, curr_index,
-					  &parsed_cell.timing_advance_meas_time);
+		err = at_token_int64_get(token_reader_get(&reader, curr_index), &tmp_int64);
 		if (err) {
 			LOG_ERR("Could not parse timing_advance_meas_time, error: %d", err);
-			goto clean_exit;
+			return err;
 		}
+		parsed_cell.timing_advance_meas_time = tmp_int64;
 
 		/* <earfcn> */
 		curr_index++;
-		err = at_params_int_get(&resp_list, curr_index, &parsed_cell.earfcn);
+		err = at_token_int_get(token_reader_get(&reader, curr_index), &tmp_int);
 		if (err) {
 			LOG_ERR("Could not parse earfcn, error: %d", err);
-			goto clean_exit;
+			return err;
 		}
+		parsed_cell.earfcn = tmp_int;
 
 		/* <phys_cell_id> */
 		curr_index++;
-		err = at_params_short_get(&resp_list, curr_index, &parsed_cell.phys_cell_id);
+		err = at_token_ushort_get(token_reader_get(&reader, curr_index),
+					  &parsed_cell.phys_cell_id);
 		if (err) {
 			LOG_ERR("Could not parse phys_cell_id, error: %d", err);
-			goto clean_exit;
+			return err;
 		}
 
 		/* <rsrp> */
 		curr_index++;
-		err = at_params_short_get(&resp_list, curr_index, &parsed_cell.rsrp);
+		err = at_token_short_get(token_reader_get(&reader, curr_index), &parsed_cell.rsrp);
 		if (err) {
 			LOG_ERR("Could not parse rsrp, error: %d", err);
-			goto clean_exit;
+			return err;
 		}
 
 		/* <rsrq> */
 		curr_index++;
-		err = at_params_short_get(&resp_list, curr_index, &parsed_cell.rsrq);
+		err = at_token_short_get(token_reader_get(&reader, curr_index), &parsed_cell.rsrq);
 		if (err) {
 			LOG_ERR("Could not parse rsrq, error: %d", err);
-			goto clean_exit;
+			return err;
 		}
 
 		/* <meas_time> */
 		curr_index++;
-		err = at_params_int64_get(&resp_list, curr_index, &parsed_cell.measurement_time);
+		err = at_token_int64_get(token_reader_get(&reader, curr_index), &tmp_int64);
 		if (err) {
 			LOG_ERR("Could not parse meas_time, error: %d", err);
-			goto clean_exit;
+			return err;
 		}
+		parsed_cell.measurement_time = tmp_int64;
 
 		/* <serving> */
 		curr_index++;
-		err = at_params_short_get(&resp_list, curr_index, &tmp_short);
+		err = at_token_short_get(token_reader_get(&reader, curr_index), &tmp_short);
 		if (err) {
 			LOG_ERR("Could not parse serving, error: %d", err);
-			goto clean_exit;
+			return err;
 		}
 		is_serving_cell = tmp_short;
 
 		/* <neighbor_count> */
 		curr_index++;
-		err = at_params_short_get(&resp_list, curr_index, &tmp_short);
+		err = at_token_short_get(token_reader_get(&reader, curr_index), &tmp_short);
 		if (err) {
 			LOG_ERR("Could not parse neighbor_count, error: %d", err);
-			goto clean_exit;
+			return err;
 		}
 		parsed_ncells_count = tmp_short;
 
 		if (is_serving_cell) {
-			int to_be_parsed_ncell_count = 0;
-
 			/* This the current/serving cell.
 			 * In practice the <neighbor_count> is always 0 for other than
 			 * the serving cell, i.e. no neigbour cell list is available.
@@ -1458,60 +1391,59 @@ int parse_ncellmeas_gci(struct lte_lc_ncellmeas_params *params,
 				if (ncells == NULL) {
 					LOG_WRN("Failed to allocate memory for the ncells"
 						" (continue)");
-					continue;
+					to_be_parsed_ncell_count = 0;
+				} else {
+					cells->neighbor_cells = ncells;
+					cells->ncells_count = to_be_parsed_ncell_count;
 				}
-				cells->neighbor_cells = ncells;
-				cells->ncells_count = to_be_parsed_ncell_count;
 			}
 
 			/* Parse neighbors */
 			for (j = 0; j < to_be_parsed_ncell_count; j++) {
 				/* <n_earfcn[j]> */
 				curr_index++;
-				err = at_params_int_get(&resp_list,
-							curr_index,
-							&cells->neighbor_cells[j].earfcn);
+				err = at_token_int_get(token_reader_get(&reader, curr_index),
+						       &tmp_int);
 				if (err) {
 					LOG_ERR("Could not parse n_earfcn, error: %d", err);
-					goto clean_exit;
+					return err;
 				}
+				cells->neighbor_cells[j].earfcn = tmp_int;
 
 				/* <n_phys_cell_id[j]> */
 				curr_index++;
-				err = at_params_short_get(&resp_list,
-							  curr_index,
+				err = at_token_ushort_get(token_reader_get(&reader, curr_index),
 							  &cells->neighbor_cells[j].phys_cell_id);
 				if (err) {
 					LOG_ERR("Could not parse n_phys_cell_id, error: %d", err);
-					goto clean_exit;
+					return err;
 				}
 
 				/* <n_rsrp[j]> */
 				curr_index++;
-				err = at_params_int_get(&resp_list, curr_index, &tmp_int);
+				err = at_token_short_get(token_reader_get(&reader, curr_index),
+							 &cells->neighbor_cells[j].rsrp);
 				if (err) {
 					LOG_ERR("Could not parse n_rsrp, error: %d", err);
-					goto clean_exit;
+					return err;
 				}
-				cells->neighbor_cells[j].rsrp = tmp_int;
 
 				/* <n_rsrq[j]> */
 				curr_index++;
-				err = at_params_int_get(&resp_list, curr_index, &tmp_int);
+				err = at_token_short_get(token_reader_get(&reader, curr_index),
+							 &cells->neighbor_cells[j].rsrq);
 				if (err) {
 					LOG_ERR("Could not parse n_rsrq, error: %d", err);
-					goto clean_exit;
+					return err;
 				}
-				cells->neighbor_cells[j].rsrq = tmp_int;
 
 				/* <time_diff[j]> */
 				curr_index++;
-				err = at_params_int_get(&resp_list,
-							curr_index,
-							&cells->neighbor_cells[j].time_diff);
+				err = at_token_int_get(token_reader_get(&reader, curr_index),
+						       &cells->neighbor_cells[j].time_diff);
 				if (err) {
 					LOG_ERR("Could not parse time_diff, error: %d", err);
-					goto clean_exit;
+					return err;
 				}
 			}
 		} else {
@@ -1519,64 +1451,62 @@ int parse_ncellmeas_gci(struct lte_lc_ncellmeas_params *params,
 			cells->gci_cells_count++; /* Increase count for non-serving GCI cell */
 			k++;
 		}
+
+		/* Skip the neighbor cells that were not parsed, so that the next cell is
+		 * parsed from the right position.
+		 */
+		curr_index += (parsed_ncells_count - to_be_parsed_ncell_count) *
+			      AT_NCELLMEAS_N_PARAMS_COUNT;
 	}
 
 	if (incomplete) {
 		err = -E2BIG;
 		LOG_ERR("Buffer is too small; results incomplete: %d", err);
+		return err;
 	}
 
-clean_exit:
-	at_params_list_free(&resp_list);
-
-	return err;
+	return 0;
 }
 
 int parse_xmodemsleep(const char *at_response, struct lte_lc_modem_sleep *modem_sleep)
 {
 	int err;
-	struct at_param_list resp_list = {0};
+	struct at_token tokens[AT_XMODEMSLEEP_PARAMS_COUNT_MAX];
+	size_t count;
 	uint16_t type;
 
 	if (modem_sleep == NULL || at_response == NULL) {
 		return -EINVAL;
 	}
 
-	err = at_params_list_init(&resp_list, AT_XMODEMSLEEP_PARAMS_COUNT_MAX);
-	if (err) {
-		LOG_ERR("Could not init AT params list, error: %d", err);
-		return err;
-	}
-
-	/* Parse XMODEMSLEEP response and populate AT parameter list */
-	err = at_parser_params_from_str(at_response, NULL, &resp_list);
+	/* Tokenize the XMODEMSLEEP response in place */
+	err = at_token_line_parse(at_response, tokens, ARRAY_SIZE(tokens), &count, NULL);
 	if (err) {
 		LOG_ERR("Could not parse %%XMODEMSLEEP response, error: %d", err);
-		goto clean_exit;
+		return err;
 	}
 
-	err = at_params_unsigned_short_get(&resp_list, AT_XMODEMSLEEP_TYPE_INDEX, &type);
+	err = at_token_ushort_get(token_get(tokens, count, AT_XMODEMSLEEP_TYPE_INDEX), &type);
 	if (err) {
 		LOG_ERR("Could not get mode sleep type, error: %d", err);
-		goto clean_exit;
+		return err;
 	}
 	modem_sleep->type = type;
 
 	/* If the time parameter is not present sleep time is considered infinite. */
-	if (at_params_valid_count_get(&resp_list) < AT_XMODEMSLEEP_PARAMS_COUNT_MAX - 1) {
+	if (count < AT_XMODEMSLEEP_PARAMS_COUNT_MAX - 1) {
 		modem_sleep->time = -1;
-		goto clean_exit;
+		return 0;
 	}
 
-	err = at_params_int64_get(&resp_list, AT_XMODEMSLEEP_TIME_INDEX, &modem_sleep->time);
+	err = at_token_int64_get(token_get(tokens, count, AT_XMODEMSLEEP_TIME_INDEX),
+				 &modem_sleep->time);
 	if (err) {
 		LOG_ERR("Could not get time until next modem sleep, error: %d", err);
-		goto clean_exit;
+		return err;
 	}
 
-clean_exit:
-	at_params_list_free(&resp_list);
-	return err;
+	return 0;
 }
 
 int parse_mdmev(const char *at_response, enum lte_lc_modem_evt *modem_evt)
@@ -71,8 +71,8 @@
 
 /* XT3412 command parameters */
 #define AT_XT3412_SUB				"AT%%XT3412=1,%d,%d"
-#define AT_XT3412_PARAMS_COUNT_MAX		4
-#define AT_XT3412_TIME_INDEX			2
+#define AT_XT3412_PARAMS_COUNT_MAX		2
+#define AT_XT3412_TIME_INDEX			1
 #define T3412_MAX				35712000000
 
 /* NCELLMEAS notification parameters */
@@ -260,18 +260,15 @@ uint32_t neighborcell_count_get(const char *at_response);
  *
  * 18446744073709551614 is the maximum value for timing_advance_meas_time and
  * measurement_time in @ref lte_lc_cells_info.
- * This value could be represented with uint64_t but cannot be stored by at_parser,
- * which internally uses int64_t value for all integers.
+ * This value could be represented with uint64_t but cannot be parsed by the AT tokenizer,
+ * which parses all integers as int64_t values.
  * Hence, the maximum value for these fields is represented by 63 bits and is
  * 9223372036854775807, which still represents millions of years.
  *
  * @param at_response Pointer to buffer with AT response.
  * @param ncell Pointer to ncell structure.
  *
- * @return Zero on success or (negative) error code otherwise.
- *         Returns -E2BIG if the static buffers set by CONFIG_LTE_NEIGHBOR_CELLS_MAX
- *         are to small for the modem response. The associated data is still valid,
- *         but not complete.
+ * @return Zero on success, 1 on measurement failure, or (negative) error code otherwise.
  */
 int parse_ncellmeas(const char *at_response, struct lte_lc_cells_info *cells);
 
@@ -280,8 +277,8 @@ int parse_ncellmeas(const char *at_response, struct lte_lc_cells_info *cells);
  *
  * 18446744073709551614 is the maximum value for timing_advance_meas_time and
  * measurement_time in @ref lte_lc_cells_info.
- * This value could be represented with uint64_t but cannot be stored by at_parser,
- * which internally uses int64_t value for all integers.
+ * This value could be represented with uint64_t but cannot be parsed by the AT tokenizer,
+ * which parses all integers as int64_t values.
  * Hence, the maximum value for these fields is represented by 63 bits and is
  * 9223372036854775807, which still represents millions of years.
  *
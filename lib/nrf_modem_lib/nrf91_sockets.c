@@ -49,12 +49,17 @@
 /* Offloading context related to nRF socket. */
 static struct nrf_sock_ctx {
 	int nrf_fd; /* nRF socket descriptior. */
+	int type; /* Socket type, SOCK_STREAM, SOCK_DGRAM or SOCK_RAW. */
 	struct k_mutex *lock; /* Mutex associated with the socket. */
 	struct k_poll_signal poll; /* poll() signal. */
 } offload_ctx[NRF_MODEM_MAX_SOCKET_COUNT];
 
 static K_MUTEX_DEFINE(ctx_lock);
 
+/* Intermediate buffers used by sendmsg() to repack scattered data. */
+K_MEM_SLAB_DEFINE_STATIC(sendmsg_bufs, CONFIG_NRF_MODEM_LIB_SENDMSG_BUF_SIZE,
+			 CONFIG_NRF_MODEM_LIB_SENDMSG_BUF_COUNT, sizeof(void *));
+
 static const struct socket_op_vtable nrf91_socket_fd_op_vtable;
 
 /* Offloading disabled in general. */
@@ -62,7 +67,7 @@ static bool offload_disabled;
 /* TLS offloading disabled only. */
 static bool tls_offload_disabled;
 
-static struct nrf_sock_ctx *allocate_ctx(int nrf_fd)
+static struct nrf_sock_ctx *allocate_ctx(int nrf_fd, int type)
 {
 	struct nrf_sock_ctx *ctx = NULL;
 
@@ -72,6 +77,7 @@ static struct nrf_sock_ctx *allocate_ctx(int nrf_fd)
 		if (offload_ctx[i].nrf_fd == -1) {
 			ctx = &offload_ctx[i];
 			ctx->nrf_fd = nrf_fd;
+			ctx->type = type;
 			break;
 		}
 	}
@@ -81,6 +87,12 @@ static struct nrf_sock_ctx *allocate_ctx(int nrf_fd)
 	return ctx;
 }
 
+/* Datagram and raw sockets preserve message boundaries. */
+static bool is_datagram(const struct nrf_sock_ctx *ctx)
+{
+	return ctx->type == SOCK_DGRAM || ctx->type == SOCK_RAW;
+}
+
 static void release_ctx(struct nrf_sock_ctx *ctx)
 {
 	k_mutex_lock(&ctx_lock, K_FOREVER);
@@ -391,7 +403,7 @@ static int nrf91_socket_offload_accept(void *obj, struct sockaddr *addr,
 		goto error;
 	}
 
-	ctx = allocate_ctx(new_sd);
+	ctx = allocate_ctx(new_sd, SOCK_STREAM);
 	if (ctx == NULL) {
 		errno = ENOMEM;
 		goto error;
@@ -678,57 +690,94 @@ static ssize_t nrf91_socket_offload_sendto(void *obj, const void *buf,
 	return retval;
 }
 
+static ssize_t sendmsg_repacked(void *obj, const struct msghdr *msg, int flags,
+				uint8_t *buf, size_t len)
+{
+	struct nrf_sock_ctx *ctx = OBJ_TO_CTX(obj);
+	size_t offset;
+	ssize_t ret;
+
+	offset = 0;
+	for (int i = 0; i < msg->msg_iovlen; i++) {
+		memcpy(buf + offset, msg->msg_iov[i].iov_base, msg->msg_iov[i].iov_len);
+		offset += msg->msg_iov[i].iov_len;
+	}
+
+	/* A datagram is sent as a whole or not at all. */
+	if (is_datagram(ctx)) {
+		return nrf91_socket_offload_sendto(obj, buf, len, flags,
+						   msg->msg_name, msg->msg_namelen);
+	}
+
+	offset = 0;
+	while (offset < len) {
+		ret = nrf91_socket_offload_sendto(obj,
+			(buf + offset), (len - offset), flags,
+			msg->msg_name, msg->msg_namelen);
+		if (ret < 0) {
+			return ret;
+		}
+		offset += (size_t)ret;
+	}
+
+	return offset;
+}
+
 static ssize_t nrf91_socket_offload_sendmsg(void *obj, const struct msghdr *msg,
 					    int flags)
 {
-	ssize_t len = 0;
+	struct nrf_sock_ctx *ctx = OBJ_TO_CTX(obj);
+	size_t len = 0;
+	size_t offset;
 	ssize_t ret;
-	ssize_t offset;
+	int chunks = 0;
 	int i;
-	static K_MUTEX_DEFINE(sendmsg_lock);
-	static uint8_t buf[CONFIG_NRF_MODEM_LIB_SENDMSG_BUF_SIZE];
+	void *buf;
 
 	if (msg == NULL) {
 		errno = EINVAL;
 		return -1;
 	}
 
-	/* Try to reduce number of `sendto` calls - copy data if they fit into
-	 * a single buffer
-	 */
-
 	for (i = 0; i < msg->msg_iovlen; i++) {
-		len += msg->msg_iov[i].iov_len;
+		if (msg->msg_iov[i].iov_len > 0) {
+			len += msg->msg_iov[i].iov_len;
+			chunks++;
+		}
 	}
 
-	if (len <= sizeof(buf)) {
-		/* Protect `buf` access with a mutex. */
-		k_mutex_lock(&sendmsg_lock, K_FOREVER);
-		len = 0;
+	/* Try to reduce number of `sendto` calls - copy data if they fit into
+	 * a single buffer. Each sender takes its own buffer from the pool, so
+	 * senders on different sockets do not block each other.
+	 */
+	if (chunks > 1 && len <= CONFIG_NRF_MODEM_LIB_SENDMSG_BUF_SIZE) {
+		k_timeout_t timeout = K_NO_WAIT;
 
-		for (i = 0; i < msg->msg_iovlen; i++) {
-			memcpy(buf + len, msg->msg_iov[i].iov_base,
-			       msg->msg_iov[i].iov_len);
-			len += msg->msg_iov[i].iov_len;
+		/* Datagrams must not be split, so wait for a buffer to become
+		 * available unless the caller asked not to block.
+		 */
+		if (is_datagram(ctx) && !(flags & ZSOCK_MSG_DONTWAIT)) {
+			timeout = K_FOREVER;
 		}
 
-		offset = 0;
-		ret = 0;
-		while ((offset < len) && (ret >= 0)) {
-			ret = nrf91_socket_offload_sendto(obj,
-				(buf + offset), (len - offset), flags,
-				msg->msg_name, msg->msg_namelen);
-			if (ret > 0) {
-				offset += ret;
-			}
+		if (k_mem_slab_alloc(&sendmsg_bufs, &buf, timeout) == 0) {
+			ret = sendmsg_repacked(obj, msg, flags, buf, len);
+			k_mem_slab_free(&sendmsg_bufs, buf);
+			return ret;
 		}
 
-		k_mutex_unlock(&sendmsg_lock);
-		return ret;
+		if (is_datagram(ctx)) {
+			errno = EAGAIN;
+			return -1;
+		}
+	} else if (chunks > 1 && is_datagram(ctx)) {
+		/* Sending each part separately would split the datagram. */
+		errno = EMSGSIZE;
+		return -1;
 	}
 
-	/* If the data won't fit into intermediate buffer, send the buffers
-	 * separately
+	/* If the data won't fit into intermediate buffer, or there is only one
+	 * buffer to send, send the buffers separately without copying.
 	 */
 
 	len = 0;
@@ -747,8 +796,13 @@ static ssize_t nrf91_socket_offload_sendmsg(void *obj, const struct msghdr *msg,
 			if (ret < 0) {
 				return ret;
 			}
-			offset += ret;
-			len += ret;
+			offset += (size_t)ret;
+			len += (size_t)ret;
+
+			/* Never send the remainder of a datagram as a new one. */
+			if (is_datagram(ctx)) {
+				break;
+			}
 		}
 	}
 
@@ -1111,7 +1165,7 @@ static int nrf91_socket_create(int family, int type, int proto)
 		return -1;
 	}
 
-	ctx = allocate_ctx(sd);
+	ctx = allocate_ctx(sd, type);
 	if (ctx == NULL) {
 		errno = ENOMEM;
 		nrf_close(sd);
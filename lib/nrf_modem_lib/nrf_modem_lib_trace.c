@@ -16,6 +16,10 @@
 #include <nrf_modem_trace.h>
 #include <nrf_errno.h>
 
+#if CONFIG_NRF_MODEM_LIB_TRACE_COMPRESSION
+#include "trace_compression.h"
+#endif
+
 LOG_MODULE_REGISTER(nrf_modem_lib_trace, CONFIG_NRF_MODEM_LIB_LOG_LEVEL);
 
 K_SEM_DEFINE(trace_sem, 0, 1);
@@ -164,6 +168,39 @@ static void backend_bps_log(struct k_work *item)
 }
 #endif
 
+#if CONFIG_NRF_MODEM_LIB_TRACE_COMPRESSION
+#define COMPRESSION_BLOCK_SIZE CONFIG_NRF_MODEM_LIB_TRACE_COMPRESSION_BLOCK_SIZE
+#define COMPRESSION_FRAME_SIZE TRACE_COMPRESSION_FRAME_SIZE(COMPRESSION_BLOCK_SIZE)
+#define COMPRESSION_FLUSH_TIMEOUT_MS CONFIG_NRF_MODEM_LIB_TRACE_COMPRESSION_FLUSH_TIMEOUT_MS
+
+BUILD_ASSERT(COMPRESSION_BLOCK_SIZE <= TRACE_COMPRESSION_BLOCK_SIZE_MAX);
+
+/* Raw trace data waiting to be compressed. */
+static uint8_t compression_block[COMPRESSION_BLOCK_SIZE];
+static size_t compression_block_len;
+/* Compressed frame waiting to be written to the backend. */
+static uint8_t compression_frame[COMPRESSION_FRAME_SIZE];
+static size_t compression_frame_len;
+/* Part of the current trace fragment that was already moved to the block. */
+static size_t compression_frag_offset;
+
+#if CONFIG_NRF_MODEM_LIB_TRACE_BITRATE_LOG
+static uint64_t compression_raw_bytes;
+static uint64_t compression_frame_bytes;
+static uint64_t compression_cycles;
+#endif
+
+#if CONFIG_NRF_MODEM_LIB_TRACE_COMPRESSION_READ_DECOMPRESS
+static uint8_t decompress_frame[COMPRESSION_FRAME_SIZE];
+static size_t decompress_frame_len;
+static uint8_t decompress_block[TRACE_COMPRESSION_BLOCK_SIZE_MAX];
+static size_t decompress_block_len;
+static size_t decompress_block_offset;
+/* Remaining part of a frame too large for the frame buffer, to be dropped. */
+static size_t decompress_skip_len;
+#endif
+#endif /* CONFIG_NRF_MODEM_LIB_TRACE_COMPRESSION */
+
 #if CONFIG_NRF_MODEM_LIB_TRACE_BITRATE_LOG
 #define BPS_LOG_PERIOD_MS CONFIG_NRF_MODEM_LIB_TRACE_BITRATE_LOG_PERIOD_MS
 #define BPS_LOG_PERIOD K_MSEC(BPS_LOG_PERIOD_MS)
@@ -199,6 +236,17 @@ static void bps_log(struct k_work *item)
 	LOG_INF("Written: %d, read: %d", trace_bytes_received_total, trace_bytes_read_total);
 	LOG_INF("Trace bitrate (bps): %u", trace_data_bps_avg);
 
+#if CONFIG_NRF_MODEM_LIB_TRACE_COMPRESSION
+	if (compression_frame_bytes != 0 && compression_raw_bytes != 0) {
+		uint32_t ratio = compression_raw_bytes * 100 / compression_frame_bytes;
+		uint32_t us_per_kib = k_cyc_to_us_floor64(compression_cycles) * 1024 /
+				      compression_raw_bytes;
+
+		LOG_INF("Trace compression ratio: %u.%02u, cost: %u us/KiB",
+			ratio / 100, ratio % 100, us_per_kib);
+	}
+#endif
+
 	k_work_schedule(&bps_log_work, BPS_LOG_PERIOD);
 }
 
@@ -231,16 +279,15 @@ int nrf_modem_lib_trace_processing_done_wait(k_timeout_t timeout)
 	return 0;
 }
 
-static int trace_fragment_write(struct nrf_modem_trace_data *frag)
+static int trace_data_write(const void *data, size_t len)
 {
 	int ret;
-	size_t remaining = frag->len;
+	size_t remaining = len;
 
 	while (remaining) {
 		PERF_START();
 
-		ret = trace_backend.write((void *)((uint8_t *)frag->data + frag->len - remaining),
-					  remaining);
+		ret = trace_backend.write((const uint8_t *)data + len - remaining, remaining);
 
 		PERF_END(ret);
 
@@ -272,6 +319,153 @@ static int trace_fragment_write(struct nrf_modem_trace_data *frag)
 	return 0;
 }
 
+#if CONFIG_NRF_MODEM_LIB_TRACE_COMPRESSION
+static int trace_processed_compressed(size_t len)
+{
+	/* The backend reports the compressed bytes it has written. The trace data itself is
+	 * marked as processed once it has been copied into the compression block.
+	 */
+	ARG_UNUSED(len);
+
+	return 0;
+}
+
+static void compression_block_seal(void)
+{
+#if CONFIG_NRF_MODEM_LIB_TRACE_BITRATE_LOG
+	uint32_t start = k_cycle_get_32();
+#endif
+
+	compression_frame_len = trace_compression_frame_encode(compression_block,
+							       compression_block_len,
+							       compression_frame);
+
+#if CONFIG_NRF_MODEM_LIB_TRACE_BITRATE_LOG
+	compression_cycles += k_cycle_get_32() - start;
+	compression_raw_bytes += compression_block_len;
+	compression_frame_bytes += compression_frame_len;
+#endif
+
+	compression_block_len = 0;
+}
+
+static int compression_frame_write(void)
+{
+	int err;
+
+	if (compression_frame_len == 0) {
+		return 0;
+	}
+
+	err = trace_data_write(compression_frame, compression_frame_len);
+	if (err) {
+		/* Keep the frame, it is written again once the backend has space. */
+		return err;
+	}
+
+	compression_frame_len = 0;
+
+	return 0;
+}
+
+static int compression_flush(void)
+{
+	int err;
+
+	/* A frame left over from a failed write goes out first. */
+	err = compression_frame_write();
+	if (err) {
+		return err;
+	}
+
+	if (compression_block_len == 0) {
+		return 0;
+	}
+
+	compression_block_seal();
+
+	return compression_frame_write();
+}
+
+static void compression_reset(void)
+{
+	compression_block_len = 0;
+	compression_frame_len = 0;
+	compression_frag_offset = 0;
+}
+
+static int trace_fragment_write(struct nrf_modem_trace_data *frag)
+{
+	int err;
+	size_t len;
+
+	err = compression_frame_write();
+	if (err) {
+		return err;
+	}
+
+	/* The offset is kept if writing fails, so that retrying the fragment does not
+	 * duplicate the part that was already compressed.
+	 */
+	while (compression_frag_offset < frag->len) {
+		len = MIN(frag->len - compression_frag_offset,
+			  COMPRESSION_BLOCK_SIZE - compression_block_len);
+
+		memcpy(&compression_block[compression_block_len],
+		       (const uint8_t *)frag->data + compression_frag_offset, len);
+
+		compression_block_len += len;
+		compression_frag_offset += len;
+
+		err = nrf_modem_trace_processed(len);
+		if (err) {
+			LOG_ERR("nrf_modem_trace_processed failed, err %d", err);
+		}
+
+		if (compression_block_len == COMPRESSION_BLOCK_SIZE) {
+			compression_block_seal();
+
+			err = compression_frame_write();
+			if (err) {
+				return err;
+			}
+		}
+	}
+
+	compression_frag_offset = 0;
+
+	return 0;
+}
+
+#define TRACE_GET_TIMEOUT                                                                          \
+	(compression_block_len ? COMPRESSION_FLUSH_TIMEOUT_MS : NRF_MODEM_OS_FOREVER)
+#define TRACE_PROCESSED_CB trace_processed_compressed
+#else
+static int trace_fragment_write(struct nrf_modem_trace_data *frag)
+{
+	return trace_data_write(frag->data, frag->len);
+}
+
+#define TRACE_GET_TIMEOUT NRF_MODEM_OS_FOREVER
+#define TRACE_PROCESSED_CB nrf_modem_trace_processed
+#endif /* CONFIG_NRF_MODEM_LIB_TRACE_COMPRESSION */
+
+/* Returns true when tracing can continue after the backend has been cleared. */
+static bool trace_backend_full_handle(void)
+{
+	nrf_modem_lib_trace_callback(NRF_MODEM_LIB_TRACE_EVT_FULL);
+
+	if (!trace_backend.clear) {
+		return false;
+	}
+
+	has_space = false;
+	k_sem_give(&trace_done_sem);
+	k_sem_take(&trace_clear_sem, K_FOREVER);
+
+	return true;
+}
+
 void trace_thread_handler(void)
 {
 	int err;
@@ -286,7 +480,7 @@ trace_reset:
 			k_work_schedule(&backend_suspend_work, BACKEND_SUSPEND_DELAY);
 		}
 
-		err = nrf_modem_trace_get(&frags, &n_frags, NRF_MODEM_OS_FOREVER);
+		err = nrf_modem_trace_get(&frags, &n_frags, TRACE_GET_TIMEOUT);
 		if (trace_backend.suspend) {
 			k_work_cancel_delayable(&backend_suspend_work);
 		}
@@ -295,6 +489,21 @@ trace_reset:
 			/* Success */
 			UPDATE_TRACE_BYTES_RECEIVED(frags, n_frags);
 			break;
+#if CONFIG_NRF_MODEM_LIB_TRACE_COMPRESSION
+		case -NRF_EAGAIN:
+			/* No more traces for a while, write out the partial block. */
+			err = compression_flush();
+			while (err == -ENOSPC) {
+				if (!trace_backend_full_handle()) {
+					goto deinit;
+				}
+				err = compression_flush();
+			}
+			if (err) {
+				goto deinit;
+			}
+			continue;
+#endif
 		case -NRF_ESHUTDOWN:
 			LOG_INF("Modem was turned off, no more traces");
 			goto deinit;
@@ -319,15 +528,9 @@ trace_reset:
 			case 0:
 				break;
 			case -ENOSPC:
-				nrf_modem_lib_trace_callback(NRF_MODEM_LIB_TRACE_EVT_FULL);
-
-				if (!trace_backend.clear) {
+				if (!trace_backend_full_handle()) {
 					goto deinit;
 				}
-
-				has_space = false;
-				k_sem_give(&trace_done_sem);
-				k_sem_take(&trace_clear_sem, K_FOREVER);
 				/* Try the same fragment again */
 				i--;
 				continue;
@@ -339,6 +542,12 @@ trace_reset:
 	}
 
 deinit:
+#if CONFIG_NRF_MODEM_LIB_TRACE_COMPRESSION
+	/* Best effort, the remaining trace data is lost if the backend is full. */
+	(void)compression_flush();
+	compression_reset();
+#endif
+
 	err = trace_deinit();
 	if (err) {
 		LOG_ERR("trace_deinit failed with err: %d", err);
@@ -358,7 +567,7 @@ static int trace_init(void)
 
 	k_sem_take(&trace_done_sem, K_FOREVER);
 
-	err = trace_backend.init(nrf_modem_trace_processed);
+	err = trace_backend.init(TRACE_PROCESSED_CB);
 	if (err) {
 		LOG_ERR("trace_backend: init failed with err: %d", err);
 		return err;
@@ -462,6 +671,96 @@ size_t nrf_modem_lib_trace_data_size(void)
 	return trace_backend.data_size();
 }
 
+#if CONFIG_NRF_MODEM_LIB_TRACE_COMPRESSION_READ_DECOMPRESS
+static void decompress_reset(void)
+{
+	decompress_frame_len = 0;
+	decompress_block_len = 0;
+	decompress_block_offset = 0;
+	decompress_skip_len = 0;
+}
+
+static int trace_read_decompress(uint8_t *buf, size_t len)
+{
+	size_t copied = 0;
+	size_t frame_len;
+	int ret;
+
+	while (copied < len) {
+		if (decompress_block_offset < decompress_block_len) {
+			size_t to_copy = MIN(len - copied,
+					     decompress_block_len - decompress_block_offset);
+
+			memcpy(&buf[copied], &decompress_block[decompress_block_offset], to_copy);
+			copied += to_copy;
+			decompress_block_offset += to_copy;
+			continue;
+		}
+
+		if (decompress_skip_len) {
+			ret = trace_backend.read(decompress_frame,
+						 MIN(decompress_skip_len, sizeof(decompress_frame)));
+			if (ret <= 0) {
+				return copied ? copied : ret;
+			}
+			decompress_skip_len -= ret;
+			continue;
+		}
+
+		/* Read the frame header first, then the rest of the frame. */
+		if (decompress_frame_len < TRACE_COMPRESSION_FRAME_HDR_SIZE) {
+			frame_len = TRACE_COMPRESSION_FRAME_HDR_SIZE;
+		} else {
+			ret = trace_compression_frame_len(decompress_frame);
+			if (ret < 0) {
+				LOG_ERR("Invalid compressed trace frame");
+				decompress_reset();
+				return ret;
+			}
+			frame_len = ret;
+			if (frame_len > sizeof(decompress_frame)) {
+				if (copied) {
+					/* Report the error on the next read. */
+					return copied;
+				}
+				/* Written with a larger block size, or corrupted. Drop the frame
+				 * and resynchronize on the next one.
+				 */
+				LOG_ERR("Compressed trace frame too large, %zu bytes", frame_len);
+				decompress_skip_len = frame_len - decompress_frame_len;
+				decompress_frame_len = 0;
+				return -EBADMSG;
+			}
+		}
+
+		if (decompress_frame_len < frame_len) {
+			ret = trace_backend.read(&decompress_frame[decompress_frame_len],
+						 frame_len - decompress_frame_len);
+			if (ret <= 0) {
+				/* No more data for now, the partial frame is kept. */
+				return copied ? copied : ret;
+			}
+			decompress_frame_len += ret;
+			continue;
+		}
+
+		ret = trace_compression_frame_decode(decompress_frame, decompress_frame_len,
+						     decompress_block, sizeof(decompress_block));
+		decompress_frame_len = 0;
+		if (ret < 0) {
+			LOG_ERR("Failed to decompress trace frame, err %d", ret);
+			decompress_reset();
+			return ret;
+		}
+
+		decompress_block_len = ret;
+		decompress_block_offset = 0;
+	}
+
+	return copied;
+}
+#endif /* CONFIG_NRF_MODEM_LIB_TRACE_COMPRESSION_READ_DECOMPRESS */
+
 int nrf_modem_lib_trace_read(uint8_t *buf, size_t len)
 {
 	int read;
@@ -470,7 +769,11 @@ int nrf_modem_lib_trace_read(uint8_t *buf, size_t len)
 		return -ENOTSUP;
 	}
 
+#if CONFIG_NRF_MODEM_LIB_TRACE_COMPRESSION_READ_DECOMPRESS
+	read = trace_read_decompress(buf, len);
+#else
 	read = trace_backend.read(buf, len);
+#endif
 	if (read > 0) {
 		UPDATE_TRACE_BYTES_READ(read);
 	}
@@ -491,6 +794,10 @@ int nrf_modem_lib_trace_clear(void)
 		return err;
 	}
 
+#if CONFIG_NRF_MODEM_LIB_TRACE_COMPRESSION_READ_DECOMPRESS
+	decompress_reset();
+#endif
+
 	if (!has_space) {
 		k_sem_take(&trace_done_sem, K_FOREVER);
 		has_space = true;
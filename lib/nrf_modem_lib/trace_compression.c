@@ -0,0 +1,237 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/sys/util.h>
+
+#include "trace_compression.h"
+
+#define HASH_BITS 10
+#define HASH_SIZE BIT(HASH_BITS)
+
+/* Most recent position (plus one) of each hashed three byte sequence in the current block.
+ * Zero marks an empty slot. Only used by the trace thread.
+ */
+static uint16_t hash_table[HASH_SIZE];
+
+static inline uint32_t hash3(const uint8_t *p)
+{
+	uint32_t v = p[0] | (p[1] << 8) | (p[2] << 16);
+
+	return (v * 2654435761u) >> (32 - HASH_BITS);
+}
+
+static inline void hash_insert(const uint8_t *in, size_t pos)
+{
+	hash_table[hash3(&in[pos])] = pos + 1;
+}
+
+static size_t match_find(const uint8_t *in, size_t in_len, size_t pos, size_t *dist)
+{
+	uint32_t h = hash3(&in[pos]);
+	size_t candidate = hash_table[h];
+	size_t max_len;
+	size_t len = 0;
+
+	hash_table[h] = pos + 1;
+
+	if (candidate == 0) {
+		return 0;
+	}
+
+	candidate--;
+
+	max_len = MIN(TRACE_COMPRESSION_MAX_MATCH, in_len - pos);
+
+	while (len < max_len && in[candidate + len] == in[pos + len]) {
+		len++;
+	}
+
+	if (len < TRACE_COMPRESSION_MIN_MATCH) {
+		return 0;
+	}
+
+	*dist = pos - candidate;
+
+	return len;
+}
+
+static size_t frame_header_write(uint8_t *frame, uint8_t flags, size_t raw_len,
+				 size_t payload_len)
+{
+	frame[0] = TRACE_COMPRESSION_FRAME_MAGIC;
+	frame[1] = flags;
+	sys_put_le16(raw_len, &frame[2]);
+	sys_put_le16(payload_len, &frame[4]);
+
+	return TRACE_COMPRESSION_FRAME_HDR_SIZE + payload_len;
+}
+
+static size_t frame_stored_encode(const uint8_t *in, size_t in_len, uint8_t *frame)
+{
+	memcpy(&frame[TRACE_COMPRESSION_FRAME_HDR_SIZE], in, in_len);
+
+	return frame_header_write(frame, TRACE_COMPRESSION_FRAME_FLAG_STORED, in_len, in_len);
+}
+
+size_t trace_compression_frame_encode(const uint8_t *in, size_t in_len, uint8_t *frame)
+{
+	/* Compressed payload must be smaller than the raw data, otherwise the block is stored. */
+	uint8_t *out = &frame[TRACE_COMPRESSION_FRAME_HDR_SIZE];
+	const uint8_t *out_end = out + in_len;
+	uint8_t *flags = NULL;
+	size_t items = 0;
+	size_t pos = 0;
+
+	memset(hash_table, 0, sizeof(hash_table));
+
+	while (pos < in_len) {
+		size_t dist = 0;
+		size_t len = 0;
+
+		if ((items % 8) == 0) {
+			if (out >= out_end) {
+				return frame_stored_encode(in, in_len, frame);
+			}
+			flags = out++;
+			*flags = 0;
+		}
+
+		if (pos + TRACE_COMPRESSION_MIN_MATCH <= in_len) {
+			len = match_find(in, in_len, pos, &dist);
+		}
+
+		if (len) {
+			if (out + 2 > out_end) {
+				return frame_stored_encode(in, in_len, frame);
+			}
+
+			*flags |= BIT(items % 8);
+			*out++ = (dist - 1) & 0xFF;
+			*out++ = (((dist - 1) >> 8) << 4) | (len - TRACE_COMPRESSION_MIN_MATCH);
+
+			/* Index the positions covered by the match to find later repetitions. */
+			for (size_t i = pos + 1;
+			     i < pos + len && i + TRACE_COMPRESSION_MIN_MATCH <= in_len; i++) {
+				hash_insert(in, i);
+			}
+
+			pos += len;
+		} else {
+			if (out >= out_end) {
+				return frame_stored_encode(in, in_len, frame);
+			}
+
+			*out++ = in[pos++];
+		}
+
+		items++;
+	}
+
+	return frame_header_write(frame, 0, in_len,
+				  out - &frame[TRACE_COMPRESSION_FRAME_HDR_SIZE]);
+}
+
+int trace_compression_frame_len(const uint8_t *hdr)
+{
+	uint16_t raw_len = sys_get_le16(&hdr[2]);
+	uint16_t payload_len = sys_get_le16(&hdr[4]);
+
+	if (hdr[0] != TRACE_COMPRESSION_FRAME_MAGIC ||
+	    (hdr[1] & ~TRACE_COMPRESSION_FRAME_FLAG_STORED) ||
+	    raw_len > TRACE_COMPRESSION_BLOCK_SIZE_MAX ||
+	    payload_len > raw_len) {
+		return -EBADMSG;
+	}
+
+	return TRACE_COMPRESSION_FRAME_HDR_SIZE + payload_len;
+}
+
+int trace_compression_frame_decode(const uint8_t *frame, size_t frame_len, uint8_t *out,
+				   size_t out_size)
+{
+	const uint8_t *in;
+	const uint8_t *in_end;
+	size_t raw_len;
+	size_t pos = 0;
+	uint8_t flags = 0;
+	size_t items = 0;
+	int len;
+
+	if (frame_len < TRACE_COMPRESSION_FRAME_HDR_SIZE) {
+		return -EBADMSG;
+	}
+
+	len = trace_compression_frame_len(frame);
+	if (len < 0 || len != frame_len) {
+		return -EBADMSG;
+	}
+
+	raw_len = sys_get_le16(&frame[2]);
+	if (raw_len > out_size) {
+		return -ENOMEM;
+	}
+
+	in = &frame[TRACE_COMPRESSION_FRAME_HDR_SIZE];
+	in_end = frame + frame_len;
+
+	if (frame[1] & TRACE_COMPRESSION_FRAME_FLAG_STORED) {
+		if (in_end - in != raw_len) {
+			return -EBADMSG;
+		}
+
+		memcpy(out, in, raw_len);
+
+		return raw_len;
+	}
+
+	while (pos < raw_len) {
+		if ((items % 8) == 0) {
+			if (in >= in_end) {
+				return -EBADMSG;
+			}
+			flags = *in++;
+		}
+
+		if (flags & BIT(items % 8)) {
+			size_t dist;
+			size_t match_len;
+
+			if (in + 2 > in_end) {
+				return -EBADMSG;
+			}
+
+			dist = (in[0] | ((in[1] >> 4) << 8)) + 1;
+			match_len = (in[1] & 0x0F) + TRACE_COMPRESSION_MIN_MATCH;
+			in += 2;
+
+			if (dist > pos || pos + match_len > raw_len) {
+				return -EBADMSG;
+			}
+
+			/* Byte by byte, the match may overlap the data it produces. */
+			for (size_t i = 0; i < match_len; i++, pos++) {
+				out[pos] = out[pos - dist];
+			}
+		} else {
+			if (in >= in_end) {
+				return -EBADMSG;
+			}
+
+			out[pos++] = *in++;
+		}
+
+		items++;
+	}
+
+	if (in != in_end) {
+		return -EBADMSG;
+	}
+
+	return raw_len;
+}
@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef TRACE_COMPRESSION_H__
+#define TRACE_COMPRESSION_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Compressed trace frame format, all multi-byte fields are little endian:
+ *
+ *   offset  size  field
+ *   0       1     magic (TRACE_COMPRESSION_FRAME_MAGIC)
+ *   1       1     flags (TRACE_COMPRESSION_FRAME_FLAG_*)
+ *   2       2     length of the raw trace data in the frame
+ *   4       2     length of the payload following the header
+ *   6       n     payload
+ *
+ * The payload is either the raw trace data (stored frame) or an LZSS stream.
+ * The LZSS stream is a sequence of groups of up to eight items, each group
+ * preceded by a flag byte. Bit n of the flag byte, starting from the least
+ * significant bit, tells whether item n is a literal byte (0) or a two byte
+ * back-reference (1). A back-reference encodes the distance minus one in the
+ * low byte and upper nibble of the high byte, and the match length minus
+ * TRACE_COMPRESSION_MIN_MATCH in the lower nibble of the high byte.
+ *
+ * Back-references never cross frame boundaries, so each frame can be
+ * decompressed on its own.
+ */
+
+#define TRACE_COMPRESSION_FRAME_MAGIC 0xC7
+#define TRACE_COMPRESSION_FRAME_FLAG_STORED 0x01
+#define TRACE_COMPRESSION_FRAME_HDR_SIZE 6
+
+#define TRACE_COMPRESSION_MIN_MATCH 3
+#define TRACE_COMPRESSION_MAX_MATCH (TRACE_COMPRESSION_MIN_MATCH + 15)
+#define TRACE_COMPRESSION_WINDOW_SIZE 4096
+
+/** Maximum size of the raw data in one frame. */
+#define TRACE_COMPRESSION_BLOCK_SIZE_MAX TRACE_COMPRESSION_WINDOW_SIZE
+
+/** Size of a frame buffer able to hold a block of @p block_size bytes. */
+#define TRACE_COMPRESSION_FRAME_SIZE(block_size) \
+	(TRACE_COMPRESSION_FRAME_HDR_SIZE + (block_size))
+
+/**
+ * @brief Compress a block of trace data into a frame.
+ *
+ * Falls back to a stored frame if the data does not compress.
+ *
+ * @param in Raw trace data.
+ * @param in_len Length of the raw trace data, at most TRACE_COMPRESSION_BLOCK_SIZE_MAX.
+ * @param frame Output frame buffer, at least TRACE_COMPRESSION_FRAME_SIZE(in_len) bytes.
+ *
+ * @return Length of the frame.
+ */
+size_t trace_compression_frame_encode(const uint8_t *in, size_t in_len, uint8_t *frame);
+
+/**
+ * @brief Get the total length of a frame from its header.
+ *
+ * @param hdr Frame header, TRACE_COMPRESSION_FRAME_HDR_SIZE bytes.
+ *
+ * @return Length of the frame, including the header, or -EBADMSG if the header is invalid.
+ */
+int trace_compression_frame_len(const uint8_t *hdr);
+
+/**
+ * @brief Decompress a frame.
+ *
+ * @param frame Complete frame.
+ * @param frame_len Length of the frame.
+ * @param out Output buffer.
+ * @param out_size Size of the output buffer.
+ *
+ * @return Length of the raw trace data on success.
+ * @retval -EBADMSG If the frame is malformed.
+ * @retval -ENOMEM If the output buffer is too small.
+ */
+int trace_compression_frame_decode(const uint8_t *frame, size_t frame_len, uint8_t *out,
+				   size_t out_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TRACE_COMPRESSION_H__ */
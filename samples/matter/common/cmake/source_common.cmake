@@ -41,6 +41,10 @@ if(CONFIG_CHIP_NUS)
     target_sources(app PRIVATE ${MATTER_COMMONS_SRC_DIR}/bt_nus/bt_nus_service.cpp)
 endif()
 
+if(CONFIG_NCS_SAMPLE_MATTER_APP_TASK_SHELL)
+    target_sources(app PRIVATE ${MATTER_COMMONS_SRC_DIR}/app/task_executor_shell.cpp)
+endif()
+
 if(CONFIG_NCS_SAMPLE_MATTER_SETTINGS_SHELL)
     target_sources(app PRIVATE ${MATTER_COMMONS_SRC_DIR}/persistent_storage/persistent_storage_shell.cpp)
 endif()
@@ -55,6 +59,8 @@ endif()
 if(CONFIG_NCS_SAMPLE_MATTER_PERSISTENT_STORAGE)
     target_sources_ifdef(CONFIG_NCS_SAMPLE_MATTER_SETTINGS_STORAGE_BACKEND app PRIVATE
             ${MATTER_COMMONS_SRC_DIR}/persistent_storage/backends/persistent_storage_settings.cpp)
+    target_sources_ifdef(CONFIG_NCS_SAMPLE_MATTER_SETTINGS_STORAGE_CACHE app PRIVATE
+            ${MATTER_COMMONS_SRC_DIR}/persistent_storage/backends/persistent_storage_settings_cache.cpp)
     target_sources_ifdef(CONFIG_NCS_SAMPLE_MATTER_SECURE_STORAGE_BACKEND app PRIVATE
             ${MATTER_COMMONS_SRC_DIR}/persistent_storage/backends/persistent_storage_secure.cpp)
 endif()
@@ -11,24 +11,147 @@
 
 LOG_MODULE_DECLARE(app, CONFIG_CHIP_APP_LOG_LEVEL);
 
-constexpr size_t kTaskQueueSize = CONFIG_NCS_SAMPLE_MATTER_APP_TASK_QUEUE_SIZE;
+constexpr size_t kHighQueueSize = CONFIG_NCS_SAMPLE_MATTER_APP_TASK_QUEUE_HIGH_SIZE;
+constexpr size_t kNormalQueueSize = CONFIG_NCS_SAMPLE_MATTER_APP_TASK_QUEUE_SIZE;
+constexpr size_t kLowQueueSize = CONFIG_NCS_SAMPLE_MATTER_APP_TASK_QUEUE_LOW_SIZE;
 
-K_MSGQ_DEFINE(sTaskQueue, sizeof(Nrf::Task), kTaskQueueSize, alignof(Nrf::Task));
+/* Number of queued tasks of all priorities. */
+K_SEM_DEFINE(sTaskCount, 0, kHighQueueSize + kNormalQueueSize + kLowQueueSize);
+
+namespace
+{
+struct QueuedTask {
+	Nrf::Task task;
+	Nrf::TaskCoalescingKey coalescingKey;
+};
+
+/* Ring buffer of the tasks of a single priority. */
+struct TaskQueue {
+	QueuedTask *tasks;
+	size_t size;
+	size_t head;
+	size_t count;
+	Nrf::TaskQueueStats stats;
+};
+
+QueuedTask sHighTasks[kHighQueueSize];
+QueuedTask sNormalTasks[kNormalQueueSize];
+QueuedTask sLowTasks[kLowQueueSize];
+
+/* Indexed by Nrf::TaskPriority, from the highest priority. */
+TaskQueue sTaskQueues[Nrf::kTaskPriorityCount] = {
+	{ sHighTasks, kHighQueueSize },
+	{ sNormalTasks, kNormalQueueSize },
+	{ sLowTasks, kLowQueueSize },
+};
+
+/* Tasks are posted from interrupts as well, for example from timer and button handlers. */
+k_spinlock sTaskLock;
+
+QueuedTask *FindQueuedTask(TaskQueue &queue, Nrf::TaskCoalescingKey coalescingKey)
+{
+	for (size_t i = 0; i < queue.count; i++) {
+		QueuedTask &queued = queue.tasks[(queue.head + i) % queue.size];
+
+		if (queued.coalescingKey == coalescingKey) {
+			return &queued;
+		}
+	}
+
+	return nullptr;
+}
+} /* namespace */
 
 namespace Nrf
 {
 	void PostTask(const Task &task)
 	{
-		if (k_msgq_put(&sTaskQueue, &task, K_NO_WAIT) != 0) {
+		PostTask(task, TaskPriority::Normal);
+	}
+
+	bool PostTask(const Task &task, TaskPriority priority, TaskCoalescingKey coalescingKey)
+	{
+		TaskQueue &queue = sTaskQueues[static_cast<size_t>(priority)];
+		bool queued = true;
+		bool coalesced = false;
+		k_spinlock_key_t key = k_spin_lock(&sTaskLock);
+
+		queue.stats.posted++;
+
+		QueuedTask *target = coalescingKey != kNoCoalescing ? FindQueuedTask(queue, coalescingKey) : nullptr;
+
+		if (target) {
+			coalesced = true;
+			queue.stats.coalesced++;
+		} else if (queue.count < queue.size) {
+			target = &queue.tasks[(queue.head + queue.count) % queue.size];
+			target->coalescingKey = coalescingKey;
+			queue.count++;
+
+			if (queue.count > queue.stats.highWaterMark) {
+				queue.stats.highWaterMark = queue.count;
+			}
+		} else {
+			queued = false;
+			queue.stats.dropped++;
+		}
+
+		if (target) {
+			target->task = task;
+		}
+
+		k_spin_unlock(&sTaskLock, key);
+
+		if (!queued) {
 			LOG_ERR("Failed to post event to app task event queue");
+		} else if (!coalesced) {
+			k_sem_give(&sTaskCount);
 		}
+
+		return queued;
 	}
 
 	void DispatchNextTask()
 	{
 		Task task;
-		k_msgq_get(&sTaskQueue, &task, K_FOREVER);
+
+		k_sem_take(&sTaskCount, K_FOREVER);
+
+		k_spinlock_key_t key = k_spin_lock(&sTaskLock);
+
+		for (TaskQueue &queue : sTaskQueues) {
+			if (queue.count > 0) {
+				task = queue.tasks[queue.head].task;
+				queue.head = (queue.head + 1) % queue.size;
+				queue.count--;
+				break;
+			}
+		}
+
+		k_spin_unlock(&sTaskLock, key);
+
 		task();
 	}
 
+	TaskQueueStats GetTaskQueueStats(TaskPriority priority)
+	{
+		k_spinlock_key_t key = k_spin_lock(&sTaskLock);
+		TaskQueueStats stats = sTaskQueues[static_cast<size_t>(priority)].stats;
+		k_spin_unlock(&sTaskLock, key);
+
+		return stats;
+	}
+
+	void ResetTaskQueueStats()
+	{
+		k_spinlock_key_t key = k_spin_lock(&sTaskLock);
+
+		for (TaskQueue &queue : sTaskQueues) {
+			queue.stats = {};
+			queue.stats.highWaterMark = queue.count;
+		}
+
+		k_spin_unlock(&sTaskLock, key);
+	}
+
 } /* namespace Nrf */
@@ -6,6 +6,9 @@
 
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <new>
 #include <type_traits>
 
 namespace Nrf
@@ -50,6 +53,48 @@ namespace Nrf
 		Handler mHandler;
 	};
 
+	/**
+	 * @brief Priority of a task.
+	 *
+	 * Each priority has a separate queue. A task is dispatched only when there are
+	 * no queued tasks of a higher priority, and tasks of the same priority are
+	 * dispatched in the order in which they were posted.
+	 */
+	enum class TaskPriority : uint8_t {
+		/* Tasks that must be handled without delay, like button presses or identification. */
+		High,
+		/* Default priority. */
+		Normal,
+		/* Bulk work, like periodic measurements and attribute reporting. */
+		Low,
+	};
+
+	constexpr size_t kTaskPriorityCount = 3;
+
+	/**
+	 * @brief Key identifying the tasks that can replace each other in the queue.
+	 *
+	 * Any unique non-zero value can be used, for example the address of the function
+	 * that the task calls.
+	 */
+	using TaskCoalescingKey = uintptr_t;
+
+	constexpr TaskCoalescingKey kNoCoalescing = 0;
+
+	/**
+	 * @brief Statistics of the queue of a single task priority.
+	 */
+	struct TaskQueueStats {
+		/* Number of tasks posted, including the coalesced and dropped ones. */
+		uint32_t posted;
+		/* Number of tasks that replaced a queued task with the same coalescing key. */
+		uint32_t coalesced;
+		/* Number of tasks dropped because the queue was full. */
+		uint32_t dropped;
+		/* Peak number of queued tasks. */
+		uint16_t highWaterMark;
+	};
+
 	/**
 	 * @brief Post a task to the task queue.
 	 *
@@ -64,10 +109,30 @@ namespace Nrf
 	 * uint32_t myNumber;
 	 * PostTask([myNumber]{ MyMethod(myNumber) };)
 	 *
+	 * The task is posted with the normal priority.
+	 *
 	 * @param task the Task to be posted to the application thread's task queue
 	 */
 	void PostTask(const Task &task);
 
+	/**
+	 * @brief Post a task with the given priority to the task queue.
+	 *
+	 * If the coalescing key is given and a task with the same key is already queued
+	 * with the same priority, the queued task is replaced and keeps its position in
+	 * the queue. This allows tasks like updating an attribute with the latest value
+	 * to be posted repeatedly without filling the queue.
+	 *
+	 * The task is dropped if the queue of the priority is full.
+	 *
+	 * @param task the Task to be posted to the application thread's task queue
+	 * @param priority the priority of the task
+	 * @param coalescingKey the key of the tasks that can replace each other, or kNoCoalescing
+	 * @return true if the task has been queued or has replaced a queued task
+	 * @return false if the task has been dropped
+	 */
+	bool PostTask(const Task &task, TaskPriority priority, TaskCoalescingKey coalescingKey = kNoCoalescing);
+
 	/**
 	 * @brief Dispatch the next available task.
 	 *
@@ -77,4 +142,17 @@ namespace Nrf
 	 *
 	 */
 	void DispatchNextTask();
+
+	/**
+	 * @brief Get the statistics of the queue of the given task priority.
+	 *
+	 * @param priority the priority of the queue
+	 * @return the statistics since the boot or the last reset
+	 */
+	TaskQueueStats GetTaskQueueStats(TaskPriority priority);
+
+	/**
+	 * @brief Reset the statistics of the queues of all task priorities.
+	 */
+	void ResetTaskQueueStats();
 } /* namespace Nrf */
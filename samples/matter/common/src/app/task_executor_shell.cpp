@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include "task_executor.h"
+
+#include <zephyr/shell/shell.h>
+
+using namespace Nrf;
+
+namespace
+{
+constexpr const char *kPriorityNames[kTaskPriorityCount] = { "high", "normal", "low" };
+
+int StatsHandler(const struct shell *shell, size_t argc, char **argv)
+{
+	shell_fprintf(shell, SHELL_NORMAL, "%-8s %10s %10s %10s %6s\n", "priority", "posted", "coalesced", "dropped",
+		      "peak");
+
+	for (size_t i = 0; i < kTaskPriorityCount; i++) {
+		TaskQueueStats stats = GetTaskQueueStats(static_cast<TaskPriority>(i));
+
+		shell_fprintf(shell, SHELL_NORMAL, "%-8s %10u %10u %10u %6u\n", kPriorityNames[i], stats.posted,
+			      stats.coalesced, stats.dropped, stats.highWaterMark);
+	}
+
+	return 0;
+}
+
+int ResetHandler(const struct shell *shell, size_t argc, char **argv)
+{
+	ResetTaskQueueStats();
+
+	return 0;
+}
+
+} // namespace
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_tasks,
+			       SHELL_CMD_ARG(stats, NULL,
+					     "Print the number of posted, coalesced and dropped tasks, and the peak number "
+					     "of queued tasks for each priority. \n"
+					     "Usage: matter_tasks stats\n",
+					     StatsHandler, 1, 0),
+			       SHELL_CMD_ARG(reset, NULL,
+					     "Reset the task queue statistics. \n"
+					     "Usage: matter_tasks reset\n",
+					     ResetHandler, 1, 0),
+			       SHELL_SUBCMD_SET_END);
+
+SHELL_CMD_REGISTER(matter_tasks, &sub_tasks, "Matter application task queue", NULL);
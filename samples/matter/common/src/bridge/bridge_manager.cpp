@@ -12,6 +12,7 @@
 #include <app-common/zap-generated/ids/Clusters.h>
 #include <app/reporting/reporting.h>
 #include <app/util/generic-callbacks.h>
+#include <lib/support/CHIPMem.h>
 #include <lib/support/Span.h>
 
 #include <zephyr/logging/log.h>
@@ -67,7 +68,7 @@ CHIP_ERROR BridgeManager::AddBridgedDevices(MatterBridgedDevice *devices[], Brid
 {
 	chip::Optional<uint8_t> indexes[deviceListSize];
 	uint16_t endpoints[deviceListSize];
-	Platform::UniquePtr<BridgedDeviceDataProvider> providerPtr(dataProvider);
+	DeviceUniquePtr<BridgedDeviceDataProvider> providerPtr(dataProvider);
 
 	VerifyOrReturnError(devicesPairIndexes, CHIP_ERROR_INTERNAL);
 	CHIP_ERROR err =
@@ -81,7 +82,7 @@ CHIP_ERROR BridgeManager::AddBridgedDevices(MatterBridgedDevice *devices[], Brid
 					    uint8_t deviceListSize, uint8_t devicesPairIndexes[],
 					    uint16_t endpointIds[])
 {
-	Platform::UniquePtr<BridgedDeviceDataProvider> providerPtr(dataProvider);
+	DeviceUniquePtr<BridgedDeviceDataProvider> providerPtr(dataProvider);
 	chip::Optional<uint8_t> indexes[deviceListSize];
 
 	VerifyOrReturnError(devicesPairIndexes, CHIP_ERROR_INTERNAL);
@@ -344,12 +345,12 @@ exit:
 	/* This method takes care of the resources, so objects have to be deleted in case of failures. */
 	if (err != CHIP_NO_ERROR) {
 		if (dataProvider) {
-			chip::Platform::Delete(dataProvider);
+			DeleteDevice(dataProvider);
 		}
 
 		if (devices) {
 			for (auto i = 0; i < deviceListSize; ++i) {
-				chip::Platform::Delete(devices[i]);
+				DeleteDevice(devices[i]);
 			}
 		}
 	}
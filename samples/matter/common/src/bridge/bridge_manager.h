@@ -135,8 +135,8 @@ private:
 
 		~BridgedDevicePair()
 		{
-			chip::Platform::Delete(mDevice);
-			chip::Platform::Delete(mProvider);
+			DeleteDevice(mDevice);
+			DeleteDevice(mProvider);
 			mDevice = nullptr;
 			mProvider = nullptr;
 		}
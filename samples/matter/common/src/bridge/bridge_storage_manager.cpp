@@ -111,6 +111,11 @@ bool BridgeStorageManager::MigrateData()
 		version = 1;
 		Nrf::GetPersistentStorage().NonSecureStore(&mVersion, &version, sizeof(version));
 
+		/* Persist the migrated data at once, as the storage may buffer the writes. */
+		if (Nrf::GetPersistentStorage().NonSecureCommit() == Nrf::PSErrorCode::Failure) {
+			return false;
+		}
+
 	} else if (version != 1) {
 		/* Currently only no-version or version equal to 1 is supported. */
 		return false;
@@ -86,6 +86,8 @@ public:
 	static constexpr uint8_t kDefaultDynamicEndpointVersion = 2;
 	static constexpr uint8_t kNodeLabelSize = 32;
 	static constexpr uint8_t kDescriptorAttributeArraySize = 254;
+	/* Maximum number of clusters of a bridged device, each cluster has its own data version. */
+	static constexpr uint8_t kMaxDataVersionSize = 8;
 
 	explicit MatterBridgedDevice(const char *nodeLabel)
 		: mIdentifyServer(mEndpointId, IdentifyStartDefaultCb, IdentifyStopDefaultCb,
@@ -95,7 +97,7 @@ public:
 			memcpy(mNodeLabel, nodeLabel, strlen(nodeLabel));
 		}
 	}
-	virtual ~MatterBridgedDevice() { chip::Platform::MemoryFree(mDataVersion); }
+	virtual ~MatterBridgedDevice() = default;
 
 	void Init(chip::EndpointId endpoint)
 	{
@@ -134,7 +136,7 @@ public:
 	EmberAfEndpointType *mEp;
 	const EmberAfDeviceType *mDeviceTypeList;
 	size_t mDeviceTypeListSize;
-	chip::DataVersion *mDataVersion;
+	chip::DataVersion mDataVersion[kMaxDataVersionSize];
 	size_t mDataVersionSize;
 
 protected:
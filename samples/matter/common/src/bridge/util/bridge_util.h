@@ -6,34 +6,174 @@
 
 #pragma once
 
-#include <lib/support/CHIPMem.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/__assert.h>
+#include <zephyr/sys/util.h>
 
+#include <cstddef>
 #include <cstdint>
-#include <functional>
-#include <map>
+#include <initializer_list>
+#include <memory>
+#include <new>
+#include <utility>
 
 namespace Nrf
 {
 
+namespace Internal
+{
+	/* A device and a data provider pool in each bridged device factory. */
+	constexpr size_t kMaxDevicePools = 4;
+
+	struct DevicePoolRegion {
+		uint8_t *mStart;
+		uint8_t *mEnd;
+		size_t mBlockSize;
+		k_mem_slab *mSlab;
+	};
+
+	inline DevicePoolRegion sDevicePools[kMaxDevicePools];
+	inline size_t sDevicePoolCount;
+
+	inline void RegisterDevicePool(uint8_t *buffer, size_t blockSize, size_t blockCount, k_mem_slab *slab)
+	{
+		/* The objects of a pool that is not registered could never be deleted. */
+		if (sDevicePoolCount >= kMaxDevicePools) {
+			__ASSERT(false, "Too many device pools");
+			k_panic();
+		}
+
+		sDevicePools[sDevicePoolCount++] = { buffer, buffer + blockSize * blockCount, blockSize, slab };
+	}
+
+	/* Returns the pool region containing the object, which does not have to start at the beginning of its block
+	 * if it is a base class subobject. */
+	inline DevicePoolRegion *FindDevicePool(const void *object)
+	{
+		const uint8_t *address = static_cast<const uint8_t *>(object);
+
+		for (size_t i = 0; i < sDevicePoolCount; i++) {
+			if (address >= sDevicePools[i].mStart && address < sDevicePools[i].mEnd) {
+				return &sDevicePools[i];
+			}
+		}
+
+		return nullptr;
+	}
+} /* namespace Internal */
+
 /*
-   DeviceFactory template container allows to instantiate a map which
+   DevicePool template provides N statically allocated blocks of BlockSize
+   bytes, shared by all concrete device or data provider types that fit in a
+   block. A factory uses one pool for all its device types, sized by the total
+   number of bridged devices rather than by the number of devices of each
+   type. The objects are constructed in place in the blocks of a k_mem_slab,
+   so creating and removing bridged devices does not use the heap. An object
+   created with New() must be destroyed with DeleteDevice(), also through a
+   pointer to its base class.
+*/
+template <size_t BlockSize, size_t N> class DevicePool {
+public:
+	DevicePool()
+	{
+		k_mem_slab_init(&mSlab, mBuffer, kBlockSize, N);
+		Internal::RegisterDevicePool(mBuffer, kBlockSize, N, &mSlab);
+	}
+
+	DevicePool(const DevicePool &) = delete;
+	DevicePool(DevicePool &&) = delete;
+	DevicePool &operator=(const DevicePool &) = delete;
+	DevicePool &operator=(DevicePool &&) = delete;
+
+	template <typename T, typename... Args> T *New(Args &&...args)
+	{
+		static_assert(sizeof(T) <= kBlockSize, "Object does not fit in a device pool block");
+		static_assert(alignof(T) <= kAlignment, "Object alignment exceeds the device pool alignment");
+
+		void *block;
+
+		if (k_mem_slab_alloc(&mSlab, &block, K_NO_WAIT) != 0) {
+			return nullptr;
+		}
+
+		return new (block) T(std::forward<Args>(args)...);
+	}
+
+private:
+	static constexpr size_t kAlignment = alignof(std::max_align_t);
+	static constexpr size_t kBlockSize = ROUND_UP(BlockSize, kAlignment);
+
+	alignas(kAlignment) uint8_t mBuffer[kBlockSize * N];
+	k_mem_slab mSlab;
+};
+
+/*
+   Destroys an object created by DevicePool::New() and returns its block to
+   the owning pool.
+*/
+template <typename T> void DeleteDevice(T *object)
+{
+	if (!object) {
+		return;
+	}
+
+	Internal::DevicePoolRegion *pool = Internal::FindDevicePool(object);
+
+	__ASSERT(pool, "Object not allocated from a device pool");
+
+	object->~T();
+
+	if (pool) {
+		uint8_t *address = reinterpret_cast<uint8_t *>(object);
+		size_t offset = address - pool->mStart;
+
+		k_mem_slab_free(pool->mSlab, pool->mStart + offset - offset % pool->mBlockSize);
+	}
+}
+
+template <typename T> struct DeviceDeleter {
+	void operator()(T *object) const { DeleteDevice(object); }
+};
+
+template <typename T> using DeviceUniquePtr = std::unique_ptr<T, DeviceDeleter<T>>;
+
+/*
+   DeviceFactory template container allows to instantiate a table which
    binds supported Matter device type identifiers (uint16_t) with corresponding
-   creation method (e.g. constructor invocation). DeviceFactory can
+   creation function (e.g. allocation from a DevicePool). DeviceFactory can
    only be constructed by passing a user-defined initialized list with
-   <uint16_t, ConcreteDeviceCreator> pairs.
+   { DeviceType, ConcreteDeviceCreator } pairs.
    Then, Create() method can be used to obtain an instance of demanded
    device type with all passed arguments forwarded to the underlying
    ConcreteDeviceCreator.
+
+   The creators are kept in a fixed array indexed by the device type modulo
+   the array size, so the factory can be constant-initialized and the lookup
+   takes a single probe as long as the device types registered in the factory
+   do not collide.
 */
 template <typename T, typename DeviceType, typename... Args> class DeviceFactory {
 public:
-	using ConcreteDeviceCreator = std::function<T *(Args...)>;
-	using CreationMap = std::map<DeviceType, ConcreteDeviceCreator>;
+	using ConcreteDeviceCreator = T *(*)(Args...);
 
-	DeviceFactory(std::initializer_list<std::pair<DeviceType, ConcreteDeviceCreator>> init)
+	struct Creator {
+		DeviceType mDeviceType;
+		ConcreteDeviceCreator mCreate;
+	};
+
+	constexpr DeviceFactory(std::initializer_list<Creator> init)
 	{
-		for (auto &pair : init) {
-			mCreationMap.insert(pair);
+		__ASSERT(init.size() <= kMaxCreators, "Too many device types in the factory");
+
+		for (size_t i = 0; i < init.size() && i < kMaxCreators; i++) {
+			const Creator &creator = init.begin()[i];
+			size_t index = Index(creator.mDeviceType);
+
+			while (mCreators[index].mCreate) {
+				index = (index + 1) % kMaxCreators;
+			}
+
+			mCreators[index] = creator;
 		}
 	}
 
@@ -44,16 +184,27 @@ public:
 	DeviceFactory &operator=(DeviceFactory &&) = delete;
 	~DeviceFactory() = default;
 
-	T *Create(DeviceType deviceType, Args... params)
+	T *Create(DeviceType deviceType, Args... params) const
 	{
-		if (mCreationMap.find(deviceType) == mCreationMap.end()) {
-			return nullptr;
+		size_t index = Index(deviceType);
+
+		for (size_t i = 0; i < kMaxCreators && mCreators[index].mCreate; i++) {
+			if (mCreators[index].mDeviceType == deviceType) {
+				return mCreators[index].mCreate(std::forward<Args>(params)...);
+			}
+
+			index = (index + 1) % kMaxCreators;
 		}
-		return mCreationMap[deviceType](std::forward<Args>(params)...);
+
+		return nullptr;
 	}
 
 private:
-	CreationMap mCreationMap;
+	static constexpr size_t kMaxCreators = 16;
+
+	static constexpr size_t Index(DeviceType deviceType) { return static_cast<size_t>(deviceType) % kMaxCreators; }
+
+	Creator mCreators[kMaxCreators] = {};
 };
 
 } /* namespace Nrf */
@@ -25,6 +25,13 @@ struct ReadEntry {
 constexpr uint8_t kEmptyValue[] = { 0x22, 0xa6, 0x54, 0xd1, 0x39 };
 constexpr size_t kEmptyValueSize = sizeof(kEmptyValue);
 
+#ifdef CONFIG_NCS_SAMPLE_MATTER_SETTINGS_STORAGE_CACHE
+bool IsEmptyValue(const void *data, size_t dataSize)
+{
+	return dataSize == kEmptyValueSize && memcmp(data, kEmptyValue, kEmptyValueSize) == 0;
+}
+#endif
+
 int LoadEntryCallback(const char *name, size_t entrySize, settings_read_cb readCb, void *cbArg, void *param)
 {
 	ReadEntry &entry = *static_cast<ReadEntry *>(param);
@@ -67,7 +74,15 @@ namespace Nrf
 {
 PSErrorCode PersistentStorageSettings::_NonSecureInit()
 {
-	return settings_load() ? PSErrorCode::Failure : PSErrorCode::Success;
+	if (settings_load()) {
+		return PSErrorCode::Failure;
+	}
+
+#ifdef CONFIG_NCS_SAMPLE_MATTER_SETTINGS_STORAGE_CACHE
+	return mCache.Init();
+#else
+	return PSErrorCode::Success;
+#endif
 }
 
 PSErrorCode PersistentStorageSettings::_NonSecureStore(PersistentStorageNode *node, const void *data, size_t dataSize)
@@ -82,7 +97,11 @@ PSErrorCode PersistentStorageSettings::_NonSecureStore(PersistentStorageNode *no
 		return PSErrorCode::Failure;
 	}
 
+#ifdef CONFIG_NCS_SAMPLE_MATTER_SETTINGS_STORAGE_CACHE
+	return mCache.Store(key, data, dataSize);
+#else
 	return (settings_save_one(key, data, dataSize) ? PSErrorCode::Failure : PSErrorCode::Success);
+#endif
 }
 
 PSErrorCode PersistentStorageSettings::_NonSecureLoad(PersistentStorageNode *node, void *data, size_t dataMaxSize,
@@ -136,6 +155,17 @@ PSErrorCode PersistentStorageSettings::_NonSecureRemove(PersistentStorageNode *n
 		return PSErrorCode::Failure;
 	}
 
+#ifdef CONFIG_NCS_SAMPLE_MATTER_SETTINGS_STORAGE_CACHE
+	switch (mCache.Remove(key)) {
+	case PersistentStorageSettingsCache::Result::Success:
+		return PSErrorCode::Success;
+	case PersistentStorageSettingsCache::Result::Failure:
+		return PSErrorCode::Failure;
+	default:
+		break;
+	}
+#endif
+
 	if (!LoadEntry(key)) {
 		return PSErrorCode::Failure;
 	}
@@ -145,8 +175,38 @@ PSErrorCode PersistentStorageSettings::_NonSecureRemove(PersistentStorageNode *n
 	return PSErrorCode::Success;
 }
 
+PSErrorCode PersistentStorageSettings::_NonSecureCommit()
+{
+#ifdef CONFIG_NCS_SAMPLE_MATTER_SETTINGS_STORAGE_CACHE
+	return mCache.Commit();
+#else
+	return PSErrorCode::Success;
+#endif
+}
+
 bool PersistentStorageSettings::LoadEntry(const char *key, void *data, size_t dataMaxSize, size_t *outSize)
 {
+#ifdef CONFIG_NCS_SAMPLE_MATTER_SETTINGS_STORAGE_CACHE
+	/* Serve the request from RAM if the cache knows the answer: the key is absent or its value is buffered. */
+	const bool readValue = data && dataMaxSize != 0;
+	size_t cachedSize = 0;
+	const PersistentStorageSettingsCache::Result cached =
+		readValue ? mCache.Load(key, data, dataMaxSize, cachedSize) : mCache.HasEntry(key);
+
+	if (cached != PersistentStorageSettingsCache::Result::Miss) {
+		if (cached == PersistentStorageSettingsCache::Result::Failure ||
+		    (readValue && IsEmptyValue(data, cachedSize))) {
+			return false;
+		}
+
+		if (outSize != nullptr) {
+			*outSize = cachedSize;
+		}
+
+		return true;
+	}
+#endif
+
 	ReadEntry entry{ data, dataMaxSize, 0, false };
 	settings_load_subtree_direct(key, LoadEntryCallback, &entry);
 
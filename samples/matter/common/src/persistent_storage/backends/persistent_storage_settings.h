@@ -8,6 +8,10 @@
 
 #include "../persistent_storage_common.h"
 
+#ifdef CONFIG_NCS_SAMPLE_MATTER_SETTINGS_STORAGE_CACHE
+#include "persistent_storage_settings_cache.h"
+#endif
+
 namespace Nrf
 {
 class PersistentStorageSettings {
@@ -17,15 +21,21 @@ protected:
 	PSErrorCode _NonSecureLoad(PersistentStorageNode *node, void *data, size_t dataMaxSize, size_t &outSize);
 	PSErrorCode _NonSecureHasEntry(PersistentStorageNode *node);
 	PSErrorCode _NonSecureRemove(PersistentStorageNode *node);
+	PSErrorCode _NonSecureCommit();
 
 	PSErrorCode _SecureInit();
 	PSErrorCode _SecureStore(PersistentStorageNode *node, const void *data, size_t dataSize);
 	PSErrorCode _SecureLoad(PersistentStorageNode *node, void *data, size_t dataMaxSize, size_t &outSize);
 	PSErrorCode _SecureHasEntry(PersistentStorageNode *node);
 	PSErrorCode _SecureRemove(PersistentStorageNode *node);
+	PSErrorCode _SecureCommit();
 
 private:
 	bool LoadEntry(const char *key, void *data = nullptr, size_t dataMaxSize = 0, size_t *outSize = nullptr);
+
+#ifdef CONFIG_NCS_SAMPLE_MATTER_SETTINGS_STORAGE_CACHE
+	PersistentStorageSettingsCache mCache;
+#endif
 };
 
 inline PSErrorCode PersistentStorageSettings::_SecureInit()
@@ -55,4 +65,9 @@ inline PSErrorCode PersistentStorageSettings::_SecureRemove(PersistentStorageNod
 	return PSErrorCode::NotSupported;
 }
 
+inline PSErrorCode PersistentStorageSettings::_SecureCommit()
+{
+	return PSErrorCode::NotSupported;
+}
+
 } /* namespace Nrf */
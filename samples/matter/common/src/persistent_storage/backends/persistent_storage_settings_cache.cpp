@@ -0,0 +1,490 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include "persistent_storage_settings_cache.h"
+
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_DECLARE(app, CONFIG_CHIP_APP_LOG_LEVEL);
+
+namespace
+{
+constexpr uint32_t kFlushDelayMs = CONFIG_NCS_SAMPLE_MATTER_SETTINGS_STORAGE_CACHE_FLUSH_DELAY_MS;
+constexpr char kSubtree[] = CONFIG_NCS_SAMPLE_MATTER_SETTINGS_STORAGE_CACHE_SUBTREE;
+
+static_assert(sizeof(kSubtree) > 1, "The settings storage cache subtree must not be empty");
+
+uint32_t KeyHash(const char *key)
+{
+	/* FNV-1a, with 0 reserved for free directory entries. */
+	uint32_t hash = 2166136261u;
+
+	for (; *key != '\0'; key++) {
+		hash = (hash ^ static_cast<uint8_t>(*key)) * 16777619u;
+	}
+
+	return hash != 0 ? hash : 1;
+}
+} /* namespace */
+
+namespace Nrf
+{
+PersistentStorageSettingsCache::~PersistentStorageSettingsCache()
+{
+	if (mInitialized) {
+		k_work_sync sync;
+
+		k_work_cancel_delayable_sync(&mFlushWork.work, &sync);
+	}
+}
+
+PSErrorCode PersistentStorageSettingsCache::Init()
+{
+	/* The storage can be initialized by several modules, the directory is populated only once. */
+	if (mInitialized) {
+		return PSErrorCode::Success;
+	}
+
+	k_mutex_init(&mLock);
+	k_work_init_delayable(&mFlushWork.work, FlushHandler);
+	mFlushWork.cache = this;
+
+	memset(mHashes, 0, sizeof(mHashes));
+	mPendingCount = 0;
+	mBufferUsed = 0;
+	mComplete = true;
+
+	if (settings_load_subtree_direct(kSubtree, DirectoryLoadCallback, this)) {
+		return PSErrorCode::Failure;
+	}
+
+	if (!mComplete) {
+		LOG_WRN("Settings storage cache directory is full, increase the maximum number of keys");
+	}
+
+	mInitialized = true;
+
+	return PSErrorCode::Success;
+}
+
+PSErrorCode PersistentStorageSettingsCache::Store(const char *key, const void *data, size_t dataSize)
+{
+	if (!mInitialized || !InSubtree(key)) {
+		return settings_save_one(key, data, dataSize) ? PSErrorCode::Failure : PSErrorCode::Success;
+	}
+
+	const uint32_t hash = KeyHash(key);
+	PSErrorCode result = PSErrorCode::Success;
+
+	k_mutex_lock(&mLock, K_FOREVER);
+
+	uint16_t index = Find(key, hash);
+
+	if (index == kInvalidIndex && dataSize > 0) {
+		index = Add(key, hash);
+		mComplete = mComplete && index != kInvalidIndex;
+	}
+
+	if (index == kInvalidIndex) {
+		/* A key that is not in the directory is passed to the settings, unless it is known to be absent and
+		 * an empty value, which deletes the key, is stored. */
+		if (dataSize > 0 || !mComplete) {
+			result = settings_save_one(key, data, dataSize) ? PSErrorCode::Failure : PSErrorCode::Success;
+		}
+	} else if (dataSize == 0) {
+		/* Storing an empty value deletes the key from the settings. */
+		RemoveEntry(index);
+	} else if (Unchanged(index, data, dataSize)) {
+		/* Nothing to write, for example when an application stores all its data again after a reboot. */
+	} else {
+		bool buffered = Buffer(index, data, dataSize);
+
+		if (!buffered && Reclaim() == PSErrorCode::Success) {
+			/* The flush releases the entry if the key was pending removal. */
+			if (mHashes[index] == 0) {
+				index = Add(key, hash);
+			}
+
+			buffered = Buffer(index, data, dataSize);
+		}
+
+		Entry &entry = mEntries[index];
+
+		if (buffered) {
+			entry.flags = (entry.flags & ~kPendingRemove) | kCached | kPendingStore;
+			Enqueue(index);
+		} else if (!settings_save_one(key, data, dataSize)) {
+			/* The value does not fit in the buffer, so it is written through, replacing the pending one. */
+			Dequeue(index);
+			entry.flags |= kStored;
+		} else {
+			result = PSErrorCode::Failure;
+
+			if (entry.flags == 0) {
+				Release(index);
+			}
+		}
+	}
+
+	k_mutex_unlock(&mLock);
+
+	return result;
+}
+
+PersistentStorageSettingsCache::Result PersistentStorageSettingsCache::Load(const char *key, void *data,
+									     size_t dataMaxSize, size_t &outSize)
+{
+	if (!mInitialized || !InSubtree(key)) {
+		return Result::Miss;
+	}
+
+	const uint32_t hash = KeyHash(key);
+	Result result = Result::Miss;
+
+	k_mutex_lock(&mLock, K_FOREVER);
+
+	const uint16_t index = Find(key, hash);
+
+	if (index == kInvalidIndex) {
+		result = mComplete ? Result::Failure : Result::Miss;
+	} else if (!Exists(index)) {
+		result = Result::Failure;
+	} else if (mEntries[index].flags & kCached) {
+		const Entry &entry = mEntries[index];
+
+		if (entry.size <= dataMaxSize) {
+			memcpy(data, mBuffer + entry.offset, entry.size);
+			outSize = entry.size;
+			result = Result::Success;
+		} else {
+			result = Result::Failure;
+		}
+	}
+
+	k_mutex_unlock(&mLock);
+
+	return result;
+}
+
+PersistentStorageSettingsCache::Result PersistentStorageSettingsCache::HasEntry(const char *key)
+{
+	if (!mInitialized || !InSubtree(key)) {
+		return Result::Miss;
+	}
+
+	const uint32_t hash = KeyHash(key);
+	Result result;
+
+	k_mutex_lock(&mLock, K_FOREVER);
+
+	const uint16_t index = Find(key, hash);
+
+	if (index == kInvalidIndex) {
+		result = mComplete ? Result::Failure : Result::Miss;
+	} else {
+		result = Exists(index) ? Result::Success : Result::Failure;
+	}
+
+	k_mutex_unlock(&mLock);
+
+	return result;
+}
+
+PersistentStorageSettingsCache::Result PersistentStorageSettingsCache::Remove(const char *key)
+{
+	if (!mInitialized || !InSubtree(key)) {
+		return Result::Miss;
+	}
+
+	const uint32_t hash = KeyHash(key);
+	Result result;
+
+	k_mutex_lock(&mLock, K_FOREVER);
+
+	const uint16_t index = Find(key, hash);
+
+	if (index == kInvalidIndex) {
+		result = mComplete ? Result::Failure : Result::Miss;
+	} else {
+		result = RemoveEntry(index) ? Result::Success : Result::Failure;
+	}
+
+	k_mutex_unlock(&mLock);
+
+	return result;
+}
+
+PSErrorCode PersistentStorageSettingsCache::Commit()
+{
+	if (!mInitialized) {
+		return PSErrorCode::Success;
+	}
+
+	k_mutex_lock(&mLock, K_FOREVER);
+	const PSErrorCode result = Flush();
+	k_mutex_unlock(&mLock);
+
+	return result;
+}
+
+int PersistentStorageSettingsCache::DirectoryLoadCallback(const char *name, size_t entrySize, settings_read_cb readCb,
+							  void *cbArg, void *param)
+{
+	PersistentStorageSettingsCache &cache = *static_cast<PersistentStorageSettingsCache *>(param);
+	char key[PersistentStorageNode::kMaxKeyNameLength];
+
+	/* The name is relative to the subtree, and is empty for the key of the subtree itself. */
+	const int keyLength = (name != nullptr && *name != '\0') ? snprintf(key, sizeof(key), "%s/%s", kSubtree, name) :
+								      snprintf(key, sizeof(key), "%s", kSubtree);
+
+	/* Longer keys cannot be created by PersistentStorageNode, so they are not tracked. */
+	if (keyLength < 0 || static_cast<size_t>(keyLength) >= sizeof(key)) {
+		return 0;
+	}
+
+	const uint32_t hash = KeyHash(key);
+	uint16_t index = cache.Find(key, hash);
+
+	/* An empty entry marks a deleted key in some settings backends. */
+	if (entrySize == 0) {
+		if (index != kInvalidIndex) {
+			cache.Release(index);
+		}
+
+		return 0;
+	}
+
+	if (index == kInvalidIndex) {
+		index = cache.Add(key, hash);
+	}
+
+	if (index == kInvalidIndex) {
+		cache.mComplete = false;
+		return 0;
+	}
+
+	Entry &entry = cache.mEntries[index];
+
+	entry.flags = kStored;
+
+	/* Keep the value in the buffer if there is room for it, so that it can be loaded from RAM. */
+	if (entrySize > entry.capacity && entrySize <= kBufferSize - cache.mBufferUsed) {
+		entry.offset = cache.mBufferUsed;
+		entry.capacity = entrySize;
+		cache.mBufferUsed += entrySize;
+	}
+
+	if (entrySize <= entry.capacity &&
+	    readCb(cbArg, cache.mBuffer + entry.offset, entrySize) == static_cast<ssize_t>(entrySize)) {
+		entry.size = entrySize;
+		entry.flags |= kCached;
+	}
+
+	return 0;
+}
+
+void PersistentStorageSettingsCache::FlushHandler(k_work *work)
+{
+	FlushWork *flushWork = CONTAINER_OF(k_work_delayable_from_work(work), FlushWork, work);
+	PersistentStorageSettingsCache &cache = *flushWork->cache;
+
+	k_mutex_lock(&cache.mLock, K_FOREVER);
+
+	/* Retry later, the failed entries are still pending. */
+	if (cache.Flush() != PSErrorCode::Success) {
+		k_work_schedule(&flushWork->work, K_MSEC(kFlushDelayMs));
+	}
+
+	k_mutex_unlock(&cache.mLock);
+}
+
+bool PersistentStorageSettingsCache::InSubtree(const char *key)
+{
+	const size_t subtreeLength = sizeof(kSubtree) - 1;
+
+	return strncmp(key, kSubtree, subtreeLength) == 0 && (key[subtreeLength] == '\0' || key[subtreeLength] == '/');
+}
+
+uint16_t PersistentStorageSettingsCache::Find(const char *key, uint32_t hash)
+{
+	for (uint16_t i = 0; i < kMaxEntries; i++) {
+		if (mHashes[i] == hash && strcmp(mEntries[i].key, key) == 0) {
+			return i;
+		}
+	}
+
+	return kInvalidIndex;
+}
+
+uint16_t PersistentStorageSettingsCache::Add(const char *key, uint32_t hash)
+{
+	for (uint16_t i = 0; i < kMaxEntries; i++) {
+		if (mHashes[i] == 0) {
+			Entry &entry = mEntries[i];
+
+			strcpy(entry.key, key);
+			entry.offset = 0;
+			entry.capacity = 0;
+			entry.size = 0;
+			entry.flags = 0;
+			mHashes[i] = hash;
+
+			return i;
+		}
+	}
+
+	return kInvalidIndex;
+}
+
+void PersistentStorageSettingsCache::Release(uint16_t index)
+{
+	mHashes[index] = 0;
+}
+
+bool PersistentStorageSettingsCache::Exists(uint16_t index)
+{
+	const uint8_t flags = mEntries[index].flags;
+
+	return (flags & kPendingStore) || ((flags & kStored) && !(flags & kPendingRemove));
+}
+
+bool PersistentStorageSettingsCache::Unchanged(uint16_t index, const void *data, size_t dataSize)
+{
+	const Entry &entry = mEntries[index];
+
+	return (entry.flags & kCached) && !(entry.flags & kPendingStore) && entry.size == dataSize &&
+	       memcmp(mBuffer + entry.offset, data, dataSize) == 0;
+}
+
+bool PersistentStorageSettingsCache::Buffer(uint16_t index, const void *data, size_t dataSize)
+{
+	Entry &entry = mEntries[index];
+
+	/* The current value is overwritten in place if the new one fits, otherwise the new one is appended. */
+	if (dataSize > entry.capacity) {
+		if (dataSize > kBufferSize - mBufferUsed) {
+			return false;
+		}
+
+		entry.offset = mBufferUsed;
+		entry.capacity = dataSize;
+		mBufferUsed += dataSize;
+	}
+
+	memcpy(mBuffer + entry.offset, data, dataSize);
+	entry.size = dataSize;
+
+	return true;
+}
+
+bool PersistentStorageSettingsCache::RemoveEntry(uint16_t index)
+{
+	Entry &entry = mEntries[index];
+
+	if (!Exists(index)) {
+		return false;
+	}
+
+	if (entry.flags & kStored) {
+		entry.flags = (entry.flags & ~(kCached | kPendingStore)) | kPendingRemove;
+		Enqueue(index);
+	} else {
+		/* The key has never been written to the settings, so only the pending value is dropped. */
+		Dequeue(index);
+		Release(index);
+	}
+
+	return true;
+}
+
+void PersistentStorageSettingsCache::Enqueue(uint16_t index)
+{
+	Entry &entry = mEntries[index];
+
+	if (!(entry.flags & kQueued)) {
+		mPending[mPendingCount++] = index;
+		entry.flags |= kQueued;
+	}
+
+	if (kFlushDelayMs > 0) {
+		/* The work is not rescheduled if already scheduled, so the delay runs from the oldest change. */
+		k_work_schedule(&mFlushWork.work, K_MSEC(kFlushDelayMs));
+	}
+}
+
+void PersistentStorageSettingsCache::Dequeue(uint16_t index)
+{
+	Entry &entry = mEntries[index];
+
+	if (entry.flags & kQueued) {
+		for (size_t i = 0; i < mPendingCount; i++) {
+			if (mPending[i] == index) {
+				memmove(&mPending[i], &mPending[i + 1], (mPendingCount - i - 1) * sizeof(mPending[0]));
+				mPendingCount--;
+				break;
+			}
+		}
+	}
+
+	/* The buffer space is released for all the entries at once, when the buffer is reclaimed. */
+	entry.flags &= ~(kQueued | kCached | kPendingStore | kPendingRemove);
+	entry.capacity = 0;
+}
+
+PSErrorCode PersistentStorageSettingsCache::Flush()
+{
+	PSErrorCode result = PSErrorCode::Success;
+	size_t flushed = 0;
+
+	/* Keys are written in the order of their first change. On a failure, the failed entry and the ones that
+	 * follow it are kept pending, in the same order. */
+	for (; flushed < mPendingCount; flushed++) {
+		const uint16_t index = mPending[flushed];
+		Entry &entry = mEntries[index];
+
+		if (entry.flags & kPendingStore) {
+			if (settings_save_one(entry.key, mBuffer + entry.offset, entry.size)) {
+				LOG_ERR("Failed to write %s to settings", entry.key);
+				result = PSErrorCode::Failure;
+				break;
+			}
+
+			entry.flags = kStored | kCached;
+		} else {
+			if (settings_delete(entry.key)) {
+				LOG_ERR("Failed to delete %s from settings", entry.key);
+				result = PSErrorCode::Failure;
+				break;
+			}
+
+			Release(index);
+		}
+	}
+
+	mPendingCount -= flushed;
+	memmove(mPending, mPending + flushed, mPendingCount * sizeof(mPending[0]));
+
+	return result;
+}
+
+PSErrorCode PersistentStorageSettingsCache::Reclaim()
+{
+	if (Flush() != PSErrorCode::Success) {
+		return PSErrorCode::Failure;
+	}
+
+	/* All values are in the settings now, so they can be dropped from the buffer to make room for new ones. */
+	for (size_t i = 0; i < kMaxEntries; i++) {
+		mEntries[i].flags &= ~kCached;
+		mEntries[i].capacity = 0;
+	}
+
+	mBufferUsed = 0;
+
+	return PSErrorCode::Success;
+}
+
+} /* namespace Nrf */
@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#pragma once
+
+#include "../persistent_storage_common.h"
+
+#include <zephyr/kernel.h>
+#include <zephyr/settings/settings.h>
+
+namespace Nrf
+{
+/**
+ * @brief Write-back cache for the settings based storage.
+ *
+ * The cache keeps a directory of the keys present in the settings, populated once at initialization, so that
+ * the existence of a key can be checked without walking the settings. The values read at initialization are kept
+ * in a bounded buffer, as long as they fit, and can be loaded from RAM. Stored values are kept in the same buffer
+ * and written to the settings after a delay, when the buffer is full, or on an explicit commit. Repeated stores of
+ * the same key before the write are coalesced into one.
+ *
+ * Only the keys in the CONFIG_NCS_SAMPLE_MATTER_SETTINGS_STORAGE_CACHE_SUBTREE settings subtree are cached. Keys out of
+ * the subtree, and keys that do not fit in the directory, are not cached, and operations on them are passed to the
+ * settings. The keys handled by the cache must not be modified in the settings directly.
+ */
+class PersistentStorageSettingsCache {
+public:
+	/**
+	 * @brief Result of a cache operation.
+	 *
+	 * Success and Failure are the results of the operation served from RAM. Miss means that the cache does not
+	 * hold the information and the operation must be performed on the settings.
+	 */
+	enum class Result : uint8_t { Success, Failure, Miss };
+
+	~PersistentStorageSettingsCache();
+
+	PSErrorCode Init();
+	PSErrorCode Store(const char *key, const void *data, size_t dataSize);
+	Result Load(const char *key, void *data, size_t dataMaxSize, size_t &outSize);
+	Result HasEntry(const char *key);
+	Result Remove(const char *key);
+	PSErrorCode Commit();
+
+private:
+	static constexpr size_t kMaxEntries = CONFIG_NCS_SAMPLE_MATTER_SETTINGS_STORAGE_CACHE_MAX_KEYS;
+	static constexpr size_t kBufferSize = CONFIG_NCS_SAMPLE_MATTER_SETTINGS_STORAGE_CACHE_BUFFER_SIZE;
+	static constexpr uint16_t kInvalidIndex = UINT16_MAX;
+
+	enum Flags : uint8_t {
+		/* The key is present in the settings. */
+		kStored = BIT(0),
+		/* The buffer holds the current value. */
+		kCached = BIT(1),
+		/* The value in the buffer has not been written to the settings yet. */
+		kPendingStore = BIT(2),
+		/* The key has not been deleted from the settings yet. */
+		kPendingRemove = BIT(3),
+		/* The entry is in the pending list. */
+		kQueued = BIT(4),
+	};
+
+	struct Entry {
+		char key[PersistentStorageNode::kMaxKeyNameLength];
+		uint16_t offset;
+		uint16_t capacity;
+		uint16_t size;
+		uint8_t flags;
+	};
+
+	struct FlushWork {
+		k_work_delayable work;
+		PersistentStorageSettingsCache *cache;
+	};
+
+	static int DirectoryLoadCallback(const char *name, size_t entrySize, settings_read_cb readCb, void *cbArg,
+					 void *param);
+	static void FlushHandler(k_work *work);
+	static bool InSubtree(const char *key);
+
+	uint16_t Find(const char *key, uint32_t hash);
+	uint16_t Add(const char *key, uint32_t hash);
+	void Release(uint16_t index);
+	bool Exists(uint16_t index);
+	bool Unchanged(uint16_t index, const void *data, size_t dataSize);
+	bool Buffer(uint16_t index, const void *data, size_t dataSize);
+	bool RemoveEntry(uint16_t index);
+	void Enqueue(uint16_t index);
+	void Dequeue(uint16_t index);
+	PSErrorCode Flush();
+	PSErrorCode Reclaim();
+
+	/* Hashes of the keys, 0 for a free entry, scanned before comparing the full keys. */
+	uint32_t mHashes[kMaxEntries];
+	Entry mEntries[kMaxEntries];
+	/* Indexes of the entries with pending changes, in the order of their first change. */
+	uint16_t mPending[kMaxEntries];
+	size_t mPendingCount = 0;
+	uint8_t mBuffer[kBufferSize];
+	size_t mBufferUsed = 0;
+	/* All the keys in the subtree that fit in PersistentStorageNode are in the directory. */
+	bool mComplete = false;
+	bool mInitialized = false;
+	k_mutex mLock;
+	FlushWork mFlushWork;
+};
+
+} /* namespace Nrf */
@@ -72,12 +72,24 @@ public:
 	 */
 	PSErrorCode NonSecureRemove(PersistentStorageNode *node);
 
+	/**
+	 * @brief Write all data buffered by the implementation to the persistent storage.
+	 *
+	 * An implementation may defer writes to reduce the storage wear. Call this method after a set of related
+	 * changes that must not be lost, for example on a power loss.
+	 *
+	 * @return true if all data has been written successfully or nothing was buffered.
+	 * @return false an error occurred.
+	 */
+	PSErrorCode NonSecureCommit();
+
 	/* Secure storage API counterparts.*/
 	PSErrorCode SecureInit();
 	PSErrorCode SecureStore(PersistentStorageNode *node, const void *data, size_t dataSize);
 	PSErrorCode SecureLoad(PersistentStorageNode *node, void *data, size_t dataMaxSize, size_t &outSize);
 	PSErrorCode SecureHasEntry(PersistentStorageNode *node);
 	PSErrorCode SecureRemove(PersistentStorageNode *node);
+	PSErrorCode SecureCommit();
 
 protected:
 	PersistentStorage() = default;
@@ -133,6 +145,11 @@ inline PSErrorCode PersistentStorage::NonSecureRemove(PersistentStorageNode *nod
 	return Impl()->_NonSecureRemove(node);
 }
 
+inline PSErrorCode PersistentStorage::NonSecureCommit()
+{
+	return Impl()->_NonSecureCommit();
+}
+
 /* Secure storage API. */
 inline PSErrorCode PersistentStorage::SecureInit()
 {
@@ -160,4 +177,9 @@ inline PSErrorCode PersistentStorage::SecureRemove(PersistentStorageNode *node)
 	return Impl()->_SecureRemove(node);
 }
 
+inline PSErrorCode PersistentStorage::SecureCommit()
+{
+	return Impl()->_SecureCommit();
+}
+
 } /* namespace Nrf */
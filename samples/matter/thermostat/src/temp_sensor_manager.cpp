@@ -33,7 +33,9 @@ CHIP_ERROR TempSensorManager::Init()
 
 void TempSensorManager::TimerEventHandler(k_timer *timer)
 {
-	Nrf::PostTask([] { TempSensorManager::SensorTimerEventHandler(); });
+	/* A measurement that has not been handled yet is replaced by the new one. */
+	Nrf::PostTask([] { TempSensorManager::SensorTimerEventHandler(); }, Nrf::TaskPriority::Low,
+		      reinterpret_cast<Nrf::TaskCoalescingKey>(&TempSensorManager::SensorTimerEventHandler));
 }
 
 /*
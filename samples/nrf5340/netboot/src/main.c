@@ -16,6 +16,15 @@
 #include <zephyr/device.h>
 #include <zephyr/devicetree.h>
 
+static struct bl_validate_stream_ctx copy_validation;
+
+static int copy_validate(const uint8_t *buf, size_t len, size_t offset)
+{
+	ARG_UNUSED(offset);
+
+	return bl_validate_firmware_stream_update(&copy_validation, buf, len);
+}
+
 int main(void)
 {
 	int err;
@@ -58,19 +67,23 @@ int main(void)
 #endif
 
 	if (status == PCD_STATUS_COPY) {
-		/* First we validate the data where the PCD CMD tells
-		 * us that we can find it.
+		/* First we check the firmware info of the data where the PCD
+		 * CMD tells us that we can find it.
 		 */
 		uint32_t update_addr = (uint32_t)pcd_cmd_data_ptr_get();
 
-		valid = bl_validate_firmware(s0_addr, update_addr);
-		if (!valid) {
+		err = bl_validate_firmware_stream_init(&copy_validation, s0_addr,
+						       update_addr);
+		if (err != 0) {
 			printk("Unable to find valid firmware inside %p\n\r",
 				(void *)update_addr);
 			goto failure;
 		}
 
-		err = pcd_fw_copy(fdev);
+		/* The data is hashed as it is read for the copy, so the image
+		 * is read only once.
+		 */
+		err = pcd_fw_copy_cb(fdev, copy_validate);
 		if (err != 0) {
 			printk("Failed to transfer image: %d\n\r", err);
 			goto failure;
@@ -78,15 +91,15 @@ int main(void)
 
 		/* Note that only the SHA is validated, no signature
 		 * check is performed. This because the signature validation
-		 * is performed by the application core. This check is only
-		 * done to verify that the flash copy operation was successful.
+		 * is performed by the application core. Errors when writing
+		 * the flash are reported by the transfer.
 		 */
-		valid = bl_validate_firmware(s0_addr, s0_addr);
+		valid = bl_validate_firmware_stream_finalize(&copy_validation);
 		if (valid) {
 			pcd_done();
 		} else {
 			printk("Unable to find valid firmware inside %p\n\r",
-				(void *)s0_addr);
+				(void *)update_addr);
 			goto failure;
 		}
 
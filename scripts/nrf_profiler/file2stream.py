@@ -0,0 +1,49 @@
+#
+# Copyright (c) 2024 Nordic Semiconductor ASA
+#
+# SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+
+import sys
+import logging
+from stream import Stream, StreamError
+
+class File2Stream:
+    """Reads data written by the nrf_profiler file transport, for example on native_sim.
+
+    The .info file holds event descriptions and the .data file holds profiled data, in the
+    same format as the RTT info and data channels.
+    """
+
+    def __init__(self, out_stream, event_close, file_name, log_lvl=logging.INFO):
+        self.out_stream = out_stream
+        self.event_close = event_close
+        self.info_filename = file_name + '.info'
+        self.data_filename = file_name + '.data'
+
+        self.logger = logging.getLogger('Profiler file to stream')
+        self.logger_console = logging.StreamHandler()
+        self.logger.setLevel(log_lvl)
+        self.log_format = logging.Formatter('[%(levelname)s] %(name)s: %(message)s')
+        self.logger_console.setFormatter(self.log_format)
+        self.logger.addHandler(self.logger_console)
+
+    def read_and_transmit_data(self):
+        try:
+            with open(self.info_filename, 'rb') as f:
+                desc_buf = f.read()
+            self.out_stream.send_desc(desc_buf)
+
+            with open(self.data_filename, 'rb') as f:
+                while not self.event_close.is_set():
+                    buf = f.read(Stream.RECV_BUF_SIZE)
+                    if len(buf) == 0:
+                        break
+                    self.out_stream.send_ev(buf)
+        except IOError as err:
+            self.logger.error("Problem with reading file: {}".format(err))
+            sys.exit()
+        except StreamError as err:
+            self.logger.error("Error: {}. Unable to send data".format(err))
+            sys.exit()
+
+        self.logger.info("All data read from files")
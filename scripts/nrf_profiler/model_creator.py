@@ -20,6 +20,7 @@ class Command(Enum):
     INFO = 3
 
 NRF_PROFILER_FATAL_ERROR_EVENT_NAME = "_nrf_profiler_fatal_error_event_"
+NRF_PROFILER_DROPPED_EVENTS_EVENT_NAME = "_nrf_profiler_dropped_events_"
 
 class ModelCreator:
 
@@ -256,6 +257,9 @@ class ModelCreator:
             if self.raw_data.registered_events_types[event.type_id].name == NRF_PROFILER_FATAL_ERROR_EVENT_NAME:
                 self.logger.error("Fatal error of Profiler on device! Event has been dropped. "
                                   "Data buffer has overflown. No more events will be received.")
+            elif self.raw_data.registered_events_types[event.type_id].name == NRF_PROFILER_DROPPED_EVENTS_EVENT_NAME:
+                self.logger.warning("{} events have been dropped on device. "
+                                    "Staging buffer has overflown.".format(event.data[0]))
 
             if event.type_id == self.event_processing_start_id:
                 self.start_event = event
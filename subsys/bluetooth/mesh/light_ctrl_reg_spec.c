@@ -4,10 +4,248 @@
  * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
  */
 
+#include <string.h>
 #include <bluetooth/mesh/light_ctrl_reg_spec.h>
 
 #define REG_INT CONFIG_BT_MESH_LIGHT_CTRL_REG_SPEC_INTERVAL
 
+#if defined(CONFIG_BT_MESH_LIGHT_CTRL_REG_SPEC_FIXED_POINT)
+
+/* Values are in Q16.16 fixed-point format, stored in 64 bits so that the illuminance range of
+ * the ambient light sensor and the intermediate products fit.
+ */
+#define FX_SHIFT 16
+/* The accuracy is a small fraction of the target, so it gets more fractional bits. */
+#define FX_ACCURACY_SHIFT 24
+#define FX_LIGHTNESS_MAX ((int64_t)UINT16_MAX << FX_SHIFT)
+
+struct reg_terms {
+	int64_t i;
+	int64_t p;
+};
+
+static void regs_step(struct k_work *work);
+
+/* All running regulators are stepped from one timer, so that the CPU wakes up once per
+ * regulator interval regardless of the number of regulators.
+ */
+static sys_slist_t running;
+static K_WORK_DELAYABLE_DEFINE(step_work, regs_step);
+
+static int64_t fx_from_float(float value, int shift)
+{
+	return (int64_t)(value * (float)(1LL << shift));
+}
+
+static int64_t fx_mul(int64_t a, int64_t b, int shift)
+{
+	return (a * b) >> shift;
+}
+
+/* The inputs are converted only when their value has changed, which is detected by comparing
+ * the bit patterns without any floating point operations.
+ */
+static void input_update(float value, uint32_t *raw, int64_t *fx)
+{
+	uint32_t value_raw;
+
+	memcpy(&value_raw, &value, sizeof(value_raw));
+	if (value_raw != *raw) {
+		*raw = value_raw;
+		*fx = fx_from_float(value, FX_SHIFT);
+	}
+}
+
+static void cfg_update(struct bt_mesh_light_ctrl_reg_spec *spec_reg)
+{
+	const struct bt_mesh_light_ctrl_reg_cfg *cfg = &spec_reg->reg.cfg;
+
+	if (!memcmp(&spec_reg->cfg, cfg, sizeof(spec_reg->cfg))) {
+		return;
+	}
+
+	spec_reg->cfg = *cfg;
+	spec_reg->kp_up = fx_from_float(cfg->kp.up, FX_SHIFT);
+	spec_reg->kp_down = fx_from_float(cfg->kp.down, FX_SHIFT);
+	/* The integral coefficients are scaled by the step interval up front. */
+	spec_reg->ki_up = fx_from_float(cfg->ki.up * ((float)REG_INT / (float)MSEC_PER_SEC),
+					FX_SHIFT);
+	spec_reg->ki_down = fx_from_float(cfg->ki.down * ((float)REG_INT / (float)MSEC_PER_SEC),
+					  FX_SHIFT);
+	/* Accuracy should be in percent and both up and down: */
+	spec_reg->accuracy = fx_from_float(cfg->accuracy / (2 * 100.0f), FX_ACCURACY_SHIFT);
+}
+
+static int64_t target_get(struct bt_mesh_light_ctrl_reg_spec *spec_reg)
+{
+	struct bt_mesh_light_ctrl_reg *reg = &spec_reg->reg;
+	int64_t elapsed;
+
+	input_update(reg->target, &spec_reg->target_raw, &spec_reg->target);
+
+	/* Same as bt_mesh_light_ctrl_reg_target_get(), in fixed point. */
+	if (reg->transition_time == 0) {
+		return spec_reg->target;
+	}
+
+	elapsed = k_uptime_get() - reg->transition_start;
+	if (elapsed >= reg->transition_time) {
+		reg->transition_time = 0;
+		return spec_reg->target;
+	}
+
+	input_update(reg->prev_target, &spec_reg->prev_target_raw, &spec_reg->prev_target);
+
+	return spec_reg->prev_target +
+	       (elapsed * (spec_reg->target - spec_reg->prev_target)) / reg->transition_time;
+}
+
+/* Returns the error outside of the accuracy band. */
+static int64_t reg_input_get(struct bt_mesh_light_ctrl_reg_spec *spec_reg)
+{
+	int64_t target = target_get(spec_reg);
+	int64_t error;
+	int64_t accuracy;
+
+	input_update(spec_reg->reg.measured, &spec_reg->measured_raw, &spec_reg->measured);
+	cfg_update(spec_reg);
+
+	error = target - spec_reg->measured;
+	accuracy = fx_mul(target, spec_reg->accuracy, FX_ACCURACY_SHIFT);
+
+	if (error > accuracy) {
+		return error - accuracy;
+	} else if (error < -accuracy) {
+		return error + accuracy;
+	}
+
+	return 0;
+}
+
+static struct reg_terms reg_terms_calc(struct bt_mesh_light_ctrl_reg_spec *spec_reg,
+				       int64_t input)
+{
+	int64_t kp, ki;
+
+	if (input >= 0) {
+		kp = spec_reg->kp_up;
+		ki = spec_reg->ki_up;
+	} else {
+		kp = spec_reg->kp_down;
+		ki = spec_reg->ki_down;
+	}
+
+	return (struct reg_terms){
+		.i = fx_mul(input, ki, FX_SHIFT),
+		.p = fx_mul(input, kp, FX_SHIFT),
+	};
+}
+
+static void reg_step(struct bt_mesh_light_ctrl_reg_spec *spec_reg)
+{
+	struct reg_terms reg_terms;
+	int64_t input;
+
+	input = reg_input_get(spec_reg);
+
+	/* Within the accuracy band, both terms are zero. If they were zero in the last step as
+	 * well, the output is still the same.
+	 */
+	if (input == 0 && spec_reg->idle) {
+		spec_reg->reg.updated(&spec_reg->reg, spec_reg->output);
+		return;
+	}
+
+	reg_terms = reg_terms_calc(spec_reg, input);
+	spec_reg->i += reg_terms.i;
+
+	if (spec_reg->i >= 0) {
+		/* Drop the negative flag as soon as the internal sum becomes positive. */
+		spec_reg->neg = false;
+	}
+
+	if (!spec_reg->neg) {
+		spec_reg->i = CLAMP(spec_reg->i, 0, FX_LIGHTNESS_MAX);
+	}
+
+	spec_reg->idle = (input == 0);
+	spec_reg->output = (float)(spec_reg->i + reg_terms.p) * (1.0f / (1 << FX_SHIFT));
+
+	spec_reg->reg.updated(&spec_reg->reg, spec_reg->output);
+}
+
+static void regs_step(struct k_work *work)
+{
+	struct bt_mesh_light_ctrl_reg_spec *spec_reg, *tmp;
+
+	if (sys_slist_is_empty(&running)) {
+		return;
+	}
+
+	k_work_reschedule(&step_work, K_MSEC(REG_INT));
+
+	/* A regulator might be stopped from its own update callback. */
+	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&running, spec_reg, tmp, node) {
+		if (spec_reg->enabled) {
+			reg_step(spec_reg);
+		}
+	}
+}
+
+static void internal_sum_recover(struct bt_mesh_light_ctrl_reg_spec *spec_reg, uint16_t lightness)
+{
+	struct reg_terms reg_terms;
+
+	reg_terms = reg_terms_calc(spec_reg, reg_input_get(spec_reg));
+
+	/* Recalculate the internal sum so that it is equal to the passed lightness level at the
+	 * next regulator step.
+	 */
+	spec_reg->i = ((int64_t)lightness << FX_SHIFT) - reg_terms.i;
+	/* Allow the internal sum to be negative until it becomes positive. */
+	spec_reg->neg = true;
+	spec_reg->idle = false;
+}
+
+void bt_mesh_light_ctrl_reg_spec_start(struct bt_mesh_light_ctrl_reg *reg, uint16_t lightness)
+{
+	struct bt_mesh_light_ctrl_reg_spec *spec_reg = CONTAINER_OF(
+		reg, struct bt_mesh_light_ctrl_reg_spec, reg);
+
+	if (!spec_reg->enabled) {
+		sys_slist_append(&running, &spec_reg->node);
+		spec_reg->enabled = true;
+	}
+
+	/* The first step of the regulator is at the next tick of the shared timer. */
+	k_work_schedule(&step_work, K_MSEC(REG_INT));
+	internal_sum_recover(spec_reg, lightness);
+}
+
+void bt_mesh_light_ctrl_reg_spec_stop(struct bt_mesh_light_ctrl_reg *reg)
+{
+	struct bt_mesh_light_ctrl_reg_spec *spec_reg = CONTAINER_OF(
+		reg, struct bt_mesh_light_ctrl_reg_spec, reg);
+	spec_reg->i = 0;
+
+	if (spec_reg->enabled) {
+		(void)sys_slist_find_and_remove(&running, &spec_reg->node);
+		spec_reg->enabled = false;
+	}
+
+	if (sys_slist_is_empty(&running)) {
+		k_work_cancel_delayable(&step_work);
+	}
+}
+
+void bt_mesh_light_ctrl_reg_spec_init(struct bt_mesh_light_ctrl_reg *reg)
+{
+	/* The shared step timer is statically initialized. */
+	ARG_UNUSED(reg);
+}
+
+#else
+
 struct reg_terms {
 	float i;
 	float p;
@@ -113,3 +351,5 @@ void bt_mesh_light_ctrl_reg_spec_init(struct bt_mesh_light_ctrl_reg *reg)
 		reg, struct bt_mesh_light_ctrl_reg_spec, reg);
 	k_work_init_delayable(&spec_reg->timer, reg_step);
 }
+
+#endif /* CONFIG_BT_MESH_LIGHT_CTRL_REG_SPEC_FIXED_POINT */
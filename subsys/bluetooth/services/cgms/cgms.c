@@ -34,6 +34,9 @@ LOG_MODULE_REGISTER(cgms, CONFIG_BT_CGMS_LOG_LEVEL);
 #define CGMS_STATUS_LENGTH         5
 #define CGMS_SST_LENGTH            9
 
+/* Attribute protocol application error codes */
+#define CGMS_ATT_ERR_PROC_IN_PROGRESS 0xFE
+
 /* The fastest communication interval supported by the device */
 #define CGMS_COMM_INTERVAL_MIN     1
 
@@ -272,7 +275,9 @@ static ssize_t racp_on_receive(struct bt_conn *conn,
 	int rc;
 
 	rc = cgms_racp_recv_request(conn, buf, len);
-	if (rc < 0) {
+	if (rc == -EBUSY) {
+		return BT_GATT_ERR(CGMS_ATT_ERR_PROC_IN_PROGRESS);
+	} else if (rc < 0) {
 		LOG_WRN("Internal Error during RACP Handling: %d", rc);
 	}
 
@@ -350,9 +355,13 @@ BT_GATT_SERVICE_DEFINE(cgms_svc,
 				BT_GATT_PERM_READ_AUTHEN | BT_GATT_PERM_WRITE_AUTHEN),
 );
 
-static void bt_cgms_notify_meas(struct bt_conn *conn, void *data)
+static int bt_cgms_notify_meas(struct bt_conn *conn, void *data, bt_gatt_complete_func_t func)
 {
 	struct cgms_meas *meas = (struct cgms_meas *)data;
+	struct bt_gatt_notify_params params = {
+		.attr = &cgms_svc.attrs[CGMS_SVC_MEAS_ATTR_IDX],
+		.func = func,
+	};
 	uint8_t meas_size;
 	struct net_buf_simple *meas_buf = NET_BUF_SIMPLE(CGMS_MEAS_LENGTH);
 
@@ -374,21 +383,23 @@ static void bt_cgms_notify_meas(struct bt_conn *conn, void *data)
 	meas_size = meas_buf->len + 1;
 	net_buf_simple_push_u8(meas_buf, meas_size);
 
+	params.data = meas_buf->data;
+	params.len = meas_size;
+
 	/* If conn is NULL, it implies this is a periodic notification.
 	 * Send it to all peers.
 	 * If conn is set, verify if the notification of this conn is enabled,
 	 * and send notification accordingly.
 	 */
 	if (conn == NULL) {
-		bt_gatt_notify(NULL, &cgms_svc.attrs[CGMS_SVC_MEAS_ATTR_IDX],
-			meas_buf->data, meas_size);
+		return bt_gatt_notify_cb(NULL, &params);
 	} else if (bt_gatt_is_subscribed(conn, &cgms_svc.attrs[CGMS_SVC_MEAS_ATTR_IDX],
 			BT_GATT_CCC_NOTIFY)) {
-		bt_gatt_notify(conn, &cgms_svc.attrs[CGMS_SVC_MEAS_ATTR_IDX],
-			meas_buf->data, meas_size);
-	} else {
-		LOG_INF("Client disabled the measurement notification");
+		return bt_gatt_notify_cb(conn, &params);
 	}
+
+	LOG_INF("Client disabled the measurement notification");
+	return -EACCES;
 }
 
 int cgms_racp_send_response(struct bt_conn *peer, struct net_buf_simple *rsp)
@@ -402,10 +413,10 @@ int cgms_racp_send_response(struct bt_conn *peer, struct net_buf_simple *rsp)
 	return bt_gatt_indicate(peer, &indicate_data);
 }
 
-int cgms_racp_send_record(struct bt_conn *peer, struct cgms_meas *entry)
+int cgms_racp_send_record(struct bt_conn *peer, struct cgms_meas *entry,
+			bt_gatt_complete_func_t done)
 {
-	bt_cgms_notify_meas(peer, entry);
-	return 0;
+	return bt_cgms_notify_meas(peer, entry, done);
 }
 
 int cgms_socp_send_response(struct bt_conn *peer, struct net_buf_simple *rsp)
@@ -423,16 +434,22 @@ int bt_cgms_measurement_add(struct bt_cgms_measurement measurement)
 {
 	/*Prepare the measurement */
 	struct cgms_meas meas;
+	uint32_t time_offset;
 
 	if (atomic_test_bit(&cgms_inst.status, CGMS_STATUS_POS_SESSION_STOPPED)) {
 		LOG_DBG("Session stopped. Cannot add new measurement.");
 		return -ENOENT;
 	}
 
+	time_offset = (k_uptime_get_32() - cgms_inst.local_start_time) / MSEC_PER_SEC / 60;
+	if (time_offset > UINT16_MAX) {
+		LOG_WRN("Time offset out of range. Cannot add new measurement.");
+		return -ERANGE;
+	}
+
 	meas.flag = 0;
 	meas.glucose_concentration = measurement.glucose.val;
-	meas.time_offset =
-		(k_uptime_get_32() - cgms_inst.local_start_time) / MSEC_PER_SEC / 60;
+	meas.time_offset = time_offset;
 	meas.sensor_status_annunciation.warning = 0;
 	meas.sensor_status_annunciation.calib_temp = 0;
 	meas.sensor_status_annunciation.status = 0;
@@ -459,7 +476,7 @@ static void report_meas(struct k_work *item)
 	if (cgms_inst.comm_interval > 0) {
 		if (cgms_racp_meas_get_latest(&meas) == 0) {
 			/* Notify all connected peers when it is periodic notification.*/
-			bt_cgms_notify_meas(NULL, &meas);
+			(void)bt_cgms_notify_meas(NULL, &meas, NULL);
 		}
 	}
 	k_work_reschedule(&report_meas_work, K_MINUTES(
@@ -478,6 +495,7 @@ static void stop_session(struct k_timer *timer_id)
 int bt_cgms_init(struct bt_cgms_init_param *init_params)
 {
 	int rc;
+	uint16_t time_offset;
 
 	cgms_inst.feature.type = init_params->type;
 	cgms_inst.feature.sample_location = init_params->sample_location;
@@ -510,7 +528,17 @@ int bt_cgms_init(struct bt_cgms_init_param *init_params)
 	}
 	cgms_inst.cb.session_state_changed = init_params->cb->session_state_changed;
 
-	cgms_racp_init();
+	rc = cgms_racp_init();
+	if (rc < 0) {
+		LOG_WRN("Cannot initialize record database.");
+		return rc;
+	}
+
+	rc = cgms_racp_session_start((uint32_t)cgms_inst.srt * 60, &time_offset);
+	if (rc) {
+		LOG_WRN("Cannot start session.");
+		return rc;
+	}
 
 	k_work_init_delayable(&report_meas_work, report_meas);
 	rc = k_work_reschedule(&report_meas_work, K_MINUTES(cgms_inst.comm_interval));
@@ -523,7 +551,8 @@ int bt_cgms_init(struct bt_cgms_init_param *init_params)
 	k_timer_start(&session_expiry_timer, K_HOURS(cgms_inst.srt), K_NO_WAIT);
 
 	/* Start a session and notify the application. */
-	cgms_inst.local_start_time = k_uptime_get_32();
+	cgms_inst.local_start_time =
+		k_uptime_get_32() - (uint32_t)time_offset * 60 * MSEC_PER_SEC;
 	atomic_clear_bit(&cgms_inst.status, CGMS_STATUS_POS_SESSION_STOPPED);
 	if (cgms_inst.cb.session_state_changed) {
 		cgms_inst.cb.session_state_changed(true);
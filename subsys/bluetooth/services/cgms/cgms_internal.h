@@ -9,6 +9,7 @@
 
 #include <zephyr/types.h>
 #include <zephyr/bluetooth/bluetooth.h>
+#include <zephyr/bluetooth/gatt.h>
 #include <bluetooth/services/cgms.h>
 
 #ifdef __cplusplus
@@ -141,8 +142,11 @@ int cgms_racp_recv_request(struct bt_conn *peer, const uint8_t *req_data, uint16
 /* Function for sending RACP response. */
 int cgms_racp_send_response(struct bt_conn *peer, struct net_buf_simple *rsp);
 
-/* Function for sending RACP records. */
-int cgms_racp_send_record(struct bt_conn *peer, struct cgms_meas *entry);
+/* Function for sending RACP records.
+ * The done callback is called when the record has been transmitted.
+ */
+int cgms_racp_send_record(struct bt_conn *peer, struct cgms_meas *entry,
+			bt_gatt_complete_func_t done);
 
 /* Function for retrieving the newest RACP records. */
 int cgms_racp_meas_get_latest(struct cgms_meas *meas);
@@ -150,10 +154,44 @@ int cgms_racp_meas_get_latest(struct cgms_meas *meas);
 /* Function for adding RACP records. */
 int cgms_racp_meas_add(struct cgms_meas meas);
 
+/* Function for starting a session of the given run time in minutes.
+ * The time offsets of the session continue from the latest record. The records are deleted
+ * and the time offsets start from zero if the time offsets of the session would not fit
+ * into 16 bits.
+ */
+int cgms_racp_session_start(uint32_t run_time, uint16_t *time_offset);
+
 /* Function for initializing RACP module.
  * It must be called before using any RACP function.
  */
-void cgms_racp_init(void);
+int cgms_racp_init(void);
+
+/* Function for initializing the measurement record storage.
+ * The records kept by the storage backend are restored.
+ */
+int cgms_storage_init(void);
+
+/* Function for appending a record to the storage.
+ * The oldest records are dropped when the storage is full.
+ */
+int cgms_storage_append(const struct cgms_meas *meas);
+
+/* Function for reading the record with the given identifier.
+ * Records are identified by consecutive numbers in the order they were added.
+ * Returns -ENOENT if the record has been dropped or was not added yet.
+ */
+int cgms_storage_get(uint32_t id, struct cgms_meas *meas);
+
+/* Function for getting the identifier of the oldest record and
+ * the identifier that the next added record will get.
+ * The storage is empty if both are equal.
+ */
+void cgms_storage_ids_get(uint32_t *first_id, uint32_t *next_id);
+
+/* Function for deleting all records from the storage.
+ * The identifiers of the records added afterwards continue from the deleted ones.
+ */
+int cgms_storage_clear(void);
 
 #ifdef __cplusplus
 }
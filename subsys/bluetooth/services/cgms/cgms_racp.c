@@ -5,7 +5,7 @@
  */
 #include <zephyr/types.h>
 #include <zephyr/kernel.h>
-#include <zephyr/sys/slist.h>
+#include <zephyr/sys/atomic.h>
 #include <string.h>
 #include <zephyr/logging/log.h>
 
@@ -21,8 +21,13 @@ LOG_MODULE_DECLARE(cgms, CONFIG_BT_CGMS_LOG_LEVEL);
 #define RACP_Q_PRIORITY 1
 K_THREAD_STACK_DEFINE(racp_q_stack_area, RACP_Q_STACK_SIZE);
 
-/* The number of measurement that can be stored */
-#define RECORD_NUM       CONFIG_BT_CGMS_MAX_MEASUREMENT_RECORD
+/* Maximum number of record notifications queued in the Bluetooth stack. */
+#define RACP_NOTIFY_MAX_PENDING CONFIG_BT_CGMS_RACP_NOTIFY_MAX_PENDING
+/* Time to wait for a queued record notification to be transmitted. */
+#define RACP_NOTIFY_TIMEOUT K_SECONDS(5)
+/* Time to wait before retrying a notification when the stack is out of buffers. */
+#define RACP_NOTIFY_RETRY_DELAY K_MSEC(10)
+#define RACP_NOTIFY_RETRY_MAX 100
 
 /**@brief Record Access Control Point opcodes. */
 enum racp_opcode {
@@ -67,13 +72,6 @@ enum racp_rsp_code {
 	RACP_RESPONSE_OPERAND_UNSUPPORTED = 9,
 };
 
-/* structure of a record in db  */
-struct cgms_meas_db_entry {
-	sys_snode_t node;
-	bool used;
-	struct cgms_meas meas;
-};
-
 /** structure of racp task */
 struct racp_task {
 	struct k_work item;
@@ -82,26 +80,22 @@ struct racp_task {
 	uint8_t req_buf[CGMS_RACP_LENGTH];
 };
 
-static struct cgms_meas_db_entry cgms_meas_db_entry_pool[RECORD_NUM];
-
-static struct k_mutex lock;
+/** RACP procedure state */
+enum racp_state {
+	/* A procedure has been requested and has not completed yet. */
+	RACP_STATE_BUSY,
+	/* The client requested to abort the procedure in progress. */
+	RACP_STATE_ABORT,
+};
 
-static sys_slist_t database;
+static atomic_t racp_state;
 
 static struct k_work_q racp_work_q;
 
 static struct racp_task report_record_task;
 
-static struct cgms_meas_db_entry *entry_alloc(void)
-{
-	for (int i = 0; i < ARRAY_SIZE(cgms_meas_db_entry_pool); i++) {
-		if (!cgms_meas_db_entry_pool[i].used) {
-			cgms_meas_db_entry_pool[i].used = true;
-			return &cgms_meas_db_entry_pool[i];
-		}
-	}
-	return NULL;
-}
+/* Limits the number of record notifications queued in the Bluetooth stack. */
+static struct k_sem notify_sem;
 
 static int generic_handler(struct bt_conn *peer, uint8_t opcode, uint8_t response_code)
 {
@@ -115,238 +109,247 @@ static int generic_handler(struct bt_conn *peer, uint8_t opcode, uint8_t respons
 	return cgms_racp_send_response(peer, &rsp);
 }
 
-static int report_recs_all_handler(struct bt_conn *peer)
+/* Finds the first record with a time offset greater than or equal to the given one,
+ * or greater than the given one if upper is set. The time offsets of the records never
+ * decrease, so the search is a binary search over the record ids.
+ */
+static int time_offset_search(uint16_t time_offset, bool upper,
+			uint32_t first_id, uint32_t next_id, uint32_t *id)
 {
 	int rc;
-	struct cgms_meas_db_entry *entry;
-	sys_snode_t *record_node;
+	uint32_t mid;
+	struct cgms_meas meas;
 
-	/* Check if database is empty */
-	if (sys_slist_is_empty(&database)) {
-		return generic_handler(peer, RACP_OPCODE_REPORT_RECS,
-				RACP_RESPONSE_NO_RECORDS_FOUND);
-	}
+	while (first_id != next_id) {
+		mid = first_id + (next_id - first_id) / 2;
 
-	SYS_SLIST_FOR_EACH_NODE(&database, record_node) {
-		entry = CONTAINER_OF(record_node, struct cgms_meas_db_entry, node);
-		rc = cgms_racp_send_record(peer, &entry->meas);
-		if (rc != 0) {
-			LOG_WRN("Error occurs when transmitting record: %d", rc);
-			return generic_handler(peer, RACP_OPCODE_REPORT_RECS,
-					RACP_RESPONSE_PROCEDURE_NOT_DONE);
+		rc = cgms_storage_get(mid, &meas);
+		if (rc == -ENOENT) {
+			/* The record has been dropped to make room for new ones. */
+			first_id = mid + 1;
+			continue;
+		} else if (rc != 0) {
+			return rc;
 		}
 
+		if ((meas.time_offset < time_offset) ||
+		    (upper && (meas.time_offset == time_offset))) {
+			first_id = mid + 1;
+		} else {
+			next_id = mid;
+		}
 	}
 
-	return generic_handler(peer, RACP_OPCODE_REPORT_RECS, RACP_RESPONSE_SUCCESS);
+	*id = first_id;
+
+	return 0;
 }
 
-static int report_recs_greater_or_equal_handler(struct bt_conn *peer,
-					struct net_buf_simple *operand)
+/* Parses the time offset operand of the request. */
+static enum racp_rsp_code operand_parse(struct net_buf_simple *operand, uint16_t *min,
+				uint16_t *max, bool range)
 {
-	int rc;
 	enum racp_operand_filter filter;
-	uint16_t time_offset_limit;
-	struct cgms_meas_db_entry *entry;
-	sys_snode_t *record_node;
 
-	/* In this case, the length of operand is at least 3 bytes,
-	 * 1 for filter type, another 2 for filter value.
-	 */
-	if (operand->len < 3) {
-		return generic_handler(peer, RACP_OPCODE_REPORT_RECS,
-				RACP_RESPONSE_INVALID_OPERAND);
+	/* The operand is 1 byte for filter type, and 2 bytes for each filter value. */
+	if (operand->len < (range ? 5 : 3)) {
+		return RACP_RESPONSE_INVALID_OPERAND;
 	}
 
 	filter = net_buf_simple_pull_u8(operand);
 	if (filter != RACP_OPERAND_FILTER_TYPE_TIME_OFFSET) {
-		return generic_handler(peer, RACP_OPCODE_REPORT_RECS,
-				RACP_RESPONSE_OPERAND_UNSUPPORTED);
-	}
-
-	time_offset_limit = net_buf_simple_pull_le16(operand);
-
-	/* Check if database is empty */
-	if (sys_slist_is_empty(&database)) {
-		return generic_handler(peer, RACP_OPCODE_REPORT_RECS,
-				RACP_RESPONSE_NO_RECORDS_FOUND);
-	}
-
-	entry = CONTAINER_OF(sys_slist_peek_tail(&database), struct cgms_meas_db_entry, node);
-	/* If the latest one has a smaller time offset than threshold, no record is found */
-	if (entry->meas.time_offset < time_offset_limit) {
-		return generic_handler(peer, RACP_OPCODE_REPORT_RECS,
-				RACP_RESPONSE_NO_RECORDS_FOUND);
-	}
-
-	SYS_SLIST_FOR_EACH_NODE(&database, record_node) {
-		entry = CONTAINER_OF(record_node, struct cgms_meas_db_entry, node);
-		if (entry->meas.time_offset >= time_offset_limit) {
-			rc = cgms_racp_send_record(peer, &entry->meas);
-			if (rc != 0) {
-				LOG_WRN("Error occurs when transmitting record: %d", rc);
-				return generic_handler(peer, RACP_OPCODE_REPORT_RECS,
-						RACP_RESPONSE_PROCEDURE_NOT_DONE);
-			}
-		}
+		return RACP_RESPONSE_OPERAND_UNSUPPORTED;
 	}
 
-	return generic_handler(peer, RACP_OPCODE_REPORT_RECS, RACP_RESPONSE_SUCCESS);
-}
-
-static int report_recs_first_handler(struct bt_conn *peer)
-{
-	int rc;
-	struct cgms_meas_db_entry *entry;
-
-	if (sys_slist_is_empty(&database)) {
-		return generic_handler(peer, RACP_OPCODE_REPORT_RECS,
-				RACP_RESPONSE_NO_RECORDS_FOUND);
-	}
+	*min = net_buf_simple_pull_le16(operand);
+	*max = range ? net_buf_simple_pull_le16(operand) : *min;
 
-	entry = CONTAINER_OF(sys_slist_peek_head(&database), struct cgms_meas_db_entry, node);
-	rc = cgms_racp_send_record(peer, &entry->meas);
-	if (rc != 0) {
-		LOG_WRN("Error occurs when transmitting record: %d", rc);
-		return generic_handler(peer, RACP_OPCODE_REPORT_RECS,
-				RACP_RESPONSE_PROCEDURE_NOT_DONE);
+	if (*min > *max) {
+		return RACP_RESPONSE_INVALID_OPERAND;
 	}
 
-	return generic_handler(peer, RACP_OPCODE_REPORT_RECS, RACP_RESPONSE_SUCCESS);
+	return RACP_RESPONSE_SUCCESS;
 }
 
-static int report_recs_last_handler(struct bt_conn *peer)
-{
-	int rc;
-	struct cgms_meas_db_entry *entry;
-
-	if (sys_slist_is_empty(&database)) {
-		return generic_handler(peer, RACP_OPCODE_REPORT_RECS,
-				RACP_RESPONSE_NO_RECORDS_FOUND);
-	}
-
-	entry = CONTAINER_OF(sys_slist_peek_tail(&database), struct cgms_meas_db_entry, node);
-	rc = cgms_racp_send_record(peer, &entry->meas);
-	if (rc != 0) {
-		LOG_WRN("Error occurs when transmitting record: %d", rc);
-		return generic_handler(peer, RACP_OPCODE_REPORT_RECS,
-				RACP_RESPONSE_PROCEDURE_NOT_DONE);
-	}
-
-	return generic_handler(peer, RACP_OPCODE_REPORT_RECS, RACP_RESPONSE_SUCCESS);
-}
-
-static int report_recs_handler(struct bt_conn *peer, struct net_buf_simple *operators)
+/* Selects the ids of the records matching the operator and operand of the request.
+ * The selected records are the ones from start_id up to, but not including, end_id.
+ */
+static enum racp_rsp_code records_select(struct net_buf_simple *req,
+				uint32_t *start_id, uint32_t *end_id)
 {
 	int rc = 0;
+	enum racp_rsp_code rsp_code;
 	enum racp_operator operator;
+	uint32_t first_id;
+	uint32_t next_id;
+	uint16_t min;
+	uint16_t max;
 
-	if (operators->len == 0) {
-		return -ENODATA;
+	if (req->len < 1) {
+		return RACP_RESPONSE_INVALID_OPERATOR;
 	}
 
-	operator = net_buf_simple_pull_u8(operators);
+	cgms_storage_ids_get(&first_id, &next_id);
+	*start_id = first_id;
+	*end_id = next_id;
+
+	operator = net_buf_simple_pull_u8(req);
 	switch (operator) {
 	case RACP_OPERATOR_ALL:
-		rc = report_recs_all_handler(peer);
+		break;
+	case RACP_OPERATOR_LESS_OR_EQUAL:
+		rsp_code = operand_parse(req, &min, &max, false);
+		if (rsp_code != RACP_RESPONSE_SUCCESS) {
+			return rsp_code;
+		}
+		rc = time_offset_search(max, true, first_id, next_id, end_id);
 		break;
 	case RACP_OPERATOR_GREATER_OR_EQUAL:
-		rc = report_recs_greater_or_equal_handler(peer, operators);
+		rsp_code = operand_parse(req, &min, &max, false);
+		if (rsp_code != RACP_RESPONSE_SUCCESS) {
+			return rsp_code;
+		}
+		rc = time_offset_search(min, false, first_id, next_id, start_id);
+		break;
+	case RACP_OPERATOR_RANGE:
+		rsp_code = operand_parse(req, &min, &max, true);
+		if (rsp_code != RACP_RESPONSE_SUCCESS) {
+			return rsp_code;
+		}
+		rc = time_offset_search(min, false, first_id, next_id, start_id);
+		if (rc == 0) {
+			rc = time_offset_search(max, true, *start_id, next_id, end_id);
+		}
 		break;
 	case RACP_OPERATOR_FIRST:
-		rc = report_recs_first_handler(peer);
+		if (first_id != next_id) {
+			*end_id = first_id + 1;
+		}
 		break;
 	case RACP_OPERATOR_LAST:
-		rc = report_recs_last_handler(peer);
+		if (first_id != next_id) {
+			*start_id = next_id - 1;
+		}
 		break;
+	case RACP_OPERATOR_NULL:
+		return RACP_RESPONSE_INVALID_OPERATOR;
 	default:
-		rc = generic_handler(peer, RACP_OPCODE_REPORT_RECS,
-				RACP_RESPONSE_OPERATOR_UNSUPPORTED);
-		break;
+		return RACP_RESPONSE_OPERATOR_UNSUPPORTED;
 	}
 
-	return rc;
+	if (rc != 0) {
+		LOG_WRN("Error occurs when searching records: %d", rc);
+		return RACP_RESPONSE_PROCEDURE_NOT_DONE;
+	}
+
+	return RACP_RESPONSE_SUCCESS;
 }
 
-static int report_num_recs_all_handler(struct bt_conn *peer)
+static void record_sent(struct bt_conn *conn, void *user_data)
 {
-	uint16_t count = 0;
-	sys_snode_t *record_node;
+	k_sem_give(&notify_sem);
+}
 
-	NET_BUF_SIMPLE_DEFINE(rsp, CGMS_RACP_LENGTH);
+static int record_send(struct bt_conn *peer, struct cgms_meas *meas)
+{
+	int rc;
 
-	if (!sys_slist_is_empty(&database)) {
-		SYS_SLIST_FOR_EACH_NODE(&database, record_node) {
-			count++;
+	rc = k_sem_take(&notify_sem, RACP_NOTIFY_TIMEOUT);
+	if (rc != 0) {
+		return -ETIMEDOUT;
+	}
+
+	for (int i = 0; i < RACP_NOTIFY_RETRY_MAX; i++) {
+		rc = cgms_racp_send_record(peer, meas, record_sent);
+		if ((rc != -ENOMEM) || atomic_test_bit(&racp_state, RACP_STATE_ABORT)) {
+			break;
 		}
+		k_sleep(RACP_NOTIFY_RETRY_DELAY);
 	}
 
-	net_buf_simple_add_u8(&rsp, RACP_OPCODE_NUM_RECS_RESPONSE);
-	net_buf_simple_add_u8(&rsp, RACP_OPERATOR_NULL);
-	net_buf_simple_add_le16(&rsp, count);
+	if (rc != 0) {
+		k_sem_give(&notify_sem);
+	}
 
-	return cgms_racp_send_response(peer, &rsp);
+	return rc;
 }
 
-static int report_num_recs_greater_or_equal_handler(struct bt_conn *peer,
-				struct net_buf_simple *operand)
+/* Sends the selected records one by one, so that the records are read from the storage
+ * only when the Bluetooth stack can take them, and the client can abort the procedure.
+ */
+static enum racp_rsp_code records_stream(struct bt_conn *peer, uint32_t start_id,
+				uint32_t end_id)
 {
-	enum racp_operand_filter filter;
-	uint16_t time_offset_limit;
-	uint16_t count = 0;
-	struct cgms_meas_db_entry *entry;
-	sys_snode_t *record_node;
-
-	NET_BUF_SIMPLE_DEFINE(rsp, CGMS_RACP_LENGTH);
+	int rc;
+	struct cgms_meas meas;
 
-	if (operand->len < 3) {
-		return generic_handler(peer, RACP_OPCODE_REPORT_RECS,
-				RACP_RESPONSE_INVALID_OPERAND);
-	}
+	k_sem_init(&notify_sem, RACP_NOTIFY_MAX_PENDING, RACP_NOTIFY_MAX_PENDING);
 
-	filter = net_buf_simple_pull_u8(operand);
-	if (filter != RACP_OPERAND_FILTER_TYPE_TIME_OFFSET) {
-		return generic_handler(peer, RACP_OPCODE_REPORT_RECS,
-			RACP_RESPONSE_OPERAND_UNSUPPORTED);
-	}
+	for (uint32_t id = start_id; id != end_id; id++) {
+		if (atomic_test_bit(&racp_state, RACP_STATE_ABORT)) {
+			LOG_INF("RACP: procedure aborted");
+			return RACP_RESPONSE_PROCEDURE_NOT_DONE;
+		}
 
-	time_offset_limit = net_buf_simple_pull_le16(operand);
+		rc = cgms_storage_get(id, &meas);
+		if (rc == -ENOENT) {
+			/* The record has been dropped to make room for new ones. */
+			continue;
+		} else if (rc == 0) {
+			rc = record_send(peer, &meas);
+		}
 
-	if (!sys_slist_is_empty(&database)) {
-		SYS_SLIST_FOR_EACH_NODE(&database, record_node) {
-			entry = CONTAINER_OF(record_node, struct cgms_meas_db_entry, node);
-			if (entry->meas.time_offset >= time_offset_limit) {
-				count++;
-			}
+		if (rc != 0) {
+			LOG_WRN("Error occurs when transmitting record: %d", rc);
+			return RACP_RESPONSE_PROCEDURE_NOT_DONE;
 		}
 	}
 
-	net_buf_simple_add_u8(&rsp, RACP_OPCODE_NUM_RECS_RESPONSE);
-	net_buf_simple_add_u8(&rsp, RACP_OPERATOR_NULL);
-	net_buf_simple_add_le16(&rsp, count);
-
-	return cgms_racp_send_response(peer, &rsp);
+	return RACP_RESPONSE_SUCCESS;
 }
 
-static int report_num_recs_handler(struct bt_conn *peer, struct net_buf_simple *operators)
+static enum racp_rsp_code report_recs_handler(struct bt_conn *peer, struct net_buf_simple *req)
 {
-	enum racp_operator operator;
+	enum racp_rsp_code rsp_code;
+	uint32_t start_id;
+	uint32_t end_id;
 
-	if (operators->len < 1) {
-		return generic_handler(peer, RACP_OPCODE_REPORT_NUM_RECS,
-			RACP_RESPONSE_INVALID_OPERATOR);
+	rsp_code = records_select(req, &start_id, &end_id);
+	if (rsp_code != RACP_RESPONSE_SUCCESS) {
+		return rsp_code;
 	}
 
-	operator = net_buf_simple_pull_u8(operators);
-	if (operator == RACP_OPERATOR_ALL) {
-		return report_num_recs_all_handler(peer);
+	if (start_id == end_id) {
+		return RACP_RESPONSE_NO_RECORDS_FOUND;
 	}
-	if (operator == RACP_OPERATOR_GREATER_OR_EQUAL) {
-		return report_num_recs_greater_or_equal_handler(peer, operators);
+
+	return records_stream(peer, start_id, end_id);
+}
+
+static int report_num_recs_handler(struct bt_conn *peer, struct net_buf_simple *req)
+{
+	enum racp_rsp_code rsp_code;
+	uint32_t start_id;
+	uint32_t end_id;
+
+	NET_BUF_SIMPLE_DEFINE(rsp, CGMS_RACP_LENGTH);
+
+	rsp_code = records_select(req, &start_id, &end_id);
+	if (rsp_code != RACP_RESPONSE_SUCCESS) {
+		return generic_handler(peer, RACP_OPCODE_REPORT_NUM_RECS, rsp_code);
 	}
 
-	return generic_handler(peer, RACP_OPCODE_REPORT_NUM_RECS,
-			RACP_RESPONSE_OPERATOR_UNSUPPORTED);
+	net_buf_simple_add_u8(&rsp, RACP_OPCODE_NUM_RECS_RESPONSE);
+	net_buf_simple_add_u8(&rsp, RACP_OPERATOR_NULL);
+	net_buf_simple_add_le16(&rsp, MIN(end_id - start_id, UINT16_MAX));
+
+	return cgms_racp_send_response(peer, &rsp);
+}
+
+static int abort_response_send(struct bt_conn *peer)
+{
+	LOG_INF("RACP: work aborted");
+	return generic_handler(peer, RACP_OPCODE_ABORT_OPERATION, RACP_RESPONSE_SUCCESS);
 }
 
 static void racp_task_handler(struct k_work *work_item)
@@ -354,34 +357,43 @@ static void racp_task_handler(struct k_work *work_item)
 	int rc;
 	struct racp_task *task;
 	enum racp_opcode opcode;
+	enum racp_rsp_code rsp_code;
 
 	task = CONTAINER_OF(work_item, struct racp_task, item);
 	opcode = net_buf_simple_pull_u8(&task->req);
 
-	if (k_mutex_lock(&lock, K_NO_WAIT) == 0) {
-		switch (opcode) {
-		case RACP_OPCODE_REPORT_RECS:
-			rc = report_recs_handler(task->peer,
-				&task->req);
-			break;
-		case RACP_OPCODE_REPORT_NUM_RECS:
-			rc = report_num_recs_handler(task->peer,
-				&task->req);
-			break;
-		default:
-			rc = generic_handler(task->peer, opcode,
-					RACP_RESPONSE_OPCODE_UNSUPPORTED);
-			break;
+	switch (opcode) {
+	case RACP_OPCODE_REPORT_RECS:
+		rsp_code = report_recs_handler(task->peer, &task->req);
+		/* An aborted procedure is completed by the response to the abortion. */
+		if (atomic_test_and_clear_bit(&racp_state, RACP_STATE_ABORT)) {
+			rc = abort_response_send(task->peer);
+		} else {
+			rc = generic_handler(task->peer, opcode, rsp_code);
 		}
-		k_mutex_unlock(&lock);
-	} else {
-		rc = -EBUSY;
+		break;
+	case RACP_OPCODE_REPORT_NUM_RECS:
+		rc = report_num_recs_handler(task->peer, &task->req);
+		break;
+	default:
+		rc = generic_handler(task->peer, opcode, RACP_RESPONSE_OPCODE_UNSUPPORTED);
+		break;
+	}
+
+	atomic_clear_bit(&racp_state, RACP_STATE_BUSY);
+
+	/* The abortion was requested when the procedure was already completing. */
+	if (atomic_test_and_clear_bit(&racp_state, RACP_STATE_ABORT)) {
+		rc = abort_response_send(task->peer);
+	}
+
+	if (rc != 0) {
+		LOG_WRN("RACP: cannot send response: %d", rc);
 	}
 }
 
 static int abort_handler(struct bt_conn *peer, struct net_buf_simple *operators)
 {
-	int rc;
 	enum racp_operator operator;
 
 	/* Check if operator exists */
@@ -398,17 +410,16 @@ static int abort_handler(struct bt_conn *peer, struct net_buf_simple *operators)
 			RACP_RESPONSE_INVALID_OPERATOR);
 	}
 
-	rc = k_work_cancel(&report_record_task.item);
-	if (rc == 0) {
-		LOG_INF("RACP: work aborted");
-		rc = generic_handler(peer, RACP_OPCODE_ABORT_OPERATION,
-		RACP_RESPONSE_SUCCESS);
-	} else {
-		LOG_WRN("RACP: cannot abort work");
-		rc = generic_handler(peer, RACP_OPCODE_ABORT_OPERATION,
-		RACP_RESPONSE_ABORT_FAILED);
+	/* The procedure in progress stops before sending the next record, and responds to
+	 * the abortion. If no procedure is in progress, the response is sent here.
+	 */
+	atomic_set_bit(&racp_state, RACP_STATE_ABORT);
+	if (!atomic_test_bit(&racp_state, RACP_STATE_BUSY) &&
+	    atomic_test_and_clear_bit(&racp_state, RACP_STATE_ABORT)) {
+		return abort_response_send(peer);
 	}
-	return rc;
+
+	return 0;
 }
 
 int cgms_racp_recv_request(struct bt_conn *peer, const uint8_t *req_data, uint16_t req_len)
@@ -423,6 +434,11 @@ int cgms_racp_recv_request(struct bt_conn *peer, const uint8_t *req_data, uint16
 		return -ENODATA;
 	}
 
+	if (req_len > sizeof(report_record_task.req_buf)) {
+		LOG_INF("RACP: Command too long");
+		return -EMSGSIZE;
+	}
+
 	net_buf_simple_init_with_data(&req, (void *)req_data, req_len);
 
 	/* All tasks are executed in system workqueue except abortion.
@@ -433,69 +449,95 @@ int cgms_racp_recv_request(struct bt_conn *peer, const uint8_t *req_data, uint16
 		return abort_handler(peer, &req);
 	}
 
+	if (atomic_test_and_set_bit(&racp_state, RACP_STATE_BUSY)) {
+		LOG_INF("RACP: procedure already in progress");
+		return -EBUSY;
+	}
+
 	/* For other requests, prepare the data and submit to workqueue. */
 	report_record_task.peer = peer;
 	memcpy(report_record_task.req_buf, req_data, req_len);
 	net_buf_simple_init_with_data(&report_record_task.req, report_record_task.req_buf, req_len);
 	rc = k_work_submit_to_queue(&racp_work_q, &report_record_task.item);
 	LOG_INF("RACP: work submission %s", rc > 0 ? "done" : "failed");
+	if (rc < 0) {
+		atomic_clear_bit(&racp_state, RACP_STATE_BUSY);
+	}
 	return rc;
 }
 
 int cgms_racp_meas_add(struct cgms_meas meas)
 {
 	int rc;
-	struct cgms_meas_db_entry *entry;
+	struct cgms_meas latest;
 
-	if (k_mutex_lock(&lock, K_NO_WAIT) == 0) {
-		entry = entry_alloc();
-		if (entry == NULL) {
-			entry = CONTAINER_OF(sys_slist_get(&database),
-					struct cgms_meas_db_entry, node);
+	/* The time offsets of the records must not decrease, as they are searched in order. */
+	rc = cgms_racp_meas_get_latest(&latest);
+	if (rc == 0) {
+		if (meas.time_offset < latest.time_offset) {
+			LOG_WRN("Time offset older than the latest record");
+			return -EINVAL;
 		}
-		memcpy(&entry->meas, &meas, sizeof(meas));
-		sys_slist_append(&database, &entry->node);
-		k_mutex_unlock(&lock);
-		rc = 0;
-	} else {
-		rc = -EBUSY;
+	} else if (rc != -ENODATA) {
+		return rc;
 	}
 
-	return rc;
+	return cgms_storage_append(&meas);
 }
 
-int cgms_racp_meas_get_latest(struct cgms_meas *meas)
+int cgms_racp_session_start(uint32_t run_time, uint16_t *time_offset)
 {
 	int rc;
-	struct cgms_meas_db_entry *entry;
-
-	if (k_mutex_lock(&lock, K_NO_WAIT) == 0) {
-		if (!sys_slist_is_empty(&database)) {
-			entry = CONTAINER_OF(sys_slist_peek_tail(&database),
-				struct cgms_meas_db_entry, node);
-			memcpy(meas, &entry->meas, sizeof(struct cgms_meas));
-			rc = 0;
-		} else {
-			rc = -ENODATA;
-		}
-		k_mutex_unlock(&lock);
-	} else {
-		rc = -EBUSY;
+	struct cgms_meas latest;
+
+	*time_offset = 0;
+
+	rc = cgms_racp_meas_get_latest(&latest);
+	if (rc == -ENODATA) {
+		return 0;
+	} else if (rc) {
+		return rc;
 	}
 
-	return rc;
+	if ((uint32_t)latest.time_offset + run_time > UINT16_MAX) {
+		LOG_INF("Time offset of the session out of range, deleting the records");
+		return cgms_storage_clear();
+	}
+
+	*time_offset = latest.time_offset;
+
+	return 0;
 }
 
-void cgms_racp_init(void)
+int cgms_racp_meas_get_latest(struct cgms_meas *meas)
 {
-	memset(&cgms_meas_db_entry_pool, 0, sizeof(cgms_meas_db_entry_pool));
+	uint32_t first_id;
+	uint32_t next_id;
 
-	sys_slist_init(&database);
+	cgms_storage_ids_get(&first_id, &next_id);
+	if (first_id == next_id) {
+		return -ENODATA;
+	}
+
+	return cgms_storage_get(next_id - 1, meas);
+}
 
-	k_mutex_init(&lock);
+int cgms_racp_init(void)
+{
+	int rc;
+
+	rc = cgms_storage_init();
+	if (rc) {
+		return rc;
+	}
+
+	atomic_clear(&racp_state);
+	k_sem_init(&notify_sem, RACP_NOTIFY_MAX_PENDING, RACP_NOTIFY_MAX_PENDING);
 
 	k_work_queue_init(&racp_work_q);
 	k_work_queue_start(&racp_work_q, racp_q_stack_area,
 			K_THREAD_STACK_SIZEOF(racp_q_stack_area), RACP_Q_PRIORITY, NULL);
 	k_work_init(&report_record_task.item, racp_task_handler);
+
+	return 0;
 }
@@ -0,0 +1,538 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/types.h>
+#include <zephyr/kernel.h>
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/sys/crc.h>
+#include <string.h>
+#include <errno.h>
+#include <zephyr/logging/log.h>
+
+#include "cgms_internal.h"
+
+LOG_MODULE_DECLARE(cgms, CONFIG_BT_CGMS_LOG_LEVEL);
+
+/* The records are kept in a circular log of flash sectors. Each sector starts with a header
+ * that holds the id of its first record, followed by slots written with the records in
+ * the order they are added. A sector is erased and gets a new header when the log moves
+ * to it, so the records of a sector are always a prefix of its slots.
+ *
+ * A record that was being written during a power loss has an invalid checksum. It is
+ * discarded on initialization and the log moves to the next sector, as the slot cannot
+ * be written again without erasing the sector.
+ */
+
+#define STORAGE_PARTITION_ID FIXED_PARTITION_ID(cgms_storage)
+#define SECTOR_MAX           CONFIG_BT_CGMS_STORAGE_FLASH_SECTOR_MAX
+
+#define SECTOR_MAGIC         0x534d4743
+
+/* Largest supported slot, the record rounded up to the flash write block size. */
+#define SLOT_SIZE_MAX        32
+
+struct sector_hdr {
+	uint32_t magic;
+	/* Id of the first record in the sector. */
+	uint32_t first_id;
+	uint32_t crc;
+} __packed;
+
+struct record {
+	uint16_t time_offset;
+	uint16_t glucose_concentration;
+	uint8_t flag;
+	uint8_t status;
+	uint8_t calib_temp;
+	uint8_t warning;
+	uint32_t crc;
+} __packed;
+
+BUILD_ASSERT(sizeof(struct sector_hdr) == sizeof(struct record));
+BUILD_ASSERT(sizeof(struct record) <= SLOT_SIZE_MAX);
+
+struct sector_info {
+	/* Id of the first record in the sector. */
+	uint32_t first_id;
+	/* Number of valid records in the sector. */
+	uint16_t count;
+};
+
+static const struct flash_area *fa;
+static size_t sector_size;
+static uint16_t sector_cnt;
+static size_t slot_size;
+static uint16_t slots_per_sector;
+static uint8_t erased_val;
+
+static struct sector_info sectors[SECTOR_MAX];
+/* Sectors holding the log, in the order of their records, starting at the oldest one. */
+static uint16_t oldest_sector;
+static uint16_t used_sector_cnt;
+/* The newest sector cannot take more records after a failed write. */
+static bool head_sealed;
+static uint32_t next_record_id;
+
+static K_MUTEX_DEFINE(storage_lock);
+
+static uint16_t sector_idx(uint16_t pos)
+{
+	return (oldest_sector + pos) % sector_cnt;
+}
+
+static off_t slot_off(uint16_t sector, uint16_t slot)
+{
+	/* The first slot of a sector holds the header. */
+	return (off_t)sector * sector_size + (off_t)(slot + 1) * slot_size;
+}
+
+static int slot_write(off_t off, const void *data, size_t len)
+{
+	uint8_t buf[SLOT_SIZE_MAX];
+
+	memset(buf, erased_val, slot_size);
+	memcpy(buf, data, len);
+
+	return flash_area_write(fa, off, buf, slot_size);
+}
+
+static int slot_erased(off_t off, bool *erased)
+{
+	int rc;
+	uint8_t buf[SLOT_SIZE_MAX];
+
+	rc = flash_area_read(fa, off, buf, slot_size);
+	if (rc) {
+		return rc;
+	}
+
+	*erased = true;
+	for (size_t i = 0; i < slot_size; i++) {
+		if (buf[i] != erased_val) {
+			*erased = false;
+			break;
+		}
+	}
+
+	return 0;
+}
+
+static int record_read(uint16_t sector, uint16_t slot, struct cgms_meas *meas)
+{
+	int rc;
+	struct record rec;
+
+	rc = flash_area_read(fa, slot_off(sector, slot), &rec, sizeof(rec));
+	if (rc) {
+		return rc;
+	}
+
+	if (rec.crc != crc32_ieee((const uint8_t *)&rec, offsetof(struct record, crc))) {
+		return -EIO;
+	}
+
+	if (meas) {
+		meas->flag = rec.flag;
+		meas->glucose_concentration = rec.glucose_concentration;
+		meas->time_offset = rec.time_offset;
+		meas->sensor_status_annunciation.status = rec.status;
+		meas->sensor_status_annunciation.calib_temp = rec.calib_temp;
+		meas->sensor_status_annunciation.warning = rec.warning;
+	}
+
+	return 0;
+}
+
+static int sector_hdr_read(uint16_t sector, uint32_t *first_id)
+{
+	int rc;
+	struct sector_hdr hdr;
+
+	rc = flash_area_read(fa, (off_t)sector * sector_size, &hdr, sizeof(hdr));
+	if (rc) {
+		return rc;
+	}
+
+	if ((hdr.magic != SECTOR_MAGIC) ||
+	    (hdr.crc != crc32_ieee((const uint8_t *)&hdr, offsetof(struct sector_hdr, crc)))) {
+		return -ENOENT;
+	}
+
+	*first_id = hdr.first_id;
+
+	return 0;
+}
+
+/* Counts the records of a sector. The written slots are a prefix of the sector, so the first
+ * erased slot is found with a binary search. Only the last written slot can be incomplete.
+ */
+static int sector_scan(uint16_t sector, uint16_t *count, bool *torn)
+{
+	int rc;
+	bool erased;
+	uint16_t lo = 0;
+	uint16_t hi = slots_per_sector;
+
+	while (lo < hi) {
+		uint16_t mid = lo + (hi - lo) / 2;
+
+		rc = slot_erased(slot_off(sector, mid), &erased);
+		if (rc) {
+			return rc;
+		}
+
+		if (erased) {
+			hi = mid;
+		} else {
+			lo = mid + 1;
+		}
+	}
+
+	*torn = false;
+	if (lo > 0) {
+		rc = record_read(sector, lo - 1, NULL);
+		if (rc == -EIO) {
+			*torn = true;
+			lo--;
+		} else if (rc) {
+			return rc;
+		}
+	}
+
+	*count = lo;
+
+	return 0;
+}
+
+static int sector_open(uint16_t sector)
+{
+	int rc;
+	struct sector_hdr hdr = {
+		.magic = SECTOR_MAGIC,
+		.first_id = next_record_id,
+	};
+
+	hdr.crc = crc32_ieee((const uint8_t *)&hdr, offsetof(struct sector_hdr, crc));
+
+	rc = flash_area_erase(fa, (off_t)sector * sector_size, sector_size);
+	if (rc) {
+		return rc;
+	}
+
+	return slot_write((off_t)sector * sector_size, &hdr, sizeof(hdr));
+}
+
+/* Prepares the newest sector for the next record, moving the log to a new sector if needed. */
+static int head_prepare(uint16_t *head)
+{
+	int rc;
+	uint16_t sector;
+
+	if (used_sector_cnt > 0) {
+		sector = sector_idx(used_sector_cnt - 1);
+
+		if (!head_sealed && (sectors[sector].count < slots_per_sector)) {
+			*head = sector;
+			return 0;
+		}
+
+		if (sectors[sector].count == 0) {
+			/* A sealed sector without records is reused. */
+			used_sector_cnt--;
+		} else {
+			sector = (sector + 1) % sector_cnt;
+		}
+	} else {
+		sector = oldest_sector;
+	}
+
+	if (used_sector_cnt == sector_cnt) {
+		LOG_DBG("Dropping %u oldest records", sectors[oldest_sector].count);
+		oldest_sector = (oldest_sector + 1) % sector_cnt;
+		used_sector_cnt--;
+	}
+
+	if (used_sector_cnt == 0) {
+		oldest_sector = sector;
+	}
+
+	/* The sector is part of the log from now on, so that a failed erase or header write
+	 * is retried with the same sector on the next append.
+	 */
+	used_sector_cnt++;
+	sectors[sector].first_id = next_record_id;
+	sectors[sector].count = 0;
+	head_sealed = true;
+
+	rc = sector_open(sector);
+	if (rc) {
+		LOG_ERR("Cannot open sector %u: %d", sector, rc);
+		return rc;
+	}
+
+	head_sealed = false;
+	*head = sector;
+
+	return 0;
+}
+
+int cgms_storage_append(const struct cgms_meas *meas)
+{
+	int rc;
+	uint16_t head;
+	struct record rec = {
+		.time_offset = meas->time_offset,
+		.glucose_concentration = meas->glucose_concentration,
+		.flag = meas->flag,
+		.status = meas->sensor_status_annunciation.status,
+		.calib_temp = meas->sensor_status_annunciation.calib_temp,
+		.warning = meas->sensor_status_annunciation.warning,
+	};
+
+	rec.crc = crc32_ieee((const uint8_t *)&rec, offsetof(struct record, crc));
+
+	k_mutex_lock(&storage_lock, K_FOREVER);
+
+	rc = head_prepare(&head);
+	if (rc) {
+		goto unlock;
+	}
+
+	rc = slot_write(slot_off(head, sectors[head].count), &rec, sizeof(rec));
+	if (rc) {
+		LOG_ERR("Cannot write record: %d", rc);
+		head_sealed = true;
+		goto unlock;
+	}
+
+	sectors[head].count++;
+	next_record_id++;
+
+unlock:
+	k_mutex_unlock(&storage_lock);
+
+	return rc;
+}
+
+int cgms_storage_get(uint32_t id, struct cgms_meas *meas)
+{
+	int rc;
+	uint16_t lo = 0;
+	uint16_t hi;
+	uint16_t sector;
+
+	k_mutex_lock(&storage_lock, K_FOREVER);
+
+	hi = used_sector_cnt;
+
+	/* Find the newest sector that starts at or before the record. */
+	while (lo < hi) {
+		uint16_t mid = lo + (hi - lo) / 2;
+
+		if (sectors[sector_idx(mid)].first_id <= id) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+
+	if (lo == 0) {
+		rc = -ENOENT;
+		goto unlock;
+	}
+
+	sector = sector_idx(lo - 1);
+	if ((id - sectors[sector].first_id) >= sectors[sector].count) {
+		rc = -ENOENT;
+		goto unlock;
+	}
+
+	rc = record_read(sector, id - sectors[sector].first_id, meas);
+
+unlock:
+	k_mutex_unlock(&storage_lock);
+
+	return rc;
+}
+
+void cgms_storage_ids_get(uint32_t *first_id, uint32_t *next_id)
+{
+	k_mutex_lock(&storage_lock, K_FOREVER);
+
+	*first_id = (used_sector_cnt > 0) ? sectors[oldest_sector].first_id : next_record_id;
+	*next_id = next_record_id;
+
+	k_mutex_unlock(&storage_lock);
+}
+
+int cgms_storage_clear(void)
+{
+	int rc = 0;
+
+	k_mutex_lock(&storage_lock, K_FOREVER);
+
+	/* The oldest sectors are erased first, so that the records left after a power loss
+	 * are still a valid log.
+	 */
+	while (used_sector_cnt > 0) {
+		rc = flash_area_erase(fa, (off_t)oldest_sector * sector_size, sector_size);
+		if (rc) {
+			LOG_ERR("Cannot erase sector %u: %d", oldest_sector, rc);
+			break;
+		}
+
+		oldest_sector = (oldest_sector + 1) % sector_cnt;
+		used_sector_cnt--;
+	}
+
+	head_sealed = false;
+
+	k_mutex_unlock(&storage_lock);
+
+	return rc;
+}
+
+static int storage_open(void)
+{
+	int rc;
+	uint32_t cnt = 1;
+	struct flash_sector fs;
+
+	rc = flash_area_open(STORAGE_PARTITION_ID, &fa);
+	if (rc) {
+		return rc;
+	}
+
+	/* Only the size of the first sector is needed, as the sectors of the partition
+	 * are expected to be of the same size.
+	 */
+	rc = flash_area_get_sectors(STORAGE_PARTITION_ID, &cnt, &fs);
+	if (rc && (rc != -ENOMEM)) {
+		return rc;
+	}
+
+	sector_size = fs.fs_size;
+	sector_cnt = MIN(fa->fa_size / sector_size, SECTOR_MAX);
+	slot_size = ROUND_UP(sizeof(struct record), flash_area_align(fa));
+	erased_val = flash_area_erased_val(fa);
+
+	if ((sector_cnt < 2) || (slot_size > SLOT_SIZE_MAX)) {
+		LOG_ERR("Unsupported storage partition layout");
+		return -EINVAL;
+	}
+
+	if ((sector_size / slot_size - 1) > UINT16_MAX) {
+		return -EDOM;
+	}
+	slots_per_sector = sector_size / slot_size - 1;
+
+	if (fa->fa_size / sector_size > SECTOR_MAX) {
+		LOG_WRN("Using %u sectors of the storage partition", sector_cnt);
+	}
+
+	return 0;
+}
+
+/* Restores the log. The newest sector has the largest first id, and the log continues
+ * backwards as long as the sectors are valid and their records precede the newer sector.
+ */
+static int storage_restore(void)
+{
+	int rc;
+	ATOMIC_DEFINE(valid, SECTOR_MAX) = {0};
+	bool torn;
+	uint16_t head = 0;
+	bool found = false;
+
+	for (uint16_t i = 0; i < sector_cnt; i++) {
+		rc = sector_hdr_read(i, &sectors[i].first_id);
+		if (rc && (rc != -ENOENT)) {
+			return rc;
+		}
+
+		if (rc == 0) {
+			atomic_set_bit(valid, i);
+		}
+
+		if ((rc == 0) && (!found || (sectors[i].first_id > sectors[head].first_id))) {
+			head = i;
+			found = true;
+		}
+	}
+
+	oldest_sector = 0;
+	used_sector_cnt = 0;
+	head_sealed = false;
+	next_record_id = 0;
+
+	if (!found) {
+		return 0;
+	}
+
+	rc = sector_scan(head, &sectors[head].count, &head_sealed);
+	if (rc) {
+		return rc;
+	}
+
+	if (head_sealed) {
+		LOG_WRN("Discarding incomplete record");
+	}
+
+	oldest_sector = head;
+	used_sector_cnt = 1;
+	next_record_id = sectors[head].first_id + sectors[head].count;
+
+	while (used_sector_cnt < sector_cnt) {
+		uint16_t sector = (oldest_sector + sector_cnt - 1) % sector_cnt;
+
+		if (!atomic_test_bit(valid, sector) ||
+		    (sectors[sector].first_id >= sectors[oldest_sector].first_id)) {
+			break;
+		}
+
+		rc = sector_scan(sector, &sectors[sector].count, &torn);
+		if (rc) {
+			return rc;
+		}
+
+		if ((sectors[sector].first_id + sectors[sector].count) !=
+		    sectors[oldest_sector].first_id) {
+			break;
+		}
+
+		oldest_sector = sector;
+		used_sector_cnt++;
+	}
+
+	return 0;
+}
+
+int cgms_storage_init(void)
+{
+	int rc;
+
+	k_mutex_lock(&storage_lock, K_FOREVER);
+
+	rc = storage_open();
+	if (rc) {
+		LOG_ERR("Cannot open storage partition: %d", rc);
+		goto unlock;
+	}
+
+	rc = storage_restore();
+	if (rc) {
+		LOG_ERR("Cannot restore records: %d", rc);
+		goto unlock;
+	}
+
+	LOG_INF("Restored %u records", next_record_id - ((used_sector_cnt > 0) ?
+					sectors[oldest_sector].first_id : next_record_id));
+
+unlock:
+	k_mutex_unlock(&storage_lock);
+
+	return rc;
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/types.h>
+#include <zephyr/kernel.h>
+#include <errno.h>
+
+#include "cgms_internal.h"
+
+/* The number of measurement that can be stored */
+#define RECORD_NUM       CONFIG_BT_CGMS_MAX_MEASUREMENT_RECORD
+
+/* The records are kept in a ring buffer, the record with a given id is at index id % RECORD_NUM. */
+static struct cgms_meas records[RECORD_NUM];
+static uint32_t records_first_id;
+static uint32_t records_next_id;
+
+static K_MUTEX_DEFINE(records_lock);
+
+int cgms_storage_append(const struct cgms_meas *meas)
+{
+	k_mutex_lock(&records_lock, K_FOREVER);
+
+	records[records_next_id % RECORD_NUM] = *meas;
+	records_next_id++;
+	if (records_next_id - records_first_id > RECORD_NUM) {
+		records_first_id++;
+	}
+
+	k_mutex_unlock(&records_lock);
+
+	return 0;
+}
+
+int cgms_storage_get(uint32_t id, struct cgms_meas *meas)
+{
+	int rc = 0;
+
+	k_mutex_lock(&records_lock, K_FOREVER);
+
+	if ((id - records_first_id) < (records_next_id - records_first_id)) {
+		*meas = records[id % RECORD_NUM];
+	} else {
+		rc = -ENOENT;
+	}
+
+	k_mutex_unlock(&records_lock);
+
+	return rc;
+}
+
+void cgms_storage_ids_get(uint32_t *first_id, uint32_t *next_id)
+{
+	k_mutex_lock(&records_lock, K_FOREVER);
+
+	*first_id = records_first_id;
+	*next_id = records_next_id;
+
+	k_mutex_unlock(&records_lock);
+}
+
+int cgms_storage_clear(void)
+{
+	k_mutex_lock(&records_lock, K_FOREVER);
+
+	records_first_id = records_next_id;
+
+	k_mutex_unlock(&records_lock);
+
+	return 0;
+}
+
+int cgms_storage_init(void)
+{
+	k_mutex_lock(&records_lock, K_FOREVER);
+
+	records_first_id = 0;
+	records_next_id = 0;
+
+	k_mutex_unlock(&records_lock);
+
+	return 0;
+}
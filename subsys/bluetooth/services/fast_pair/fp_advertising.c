@@ -6,7 +6,6 @@
 
 #include <errno.h>
 #include <zephyr/net/buf.h>
-#include <zephyr/random/random.h>
 #include <zephyr/bluetooth/bluetooth.h>
 
 #include <zephyr/logging/log.h>
@@ -14,6 +13,7 @@ LOG_MODULE_DECLARE(fast_pair, CONFIG_BT_FAST_PAIR_LOG_LEVEL);
 
 #include <bluetooth/services/fast_pair/fast_pair.h>
 #include <bluetooth/services/fast_pair/uuid.h>
+#include "fp_ak_filter.h"
 #include "fp_battery.h"
 #include "fp_common.h"
 #include "fp_crypto.h"
@@ -186,11 +186,6 @@ static int fp_adv_data_fill_non_discoverable(struct net_buf_simple *buf, size_t
 		uint16_t salt;
 		int err;
 
-		err = sys_csrand_get(&salt, sizeof(salt));
-		if (err) {
-			return err;
-		}
-
 		err = fp_storage_ak_get(ak, &account_key_get_cnt);
 		if (err) {
 			return err;
@@ -205,9 +200,8 @@ static int fp_adv_data_fill_non_discoverable(struct net_buf_simple *buf, size_t
 		__ASSERT_NO_MSG(ak_filter_size <= BIT_MASK(LEN_BITS));
 		net_buf_simple_add_u8(buf, ENCODE_FIELD_LEN_TYPE(ak_filter_size, ak_filter_type));
 
-		err = fp_crypto_account_key_filter(net_buf_simple_add(buf, ak_filter_size), ak,
-						   account_key_cnt, salt,
-						   add_battery_info ? battery_info : NULL);
+		err = fp_ak_filter_get(net_buf_simple_add(buf, ak_filter_size), &salt, ak,
+				       account_key_cnt, add_battery_info ? battery_info : NULL);
 		if (err) {
 			return err;
 		}
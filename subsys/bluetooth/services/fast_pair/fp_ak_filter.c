@@ -0,0 +1,228 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/random/random.h>
+#include <zephyr/sys/__assert.h>
+
+#include "fp_activation.h"
+#include "fp_ak_filter.h"
+#include "fp_common.h"
+#include "fp_crypto.h"
+
+#define ACCOUNT_KEY_MAX_CNT	CONFIG_BT_FAST_PAIR_STORAGE_ACCOUNT_KEY_MAX
+
+/* Account Key Filter size for the maximum number of Account Keys
+ * (see fp_crypto_account_key_filter_size).
+ */
+#define AK_FILTER_MAX_SIZE	((6 * ACCOUNT_KEY_MAX_CNT) / 5 + 3)
+
+struct ak_filter_input {
+	struct fp_account_key account_keys[ACCOUNT_KEY_MAX_CNT];
+	size_t n;
+	uint8_t battery_info[FP_CRYPTO_BATTERY_INFO_LEN];
+	bool has_battery_info;
+};
+
+struct ak_filter_precomputed {
+	uint8_t filter[AK_FILTER_MAX_SIZE];
+	uint16_t salt;
+	bool valid;
+};
+
+/* The Account Key Filter is requested and precomputed in the cooperative thread context, so
+ * the data does not need to be protected by a lock.
+ */
+static struct ak_filter_input last_input;
+static struct ak_filter_precomputed next_filter;
+static struct fp_ak_filter_stats stats;
+
+static void precompute_work_handler(struct k_work *work);
+static K_WORK_DEFINE(precompute_work, precompute_work_handler);
+
+static bool input_matches(const struct fp_account_key *account_key_list, size_t n,
+			  const uint8_t *battery_info)
+{
+	if (n != last_input.n) {
+		return false;
+	}
+
+	if (memcmp(last_input.account_keys, account_key_list, n * sizeof(account_key_list[0]))) {
+		return false;
+	}
+
+	if (!battery_info) {
+		return !last_input.has_battery_info;
+	}
+
+	return last_input.has_battery_info &&
+	       !memcmp(last_input.battery_info, battery_info, sizeof(last_input.battery_info));
+}
+
+static void input_store(const struct fp_account_key *account_key_list, size_t n,
+			const uint8_t *battery_info)
+{
+	memcpy(last_input.account_keys, account_key_list, n * sizeof(account_key_list[0]));
+	last_input.n = n;
+
+	last_input.has_battery_info = (battery_info != NULL);
+	if (battery_info) {
+		memcpy(last_input.battery_info, battery_info, sizeof(last_input.battery_info));
+	}
+}
+
+static int filter_compute(uint8_t *out, uint16_t *salt,
+			  const struct fp_account_key *account_key_list, size_t n,
+			  const uint8_t *battery_info)
+{
+	int err;
+
+	err = sys_csrand_get(salt, sizeof(*salt));
+	if (err) {
+		return err;
+	}
+
+	return fp_crypto_account_key_filter(out, account_key_list, n, *salt, battery_info);
+}
+
+static void cycles_update(uint32_t cycles, uint32_t *last, uint32_t *max)
+{
+	*last = cycles;
+	if (cycles > *max) {
+		*max = cycles;
+	}
+}
+
+static void precompute_work_handler(struct k_work *work)
+{
+	uint32_t start = k_cycle_get_32();
+	int err;
+
+	if (next_filter.valid || (last_input.n == 0)) {
+		return;
+	}
+
+	err = filter_compute(next_filter.filter, &next_filter.salt, last_input.account_keys,
+			     last_input.n,
+			     last_input.has_battery_info ? last_input.battery_info : NULL);
+	if (err) {
+		return;
+	}
+
+	next_filter.valid = true;
+	cycles_update(k_cycle_get_32() - start, &stats.precompute_cycles_last,
+		      &stats.precompute_cycles_max);
+}
+
+int fp_ak_filter_get(uint8_t *out, uint16_t *salt,
+		     const struct fp_account_key *account_key_list, size_t n,
+		     const uint8_t *battery_info)
+{
+	size_t filter_size = fp_crypto_account_key_filter_size(n);
+	int err = 0;
+
+	__ASSERT_NO_MSG((n > 0) && (n <= ACCOUNT_KEY_MAX_CNT));
+	__ASSERT_NO_MSG(filter_size <= AK_FILTER_MAX_SIZE);
+
+	if (!IS_ENABLED(CONFIG_BT_FAST_PAIR_ADVERTISING_AK_FILTER_PRECOMPUTE)) {
+		return filter_compute(out, salt, account_key_list, n, battery_info);
+	}
+
+	if (next_filter.valid && input_matches(account_key_list, n, battery_info)) {
+		memcpy(out, next_filter.filter, filter_size);
+		*salt = next_filter.salt;
+		stats.hits++;
+	} else {
+		uint32_t start = k_cycle_get_32();
+
+		err = filter_compute(out, salt, account_key_list, n, battery_info);
+		cycles_update(k_cycle_get_32() - start, &stats.compute_cycles_last,
+			      &stats.compute_cycles_max);
+		stats.misses++;
+
+		input_store(account_key_list, n, battery_info);
+	}
+
+	/* The Salt must not be used again. */
+	memset(&next_filter, 0, sizeof(next_filter));
+
+	if (!err) {
+		/* Precompute the filter for the next advertising data update. */
+		(void)k_work_submit(&precompute_work);
+	}
+
+	return err;
+}
+
+void fp_ak_filter_stats_get(struct fp_ak_filter_stats *out_stats)
+{
+	*out_stats = stats;
+}
+
+static int fp_ak_filter_init(void)
+{
+	return 0;
+}
+
+static int fp_ak_filter_uninit(void)
+{
+	(void)k_work_cancel(&precompute_work);
+
+	memset(&last_input, 0, sizeof(last_input));
+	memset(&next_filter, 0, sizeof(next_filter));
+
+	return 0;
+}
+
+FP_ACTIVATION_MODULE_REGISTER(fp_ak_filter, FP_ACTIVATION_INIT_PRIORITY_DEFAULT,
+			      fp_ak_filter_init, fp_ak_filter_uninit);
+
+#if CONFIG_BT_FAST_PAIR_ADVERTISING_AK_FILTER_SHELL
+#include <zephyr/shell/shell.h>
+
+static void cycles_print(const struct shell *sh, const char *name, uint32_t last, uint32_t max)
+{
+	shell_print(sh, "%s: last %u cycles (%u us), max %u cycles (%u us)", name, last,
+		    k_cyc_to_us_floor32(last), max, k_cyc_to_us_floor32(max));
+}
+
+static int cmd_ak_filter_stats(const struct shell *sh, size_t argc, char **argv)
+{
+	struct fp_ak_filter_stats current;
+
+	fp_ak_filter_stats_get(&current);
+
+	shell_print(sh, "Precomputed filter used: %u", current.hits);
+	shell_print(sh, "Filter computed on request: %u", current.misses);
+	cycles_print(sh, "Computation on request", current.compute_cycles_last,
+		     current.compute_cycles_max);
+	cycles_print(sh, "Precomputation", current.precompute_cycles_last,
+		     current.precompute_cycles_max);
+
+	return 0;
+}
+
+static int cmd_ak_filter_stats_reset(const struct shell *sh, size_t argc, char **argv)
+{
+	memset(&stats, 0, sizeof(stats));
+	shell_print(sh, "Statistics reset");
+
+	return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_fp_ak_filter,
+	SHELL_CMD_ARG(stats, NULL, "Print Account Key Filter statistics",
+		      cmd_ak_filter_stats, 1, 0),
+	SHELL_CMD_ARG(reset, NULL, "Reset Account Key Filter statistics",
+		      cmd_ak_filter_stats_reset, 1, 0),
+	SHELL_SUBCMD_SET_END
+);
+
+SHELL_CMD_REGISTER(fp_ak_filter, &sub_fp_ak_filter, "Fast Pair Account Key Filter commands",
+		   NULL);
+#endif /* CONFIG_BT_FAST_PAIR_ADVERTISING_AK_FILTER_SHELL */
@@ -146,6 +146,39 @@ int fp_crypto_aes128_ecb_decrypt(uint8_t *out, const uint8_t *in, const uint8_t
 	return aes128_ecb_crypt(out, in, k, false);
 }
 
+int fp_crypto_aes128_dec_key_prepare(struct fp_crypto_aes128_dec_key *dec_key, const uint8_t *k)
+{
+	int ret;
+
+	mbedtls_aes_init(&dec_key->ctx);
+
+	ret = mbedtls_aes_setkey_dec(&dec_key->ctx, k, AES128_ECB_KEY_BIT_LEN);
+	if (ret) {
+		LOG_ERR("aes128_dec_key_prepare: mbedtls_aes_setkey_dec failed: %d", ret);
+		mbedtls_aes_free(&dec_key->ctx);
+	}
+
+	return ret;
+}
+
+void fp_crypto_aes128_dec_key_free(struct fp_crypto_aes128_dec_key *dec_key)
+{
+	mbedtls_aes_free(&dec_key->ctx);
+}
+
+int fp_crypto_aes128_ecb_decrypt_prepared(uint8_t *out, const uint8_t *in,
+					  struct fp_crypto_aes128_dec_key *dec_key)
+{
+	int ret;
+
+	ret = mbedtls_aes_crypt_ecb(&dec_key->ctx, MBEDTLS_AES_DECRYPT, in, out);
+	if (ret) {
+		LOG_ERR("aes128_ecb_decrypt_prepared: mbedtls_aes_crypt_ecb failed: %d", ret);
+	}
+
+	return ret;
+}
+
 int fp_crypto_ecdh_shared_secret(uint8_t *secret_key,
 				 const uint8_t *public_key,
 				 const uint8_t *private_key)
@@ -4,6 +4,8 @@
  * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
  */
 
+#include <string.h>
+
 #include "fp_crypto.h"
 
 #include <ocrypto_hmac_sha256.h>
@@ -65,6 +67,25 @@ int fp_crypto_aes128_ecb_decrypt(uint8_t *out, const uint8_t *in, const uint8_t
 	return 0;
 }
 
+int fp_crypto_aes128_dec_key_prepare(struct fp_crypto_aes128_dec_key *dec_key, const uint8_t *k)
+{
+	/* The Oberon AES API does not expose the expanded key schedule. */
+	memcpy(dec_key->key, k, sizeof(dec_key->key));
+
+	return 0;
+}
+
+void fp_crypto_aes128_dec_key_free(struct fp_crypto_aes128_dec_key *dec_key)
+{
+	memset(dec_key, 0, sizeof(*dec_key));
+}
+
+int fp_crypto_aes128_ecb_decrypt_prepared(uint8_t *out, const uint8_t *in,
+					  struct fp_crypto_aes128_dec_key *dec_key)
+{
+	return fp_crypto_aes128_ecb_decrypt(out, in, dec_key->key);
+}
+
 int fp_crypto_aes256_ecb_encrypt(uint8_t *out, const uint8_t *in, const uint8_t *k)
 {
 	ocrypto_aes_ecb_encrypt(out, in, FP_CRYPTO_AES256_BLOCK_LEN, k, FP_CRYPTO_AES256_KEY_LEN);
@@ -191,6 +191,42 @@ int fp_crypto_aes128_ecb_decrypt(uint8_t *out, const uint8_t *in, const uint8_t
 	return fp_crypto_aes128_ecb_crypt(out, in, k, false);
 }
 
+int fp_crypto_aes128_dec_key_prepare(struct fp_crypto_aes128_dec_key *dec_key, const uint8_t *k)
+{
+	/* The imported key is kept until it is released, so that the key import is not repeated
+	 * on every decryption.
+	 */
+	dec_key->key_id = import_aes128_key(k);
+	if (dec_key->key_id == PSA_KEY_ID_NULL) {
+		LOG_ERR("import_aes128_key failed");
+		return -EIO;
+	}
+
+	return 0;
+}
+
+void fp_crypto_aes128_dec_key_free(struct fp_crypto_aes128_dec_key *dec_key)
+{
+	psa_status_t status;
+
+	if (dec_key->key_id == PSA_KEY_ID_NULL) {
+		return;
+	}
+
+	status = psa_destroy_key(dec_key->key_id);
+	if (status != PSA_SUCCESS) {
+		LOG_ERR("psa_destroy_key failed (err: %d)", status);
+	}
+
+	dec_key->key_id = PSA_KEY_ID_NULL;
+}
+
+int fp_crypto_aes128_ecb_decrypt_prepared(uint8_t *out, const uint8_t *in,
+					  struct fp_crypto_aes128_dec_key *dec_key)
+{
+	return fp_crypto_psa_aes128_ecb_crypt(out, in, dec_key->key_id, false);
+}
+
 static psa_key_id_t import_ecdh_priv_key(const uint8_t *data)
 {
 	static const size_t len = 32;
@@ -9,6 +9,14 @@
 
 #include <zephyr/types.h>
 
+#if defined(CONFIG_BT_FAST_PAIR_CRYPTO_TINYCRYPT)
+#include <tinycrypt/aes.h>
+#elif defined(CONFIG_BT_FAST_PAIR_CRYPTO_MBEDTLS)
+#include <mbedtls/aes.h>
+#elif defined(CONFIG_BT_FAST_PAIR_CRYPTO_PSA)
+#include <psa/crypto.h>
+#endif
+
 #include "fp_common.h"
 
 /**
@@ -97,6 +105,56 @@ int fp_crypto_aes128_ecb_encrypt(uint8_t *out, const uint8_t *in, const uint8_t
  */
 int fp_crypto_aes128_ecb_decrypt(uint8_t *out, const uint8_t *in, const uint8_t *k);
 
+/** AES-128 key prepared for repeated decryption.
+ *
+ * The structure holds the AES-128 key in the form used internally by the cryptographic backend,
+ * for example the expanded key schedule, so that the key preparation is not repeated on every
+ * decryption. Backends that do not expose such form keep a copy of the raw key.
+ */
+struct fp_crypto_aes128_dec_key {
+#if defined(CONFIG_BT_FAST_PAIR_CRYPTO_TINYCRYPT)
+	struct tc_aes_key_sched_struct sched;
+#elif defined(CONFIG_BT_FAST_PAIR_CRYPTO_MBEDTLS)
+	mbedtls_aes_context ctx;
+#elif defined(CONFIG_BT_FAST_PAIR_CRYPTO_PSA)
+	psa_key_id_t key_id;
+#else
+	uint8_t key[FP_CRYPTO_AES128_KEY_LEN];
+#endif
+};
+
+/** Prepare AES-128 key for decryption.
+ *
+ * The prepared key must be released with @ref fp_crypto_aes128_dec_key_free when it is no longer
+ * used.
+ *
+ * @param[out] dec_key Prepared key.
+ * @param[in] k 128-bit (16-byte) AES key.
+ *
+ * @return 0 If the operation was successful. Otherwise, a (negative) error code is returned.
+ */
+int fp_crypto_aes128_dec_key_prepare(struct fp_crypto_aes128_dec_key *dec_key, const uint8_t *k);
+
+/** Release AES-128 key prepared for decryption.
+ *
+ * @param[in] dec_key Prepared key.
+ */
+void fp_crypto_aes128_dec_key_free(struct fp_crypto_aes128_dec_key *dec_key);
+
+/** Decrypt message using AES-128-ECB with a prepared key.
+ *
+ * The result is the same as the result of @ref fp_crypto_aes128_ecb_decrypt called with the key
+ * used to prepare the dec_key.
+ *
+ * @param[out] out 128-bit (16-byte) buffer to receive plaintext message.
+ * @param[in] in 128-bit (16-byte) ciphertext message.
+ * @param[in] dec_key Key prepared with @ref fp_crypto_aes128_dec_key_prepare.
+ *
+ * @return 0 If the operation was successful. Otherwise, a (negative) error code is returned.
+ */
+int fp_crypto_aes128_ecb_decrypt_prepared(uint8_t *out, const uint8_t *in,
+					  struct fp_crypto_aes128_dec_key *dec_key);
+
 /** Encrypt data using AES-128-CTR.
  *
  * @param[out] out Buffer to receive encrypted data.
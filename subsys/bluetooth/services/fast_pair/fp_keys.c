@@ -52,6 +52,12 @@ struct fp_procedure {
 	uint8_t aes_key[FP_ACCOUNT_KEY_LEN];
 };
 
+struct fp_ak_dec_key {
+	struct fp_account_key account_key;
+	struct fp_crypto_aes128_dec_key dec_key;
+	bool valid;
+};
+
 struct fp_key_gen_account_key_check_context {
 	const struct bt_conn *conn;
 	struct fp_keys_keygen_params *keygen_params;
@@ -66,6 +72,10 @@ static struct fp_procedure fp_procedures[CONFIG_BT_MAX_CONN];
 
 static bool is_enabled;
 
+#if CONFIG_BT_FAST_PAIR_KEYS_ACCOUNT_KEY_CACHE
+static struct fp_ak_dec_key ak_dec_keys[CONFIG_BT_FAST_PAIR_STORAGE_ACCOUNT_KEY_MAX];
+#endif
+
 
 void bt_fast_pair_set_pairing_mode(bool pairing_mode)
 {
@@ -241,6 +251,137 @@ static int key_gen_public_key(const struct bt_conn *conn,
 	return err;
 }
 
+#if CONFIG_BT_FAST_PAIR_KEYS_ACCOUNT_KEY_CACHE
+static void ak_dec_key_remove(struct fp_ak_dec_key *ak_dec_key)
+{
+	fp_crypto_aes128_dec_key_free(&ak_dec_key->dec_key);
+	memset(ak_dec_key, 0, sizeof(*ak_dec_key));
+}
+
+static struct fp_ak_dec_key *ak_dec_key_find(const struct fp_account_key *account_key)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(ak_dec_keys); i++) {
+		struct fp_ak_dec_key *ak_dec_key = &ak_dec_keys[i];
+
+		if (ak_dec_key->valid &&
+		    !memcmp(ak_dec_key->account_key.key, account_key->key, FP_ACCOUNT_KEY_LEN)) {
+			return ak_dec_key;
+		}
+	}
+
+	return NULL;
+}
+
+static void ak_dec_keys_clear(void)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(ak_dec_keys); i++) {
+		if (ak_dec_keys[i].valid) {
+			ak_dec_key_remove(&ak_dec_keys[i]);
+		}
+	}
+}
+
+static int ak_dec_keys_sync(void)
+{
+	int err;
+	struct fp_account_key account_keys[CONFIG_BT_FAST_PAIR_STORAGE_ACCOUNT_KEY_MAX];
+	size_t account_key_cnt = ARRAY_SIZE(account_keys);
+
+	err = fp_storage_ak_get(account_keys, &account_key_cnt);
+	if (err) {
+		ak_dec_keys_clear();
+		return err;
+	}
+
+	/* Remove the keys that are no longer stored. */
+	for (size_t i = 0; i < ARRAY_SIZE(ak_dec_keys); i++) {
+		struct fp_ak_dec_key *ak_dec_key = &ak_dec_keys[i];
+		bool stored = false;
+
+		if (!ak_dec_key->valid) {
+			continue;
+		}
+
+		for (size_t j = 0; j < account_key_cnt; j++) {
+			if (!memcmp(ak_dec_key->account_key.key, account_keys[j].key,
+				    FP_ACCOUNT_KEY_LEN)) {
+				stored = true;
+				break;
+			}
+		}
+
+		if (!stored) {
+			ak_dec_key_remove(ak_dec_key);
+		}
+	}
+
+	/* Prepare the newly stored keys. */
+	for (size_t i = 0; i < account_key_cnt; i++) {
+		struct fp_ak_dec_key *ak_dec_key = NULL;
+
+		if (ak_dec_key_find(&account_keys[i])) {
+			continue;
+		}
+
+		for (size_t j = 0; j < ARRAY_SIZE(ak_dec_keys); j++) {
+			if (!ak_dec_keys[j].valid) {
+				ak_dec_key = &ak_dec_keys[j];
+				break;
+			}
+		}
+
+		__ASSERT_NO_MSG(ak_dec_key);
+
+		err = fp_crypto_aes128_dec_key_prepare(&ak_dec_key->dec_key,
+						       account_keys[i].key);
+		if (err) {
+			memset(ak_dec_key, 0, sizeof(*ak_dec_key));
+			break;
+		}
+
+		ak_dec_key->account_key = account_keys[i];
+		ak_dec_key->valid = true;
+	}
+
+	memset(account_keys, 0, sizeof(account_keys));
+
+	return err;
+}
+
+static struct fp_ak_dec_key *ak_dec_key_get(const struct fp_account_key *account_key)
+{
+	struct fp_ak_dec_key *ak_dec_key = ak_dec_key_find(account_key);
+
+	if (!ak_dec_key) {
+		/* The stored Account Keys have changed since the last synchronization. */
+		int err = ak_dec_keys_sync();
+
+		if (err) {
+			LOG_WRN("Unable to prepare Account Keys for decryption: err=%d", err);
+		}
+
+		ak_dec_key = ak_dec_key_find(account_key);
+	}
+
+	return ak_dec_key;
+}
+#endif /* CONFIG_BT_FAST_PAIR_KEYS_ACCOUNT_KEY_CACHE */
+
+static int key_gen_account_key_decrypt(const struct bt_conn *conn,
+				       const struct fp_account_key *account_key,
+				       uint8_t *req, const uint8_t *req_enc)
+{
+#if CONFIG_BT_FAST_PAIR_KEYS_ACCOUNT_KEY_CACHE
+	struct fp_ak_dec_key *ak_dec_key = ak_dec_key_get(account_key);
+
+	if (ak_dec_key) {
+		return fp_crypto_aes128_ecb_decrypt_prepared(req, req_enc, &ak_dec_key->dec_key);
+	}
+#endif
+
+	return fp_keys_decrypt(conn, req, req_enc);
+}
+
 static bool key_gen_account_key_check(const struct fp_account_key *account_key, void *context)
 {
 	int err;
@@ -252,7 +393,7 @@ static bool key_gen_account_key_check(const struct fp_account_key *account_key,
 
 	memcpy(proc->aes_key, account_key->key, FP_ACCOUNT_KEY_LEN);
 
-	err = fp_keys_decrypt(conn, req, keygen_params->req_enc);
+	err = key_gen_account_key_decrypt(conn, account_key, req, keygen_params->req_enc);
 	if (err) {
 		return false;
 	}
@@ -368,6 +509,14 @@ int fp_keys_store_account_key(const struct bt_conn *conn, const struct fp_accoun
 	err = fp_storage_ak_save(account_key);
 	if (!err) {
 		LOG_DBG("Account Key stored");
+
+#if CONFIG_BT_FAST_PAIR_KEYS_ACCOUNT_KEY_CACHE
+		int ret = ak_dec_keys_sync();
+
+		if (ret) {
+			LOG_WRN("Unable to prepare Account Keys for decryption: err=%d", ret);
+		}
+#endif
 	} else {
 		LOG_WRN("Store account key error: err=%d", err);
 	}
@@ -502,6 +651,15 @@ static int fp_keys_init(void)
 		timeout_works_initialized = true;
 	}
 
+#if CONFIG_BT_FAST_PAIR_KEYS_ACCOUNT_KEY_CACHE
+	int err = ak_dec_keys_sync();
+
+	if (err) {
+		/* Not fatal, the keys are prepared again when they are used. */
+		LOG_WRN("Unable to prepare Account Keys for decryption: err=%d", err);
+	}
+#endif
+
 	is_enabled = true;
 
 	return 0;
@@ -525,6 +683,10 @@ static int fp_keys_uninit(void)
 		ARG_UNUSED(ret);
 	}
 
+#if CONFIG_BT_FAST_PAIR_KEYS_ACCOUNT_KEY_CACHE
+	ak_dec_keys_clear();
+#endif
+
 	return 0;
 }
 
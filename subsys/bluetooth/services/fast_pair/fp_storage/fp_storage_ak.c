@@ -9,6 +9,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <zephyr/kernel.h>
 #include <zephyr/sys/__assert.h>
 #include <zephyr/settings/settings.h>
 #include <bluetooth/services/fast_pair/fast_pair.h>
@@ -26,10 +27,16 @@ static uint8_t account_key_metadata[ACCOUNT_KEY_CNT];
 static uint8_t account_key_count;
 
 static uint8_t account_key_order[ACCOUNT_KEY_CNT];
+/* The order is updated by Account Key lookups and saved from the system workqueue. */
+static K_MUTEX_DEFINE(ak_order_lock);
 
 static int settings_set_err;
 static bool is_enabled;
 
+static void ak_order_save_work_handler(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(ak_order_save_work, ak_order_save_work_handler);
+static bool ak_order_save_pending;
+
 static int fp_settings_load_ak(const char *name, size_t len, settings_read_cb read_cb, void *cb_arg)
 {
 	int rc;
@@ -157,6 +164,8 @@ static void ak_order_update_ram(uint8_t used_id)
 	bool id_found = false;
 	size_t found_idx;
 
+	(void)k_mutex_lock(&ak_order_lock, K_FOREVER);
+
 	for (size_t i = 0; i < account_key_count; i++) {
 		if (account_key_order[i] == used_id) {
 			id_found = true;
@@ -175,6 +184,56 @@ static void ak_order_update_ram(uint8_t used_id)
 		}
 	}
 	account_key_order[0] = used_id;
+
+	(void)k_mutex_unlock(&ak_order_lock);
+}
+
+static int ak_order_save(void)
+{
+	uint8_t order[ACCOUNT_KEY_CNT];
+
+	(void)k_mutex_lock(&ak_order_lock, K_FOREVER);
+	ak_order_save_pending = false;
+	memcpy(order, account_key_order, sizeof(order));
+	(void)k_mutex_unlock(&ak_order_lock);
+
+	return settings_save_one(SETTINGS_AK_ORDER_FULL_NAME, order, sizeof(order));
+}
+
+static void ak_order_save_log_err(void)
+{
+	LOG_ERR("Unable to save new Account Key order in Settings. "
+		"Not propagating the error and keeping updated Account Key "
+		"order in RAM. After the Settings error the Account Key "
+		"order may change at reboot.");
+}
+
+static void ak_order_save_work_handler(struct k_work *work)
+{
+	if (!ak_order_save_pending) {
+		return;
+	}
+
+	if (ak_order_save()) {
+		ak_order_save_log_err();
+	}
+}
+
+static void ak_order_save_cancel(void)
+{
+	(void)k_work_cancel_delayable(&ak_order_save_work);
+	ak_order_save_pending = false;
+}
+
+static void ak_order_save_schedule(void)
+{
+	/* Saving the order is postponed, so that the order updates caused by the subsequent
+	 * Account Key lookups are coalesced into a single settings write. The scheduled save is
+	 * not moved if it is already pending to limit the delay of the first update.
+	 */
+	ak_order_save_pending = true;
+	(void)k_work_schedule(&ak_order_save_work,
+			      K_MSEC(CONFIG_BT_FAST_PAIR_STORAGE_AK_ORDER_SAVE_DELAY));
 }
 
 static int validate_ak_order(void)
@@ -214,8 +273,7 @@ static int validate_ak_order(void)
 	}
 
 	if (ak_order_update_count > 0) {
-		err = settings_save_one(SETTINGS_AK_ORDER_FULL_NAME, account_key_order,
-					sizeof(account_key_order));
+		err = ak_order_save();
 		if (err) {
 			return err;
 		}
@@ -310,23 +368,26 @@ int fp_storage_ak_find(struct fp_account_key *account_key,
 		return -EINVAL;
 	}
 
+	/* Account Keys are checked starting from the most recently used one, as it is the most
+	 * likely to be used again.
+	 */
 	for (size_t i = 0; i < account_key_count; i++) {
-		if (account_key_check_cb(&account_key_list[i], context)) {
-			int err;
-
-			ak_order_update_ram(ACCOUNT_KEY_METADATA_FIELD_GET(account_key_metadata[i],
-									   ID));
-			err = settings_save_one(SETTINGS_AK_ORDER_FULL_NAME, account_key_order,
-						sizeof(account_key_order));
-			if (err) {
-				LOG_ERR("Unable to save new Account Key order in Settings. "
-					"Not propagating the error and keeping updated Account Key "
-					"order in RAM. After the Settings error the Account Key "
-					"order may change at reboot.");
+		uint8_t id = account_key_order[i];
+		uint8_t index = account_key_id_to_idx(id);
+
+		if (account_key_check_cb(&account_key_list[index], context)) {
+			if (i > 0) {
+				ak_order_update_ram(id);
+
+				if (CONFIG_BT_FAST_PAIR_STORAGE_AK_ORDER_SAVE_DELAY > 0) {
+					ak_order_save_schedule();
+				} else if (ak_order_save()) {
+					ak_order_save_log_err();
+				}
 			}
 
 			if (account_key) {
-				*account_key = account_key_list[i];
+				*account_key = account_key_list[index];
 			}
 
 			return 0;
@@ -396,13 +457,12 @@ int fp_storage_ak_save(const struct fp_account_key *account_key)
 	}
 
 	ak_order_update_ram(id);
-	err = settings_save_one(SETTINGS_AK_ORDER_FULL_NAME, account_key_order,
-				sizeof(account_key_order));
+
+	/* The saved order includes all of the pending order updates. */
+	ak_order_save_cancel();
+	err = ak_order_save();
 	if (err) {
-		LOG_ERR("Unable to save new Account Key order in Settings. "
-			"Not propagating the error and keeping updated Account Key "
-			"order in RAM. After the Settings error the Account Key "
-			"order may change at reboot.");
+		ak_order_save_log_err();
 	}
 
 	return 0;
@@ -410,11 +470,15 @@ int fp_storage_ak_save(const struct fp_account_key *account_key)
 
 void fp_storage_ak_ram_clear(void)
 {
+	ak_order_save_cancel();
+
 	memset(account_key_list, 0, sizeof(account_key_list));
 	memset(account_key_metadata, 0, sizeof(account_key_metadata));
 	account_key_count = 0;
 
+	(void)k_mutex_lock(&ak_order_lock, K_FOREVER);
 	memset(account_key_order, 0, sizeof(account_key_order));
+	(void)k_mutex_unlock(&ak_order_lock);
 
 	settings_set_err = 0;
 
@@ -448,6 +512,14 @@ static int fp_storage_ak_init(void)
 static int fp_storage_ak_uninit(void)
 {
 	is_enabled = false;
+
+	if (ak_order_save_pending) {
+		ak_order_save_cancel();
+		if (ak_order_save()) {
+			ak_order_save_log_err();
+		}
+	}
+
 	return 0;
 }
 
@@ -474,6 +546,8 @@ static int fp_storage_ak_reset(void)
 	int err;
 	bool was_enabled = is_enabled;
 
+	ak_order_save_cancel();
+
 	for (uint8_t index = 0; index < ACCOUNT_KEY_CNT; index++) {
 		err = fp_storage_ak_delete(index);
 		if (err) {
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _FP_AK_FILTER_H_
+#define _FP_AK_FILTER_H_
+
+#include <zephyr/types.h>
+
+#include "fp_common.h"
+
+/**
+ * @defgroup fp_ak_filter Fast Pair Account Key Filter
+ * @brief Internal API for Fast Pair Account Key Filter engine
+ *
+ * The Account Key Filter engine provides the Account Key Filter and the Salt for
+ * the non-discoverable advertising data. After the Account Key Filter is provided, the engine
+ * precomputes the Account Key Filter for the next advertising data update with a new Salt in
+ * the background. The precomputed Account Key Filter is used if the Account Keys and
+ * the battery info do not change until the next update. Every Salt is used only once.
+ *
+ * @{
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Account Key Filter engine statistics. */
+struct fp_ak_filter_stats {
+	/** Number of requests served with the precomputed Account Key Filter. */
+	uint32_t hits;
+
+	/** Number of requests that required computing the Account Key Filter. */
+	uint32_t misses;
+
+	/** Number of cycles spent to compute the Account Key Filter on the last miss. */
+	uint32_t compute_cycles_last;
+
+	/** Maximum number of cycles spent to compute the Account Key Filter on a miss. */
+	uint32_t compute_cycles_max;
+
+	/** Number of cycles spent on the last Account Key Filter precomputation. */
+	uint32_t precompute_cycles_last;
+
+	/** Maximum number of cycles spent on an Account Key Filter precomputation. */
+	uint32_t precompute_cycles_max;
+};
+
+/** Get Account Key Filter together with the Salt used to compute it.
+ *
+ * The function must be called in the cooperative thread context.
+ *
+ * @param[out] out Buffer to receive Account Key Filter. Buffer size must be at least
+ *                 @ref fp_crypto_account_key_filter_size.
+ * @param[out] salt Salt used to compute the Account Key Filter.
+ * @param[in] account_key_list Pointer to array of Account Keys.
+ * @param[in] n Number of Account Keys (1 <= n <= CONFIG_BT_FAST_PAIR_STORAGE_ACCOUNT_KEY_MAX).
+ * @param[in] battery_info Battery info or NULL if there is no battery info. Length of battery info
+ *			   must be equal to @ref FP_CRYPTO_BATTERY_INFO_LEN.
+ *
+ * @return 0 If the operation was successful. Otherwise, a (negative) error code is returned.
+ */
+int fp_ak_filter_get(uint8_t *out, uint16_t *salt,
+		     const struct fp_account_key *account_key_list, size_t n,
+		     const uint8_t *battery_info);
+
+/** Get Account Key Filter engine statistics.
+ *
+ * @param[out] stats Statistics.
+ */
+void fp_ak_filter_stats_get(struct fp_ak_filter_stats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* _FP_AK_FILTER_H_ */
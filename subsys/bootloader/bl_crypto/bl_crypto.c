@@ -49,23 +49,30 @@ static int verify_truncated_hash(const uint8_t *data, uint32_t data_len,
 	return 0;
 }
 
-static int verify_signature(const uint8_t *data, uint32_t data_len,
+static int verify_signature_hash(const uint8_t *data_hash,
 		const uint8_t *signature, const uint8_t *public_key, bool external)
 {
-	uint8_t hash1[CONFIG_SB_HASH_LEN];
 	uint8_t hash2[CONFIG_SB_HASH_LEN];
 
-	int retval = get_hash(hash1, data, data_len, external);
+	int retval = get_hash(hash2, data_hash, CONFIG_SB_HASH_LEN, external);
 	if (retval != 0) {
 		return retval;
 	}
 
-	retval = get_hash(hash2, hash1, CONFIG_SB_HASH_LEN, external);
+	return bl_secp256r1_validate(hash2, CONFIG_SB_HASH_LEN, public_key, signature);
+}
+
+static int verify_signature(const uint8_t *data, uint32_t data_len,
+		const uint8_t *signature, const uint8_t *public_key, bool external)
+{
+	uint8_t hash1[CONFIG_SB_HASH_LEN];
+
+	int retval = get_hash(hash1, data, data_len, external);
 	if (retval != 0) {
 		return retval;
 	}
 
-	return bl_secp256r1_validate(hash2, CONFIG_SB_HASH_LEN, public_key, signature);
+	return verify_signature_hash(hash1, signature, public_key, external);
 }
 
 /* Base implementation, with 'external' parameter. */
@@ -86,6 +93,24 @@ static int root_of_trust_verify(
 	return verify_signature(firmware, firmware_len, signature, public_key,
 			external);
 }
+
+/* For use by the bootloader, when the firmware has already been hashed. */
+int bl_root_of_trust_verify_hash(const uint8_t *public_key,
+				 const uint8_t *public_key_hash,
+				 const uint8_t *signature,
+				 const uint8_t *firmware_hash)
+{
+	__ASSERT(public_key && public_key_hash && signature && firmware_hash,
+			"A parameter was NULL.");
+	int retval = verify_truncated_hash(public_key, CONFIG_SB_PUBLIC_KEY_LEN,
+			public_key_hash, SB_PUBLIC_KEY_HASH_LEN, true);
+
+	if (retval != 0) {
+		return retval;
+	}
+
+	return verify_signature_hash(firmware_hash, signature, public_key, true);
+}
 #endif
 
 
@@ -115,6 +115,7 @@ bool bl_validate_firmware(uint32_t fw_dst_address, uint32_t fw_src_address)
 #include <zephyr/sys/printk.h>
 #include <zephyr/toolchain.h>
 #include <bl_crypto.h>
+#include <ocrypto_constant_time.h>
 #include "bl_validation_internal.h"
 
 #if USE_PARTITION_MANAGER
@@ -194,7 +195,11 @@ validation_info_find(uint32_t start_address, uint32_t search_distance)
 }
 
 #ifdef CONFIG_SB_VALIDATE_FW_SIGNATURE
+/* If fw_hash is not NULL, it is the digest of the firmware, and the firmware
+ * itself is not read.
+ */
 static bool validate_signature(const uint32_t fw_src_address, const uint32_t fw_size,
+			       const uint8_t *fw_hash,
 			       const struct fw_validation_info *fw_val_info,
 			       bool external)
 {
@@ -242,11 +247,20 @@ static bool validate_signature(const uint32_t fw_src_address, const uint32_t fw_
 		PRINT("Verifying signature against key %d.\n\r", key_data_idx);
 		PRINT("Hash: 0x%02x...%02x\r\n", key_data[0],
 			key_data[SB_PUBLIC_KEY_HASH_LEN-1]);
-		int retval = rot_verify(fw_val_info->public_key,
-					key_data,
-					fw_val_info->signature,
-					(const uint8_t *)fw_src_address,
-					fw_size);
+		int retval;
+
+		if (fw_hash) {
+			retval = bl_root_of_trust_verify_hash(fw_val_info->public_key,
+							      key_data,
+							      fw_val_info->signature,
+							      fw_hash);
+		} else {
+			retval = rot_verify(fw_val_info->public_key,
+					    key_data,
+					    fw_val_info->signature,
+					    (const uint8_t *)fw_src_address,
+					    fw_size);
+		}
 
 		if (retval == 0) {
 			for (uint32_t i = 0; i < key_data_idx; i++) {
@@ -298,8 +312,12 @@ static bool validate_hash(const uint32_t fw_src_address, const uint32_t fw_size,
 #endif
 
 
-static bool validate_firmware(uint32_t fw_dst_address, uint32_t fw_src_address,
-			      const struct fw_info *fwinfo, bool external)
+/* Check everything except the digest and signature. Returns the validation
+ * info of the firmware, or NULL if the firmware is invalid.
+ */
+static const struct fw_validation_info *
+validate_firmware_info(uint32_t fw_dst_address, uint32_t fw_src_address,
+		       const struct fw_info *fwinfo, bool external)
 {
 	const struct fw_validation_info *fw_val_info;
 	const uint32_t fwinfo_address = (uint32_t)fwinfo;
@@ -309,33 +327,33 @@ static bool validate_firmware(uint32_t fw_dst_address, uint32_t fw_src_address,
 
 	if (!fwinfo) {
 		PRINT("NULL parameter.\n\r");
-		return false;
+		return NULL;
 	}
 
 	if (!fw_info_check((uint32_t)fwinfo)) {
 		PRINT("Invalid firmware info format.\n\r");
-		return false;
+		return NULL;
 	}
 
 	if (fw_dst_address != fwinfo->address) {
 		PRINT("The firmware doesn't belong at destination addr.\n\r");
-		return false;
+		return NULL;
 	}
 
 	if (!external && (fw_src_address != fw_dst_address)) {
 		PRINT("src and dst must be equal for local calls.\n\r");
-		return false;
+		return NULL;
 	}
 
 	if (fw_info_find(fw_src_address) != fwinfo) {
 		PRINT("Firmware info doesn't point to itself.\n\r");
-		return false;
+		return NULL;
 	}
 
 	if (fwinfo->valid != CONFIG_FW_INFO_VALID_VAL) {
 		PRINT("Firwmare has been invalidated: 0x%x.\n\r",
 			fwinfo->valid);
-		return false;
+		return NULL;
 	}
 
 	uint16_t stored_version;
@@ -360,7 +378,7 @@ static bool validate_firmware(uint32_t fw_dst_address, uint32_t fw_src_address,
 	if (fwinfo->version < stored_version) {
 		PRINT("Firmware version (%u) is smaller than monotonic counter (%u).\n\r",
 			fwinfo->version, stored_version);
-		return false;
+		return NULL;
 	}
 
 #if defined(PM_S0_SIZE) && defined(PM_S1_SIZE)
@@ -369,19 +387,19 @@ static bool validate_firmware(uint32_t fw_dst_address, uint32_t fw_src_address,
 	if ((fwinfo->size > (PM_S0_SIZE))
 		|| (fwinfo->total_size > fwinfo->size)) {
 		PRINT("Invalid size or total_size in firmware info.\n\r");
-		return false;
+		return NULL;
 	}
 #endif
 
 	if (!region_within(fwinfo_address, fwinfo_end,
 			fw_src_address, fw_src_end)) {
 		PRINT("Firmware info is not within signed region.\n\r");
-		return false;
+		return NULL;
 	}
 
 	if (!within(fwinfo->boot_address, fw_dst_address, fw_dst_end)) {
 		PRINT("Boot address is not within signed region.\n\r");
-		return false;
+		return NULL;
 	}
 
 	/* Wait until this point to set these values as we must know that we
@@ -392,24 +410,39 @@ static bool validate_firmware(uint32_t fw_dst_address, uint32_t fw_src_address,
 
 	if (!within(reset_vector, fw_dst_address, fw_dst_end)) {
 		PRINT("Reset handler is not within signed region.\n\r");
-		return false;
+		return NULL;
 	}
 
 	fw_val_info = validation_info_find(fw_src_address + fwinfo->size, 4);
 
 	if (!fw_val_info) {
 		PRINT("Could not find valid firmware validation info.\n\r");
-		return false;
+		return NULL;
 	}
 
 	if (fw_val_info->address != fwinfo->address) {
 		PRINT("Validation info doesn't belong to this firmware.\n\r");
+		return NULL;
+	}
+
+	return fw_val_info;
+}
+
+
+static bool validate_firmware(uint32_t fw_dst_address, uint32_t fw_src_address,
+			      const struct fw_info *fwinfo, bool external)
+{
+	const struct fw_validation_info *fw_val_info =
+		validate_firmware_info(fw_dst_address, fw_src_address, fwinfo,
+				       external);
+
+	if (!fw_val_info) {
 		return false;
 	}
 
 #ifdef CONFIG_SB_VALIDATE_FW_SIGNATURE
-	return validate_signature(fw_src_address, fwinfo->size, fw_val_info,
-				external);
+	return validate_signature(fw_src_address, fwinfo->size, NULL,
+				fw_val_info, external);
 #elif defined(CONFIG_SB_VALIDATE_FW_HASH)
 	return validate_hash(fw_src_address, fwinfo->size, fw_val_info,
 				external);
@@ -430,6 +463,109 @@ bool bl_validate_firmware_local(uint32_t fw_address, const struct fw_info *fwinf
 {
 	return validate_firmware(fw_address, fw_address, fwinfo, false);
 }
+
+
+int bl_validate_firmware_stream_init(struct bl_validate_stream_ctx *ctx,
+				     uint32_t fw_dst_address,
+				     uint32_t fw_src_address)
+{
+	const struct fw_info *fwinfo = fw_info_find(fw_src_address);
+	int err;
+
+	if (!ctx) {
+		return -EINVAL;
+	}
+
+	ctx->fw_info = NULL;
+
+	/* validate_firmware_info() reads fwinfo before checking it for NULL. */
+	if (!fwinfo) {
+		return -EINVAL;
+	}
+
+	ctx->fw_val_info = validate_firmware_info(fw_dst_address, fw_src_address,
+						  fwinfo, true);
+	if (!ctx->fw_val_info) {
+		return -EINVAL;
+	}
+
+	err = bl_crypto_init();
+	if (err) {
+		return err;
+	}
+
+	err = bl_sha256_init(&ctx->sha_ctx);
+	if (err) {
+		return err;
+	}
+
+	ctx->fw_info = fwinfo;
+	ctx->hashed_len = 0;
+
+	return 0;
+}
+
+
+int bl_validate_firmware_stream_update(struct bl_validate_stream_ctx *ctx,
+				       const uint8_t *data, uint32_t data_len)
+{
+	if (!ctx || !ctx->fw_info) {
+		return -EINVAL;
+	}
+
+	/* Anything after the firmware, like the validation info, is not part
+	 * of the digest.
+	 */
+	data_len = MIN(data_len, ctx->fw_info->size - ctx->hashed_len);
+	if (data_len == 0) {
+		return 0;
+	}
+
+	int err = bl_sha256_update(&ctx->sha_ctx, data, data_len);
+
+	if (err) {
+		return err;
+	}
+
+	ctx->hashed_len += data_len;
+
+	return 0;
+}
+
+
+bool bl_validate_firmware_stream_finalize(struct bl_validate_stream_ctx *ctx)
+{
+	const struct fw_validation_info *fw_val_info;
+	uint8_t hash[CONFIG_SB_HASH_LEN];
+
+	if (!ctx || !ctx->fw_info) {
+		return false;
+	}
+
+	fw_val_info = ctx->fw_val_info;
+
+	/* The context cannot be used again without a new init. */
+	bool complete = (ctx->hashed_len == ctx->fw_info->size);
+
+	ctx->fw_info = NULL;
+
+	if (!complete) {
+		return false;
+	}
+
+	if (bl_sha256_finalize(&ctx->sha_ctx, hash)) {
+		return false;
+	}
+
+#ifdef CONFIG_SB_VALIDATE_FW_SIGNATURE
+	return validate_signature(0, 0, hash, fw_val_info, true);
+#elif defined(CONFIG_SB_VALIDATE_FW_HASH)
+	return ocrypto_constant_time_equal(hash, fw_val_info->hash,
+					   CONFIG_SB_HASH_LEN);
+#else
+	#error "Validation not specified."
+#endif
+}
 #endif
 
 bool bl_validate_firmware_available(void)
@@ -11,6 +11,10 @@
 #include <zephyr/drivers/flash.h>
 #include "emds_flash.h"
 
+#if defined(CONFIG_EMDS_FLUSH)
+#include <zephyr/sys/crc.h>
+#endif
+
 #include <zephyr/logging/log.h>
 LOG_MODULE_REGISTER(emds, CONFIG_EMDS_LOG_LEVEL);
 
@@ -21,6 +25,25 @@ static sys_slist_t emds_dynamic_entries;
 static struct emds_fs emds_flash;
 static emds_store_cb_t app_store_cb;
 
+#if defined(CONFIG_EMDS_FLUSH)
+/* The checksum of the entry was computed by a previous flush. */
+#define EMDS_FLUSH_CHECKED BIT(0)
+/* The flash holds a copy of the entry data that matches the checksum. */
+#define EMDS_FLUSH_STORED BIT(1)
+
+/* Values of the marker entry. The flushed marker is written before the first flushed entry, and
+ * every store ends with the committed marker. Entries written after the last committed marker
+ * were flushed but never committed, and are not loaded.
+ */
+#define EMDS_MARKER_FLUSHED 0x48534c46
+#define EMDS_MARKER_COMMITTED 0x54494d43
+
+static uint32_t flushed_marker = EMDS_MARKER_FLUSHED;
+static uint32_t committed_marker = EMDS_MARKER_COMMITTED;
+static bool marker_flushed;
+static K_MUTEX_DEFINE(flush_lock);
+#endif
+
 static int emds_fs_init(void)
 {
 	int rc;
@@ -67,30 +90,247 @@ static int emds_fs_init(void)
 }
 
 
-static int emds_entries_size(uint32_t *size)
+static uint32_t entry_size(size_t len)
 {
 	size_t block_size = emds_flash.flash_params->write_block_size;
+
+	return DIV_ROUND_UP(len, block_size) * block_size +
+	       DIV_ROUND_UP(emds_flash.ate_size, block_size) * block_size;
+}
+
+static int emds_entries_size(uint32_t *size)
+{
 	int entries = 0;
 
 	*size = 0;
 
 	STRUCT_SECTION_FOREACH(emds_entry, ch) {
-		*size += DIV_ROUND_UP(ch->len, block_size) * block_size;
-		*size += DIV_ROUND_UP(emds_flash.ate_size, block_size) * block_size;
+		*size += entry_size(ch->len);
 		entries++;
 	}
 
 	struct emds_dynamic_entry *ch;
 
 	SYS_SLIST_FOR_EACH_CONTAINER(&emds_dynamic_entries, ch, node) {
-		*size += DIV_ROUND_UP(ch->entry.len, block_size) * block_size;
-		*size += DIV_ROUND_UP(emds_flash.ate_size, block_size) * block_size;
+		*size += entry_size(ch->entry.len);
 		entries++;
 	}
 
+#if defined(CONFIG_EMDS_FLUSH)
+	*size += entry_size(sizeof(committed_marker));
+#endif
+
 	return entries;
 }
 
+static bool entry_is_flushed(const struct emds_entry *entry)
+{
+#if defined(CONFIG_EMDS_FLUSH)
+	return (entry->flush->flags & EMDS_FLUSH_STORED) &&
+	       (entry->flush->crc == crc32_ieee(entry->data, entry->len));
+#else
+	return false;
+#endif
+}
+
+static uint32_t entry_store_time(size_t len)
+{
+	size_t block_size = emds_flash.flash_params->write_block_size;
+
+	return DIV_ROUND_UP(len, block_size) * CONFIG_EMDS_FLASH_TIME_WRITE_ONE_WORD_US
+	       + DIV_ROUND_UP(emds_flash.ate_size, block_size) *
+			CONFIG_EMDS_FLASH_TIME_WRITE_ONE_WORD_US
+	       + CONFIG_EMDS_FLASH_TIME_ENTRY_OVERHEAD_US;
+}
+
+static uint32_t entry_time(const struct emds_entry *entry, bool worst_case)
+{
+	uint32_t time_us = 0;
+
+#if defined(CONFIG_EMDS_FLUSH)
+	/* Flushed entries are checked for changes before they are skipped. */
+	if (worst_case || (entry->flush->flags & EMDS_FLUSH_STORED)) {
+		time_us += DIV_ROUND_UP(entry->len * CONFIG_EMDS_FLUSH_TIME_CHECK_BYTE_NS, 1000);
+	}
+
+	if (!worst_case && entry_is_flushed(entry)) {
+		return time_us;
+	}
+#endif
+
+	return time_us + entry_store_time(entry->len);
+}
+
+static uint32_t store_time_get(bool worst_case)
+{
+	uint32_t store_time_us = CONFIG_EMDS_FLASH_TIME_BASE_OVERHEAD_US;
+
+	STRUCT_SECTION_FOREACH(emds_entry, ch) {
+		store_time_us += entry_time(ch, worst_case);
+	}
+
+	struct emds_dynamic_entry *ch;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&emds_dynamic_entries, ch, node) {
+		store_time_us += entry_time(&ch->entry, worst_case);
+	}
+
+#if defined(CONFIG_EMDS_FLUSH)
+	size_t block_size = emds_flash.flash_params->write_block_size;
+
+	/* Writing the committed marker. */
+	store_time_us += entry_store_time(sizeof(committed_marker));
+
+	if (worst_case || marker_flushed) {
+		/* Discarding an interrupted flush. */
+		store_time_us += DIV_ROUND_UP(emds_flash.ate_size, block_size) *
+				 CONFIG_EMDS_FLASH_TIME_WRITE_ONE_WORD_US;
+	}
+#endif
+
+	return store_time_us;
+}
+
+#if defined(CONFIG_EMDS_FLUSH)
+static void flush_states_reset(void)
+{
+	struct emds_dynamic_entry *ch;
+
+	STRUCT_SECTION_FOREACH(emds_entry, entry) {
+		entry->flush->flags = 0;
+	}
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&emds_dynamic_entries, ch, node) {
+		ch->flush_state.flags = 0;
+	}
+
+	marker_flushed = false;
+}
+
+static int flush_write(uint16_t id, const void *data, size_t len, uint32_t reserved_size)
+{
+	ssize_t written;
+
+	/* Keep enough space for a store where all entries have changed. */
+	if (emds_flash_free_space_get(&emds_flash) < reserved_size + entry_size(len)) {
+		return -ENOMEM;
+	}
+
+	written = emds_flash_background_write(&emds_flash, id, data, len);
+	if (written == -EBUSY) {
+		/* The store has started. */
+		return -ECANCELED;
+	}
+
+	return (written < 0) ? written : 0;
+}
+
+static int entry_flush(const struct emds_entry *entry, uint32_t reserved_size)
+{
+	struct emds_flush_state *state = entry->flush;
+	uint32_t crc = crc32_ieee(entry->data, entry->len);
+	unsigned int key;
+	int err;
+
+	if (!(state->flags & EMDS_FLUSH_CHECKED) || (state->crc != crc)) {
+		/* The entry has changed since the last flush. It is written once it is stable.
+		 * The store must not see the new checksum with the old flags.
+		 */
+		key = irq_lock();
+		state->crc = crc;
+		state->flags = EMDS_FLUSH_CHECKED;
+		irq_unlock(key);
+		return 0;
+	}
+
+	if (state->flags & EMDS_FLUSH_STORED) {
+		return 0;
+	}
+
+	if (!marker_flushed) {
+		/* Set before writing the marker, so that the store commits it even if it
+		 * interrupts the write.
+		 */
+		marker_flushed = true;
+
+		err = flush_write(EMDS_FLUSH_MARKER_ID, &flushed_marker, sizeof(flushed_marker),
+				  reserved_size);
+		if (err) {
+			return err;
+		}
+	}
+
+	err = flush_write(entry->id, entry->data, entry->len, reserved_size);
+	if (err == -EAGAIN) {
+		/* Changed while it was written. */
+		return 0;
+	} else if (err) {
+		return err;
+	}
+
+	/* The store checks the checksum again, so the entry can change after this check. */
+	if (crc32_ieee(entry->data, entry->len) == crc) {
+		state->flags |= EMDS_FLUSH_STORED;
+	}
+
+	return 0;
+}
+
+/* Get the allocation table entry address to load the entries from. Entries written after the
+ * last committed marker were flushed but never committed by a store, and are skipped.
+ */
+static int load_start_get(uint32_t *ate_addr)
+{
+	uint32_t marker;
+	ssize_t len;
+
+	*ate_addr = emds_flash.ate_wra;
+
+	while (true) {
+		len = emds_flash_read_from(&emds_flash, ate_addr, EMDS_FLUSH_MARKER_ID, &marker,
+					   sizeof(marker));
+		if (len == -ENXIO) {
+			/* Without any marker, all entries were written by stores. */
+			return (*ate_addr == emds_flash.ate_wra) ? 0 : -ENOENT;
+		} else if (len < 0) {
+			return len;
+		}
+
+		if (len == sizeof(marker) && marker == EMDS_MARKER_COMMITTED) {
+			return 0;
+		}
+
+		LOG_WRN("Flushed entries were not committed by a store, skipping them.");
+
+		/* Continue the search from the entry before the flushed marker. */
+		*ate_addr += emds_flash.ate_size;
+	}
+}
+
+#if CONFIG_EMDS_FLUSH_INTERVAL > 0
+static void flush_thread(void *p1, void *p2, void *p3)
+{
+	int err;
+
+	while (true) {
+		k_sleep(K_MSEC(CONFIG_EMDS_FLUSH_INTERVAL));
+
+		if (!emds_ready) {
+			continue;
+		}
+
+		err = emds_flush();
+		if (err && err != -ECANCELED) {
+			LOG_DBG("Background flush stopped (%d)", err);
+		}
+	}
+}
+
+K_THREAD_DEFINE(emds_flush_thread, CONFIG_EMDS_FLUSH_THREAD_STACK_SIZE, flush_thread,
+		NULL, NULL, NULL, K_LOWEST_APPLICATION_THREAD_PRIO, 0, 0);
+#endif
+#endif /* CONFIG_EMDS_FLUSH */
+
 int emds_init(emds_store_cb_t cb)
 {
 	int rc;
@@ -100,6 +340,15 @@ int emds_init(emds_store_cb_t cb)
 		return -EALREADY;
 	}
 
+#if defined(CONFIG_EMDS_FLUSH)
+	STRUCT_SECTION_FOREACH(emds_entry, ch) {
+		if (ch->id == EMDS_FLUSH_MARKER_ID) {
+			LOG_ERR("Static entry uses reserved ID (%d)", ch->id);
+			return -EINVAL;
+		}
+	}
+#endif
+
 	rc = emds_fs_init();
 	if (rc) {
 		return rc;
@@ -130,6 +379,15 @@ int emds_entry_add(struct emds_dynamic_entry *entry)
 		}
 	}
 
+#if defined(CONFIG_EMDS_FLUSH)
+	if (entry->entry.id == EMDS_FLUSH_MARKER_ID) {
+		return -EINVAL;
+	}
+
+	entry->entry.flush = &entry->flush_state;
+	entry->flush_state.flags = 0;
+#endif
+
 	sys_slist_append(&emds_dynamic_entries, &entry->node);
 
 	emds_ready = false;
@@ -152,6 +410,10 @@ int emds_store(void)
 	LOG_DBG("Emergency Data Storeage released");
 
 	STRUCT_SECTION_FOREACH(emds_entry, ch) {
+		if (entry_is_flushed(ch)) {
+			continue;
+		}
+
 		ssize_t len = emds_flash_write(&emds_flash,
 					       ch->id, ch->data, ch->len);
 		if (len < 0) {
@@ -166,6 +428,10 @@ int emds_store(void)
 	struct emds_dynamic_entry *ch;
 
 	SYS_SLIST_FOR_EACH_CONTAINER(&emds_dynamic_entries, ch, node) {
+		if (entry_is_flushed(&ch->entry)) {
+			continue;
+		}
+
 		ssize_t len = emds_flash_write(&emds_flash,
 					       ch->entry.id, ch->entry.data, ch->entry.len);
 		if (len < 0) {
@@ -178,6 +444,15 @@ int emds_store(void)
 		}
 	}
 
+#if defined(CONFIG_EMDS_FLUSH)
+	/* Always written, as the entries of the previous store are still in the flash. */
+	ssize_t len = emds_flash_write(&emds_flash, EMDS_FLUSH_MARKER_ID,
+				       &committed_marker, sizeof(committed_marker));
+	if (len != sizeof(committed_marker)) {
+		LOG_ERR("Write committed marker failed (%d).", len);
+	}
+#endif
+
 	emds_ready = false;
 
 	/* Unlock all interrupts */
@@ -193,15 +468,28 @@ int emds_store(void)
 int emds_load(void)
 {
 	struct emds_dynamic_entry *ch;
+	uint32_t start = emds_flash.ate_wra;
 
 	if (!emds_initialized) {
 		return -ECANCELED;
 	}
 
+#if defined(CONFIG_EMDS_FLUSH)
+	int err = load_start_get(&start);
+
+	if (err == -ENOENT) {
+		LOG_WRN("No entries were committed by a store, not loading.");
+		return 0;
+	} else if (err) {
+		return err;
+	}
+#endif
+
 	SYS_SLIST_FOR_EACH_CONTAINER(&emds_dynamic_entries, ch, node) {
-		ssize_t len = emds_flash_read(&emds_flash,
-					      ch->entry.id, ch->entry.data,
-					      ch->entry.len);
+		uint32_t ate_addr = start;
+		ssize_t len = emds_flash_read_from(&emds_flash, &ate_addr,
+						   ch->entry.id, ch->entry.data,
+						   ch->entry.len);
 
 		if (len < 0) {
 			if (len != -ENXIO) {
@@ -215,8 +503,9 @@ int emds_load(void)
 	}
 
 	STRUCT_SECTION_FOREACH(emds_entry, ch) {
-		ssize_t len = emds_flash_read(&emds_flash,
-					      ch->id, ch->data, ch->len);
+		uint32_t ate_addr = start;
+		ssize_t len = emds_flash_read_from(&emds_flash, &ate_addr,
+						   ch->id, ch->data, ch->len);
 
 		if (len < 0) {
 			if (len != -ENXIO) {
@@ -252,41 +541,70 @@ int emds_prepare(void)
 
 	(void)emds_entries_size(&size);
 
+#if defined(CONFIG_EMDS_FLUSH)
+	k_mutex_lock(&flush_lock, K_FOREVER);
+	flush_states_reset();
+#endif
+
 	rc = emds_flash_prepare(&emds_flash, size);
-	if (rc) {
-		return rc;
+	if (!rc) {
+		emds_ready = true;
 	}
 
-	emds_ready = true;
+#if defined(CONFIG_EMDS_FLUSH)
+	k_mutex_unlock(&flush_lock);
+#endif
 
-	return 0;
+	return rc;
 }
 
-uint32_t emds_store_time_get(void)
+int emds_flush(void)
 {
-	size_t block_size = emds_flash.flash_params->write_block_size;
-	uint32_t store_time_us = CONFIG_EMDS_FLASH_TIME_BASE_OVERHEAD_US;
+#if defined(CONFIG_EMDS_FLUSH)
+	uint32_t reserved_size;
+	int err = 0;
+
+	if (!emds_ready) {
+		return -ECANCELED;
+	}
 
+	k_mutex_lock(&flush_lock, K_FOREVER);
+
+	(void)emds_entries_size(&reserved_size);
 
 	STRUCT_SECTION_FOREACH(emds_entry, ch) {
-		store_time_us += DIV_ROUND_UP(ch->len, block_size) *
-					CONFIG_EMDS_FLASH_TIME_WRITE_ONE_WORD_US
-			       + DIV_ROUND_UP(emds_flash.ate_size, block_size) *
-					CONFIG_EMDS_FLASH_TIME_WRITE_ONE_WORD_US
-			       + CONFIG_EMDS_FLASH_TIME_ENTRY_OVERHEAD_US;
+		err = entry_flush(ch, reserved_size);
+		if (err) {
+			goto unlock;
+		}
 	}
 
 	struct emds_dynamic_entry *ch;
 
 	SYS_SLIST_FOR_EACH_CONTAINER(&emds_dynamic_entries, ch, node) {
-		store_time_us += DIV_ROUND_UP(ch->entry.len, block_size) *
-					CONFIG_EMDS_FLASH_TIME_WRITE_ONE_WORD_US
-			       + DIV_ROUND_UP(emds_flash.ate_size, block_size) *
-					CONFIG_EMDS_FLASH_TIME_WRITE_ONE_WORD_US
-			       + CONFIG_EMDS_FLASH_TIME_ENTRY_OVERHEAD_US;
+		err = entry_flush(&ch->entry, reserved_size);
+		if (err) {
+			goto unlock;
+		}
 	}
 
-	return store_time_us;
+unlock:
+	k_mutex_unlock(&flush_lock);
+
+	return err;
+#else
+	return -ENOTSUP;
+#endif
+}
+
+uint32_t emds_store_time_get(void)
+{
+	return store_time_get(true);
+}
+
+uint32_t emds_store_time_current_get(void)
+{
+	return store_time_get(false);
 }
 
 uint32_t emds_store_size_get(void)
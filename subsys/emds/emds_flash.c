@@ -212,6 +212,8 @@ static int flash_direct_write(const struct device *dev, off_t offset, const void
 	return 0;
 }
 
+typedef int (*flash_write_t)(const struct device *dev, off_t offset, const void *data, size_t len);
+
 static size_t align_size(struct emds_fs *fs, size_t len)
 {
 	uint8_t write_block_size = fs->flash_params->write_block_size;
@@ -240,47 +242,58 @@ static int ate_wrt(struct emds_fs *fs, const struct emds_ate *entry)
 	return 0;
 }
 
-static int data_wrt(struct emds_fs *fs, const void *data, size_t len)
+static int data_wrt_at(struct emds_fs *fs, flash_write_t write, off_t offset, const void *data,
+		       size_t len)
 {
 	const uint8_t *data8 = (const uint8_t *)data;
 	int rc;
-	off_t offset;
 	size_t blen;
-	size_t temp_len = len;
 	uint8_t buf[EMDS_FLASH_BLOCK_SIZE];
 
-	if (!temp_len) {
-		/* Nothing to write, avoid changing the flash protection */
-		return 0;
-	}
-
-	offset = fs->offset;
-	offset += fs->data_wra_offset & ADDR_OFFS_MASK;
-
-	blen = temp_len & ~(fs->flash_params->write_block_size - 1U);
+	blen = len & ~(fs->flash_params->write_block_size - 1U);
 	/* Writes multiples of 4 bytes to flash */
 	if (blen > 0) {
-		rc = flash_direct_write(fs->flash_dev, offset, data8, blen);
+		rc = write(fs->flash_dev, offset, data8, blen);
 		if (rc) {
 			return rc;
 		}
 
-		temp_len -= blen;
+		len -= blen;
 		offset += blen;
 		data8 += blen;
 	}
 
-	if (temp_len) {
-		(void)memcpy(buf, data8, temp_len);
-		(void)memset(buf + temp_len, fs->flash_params->erase_value,
-			     fs->flash_params->write_block_size - temp_len);
-		rc = flash_direct_write(fs->flash_dev, offset, buf,
-					fs->flash_params->write_block_size);
+	if (len) {
+		(void)memcpy(buf, data8, len);
+		(void)memset(buf + len, fs->flash_params->erase_value,
+			     fs->flash_params->write_block_size - len);
+		rc = write(fs->flash_dev, offset, buf, fs->flash_params->write_block_size);
 		if (rc) {
 			return rc;
 		}
 	}
 
+	return 0;
+}
+
+static int data_wrt(struct emds_fs *fs, const void *data, size_t len)
+{
+	int rc;
+	off_t offset;
+
+	if (!len) {
+		/* Nothing to write, avoid changing the flash protection */
+		return 0;
+	}
+
+	offset = fs->offset;
+	offset += fs->data_wra_offset & ADDR_OFFS_MASK;
+
+	rc = data_wrt_at(fs, flash_direct_write, offset, data, len);
+	if (rc) {
+		return rc;
+	}
+
 	fs->data_wra_offset += align_size(fs, len);
 	return 0;
 }
@@ -336,6 +349,41 @@ static int entry_wrt(struct emds_fs *fs, uint16_t id, const void *data, size_t l
 	return 0;
 }
 
+/* Invalidates the allocation table entry reserved by emds_flash_background_write(). The entry may
+ * be partially written, but writing zeros is always possible.
+ */
+static int reserved_ate_invalidate(struct emds_fs *fs, flash_write_t write, uint32_t addr)
+{
+	uint8_t inval_buf[fs->ate_size];
+
+	memset(inval_buf, 0, sizeof(inval_buf));
+
+	return write(fs->flash_dev, addr, inval_buf, sizeof(inval_buf));
+}
+
+/* Checks that the data written to flash matches the data CRC of the allocation table entry. */
+static int data_verify(struct emds_fs *fs, off_t offset, size_t len, uint8_t crc8_data)
+{
+	uint8_t buf[EMDS_FLASH_BLOCK_SIZE];
+	uint8_t crc8 = 0xff;
+	size_t bytes_to_read;
+	int rc;
+
+	while (len) {
+		bytes_to_read = MIN(sizeof(buf), len);
+		rc = flash_read(fs->flash_dev, offset, buf, bytes_to_read);
+		if (rc) {
+			return rc;
+		}
+
+		crc8 = crc8_ccitt(crc8, buf, bytes_to_read);
+		len -= bytes_to_read;
+		offset += bytes_to_read;
+	}
+
+	return (crc8 == crc8_data) ? 0 : -EAGAIN;
+}
+
 static enum ate_type ate_check(struct emds_fs *fs, uint32_t addr, struct emds_ate *entry)
 {
 	uint8_t read_buf[fs->ate_size];
@@ -525,8 +573,23 @@ ssize_t emds_flash_write(struct emds_fs *fs, uint16_t id, const void *data, size
 		return 0;
 	}
 
-	int rc = entry_wrt(fs, id, data, len);
+	int rc;
+
+	if (fs->ate_reserved) {
+		/* A background write was interrupted. Its entry is discarded so that the entries
+		 * written after it can be found.
+		 */
+		rc = reserved_ate_invalidate(fs, flash_direct_write, fs->reserved_ate_addr);
+		if (rc) {
+			return rc;
+		}
 
+		fs->ate_reserved = false;
+	}
+
+	fs->direct_written = true;
+
+	rc = entry_wrt(fs, id, data, len);
 	if (rc) {
 		return rc;
 	}
@@ -534,7 +597,91 @@ ssize_t emds_flash_write(struct emds_fs *fs, uint16_t id, const void *data, size
 	return len;
 }
 
-ssize_t emds_flash_read(struct emds_fs *fs, uint16_t id, void *data, size_t len)
+ssize_t emds_flash_background_write(struct emds_fs *fs, uint16_t id, const void *data, size_t len)
+{
+	struct emds_ate entry;
+	uint8_t ate_buf[fs->ate_size];
+	uint32_t ate_addr;
+	off_t data_addr;
+	unsigned int key;
+	int rc;
+
+	if (!fs->is_initialized || !fs->is_prepeared) {
+		LOG_ERR("EMDS flash not initialized or not ready for write");
+		return -EACCES;
+	}
+
+	if (len == 0) {
+		return 0;
+	}
+
+	/* Reserve space for the entry before writing it, as emds_flash_write() may interrupt
+	 * the write at any point.
+	 */
+	key = irq_lock();
+
+	if (fs->direct_written || fs->ate_reserved) {
+		irq_unlock(key);
+		return -EBUSY;
+	}
+
+	if (fs->ate_size + align_size(fs, len) > emds_flash_free_space_get(fs)) {
+		irq_unlock(key);
+		return -ENOMEM;
+	}
+
+	entry.id = id;
+	entry.offset = fs->data_wra_offset;
+	entry.len = (uint16_t)len;
+	data_addr = fs->offset + (fs->data_wra_offset & ADDR_OFFS_MASK);
+	ate_addr = fs->ate_wra;
+
+	fs->data_wra_offset += align_size(fs, len);
+	fs->ate_wra -= fs->ate_size;
+	fs->reserved_ate_addr = ate_addr;
+	fs->ate_reserved = true;
+
+	irq_unlock(key);
+
+	entry.crc8_data = crc8_ccitt(0xff, data, len);
+	entry.crc8 = crc8_ccitt(0xff, &entry, offsetof(struct emds_ate, crc8));
+
+	rc = data_wrt_at(fs, flash_write, data_addr, data, len);
+	if (!rc) {
+		/* The data may have changed while it was written. */
+		rc = data_verify(fs, data_addr, len, entry.crc8_data);
+	}
+
+	if (!rc) {
+		memset(ate_buf, fs->flash_params->erase_value, sizeof(ate_buf));
+		memcpy(ate_buf, &entry, sizeof(entry));
+		rc = flash_write(fs->flash_dev, ate_addr, ate_buf, sizeof(ate_buf));
+	}
+
+	if (rc && fs->ate_reserved && fs->reserved_ate_addr == ate_addr) {
+		(void)reserved_ate_invalidate(fs, flash_write, ate_addr);
+	}
+
+	key = irq_lock();
+
+	if (fs->ate_reserved && fs->reserved_ate_addr == ate_addr) {
+		fs->ate_reserved = false;
+	} else if (!rc) {
+		/* The entry was discarded by emds_flash_write(). */
+		rc = -ECANCELED;
+	}
+
+	irq_unlock(key);
+
+	if (rc) {
+		return rc;
+	}
+
+	return len;
+}
+
+ssize_t emds_flash_read_from(struct emds_fs *fs, uint32_t *ate_addr, uint16_t id, void *data,
+			     size_t len)
 {
 	if (!fs->is_initialized) {
 		LOG_ERR("EMDS flash not initialized");
@@ -542,10 +689,14 @@ ssize_t emds_flash_read(struct emds_fs *fs, uint16_t id, void *data, size_t len)
 	}
 
 	int rc;
-	uint32_t wlk_addr = fs->ate_wra;
+	uint32_t wlk_addr = *ate_addr;
 	struct emds_ate wlk_ate;
 
 	while (true) {
+		if (wlk_addr >= fs->offset + fs->sector_cnt * fs->sector_size) {
+			return -ENXIO;
+		}
+
 		rc = flash_read(fs->flash_dev, wlk_addr, &wlk_ate, sizeof(struct emds_ate));
 		if (rc) {
 			return rc;
@@ -556,11 +707,10 @@ ssize_t emds_flash_read(struct emds_fs *fs, uint16_t id, void *data, size_t len)
 		}
 
 		wlk_addr += fs->ate_size;
-		if (wlk_addr >= fs->offset + fs->sector_cnt * fs->sector_size) {
-			return -ENXIO;
-		}
 	}
 
+	*ate_addr = wlk_addr;
+
 	if (len < wlk_ate.len) {
 		return -ENOMEM;
 	}
@@ -577,6 +727,13 @@ ssize_t emds_flash_read(struct emds_fs *fs, uint16_t id, void *data, size_t len)
 	return wlk_ate.len;
 }
 
+ssize_t emds_flash_read(struct emds_fs *fs, uint16_t id, void *data, size_t len)
+{
+	uint32_t ate_addr = fs->ate_wra;
+
+	return emds_flash_read_from(fs, &ate_addr, id, data, len);
+}
+
 int emds_flash_prepare(struct emds_fs *fs, int byte_size)
 {
 	if (!fs->is_initialized) {
@@ -588,10 +745,16 @@ int emds_flash_prepare(struct emds_fs *fs, int byte_size)
 		return -ENOMEM;
 	}
 
-	int rc = old_entries_invalidate(fs);
+	int rc;
 
-	if (rc) {
-		return rc;
+	/* With flushing, the entries of the last store are kept until the next store commits
+	 * the flushed entries, so that they can be loaded if the device resets before that.
+	 */
+	if (!IS_ENABLED(CONFIG_EMDS_FLUSH)) {
+		rc = old_entries_invalidate(fs);
+		if (rc) {
+			return rc;
+		}
 	}
 
 	if (fs->force_erase || (byte_size > emds_flash_free_space_get(fs))) {
@@ -599,6 +762,8 @@ int emds_flash_prepare(struct emds_fs *fs, int byte_size)
 		fs->force_erase = false;
 	}
 
+	fs->ate_reserved = false;
+	fs->direct_written = false;
 	fs->is_prepeared = true;
 	return 0;
 }
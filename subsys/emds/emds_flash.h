@@ -31,6 +31,10 @@ extern "C" {
  * @param flash_dev Pointer to flash device runtime structure
  * @param flash_params Pointer to flash memory parameters structure
  * @param force_erase Force erase flag
+ * @param ate_reserved An allocation table entry is reserved by a background write
+ * @param direct_written An entry has been written since the last prepare, background writes are
+ * no longer allowed
+ * @param reserved_ate_addr Address of the reserved allocation table entry
  */
 struct emds_fs {
 	off_t offset;
@@ -45,6 +49,9 @@ struct emds_fs {
 	const struct device *flash_dev;
 	const struct flash_parameters *flash_params;
 	bool force_erase;
+	bool ate_reserved;
+	bool direct_written;
+	uint32_t reserved_ate_addr;
 };
 
 /**
@@ -82,6 +89,30 @@ int emds_flash_clear(struct emds_fs *fs);
  */
 ssize_t emds_flash_write(struct emds_fs *fs, uint16_t id, const void *data, size_t len);
 
+/**
+ * @brief Write an entry to the EMDS file system through the flash driver.
+ *
+ * Unlike @ref emds_flash_write, this function can be used while other users of the flash driver,
+ * such as MPSL, are active, but it does not have a deterministic write time. It must not be
+ * called from an interrupt.
+ *
+ * Space for the entry is reserved before it is written, so that @ref emds_flash_write may
+ * interrupt this function at any point. The interrupted entry is then discarded. The entry is
+ * also discarded if the data changes while it is written.
+ *
+ * @param fs Pointer to file system
+ * @param id Id of the entry to be written
+ * @param data Pointer to the data to be written
+ * @param len Number of bytes to be written
+ *
+ * @return Number of bytes written. On success, it will be equal to the number of bytes requested
+ * to be written. Returns -ECANCELED if the entry was discarded by @ref emds_flash_write, -EAGAIN
+ * if the data changed while it was written, -EBUSY if @ref emds_flash_write has been called since
+ * the last prepare or another background write is in progress, or another negative value of
+ * errno.h defined error codes.
+ */
+ssize_t emds_flash_background_write(struct emds_fs *fs, uint16_t id, const void *data, size_t len);
+
 /**
  * @brief Read an entry from the EMDS file system.
  *
@@ -99,15 +130,35 @@ ssize_t emds_flash_write(struct emds_fs *fs, uint16_t id, const void *data, size
  */
 ssize_t emds_flash_read(struct emds_fs *fs, uint16_t id, void *data, size_t len);
 
+/**
+ * @brief Read an entry from the EMDS file system, ignoring newer entries.
+ *
+ * Same as @ref emds_flash_read, but the search for the entry starts at the given allocation table
+ * entry address instead of the newest entry, and continues towards older entries.
+ *
+ * @param fs Pointer to file system
+ * @param ate_addr Address of the allocation table entry to start the search from. On success, it
+ * is set to the address of the allocation table entry of the entry that was read.
+ * @param id Id of the entry to be read
+ * @param data Pointer to data buffer
+ * @param len Number of bytes in data buffer
+ *
+ * @return Number of bytes read, or negative value of errno.h defined error codes, as for
+ * @ref emds_flash_read.
+ */
+ssize_t emds_flash_read_from(struct emds_fs *fs, uint32_t *ate_addr, uint16_t id, void *data,
+			     size_t len);
+
 /**
  * @brief Prepare EMDS file system for next write events.
  *
  * This function should be called at the moment when the user has restored the desired data
  * entries from flash. It will invalidate all prior entries, and potentially clear the flash
- * area.
+ * area. With CONFIG_EMDS_FLUSH, prior entries are not invalidated, so that they can still be
+ * read until they are replaced by newer entries.
  *
- * @note Calling this function will make any subsequent read attempts fail. Be sure to
- * restore all necessary entries before using this function.
+ * @note Unless CONFIG_EMDS_FLUSH is enabled, calling this function will make any subsequent read
+ * attempts fail. Be sure to restore all necessary entries before using this function.
  *
  * @note Should only be called once.
  *
@@ -22,6 +22,6 @@ int coap_initiate_retransmission(struct download_client *dl);
 int coap_parse(struct download_client *client, size_t len);
 int coap_request_send(struct download_client *client);
 
-int socket_send(const struct download_client *client, size_t len, int timeout);
+int socket_send(const struct download_client *client, const char *buf, size_t len, int timeout);
 
 #endif /* DOWNLOAD_CLIENT_INTERNAL_H */
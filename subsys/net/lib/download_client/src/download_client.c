@@ -465,7 +465,7 @@ cleanup:
 	return err;
 }
 
-int socket_send(const struct download_client *client, size_t len, int timeout)
+int socket_send(const struct download_client *client, const char *buf, size_t len, int timeout)
 {
 	int err;
 	int sent;
@@ -477,7 +477,7 @@ int socket_send(const struct download_client *client, size_t len, int timeout)
 	}
 
 	while (len) {
-		sent = send(client->fd, client->buf + off, len, 0);
+		sent = send(client->fd, buf + off, len, 0);
 		if (sent < 0) {
 			return -errno;
 		}
@@ -513,17 +513,27 @@ static int fragment_evt_send(struct download_client *client)
 	__ASSERT(client->offset <= CONFIG_DOWNLOAD_CLIENT_BUF_SIZE,
 		 "Buffer overflow!");
 
+	int err;
+	size_t overflow = client->http.overflow;
 	const struct download_client_evt evt = {
 		.id = DOWNLOAD_CLIENT_EVT_FRAGMENT,
 		.fragment = {
 			.buf = client->buf,
-			.len = client->offset,
+			.len = client->offset - overflow,
 		}
 	};
 
-	client->offset = 0;
+	client->offset = overflow;
+	client->http.overflow = 0;
+
+	err = client->callback(&evt);
 
-	return client->callback(&evt);
+	if (overflow) {
+		/* Keep the start of the next pipelined response */
+		memmove(client->buf, client->buf + evt.fragment.len, overflow);
+	}
+
+	return err;
 }
 
 static int error_evt_send(const struct download_client *dl, int error)
@@ -539,11 +549,23 @@ static int error_evt_send(const struct download_client *dl, int error)
 	return dl->callback(&evt);
 }
 
+static void pipeline_reset(struct download_client *dl)
+{
+	/* Responses to the requests in flight are lost with the connection,
+	 * the download resumes from the current progress.
+	 */
+	dl->http.in_flight = 0;
+	dl->http.overflow = 0;
+	dl->http.has_header = false;
+	dl->offset = 0;
+}
+
 static int reconnect(struct download_client *dl)
 {
 	int err;
 
 	LOG_INF("Reconnecting...");
+	pipeline_reset(dl);
 	if (dl->fd >= 0) {
 		err = close(dl->fd);
 		if (err) {
@@ -828,7 +850,9 @@ void download_thread(void *client, void *a, void *b)
 		while (is_downloading(dl)) {
 			if (send_request) {
 				/* Request next fragment */
-				dl->offset = 0;
+				if (dl->http.in_flight == 0) {
+					dl->offset = 0;
+				}
 				rc = request_send(dl);
 				send_request = false;
 				if (rc) {
@@ -846,6 +870,19 @@ void download_thread(void *client, void *a, void *b)
 					send_request = true;
 					continue;
 				}
+
+				if (dl->offset > 0) {
+					/* Parse the pipelined responses that were received
+					 * together with the previous fragment.
+					 */
+					rc = handle_received(dl, 0);
+					if (rc < 0) {
+						break;
+					} else if (rc == 0) {
+						send_request = true;
+						continue;
+					}
+				}
 			}
 
 			__ASSERT(dl->offset < sizeof(dl->buf), "Buffer overflow");
@@ -882,6 +919,17 @@ void download_thread(void *client, void *a, void *b)
 			}
 		}
 
+		if (dl->http.in_flight && dl->fd != -1) {
+			/* The responses to the remaining requests would be taken
+			 * for the responses to the next download, close the socket.
+			 */
+			k_mutex_lock(&dl->mutex, K_FOREVER);
+			(void)close(dl->fd);
+			dl->fd = -1;
+			pipeline_reset(dl);
+			k_mutex_unlock(&dl->mutex);
+		}
+
 		if (is_downloading(dl)) {
 			if (dl->close_when_done) {
 				set_state(dl, DOWNLOAD_CLIENT_CLOSING);
@@ -993,7 +1041,9 @@ int download_client_start(struct download_client *client, const char *file,
 	client->progress = from;
 	client->offset = 0;
 	client->http.has_header = false;
-	if (is_idle(client)) {
+	client->http.in_flight = 0;
+	client->http.overflow = 0;
+	if (is_idle(client) || client->fd == -1) {
 		set_state(client, DOWNLOAD_CLIENT_CONNECTING);
 	} else {
 		set_state(client, DOWNLOAD_CLIENT_DOWNLOADING);
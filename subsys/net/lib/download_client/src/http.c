@@ -43,18 +43,100 @@ LOG_MODULE_DECLARE(download_client, CONFIG_DOWNLOAD_CLIENT_LOG_LEVEL);
 
 extern char *strnstr(const char *haystack, const char *needle, size_t haystack_sz);
 
-int http_get_request_send(struct download_client *client)
+static size_t frag_size_get(const struct download_client *client)
+{
+	if (client->config.frag_size_override) {
+		return client->config.frag_size_override;
+	}
+
+	return CONFIG_DOWNLOAD_CLIENT_HTTP_FRAG_SIZE;
+}
+
+/* Whether another range request can be sent before the responses
+ * to the requests in flight have been received.
+ */
+static bool range_request_pending(const struct download_client *client)
+{
+	if (client->http.in_flight == 0) {
+		return true;
+	}
+
+	/* The file size is known after the first response, only then
+	 * it is known which ranges are left to request.
+	 */
+	return (client->http.in_flight < CONFIG_DOWNLOAD_CLIENT_HTTP_PIPELINE_DEPTH) &&
+	       (client->file_size != 0) &&
+	       (client->http.request_offset < client->file_size);
+}
+
+static int range_requests_send(struct download_client *client, const char *host,
+			       const char *file)
 {
 	int err;
 	int len;
 	size_t off;
+	char *buf;
+	size_t buf_size;
+
+	while (range_request_pending(client)) {
+		/* The request is written after any response bytes
+		 * that have already been received.
+		 */
+		buf = client->buf + client->offset;
+		buf_size = sizeof(client->buf) - client->offset;
+
+		/* Offset of last byte in range (Content-Range) */
+		off = client->http.request_offset + frag_size_get(client) - 1;
+
+		if (client->file_size != 0) {
+			/* Don't request bytes past the end of file */
+			off = MIN(off, client->file_size - 1);
+		}
+
+		len = snprintf(buf, buf_size, HTTP_GET_RANGE, file, host,
+			       client->http.request_offset, off);
+
+		if (len < 0 || len >= buf_size) {
+			if (client->http.in_flight) {
+				/* Try again when the buffer has been emptied */
+				return 0;
+			}
+
+			LOG_ERR("Cannot create GET request, buffer too small");
+			return -ENOMEM;
+		}
+
+		if (IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_LOG_HEADERS)) {
+			LOG_HEXDUMP_DBG(buf, len, "HTTP request");
+		}
+
+		err = socket_send(client, buf, len, 0);
+		if (err) {
+			LOG_ERR("Failed to send HTTP request, errno %d", errno);
+			return err;
+		}
+
+		client->http.in_flight++;
+		client->http.request_offset = off + 1;
+	}
+
+	return 0;
+}
+
+int http_get_request_send(struct download_client *client)
+{
+	int err;
+	int len;
 	char host[HOSTNAME_SIZE];
 	char file[FILENAME_SIZE];
 
 	__ASSERT_NO_MSG(client->host);
 	__ASSERT_NO_MSG(client->file);
 
-	client->http.has_header = false;
+	if (client->http.in_flight == 0) {
+		client->http.has_header = false;
+		client->http.request_offset = client->progress;
+	}
 
 	err = url_parse_host(client->host, host, sizeof(host));
 	if (err) {
@@ -66,25 +148,10 @@ int http_get_request_send(struct download_client *client)
 		return err;
 	}
 
-	/* Offset of last byte in range (Content-Range) */
-	if (client->config.frag_size_override) {
-		off = client->progress + client->config.frag_size_override - 1;
-	} else {
-		off = client->progress +
-			CONFIG_DOWNLOAD_CLIENT_HTTP_FRAG_SIZE - 1;
-	}
-
-	if (client->file_size != 0) {
-		/* Don't request bytes past the end of file */
-		off = MIN(off, client->file_size - 1);
-	}
-
 	if (client->proto == IPPROTO_TLS_1_2
 	   || IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_RANGE_REQUESTS)) {
-		len = snprintf(client->buf,
-			CONFIG_DOWNLOAD_CLIENT_BUF_SIZE,
-			HTTP_GET_RANGE, file, host, client->progress, off);
 		client->http.ranged = true;
+		return range_requests_send(client, host, file);
 	} else if (client->progress) {
 		len = snprintf(client->buf,
 			CONFIG_DOWNLOAD_CLIENT_BUF_SIZE,
@@ -106,7 +173,7 @@ int http_get_request_send(struct download_client *client)
 		LOG_HEXDUMP_DBG(client->buf, len, "HTTP request");
 	}
 
-	err = socket_send(client, len, 0);
+	err = socket_send(client, client->buf, len, 0);
 	if (err) {
 		LOG_ERR("Failed to send HTTP request, errno %d", errno);
 		return err;
@@ -129,7 +196,7 @@ static int http_header_parse(struct download_client *client, size_t *hdr_len)
 	const unsigned int expected_status = (client->http.ranged || client->progress) ? 206 : 200;
 
 	p = strnstr(client->buf, "\r\n\r\n", sizeof(client->buf));
-	if (!p || p > client->buf + client->offset) {
+	if (!p || p + strlen("\r\n\r\n") > client->buf + client->offset) {
 		/* Waiting full HTTP header */
 		LOG_DBG("Waiting full header in response");
 		return 1;
@@ -220,7 +287,8 @@ static int http_header_parse(struct download_client *client, size_t *hdr_len)
 		LOG_DBG("File size = %u", client->file_size);
 	}
 
-	p = strnstr(client->buf, "\r\nconnection: close", sizeof(client->buf));
+	/* Only look in this header, the next response may follow it */
+	p = strnstr(client->buf, "\r\nconnection: close", *hdr_len);
 	if (p) {
 		LOG_WRN("Peer closed connection, will re-connect");
 		client->http.connection_close = true;
@@ -272,32 +340,47 @@ int http_parse(struct download_client *client, size_t len)
 			 */
 			client->offset = 0;
 		}
+
+		/* All bytes left in the buffer are new payload bytes */
+		len = client->offset;
+
+		/* Responses arrive in the order of the requests,
+		 * so this one starts at the current progress.
+		 */
+		client->http.payload_left =
+			MIN(frag_size_get(client), client->file_size - client->progress);
 	}
 
-	/* Accumulate overall file progress.
-	 * If the last recv() call read an HTTP header,
-	 * `offset` has been moved at the end of any trailing
-	 * payload bytes by http_header_parse(). In this case,
-	 * `offset` is less than `len` and it represents
-	 * the actual payload bytes.
-	 */
-	client->progress += MIN(client->offset, len);
+	if (client->http.ranged) {
+		/* With pipelined requests, the next response may follow
+		 * the end of this one in the buffer.
+		 */
+		size_t payload_len = MIN(len, client->http.payload_left);
 
-	/* Have we received a whole fragment or the whole file? */
-	if (client->progress != client->file_size) {
-		if (client->http.ranged) {
-			if (client->offset < (client->config.frag_size_override != 0 ?
-						      client->config.frag_size_override :
-						      CONFIG_DOWNLOAD_CLIENT_HTTP_FRAG_SIZE)) {
-				/* Ranged query: read until a full fragment */
-				return 1;
-			}
-		} else {
-			/* Non-ranged query: just keep on reading, ignore fragment size */
+		client->http.overflow = len - payload_len;
+		client->http.payload_left -= payload_len;
+		client->progress += payload_len;
+
+		if (client->http.payload_left) {
+			/* Ranged query: read until a full fragment */
 			return 1;
 		}
+
+		/* Parse the header of the next response */
+		client->http.has_header = false;
+		client->http.in_flight--;
+
+		return 0;
+	}
+
+	/* Accumulate overall file progress */
+	client->progress += len;
+
+	if (client->progress != client->file_size) {
+		/* Non-ranged query: just keep on reading, ignore fragment size */
+		return 1;
 	}
 
-	/* Either we have a full file, or we need to request a next fragment */
+	/* We have a full file */
 	return 0;
 }
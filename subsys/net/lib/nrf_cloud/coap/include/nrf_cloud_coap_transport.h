@@ -47,6 +47,54 @@ enum coap_content_format {
  */
 bool nrf_cloud_coap_is_connected(void);
 
+/**@brief Completion callback of an asynchronous CoAP request.
+ *
+ * Called from the CoAP client thread once the transfer is complete, after the last
+ * call of the response callback. A new request can be queued from the callback.
+ *
+ * @param result 0 if the request succeeded, a positive value indicating a CoAP result code
+ * of a failed Non-confirmable request, or a negative error number.
+ * @param user Pointer to user-specific data given with the request.
+ */
+typedef void (*nrf_cloud_coap_done_cb_t)(int result, void *user);
+
+#if defined(CONFIG_NRF_CLOUD_COAP)
+/**@brief Queue a CoAP request without waiting for the response.
+ *
+ * Up to CONFIG_NRF_CLOUD_COAP_NSTART requests can be outstanding at the same time,
+ * each with its own token. The response is given to @p cb as it arrives and
+ * @p done_cb is called once the transfer is complete. A Non-confirmable request
+ * with no callbacks is sent and forgotten.
+ *
+ * The resource and query strings are copied, but the payload must stay valid until
+ * the transfer is complete, since it is read again for block-wise transfers.
+ *
+ * @param method CoAP method of the request.
+ * @param resource String containing the specific CoAP endpoint to access.
+ * @param query Optional string containing REST-style query parameters.
+ * @param buf Optional pointer to buffer containing a payload to include with the request.
+ * @param len Length of payload or 0 if none.
+ * @param fmt_out CoAP content format for the Content-Format message option of the payload.
+ * @param fmt_in CoAP content format for the Accept message option of the returned payload.
+ * @param response_expected True to include the Accept message option.
+ * @param reliable True to use a Confirmable message, otherwise, a Non-confirmable message.
+ * @param cb Optional pointer to a callback function to receive the results.
+ * @param done_cb Optional pointer to a callback function called when the transfer is complete.
+ * @param user Pointer to user-specific data to be passed back to the callbacks.
+ * @retval 0 if the request was queued.
+ * @retval -EAGAIN if the maximum number of requests is already outstanding.
+ * @return A negative error number if the request could not be sent.
+ */
+int nrf_cloud_coap_async_req(enum coap_method method,
+			     const char *resource, const char *query,
+			     const uint8_t *buf, size_t len,
+			     enum coap_content_format fmt_out,
+			     enum coap_content_format fmt_in,
+			     bool response_expected, bool reliable,
+			     coap_client_response_cb_t cb,
+			     nrf_cloud_coap_done_cb_t done_cb, void *user);
+#endif /* CONFIG_NRF_CLOUD_COAP */
+
 /**@brief Perform CoAP GET request.
  *
  * The function will block until the response or an error have been returned.
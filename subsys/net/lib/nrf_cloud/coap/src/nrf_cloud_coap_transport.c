@@ -455,21 +455,60 @@ int nrf_cloud_coap_resume(void)
 	return err;
 }
 
-static K_SEM_DEFINE(serial_sem, 1, 1);
-static K_SEM_DEFINE(cb_sem, 0, 1);
-
-struct user_cb {
+/* Context of a request in flight. One is taken for each request given to the CoAP client
+ * and released when the transfer completes, which bounds the number of outstanding
+ * requests to CONFIG_NRF_CLOUD_COAP_NSTART.
+ */
+struct transfer {
+	atomic_t in_use;
+	bool reliable;
+	int result_code;
 	coap_client_response_cb_t cb;
+	nrf_cloud_coap_done_cb_t done_cb;
 	void *user_data;
-	int result_code;
+	/* The CoAP client keeps using the path for block-wise transfers. */
+	char path[MAX_COAP_PATH + 1];
 };
 
+BUILD_ASSERT(CONFIG_NRF_CLOUD_COAP_NSTART <= CONFIG_COAP_CLIENT_MAX_REQUESTS,
+	     "The CoAP client must hold CONFIG_NRF_CLOUD_COAP_NSTART requests");
+
+static struct transfer transfers[CONFIG_NRF_CLOUD_COAP_NSTART];
+static K_SEM_DEFINE(nstart_sem, CONFIG_NRF_CLOUD_COAP_NSTART, CONFIG_NRF_CLOUD_COAP_NSTART);
+
+static struct transfer *transfer_alloc(k_timeout_t timeout)
+{
+	if (k_sem_take(&nstart_sem, timeout)) {
+		return NULL;
+	}
+
+	for (int i = 0; i < ARRAY_SIZE(transfers); i++) {
+		if (atomic_cas(&transfers[i].in_use, 0, 1)) {
+			return &transfers[i];
+		}
+	}
+
+	/* The semaphore guarantees a free context. */
+	__ASSERT_NO_MSG(false);
+	k_sem_give(&nstart_sem);
+	return NULL;
+}
+
+static void transfer_free(struct transfer *xfer)
+{
+	atomic_set(&xfer->in_use, 0);
+	k_sem_give(&nstart_sem);
+}
+
 static void client_callback(int16_t result_code, size_t offset, const uint8_t *payload, size_t len,
 			    bool last_block, void *user_data)
 {
-	struct user_cb *user_cb = (struct user_cb *)user_data;
+	struct transfer *xfer = (struct transfer *)user_data;
+	nrf_cloud_coap_done_cb_t done_cb;
+	void *done_user_data;
+	int result = 0;
 
-	user_cb->result_code = result_code;
+	xfer->result_code = result_code;
 	if (result_code >= 0) {
 		LOG_CB_DBG(result_code, offset, len, last_block);
 	} else {
@@ -485,36 +524,48 @@ static void client_callback(int16_t result_code, size_t offset, const uint8_t *p
 	} else if ((result_code >= COAP_RESPONSE_CODE_BAD_REQUEST) && len) {
 		LOG_ERR("Unexpected response: %*s", len, payload);
 	}
-	if ((user_cb != NULL) && (user_cb->cb != NULL)) {
-		LOG_DBG("Calling user's callback %p", user_cb->cb);
-		user_cb->cb(result_code, offset, payload, len, last_block, user_cb->user_data);
+	if (xfer->cb != NULL) {
+		LOG_DBG("Calling user's callback %p", xfer->cb);
+		xfer->cb(result_code, offset, payload, len, last_block, xfer->user_data);
 	}
 	if (last_block || (result_code >= COAP_RESPONSE_CODE_BAD_REQUEST)) {
 		LOG_DBG("End of client transfer");
-		k_sem_give(&cb_sem);
+
+		if (!xfer->reliable && (result_code >= COAP_RESPONSE_CODE_BAD_REQUEST)) {
+			/* NON transfers usually do not use a callback,
+			 * so make sure a bad result is not ignored.
+			 */
+			result = result_code;
+		}
+
+		/* Release the context before completing, so that the
+		 * completion callback can queue the next request.
+		 */
+		done_cb = xfer->done_cb;
+		done_user_data = xfer->user_data;
+		transfer_free(xfer);
+
+		if (done_cb != NULL) {
+			done_cb(result, done_user_data);
+		}
 	}
 }
 
-static int client_transfer(enum coap_method method,
-			   const char *resource, const char *query,
-			   const uint8_t *buf, size_t buf_len,
-			   enum coap_content_format fmt_out,
-			   enum coap_content_format fmt_in,
-			   bool response_expected,
-			   bool reliable,
-			   coap_client_response_cb_t cb, void *user)
+static int transfer_start(enum coap_method method,
+			  const char *resource, const char *query,
+			  const uint8_t *buf, size_t buf_len,
+			  enum coap_content_format fmt_out,
+			  enum coap_content_format fmt_in,
+			  bool response_expected,
+			  bool reliable,
+			  coap_client_response_cb_t cb,
+			  nrf_cloud_coap_done_cb_t done_cb, void *user,
+			  k_timeout_t timeout)
 {
 	__ASSERT_NO_MSG(resource != NULL);
 
-	k_sem_take(&serial_sem, K_FOREVER);
-
 	int err;
-	int retry;
-	char path[MAX_COAP_PATH + 1];
-	struct user_cb user_cb = {
-		.cb = cb,
-		.user_data = user
-	};
+	struct transfer *xfer;
 	struct coap_client_option options[1] = {{
 		.code = COAP_OPTION_ACCEPT,
 		.len = 1,
@@ -523,14 +574,25 @@ static int client_transfer(enum coap_method method,
 	struct coap_client_request request = {
 		.method = method,
 		.confirmable = reliable,
-		.path = path,
 		.fmt = fmt_out,
 		.payload = (uint8_t *)buf,
 		.len = buf_len,
-		.cb = client_callback,
-		.user_data = &user_cb
+		.cb = client_callback
 	};
 
+	xfer = transfer_alloc(timeout);
+	if (!xfer) {
+		return -EAGAIN;
+	}
+
+	xfer->reliable = reliable;
+	xfer->result_code = 0;
+	xfer->cb = cb;
+	xfer->done_cb = done_cb;
+	xfer->user_data = user;
+	request.path = xfer->path;
+	request.user_data = xfer;
+
 	if (response_expected) {
 		request.options = options;
 		request.num_options = ARRAY_SIZE(options);
@@ -540,27 +602,104 @@ static int client_transfer(enum coap_method method,
 	}
 
 	if (!query) {
-		strncpy(path, resource, MAX_COAP_PATH);
-		path[MAX_COAP_PATH] = '\0';
+		strncpy(xfer->path, resource, MAX_COAP_PATH);
+		xfer->path[MAX_COAP_PATH] = '\0';
 	} else {
-		err = snprintf(path, MAX_COAP_PATH, "%s?%s", resource, query);
+		err = snprintf(xfer->path, MAX_COAP_PATH, "%s?%s", resource, query);
 		if ((err < 0) || (err >= MAX_COAP_PATH)) {
 			LOG_ERR("Could not format string");
+			transfer_free(xfer);
 			return -ETXTBSY;
 		}
 	}
 
 #if defined(CONFIG_NRF_CLOUD_COAP_LOG_LEVEL_DBG)
 	LOG_DBG("%s %s %s Content-Format:%s, %zd bytes out, Accept:%s", reliable ? "CON" : "NON",
-		METHOD_NAME(method), path, fmt_name(fmt_out), buf_len,
+		METHOD_NAME(method), xfer->path, fmt_name(fmt_out), buf_len,
 		response_expected ? fmt_name(fmt_in) : "none");
 #endif /* CONFIG_NRF_CLOUD_COAP_LOG_LEVEL_DBG */
 
-	retry = 0;
-	k_sem_reset(&cb_sem);
-	while ((err = coap_client_req(&coap_client, sock, NULL, &request, NULL)) == -EAGAIN) {
-		/* -EAGAIN means the CoAP client is currently waiting for a response
-		 * to a previous request (likely started in a separate thread).
+	err = coap_client_req(&coap_client, sock, NULL, &request, NULL);
+	if (err < 0) {
+		/* -EAGAIN means the CoAP client has no room for another request. */
+		if (err != -EAGAIN) {
+			LOG_ERR("Error sending CoAP request: %d", err);
+		}
+		transfer_free(xfer);
+		return err;
+	}
+
+	if (buf_len) {
+		LOG_HEXDUMP_DBG(buf, MIN(64, buf_len), "Sent");
+	}
+
+	return 0;
+}
+
+int nrf_cloud_coap_async_req(enum coap_method method,
+			     const char *resource, const char *query,
+			     const uint8_t *buf, size_t len,
+			     enum coap_content_format fmt_out,
+			     enum coap_content_format fmt_in,
+			     bool response_expected, bool reliable,
+			     coap_client_response_cb_t cb,
+			     nrf_cloud_coap_done_cb_t done_cb, void *user)
+{
+	return transfer_start(method, resource, query, buf, len, fmt_out, fmt_in,
+			      response_expected, reliable, cb, done_cb, user, K_NO_WAIT);
+}
+
+/* Context of a blocking request. The user's callback is chained through it, since
+ * the user data of the transfer is shared with the completion callback.
+ */
+struct sync_transfer {
+	struct k_sem done;
+	int result;
+	coap_client_response_cb_t cb;
+	void *user_data;
+};
+
+static void sync_transfer_callback(int16_t result_code, size_t offset, const uint8_t *payload,
+				   size_t len, bool last_block, void *user_data)
+{
+	struct sync_transfer *sync = user_data;
+
+	if (sync->cb != NULL) {
+		sync->cb(result_code, offset, payload, len, last_block, sync->user_data);
+	}
+}
+
+static void sync_transfer_done(int result, void *user_data)
+{
+	struct sync_transfer *sync = user_data;
+
+	sync->result = result;
+	k_sem_give(&sync->done);
+}
+
+static int client_transfer(enum coap_method method,
+			   const char *resource, const char *query,
+			   const uint8_t *buf, size_t buf_len,
+			   enum coap_content_format fmt_out,
+			   enum coap_content_format fmt_in,
+			   bool response_expected,
+			   bool reliable,
+			   coap_client_response_cb_t cb, void *user)
+{
+	int err;
+	int retry = 0;
+	struct sync_transfer sync = {
+		.cb = cb,
+		.user_data = user
+	};
+
+	k_sem_init(&sync.done, 0, 1);
+
+	while ((err = transfer_start(method, resource, query, buf, buf_len, fmt_out, fmt_in,
+				     response_expected, reliable, sync_transfer_callback,
+				     sync_transfer_done, &sync, K_FOREVER)) == -EAGAIN) {
+		/* -EAGAIN means the CoAP client is currently waiting for responses
+		 * to other requests (likely started in a separate thread).
 		 */
 		if (retry++ > MAX_RETRIES) {
 			LOG_ERR("Timeout waiting for CoAP client to be available");
@@ -570,24 +709,14 @@ static int client_transfer(enum coap_method method,
 		k_sleep(K_MSEC(500));
 	}
 
-	if (err < 0) {
-		LOG_ERR("Error sending CoAP request: %d", err);
-	} else {
-		if (buf_len) {
-			LOG_HEXDUMP_DBG(buf, MIN(64, buf_len), "Sent");
-		}
-		(void)k_sem_take(&cb_sem, K_FOREVER); /* Wait for coap_client to exhaust retries */
+	if (err) {
+		return err;
 	}
 
-	if (!reliable && !err && (user_cb.result_code >= COAP_RESPONSE_CODE_BAD_REQUEST)) {
-		/* NON transfers usually do not use a callback,
-		 * so make sure a bad result is not ignored.
-		 */
-		err = user_cb.result_code;
-	}
+	/* Wait for coap_client to exhaust retries */
+	(void)k_sem_take(&sync.done, K_FOREVER);
 
-	k_sem_give(&serial_sem);
-	return err;
+	return sync.result;
 }
 
 int nrf_cloud_coap_get(const char *resource, const char *query,
@@ -56,6 +56,15 @@ const struct nrf_cloud_pgps_header *npgps_get_saved_header(void);
 const struct gps_location *npgps_get_saved_location(void);
 int npgps_settings_init(void);
 
+/* prediction catalog functions */
+void npgps_catalog_reset(void);
+void npgps_catalog_set(int pnum, int block, uint32_t crc);
+int npgps_catalog_get(int pnum, uint32_t *crc);
+void npgps_catalog_discard(int num, int count);
+int npgps_catalog_save(const struct nrf_cloud_pgps_header *header);
+int npgps_catalog_invalidate(void);
+bool npgps_catalog_matches(const struct nrf_cloud_pgps_header *header);
+
 /* time functions */
 int64_t npgps_gps_day_time_to_sec(uint16_t gps_day, uint32_t gps_time_of_day);
 void npgps_gps_sec_to_day_time(int64_t gps_sec, uint16_t *gps_day, uint32_t *gps_time_of_day);
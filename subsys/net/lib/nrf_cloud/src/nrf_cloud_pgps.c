@@ -9,6 +9,7 @@
 #include <zephyr/device.h>
 #include <zephyr/storage/stream_flash.h>
 #include <zephyr/storage/flash_map.h>
+#include <zephyr/sys/crc.h>
 
 #include <cJSON.h>
 #include <modem/modem_info.h>
@@ -201,6 +202,11 @@ static struct nrf_cloud_pgps_prediction *get_prediction_slot(int slot, off_t *fl
 	return get_cached_prediction(off);
 }
 
+static uint32_t prediction_crc(const struct nrf_cloud_pgps_prediction *p)
+{
+	return crc32_ieee((const uint8_t *)p, sizeof(*p));
+}
+
 static int determine_prediction_num(struct nrf_cloud_pgps_header *header,
 				    struct nrf_cloud_pgps_prediction *p)
 {
@@ -341,6 +347,9 @@ static int validate_stored_predictions(uint16_t *first_bad_day,
 	}
 
 	npgps_reset_block_pool();
+	if (IS_ENABLED(CONFIG_NRF_CLOUD_PGPS_CATALOG)) {
+		npgps_catalog_reset();
+	}
 
 	/* build catalog of predictions by block */
 	for (i = 0; i < count; i++) {
@@ -396,6 +405,9 @@ static int validate_stored_predictions(uint16_t *first_bad_day,
 		LOG_DBG("Prediction num:%u, loc:%p, blk:%d", pnum, pred, i);
 		__ASSERT(i != NO_BLOCK, "unexpected pointer value %p", pred);
 		npgps_mark_block_used(i, true);
+		if (IS_ENABLED(CONFIG_NRF_CLOUD_PGPS_CATALOG)) {
+			npgps_catalog_set(pnum, i, prediction_crc(pred));
+		}
 	}
 
 	/* find first free block in flash, if any, after chronologicaly
@@ -413,6 +425,14 @@ static int validate_stored_predictions(uint16_t *first_bad_day,
 	}
 
 	npgps_print_blocks();
+
+	/* next time, trust the catalog instead of reading all predictions again */
+	if (IS_ENABLED(CONFIG_NRF_CLOUD_PGPS_CATALOG)) {
+		err = npgps_catalog_save(&index.header);
+		if (err) {
+			LOG_WRN("Error saving prediction catalog:%d", err);
+		}
+	}
 	return pnum;
 }
 
@@ -429,6 +449,74 @@ static void get_prediction_day_time(int pnum, int64_t *gps_sec, uint16_t *gps_da
 	}
 }
 
+/* Same as validate_stored_predictions(), but takes the location of each
+ * prediction from the catalog saved with the current header, instead of
+ * reading and validating all predictions in flash.
+ */
+static int restore_cataloged_predictions(uint16_t *first_bad_day,
+					 uint32_t *first_bad_time)
+{
+	int i = -1;
+	int pnum;
+	int num_valid;
+	int block;
+	uint16_t count = index.header.prediction_count;
+
+	discard_prediction_buffer();
+	for (pnum = 0; pnum < count; pnum++) {
+		index.predictions[pnum] = NULL;
+	}
+
+	npgps_reset_block_pool();
+
+	for (pnum = 0; pnum < count; pnum++) {
+		block = npgps_catalog_get(pnum, NULL);
+		if (block == NO_BLOCK) {
+			LOG_WRN("Prediction num:%u missing", pnum);
+			get_prediction_day_time(pnum, NULL, first_bad_day, first_bad_time);
+			break;
+		}
+
+		index.predictions[pnum] = npgps_block_to_pointer(block);
+		LOG_DBG("Prediction num:%u, blk:%d", pnum, block);
+		npgps_mark_block_used(block, true);
+		i = block;
+	}
+	num_valid = pnum;
+
+	/* blocks of any predictions after the first missing one are free now */
+	for (; pnum < count; pnum++) {
+		npgps_catalog_set(pnum, NO_BLOCK, 0);
+	}
+
+	if (i != -1) {
+		i = npgps_find_first_free(i);
+		LOG_DBG("first free:%d", i);
+	}
+
+	npgps_print_blocks();
+	return num_valid;
+}
+
+/* Check the prediction against the CRC it was cataloged with, if any. */
+static int verify_cataloged_prediction(int pnum, const struct nrf_cloud_pgps_prediction *p)
+{
+	uint32_t crc;
+
+	if (!IS_ENABLED(CONFIG_NRF_CLOUD_PGPS_CATALOG) ||
+	    (npgps_catalog_get(pnum, &crc) != get_prediction_block(pnum))) {
+		return 0;
+	}
+
+	if (prediction_crc(p) != crc) {
+		LOG_ERR("Prediction num:%u does not match catalog", pnum);
+		/* do not trust the catalog on the next init */
+		(void)npgps_catalog_invalidate();
+		return -EINVAL;
+	}
+	return 0;
+}
+
 static void discard_oldest_predictions(int num)
 {
 	int i;
@@ -484,6 +572,11 @@ static void discard_oldest_predictions(int num)
 	LOG_DBG("updated index to gps_sec:%d, day:%u, time:%u",
 		(int32_t)index.start_sec, index.header.gps_day,
 		index.header.gps_time_of_day);
+
+	if (IS_ENABLED(CONFIG_NRF_CLOUD_PGPS_CATALOG)) {
+		npgps_catalog_discard(last, index.header.prediction_count);
+		(void)npgps_catalog_save(&index.header);
+	}
 }
 
 int nrf_cloud_pgps_notify_prediction(void)
@@ -699,6 +792,9 @@ int nrf_cloud_pgps_find_prediction(struct nrf_cloud_pgps_prediction **prediction
 		err = validate_prediction(*prediction,
 					  cur_gps_day, cur_gps_time_of_day,
 					  period_min, false, margin);
+		if (!err) {
+			err = verify_cataloged_prediction(pnum, *prediction);
+		}
 		if (!err) {
 			start_expiration_timer(pnum, cur_gps_sec);
 			return pnum;
@@ -1230,7 +1326,8 @@ static int open_storage(uint32_t offset, bool preserve)
 	return 0;
 }
 
-static int store_prediction(uint8_t *p, size_t len, uint32_t sentinel, bool last)
+static int store_prediction(uint8_t *p, size_t len, uint32_t sentinel, bool last,
+			    uint32_t *crc)
 {
 	static bool first = true;
 	static uint8_t pad[PGPS_PREDICTION_PAD];
@@ -1243,6 +1340,12 @@ static int store_prediction(uint8_t *p, size_t len, uint32_t sentinel, bool last
 		first = false;
 	}
 
+	/* CRC of the prediction as stored in flash */
+	*crc = crc32_ieee_update(0, p, schema_offset);
+	*crc = crc32_ieee_update(*crc, &schema, sizeof(schema));
+	*crc = crc32_ieee_update(*crc, p + schema_offset, len - schema_offset);
+	*crc = crc32_ieee_update(*crc, (uint8_t *)&sentinel, sizeof(sentinel));
+
 	err = stream_flash_buffered_write(&stream, p, schema_offset, false);
 	if (err) {
 		LOG_ERR("Error writing pgps prediction:%d", err);
@@ -1456,6 +1559,7 @@ static int consume_pgps_data(uint8_t pnum, const char *buf, size_t buf_len)
 	size_t parsed_len = 0;
 	int64_t gps_sec;
 	bool finished = false;
+	uint32_t crc;
 	int err = 0;
 
 	gps_sec = 0;
@@ -1514,13 +1618,23 @@ static int consume_pgps_data(uint8_t pnum, const char *buf, size_t buf_len)
 			index.loading_count++;
 			finished = (index.loading_count == index.expected_count);
 			err = store_prediction(prediction_ptr, buf_len, (uint32_t)gps_sec,
-					       finished || (index.storage_extent == 1));
+					       finished || (index.storage_extent == 1), &crc);
 			if (err) {
 				LOG_ERR("Error storing prediction:%d", err);
 				goto fail;
 			}
 			index.predictions[pnum] = npgps_block_to_pointer(index.store_block);
 
+			if (IS_ENABLED(CONFIG_NRF_CLOUD_PGPS_CATALOG)) {
+				npgps_catalog_set(pnum, index.store_block, crc);
+				/* save the catalog once per download, when the last
+				 * prediction has been flushed to flash
+				 */
+				if (finished) {
+					(void)npgps_catalog_save(&index.header);
+				}
+			}
+
 			if (!finished) {
 				if (loading_in_progress && !notified && (index.loading_count > 1)) {
 					notified = true;
@@ -1624,10 +1738,24 @@ int nrf_cloud_pgps_begin_update(void)
 		index.header.prediction_period_min = PREDICTION_PERIOD;
 		index.period_sec = index.header.prediction_period_min * SEC_PER_MIN;
 		memset(index.predictions, 0, sizeof(index.predictions));
+		if (IS_ENABLED(CONFIG_NRF_CLOUD_PGPS_CATALOG)) {
+			/* stored predictions are about to be overwritten */
+			npgps_catalog_reset();
+			(void)npgps_catalog_invalidate();
+		}
 	} else {
 		for (uint8_t pnum = index.pnum_offset;
 		     pnum < index.expected_count + index.pnum_offset; pnum++) {
 			index.predictions[pnum] = NULL;
+			if (IS_ENABLED(CONFIG_NRF_CLOUD_PGPS_CATALOG)) {
+				npgps_catalog_set(pnum, NO_BLOCK, 0);
+			}
+		}
+		if (IS_ENABLED(CONFIG_NRF_CLOUD_PGPS_CATALOG)) {
+			/* the saved catalog is only updated when the download
+			 * completes; until then, the stored predictions are scanned
+			 */
+			(void)npgps_catalog_invalidate();
 		}
 	}
 
@@ -1779,7 +1907,13 @@ int nrf_cloud_pgps_init(struct nrf_cloud_pgps_init_param *param)
 		 */
 		LOG_INF("Checking stored P-GPS data; count:%u, period_min:%u",
 			count, period_min);
-		num_valid = validate_stored_predictions(&gps_day, &gps_time_of_day);
+		if (IS_ENABLED(CONFIG_NRF_CLOUD_PGPS_CATALOG) &&
+		    npgps_catalog_matches(&index.header)) {
+			LOG_INF("Using P-GPS prediction catalog");
+			num_valid = restore_cataloged_predictions(&gps_day, &gps_time_of_day);
+		} else {
+			num_valid = validate_stored_predictions(&gps_day, &gps_time_of_day);
+		}
 	}
 
 	struct nrf_cloud_pgps_prediction *found_prediction = NULL;
@@ -9,6 +9,7 @@
 
 #include <net/nrf_cloud_pgps.h>
 #include <zephyr/settings/settings.h>
+#include <zephyr/sys/crc.h>
 #include <date_time.h>
 
 #include "nrf_cloud_transport.h"
@@ -29,6 +30,9 @@ LOG_MODULE_DECLARE(nrf_cloud_pgps, CONFIG_NRF_CLOUD_GPS_LOG_LEVEL);
 #define SETTINGS_FULL_LOCATION			SETTINGS_NAME "/" SETTINGS_KEY_LOCATION
 #define SETTINGS_KEY_LEAP_SEC			"g2u_leap_sec"
 #define SETTINGS_FULL_LEAP_SEC			SETTINGS_NAME "/" SETTINGS_KEY_LEAP_SEC
+#define SETTINGS_KEY_CATALOG			"catalog"
+#define SETTINGS_FULL_CATALOG			SETTINGS_NAME "/" SETTINGS_KEY_CATALOG
+#define CATALOG_NO_BLOCK			0xFFU
 
 struct block_pool {
 	int first_free;
@@ -45,6 +49,25 @@ static int gps_leap_seconds = GPS_TO_UTC_LEAP_SECONDS;
 static struct gps_location saved_location;
 static struct nrf_cloud_pgps_header saved_header;
 
+#if defined(CONFIG_NRF_CLOUD_PGPS_CATALOG)
+struct catalog_entry {
+	uint8_t block;
+	uint32_t crc;
+} __packed;
+
+/* Flash block and CRC of each stored prediction, by prediction number.
+ * It is only valid for the header it was saved with.
+ */
+struct catalog {
+	uint32_t header_hash;
+	struct catalog_entry entries[NUM_PREDICTIONS];
+	uint32_t crc;
+} __packed;
+
+static struct catalog catalog;
+static bool catalog_loaded;
+#endif
+
 static K_SEM_DEFINE(dl_active, 1, 1);
 
 static struct download_client dlc;
@@ -98,6 +121,17 @@ static int settings_set(const char *key, size_t len_rd,
 			return 0;
 		}
 	}
+#if defined(CONFIG_NRF_CLOUD_PGPS_CATALOG)
+	if (!strncmp(key, SETTINGS_KEY_CATALOG,
+		     strlen(SETTINGS_KEY_CATALOG)) &&
+	    (len_rd == sizeof(catalog))) {
+		if (read_cb(cb_arg, (void *)&catalog, len_rd) == len_rd) {
+			LOG_DBG("Read prediction catalog");
+			catalog_loaded = true;
+			return 0;
+		}
+	}
+#endif
 	return -ENOTSUP;
 }
 
@@ -170,6 +204,10 @@ int npgps_settings_init(void)
 		LOG_ERR("Settings init failed:%d", ret);
 		return ret;
 	}
+#if defined(CONFIG_NRF_CLOUD_PGPS_CATALOG)
+	npgps_catalog_reset();
+	catalog_loaded = false;
+#endif
 	ret = settings_load_subtree(settings_handler_nrf_cloud_pgps.name);
 	if (ret) {
 		LOG_ERR("Cannot load settings:%d", ret);
@@ -177,6 +215,91 @@ int npgps_settings_init(void)
 	return ret;
 }
 
+#if defined(CONFIG_NRF_CLOUD_PGPS_CATALOG)
+static uint32_t catalog_crc(void)
+{
+	return crc32_ieee((const uint8_t *)&catalog, offsetof(struct catalog, crc));
+}
+
+static uint32_t header_hash(const struct nrf_cloud_pgps_header *header)
+{
+	return crc32_ieee((const uint8_t *)header, sizeof(*header));
+}
+
+void npgps_catalog_reset(void)
+{
+	LOG_DBG("resetting catalog");
+	memset(catalog.entries, CATALOG_NO_BLOCK, sizeof(catalog.entries));
+}
+
+void npgps_catalog_set(int pnum, int block, uint32_t crc)
+{
+	__ASSERT((pnum >= 0) && (pnum < NUM_PREDICTIONS), "pnum %d out of range", pnum);
+	catalog.entries[pnum].block = (block == NO_BLOCK) ? CATALOG_NO_BLOCK : block;
+	catalog.entries[pnum].crc = crc;
+}
+
+int npgps_catalog_get(int pnum, uint32_t *crc)
+{
+	if ((pnum < 0) || (pnum >= NUM_PREDICTIONS) ||
+	    (catalog.entries[pnum].block >= num_blocks)) {
+		return NO_BLOCK;
+	}
+	if (crc) {
+		*crc = catalog.entries[pnum].crc;
+	}
+	return catalog.entries[pnum].block;
+}
+
+void npgps_catalog_discard(int num, int count)
+{
+	__ASSERT((num >= 0) && (num <= count) && (count <= NUM_PREDICTIONS),
+		 "cannot discard %d of %d", num, count);
+	memmove(&catalog.entries[0], &catalog.entries[num],
+		(count - num) * sizeof(catalog.entries[0]));
+	memset(&catalog.entries[count - num], CATALOG_NO_BLOCK,
+	       num * sizeof(catalog.entries[0]));
+}
+
+int npgps_catalog_save(const struct nrf_cloud_pgps_header *header)
+{
+	int ret = 0;
+
+	catalog.header_hash = header_hash(header);
+	catalog.crc = catalog_crc();
+
+	LOG_DBG("Saving prediction catalog");
+	ret = settings_save_one(SETTINGS_FULL_CATALOG, &catalog, sizeof(catalog));
+	return ret;
+}
+
+int npgps_catalog_invalidate(void)
+{
+	int ret = 0;
+
+	LOG_DBG("Deleting prediction catalog");
+	ret = settings_delete(SETTINGS_FULL_CATALOG);
+	return ret;
+}
+
+bool npgps_catalog_matches(const struct nrf_cloud_pgps_header *header)
+{
+	if (!catalog_loaded) {
+		LOG_DBG("No prediction catalog");
+		return false;
+	}
+	if (catalog.crc != catalog_crc()) {
+		LOG_WRN("Prediction catalog is corrupted");
+		return false;
+	}
+	if (catalog.header_hash != header_hash(header)) {
+		LOG_DBG("Prediction catalog is for another header");
+		return false;
+	}
+	return true;
+}
+#endif /* CONFIG_NRF_CLOUD_PGPS_CATALOG */
+
 void nrf_cloud_pgps_set_location_normalized(int32_t latitude, int32_t longitude)
 {
 	int64_t sec;
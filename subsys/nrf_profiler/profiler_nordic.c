@@ -8,11 +8,13 @@
 #include <zephyr/kernel_structs.h>
 #include <zephyr/sys/util.h>
 #include <zephyr/sys/byteorder.h>
+#include <zephyr/sys/barrier.h>
 #include <zephyr/kernel.h>
-#include <SEGGER_RTT.h>
 #include <nrf_profiler.h>
 #include <string.h>
-#include <nrfx.h>
+
+#include "profiler_nordic_transport.h"
+#include "profiler_nordic_staging.h"
 
 
 enum state {
@@ -28,6 +30,7 @@ struct nrf_profiler_event_enabled_bm _nrf_profiler_event_enabled_bm;
 static K_SEM_DEFINE(nrf_profiler_sem, 0, 1);
 static atomic_t nrf_profiler_state;
 static uint16_t fatal_error_event_id;
+static uint16_t dropped_events_event_id;
 static struct k_spinlock lock;
 
 enum nordic_command {
@@ -51,10 +54,6 @@ static char *arg_types_encodings[] = {
 
 uint8_t nrf_profiler_num_events;
 
-static uint8_t buffer_data[CONFIG_NRF_PROFILER_NORDIC_DATA_BUFFER_SIZE];
-static uint8_t buffer_info[CONFIG_NRF_PROFILER_NORDIC_INFO_BUFFER_SIZE];
-static uint8_t buffer_commands[CONFIG_NRF_PROFILER_NORDIC_COMMAND_BUFFER_SIZE];
-
 static k_tid_t protocol_thread_id;
 
 static K_THREAD_STACK_DEFINE(nrf_profiler_nordic_stack,
@@ -68,17 +67,13 @@ static int send_info_data(const char *data, size_t data_len)
 
 	size_t num_bytes_send;
 
-	num_bytes_send = SEGGER_RTT_WriteNoLock(
-				  CONFIG_NRF_PROFILER_NORDIC_RTT_CHANNEL_INFO,
-				  data, data_len);
+	num_bytes_send = nrf_profiler_transport_info_send(data, data_len);
 
 	while (num_bytes_send != data_len) {
 		/* Give host time to read the data and free some space
 		 * in the buffer. */
 		k_sleep(K_MSEC(100));
-		num_bytes_send = SEGGER_RTT_WriteNoLock(
-				  CONFIG_NRF_PROFILER_NORDIC_RTT_CHANNEL_INFO,
-				  data, data_len);
+		num_bytes_send = nrf_profiler_transport_info_send(data, data_len);
 
 		/* Avoid being blocked in while loop if host does not read
 		 * the RTT data.
@@ -99,10 +94,11 @@ static void send_system_description(void)
 	 */
 	uint8_t ne = nrf_profiler_num_events;
 
-	__DMB();
+	barrier_dmem_fence_full();
 	char end_line = '\n';
 	int err = 0;
 
+	nrf_profiler_transport_info_begin();
 	for (size_t t = 0; ((t < ne) && !err); t++) {
 		err = send_info_data(descr[t], strlen(descr[t]));
 		if (!err) {
@@ -120,9 +116,7 @@ static void nrf_profiler_nordic_thread_fn(void)
 		uint8_t read_data;
 		enum nordic_command command;
 
-		if (SEGGER_RTT_Read(
-		     CONFIG_NRF_PROFILER_NORDIC_RTT_CHANNEL_COMMANDS,
-		     &read_data, sizeof(read_data))) {
+		if (nrf_profiler_transport_command_get(&read_data)) {
 			command = (enum nordic_command)read_data;
 			switch (command) {
 			case NORDIC_COMMAND_START:
@@ -139,7 +133,17 @@ static void nrf_profiler_nordic_thread_fn(void)
 				break;
 			}
 		}
-		k_sleep(K_MSEC(500));
+
+		if (IS_ENABLED(CONFIG_NRF_PROFILER_NORDIC_STAGING)) {
+			nrf_profiler_staging_drain();
+			k_sleep(K_MSEC(CONFIG_NRF_PROFILER_NORDIC_STAGING_DRAIN_INTERVAL_MS));
+		} else {
+			k_sleep(K_MSEC(500));
+		}
+	}
+
+	if (IS_ENABLED(CONFIG_NRF_PROFILER_NORDIC_STAGING)) {
+		nrf_profiler_staging_drain();
 	}
 	k_sem_give(&nrf_profiler_sem);
 }
@@ -160,36 +164,32 @@ int nrf_profiler_init(void)
 		}
 	}
 
+	int ret = nrf_profiler_transport_init();
+
+	if (ret) {
+		atomic_set(&nrf_profiler_state, STATE_DISABLED);
+		k_sched_unlock();
+		return ret;
+	}
+
+	/* Registering fatal error event */
+	fatal_error_event_id = nrf_profiler_register_event_type("_nrf_profiler_fatal_error_event_",
+							    NULL, NULL, 0);
+
+	if (IS_ENABLED(CONFIG_NRF_PROFILER_NORDIC_STAGING)) {
+		static const char * const dropped_args[] = {"count"};
+		static const enum nrf_profiler_arg dropped_arg_types[] = {NRF_PROFILER_ARG_U32};
+
+		/* Registering event reporting events dropped when staged */
+		dropped_events_event_id = nrf_profiler_register_event_type(
+			"_nrf_profiler_dropped_events_", dropped_args, dropped_arg_types, 1);
+		nrf_profiler_staging_init(dropped_events_event_id);
+	}
+
 	if (IS_ENABLED(CONFIG_NRF_PROFILER_NORDIC_START_LOGGING_ON_SYSTEM_START)) {
 		atomic_cas(&nrf_profiler_state, STATE_INACTIVE, STATE_ACTIVE);
 	}
 
-	int ret;
-
-	ret = SEGGER_RTT_ConfigUpBuffer(
-		CONFIG_NRF_PROFILER_NORDIC_RTT_CHANNEL_DATA,
-		"Nordic nrf_profiler data",
-		buffer_data,
-		CONFIG_NRF_PROFILER_NORDIC_DATA_BUFFER_SIZE,
-		SEGGER_RTT_MODE_NO_BLOCK_SKIP);
-	__ASSERT_NO_MSG(ret >= 0);
-
-	ret = SEGGER_RTT_ConfigUpBuffer(
-		CONFIG_NRF_PROFILER_NORDIC_RTT_CHANNEL_INFO,
-		"Nordic nrf_profiler info",
-		buffer_info,
-		CONFIG_NRF_PROFILER_NORDIC_INFO_BUFFER_SIZE,
-		SEGGER_RTT_MODE_NO_BLOCK_SKIP);
-	__ASSERT_NO_MSG(ret >= 0);
-
-	ret = SEGGER_RTT_ConfigDownBuffer(
-		CONFIG_NRF_PROFILER_NORDIC_RTT_CHANNEL_COMMANDS,
-		"Nordic nrf_profiler command",
-		buffer_commands,
-		CONFIG_NRF_PROFILER_NORDIC_COMMAND_BUFFER_SIZE,
-		SEGGER_RTT_MODE_NO_BLOCK_SKIP);
-	__ASSERT_NO_MSG(ret >= 0);
-
 	protocol_thread_id =  k_thread_create(&nrf_profiler_nordic_thread,
 			nrf_profiler_nordic_stack,
 			K_THREAD_STACK_SIZEOF(nrf_profiler_nordic_stack),
@@ -197,10 +197,6 @@ int nrf_profiler_init(void)
 			NULL, NULL, NULL,
 			CONFIG_NRF_PROFILER_NORDIC_THREAD_PRIORITY, 0, K_NO_WAIT);
 
-	/* Registering fatal error event */
-	fatal_error_event_id = nrf_profiler_register_event_type("_nrf_profiler_fatal_error_event_",
-							    NULL, NULL, 0);
-
 	k_sched_unlock();
 	return 0;
 }
@@ -262,10 +258,16 @@ uint16_t nrf_profiler_register_event_type(const char *name, const char * const *
 	/* Memory barrier to make sure that data is visible
 	 * before being accessed
 	 */
-	__DMB();
+	barrier_dmem_fence_full();
 	nrf_profiler_num_events++;
 	k_sched_unlock();
 
+	if (IS_ENABLED(CONFIG_NRF_PROFILER_NORDIC_TRANSPORT_FILE) &&
+	    (atomic_get(&nrf_profiler_state) != STATE_DISABLED)) {
+		/* No host requests the descriptions, keep them up to date instead. */
+		send_system_description();
+	}
+
 	return ne;
 }
 
@@ -340,14 +342,13 @@ void nrf_profiler_log_add_mem_address(struct log_event_buf *buf,
 	nrf_profiler_log_encode_uint32(buf, (uint32_t)mem_address);
 }
 
-static bool nrf_profiler_RTT_send(struct log_event_buf *buf, uint8_t type_id)
+static bool nrf_profiler_data_send(struct log_event_buf *buf, uint8_t type_id)
 {
 	buf->payload_start[0] = type_id;
 	size_t data_len = buf->payload - buf->payload_start;
 
-	size_t num_bytes_send = SEGGER_RTT_WriteNoLock(
-			CONFIG_NRF_PROFILER_NORDIC_RTT_CHANNEL_DATA,
-			buf->payload_start, data_len);
+	size_t num_bytes_send = nrf_profiler_transport_data_send(buf->payload_start, data_len);
+
 	return (num_bytes_send == data_len);
 }
 
@@ -358,7 +359,7 @@ static void nrf_profiler_fatal_error(void)
 	nrf_profiler_log_start(&buf);
 	while (true) {
 		/* Sending Fatal Error event */
-		if (nrf_profiler_RTT_send(&buf, (uint8_t)fatal_error_event_id)) {
+		if (nrf_profiler_data_send(&buf, (uint8_t)fatal_error_event_id)) {
 			break;
 		}
 	}
@@ -372,11 +373,28 @@ void nrf_profiler_log_send(struct log_event_buf *buf, uint16_t event_type_id)
 	if (atomic_get(&nrf_profiler_state) == STATE_ACTIVE) {
 		uint8_t type_id = event_type_id & UINT8_MAX;
 
+		if (IS_ENABLED(CONFIG_NRF_PROFILER_NORDIC_STAGING)) {
+			buf->payload_start[0] = type_id;
+			(void)nrf_profiler_staging_put(buf->payload_start,
+						       buf->payload - buf->payload_start);
+			return;
+		}
+
 		k_spinlock_key_t key = k_spin_lock(&lock);
 
-		if (!nrf_profiler_RTT_send(buf, type_id)) {
+		if (!nrf_profiler_data_send(buf, type_id)) {
 			nrf_profiler_fatal_error();
 		}
 		k_spin_unlock(&lock, key);
 	}
 }
+
+uint32_t nrf_profiler_dropped_events_count(void)
+{
+	if (IS_ENABLED(CONFIG_NRF_PROFILER_NORDIC_STAGING)) {
+		return nrf_profiler_staging_dropped_count();
+	}
+
+	/* Without staging, a transport overflow is a fatal error. */
+	return 0;
+}
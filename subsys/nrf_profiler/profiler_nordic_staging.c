@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/kernel_structs.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/sys/util.h>
+
+#include "profiler_nordic_staging.h"
+#include "profiler_nordic_transport.h"
+
+#define SLOT_COUNT	CONFIG_NRF_PROFILER_NORDIC_STAGING_SLOTS
+#define SLOT_MASK	(SLOT_COUNT - 1)
+
+BUILD_ASSERT(IS_POWER_OF_TWO(SLOT_COUNT), "Number of staging slots must be a power of two");
+
+/* Event type ID, timestamp and number of dropped events. */
+#define DROPPED_EVENT_LEN	(sizeof(uint8_t) + 2 * sizeof(uint32_t))
+
+struct staging_slot {
+	/* Equal to the position of the event that can be written to the slot,
+	 * and to the position plus one once the event is written.
+	 */
+	atomic_t seq;
+	uint16_t len;
+	uint8_t data[CONFIG_NRF_PROFILER_CUSTOM_EVENT_BUF_LEN];
+};
+
+/* Bounded queue of encoded events. Events are added from any context and
+ * removed by the draining thread, or by a producer dropping the oldest event,
+ * without locks. A slot is claimed by moving the enqueue or dequeue position,
+ * and handed over by updating the sequence number of the slot.
+ */
+struct staging_ring {
+	atomic_t enqueue_pos;
+	atomic_t dequeue_pos;
+	/* Events dropped and not reported yet. */
+	atomic_t dropped;
+	struct staging_slot slots[SLOT_COUNT];
+};
+
+static struct staging_ring rings[CONFIG_MP_MAX_NUM_CPUS];
+static atomic_t dropped_total;
+static uint8_t dropped_id;
+
+/* Event removed from a ring, but not accepted by the transport yet. */
+static uint8_t pending[CONFIG_NRF_PROFILER_CUSTOM_EVENT_BUF_LEN];
+static size_t pending_len;
+
+static bool ring_put(struct staging_ring *ring, const uint8_t *data, size_t len)
+{
+	atomic_val_t pos = atomic_get(&ring->enqueue_pos);
+	struct staging_slot *slot;
+
+	while (true) {
+		slot = &ring->slots[pos & SLOT_MASK];
+
+		atomic_val_t dif = atomic_get(&slot->seq) - pos;
+
+		if (dif == 0) {
+			if (atomic_cas(&ring->enqueue_pos, pos, pos + 1)) {
+				break;
+			}
+		} else if (dif < 0) {
+			/* Full, or the oldest event is still being read. */
+			return false;
+		}
+		pos = atomic_get(&ring->enqueue_pos);
+	}
+
+	memcpy(slot->data, data, len);
+	slot->len = len;
+	atomic_set(&slot->seq, pos + 1);
+
+	return true;
+}
+
+static bool ring_get(struct staging_ring *ring, uint8_t *data, size_t *len)
+{
+	atomic_val_t pos = atomic_get(&ring->dequeue_pos);
+	struct staging_slot *slot;
+
+	while (true) {
+		slot = &ring->slots[pos & SLOT_MASK];
+
+		atomic_val_t dif = atomic_get(&slot->seq) - (pos + 1);
+
+		if (dif == 0) {
+			if (atomic_cas(&ring->dequeue_pos, pos, pos + 1)) {
+				break;
+			}
+		} else if (dif < 0) {
+			/* Empty, or the oldest event is still being written. */
+			return false;
+		}
+		pos = atomic_get(&ring->dequeue_pos);
+	}
+
+	if (data) {
+		*len = slot->len;
+		memcpy(data, slot->data, *len);
+	}
+	atomic_set(&slot->seq, pos + SLOT_COUNT);
+
+	return true;
+}
+
+static void count_dropped(struct staging_ring *ring)
+{
+	atomic_inc(&ring->dropped);
+	atomic_inc(&dropped_total);
+}
+
+void nrf_profiler_staging_init(uint8_t dropped_event_id)
+{
+	dropped_id = dropped_event_id;
+
+	for (size_t i = 0; i < ARRAY_SIZE(rings); i++) {
+		for (size_t j = 0; j < SLOT_COUNT; j++) {
+			atomic_set(&rings[i].slots[j].seq, j);
+		}
+	}
+}
+
+bool nrf_profiler_staging_put(const uint8_t *data, size_t len)
+{
+	struct staging_ring *ring = &rings[arch_curr_cpu()->id];
+
+	__ASSERT_NO_MSG(len <= CONFIG_NRF_PROFILER_CUSTOM_EVENT_BUF_LEN);
+
+	while (!ring_put(ring, data, len)) {
+		if (IS_ENABLED(CONFIG_NRF_PROFILER_NORDIC_STAGING_DROP_OLDEST) &&
+		    ring_get(ring, NULL, NULL)) {
+			count_dropped(ring);
+			continue;
+		}
+
+		if (IS_ENABLED(CONFIG_NRF_PROFILER_NORDIC_STAGING_BLOCK) && k_can_yield()) {
+			k_sleep(K_MSEC(1));
+			continue;
+		}
+
+		count_dropped(ring);
+		return false;
+	}
+
+	return true;
+}
+
+static bool send(const uint8_t *data, size_t len)
+{
+	return nrf_profiler_transport_data_send(data, len) == len;
+}
+
+static bool report_dropped(struct staging_ring *ring)
+{
+	atomic_val_t count = atomic_clear(&ring->dropped);
+	uint8_t event[DROPPED_EVENT_LEN];
+
+	if (!count) {
+		return true;
+	}
+
+	event[0] = dropped_id;
+	sys_put_le32(k_cycle_get_32(), &event[1]);
+	sys_put_le32(count, &event[5]);
+
+	if (!send(event, sizeof(event))) {
+		/* Report it next time. */
+		atomic_add(&ring->dropped, count);
+		return false;
+	}
+
+	return true;
+}
+
+void nrf_profiler_staging_drain(void)
+{
+	if (pending_len) {
+		if (!send(pending, pending_len)) {
+			return;
+		}
+		pending_len = 0;
+	}
+
+	for (size_t i = 0; i < ARRAY_SIZE(rings); i++) {
+		while (ring_get(&rings[i], pending, &pending_len)) {
+			if (!send(pending, pending_len)) {
+				return;
+			}
+			pending_len = 0;
+		}
+
+		/* Drops are reported once the ring is empty, so that the timestamps of
+		 * sent events keep increasing.
+		 */
+		if (!report_dropped(&rings[i])) {
+			return;
+		}
+	}
+}
+
+uint32_t nrf_profiler_staging_dropped_count(void)
+{
+	return (uint32_t)atomic_get(&dropped_total);
+}
@@ -0,0 +1,32 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _PROFILER_NORDIC_STAGING_H_
+#define _PROFILER_NORDIC_STAGING_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/** Initialize the staging ring buffers.
+ *
+ * @param dropped_event_id ID of the event used to report dropped events.
+ */
+void nrf_profiler_staging_init(uint8_t dropped_event_id);
+
+/** Stage an encoded event. Can be called from any context.
+ *
+ * @return True if the event was staged, false if it was dropped.
+ */
+bool nrf_profiler_staging_put(const uint8_t *data, size_t len);
+
+/** Pass the staged events to the transport. Must be called from a single thread. */
+void nrf_profiler_staging_drain(void);
+
+/** Get the total number of dropped events. */
+uint32_t nrf_profiler_staging_dropped_count(void);
+
+#endif /* _PROFILER_NORDIC_STAGING_H_ */
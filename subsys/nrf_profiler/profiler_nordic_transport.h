@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _PROFILER_NORDIC_TRANSPORT_H_
+#define _PROFILER_NORDIC_TRANSPORT_H_
+
+/* Transport of the Nordic nrf_profiler protocol to the host. The transport
+ * is selected with the CONFIG_NRF_PROFILER_NORDIC_TRANSPORT choice.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/** Initialize the transport. */
+int nrf_profiler_transport_init(void);
+
+/** Send profiled data. Data is either sent completely or not at all.
+ *
+ * @return Number of bytes sent.
+ */
+size_t nrf_profiler_transport_data_send(const uint8_t *data, size_t len);
+
+/** Prepare for sending a complete set of event descriptions. */
+void nrf_profiler_transport_info_begin(void);
+
+/** Send a part of event descriptions.
+ *
+ * @return Number of bytes sent.
+ */
+size_t nrf_profiler_transport_info_send(const char *data, size_t len);
+
+/** Get a command from the host, if there is any.
+ *
+ * @return True if a command was received.
+ */
+bool nrf_profiler_transport_command_get(uint8_t *command);
+
+#endif /* _PROFILER_NORDIC_TRANSPORT_H_ */
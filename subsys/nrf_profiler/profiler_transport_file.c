@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+#include "profiler_nordic_transport.h"
+#include "profiler_transport_file_native.h"
+
+LOG_MODULE_REGISTER(nrf_profiler, CONFIG_NRF_PROFILER_LOG_LEVEL);
+
+#define DATA_FILE_NAME CONFIG_NRF_PROFILER_NORDIC_TRANSPORT_FILE_NAME ".data"
+#define INFO_FILE_NAME CONFIG_NRF_PROFILER_NORDIC_TRANSPORT_FILE_NAME ".info"
+
+static int data_fd = -1;
+static int info_fd = -1;
+
+int nrf_profiler_transport_init(void)
+{
+	data_fd = nrf_profiler_file_native_open(DATA_FILE_NAME);
+	if (data_fd < 0) {
+		LOG_ERR("Cannot open %s: %d", DATA_FILE_NAME, data_fd);
+		return data_fd;
+	}
+
+	info_fd = nrf_profiler_file_native_open(INFO_FILE_NAME);
+	if (info_fd < 0) {
+		LOG_ERR("Cannot open %s: %d", INFO_FILE_NAME, info_fd);
+		return info_fd;
+	}
+
+	return 0;
+}
+
+static size_t file_write(int fd, const void *data, size_t len)
+{
+	if ((fd < 0) || (nrf_profiler_file_native_write(fd, data, len) != len)) {
+		return 0;
+	}
+
+	return len;
+}
+
+size_t nrf_profiler_transport_data_send(const uint8_t *data, size_t len)
+{
+	return file_write(data_fd, data, len);
+}
+
+void nrf_profiler_transport_info_begin(void)
+{
+	/* The file holds only the latest set of descriptions. */
+	if (info_fd >= 0) {
+		(void)nrf_profiler_file_native_truncate(info_fd);
+	}
+}
+
+size_t nrf_profiler_transport_info_send(const char *data, size_t len)
+{
+	return file_write(info_fd, data, len);
+}
+
+bool nrf_profiler_transport_command_get(uint8_t *command)
+{
+	/* There is no host to send commands. */
+	return false;
+}
@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "profiler_transport_file_native.h"
+
+int nrf_profiler_file_native_open(const char *name)
+{
+	int fd = open(name, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+	return (fd < 0) ? -errno : fd;
+}
+
+int nrf_profiler_file_native_write(int fd, const void *data, size_t len)
+{
+	const char *pos = data;
+	size_t left = len;
+
+	while (left > 0) {
+		ssize_t written = write(fd, pos, left);
+
+		if (written < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			return -errno;
+		}
+		pos += written;
+		left -= written;
+	}
+
+	return len;
+}
+
+int nrf_profiler_file_native_truncate(int fd)
+{
+	if ((ftruncate(fd, 0) < 0) || (lseek(fd, 0, SEEK_SET) < 0)) {
+		return -errno;
+	}
+
+	return 0;
+}
@@ -0,0 +1,20 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _PROFILER_TRANSPORT_FILE_NATIVE_H_
+#define _PROFILER_TRANSPORT_FILE_NATIVE_H_
+
+/* Host side of the file transport. These functions are built with the host
+ * C library, so that they can access the host file system.
+ */
+
+#include <stddef.h>
+
+int nrf_profiler_file_native_open(const char *name);
+int nrf_profiler_file_native_write(int fd, const void *data, size_t len);
+int nrf_profiler_file_native_truncate(int fd);
+
+#endif /* _PROFILER_TRANSPORT_FILE_NATIVE_H_ */
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2018 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <SEGGER_RTT.h>
+
+#include "profiler_nordic_transport.h"
+
+static uint8_t buffer_data[CONFIG_NRF_PROFILER_NORDIC_DATA_BUFFER_SIZE];
+static uint8_t buffer_info[CONFIG_NRF_PROFILER_NORDIC_INFO_BUFFER_SIZE];
+static uint8_t buffer_commands[CONFIG_NRF_PROFILER_NORDIC_COMMAND_BUFFER_SIZE];
+
+int nrf_profiler_transport_init(void)
+{
+	int ret;
+
+	ret = SEGGER_RTT_ConfigUpBuffer(
+		CONFIG_NRF_PROFILER_NORDIC_RTT_CHANNEL_DATA,
+		"Nordic nrf_profiler data",
+		buffer_data,
+		CONFIG_NRF_PROFILER_NORDIC_DATA_BUFFER_SIZE,
+		SEGGER_RTT_MODE_NO_BLOCK_SKIP);
+	__ASSERT_NO_MSG(ret >= 0);
+
+	ret = SEGGER_RTT_ConfigUpBuffer(
+		CONFIG_NRF_PROFILER_NORDIC_RTT_CHANNEL_INFO,
+		"Nordic nrf_profiler info",
+		buffer_info,
+		CONFIG_NRF_PROFILER_NORDIC_INFO_BUFFER_SIZE,
+		SEGGER_RTT_MODE_NO_BLOCK_SKIP);
+	__ASSERT_NO_MSG(ret >= 0);
+
+	ret = SEGGER_RTT_ConfigDownBuffer(
+		CONFIG_NRF_PROFILER_NORDIC_RTT_CHANNEL_COMMANDS,
+		"Nordic nrf_profiler command",
+		buffer_commands,
+		CONFIG_NRF_PROFILER_NORDIC_COMMAND_BUFFER_SIZE,
+		SEGGER_RTT_MODE_NO_BLOCK_SKIP);
+	__ASSERT_NO_MSG(ret >= 0);
+
+	return 0;
+}
+
+size_t nrf_profiler_transport_data_send(const uint8_t *data, size_t len)
+{
+	return SEGGER_RTT_WriteNoLock(CONFIG_NRF_PROFILER_NORDIC_RTT_CHANNEL_DATA, data, len);
+}
+
+void nrf_profiler_transport_info_begin(void)
+{
+	/* Descriptions are sent on request of the host. */
+}
+
+size_t nrf_profiler_transport_info_send(const char *data, size_t len)
+{
+	return SEGGER_RTT_WriteNoLock(CONFIG_NRF_PROFILER_NORDIC_RTT_CHANNEL_INFO, data, len);
+}
+
+bool nrf_profiler_transport_command_get(uint8_t *command)
+{
+	return SEGGER_RTT_Read(CONFIG_NRF_PROFILER_NORDIC_RTT_CHANNEL_COMMANDS,
+			       command, sizeof(*command)) > 0;
+}
@@ -104,9 +104,17 @@ int pcd_find_fw_version(void)
 #endif
 
 int pcd_fw_copy(const struct device *fdev)
+{
+	return pcd_fw_copy_cb(fdev, NULL);
+}
+
+int pcd_fw_copy_cb(const struct device *fdev, pcd_fw_copy_cb_t cb)
 {
 	struct stream_flash_ctx stream;
 	uint8_t buf[CONFIG_PCD_BUF_SIZE];
+	const uint8_t *data;
+	size_t offset;
+	size_t len;
 	int rc;
 
 	if (cmd->magic != PCD_CMD_MAGIC_COPY) {
@@ -120,11 +128,28 @@ int pcd_fw_copy(const struct device *fdev)
 		return rc;
 	}
 
-	rc = stream_flash_buffered_write(&stream, (uint8_t *)cmd->data,
-					 cmd->len, true);
-	if (rc != 0) {
-		LOG_ERR("stream_flash_buffered_write fail: %d", rc);
-		return rc;
+	data = cmd->data;
+
+	/* The source is passed to the callback in the chunks it is written in,
+	 * so that it is only read once.
+	 */
+	for (offset = 0; offset < cmd->len; offset += len) {
+		len = MIN(sizeof(buf), cmd->len - offset);
+
+		if (cb != NULL) {
+			rc = cb(&data[offset], len, offset);
+			if (rc != 0) {
+				LOG_ERR("Transfer aborted by callback: %d", rc);
+				return rc;
+			}
+		}
+
+		rc = stream_flash_buffered_write(&stream, &data[offset], len,
+						 (offset + len) == cmd->len);
+		if (rc != 0) {
+			LOG_ERR("stream_flash_buffered_write fail: %d", rc);
+			return rc;
+		}
 	}
 
 	LOG_INF("Transfer done");
@@ -59,8 +59,8 @@ struct match_uri_ctx {
  * @brief Foreach callback for matching.
  */
 static bool match_uri(struct dfu_cache_pool *cache_pool, zcbor_state_t *state,
-		      const struct zcbor_string *uri, uintptr_t payload_offset, size_t payload_size,
-		      void *ctx)
+		      const struct zcbor_string *uri, uintptr_t uri_offset, uintptr_t payload_offset,
+		      size_t payload_size, void *ctx)
 {
 	struct match_uri_ctx *cb_ctx = ctx;
 
@@ -112,6 +112,151 @@ static suit_plat_err_t search_cache_pool(struct dfu_cache_pool *cache_pool,
 	return SUIT_PLAT_ERR_INVAL;
 }
 
+#if CONFIG_SUIT_CACHE_INDEX_SIZE > 0
+/* Twice as many buckets as entries keeps the probe sequences short. */
+#define URI_INDEX_BUCKETS (2 * CONFIG_SUIT_CACHE_INDEX_SIZE)
+
+/* URI index entry, describing a single cache slot. */
+struct uri_index_entry {
+	uint32_t uri_hash;
+	size_t uri_len;
+	uintptr_t uri_offset;
+	uintptr_t payload_offset;
+	size_t payload_size;
+};
+
+/* Index of the cache slots of all pools, in the order in which the pools are searched. */
+static struct {
+	struct uri_index_entry entries[CONFIG_SUIT_CACHE_INDEX_SIZE];
+	/* Open addressing hash table. Holds the entry number + 1, or 0 for an empty bucket. */
+	uint16_t buckets[URI_INDEX_BUCKETS];
+	size_t count;
+	/* The index has been built for the current content of the cache. */
+	bool valid;
+	/* All slots fit in the index. */
+	bool complete;
+} uri_index;
+
+BUILD_ASSERT(CONFIG_SUIT_CACHE_INDEX_SIZE < UINT16_MAX, "Index entry numbers must fit in buckets");
+
+/**
+ * @brief Compute the FNV-1a hash of a URI
+ */
+static uint32_t uri_hash(const uint8_t *uri, size_t uri_len)
+{
+	uint32_t hash = 2166136261U;
+
+	for (size_t i = 0; i < uri_len; i++) {
+		hash ^= uri[i];
+		hash *= 16777619U;
+	}
+
+	return hash;
+}
+
+/**
+ * @brief Foreach callback for adding slots to the index.
+ */
+static bool index_add(struct dfu_cache_pool *cache_pool, zcbor_state_t *state,
+		      const struct zcbor_string *uri, uintptr_t uri_offset, uintptr_t payload_offset,
+		      size_t payload_size, void *ctx)
+{
+	struct uri_index_entry *entry;
+	size_t bucket;
+
+	if (uri->len == 0) {
+		/* Padding slot, cannot be searched for. */
+		return true;
+	}
+
+	if (uri_index.count == ARRAY_SIZE(uri_index.entries)) {
+		uri_index.complete = false;
+		return false;
+	}
+
+	entry = &uri_index.entries[uri_index.count];
+	entry->uri_hash = uri_hash(uri->value, uri->len);
+	entry->uri_len = uri->len;
+	entry->uri_offset = uri_offset;
+	entry->payload_offset = payload_offset;
+	entry->payload_size = payload_size;
+
+	/* Slots with the same URI share the probe sequence. A slot added later is found later,
+	 * so the search result is the same as when walking the pools in order.
+	 */
+	bucket = entry->uri_hash % URI_INDEX_BUCKETS;
+	while (uri_index.buckets[bucket] != 0) {
+		bucket = (bucket + 1) % URI_INDEX_BUCKETS;
+	}
+
+	uri_index.buckets[bucket] = ++uri_index.count;
+
+	return true;
+}
+
+/**
+ * @brief Build the index in a single pass over all cache pools
+ */
+static void index_build(void)
+{
+	memset(&uri_index, 0, sizeof(uri_index));
+	uri_index.complete = true;
+
+	for (size_t i = 0; (i < dfu_cache.pools_count) && uri_index.complete; i++) {
+		struct dfu_cache_pool *cache_pool = &dfu_cache.pools[i];
+
+		if (cache_pool->address == NULL) {
+			continue;
+		}
+
+		/* Slots decoded before an error are still searchable, as without the index. */
+		(void)suit_dfu_cache_partition_slot_foreach(cache_pool, index_add, NULL);
+	}
+
+	uri_index.valid = true;
+
+	LOG_DBG("URI index built: %u slots (complete: %d)", uri_index.count, uri_index.complete);
+}
+
+/**
+ * @brief Search the index for a slot with key equal to uri
+ *
+ * @param uri URI without the null terminator
+ * @param payload Output pointer to data in slot
+ * @return suit_plat_err_t SUIT_PLAT_SUCCESS in case of success, otherwise error code
+ */
+static suit_plat_err_t index_search(const struct zcbor_string *uri, struct zcbor_string *payload)
+{
+	uint8_t slot_uri[CONFIG_SUIT_MAX_URI_LENGTH];
+	uint32_t hash = uri_hash(uri->value, uri->len);
+	size_t bucket = hash % URI_INDEX_BUCKETS;
+
+	while (uri_index.buckets[bucket] != 0) {
+		const struct uri_index_entry *entry = &uri_index.entries[uri_index.buckets[bucket] - 1];
+
+		if ((entry->uri_hash == hash) && (entry->uri_len == uri->len) &&
+		    (suit_dfu_cache_memcpy(slot_uri, entry->uri_offset, entry->uri_len) ==
+		     SUIT_PLAT_SUCCESS) &&
+		    (memcmp(slot_uri, uri->value, uri->len) == 0)) {
+			payload->value = (uint8_t *)entry->payload_offset;
+			payload->len = entry->payload_size;
+			return SUIT_PLAT_SUCCESS;
+		}
+
+		bucket = (bucket + 1) % URI_INDEX_BUCKETS;
+	}
+
+	return SUIT_PLAT_ERR_NOT_FOUND;
+}
+#endif /* CONFIG_SUIT_CACHE_INDEX_SIZE > 0 */
+
+void suit_dfu_cache_index_invalidate(void)
+{
+#if CONFIG_SUIT_CACHE_INDEX_SIZE > 0
+	uri_index.valid = false;
+#endif /* CONFIG_SUIT_CACHE_INDEX_SIZE > 0 */
+}
+
 suit_plat_err_t suit_dfu_cache_search(const uint8_t *uri, size_t uri_size, const uint8_t **payload,
 				      size_t *payload_size)
 {
@@ -119,6 +264,33 @@ suit_plat_err_t suit_dfu_cache_search(const uint8_t *uri, size_t uri_size, const
 		struct zcbor_string tmp_payload = {.len = 0, .value = NULL};
 		struct zcbor_string tmp_uri = {.len = uri_size, .value = uri};
 
+#if CONFIG_SUIT_CACHE_INDEX_SIZE > 0
+		struct zcbor_string key = tmp_uri;
+
+		if (uri[uri_size - 1] == '\0') {
+			key.len--;
+		}
+
+		if (!uri_index.valid) {
+			index_build();
+		}
+
+		if (key.len <= CONFIG_SUIT_MAX_URI_LENGTH) {
+			suit_plat_err_t ret = index_search(&key, &tmp_payload);
+
+			if ((ret == SUIT_PLAT_SUCCESS) || uri_index.complete) {
+				if (ret == SUIT_PLAT_SUCCESS) {
+					*payload = tmp_payload.value;
+					*payload_size = tmp_payload.len;
+				}
+
+				return ret;
+			}
+		}
+
+		/* Slots that did not fit in the index are found by walking the pools. */
+#endif /* CONFIG_SUIT_CACHE_INDEX_SIZE > 0 */
+
 		for (size_t i = 0; i < dfu_cache.pools_count; i++) {
 			suit_plat_err_t ret =
 				search_cache_pool(&dfu_cache.pools[i], &tmp_uri, &tmp_payload);
@@ -189,6 +361,7 @@ suit_plat_err_t suit_dfu_cache_initialize(struct dfu_cache *cache)
 	}
 
 	init_done = true;
+	suit_dfu_cache_index_invalidate();
 
 	return SUIT_PLAT_SUCCESS;
 }
@@ -196,5 +369,6 @@ suit_plat_err_t suit_dfu_cache_initialize(struct dfu_cache *cache)
 void suit_dfu_cache_deinitialize(void)
 {
 	suit_dfu_cache_clear(&dfu_cache);
+	suit_dfu_cache_index_invalidate();
 	init_done = false;
 }
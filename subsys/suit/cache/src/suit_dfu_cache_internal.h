@@ -29,6 +29,7 @@ extern "C" {
  * @param cache_pool  Pointer to the SUIT cache pool structure.
  * @param state  zcbor state of the current slot.
  * @param uri  URI of the current slot
+ * @param uri_offset  Offset of the URI characters. May be located in external storage area.
  * @param payload_offset  Offset of the payload. May be located in external storage area.
  * @param payload_size  Size of the payload.
  * @param ctx  Additional callback context.
@@ -36,8 +37,8 @@ extern "C" {
  * @return True continues iteration, false causes the caller to stop subsequent iterations.
  */
 typedef bool (*partition_slot_foreach_cb)(struct dfu_cache_pool *cache_pool, zcbor_state_t *state,
-					  const struct zcbor_string *uri, uintptr_t payload_offset,
-					  size_t payload_size, void *ctx);
+					  const struct zcbor_string *uri, uintptr_t uri_offset,
+					  uintptr_t payload_offset, size_t payload_size, void *ctx);
 
 /**
  * @brief Iterates over cache slots and executes a provided callback.
@@ -89,6 +90,14 @@ suit_plat_err_t suit_dfu_cache_partition_find_free_space(struct dfu_cache_pool *
 							 uintptr_t *address,
 							 bool *needs_erase);
 
+/**
+ * @brief Invalidate the URI index of the SUIT cache.
+ *
+ * Must be called whenever the content of a cache partition changes. The index is rebuilt on the
+ * next call to @ref suit_dfu_cache_search.
+ */
+void suit_dfu_cache_index_invalidate(void);
+
 /**
  * @brief Memcpy-like helper for writing streamable data into a memory buffer.
  *
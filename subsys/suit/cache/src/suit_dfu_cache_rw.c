@@ -270,6 +270,9 @@ static suit_plat_err_t write_to_sink(uint8_t *address, uint8_t *data, size_t siz
 {
 	struct stream_sink sink;
 
+	/* Any change of the cache content makes the URI index stale. */
+	suit_dfu_cache_index_invalidate();
+
 	suit_plat_err_t ret = suit_flash_sink_get(&sink, address, size);
 
 	if (ret != SUIT_PLAT_SUCCESS) {
@@ -310,6 +313,8 @@ static suit_plat_err_t erase_on_sink(uint8_t *address, size_t size)
 
 	LOG_DBG("Erasing memory: %p(size:%u)", (void *)address, size);
 
+	suit_dfu_cache_index_invalidate();
+
 	suit_plat_err_t ret = suit_flash_sink_get(&sink, address, size);
 
 	if (ret != SUIT_PLAT_SUCCESS) {
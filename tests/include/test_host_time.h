@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef TEST_HOST_TIME_H_
+#define TEST_HOST_TIME_H_
+
+#include <stdint.h>
+#include <zephyr/kernel.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file test_host_time.h
+ * @brief Execution time measurements in tests, enabled with CONFIG_TEST_HOST_TIME.
+ *
+ * The simulated time of native targets does not advance while the code is executed,
+ * so the host monotonic clock is used on them. Other targets use the cycle counter.
+ */
+
+#if defined(CONFIG_ARCH_POSIX)
+/** @brief Get the host monotonic clock in nanoseconds. */
+uint64_t test_host_time_ns(void);
+#endif
+
+/** @brief Get a timestamp to measure the execution time from. */
+static inline uint64_t test_timestamp_get(void)
+{
+#if defined(CONFIG_ARCH_POSIX)
+	return test_host_time_ns();
+#else
+	return k_cycle_get_32();
+#endif
+}
+
+/** @brief Get the time in nanoseconds elapsed since @p start. */
+static inline uint64_t test_elapsed_ns_get(uint64_t start)
+{
+#if defined(CONFIG_ARCH_POSIX)
+	return test_host_time_ns() - start;
+#else
+	return k_cyc_to_ns_floor64((uint32_t)k_cycle_get_32() - (uint32_t)start);
+#endif
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TEST_HOST_TIME_H_ */
@@ -0,0 +1,422 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/ztest.h>
+#include <stdio.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/sys_heap.h>
+
+#include <modem/at_cmd_parser.h>
+#include <modem/at_params.h>
+#include <modem/at_token.h>
+
+#define TEST_TOKENS 16
+
+/* Number of times each response is parsed in the benchmark. */
+#define BENCHMARK_ROUNDS 100
+/* Worst case number of %NCELLMEAS parameters. */
+#define BENCHMARK_PARAMS 97
+
+extern struct sys_heap _system_heap;
+
+static struct at_token tokens[TEST_TOKENS];
+
+/* Responses recorded from an nRF9160 modem. */
+static const char cereg_notif[] =
+	"+CEREG: 5,\"0A0B\",\"01020304\",7,,,\"11100000\",\"00011111\"\r\n";
+static const char cereg_read[] =
+	"+CEREG: 5,1,\"0A0B\",\"01020304\",9,0,0,\"00100110\",\"01011111\"\r\nOK\r\n";
+static const char ncellmeas[] =
+	"%NCELLMEAS: 0,\"021D140C\",\"24201\",\"0821\",65535,5300,449,50,15,10891,"
+	"5300,194,46,8,0,1650,292,60,27,24,6400,103,36,11,-12,6400,250,31,6,105,"
+	"1650,17,28,5,322,5300,331,22,3,-40,8061152878017748\r\n";
+
+static void assert_token(const struct at_token *token, enum at_token_type type,
+			 const char *str)
+{
+	zassert_equal(type, token->type, "Wrong token type");
+	zassert_equal(strlen(str), token->len, "Wrong token length");
+	zassert_mem_equal(str, token->start, token->len, "Wrong token");
+}
+
+static void token_init(struct at_token *token, enum at_token_type type, const char *str)
+{
+	token->start = str;
+	token->len = strlen(str);
+	token->type = type;
+}
+
+ZTEST(at_token, test_line_parse_fail_on_invalid_input)
+{
+	size_t count;
+
+	zassert_equal(-EINVAL, at_token_line_parse(NULL, tokens, TEST_TOKENS, &count, NULL));
+	zassert_equal(-EINVAL, at_token_line_parse(cereg_read, NULL, TEST_TOKENS, &count, NULL));
+	zassert_equal(-EINVAL, at_token_line_parse(cereg_read, tokens, 0, &count, NULL));
+	zassert_equal(-EINVAL, at_token_line_parse(cereg_read, tokens, TEST_TOKENS, NULL, NULL));
+	zassert_equal(-EINVAL, at_token_params_parse(NULL, tokens, TEST_TOKENS, &count, NULL));
+}
+
+ZTEST(at_token, test_line_parse)
+{
+	int err;
+	size_t count;
+	const char *remainder;
+
+	err = at_token_line_parse(cereg_read, tokens, TEST_TOKENS, &count, &remainder);
+	zassert_equal(0, err);
+	zassert_equal(10, count);
+
+	assert_token(&tokens[0], AT_TOKEN_TYPE_PREFIX, "+CEREG");
+	assert_token(&tokens[1], AT_TOKEN_TYPE_INT, "5");
+	assert_token(&tokens[2], AT_TOKEN_TYPE_INT, "1");
+	assert_token(&tokens[3], AT_TOKEN_TYPE_QUOTED_STRING, "0A0B");
+	assert_token(&tokens[4], AT_TOKEN_TYPE_QUOTED_STRING, "01020304");
+	assert_token(&tokens[5], AT_TOKEN_TYPE_INT, "9");
+	assert_token(&tokens[8], AT_TOKEN_TYPE_QUOTED_STRING, "00100110");
+	assert_token(&tokens[9], AT_TOKEN_TYPE_QUOTED_STRING, "01011111");
+
+	/* Tokens are views into the string. */
+	zassert_equal_ptr(cereg_read, tokens[0].start);
+
+	/* Tokenizing stops at the end of the line. */
+	zassert_equal(0, strcmp(remainder, "OK\r\n"));
+}
+
+ZTEST(at_token, test_line_parse_empty_params)
+{
+	int err;
+	size_t count;
+
+	err = at_token_line_parse("+CEREG: 5,0,,,9,0,0,,", tokens, TEST_TOKENS, &count, NULL);
+	zassert_equal(0, err);
+	zassert_equal(10, count);
+
+	assert_token(&tokens[2], AT_TOKEN_TYPE_INT, "0");
+	assert_token(&tokens[3], AT_TOKEN_TYPE_EMPTY, "");
+	assert_token(&tokens[4], AT_TOKEN_TYPE_EMPTY, "");
+	assert_token(&tokens[5], AT_TOKEN_TYPE_INT, "9");
+	assert_token(&tokens[8], AT_TOKEN_TYPE_EMPTY, "");
+	assert_token(&tokens[9], AT_TOKEN_TYPE_EMPTY, "");
+
+	err = at_token_line_parse("+CEDRXRDP: 5,\"1000\",\"\",\"\"", tokens, TEST_TOKENS, &count,
+				  NULL);
+	zassert_equal(0, err);
+	zassert_equal(5, count);
+	assert_token(&tokens[3], AT_TOKEN_TYPE_QUOTED_STRING, "");
+}
+
+ZTEST(at_token, test_line_parse_prefix)
+{
+	int err;
+	size_t count;
+	const char *remainder;
+
+	/* The prefix can contain digits. */
+	err = at_token_line_parse("%XT3412: 360", tokens, TEST_TOKENS, &count, NULL);
+	zassert_equal(0, err);
+	zassert_equal(2, count);
+	assert_token(&tokens[0], AT_TOKEN_TYPE_PREFIX, "%XT3412");
+	assert_token(&tokens[1], AT_TOKEN_TYPE_INT, "360");
+
+	/* Prefix without parameters, leading CRLF is skipped. */
+	err = at_token_line_parse("\r\n%XMODEMSLEEP\r\n", tokens, TEST_TOKENS, &count, NULL);
+	zassert_equal(0, err);
+	zassert_equal(1, count);
+	assert_token(&tokens[0], AT_TOKEN_TYPE_PREFIX, "%XMODEMSLEEP");
+
+	/* A line without a prefix is a single string. */
+	err = at_token_line_parse("OK\r\n", tokens, TEST_TOKENS, &count, &remainder);
+	zassert_equal(0, err);
+	zassert_equal(1, count);
+	assert_token(&tokens[0], AT_TOKEN_TYPE_STRING, "OK");
+	zassert_equal(0, strlen(remainder));
+
+	/* Notifications are tokenized one line at a time. */
+	err = at_token_line_parse("+CSCON: 1\r\n+CEREG: 1\r\n", tokens, TEST_TOKENS, &count,
+				  &remainder);
+	zassert_equal(0, err);
+	zassert_equal(2, count);
+	assert_token(&tokens[0], AT_TOKEN_TYPE_PREFIX, "+CSCON");
+	zassert_equal(0, strcmp(remainder, "+CEREG: 1\r\n"));
+}
+
+ZTEST(at_token, test_line_parse_types)
+{
+	int err;
+	size_t count;
+
+	err = at_token_line_parse("+CIND: (0,1), -12 ,+3,abc,\"a,b\",1A", tokens, TEST_TOKENS,
+				  &count, NULL);
+	zassert_equal(0, err);
+	zassert_equal(7, count);
+
+	assert_token(&tokens[1], AT_TOKEN_TYPE_ARRAY, "0,1");
+	assert_token(&tokens[2], AT_TOKEN_TYPE_INT, "-12");
+	assert_token(&tokens[3], AT_TOKEN_TYPE_INT, "+3");
+	assert_token(&tokens[4], AT_TOKEN_TYPE_STRING, "abc");
+	assert_token(&tokens[5], AT_TOKEN_TYPE_QUOTED_STRING, "a,b");
+	assert_token(&tokens[6], AT_TOKEN_TYPE_STRING, "1A");
+}
+
+ZTEST(at_token, test_line_parse_malformed)
+{
+	int err;
+	size_t count;
+
+	/* Unterminated quoted string. */
+	err = at_token_line_parse("+CEREG: 1,\"0A0B", tokens, TEST_TOKENS, &count, NULL);
+	zassert_equal(-EBADMSG, err);
+	zassert_equal(2, count);
+
+	/* Unterminated array. */
+	err = at_token_line_parse("+CIND: (0,1", tokens, TEST_TOKENS, &count, NULL);
+	zassert_equal(-EBADMSG, err);
+	zassert_equal(1, count);
+
+	/* Garbage after a quoted string. */
+	err = at_token_line_parse("+CEREG: \"0A0B\"x,1", tokens, TEST_TOKENS, &count, NULL);
+	zassert_equal(-EBADMSG, err);
+	zassert_equal(1, count);
+}
+
+ZTEST(at_token, test_line_parse_windows)
+{
+	int err;
+	size_t count;
+	size_t total;
+	const char *remainder;
+	int32_t value;
+	struct at_token window[4];
+
+	err = at_token_line_parse(ncellmeas, window, ARRAY_SIZE(window), &count, &remainder);
+	zassert_equal(-E2BIG, err);
+	zassert_equal(ARRAY_SIZE(window), count);
+	assert_token(&window[0], AT_TOKEN_TYPE_PREFIX, "%NCELLMEAS");
+	assert_token(&window[3], AT_TOKEN_TYPE_QUOTED_STRING, "24201");
+
+	total = count;
+
+	/* Continue in windows until the end of the line. */
+	do {
+		err = at_token_params_parse(remainder, window, ARRAY_SIZE(window), &count,
+					    &remainder);
+		zassert_true(err == 0 || err == -E2BIG);
+
+		if (total <= 10 && total + count > 10) {
+			/* Parameter 10 is the measurement time. */
+			zassert_equal(0, at_token_int_get(&window[10 - total], &value));
+			zassert_equal(10891, value);
+		}
+
+		total += count;
+	} while (err == -E2BIG);
+
+	zassert_equal(42, total);
+	assert_token(&window[count - 1], AT_TOKEN_TYPE_INT, "8061152878017748");
+	zassert_equal(0, strlen(remainder));
+
+	/* A line that fills the array exactly is not too big. */
+	err = at_token_line_parse("+CSCON: 1,2,3", window, ARRAY_SIZE(window), &count, NULL);
+	zassert_equal(0, err);
+	zassert_equal(4, count);
+}
+
+ZTEST(at_token, test_int_get)
+{
+	struct at_token token;
+	int16_t short_value;
+	uint16_t ushort_value;
+	int32_t int_value;
+	int64_t int64_value;
+
+	token_init(&token, AT_TOKEN_TYPE_INT, "-32768");
+	zassert_equal(0, at_token_short_get(&token, &short_value));
+	zassert_equal(INT16_MIN, short_value);
+	zassert_equal(-EINVAL, at_token_ushort_get(&token, &ushort_value));
+
+	token_init(&token, AT_TOKEN_TYPE_INT, "65535");
+	zassert_equal(-EINVAL, at_token_short_get(&token, &short_value));
+	zassert_equal(0, at_token_ushort_get(&token, &ushort_value));
+	zassert_equal(UINT16_MAX, ushort_value);
+
+	token_init(&token, AT_TOKEN_TYPE_INT, "2147483647");
+	zassert_equal(0, at_token_int_get(&token, &int_value));
+	zassert_equal(INT32_MAX, int_value);
+
+	token_init(&token, AT_TOKEN_TYPE_INT, "2147483648");
+	zassert_equal(-EINVAL, at_token_int_get(&token, &int_value));
+	zassert_equal(0, at_token_int64_get(&token, &int64_value));
+	zassert_equal(2147483648LL, int64_value);
+
+	token_init(&token, AT_TOKEN_TYPE_INT, "-9223372036854775808");
+	zassert_equal(0, at_token_int64_get(&token, &int64_value));
+	zassert_equal(INT64_MIN, int64_value);
+
+	token_init(&token, AT_TOKEN_TYPE_INT, "9223372036854775808");
+	zassert_equal(-EINVAL, at_token_int64_get(&token, &int64_value));
+
+	token_init(&token, AT_TOKEN_TYPE_INT, "99999999999999999999");
+	zassert_equal(-EINVAL, at_token_int64_get(&token, &int64_value));
+
+	/* Only integer tokens have integer values. */
+	token_init(&token, AT_TOKEN_TYPE_QUOTED_STRING, "1");
+	zassert_equal(-EINVAL, at_token_int_get(&token, &int_value));
+
+	zassert_equal(-EINVAL, at_token_int_get(NULL, &int_value));
+	zassert_equal(-EINVAL, at_token_int_get(&token, NULL));
+}
+
+ZTEST(at_token, test_string_uint_get)
+{
+	struct at_token token;
+	uint32_t value;
+
+	token_init(&token, AT_TOKEN_TYPE_QUOTED_STRING, "FFFFFFFF");
+	zassert_equal(0, at_token_string_uint_get(&token, 16, &value));
+	zassert_equal(UINT32_MAX, value);
+
+	token_init(&token, AT_TOKEN_TYPE_QUOTED_STRING, "021d140c");
+	zassert_equal(0, at_token_string_uint_get(&token, 16, &value));
+	zassert_equal(0x021D140C, value);
+
+	token_init(&token, AT_TOKEN_TYPE_QUOTED_STRING, "100000000");
+	zassert_equal(-EINVAL, at_token_string_uint_get(&token, 16, &value));
+
+	token_init(&token, AT_TOKEN_TYPE_QUOTED_STRING, "1011");
+	zassert_equal(0, at_token_string_uint_get(&token, 2, &value));
+	zassert_equal(11, value);
+
+	token_init(&token, AT_TOKEN_TYPE_QUOTED_STRING, "1021");
+	zassert_equal(-EINVAL, at_token_string_uint_get(&token, 2, &value));
+
+	token_init(&token, AT_TOKEN_TYPE_INT, "0821");
+	zassert_equal(0, at_token_string_uint_get(&token, 16, &value));
+	zassert_equal(0x0821, value);
+
+	token_init(&token, AT_TOKEN_TYPE_QUOTED_STRING, "");
+	zassert_equal(-EINVAL, at_token_string_uint_get(&token, 16, &value));
+
+	token_init(&token, AT_TOKEN_TYPE_EMPTY, "");
+	zassert_equal(-EINVAL, at_token_string_uint_get(&token, 16, &value));
+
+	token_init(&token, AT_TOKEN_TYPE_QUOTED_STRING, "1");
+	zassert_equal(-EINVAL, at_token_string_uint_get(&token, 1, &value));
+	zassert_equal(-EINVAL, at_token_string_uint_get(&token, 17, &value));
+}
+
+ZTEST(at_token, test_string_get)
+{
+	struct at_token token;
+	char buf[8];
+	size_t len;
+
+	token_init(&token, AT_TOKEN_TYPE_QUOTED_STRING, "24201");
+	len = sizeof(buf);
+	zassert_equal(0, at_token_string_get(&token, buf, &len));
+	zassert_equal(5, len);
+	zassert_mem_equal("24201", buf, len);
+
+	len = 4;
+	zassert_equal(-ENOMEM, at_token_string_get(&token, buf, &len));
+
+	token_init(&token, AT_TOKEN_TYPE_PREFIX, "+CEREG");
+	len = sizeof(buf);
+	zassert_equal(0, at_token_string_get(&token, buf, &len));
+	zassert_true(at_token_equals(&token, "+CEREG"));
+	zassert_false(at_token_equals(&token, "+CERE"));
+	zassert_false(at_token_equals(&token, "+CEREGX"));
+
+	token_init(&token, AT_TOKEN_TYPE_INT, "1");
+	len = sizeof(buf);
+	zassert_equal(-EINVAL, at_token_string_get(&token, buf, &len));
+	zassert_false(at_token_equals(&token, "1"));
+
+	token_init(&token, AT_TOKEN_TYPE_EMPTY, "");
+	zassert_equal(-EINVAL, at_token_string_get(&token, buf, &len));
+}
+
+static void heap_peak_reset(void)
+{
+	sys_heap_runtime_stats_reset_max(&_system_heap);
+}
+
+static size_t heap_peak_get(void)
+{
+	struct sys_memory_stats stats;
+
+	sys_heap_runtime_stats_get(&_system_heap, &stats);
+
+	return stats.max_allocated_bytes;
+}
+
+/* Parses a response the way the LTE link control parsers did with the AT command parser. */
+static uint32_t at_params_parse(const char *response, size_t *count)
+{
+	struct at_param_list list;
+	uint32_t start = k_cycle_get_32();
+
+	zassert_equal(0, at_params_list_init(&list, BENCHMARK_PARAMS));
+	zassert_equal(0, at_parser_params_from_str(response, NULL, &list));
+	*count = at_params_valid_count_get(&list);
+	at_params_list_free(&list);
+
+	return k_cycle_get_32() - start;
+}
+
+static uint32_t at_token_parse(const char *response, size_t *count)
+{
+	struct at_token line[BENCHMARK_PARAMS];
+	uint32_t start = k_cycle_get_32();
+
+	zassert_equal(0, at_token_line_parse(response, line, ARRAY_SIZE(line), count, NULL));
+
+	return k_cycle_get_32() - start;
+}
+
+static void benchmark(const char *name, const char *response)
+{
+	uint32_t params_cycles = 0;
+	uint32_t token_cycles = 0;
+	size_t params_heap;
+	size_t token_heap;
+	size_t params_count;
+	size_t token_count;
+
+	heap_peak_reset();
+
+	for (int i = 0; i < BENCHMARK_ROUNDS; i++) {
+		params_cycles += at_params_parse(response, &params_count);
+	}
+
+	params_heap = heap_peak_get();
+
+	heap_peak_reset();
+
+	for (int i = 0; i < BENCHMARK_ROUNDS; i++) {
+		token_cycles += at_token_parse(response, &token_count);
+	}
+
+	token_heap = heap_peak_get();
+
+	TC_PRINT("%s: at_params %u cycles, %zu bytes of heap; at_token %u cycles, %zu bytes of heap\n",
+		 name, params_cycles / BENCHMARK_ROUNDS, params_heap,
+		 token_cycles / BENCHMARK_ROUNDS, token_heap);
+
+	zassert_equal(params_count, token_count, "Parsers disagree");
+	zassert_true(params_heap > 0);
+	zassert_equal(0, token_heap, "Tokenizer must not allocate");
+}
+
+ZTEST(at_token, test_benchmark)
+{
+	benchmark("+CEREG notification", cereg_notif);
+	benchmark("+CEREG read", cereg_read);
+	benchmark("%NCELLMEAS", ncellmeas);
+}
+
+ZTEST_SUITE(at_token, NULL, NULL, NULL, NULL, NULL);
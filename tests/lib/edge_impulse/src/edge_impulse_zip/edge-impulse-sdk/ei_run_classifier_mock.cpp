@@ -8,17 +8,24 @@
 #include <ei_run_classifier.h>
 
 static size_t prediction_idx;
+static size_t reset_cnt;
 
 void ei_run_classifier_mock_init(void)
 {
 	prediction_idx = 0;
+	reset_cnt = 0;
+}
+
+size_t ei_run_classifier_mock_reset_cnt(void)
+{
+	return reset_cnt;
 }
 
 /* Input data must be ascending sequence of floats. Difference between
  * subsequent elements of input sequence equals 1. The first element
  * has value defined by ei_test_params.h (depends on current prediction idx).
  */
-static void verify_data_read(signal_t *signal, const size_t prediction_idx,
+static void verify_data_read(signal_t *signal, const float first_value,
 			     const size_t chunk_size)
 {
 	size_t data_size = signal->total_length;
@@ -37,7 +44,7 @@ static void verify_data_read(signal_t *signal, const size_t prediction_idx,
 		zassert_ok(err, "get_data returned an error");
 	}
 
-	float value = EI_MOCK_GEN_FIRST_INPUT(prediction_idx);;
+	float value = first_value;
 
 	for (size_t off = 0; off < data_size; off++) {
 		zassert_within(data_buf[off], value, FLOAT_CMP_EPSILON,
@@ -46,19 +53,8 @@ static void verify_data_read(signal_t *signal, const size_t prediction_idx,
 	}
 }
 
-EI_IMPULSE_ERROR run_classifier(signal_t *signal,
-				ei_impulse_result_t *result,
-				bool debug)
+static void fill_result(ei_impulse_result_t *result)
 {
-	ARG_UNUSED(debug);
-
-	/* Test getting data. */
-	verify_data_read(signal, prediction_idx, 1);
-	verify_data_read(signal, prediction_idx,
-			 EI_CLASSIFIER_RAW_SAMPLES_PER_FRAME);
-	verify_data_read(signal, prediction_idx,
-			 EI_CLASSIFIER_DSP_INPUT_FRAME_SIZE);
-
 	/* Busy wait for predefined amount of time to simulate calculations. */
 	k_busy_wait(EI_MOCK_BUSY_WAIT_TIME);
 
@@ -88,6 +84,53 @@ EI_IMPULSE_ERROR run_classifier(signal_t *signal,
 		      "Wrong label");
 
 	prediction_idx++;
+}
+
+EI_IMPULSE_ERROR run_classifier(signal_t *signal,
+				ei_impulse_result_t *result,
+				bool debug)
+{
+	ARG_UNUSED(debug);
+
+	zassert_equal(signal->total_length, EI_CLASSIFIER_DSP_INPUT_FRAME_SIZE,
+		      "Classifier expects a full window");
+
+	/* Test getting data. */
+	const float first_value = EI_MOCK_GEN_FIRST_INPUT(prediction_idx);
+
+	verify_data_read(signal, first_value, 1);
+	verify_data_read(signal, first_value, EI_CLASSIFIER_RAW_SAMPLES_PER_FRAME);
+	verify_data_read(signal, first_value, EI_CLASSIFIER_DSP_INPUT_FRAME_SIZE);
+
+	fill_result(result);
+
+	return EI_IMPULSE_OK;
+}
+
+void run_classifier_init(void)
+{
+	reset_cnt++;
+}
+
+EI_IMPULSE_ERROR run_classifier_continuous(signal_t *signal,
+					   ei_impulse_result_t *result,
+					   bool debug,
+					   bool enable_maf)
+{
+	ARG_UNUSED(debug);
+	ARG_UNUSED(enable_maf);
+
+	zassert_equal(signal->total_length, EI_MOCK_SLICE_SIZE,
+		      "Continuous classifier expects a single slice");
+
+	/* Test getting data. */
+	const float first_value = EI_MOCK_GEN_FIRST_SLICE_INPUT(prediction_idx);
+
+	verify_data_read(signal, first_value, 1);
+	verify_data_read(signal, first_value, EI_CLASSIFIER_RAW_SAMPLES_PER_FRAME);
+	verify_data_read(signal, first_value, EI_MOCK_SLICE_SIZE);
+
+	fill_result(result);
 
 	return EI_IMPULSE_OK;
 }
@@ -9,4 +9,7 @@
 
 void ei_run_classifier_mock_init(void);
 
+/* Number of times the continuous classifier state was reset by the wrapper. */
+size_t ei_run_classifier_mock_reset_cnt(void);
+
 #endif /* _EI_RUN_CLASSIFIER_MOCK_H_ */
@@ -18,6 +18,7 @@
 #define EI_CLASSIFIER_DSP_INPUT_FRAME_SIZE	300
 #define EI_CLASSIFIER_HAS_ANOMALY		1
 #define EI_CLASSIFIER_FREQUENCY			60
+#define EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW	4
 
 /* Mocked results. */
 static const char * const ei_classifier_inferencing_categories[] = {
@@ -29,6 +30,13 @@ static const char * const ei_classifier_inferencing_categories[] = {
 #define EI_MOCK_GEN_FIRST_INPUT(PRED_IDX) \
 	((float)((PRED_IDX) * EI_CLASSIFIER_RAW_SAMPLES_PER_FRAME))
 
+/* Size of the slice processed by a single prediction in continuous mode. */
+#define EI_MOCK_SLICE_SIZE \
+	(EI_CLASSIFIER_DSP_INPUT_FRAME_SIZE / EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW)
+
+#define EI_MOCK_GEN_FIRST_SLICE_INPUT(PRED_IDX) \
+	((float)((PRED_IDX) * EI_MOCK_SLICE_SIZE))
+
 #define EI_MOCK_GEN_LABEL_IDX(PRED_IDX) ((PRED_IDX) % EI_CLASSIFIER_LABEL_COUNT)
 #define EI_MOCK_GEN_LABEL(PRED_IDX)	\
 	(ei_classifier_inferencing_categories[EI_MOCK_GEN_LABEL_IDX(PRED_IDX)])
@@ -458,4 +458,139 @@ static void setup_fn(void *unused)
 	zassert_true(err, "Unhandled prediction result");
 }
 
-ZTEST_SUITE(suite0, NULL, test_init, setup_fn, NULL, NULL);
+static bool suite0_predicate(const void *global_state)
+{
+	ARG_UNUSED(global_state);
+
+	return !IS_ENABLED(CONFIG_EI_WRAPPER_CONTINUOUS);
+}
+
+ZTEST_SUITE(suite0, suite0_predicate, test_init, setup_fn, NULL, NULL);
+
+static int add_slice_data(const size_t slice_idx)
+{
+	static float data_buf[EI_CLASSIFIER_RAW_SAMPLES_PER_FRAME];
+
+	int err = 0;
+	float value = EI_MOCK_GEN_FIRST_SLICE_INPUT(slice_idx);
+
+	for (size_t i = 0; i < EI_MOCK_SLICE_SIZE; i += EI_CLASSIFIER_RAW_SAMPLES_PER_FRAME) {
+		for (size_t j = 0; j < ARRAY_SIZE(data_buf); j++) {
+			data_buf[j] = value;
+			value++;
+		}
+
+		err = ei_wrapper_add_data(data_buf, EI_CLASSIFIER_RAW_SAMPLES_PER_FRAME);
+		if (err) {
+			break;
+		}
+	}
+
+	return err;
+}
+
+ZTEST(suite_continuous, test_slice_size)
+{
+	zassert_equal(ei_wrapper_get_slice_size(), EI_MOCK_SLICE_SIZE, "Wrong slice size");
+	zassert_true(ei_wrapper_get_slice_size() % ei_wrapper_get_frame_size() == 0,
+		     "Wrong slice and frame size combination");
+}
+
+ZTEST(suite_continuous, test_slices)
+{
+	const static size_t loop_cnt = 10 * EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW;
+	const size_t slice_frames = ei_wrapper_get_slice_size() / ei_wrapper_get_frame_size();
+	int err;
+
+	for (size_t i = 0; i < loop_cnt; i++) {
+		size_t frame_shift = (i == 0) ? (0) : (slice_frames);
+
+		err = add_slice_data(prediction_idx);
+		zassert_ok(err, "Cannot add input data");
+
+		err = ei_wrapper_start_prediction(0, frame_shift);
+		zassert_ok(err, "Cannot start prediction");
+		err = k_sem_take(&test_sem, EI_TEST_SEM_TIMEOUT);
+		zassert_ok(err, "Cannot take semaphore");
+	}
+
+	zassert_equal(ei_run_classifier_mock_reset_cnt(), 1,
+		      "Classifier state should be reset only once");
+}
+
+ZTEST(suite_continuous, test_slice_after_start)
+{
+	int err;
+
+	/* Prediction waits until the whole slice is available. */
+	err = ei_wrapper_start_prediction(0, 0);
+	zassert_ok(err, "Cannot start prediction");
+	err = k_sem_take(&test_sem, EI_TEST_SEM_TIMEOUT);
+	zassert_true(err, "Expected semaphore timeout");
+
+	err = add_slice_data(prediction_idx);
+	zassert_ok(err, "Cannot add input data");
+	err = k_sem_take(&test_sem, EI_TEST_SEM_TIMEOUT);
+	zassert_ok(err, "Cannot take semaphore");
+}
+
+ZTEST(suite_continuous, test_invalid_shift)
+{
+	const size_t slice_frames = ei_wrapper_get_slice_size() / ei_wrapper_get_frame_size();
+	int err;
+
+	err = ei_wrapper_start_prediction(1, 0);
+	zassert_equal(err, -EINVAL, "Window shift should not be allowed");
+	err = ei_wrapper_start_prediction(0, slice_frames + 1);
+	zassert_equal(err, -EINVAL, "Shift longer than slice should not be allowed");
+	err = ei_wrapper_start_prediction(0, slice_frames - 1);
+	zassert_equal(err, -EINVAL, "Shift shorter than slice should not be allowed");
+	err = ei_wrapper_start_prediction(0, slice_frames);
+	zassert_equal(err, -EINVAL, "First prediction should not be shifted");
+}
+
+ZTEST(suite_continuous, test_no_shift_after_first_prediction)
+{
+	int err;
+
+	err = add_slice_data(prediction_idx);
+	zassert_ok(err, "Cannot add input data");
+	run_basic_setup(prediction_idx, 0, 0, 0);
+
+	/* The same slice would be passed to the classifier twice. */
+	err = ei_wrapper_start_prediction(0, 0);
+	zassert_equal(err, -EINVAL, "No shift should not be allowed after first prediction");
+}
+
+ZTEST(suite_continuous, test_reset_on_clear)
+{
+	bool cancelled;
+	int err;
+
+	err = add_slice_data(prediction_idx);
+	zassert_ok(err, "Cannot add input data");
+	run_basic_setup(prediction_idx, 0, 0, 0);
+	zassert_equal(ei_run_classifier_mock_reset_cnt(), 1, "Classifier state not reset");
+
+	err = ei_wrapper_clear_data(&cancelled);
+	zassert_ok(err, "Cannot clear data");
+	zassert_false(cancelled, "Unexpected prediction cancel");
+
+	/* Slices are counted from the start of the buffer again. */
+	prediction_idx = 0;
+	ei_run_classifier_mock_init();
+
+	err = add_slice_data(prediction_idx);
+	zassert_ok(err, "Cannot add input data");
+	run_basic_setup(prediction_idx, 0, 0, 0);
+	zassert_equal(ei_run_classifier_mock_reset_cnt(), 1, "Classifier state not reset");
+}
+
+static bool suite_continuous_predicate(const void *global_state)
+{
+	ARG_UNUSED(global_state);
+
+	return IS_ENABLED(CONFIG_EI_WRAPPER_CONTINUOUS);
+}
+
+ZTEST_SUITE(suite_continuous, suite_continuous_predicate, test_init, setup_fn, NULL, NULL);
@@ -0,0 +1,599 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/byteorder.h>
+#include <modem/location.h>
+
+#if defined(CONFIG_LOCATION_CACHE_SETTINGS)
+#include <zephyr/settings/settings.h>
+#include <date_time.h>
+#endif
+
+#include "location_cache.h"
+
+LOG_MODULE_REGISTER(location, CONFIG_LOCATION_LOG_LEVEL);
+
+/* The synthetic radio environment. Access points are on a grid with some jitter, and the
+ * signal strength decreases linearly with the distance. Cells are on a coarser grid.
+ * Positions are in meters, and latitude and longitude are derived from them as if
+ * at the equator.
+ */
+#define AP_SPACING		30
+#define AP_JITTER		10
+#define AP_RANGE		120
+#define AP_RSSI_1M		-30
+#define AP_RSSI_NOISE		3
+#define SCAN_AP_MAX		10
+
+#define CELL_SPACING		1500
+#define CELL_NEIGHBOR_MAX	6
+#define CELL_RSRP_NOISE		2
+
+#define METERS_PER_DEGREE	111320.0
+
+/* Accuracy of the locations returned by the simulated location service */
+#define WIFI_ACCURACY		20.0f
+#define CELL_ACCURACY		500.0f
+
+#define TTL_SEC			CONFIG_LOCATION_CACHE_TTL
+#define CACHE_SIZE		CONFIG_LOCATION_CACHE_SIZE
+
+struct position {
+	int32_t x;
+	int32_t y;
+};
+
+struct locate_result {
+	struct position position;
+	float accuracy;
+	bool hit;
+	uint8_t similarity;
+};
+
+static struct wifi_scan_result scan_aps[SCAN_AP_MAX];
+static struct lte_lc_ncell scan_ncells[CELL_NEIGHBOR_MAX];
+static uint32_t prng_state;
+static uint32_t service_request_cnt;
+
+#if defined(CONFIG_LOCATION_CACHE_SETTINGS)
+/* UTC time at boot */
+#define BOOT_TIME_MS		1700000000000LL
+
+static bool time_valid;
+
+int date_time_now(int64_t *unix_time_ms)
+{
+	if (!time_valid) {
+		return -ENODATA;
+	}
+
+	*unix_time_ms = BOOT_TIME_MS + k_uptime_get();
+	return 0;
+}
+
+/* RAM settings backend */
+struct ram_setting {
+	char name[SETTINGS_MAX_NAME_LEN + 1];
+	uint8_t value[256];
+	size_t len;
+};
+
+static struct ram_setting ram_settings[CACHE_SIZE];
+
+static ssize_t ram_setting_read(void *cb_arg, void *data, size_t len)
+{
+	struct ram_setting *setting = cb_arg;
+
+	len = MIN(len, setting->len);
+	memcpy(data, setting->value, len);
+	return len;
+}
+
+static int ram_settings_load(struct settings_store *cs, const struct settings_load_arg *arg)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(ram_settings); i++) {
+		if (ram_settings[i].len) {
+			settings_call_set_handler(ram_settings[i].name, ram_settings[i].len,
+						  ram_setting_read, &ram_settings[i], arg);
+		}
+	}
+	return 0;
+}
+
+static struct ram_setting *ram_setting_find(const char *name)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(ram_settings); i++) {
+		if (ram_settings[i].len && !strcmp(ram_settings[i].name, name)) {
+			return &ram_settings[i];
+		}
+	}
+	return NULL;
+}
+
+static int ram_settings_save(struct settings_store *cs, const char *name, const char *value,
+			     size_t val_len)
+{
+	struct ram_setting *setting = ram_setting_find(name);
+
+	if (!value || !val_len) {
+		if (setting) {
+			setting->len = 0;
+		}
+		return 0;
+	}
+
+	if (!setting) {
+		for (size_t i = 0; !setting && i < ARRAY_SIZE(ram_settings); i++) {
+			if (!ram_settings[i].len) {
+				setting = &ram_settings[i];
+			}
+		}
+	}
+	if (!setting || val_len > sizeof(setting->value)) {
+		return -ENOMEM;
+	}
+
+	strncpy(setting->name, name, sizeof(setting->name) - 1);
+	memcpy(setting->value, value, val_len);
+	setting->len = val_len;
+	return 0;
+}
+
+static const struct settings_store_itf ram_settings_itf = {
+	.csi_load = ram_settings_load,
+	.csi_save = ram_settings_save,
+};
+
+static struct settings_store ram_settings_store = {
+	.cs_itf = &ram_settings_itf,
+};
+
+int settings_backend_init(void)
+{
+	settings_dst_register(&ram_settings_store);
+	settings_src_register(&ram_settings_store);
+	return 0;
+}
+#endif /* CONFIG_LOCATION_CACHE_SETTINGS */
+
+/* xorshift32, so that the scan traces are the same on every run */
+static uint32_t prng_get(void)
+{
+	prng_state ^= prng_state << 13;
+	prng_state ^= prng_state >> 17;
+	prng_state ^= prng_state << 5;
+
+	return prng_state;
+}
+
+static int32_t noise_get(int32_t amplitude)
+{
+	return (int32_t)(prng_get() % (2 * amplitude + 1)) - amplitude;
+}
+
+static uint32_t grid_hash(int32_t i, int32_t j)
+{
+	uint32_t hash = (uint32_t)i * 73856093U ^ (uint32_t)j * 19349663U;
+
+	hash ^= hash >> 15;
+	hash *= 2246822519U;
+	hash ^= hash >> 13;
+
+	return hash;
+}
+
+static uint32_t isqrt(uint32_t value)
+{
+	uint32_t root = 0;
+	uint32_t bit = 1U << 30;
+
+	while (bit > value) {
+		bit >>= 2;
+	}
+
+	while (bit) {
+		if (value >= root + bit) {
+			value -= root + bit;
+			root = (root >> 1) + bit;
+		} else {
+			root >>= 1;
+		}
+		bit >>= 2;
+	}
+
+	return root;
+}
+
+static uint32_t distance_get(const struct position *a, const struct position *b)
+{
+	int32_t dx = a->x - b->x;
+	int32_t dy = a->y - b->y;
+
+	return isqrt(dx * dx + dy * dy);
+}
+
+static int32_t floor_div(int32_t a, int32_t b)
+{
+	return (a >= 0) ? a / b : -((-a + b - 1) / b);
+}
+
+/* Scans the access points around a position, keeping the strongest ones sorted by signal
+ * strength like the Wi-Fi scanning of the library does.
+ */
+static void wifi_scan(const struct position *position, struct wifi_scan_info *info)
+{
+	struct wifi_scan_result ap;
+	struct position ap_position;
+	uint32_t hash;
+	uint32_t distance;
+	int32_t i0 = floor_div(position->x, AP_SPACING);
+	int32_t j0 = floor_div(position->y, AP_SPACING);
+	int n;
+
+	info->ap_info = scan_aps;
+	info->cnt = 0;
+
+	for (int32_t i = i0 - 5; i <= i0 + 5; i++) {
+		for (int32_t j = j0 - 5; j <= j0 + 5; j++) {
+			hash = grid_hash(i, j);
+			ap_position.x = i * AP_SPACING + (int32_t)(hash % (2 * AP_JITTER + 1)) -
+					AP_JITTER;
+			ap_position.y = j * AP_SPACING +
+					(int32_t)((hash >> 8) % (2 * AP_JITTER + 1)) - AP_JITTER;
+
+			distance = distance_get(position, &ap_position);
+			if (distance > AP_RANGE) {
+				continue;
+			}
+
+			memset(&ap, 0, sizeof(ap));
+			ap.mac[0] = 0x00;
+			ap.mac[1] = 0x1d;
+			sys_put_be32(hash, &ap.mac[2]);
+			ap.mac_length = WIFI_MAC_ADDR_LEN;
+			ap.rssi = AP_RSSI_1M - distance / 2 + noise_get(AP_RSSI_NOISE);
+
+			n = info->cnt;
+			if (n == SCAN_AP_MAX) {
+				if (ap.rssi <= scan_aps[n - 1].rssi) {
+					continue;
+				}
+				n--;
+			} else {
+				info->cnt++;
+			}
+			for (; n > 0 && scan_aps[n - 1].rssi < ap.rssi; n--) {
+				scan_aps[n] = scan_aps[n - 1];
+			}
+			scan_aps[n] = ap;
+		}
+	}
+}
+
+/* Measures the nearest cell as the serving cell and the next ones as the neighbor cells */
+static void cell_scan(const struct position *position, struct lte_lc_cells_info *info)
+{
+	struct position cell_position;
+	uint32_t best_distance = UINT32_MAX;
+	uint32_t distance;
+	int32_t i0 = floor_div(position->x, CELL_SPACING);
+	int32_t j0 = floor_div(position->y, CELL_SPACING);
+	uint32_t id;
+
+	memset(info, 0, sizeof(*info));
+	info->neighbor_cells = scan_ncells;
+	info->current_cell.mcc = 244;
+	info->current_cell.mnc = 91;
+
+	for (int32_t i = i0 - 1; i <= i0 + 2; i++) {
+		for (int32_t j = j0 - 1; j <= j0 + 2; j++) {
+			cell_position.x = i * CELL_SPACING;
+			cell_position.y = j * CELL_SPACING;
+			distance = distance_get(position, &cell_position);
+			id = grid_hash(i, j) & LTE_LC_CELL_EUTRAN_ID_MAX;
+
+			if (distance < best_distance) {
+				if (best_distance != UINT32_MAX &&
+				    info->ncells_count < CELL_NEIGHBOR_MAX) {
+					/* The previous serving cell becomes a neighbor */
+					scan_ncells[info->ncells_count].earfcn = 6400;
+					scan_ncells[info->ncells_count].phys_cell_id =
+						info->current_cell.id % 504;
+					scan_ncells[info->ncells_count].rsrp =
+						info->current_cell.rsrp;
+					info->ncells_count++;
+				}
+				best_distance = distance;
+				info->current_cell.id = id;
+				info->current_cell.tac = 100 + id % 7;
+				info->current_cell.rsrp = CLAMP(97 - (int32_t)distance / 40 +
+								noise_get(CELL_RSRP_NOISE), 0, 97);
+			} else if (info->ncells_count < CELL_NEIGHBOR_MAX) {
+				scan_ncells[info->ncells_count].earfcn = 6400;
+				scan_ncells[info->ncells_count].phys_cell_id = id % 504;
+				scan_ncells[info->ncells_count].rsrp =
+					CLAMP(97 - (int32_t)distance / 40 +
+					      noise_get(CELL_RSRP_NOISE), 0, 97);
+				info->ncells_count++;
+			}
+		}
+	}
+}
+
+/* Makes a location request as the cloud location method does: a cached location is used if
+ * there is one for the radio environment, otherwise the simulated location service returns
+ * the true position and it is cached.
+ */
+static void locate(const struct position *position, bool wifi, bool cell,
+		   struct locate_result *result)
+{
+	struct location_cache_fingerprint fingerprint;
+	struct lte_lc_cells_info cell_info;
+	struct wifi_scan_info wifi_info;
+	struct location_data location = { 0 };
+
+	if (wifi) {
+		wifi_scan(position, &wifi_info);
+	}
+	if (cell) {
+		cell_scan(position, &cell_info);
+	}
+
+	location_cache_fingerprint_make(&fingerprint, cell ? &cell_info : NULL,
+					wifi ? &wifi_info : NULL);
+
+	result->hit = location_cache_get(&fingerprint, &location, &result->similarity) == 0;
+	if (!result->hit) {
+		service_request_cnt++;
+		location.latitude = position->y / METERS_PER_DEGREE;
+		location.longitude = position->x / METERS_PER_DEGREE;
+		location.accuracy = wifi ? WIFI_ACCURACY : CELL_ACCURACY;
+		location_cache_put(&fingerprint, &location);
+	}
+
+	result->position.x = (int32_t)(location.longitude * METERS_PER_DEGREE +
+				       (location.longitude >= 0 ? 0.5 : -0.5));
+	result->position.y = (int32_t)(location.latitude * METERS_PER_DEGREE +
+				       (location.latitude >= 0 ? 0.5 : -0.5));
+	result->accuracy = location.accuracy;
+}
+
+static void cache_before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+#if defined(CONFIG_LOCATION_CACHE_SETTINGS)
+	time_valid = true;
+	memset(ram_settings, 0, sizeof(ram_settings));
+#endif
+	zassert_ok(location_cache_init());
+	location_cache_clear();
+	prng_state = 0x5eed1234;
+	service_request_cnt = 0;
+}
+
+ZTEST(suite_location_cache, test_stationary)
+{
+	const struct position home = { 100, 200 };
+	struct locate_result result;
+	uint32_t hits;
+	uint32_t misses;
+
+	locate(&home, true, true, &result);
+	zassert_false(result.hit);
+
+	for (int i = 0; i < 30; i++) {
+		k_sleep(K_SECONDS(10));
+		locate(&home, true, true, &result);
+
+		zassert_true(result.hit, "Request %d not answered from the cache", i);
+		zassert_equal(result.position.x, home.x);
+		zassert_equal(result.position.y, home.y);
+		zassert_true(result.accuracy >= WIFI_ACCURACY, "Accuracy not widened");
+		zassert_true(result.accuracy <= WIFI_ACCURACY * 100 /
+					       CONFIG_LOCATION_CACHE_SIMILARITY_THRESHOLD);
+	}
+
+	zassert_equal(service_request_cnt, 1);
+
+	location_cache_stats_get(&hits, &misses);
+	zassert_equal(hits, 30);
+	zassert_equal(misses, 1);
+}
+
+ZTEST(suite_location_cache, test_stationary_cellular)
+{
+	const struct position home = { 100, 200 };
+	struct locate_result result;
+
+	locate(&home, false, true, &result);
+	zassert_false(result.hit);
+
+	for (int i = 0; i < 10; i++) {
+		locate(&home, false, true, &result);
+		zassert_true(result.hit, "Request %d not answered from the cache", i);
+		zassert_true(result.accuracy >= CELL_ACCURACY);
+	}
+
+	/* A location acquired with Wi-Fi is not used for a cellular only request, and the
+	 * other way around.
+	 */
+	locate(&home, true, true, &result);
+	zassert_false(result.hit);
+	locate(&home, true, false, &result);
+	zassert_false(result.hit);
+
+	zassert_equal(service_request_cnt, 3);
+}
+
+ZTEST(suite_location_cache, test_slow_movement)
+{
+	struct position position = { 0, 0 };
+	struct locate_result result;
+	uint32_t error;
+	int hit_cnt = 0;
+
+	/* Walking 3 meters between requests along a 600 meter route */
+	for (int i = 0; i < 200; i++) {
+		position.x += 3;
+		k_sleep(K_SECONDS(2));
+		locate(&position, true, true, &result);
+
+		error = distance_get(&position, &result.position);
+		if (result.hit) {
+			hit_cnt++;
+			/* The position has moved since the cached location was acquired,
+			 * so the error is only bounded by the widened accuracy.
+			 */
+			zassert_true(error <= 3 * result.accuracy,
+				     "Error %d m too large for accuracy %d m at %d m",
+				     error, (int)result.accuracy, position.x);
+		} else {
+			zassert_equal(error, 0);
+		}
+	}
+
+	/* The cached locations are used while the environment stays similar, and renewed
+	 * when enough access points have changed.
+	 */
+	zassert_true(hit_cnt > 150, "Only %d hits", hit_cnt);
+	zassert_true(service_request_cnt > 5, "Only %d service requests", service_request_cnt);
+}
+
+ZTEST(suite_location_cache, test_sudden_relocation)
+{
+	const struct position a = { 100, 200 };
+	const struct position b = { 5100, 3200 };
+	struct locate_result result;
+
+	for (int i = 0; i < 5; i++) {
+		locate(&a, true, true, &result);
+	}
+	zassert_equal(service_request_cnt, 1);
+
+	/* The location of the previous place must not be returned after a relocation */
+	locate(&b, true, true, &result);
+	zassert_false(result.hit);
+	zassert_equal(result.position.x, b.x);
+	zassert_equal(result.position.y, b.y);
+
+	for (int i = 0; i < 5; i++) {
+		locate(&b, true, true, &result);
+		zassert_true(result.hit);
+		zassert_equal(result.position.x, b.x);
+		zassert_equal(result.position.y, b.y);
+	}
+
+	/* Both places are cached */
+	locate(&a, true, true, &result);
+	zassert_true(result.hit);
+	zassert_equal(result.position.x, a.x);
+	zassert_equal(result.position.y, a.y);
+
+	zassert_equal(service_request_cnt, 2);
+}
+
+ZTEST(suite_location_cache, test_ttl)
+{
+	const struct position home = { 100, 200 };
+	struct locate_result result;
+
+	locate(&home, true, true, &result);
+	zassert_false(result.hit);
+
+	k_sleep(K_SECONDS(TTL_SEC - 1));
+	locate(&home, true, true, &result);
+	zassert_true(result.hit);
+
+	k_sleep(K_SECONDS(1));
+	locate(&home, true, true, &result);
+	zassert_false(result.hit, "Expired location used");
+	zassert_equal(service_request_cnt, 2);
+}
+
+ZTEST(suite_location_cache, test_lru)
+{
+	struct position places[CACHE_SIZE + 1];
+	struct locate_result result;
+
+	for (int i = 0; i < ARRAY_SIZE(places); i++) {
+		places[i].x = i * 1000;
+		places[i].y = 0;
+	}
+
+	for (int i = 0; i < CACHE_SIZE; i++) {
+		locate(&places[i], true, true, &result);
+		zassert_false(result.hit);
+	}
+
+	/* Using the oldest place makes the second one the least recently used */
+	locate(&places[0], true, true, &result);
+	zassert_true(result.hit);
+
+	locate(&places[CACHE_SIZE], true, true, &result);
+	zassert_false(result.hit);
+
+	locate(&places[1], true, true, &result);
+	zassert_false(result.hit, "Least recently used location not replaced");
+
+	locate(&places[0], true, true, &result);
+	zassert_true(result.hit);
+	locate(&places[CACHE_SIZE], true, true, &result);
+	zassert_true(result.hit);
+}
+
+#if defined(CONFIG_LOCATION_CACHE_SETTINGS)
+ZTEST(suite_location_cache, test_settings_restore)
+{
+	const struct position a = { 100, 200 };
+	const struct position b = { 5100, 3200 };
+	struct locate_result result;
+
+	locate(&a, true, true, &result);
+	locate(&b, false, true, &result);
+	zassert_equal(service_request_cnt, 2);
+
+	/* Reboot */
+	zassert_ok(location_cache_init());
+
+	locate(&a, true, true, &result);
+	zassert_true(result.hit, "Location not restored");
+	zassert_equal(result.position.x, a.x);
+	locate(&b, false, true, &result);
+	zassert_true(result.hit, "Location not restored");
+	zassert_equal(result.position.x, b.x);
+
+	/* Cleared locations are not restored */
+	location_cache_clear();
+	zassert_ok(location_cache_init());
+
+	locate(&a, true, true, &result);
+	zassert_false(result.hit);
+}
+
+ZTEST(suite_location_cache, test_no_valid_time)
+{
+	const struct position home = { 100, 200 };
+	struct locate_result result;
+
+	/* Locations cannot be timestamped before the time is known */
+	time_valid = false;
+	locate(&home, true, true, &result);
+	locate(&home, true, true, &result);
+	zassert_false(result.hit);
+
+	time_valid = true;
+	locate(&home, true, true, &result);
+	zassert_false(result.hit);
+	locate(&home, true, true, &result);
+	zassert_true(result.hit);
+}
+#endif /* CONFIG_LOCATION_CACHE_SETTINGS */
+
+ZTEST_SUITE(suite_location_cache, NULL, NULL, cache_before, NULL, NULL);
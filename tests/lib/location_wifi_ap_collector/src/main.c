@@ -0,0 +1,358 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <zephyr/ztest.h>
+
+#include "wifi_ap_collector.h"
+#include "test_host_time.h"
+
+/* Same as the default of CONFIG_LOCATION_METHOD_WIFI_SCANNING_RESULTS_MAX_CNT */
+#define AP_MAX			10
+
+/* Size of the replayed scenes. An nRF7002 scan in a dense urban area reports a few hundred
+ * results, with the same BSSID reported again for each band and scan pass.
+ */
+#define SCENE_AP_MAX		1000
+#define SCENE_PASS_MAX		3
+#define SCENE_RESULT_MAX	(SCENE_AP_MAX * SCENE_PASS_MAX)
+
+#define RSSI_MIN		-100
+#define RSSI_MAX		-20
+
+/* Number of times a scene is replayed when measuring the insertion cost, and the limit for
+ * the average cost of one result. The limit is generous on purpose, the cost of a bounded
+ * collector is a few tens of nanoseconds on a host, whereas a search through the stored
+ * entries would grow with the buffer size.
+ */
+#define COST_REPEAT_CNT		200
+#define COST_PER_RESULT_MAX_NS	2000
+
+WIFI_AP_COLLECTOR_DEFINE(collector, AP_MAX, 0);
+WIFI_AP_COLLECTOR_DEFINE(filtering_collector, AP_MAX,
+			 WIFI_AP_COLLECTOR_FILTER_LOCAL_MAC | WIFI_AP_COLLECTOR_FILTER_HIDDEN_SSID);
+WIFI_AP_COLLECTOR_DEFINE(single_collector, 1, 0);
+
+static struct wifi_scan_result scene[SCENE_RESULT_MAX];
+static size_t scene_cnt;
+
+/* Strongest RSSI of each access point of the scene, indexed by access point. */
+static int8_t scene_ap_rssi[SCENE_AP_MAX];
+static size_t scene_ap_cnt;
+
+static uint32_t prng_state;
+
+/* xorshift32, so that the scenes are the same on every run */
+static uint32_t prng_get(void)
+{
+	prng_state ^= prng_state << 13;
+	prng_state ^= prng_state >> 17;
+	prng_state ^= prng_state << 5;
+
+	return prng_state;
+}
+
+static void ap_mac_set(uint8_t *mac, size_t ap)
+{
+	/* Globally administered unicast address with the access point index in the
+	 * device specific part.
+	 */
+	mac[0] = 0x00;
+	mac[1] = 0x1d;
+	mac[2] = 0xaa;
+	mac[3] = ap >> 16;
+	mac[4] = ap >> 8;
+	mac[5] = ap;
+}
+
+static size_t ap_from_mac(const uint8_t *mac)
+{
+	return (mac[3] << 16) | (mac[4] << 8) | mac[5];
+}
+
+/* Generates a scene with the given number of access points, each reported in every scan pass
+ * with a signal strength varying by a few dB between the passes. With ascending set, the
+ * results are ordered from the weakest to the strongest, which makes every result replace
+ * a stored one.
+ */
+static void scene_generate(uint32_t seed, size_t ap_cnt, size_t pass_cnt, bool ascending)
+{
+	struct wifi_scan_result *result;
+	int8_t base_rssi[SCENE_AP_MAX];
+
+	__ASSERT_NO_MSG(ap_cnt <= SCENE_AP_MAX && pass_cnt <= SCENE_PASS_MAX);
+
+	prng_state = seed;
+	scene_ap_cnt = ap_cnt;
+	scene_cnt = 0;
+
+	for (size_t ap = 0; ap < ap_cnt; ap++) {
+		base_rssi[ap] = ascending ?
+			RSSI_MIN + (int)(ap * (RSSI_MAX - RSSI_MIN) / ap_cnt) :
+			RSSI_MIN + (int)(prng_get() % (RSSI_MAX - RSSI_MIN));
+		scene_ap_rssi[ap] = INT8_MIN;
+	}
+
+	for (size_t pass = 0; pass < pass_cnt; pass++) {
+		for (size_t ap = 0; ap < ap_cnt; ap++) {
+			result = &scene[scene_cnt++];
+
+			memset(result, 0, sizeof(*result));
+			ap_mac_set(result->mac, ap);
+			result->mac_length = WIFI_MAC_ADDR_LEN;
+			result->ssid_length = snprintk((char *)result->ssid, sizeof(result->ssid),
+						       "AP%u", (unsigned int)ap);
+			result->channel = 1 + ap % 13;
+			result->rssi = ascending ?
+				base_rssi[ap] + pass :
+				base_rssi[ap] + (int)(prng_get() % 7) - 3;
+
+			scene_ap_rssi[ap] = MAX(scene_ap_rssi[ap], result->rssi);
+		}
+	}
+}
+
+static int rssi_compare_desc(const void *a, const void *b)
+{
+	return *(const int8_t *)b - *(const int8_t *)a;
+}
+
+static void scene_replay(struct wifi_ap_collector *target)
+{
+	wifi_ap_collector_reset(target);
+
+	for (size_t i = 0; i < scene_cnt; i++) {
+		(void)wifi_ap_collector_add(target, &scene[i]);
+	}
+}
+
+/* Checks that the collector holds the strongest access points of the scene, each once and
+ * with its strongest RSSI, strongest first. Access points with an equal RSSI at the limit may
+ * be selected either way, so the selection is compared by signal strength.
+ */
+static void scene_selection_verify(struct wifi_ap_collector *target)
+{
+	static int8_t expected[SCENE_AP_MAX];
+	size_t expected_cnt = MIN(scene_ap_cnt, target->max_cnt);
+	struct wifi_scan_result *ap;
+
+	memcpy(expected, scene_ap_rssi, scene_ap_cnt);
+	qsort(expected, scene_ap_cnt, sizeof(expected[0]), rssi_compare_desc);
+
+	zassert_equal(target->cnt, expected_cnt, "Wrong number of access points selected");
+
+	for (int i = 0; i < target->cnt; i++) {
+		ap = &target->aps[i];
+
+		zassert_equal(ap->rssi, expected[i], "Wrong access point selected at %d", i);
+		zassert_equal(ap->rssi, scene_ap_rssi[ap_from_mac(ap->mac)],
+			      "Access point not stored with its strongest signal");
+
+		for (int j = 0; j < i; j++) {
+			zassert_false(memcmp(ap->mac, target->aps[j].mac, WIFI_MAC_ADDR_LEN) == 0,
+				      "Access point stored twice");
+		}
+	}
+}
+
+static uint64_t scene_cost_ns_get(struct wifi_ap_collector *target)
+{
+	uint64_t start;
+	uint64_t elapsed = 0;
+
+	for (size_t i = 0; i < COST_REPEAT_CNT; i++) {
+		wifi_ap_collector_reset(target);
+
+		start = test_timestamp_get();
+		for (size_t j = 0; j < scene_cnt; j++) {
+			(void)wifi_ap_collector_add(target, &scene[j]);
+		}
+		elapsed += test_elapsed_ns_get(start);
+	}
+
+	return elapsed / (COST_REPEAT_CNT * scene_cnt);
+}
+
+static struct wifi_scan_result result_make(uint8_t mac0, uint8_t mac5, int8_t rssi,
+					   const char *ssid)
+{
+	struct wifi_scan_result result = {
+		.mac = {mac0, 0x1d, 0xaa, 0x00, 0x00, mac5},
+		.mac_length = WIFI_MAC_ADDR_LEN,
+		.rssi = rssi,
+		.channel = 6,
+	};
+
+	result.ssid_length = strlen(ssid);
+	memcpy(result.ssid, ssid, result.ssid_length);
+
+	return result;
+}
+
+static void collector_before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	wifi_ap_collector_reset(&collector);
+	wifi_ap_collector_reset(&filtering_collector);
+	wifi_ap_collector_reset(&single_collector);
+}
+
+ZTEST(suite_wifi_ap_collector, test_keeps_strongest)
+{
+	const int8_t rssi[] = {-90, -40, -75, -60, -85, -45, -70, -95, -50, -65, -55, -80, -30,
+			      -99, -82};
+	const int8_t expected[] = {-30, -40, -45, -50, -55, -60, -65, -70, -75, -80};
+	struct wifi_scan_result result;
+	int err;
+
+	for (int i = 0; i < ARRAY_SIZE(rssi); i++) {
+		result = result_make(0x00, i, rssi[i], "AP");
+		err = wifi_ap_collector_add(&collector, &result);
+		/* The last ones arrive when all stored access points are stronger */
+		if (i >= AP_MAX + 3) {
+			zassert_equal(err, -ENOSPC, "Weak result stored: %d", rssi[i]);
+		} else {
+			zassert_ok(err, "Result not stored: %d", rssi[i]);
+		}
+	}
+
+	zassert_equal(collector.cnt, AP_MAX);
+	zassert_equal(collector.dropped_cnt, 5);
+
+	wifi_ap_collector_sort(&collector);
+
+	for (int i = 0; i < AP_MAX; i++) {
+		zassert_equal(collector.aps[i].rssi, expected[i], "Wrong order at %d", i);
+	}
+
+	result = result_make(0x00, 0xff, 0, "AP");
+	zassert_equal(wifi_ap_collector_add(&collector, &result), -EBUSY);
+}
+
+ZTEST(suite_wifi_ap_collector, test_duplicates)
+{
+	struct wifi_scan_result result;
+
+	/* Dual band access point reported on both bands, and again in the next scan pass */
+	result = result_make(0x00, 1, -70, "Office");
+	zassert_ok(wifi_ap_collector_add(&collector, &result));
+	result.rssi = -50;
+	result.channel = 36;
+	zassert_ok(wifi_ap_collector_add(&collector, &result));
+	result.rssi = -60;
+	result.channel = 6;
+	zassert_equal(wifi_ap_collector_add(&collector, &result), -EALREADY);
+
+	result = result_make(0x00, 2, -65, "Cafe");
+	zassert_ok(wifi_ap_collector_add(&collector, &result));
+	zassert_equal(wifi_ap_collector_add(&collector, &result), -EALREADY);
+
+	zassert_equal(collector.cnt, 2);
+	zassert_equal(collector.duplicate_cnt, 3);
+
+	wifi_ap_collector_sort(&collector);
+
+	zassert_equal(collector.aps[0].mac[5], 1);
+	zassert_equal(collector.aps[0].rssi, -50);
+	zassert_equal(collector.aps[0].channel, 36, "Entry not updated from stronger result");
+	zassert_equal(collector.aps[1].mac[5], 2);
+	zassert_equal(collector.aps[1].rssi, -65);
+}
+
+ZTEST(suite_wifi_ap_collector, test_evicted_reported_again)
+{
+	struct wifi_scan_result result;
+
+	result = result_make(0x00, 1, -80, "AP");
+	zassert_ok(wifi_ap_collector_add(&single_collector, &result));
+	result = result_make(0x00, 2, -70, "AP");
+	zassert_ok(wifi_ap_collector_add(&single_collector, &result));
+
+	/* The evicted access point is no longer known, so it competes as a new one */
+	result = result_make(0x00, 1, -75, "AP");
+	zassert_equal(wifi_ap_collector_add(&single_collector, &result), -ENOSPC);
+	result = result_make(0x00, 1, -60, "AP");
+	zassert_ok(wifi_ap_collector_add(&single_collector, &result));
+
+	zassert_equal(single_collector.cnt, 1);
+	zassert_equal(single_collector.aps[0].mac[5], 1);
+	zassert_equal(single_collector.aps[0].rssi, -60);
+}
+
+ZTEST(suite_wifi_ap_collector, test_filters)
+{
+	struct wifi_scan_result result;
+
+	/* Mobile hotspot with a locally administered address */
+	result = result_make(0x02, 1, -40, "Phone");
+	zassert_equal(wifi_ap_collector_add(&filtering_collector, &result), -EPERM);
+	zassert_ok(wifi_ap_collector_add(&collector, &result));
+
+	/* Hidden network */
+	result = result_make(0x00, 2, -45, "");
+	zassert_equal(wifi_ap_collector_add(&filtering_collector, &result), -EPERM);
+	zassert_ok(wifi_ap_collector_add(&collector, &result));
+
+	/* Multicast bit alone does not make an address locally administered */
+	result = result_make(0x01, 3, -50, "AP");
+	zassert_ok(wifi_ap_collector_add(&filtering_collector, &result));
+
+	zassert_equal(filtering_collector.cnt, 1);
+	zassert_equal(filtering_collector.filtered_cnt, 2);
+	zassert_equal(collector.cnt, 2);
+}
+
+ZTEST(suite_wifi_ap_collector, test_scene_replay)
+{
+	static const struct {
+		uint32_t seed;
+		size_t ap_cnt;
+		size_t pass_cnt;
+	} scenes[] = {
+		{ 0x1234abcd, 5, 2 },		/* Rural, fewer APs than the buffer */
+		{ 0x5eed0001, 60, 1 },		/* Residential */
+		{ 0x5eed0002, 250, 2 },		/* Office building, dual band */
+		{ 0x5eed0003, 600, 3 },		/* City center */
+		{ 0x5eed0004, SCENE_AP_MAX, 3 },
+	};
+
+	for (int i = 0; i < ARRAY_SIZE(scenes); i++) {
+		scene_generate(scenes[i].seed, scenes[i].ap_cnt, scenes[i].pass_cnt, false);
+
+		scene_replay(&collector);
+		wifi_ap_collector_sort(&collector);
+		scene_selection_verify(&collector);
+	}
+
+	/* Worst case, every result replaces the weakest stored one */
+	scene_generate(0x5eed0005, SCENE_AP_MAX, SCENE_PASS_MAX, true);
+	scene_replay(&collector);
+	wifi_ap_collector_sort(&collector);
+	scene_selection_verify(&collector);
+}
+
+ZTEST(suite_wifi_ap_collector, test_insertion_cost)
+{
+	uint64_t cost_random;
+	uint64_t cost_ascending;
+
+	scene_generate(0x5eed0006, SCENE_AP_MAX, SCENE_PASS_MAX, false);
+	cost_random = scene_cost_ns_get(&collector);
+
+	/* Worst case, every result replaces the weakest stored one */
+	scene_generate(0x5eed0007, SCENE_AP_MAX, SCENE_PASS_MAX, true);
+	cost_ascending = scene_cost_ns_get(&collector);
+
+	TC_PRINT("Insertion cost per result: %llu ns in random order, %llu ns in ascending order\n",
+		 (unsigned long long)cost_random, (unsigned long long)cost_ascending);
+
+	zassert_true(cost_random < COST_PER_RESULT_MAX_NS, "Insertion too slow");
+	zassert_true(cost_ascending < COST_PER_RESULT_MAX_NS, "Insertion too slow");
+}
+
+ZTEST_SUITE(suite_wifi_ap_collector, NULL, NULL, collector_before, NULL, NULL);
@@ -1564,6 +1564,54 @@ void test_nrf91_socket_offload_sendmsg_fits_buf(void)
 	TEST_ASSERT_EQUAL(ret, 0);
 }
 
+void test_nrf91_socket_offload_sendmsg_fits_buf_partial(void)
+{
+	int ret;
+	int fd;
+	int nrf_fd = 2;
+	int family = AF_INET;
+	int type = SOCK_STREAM;
+	int proto = IPPROTO_TCP;
+	int flags = ZSOCK_MSG_DONTWAIT;
+	struct msghdr msg = { 0 };
+	struct iovec chunks[2] = { 0 };
+	int chunk_1 = 42;
+	int chunk_2 = 43;
+
+	__cmock_nrf_socket_ExpectAndReturn(NRF_AF_INET, NRF_SOCK_STREAM, NRF_IPPROTO_TCP, nrf_fd);
+
+	fd = zsock_socket(family, type, proto);
+
+	TEST_ASSERT_EQUAL(fd, 0);
+
+	chunks[0].iov_base = &chunk_1;
+	chunks[0].iov_len = sizeof(int);
+	chunks[1].iov_base = &chunk_2;
+	chunks[1].iov_len = sizeof(int);
+	msg.msg_iov = chunks;
+	msg.msg_iovlen = 2;
+
+	/* The repacked data is sent in two parts, the total length is returned. */
+	__cmock_nrf_sendto_ExpectAndReturn(nrf_fd, NULL, 2 * sizeof(int),
+					   NRF_MSG_DONTWAIT,
+					   NULL, 0, sizeof(int) + 1);
+	__cmock_nrf_sendto_IgnoreArg_message();
+	__cmock_nrf_sendto_ExpectAndReturn(nrf_fd, NULL, sizeof(int) - 1,
+					   NRF_MSG_DONTWAIT,
+					   NULL, 0, sizeof(int) - 1);
+	__cmock_nrf_sendto_IgnoreArg_message();
+
+	ret = zsock_sendmsg(fd, &msg, flags);
+
+	TEST_ASSERT_EQUAL(ret, 2 * sizeof(int));
+
+	__cmock_nrf_close_ExpectAndReturn(nrf_fd, 0);
+
+	ret = zsock_close(fd);
+
+	TEST_ASSERT_EQUAL(ret, 0);
+}
+
 void test_nrf91_socket_offload_sendmsg_not_fits_buf(void)
 {
 	int ret;
@@ -1629,6 +1677,314 @@ void test_nrf91_socket_offload_sendmsg_not_fits_buf(void)
 	TEST_ASSERT_EQUAL(ret, 0);
 }
 
+void test_nrf91_socket_offload_sendmsg_single_chunk_no_copy(void)
+{
+	int ret;
+	int fd;
+	int nrf_fd = 2;
+	int family = AF_INET;
+	int type = SOCK_STREAM;
+	int proto = IPPROTO_TCP;
+	int flags = ZSOCK_MSG_DONTWAIT;
+	struct msghdr msg = { 0 };
+	struct iovec chunks[2] = { 0 };
+	int chunk_1 = 42;
+
+	__cmock_nrf_socket_ExpectAndReturn(NRF_AF_INET, NRF_SOCK_STREAM, NRF_IPPROTO_TCP, nrf_fd);
+
+	fd = zsock_socket(family, type, proto);
+
+	TEST_ASSERT_EQUAL(fd, 0);
+
+	chunks[0].iov_base = &chunk_1;
+	chunks[0].iov_len = sizeof(int);
+	chunks[1].iov_base = NULL;
+	chunks[1].iov_len = 0;
+	msg.msg_iov = chunks;
+	msg.msg_iovlen = 2;
+
+	/* The only non-empty chunk is sent directly from the caller's memory */
+	__cmock_nrf_sendto_ExpectAndReturn(nrf_fd, &chunk_1, sizeof(int),
+					   NRF_MSG_DONTWAIT,
+					   NULL, 0, sizeof(int));
+
+	ret = zsock_sendmsg(fd, &msg, flags);
+
+	TEST_ASSERT_EQUAL(ret, sizeof(int));
+
+	__cmock_nrf_close_ExpectAndReturn(nrf_fd, 0);
+
+	ret = zsock_close(fd);
+
+	TEST_ASSERT_EQUAL(ret, 0);
+}
+
+void test_nrf91_socket_offload_sendmsg_dgram_fits_buf(void)
+{
+	int ret;
+	int fd;
+	int nrf_fd = 2;
+	int family = AF_INET;
+	int type = SOCK_DGRAM;
+	int proto = IPPROTO_UDP;
+	int flags = 0;
+	struct msghdr msg = { 0 };
+	struct iovec chunks[2] = { 0 };
+	int chunk_1 = 42;
+	int chunk_2 = 43;
+
+	__cmock_nrf_socket_ExpectAndReturn(NRF_AF_INET, NRF_SOCK_DGRAM, NRF_IPPROTO_UDP, nrf_fd);
+
+	fd = zsock_socket(family, type, proto);
+
+	TEST_ASSERT_EQUAL(fd, 0);
+
+	chunks[0].iov_base = &chunk_1;
+	chunks[0].iov_len = sizeof(int);
+	chunks[1].iov_base = &chunk_2;
+	chunks[1].iov_len = sizeof(int);
+	msg.msg_iov = chunks;
+	msg.msg_iovlen = 2;
+
+	/* The datagram is sent once, even if the modem library rejects it */
+	__cmock_nrf_sendto_ExpectAndReturn(nrf_fd, NULL, 2 * sizeof(int),
+					   0, NULL, 0, -1);
+	__cmock_nrf_sendto_IgnoreArg_message();
+
+	ret = zsock_sendmsg(fd, &msg, flags);
+
+	TEST_ASSERT_EQUAL(ret, -1);
+
+	__cmock_nrf_close_ExpectAndReturn(nrf_fd, 0);
+
+	ret = zsock_close(fd);
+
+	TEST_ASSERT_EQUAL(ret, 0);
+}
+
+void test_nrf91_socket_offload_sendmsg_dgram_not_fits_buf_emsgsize(void)
+{
+	int ret;
+	int fd;
+	int nrf_fd = 2;
+	int family = AF_INET;
+	int type = SOCK_DGRAM;
+	int proto = IPPROTO_UDP;
+	int flags = 0;
+	struct msghdr msg = { 0 };
+	struct iovec chunks[3] = { 0 };
+	int chunk_1 = 42;
+	int chunk_2 = 43;
+	int chunk_3 = 44;
+
+	__cmock_nrf_socket_ExpectAndReturn(NRF_AF_INET, NRF_SOCK_DGRAM, NRF_IPPROTO_UDP, nrf_fd);
+
+	fd = zsock_socket(family, type, proto);
+
+	TEST_ASSERT_EQUAL(fd, 0);
+
+	chunks[0].iov_base = &chunk_1;
+	chunks[0].iov_len = sizeof(int);
+	chunks[1].iov_base = &chunk_2;
+	chunks[1].iov_len = sizeof(int);
+	chunks[2].iov_base = &chunk_3;
+	chunks[2].iov_len = sizeof(int);
+	msg.msg_iov = chunks;
+	msg.msg_iovlen = 3;
+
+	/* No nrf_sendto calls are expected, the datagram must not be split */
+	ret = zsock_sendmsg(fd, &msg, flags);
+
+	TEST_ASSERT_EQUAL(ret, -1);
+	TEST_ASSERT_EQUAL(errno, EMSGSIZE);
+
+	__cmock_nrf_close_ExpectAndReturn(nrf_fd, 0);
+
+	ret = zsock_close(fd);
+
+	TEST_ASSERT_EQUAL(ret, 0);
+}
+
+void test_nrf91_socket_offload_sendmsg_raw_not_fits_buf_emsgsize(void)
+{
+	int ret;
+	int fd;
+	int nrf_fd = 2;
+	int family = AF_PACKET;
+	int type = SOCK_RAW;
+	int proto = 0;
+	int flags = 0;
+	struct msghdr msg = { 0 };
+	struct iovec chunks[3] = { 0 };
+	int chunk_1 = 42;
+	int chunk_2 = 43;
+	int chunk_3 = 44;
+
+	__cmock_nrf_socket_ExpectAndReturn(NRF_AF_PACKET, NRF_SOCK_RAW, 0, nrf_fd);
+
+	fd = zsock_socket(family, type, proto);
+
+	TEST_ASSERT_EQUAL(fd, 0);
+
+	chunks[0].iov_base = &chunk_1;
+	chunks[0].iov_len = sizeof(int);
+	chunks[1].iov_base = &chunk_2;
+	chunks[1].iov_len = sizeof(int);
+	chunks[2].iov_base = &chunk_3;
+	chunks[2].iov_len = sizeof(int);
+	msg.msg_iov = chunks;
+	msg.msg_iovlen = 3;
+
+	/* Raw packets are not split either */
+	ret = zsock_sendmsg(fd, &msg, flags);
+
+	TEST_ASSERT_EQUAL(ret, -1);
+	TEST_ASSERT_EQUAL(errno, EMSGSIZE);
+
+	__cmock_nrf_close_ExpectAndReturn(nrf_fd, 0);
+
+	ret = zsock_close(fd);
+
+	TEST_ASSERT_EQUAL(ret, 0);
+}
+
+#define SENDMSG_SOCKETS_MAX 4
+#define SENDMSG_ITERATIONS 1000
+#define SENDMSG_STACK_SIZE 1024
+
+static K_THREAD_STACK_ARRAY_DEFINE(sendmsg_stacks, SENDMSG_SOCKETS_MAX, SENDMSG_STACK_SIZE);
+static struct k_thread sendmsg_threads[SENDMSG_SOCKETS_MAX];
+
+static struct test_state_sendmsg {
+	int fd;
+	ssize_t ret;
+	atomic_t sent;
+} test_state_sendmsg[SENDMSG_SOCKETS_MAX];
+
+/* Senders inside nrf_sendto() at the same time, in total and from a repacking buffer. */
+static atomic_t sendto_in_flight;
+static atomic_t sendto_in_flight_max;
+static atomic_t repacked_in_flight;
+static atomic_t repacked_in_flight_max;
+
+static void in_flight_inc(atomic_t *in_flight, atomic_t *in_flight_max)
+{
+	atomic_val_t val = atomic_inc(in_flight) + 1;
+	atomic_val_t max;
+
+	do {
+		max = atomic_get(in_flight_max);
+	} while (val > max && !atomic_cas(in_flight_max, max, val));
+}
+
+static ssize_t nrf_sendto_concurrent_stub(int socket, const void *message, size_t length,
+					  int flags, const struct nrf_sockaddr *dest_addr,
+					  nrf_socklen_t dest_len, int cmock_num_calls)
+{
+	/* Both parts of the message are sent at once only when they were repacked. */
+	bool repacked = (length == 2 * sizeof(int));
+
+	atomic_add(&test_state_sendmsg[socket - NRF_FD].sent, length);
+
+	in_flight_inc(&sendto_in_flight, &sendto_in_flight_max);
+	if (repacked) {
+		in_flight_inc(&repacked_in_flight, &repacked_in_flight_max);
+	}
+
+	/* Let the other senders run while this one is "in the modem". */
+	k_yield();
+
+	if (repacked) {
+		atomic_dec(&repacked_in_flight);
+	}
+	atomic_dec(&sendto_in_flight);
+
+	return length;
+}
+
+static void sendmsg_thread_fn(void *p1, void *p2, void *p3)
+{
+	struct test_state_sendmsg *state = p1;
+	int chunk_1 = 42;
+	int chunk_2 = 43;
+	struct iovec chunks[2] = {
+		{ .iov_base = &chunk_1, .iov_len = sizeof(int) },
+		{ .iov_base = &chunk_2, .iov_len = sizeof(int) },
+	};
+	struct msghdr msg = { .msg_iov = chunks, .msg_iovlen = ARRAY_SIZE(chunks) };
+	ssize_t ret;
+
+	for (int i = 0; i < SENDMSG_ITERATIONS; i++) {
+		ret = zsock_sendmsg(state->fd, &msg, 0);
+		if (ret != 2 * sizeof(int)) {
+			state->ret = ret;
+			return;
+		}
+	}
+
+	state->ret = 0;
+}
+
+void test_nrf91_socket_offload_sendmsg_concurrent(void)
+{
+	int ret;
+	uint32_t start;
+	uint32_t us;
+
+	for (int count = 1; count <= SENDMSG_SOCKETS_MAX; count++) {
+		for (int i = 0; i < count; i++) {
+			__cmock_nrf_socket_ExpectAndReturn(NRF_AF_INET, NRF_SOCK_STREAM,
+							   NRF_IPPROTO_TCP, NRF_FD + i);
+
+			test_state_sendmsg[i].fd = zsock_socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+			TEST_ASSERT_TRUE(test_state_sendmsg[i].fd >= 0);
+			test_state_sendmsg[i].ret = -1;
+			atomic_set(&test_state_sendmsg[i].sent, 0);
+		}
+
+		__cmock_nrf_sendto_Stub(nrf_sendto_concurrent_stub);
+
+		atomic_set(&sendto_in_flight_max, 0);
+		atomic_set(&repacked_in_flight_max, 0);
+
+		start = k_cycle_get_32();
+
+		for (int i = 0; i < count; i++) {
+			k_thread_create(&sendmsg_threads[i], sendmsg_stacks[i],
+					K_THREAD_STACK_SIZEOF(sendmsg_stacks[i]),
+					sendmsg_thread_fn, &test_state_sendmsg[i], NULL, NULL,
+					K_PRIO_PREEMPT(1), 0, K_NO_WAIT);
+		}
+
+		for (int i = 0; i < count; i++) {
+			k_thread_join(&sendmsg_threads[i], K_FOREVER);
+		}
+
+		us = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+
+		printk("sendmsg: %d socket(s), %d bytes in %u us\n", count,
+		       count * SENDMSG_ITERATIONS * 2 * (int)sizeof(int), us);
+
+		/* The senders do not serialize, and each holds a buffer of its own while
+		 * the pool lasts.
+		 */
+		TEST_ASSERT_EQUAL(count, atomic_get(&sendto_in_flight_max));
+		TEST_ASSERT_EQUAL(MIN(count, CONFIG_NRF_MODEM_LIB_SENDMSG_BUF_COUNT),
+				  atomic_get(&repacked_in_flight_max));
+
+		for (int i = 0; i < count; i++) {
+			TEST_ASSERT_EQUAL(0, test_state_sendmsg[i].ret);
+			TEST_ASSERT_EQUAL(SENDMSG_ITERATIONS * 2 * sizeof(int),
+					  atomic_get(&test_state_sendmsg[i].sent));
+
+			__cmock_nrf_close_ExpectAndReturn(NRF_FD + i, 0);
+
+			ret = zsock_close(test_state_sendmsg[i].fd);
+			TEST_ASSERT_EQUAL(ret, 0);
+		}
+	}
+}
+
 void test_nrf91_socket_offload_fcntl_einval(void)
 {
 	int ret;
@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <unity.h>
+#include <zephyr/fff.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/sys/util.h>
+#include <modem/nrf_modem_lib_trace.h>
+
+#include "trace_compression.h"
+
+#include "cmock_trace_backend_mock.h"
+#include "cmock_nrf_modem.h"
+#include "cmock_nrf_modem_trace.h"
+#include "cmock_nrf_modem_os.h"
+
+DEFINE_FFF_GLOBALS;
+
+FAKE_VALUE_FUNC_VARARG(int, nrf_modem_at_printf, const char *, ...);
+
+/* It is required to be added to each test. That is because unity's
+ * main may return nonzero, while zephyr's main currently must
+ * return 0 in all cases (other values are reserved).
+ */
+extern int unity_main(void);
+
+#define BLOCK_SIZE CONFIG_NRF_MODEM_LIB_TRACE_COMPRESSION_BLOCK_SIZE
+/* Frame written with a block size larger than the one configured for reading. */
+#define LARGE_FRAME_PAYLOAD_LEN (4 * BLOCK_SIZE)
+
+static uint8_t block[BLOCK_SIZE];
+static uint8_t stored[2 * TRACE_COMPRESSION_FRAME_SIZE(BLOCK_SIZE) +
+		      TRACE_COMPRESSION_FRAME_SIZE(LARGE_FRAME_PAYLOAD_LEN)];
+static size_t stored_len;
+static size_t stored_offset;
+/* Largest read served by the backend at once. */
+static size_t backend_read_max;
+
+static int trace_backend_read_stub(void *buf, size_t len, int cmock_num_calls)
+{
+	size_t to_read = MIN(MIN(len, backend_read_max), stored_len - stored_offset);
+
+	memcpy(buf, &stored[stored_offset], to_read);
+	stored_offset += to_read;
+
+	return to_read;
+}
+
+static void frame_store(const uint8_t *data, size_t len)
+{
+	stored_len += trace_compression_frame_encode(data, len, &stored[stored_len]);
+}
+
+static void large_frame_store(void)
+{
+	uint8_t *frame = &stored[stored_len];
+
+	frame[0] = TRACE_COMPRESSION_FRAME_MAGIC;
+	frame[1] = TRACE_COMPRESSION_FRAME_FLAG_STORED;
+	sys_put_le16(LARGE_FRAME_PAYLOAD_LEN, &frame[2]);
+	sys_put_le16(LARGE_FRAME_PAYLOAD_LEN, &frame[4]);
+	memset(&frame[TRACE_COMPRESSION_FRAME_HDR_SIZE], 0xAA, LARGE_FRAME_PAYLOAD_LEN);
+
+	stored_len += TRACE_COMPRESSION_FRAME_SIZE(LARGE_FRAME_PAYLOAD_LEN);
+}
+
+void setUp(void)
+{
+	for (size_t i = 0; i < sizeof(block); i++) {
+		block[i] = i % 7;
+	}
+
+	stored_len = 0;
+	stored_offset = 0;
+	backend_read_max = SIZE_MAX;
+
+	__cmock_trace_backend_read_Stub(trace_backend_read_stub);
+
+	/* Drop any partial frame left by the previous test. */
+	__cmock_trace_backend_clear_ExpectAndReturn(0);
+	TEST_ASSERT_EQUAL(0, nrf_modem_lib_trace_clear());
+}
+
+void test_nrf_modem_lib_trace_read_decompress(void)
+{
+	uint8_t buf[BLOCK_SIZE];
+	int ret;
+
+	frame_store(block, sizeof(block));
+
+	/* Frames are reassembled from short backend reads. */
+	backend_read_max = 5;
+
+	ret = nrf_modem_lib_trace_read(buf, sizeof(buf));
+	TEST_ASSERT_EQUAL(sizeof(buf), ret);
+	TEST_ASSERT_EQUAL_MEMORY(block, buf, sizeof(buf));
+
+	ret = nrf_modem_lib_trace_read(buf, sizeof(buf));
+	TEST_ASSERT_EQUAL(0, ret);
+}
+
+void test_nrf_modem_lib_trace_read_decompress_frame_too_large(void)
+{
+	uint8_t buf[BLOCK_SIZE];
+	int ret;
+
+	frame_store(block, sizeof(block) / 2);
+	large_frame_store();
+	frame_store(block, sizeof(block));
+
+	/* The data decompressed before the large frame is returned first. */
+	ret = nrf_modem_lib_trace_read(buf, sizeof(buf));
+	TEST_ASSERT_EQUAL(sizeof(block) / 2, ret);
+	TEST_ASSERT_EQUAL_MEMORY(block, buf, sizeof(block) / 2);
+
+	ret = nrf_modem_lib_trace_read(buf, sizeof(buf));
+	TEST_ASSERT_EQUAL(-EBADMSG, ret);
+
+	/* The large frame is dropped, and reading continues from the next frame. */
+	ret = nrf_modem_lib_trace_read(buf, sizeof(buf));
+	TEST_ASSERT_EQUAL(sizeof(block), ret);
+	TEST_ASSERT_EQUAL_MEMORY(block, buf, sizeof(block));
+	TEST_ASSERT_EQUAL(stored_len, stored_offset);
+}
+
+int main(void)
+{
+	(void)unity_main();
+
+	return 0;
+}
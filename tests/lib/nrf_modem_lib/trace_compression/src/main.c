@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <zephyr/random/random.h>
+
+#include "trace_compression.h"
+
+#define BLOCK_SIZE TRACE_COMPRESSION_BLOCK_SIZE_MAX
+
+static uint8_t raw[BLOCK_SIZE];
+static uint8_t frame[TRACE_COMPRESSION_FRAME_SIZE(BLOCK_SIZE)];
+static uint8_t decoded[BLOCK_SIZE];
+
+/* Generate data resembling modem traces: short records with a repeating header,
+ * an incrementing sequence number and a few bytes of varying payload.
+ */
+static void trace_like_data_generate(uint8_t *buf, size_t len)
+{
+	static const uint8_t hdr[] = { 0xEF, 0xBE, 0x0D, 0xF0, 0x01, 0x02, 0x00, 0x10 };
+	uint16_t seq = 0;
+	size_t pos = 0;
+
+	while (pos < len) {
+		for (size_t i = 0; i < sizeof(hdr) && pos < len; i++) {
+			buf[pos++] = hdr[i];
+		}
+		for (size_t i = 0; i < 2 && pos < len; i++) {
+			buf[pos++] = seq >> (8 * i);
+		}
+		for (size_t i = 0; i < 6 && pos < len; i++) {
+			buf[pos++] = sys_rand32_get() % 4;
+		}
+		seq++;
+	}
+}
+
+static size_t round_trip(size_t len)
+{
+	size_t frame_len;
+	int ret;
+
+	frame_len = trace_compression_frame_encode(raw, len, frame);
+	zassert_true(frame_len <= TRACE_COMPRESSION_FRAME_SIZE(len), "Frame too long");
+
+	ret = trace_compression_frame_len(frame);
+	zassert_equal(ret, frame_len, "Wrong frame length in header");
+
+	ret = trace_compression_frame_decode(frame, frame_len, decoded, sizeof(decoded));
+	zassert_equal(ret, len, "Wrong decoded length");
+	zassert_mem_equal(raw, decoded, len, "Decoded data does not match");
+
+	return frame_len;
+}
+
+ZTEST(trace_compression, test_random_data_is_stored)
+{
+	size_t frame_len;
+
+	sys_rand_get(raw, sizeof(raw));
+
+	frame_len = round_trip(sizeof(raw));
+	zassert_equal(frame[1], TRACE_COMPRESSION_FRAME_FLAG_STORED, "Frame not stored");
+	zassert_equal(frame_len, TRACE_COMPRESSION_FRAME_SIZE(sizeof(raw)), "Wrong frame length");
+}
+
+ZTEST(trace_compression, test_trace_like_data_compresses)
+{
+	size_t frame_len;
+	uint32_t start;
+	uint32_t cycles;
+
+	trace_like_data_generate(raw, sizeof(raw));
+
+	start = k_cycle_get_32();
+	frame_len = trace_compression_frame_encode(raw, sizeof(raw), frame);
+	cycles = k_cycle_get_32() - start;
+
+	zassert_equal(frame[1], 0, "Frame not compressed");
+	zassert_true(frame_len * 3 < sizeof(raw) * 2, "Compression ratio too low");
+
+	TC_PRINT("Compressed %zu bytes into %zu, %u cycles\n", sizeof(raw), frame_len, cycles);
+
+	round_trip(sizeof(raw));
+}
+
+ZTEST(trace_compression, test_lengths)
+{
+	static const size_t lengths[] = { 0, 1, 2, 3, 4, 17, 18, 19, 255, 1000, BLOCK_SIZE - 1 };
+
+	for (size_t i = 0; i < ARRAY_SIZE(lengths); i++) {
+		trace_like_data_generate(raw, lengths[i]);
+		round_trip(lengths[i]);
+
+		sys_rand_get(raw, lengths[i]);
+		round_trip(lengths[i]);
+
+		memset(raw, 0xAA, lengths[i]);
+		round_trip(lengths[i]);
+	}
+}
+
+ZTEST(trace_compression, test_invalid_frames)
+{
+	size_t frame_len;
+	int ret;
+
+	trace_like_data_generate(raw, sizeof(raw));
+	frame_len = trace_compression_frame_encode(raw, sizeof(raw), frame);
+
+	ret = trace_compression_frame_decode(frame, frame_len - 1, decoded, sizeof(decoded));
+	zassert_equal(ret, -EBADMSG, "Truncated frame accepted");
+
+	ret = trace_compression_frame_decode(frame, frame_len, decoded, sizeof(raw) - 1);
+	zassert_equal(ret, -ENOMEM, "Too small output buffer accepted");
+
+	frame[0] ^= 0xFF;
+	ret = trace_compression_frame_len(frame);
+	zassert_equal(ret, -EBADMSG, "Invalid magic accepted");
+	frame[0] ^= 0xFF;
+
+	frame[1] = 0x80;
+	ret = trace_compression_frame_len(frame);
+	zassert_equal(ret, -EBADMSG, "Invalid flags accepted");
+	frame[1] = 0;
+
+	/* Back-reference before the start of the block. */
+	frame[TRACE_COMPRESSION_FRAME_HDR_SIZE] = 0x01;
+	ret = trace_compression_frame_decode(frame, frame_len, decoded, sizeof(decoded));
+	zassert_equal(ret, -EBADMSG, "Invalid back-reference accepted");
+}
+
+ZTEST_SUITE(trace_compression, NULL, NULL, NULL, NULL, NULL);
@@ -0,0 +1,320 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include "bridge_util.h"
+
+#include <zephyr/ztest.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+using namespace Nrf;
+
+namespace
+{
+/* Bridged devices present at the same time, spread over all device types. */
+constexpr size_t kMaxBridgedDevices = 8;
+constexpr size_t kDevicePoolSize = kMaxBridgedDevices;
+constexpr size_t kProviderPoolSize = kMaxBridgedDevices;
+constexpr size_t kIterations = 10000;
+constexpr size_t kNodeLabelSize = 32;
+
+/* Number of allocations from the heap that have not been freed yet. */
+size_t sHeapAllocations;
+size_t sLiveObjects;
+
+enum DeviceType : uint16_t {
+	OnOffLight = 0x0100,
+	OnOffLightSwitch = 0x0103,
+	TemperatureSensor = 0x0302,
+	HumiditySensor = 0x0307,
+	GenericSwitch = 0x000F
+};
+
+constexpr DeviceType kDeviceTypes[] = { OnOffLight, OnOffLightSwitch, TemperatureSensor, HumiditySensor,
+					GenericSwitch };
+
+class Device {
+public:
+	explicit Device(const char *nodeLabel)
+	{
+		strncpy(mNodeLabel, nodeLabel ? nodeLabel : "", sizeof(mNodeLabel) - 1);
+		sLiveObjects++;
+	}
+	virtual ~Device() { sLiveObjects--; }
+
+	virtual uint16_t GetDeviceType() const = 0;
+	const char *GetNodeLabel() const { return mNodeLabel; }
+
+private:
+	char mNodeLabel[kNodeLabelSize] = {};
+};
+
+template <DeviceType Type, size_t ExtraSize> class ConcreteDevice : public Device {
+public:
+	using Device::Device;
+	uint16_t GetDeviceType() const override { return Type; }
+
+private:
+	uint8_t mState[ExtraSize] = {};
+};
+
+class Provider {
+public:
+	explicit Provider(int context) : mContext(context) { sLiveObjects++; }
+	virtual ~Provider() { sLiveObjects--; }
+
+	int GetContext() const { return mContext; }
+
+private:
+	int mContext;
+};
+
+/* Puts the provider base class at a non-zero offset within the object. */
+class Connection {
+public:
+	virtual ~Connection() = default;
+
+private:
+	uint32_t mHandle = 0;
+};
+
+class ConnectedProvider : public Connection, public Provider {
+public:
+	using Provider::Provider;
+};
+
+using OnOffLightDevice = ConcreteDevice<OnOffLight, 8>;
+using OnOffLightSwitchDevice = ConcreteDevice<OnOffLightSwitch, 16>;
+using TemperatureSensorDevice = ConcreteDevice<TemperatureSensor, 4>;
+using HumiditySensorDevice = ConcreteDevice<HumiditySensor, 4>;
+using GenericSwitchDevice = ConcreteDevice<GenericSwitch, 12>;
+
+/* The pools are shared by all types, as in the bridge factories. */
+DevicePool<std::max({ sizeof(OnOffLightDevice), sizeof(OnOffLightSwitchDevice), sizeof(TemperatureSensorDevice),
+		      sizeof(HumiditySensorDevice), sizeof(GenericSwitchDevice) }),
+	   kDevicePoolSize>
+	sDevicePool;
+DevicePool<std::max(sizeof(Provider), sizeof(ConnectedProvider)), kProviderPoolSize> sProviderPool;
+
+template <typename T> Device *CreateDevice(const char *nodeLabel)
+{
+	if (nodeLabel && strlen(nodeLabel) >= kNodeLabelSize) {
+		return nullptr;
+	}
+
+	return sDevicePool.New<T>(nodeLabel);
+}
+
+template <typename T> Provider *CreateProvider(int context)
+{
+	return sProviderPool.New<T>(context);
+}
+
+using TestDeviceFactory = DeviceFactory<Device, uint16_t, const char *>;
+using TestProviderFactory = DeviceFactory<Provider, uint16_t, int>;
+
+const TestDeviceFactory sDeviceFactory{
+	{ OnOffLight, CreateDevice<OnOffLightDevice> },
+	{ OnOffLightSwitch, CreateDevice<OnOffLightSwitchDevice> },
+	{ TemperatureSensor, CreateDevice<TemperatureSensorDevice> },
+	{ HumiditySensor, CreateDevice<HumiditySensorDevice> },
+	{ GenericSwitch, CreateDevice<GenericSwitchDevice> },
+};
+
+const TestProviderFactory sProviderFactory{
+	{ OnOffLight, CreateProvider<Provider> },
+	{ OnOffLightSwitch, CreateProvider<ConnectedProvider> },
+	{ TemperatureSensor, CreateProvider<Provider> },
+	{ HumiditySensor, CreateProvider<ConnectedProvider> },
+	{ GenericSwitch, CreateProvider<Provider> },
+};
+
+struct BridgedDevice {
+	DeviceUniquePtr<Device> mDevice;
+	DeviceUniquePtr<Provider> mProvider;
+};
+
+/* Adds a bridged device the way the bridge factories do, the device and its provider or nothing. */
+bool AddBridgedDevice(BridgedDevice &slot, uint16_t deviceType, const char *nodeLabel, int context)
+{
+	DeviceUniquePtr<Provider> provider(sProviderFactory.Create(deviceType, context));
+
+	if (!provider) {
+		return false;
+	}
+
+	DeviceUniquePtr<Device> device(sDeviceFactory.Create(deviceType, nodeLabel));
+
+	if (!device) {
+		return false;
+	}
+
+	slot.mDevice = std::move(device);
+	slot.mProvider = std::move(provider);
+
+	return true;
+}
+
+void TestBefore(void *)
+{
+	sLiveObjects = 0;
+}
+} /* namespace */
+
+void *operator new(size_t size)
+{
+	void *memory = malloc(size);
+
+	if (!memory) {
+		abort();
+	}
+
+	sHeapAllocations++;
+
+	return memory;
+}
+
+void operator delete(void *memory) noexcept
+{
+	if (memory) {
+		sHeapAllocations--;
+		free(memory);
+	}
+}
+
+void operator delete(void *memory, size_t) noexcept
+{
+	operator delete(memory);
+}
+
+ZTEST_SUITE(matter_bridge_device_factory, NULL, NULL, TestBefore, NULL, NULL);
+
+ZTEST(matter_bridge_device_factory, test_create_all_types)
+{
+	for (DeviceType type : kDeviceTypes) {
+		DeviceUniquePtr<Device> device(sDeviceFactory.Create(type, "Bridged device"));
+		DeviceUniquePtr<Provider> provider(sProviderFactory.Create(type, type));
+
+		zassert_not_null(device.get(), "No device of type 0x%04x", type);
+		zassert_equal(device->GetDeviceType(), type);
+		zassert_equal(strcmp(device->GetNodeLabel(), "Bridged device"), 0);
+		zassert_not_null(provider.get(), "No provider of type 0x%04x", type);
+		zassert_equal(provider->GetContext(), type);
+	}
+
+	zassert_equal(sLiveObjects, 0, "Objects not destroyed");
+}
+
+ZTEST(matter_bridge_device_factory, test_create_unknown_type)
+{
+	/* The same slot in the table as OnOffLight. */
+	zassert_is_null(sDeviceFactory.Create(0x0110, "Unknown"));
+	zassert_is_null(sDeviceFactory.Create(0x0013, "Unknown"));
+	zassert_is_null(sProviderFactory.Create(0xFFFF, 0));
+}
+
+ZTEST(matter_bridge_device_factory, test_node_label_too_long)
+{
+	char nodeLabel[kNodeLabelSize + 1];
+
+	memset(nodeLabel, 'a', kNodeLabelSize);
+	nodeLabel[kNodeLabelSize] = '\0';
+
+	zassert_is_null(sDeviceFactory.Create(OnOffLight, nodeLabel));
+	zassert_equal(sLiveObjects, 0);
+}
+
+ZTEST(matter_bridge_device_factory, test_pool_exhaustion)
+{
+	Device *devices[kDevicePoolSize];
+
+	for (size_t i = 0; i < kDevicePoolSize; i++) {
+		devices[i] = sDeviceFactory.Create(kDeviceTypes[i % ARRAY_SIZE(kDeviceTypes)], "Device");
+		zassert_not_null(devices[i]);
+	}
+
+	/* All device types share the pool. */
+	zassert_is_null(sDeviceFactory.Create(OnOffLight, "Light"));
+	zassert_is_null(sDeviceFactory.Create(TemperatureSensor, "Sensor"));
+
+	/* A removed device returns its block to the pool, for a device of any type. */
+	Device *freed = devices[1];
+
+	DeleteDevice(devices[1]);
+	devices[1] = sDeviceFactory.Create(GenericSwitch, "Switch");
+	zassert_equal_ptr(devices[1], freed);
+
+	for (size_t i = 0; i < kDevicePoolSize; i++) {
+		DeleteDevice(devices[i]);
+	}
+
+	zassert_equal(sLiveObjects, 0);
+}
+
+ZTEST(matter_bridge_device_factory, test_delete_through_base)
+{
+	Provider *providers[kProviderPoolSize];
+
+	/* The provider base class is not at the beginning of the allocated block. */
+	for (size_t i = 0; i < kProviderPoolSize; i++) {
+		providers[i] = sProviderFactory.Create(HumiditySensor, i);
+		zassert_not_null(providers[i]);
+	}
+
+	zassert_is_null(sProviderFactory.Create(HumiditySensor, 0));
+
+	for (size_t i = 0; i < kProviderPoolSize; i++) {
+		DeleteDevice(providers[i]);
+	}
+
+	for (size_t i = 0; i < kProviderPoolSize; i++) {
+		providers[i] = sProviderFactory.Create(HumiditySensor, i);
+		zassert_not_null(providers[i], "Block %zu not returned to the pool", i);
+	}
+
+	for (size_t i = 0; i < kProviderPoolSize; i++) {
+		DeleteDevice(providers[i]);
+	}
+
+	zassert_equal(sLiveObjects, 0);
+}
+
+ZTEST(matter_bridge_device_factory, test_add_remove_no_heap)
+{
+	BridgedDevice bridgedDevices[kMaxBridgedDevices];
+	size_t heapAllocations = sHeapAllocations;
+	size_t added = 0;
+	uint32_t start = k_cycle_get_32();
+
+	for (size_t i = 0; i < kIterations; i++) {
+		/* Replace the oldest device with one of the next type. */
+		BridgedDevice &slot = bridgedDevices[i % kMaxBridgedDevices];
+		uint16_t type = kDeviceTypes[i % ARRAY_SIZE(kDeviceTypes)];
+
+		slot.mDevice.reset();
+		slot.mProvider.reset();
+
+		zassert_true(AddBridgedDevice(slot, type, "Bridged device", i), "Failed to add device %zu", i);
+		zassert_equal(slot.mDevice->GetDeviceType(), type);
+		added++;
+	}
+
+	uint32_t cycles = k_cycle_get_32() - start;
+
+	for (BridgedDevice &slot : bridgedDevices) {
+		slot.mDevice.reset();
+		slot.mProvider.reset();
+	}
+
+	TC_PRINT("%zu bridged devices added and removed, %u cycles per device\n", added, static_cast<uint32_t>(cycles / kIterations));
+
+	zassert_equal(sHeapAllocations, heapAllocations, "Heap grew by %zu allocations",
+		      sHeapAllocations - heapAllocations);
+	zassert_equal(sLiveObjects, 0, "Objects not destroyed");
+}
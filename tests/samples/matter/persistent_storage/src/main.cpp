@@ -0,0 +1,360 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include "persistent_storage/backends/persistent_storage_settings.h"
+#include "settings_mock.h"
+
+#include <new>
+#include <zephyr/logging/log.h>
+#include <zephyr/ztest.h>
+
+LOG_MODULE_REGISTER(app, CONFIG_CHIP_APP_LOG_LEVEL);
+
+using namespace Nrf;
+
+namespace
+{
+constexpr size_t kBridgedDevices = 32;
+/* Serialized endpoint id, device type, node label and Bluetooth LE address of a bridged device. */
+constexpr size_t kDeviceDataSize = 32;
+constexpr size_t kKeys = 8;
+
+class TestStorage : public PersistentStorageSettings {
+public:
+	using PersistentStorageSettings::_NonSecureCommit;
+	using PersistentStorageSettings::_NonSecureHasEntry;
+	using PersistentStorageSettings::_NonSecureInit;
+	using PersistentStorageSettings::_NonSecureLoad;
+	using PersistentStorageSettings::_NonSecureRemove;
+	using PersistentStorageSettings::_NonSecureStore;
+};
+
+alignas(TestStorage) uint8_t sStorageBuffer[sizeof(TestStorage)];
+TestStorage *sStorage;
+
+/* The same tree of keys as used by the bridge storage manager. */
+PersistentStorageNode sBridge("br", strlen("br"));
+PersistentStorageNode sVersion("ver", strlen("ver"), &sBridge);
+PersistentStorageNode sDevicesCount("brd_cnt", strlen("brd_cnt"), &sBridge);
+PersistentStorageNode sDevicesIndexes("brd_ids", strlen("brd_ids"), &sBridge);
+PersistentStorageNode sDevice("brd", strlen("brd"), &sBridge);
+
+PersistentStorageNode IndexNode(size_t index, PersistentStorageNode *parent)
+{
+	char name[4];
+
+	snprintf(name, sizeof(name), "%u", static_cast<unsigned int>(index));
+
+	return PersistentStorageNode(name, strlen(name), parent);
+}
+
+/* Simulates a reboot, the new instance knows only what is in the settings. */
+void PowerCycle()
+{
+	if (sStorage) {
+		sStorage->~TestStorage();
+	}
+
+	sStorage = new (sStorageBuffer) TestStorage();
+	zassert_equal(sStorage->_NonSecureInit(), PSErrorCode::Success, "Failed to initialize storage");
+}
+
+void StoreValue(PersistentStorageNode &node, uint8_t value)
+{
+	zassert_equal(sStorage->_NonSecureStore(&node, &value, sizeof(value)), PSErrorCode::Success,
+		      "Failed to store value");
+}
+
+void CheckValue(PersistentStorageNode &node, uint8_t expected)
+{
+	uint8_t value = 0;
+	size_t size = 0;
+
+	zassert_equal(sStorage->_NonSecureLoad(&node, &value, sizeof(value), size), PSErrorCode::Success,
+		      "Failed to load value");
+	zassert_equal(size, sizeof(value), "Invalid size");
+	zassert_equal(value, expected, "Invalid value %u, expected %u", value, expected);
+}
+
+void CheckAbsent(PersistentStorageNode &node)
+{
+	uint8_t value;
+	size_t size;
+
+	zassert_equal(sStorage->_NonSecureHasEntry(&node), PSErrorCode::Failure, "Unexpected entry");
+	zassert_equal(sStorage->_NonSecureLoad(&node, &value, sizeof(value), size), PSErrorCode::Failure,
+		      "Unexpected value");
+}
+
+/* Adds a bridged device as the bridge application does: checks if it is already stored, stores it, and
+ * updates the list of devices if it was not.
+ */
+void AddBridgedDevice(uint8_t index, uint8_t (&indexes)[kBridgedDevices], uint8_t &count)
+{
+	PersistentStorageNode node = IndexNode(index, &sDevice);
+	uint8_t data[kDeviceDataSize];
+	size_t size;
+	const bool refresh = sStorage->_NonSecureLoad(&node, data, sizeof(data), size) == PSErrorCode::Success;
+
+	memset(data, index, sizeof(data));
+	zassert_equal(sStorage->_NonSecureStore(&node, data, sizeof(data)), PSErrorCode::Success,
+		      "Failed to store device");
+
+	if (!refresh) {
+		indexes[count++] = index;
+
+		zassert_equal(sStorage->_NonSecureStore(&sDevicesIndexes, indexes, count), PSErrorCode::Success,
+			      "Failed to store indexes");
+		zassert_equal(sStorage->_NonSecureStore(&sDevicesCount, &count, sizeof(count)), PSErrorCode::Success,
+			      "Failed to store count");
+	}
+}
+
+void PrintStats(const char *operation)
+{
+	const settings_mock_stats *stats = settings_mock_stats_get();
+
+	TC_PRINT("%s: %zu loads, %zu saves\n", operation, stats->loads, stats->saves);
+}
+
+void TestBefore(void *fixture)
+{
+	settings_mock_clear();
+	PowerCycle();
+}
+
+} /* namespace */
+
+ZTEST_SUITE(persistent_storage_settings, NULL, NULL, TestBefore, NULL, NULL);
+
+ZTEST(persistent_storage_settings, test_store_load_remove)
+{
+	uint8_t buffer[kDeviceDataSize] = { 0 };
+	size_t size;
+
+	CheckAbsent(sVersion);
+	zassert_equal(sStorage->_NonSecureRemove(&sVersion), PSErrorCode::Failure, "Removed absent entry");
+
+	StoreValue(sVersion, 1);
+	zassert_equal(sStorage->_NonSecureHasEntry(&sVersion), PSErrorCode::Success, "Entry not found");
+	CheckValue(sVersion, 1);
+
+	/* The value does not fit in the destination buffer. */
+	zassert_equal(sStorage->_NonSecureStore(&sDevice, buffer, sizeof(buffer)), PSErrorCode::Success,
+		      "Failed to store value");
+	zassert_equal(sStorage->_NonSecureLoad(&sDevice, buffer, 1, size), PSErrorCode::Failure,
+		      "Loaded value larger than buffer");
+
+	zassert_equal(sStorage->_NonSecureRemove(&sVersion), PSErrorCode::Success, "Failed to remove");
+	CheckAbsent(sVersion);
+
+	zassert_equal(sStorage->_NonSecureCommit(), PSErrorCode::Success, "Failed to commit");
+	PowerCycle();
+
+	CheckAbsent(sVersion);
+	zassert_equal(sStorage->_NonSecureHasEntry(&sDevice), PSErrorCode::Success, "Entry not found");
+}
+
+ZTEST(persistent_storage_settings, test_existence_checks_from_ram)
+{
+	StoreValue(sVersion, 1);
+	zassert_equal(sStorage->_NonSecureCommit(), PSErrorCode::Success, "Failed to commit");
+	PowerCycle();
+	settings_mock_stats_reset();
+
+	zassert_equal(sStorage->_NonSecureHasEntry(&sVersion), PSErrorCode::Success, "Entry not found");
+	zassert_equal(sStorage->_NonSecureHasEntry(&sDevicesCount), PSErrorCode::Failure, "Unexpected entry");
+	zassert_equal(sStorage->_NonSecureRemove(&sDevicesCount), PSErrorCode::Failure, "Removed absent entry");
+
+	if (IS_ENABLED(CONFIG_NCS_SAMPLE_MATTER_SETTINGS_STORAGE_CACHE)) {
+		zassert_equal(settings_mock_stats_get()->loads, 0, "Settings walked for existence checks");
+	}
+}
+
+ZTEST(persistent_storage_settings, test_keys_out_of_subtree)
+{
+	PersistentStorageNode other("crd", strlen("crd"));
+
+	StoreValue(other, 1);
+
+	/* Keys out of the cached subtree are written to the settings directly. */
+	zassert_true(settings_mock_has("crd"), "Value not written");
+	CheckValue(other, 1);
+
+	PowerCycle();
+	CheckValue(other, 1);
+	CheckAbsent(sVersion);
+
+	zassert_equal(sStorage->_NonSecureRemove(&other), PSErrorCode::Success, "Failed to remove");
+	zassert_false(settings_mock_has("crd"), "Value not removed");
+	CheckAbsent(other);
+}
+
+ZTEST(persistent_storage_settings, test_stores_coalesced)
+{
+	settings_mock_stats_reset();
+
+	for (uint8_t i = 0; i < 10; i++) {
+		StoreValue(sDevicesCount, i);
+		CheckValue(sDevicesCount, i);
+	}
+
+	zassert_equal(sStorage->_NonSecureCommit(), PSErrorCode::Success, "Failed to commit");
+
+	if (IS_ENABLED(CONFIG_NCS_SAMPLE_MATTER_SETTINGS_STORAGE_CACHE)) {
+		zassert_equal(settings_mock_stats_get()->saves, 1, "Stores not coalesced");
+	}
+
+	PowerCycle();
+	CheckValue(sDevicesCount, 9);
+}
+
+ZTEST(persistent_storage_settings, test_power_loss_before_commit)
+{
+	StoreValue(sVersion, 1);
+	StoreValue(sDevicesCount, 1);
+	zassert_equal(sStorage->_NonSecureCommit(), PSErrorCode::Success, "Failed to commit");
+
+	StoreValue(sVersion, 2);
+	StoreValue(sDevicesIndexes, 2);
+	zassert_equal(sStorage->_NonSecureRemove(&sDevicesCount), PSErrorCode::Success, "Failed to remove");
+
+	PowerCycle();
+
+	if (IS_ENABLED(CONFIG_NCS_SAMPLE_MATTER_SETTINGS_STORAGE_CACHE)) {
+		/* Only the committed changes survive. */
+		CheckValue(sVersion, 1);
+		CheckValue(sDevicesCount, 1);
+		CheckAbsent(sDevicesIndexes);
+	} else {
+		CheckValue(sVersion, 2);
+		CheckValue(sDevicesIndexes, 2);
+		CheckAbsent(sDevicesCount);
+	}
+}
+
+ZTEST(persistent_storage_settings, test_power_loss_during_flush)
+{
+	constexpr size_t kWritten = 3;
+
+	if (!IS_ENABLED(CONFIG_NCS_SAMPLE_MATTER_SETTINGS_STORAGE_CACHE)) {
+		ztest_test_skip();
+	}
+
+	for (size_t i = 0; i < kKeys; i++) {
+		PersistentStorageNode node = IndexNode(i, &sDevice);
+
+		StoreValue(node, 1);
+	}
+
+	zassert_equal(sStorage->_NonSecureCommit(), PSErrorCode::Success, "Failed to commit");
+
+	/* Change the keys in reverse order, so that the order of writes is not the order of the keys. */
+	for (size_t i = kKeys; i-- > 0;) {
+		PersistentStorageNode node = IndexNode(i, &sDevice);
+
+		StoreValue(node, 2);
+	}
+
+	settings_mock_fail_save_after(kWritten);
+	zassert_equal(sStorage->_NonSecureCommit(), PSErrorCode::Failure, "Commit did not fail");
+
+	PowerCycle();
+
+	/* The keys are written in the order of their changes, each key either fully updated or not at all. */
+	for (size_t i = 0; i < kKeys; i++) {
+		PersistentStorageNode node = IndexNode(i, &sDevice);
+
+		CheckValue(node, i >= kKeys - kWritten ? 2 : 1);
+	}
+}
+
+ZTEST(persistent_storage_settings, test_commit_retried_after_failure)
+{
+	if (!IS_ENABLED(CONFIG_NCS_SAMPLE_MATTER_SETTINGS_STORAGE_CACHE)) {
+		ztest_test_skip();
+	}
+
+	for (size_t i = 0; i < kKeys; i++) {
+		PersistentStorageNode node = IndexNode(i, &sDevice);
+
+		StoreValue(node, i);
+	}
+
+	settings_mock_fail_save_after(1);
+	zassert_equal(sStorage->_NonSecureCommit(), PSErrorCode::Failure, "Commit did not fail");
+
+	/* The failed entries are still served from RAM and written on the next commit. */
+	for (size_t i = 0; i < kKeys; i++) {
+		PersistentStorageNode node = IndexNode(i, &sDevice);
+
+		CheckValue(node, i);
+	}
+
+	zassert_equal(sStorage->_NonSecureCommit(), PSErrorCode::Success, "Failed to commit");
+	PowerCycle();
+
+	for (size_t i = 0; i < kKeys; i++) {
+		PersistentStorageNode node = IndexNode(i, &sDevice);
+
+		CheckValue(node, i);
+	}
+}
+
+#if defined(CONFIG_NCS_SAMPLE_MATTER_SETTINGS_STORAGE_CACHE) &&                                                \
+	CONFIG_NCS_SAMPLE_MATTER_SETTINGS_STORAGE_CACHE_FLUSH_DELAY_MS > 0
+ZTEST(persistent_storage_settings, test_flush_after_delay)
+{
+	StoreValue(sVersion, 1);
+	zassert_false(settings_mock_has("br/ver"), "Value written before the delay");
+
+	k_sleep(K_MSEC(CONFIG_NCS_SAMPLE_MATTER_SETTINGS_STORAGE_CACHE_FLUSH_DELAY_MS * 2));
+	zassert_true(settings_mock_has("br/ver"), "Value not written after the delay");
+}
+#endif
+
+ZTEST(persistent_storage_settings, test_bridge_restore_benchmark)
+{
+	uint8_t indexes[kBridgedDevices];
+	uint8_t count = 0;
+	uint8_t data[kDeviceDataSize];
+	size_t size;
+
+	/* Add the devices for the first time. */
+	settings_mock_stats_reset();
+	StoreValue(sVersion, 1);
+
+	for (uint8_t i = 0; i < kBridgedDevices; i++) {
+		AddBridgedDevice(i, indexes, count);
+	}
+
+	zassert_equal(sStorage->_NonSecureCommit(), PSErrorCode::Success, "Failed to commit");
+	PrintStats("Add 32 bridged devices");
+
+	/* Reboot and restore the devices, which stores them again. */
+	settings_mock_stats_reset();
+	PowerCycle();
+
+	CheckValue(sVersion, 1);
+	CheckValue(sDevicesCount, kBridgedDevices);
+	zassert_equal(sStorage->_NonSecureLoad(&sDevicesIndexes, indexes, sizeof(indexes), size),
+		      PSErrorCode::Success, "Failed to load indexes");
+	zassert_equal(size, kBridgedDevices, "Invalid number of indexes");
+
+	for (size_t i = 0; i < kBridgedDevices; i++) {
+		PersistentStorageNode node = IndexNode(indexes[i], &sDevice);
+
+		zassert_equal(sStorage->_NonSecureLoad(&node, data, sizeof(data), size), PSErrorCode::Success,
+			      "Failed to load device");
+		zassert_equal(data[0], indexes[i], "Invalid device data");
+
+		AddBridgedDevice(indexes[i], indexes, count);
+	}
+
+	zassert_equal(sStorage->_NonSecureCommit(), PSErrorCode::Success, "Failed to commit");
+	zassert_equal(count, kBridgedDevices, "Devices added twice");
+	PrintStats("Restore 32 bridged devices");
+}
@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/init.h>
+#include <zephyr/ztest.h>
+#include <zephyr/settings/settings.h>
+
+#include "settings_mock.h"
+
+struct settings_data {
+	sys_snode_t node;
+	char *name;
+	char *val;
+	size_t val_len;
+};
+
+static sys_slist_t settings_list;
+static struct settings_mock_stats stats;
+/* Number of writes that succeed before the failing one, negative if none fails. */
+static int fail_countdown = -1;
+
+void settings_mock_clear(void)
+{
+	while (!sys_slist_is_empty(&settings_list)) {
+		sys_snode_t *cur_node = sys_slist_get(&settings_list);
+		struct settings_data *data = CONTAINER_OF(cur_node, struct settings_data, node);
+
+		k_free(data->val);
+		k_free(data->name);
+		k_free(data);
+	}
+
+	fail_countdown = -1;
+	settings_mock_stats_reset();
+}
+
+void settings_mock_stats_reset(void)
+{
+	memset(&stats, 0, sizeof(stats));
+}
+
+const struct settings_mock_stats *settings_mock_stats_get(void)
+{
+	return &stats;
+}
+
+void settings_mock_fail_save_after(size_t count)
+{
+	fail_countdown = count;
+}
+
+static struct settings_data *settings_mock_find(const char *name)
+{
+	struct settings_data *data;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&settings_list, data, node) {
+		if (!strcmp(data->name, name)) {
+			return data;
+		}
+	}
+
+	return NULL;
+}
+
+bool settings_mock_has(const char *name)
+{
+	return settings_mock_find(name) != NULL;
+}
+
+static ssize_t settings_mock_read_fn(void *back_end, void *data, size_t len)
+{
+	struct settings_data *settings_data = back_end;
+
+	len = MIN(len, settings_data->val_len);
+	memcpy(data, settings_data->val, len);
+
+	return len;
+}
+
+static int settings_mock_load(struct settings_store *cs, const struct settings_load_arg *arg)
+{
+	struct settings_data *data;
+	int err = 0;
+
+	stats.loads++;
+
+	/* Entries out of the requested subtree are filtered out by the settings subsystem. */
+	SYS_SLIST_FOR_EACH_CONTAINER(&settings_list, data, node) {
+		err = settings_call_set_handler(data->name, data->val_len, settings_mock_read_fn, data,
+						arg);
+		if (err) {
+			break;
+		}
+	}
+
+	return err;
+}
+
+static int settings_mock_save(struct settings_store *cs, const char *name, const char *value,
+			      size_t val_len)
+{
+	struct settings_data *record = settings_mock_find(name);
+
+	stats.saves++;
+
+	if (fail_countdown == 0) {
+		fail_countdown = -1;
+		return -EIO;
+	} else if (fail_countdown > 0) {
+		fail_countdown--;
+	}
+
+	if (record && val_len == 0) {
+		sys_slist_find_and_remove(&settings_list, &record->node);
+		k_free(record->val);
+		k_free(record->name);
+		k_free(record);
+
+		return 0;
+	}
+
+	if (val_len == 0) {
+		return 0;
+	}
+
+	if (!record) {
+		record = k_malloc(sizeof(*record));
+		zassert_not_null(record, "Heap too small. Increase heap size.");
+
+		record->name = k_malloc(strlen(name) + 1);
+		zassert_not_null(record->name, "Heap too small. Increase heap size.");
+		strcpy(record->name, name);
+
+		record->val = NULL;
+		record->val_len = 0;
+
+		sys_slist_append(&settings_list, &record->node);
+	}
+
+	if (val_len != record->val_len) {
+		k_free(record->val);
+
+		record->val = k_malloc(val_len);
+		zassert_not_null(record->val, "Heap too small. Increase heap size.");
+		record->val_len = val_len;
+	}
+
+	memcpy(record->val, value, val_len);
+
+	return 0;
+}
+
+static struct settings_store_itf settings_mock_itf = {
+	.csi_load = settings_mock_load,
+	.csi_save = settings_mock_save,
+};
+
+static struct settings_store settings_mock_store = {
+	.cs_itf = &settings_mock_itf
+};
+
+static int settings_mock_init(void)
+{
+	sys_slist_init(&settings_list);
+
+	settings_dst_register(&settings_mock_store);
+	settings_src_register(&settings_mock_store);
+
+	return 0;
+}
+
+SYS_INIT(settings_mock_init, POST_KERNEL, CONFIG_KERNEL_INIT_PRIORITY_DEVICE);
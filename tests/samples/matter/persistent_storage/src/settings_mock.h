@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _SETTINGS_MOCK_H_
+#define _SETTINGS_MOCK_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Number of calls to the settings backend. */
+struct settings_mock_stats {
+	/** Loads, each of which walks the whole storage. */
+	size_t loads;
+	/** Writes and deletes of single entries. */
+	size_t saves;
+};
+
+/** Remove all data from the mocked storage and reset the statistics. */
+void settings_mock_clear(void);
+
+/** Reset the statistics. */
+void settings_mock_stats_reset(void);
+
+/** Get the statistics. */
+const struct settings_mock_stats *settings_mock_stats_get(void);
+
+/** Make the write that follows @p count successful writes fail, as on a power loss. */
+void settings_mock_fail_save_after(size_t count);
+
+/** Check if the mocked storage holds an entry. */
+bool settings_mock_has(const char *name);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _SETTINGS_MOCK_H_ */
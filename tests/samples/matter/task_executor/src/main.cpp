@@ -0,0 +1,272 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include "app/task_executor.h"
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/ztest.h>
+
+#include <cstring>
+
+LOG_MODULE_REGISTER(app, CONFIG_CHIP_APP_LOG_LEVEL);
+
+using namespace Nrf;
+
+namespace
+{
+constexpr size_t kHighQueueSize = CONFIG_NCS_SAMPLE_MATTER_APP_TASK_QUEUE_HIGH_SIZE;
+constexpr size_t kNormalQueueSize = CONFIG_NCS_SAMPLE_MATTER_APP_TASK_QUEUE_SIZE;
+constexpr size_t kLowQueueSize = CONFIG_NCS_SAMPLE_MATTER_APP_TASK_QUEUE_LOW_SIZE;
+constexpr size_t kMaxExecuted = kHighQueueSize + kNormalQueueSize + kLowQueueSize;
+
+constexpr size_t kBenchmarkRounds = 20;
+/* Time spent in a low priority task, as when reporting a bulk of measurements. */
+constexpr uint32_t kLowTaskWorkUs = 500;
+constexpr size_t kDispatcherStackSize = 2048;
+constexpr int kDispatcherPriority = 5;
+
+/* Values passed by the executed tasks, in the order of execution. */
+int sExecuted[kMaxExecuted];
+size_t sExecutedCount;
+
+void Execute(int value)
+{
+	if (sExecutedCount < kMaxExecuted) {
+		sExecuted[sExecutedCount] = value;
+	}
+
+	sExecutedCount++;
+}
+
+bool Post(TaskPriority priority, int value, TaskCoalescingKey coalescingKey = kNoCoalescing)
+{
+	return PostTask([value] { Execute(value); }, priority, coalescingKey);
+}
+
+void DispatchAll(size_t count)
+{
+	for (size_t i = 0; i < count; i++) {
+		DispatchNextTask();
+	}
+}
+
+void CheckExecuted(const int *expected, size_t count)
+{
+	zassert_equal(sExecutedCount, count, "Executed %zu tasks instead of %zu", sExecutedCount, count);
+
+	for (size_t i = 0; i < count; i++) {
+		zassert_equal(sExecuted[i], expected[i], "Unexpected task %d at position %zu", sExecuted[i], i);
+	}
+}
+
+struct LatencyStats {
+	uint64_t total;
+	uint32_t max;
+	uint32_t count;
+};
+
+LatencyStats sLatency[kTaskPriorityCount];
+
+void RecordLatency(TaskPriority priority, uint32_t postedAt)
+{
+	LatencyStats &stats = sLatency[static_cast<size_t>(priority)];
+	uint32_t latency = k_cycle_get_32() - postedAt;
+
+	stats.total += latency;
+	stats.max = MAX(stats.max, latency);
+	stats.count++;
+}
+
+bool PostMeasured(TaskPriority priority)
+{
+	uint32_t postedAt = k_cycle_get_32();
+
+	return PostTask(
+		[priority, postedAt] {
+			RecordLatency(priority, postedAt);
+
+			if (priority == TaskPriority::Low) {
+				k_busy_wait(kLowTaskWorkUs);
+			}
+		},
+		priority);
+}
+
+K_THREAD_STACK_DEFINE(sDispatcherStack, kDispatcherStackSize);
+k_thread sDispatcherThread;
+
+void Dispatcher(void *, void *, void *)
+{
+	while (true) {
+		DispatchNextTask();
+	}
+}
+
+void TestBefore(void *)
+{
+	sExecutedCount = 0;
+	ResetTaskQueueStats();
+}
+} /* namespace */
+
+ZTEST_SUITE(matter_task_executor, NULL, NULL, TestBefore, NULL, NULL);
+
+ZTEST(matter_task_executor, test_priority_order)
+{
+	const int expected[] = { 1, 2, 3, 4, 5, 6 };
+
+	zassert_true(Post(TaskPriority::Low, 5));
+	zassert_true(Post(TaskPriority::Normal, 3));
+	zassert_true(Post(TaskPriority::High, 1));
+	zassert_true(Post(TaskPriority::Low, 6));
+	zassert_true(Post(TaskPriority::Normal, 4));
+	zassert_true(Post(TaskPriority::High, 2));
+
+	DispatchAll(ARRAY_SIZE(expected));
+	CheckExecuted(expected, ARRAY_SIZE(expected));
+}
+
+ZTEST(matter_task_executor, test_default_priority)
+{
+	const int expected[] = { 1, 2, 3 };
+
+	zassert_true(Post(TaskPriority::Low, 3));
+	PostTask([] { Execute(2); });
+	zassert_true(Post(TaskPriority::High, 1));
+
+	DispatchAll(ARRAY_SIZE(expected));
+	CheckExecuted(expected, ARRAY_SIZE(expected));
+	zassert_equal(GetTaskQueueStats(TaskPriority::Normal).posted, 1);
+}
+
+ZTEST(matter_task_executor, test_coalescing)
+{
+	/* The latest task replaces the queued one, but keeps its position in the queue. */
+	const int expected[] = { 3, 10 };
+	const TaskCoalescingKey key = 1;
+
+	zassert_true(Post(TaskPriority::Low, 1, key));
+	zassert_true(Post(TaskPriority::Low, 10));
+	zassert_true(Post(TaskPriority::Low, 2, key));
+	zassert_true(Post(TaskPriority::Low, 3, key));
+
+	DispatchAll(ARRAY_SIZE(expected));
+	CheckExecuted(expected, ARRAY_SIZE(expected));
+
+	TaskQueueStats stats = GetTaskQueueStats(TaskPriority::Low);
+
+	zassert_equal(stats.posted, 4);
+	zassert_equal(stats.coalesced, 2);
+	zassert_equal(stats.dropped, 0);
+	zassert_equal(stats.highWaterMark, 2);
+
+	/* Once executed, a task with the same key is queued again. */
+	zassert_true(Post(TaskPriority::Low, 4, key));
+	DispatchAll(1);
+	zassert_equal(sExecuted[2], 4);
+}
+
+ZTEST(matter_task_executor, test_coalescing_per_priority)
+{
+	const int expected[] = { 2, 1 };
+	const TaskCoalescingKey key = 1;
+
+	zassert_true(Post(TaskPriority::Low, 1, key));
+	zassert_true(Post(TaskPriority::High, 2, key));
+
+	DispatchAll(ARRAY_SIZE(expected));
+	CheckExecuted(expected, ARRAY_SIZE(expected));
+	zassert_equal(GetTaskQueueStats(TaskPriority::Low).coalesced, 0);
+	zassert_equal(GetTaskQueueStats(TaskPriority::High).coalesced, 0);
+}
+
+ZTEST(matter_task_executor, test_full_queue)
+{
+	const TaskCoalescingKey key = 1;
+
+	zassert_true(Post(TaskPriority::Low, 0, key));
+
+	for (size_t i = 1; i < kLowQueueSize; i++) {
+		zassert_true(Post(TaskPriority::Low, i));
+	}
+
+	/* A full low priority queue affects neither the other priorities nor coalescing. */
+	zassert_false(Post(TaskPriority::Low, kLowQueueSize));
+	zassert_true(Post(TaskPriority::Low, -3, key));
+	zassert_true(Post(TaskPriority::Normal, -1));
+	zassert_true(Post(TaskPriority::High, -2));
+
+	TaskQueueStats stats = GetTaskQueueStats(TaskPriority::Low);
+
+	zassert_equal(stats.posted, kLowQueueSize + 2);
+	zassert_equal(stats.coalesced, 1);
+	zassert_equal(stats.dropped, 1);
+	zassert_equal(stats.highWaterMark, kLowQueueSize);
+
+	DispatchAll(kLowQueueSize + 2);
+
+	zassert_equal(sExecuted[0], -2);
+	zassert_equal(sExecuted[1], -1);
+	zassert_equal(sExecuted[2], -3);
+
+	for (size_t i = 1; i < kLowQueueSize; i++) {
+		zassert_equal(sExecuted[i + 2], static_cast<int>(i));
+	}
+}
+
+ZTEST(matter_task_executor, test_reset_stats)
+{
+	zassert_true(Post(TaskPriority::Normal, 1));
+	zassert_true(Post(TaskPriority::Normal, 2));
+
+	ResetTaskQueueStats();
+
+	TaskQueueStats stats = GetTaskQueueStats(TaskPriority::Normal);
+
+	zassert_equal(stats.posted, 0);
+	/* The tasks still in the queue count in the high-water mark. */
+	zassert_equal(stats.highWaterMark, 2);
+
+	DispatchAll(2);
+}
+
+ZTEST(matter_task_executor, test_dispatch_latency_benchmark)
+{
+	memset(sLatency, 0, sizeof(sLatency));
+
+	k_thread_create(&sDispatcherThread, sDispatcherStack, K_THREAD_STACK_SIZEOF(sDispatcherStack), Dispatcher,
+			NULL, NULL, NULL, kDispatcherPriority, 0, K_NO_WAIT);
+
+	for (size_t round = 0; round < kBenchmarkRounds; round++) {
+		/* Flood the low priority queue, then post an urgent task behind it. */
+		for (size_t i = 0; i < kLowQueueSize; i++) {
+			PostMeasured(TaskPriority::Low);
+		}
+
+		zassert_true(PostMeasured(TaskPriority::Normal));
+		zassert_true(PostMeasured(TaskPriority::High));
+
+		k_sleep(K_USEC(kLowTaskWorkUs * (kLowQueueSize + 2)));
+	}
+
+	k_thread_abort(&sDispatcherThread);
+
+	static const char *const kNames[] = { "high", "normal", "low" };
+
+	for (size_t i = 0; i < kTaskPriorityCount; i++) {
+		const LatencyStats &stats = sLatency[i];
+
+		zassert_true(stats.count > 0, "No %s priority tasks executed", kNames[i]);
+		TC_PRINT("%6s: %u tasks, latency avg %u us, max %u us\n", kNames[i], stats.count,
+			 static_cast<uint32_t>(k_cyc_to_us_floor64(stats.total / stats.count)),
+			 k_cyc_to_us_floor32(stats.max));
+	}
+
+	/* The urgent tasks wait for one low priority task at most. */
+	zassert_true(sLatency[0].max < k_us_to_cyc_ceil32(2 * kLowTaskWorkUs), "High priority task delayed");
+	zassert_true(sLatency[0].total / sLatency[0].count < sLatency[2].total / sLatency[2].count);
+}
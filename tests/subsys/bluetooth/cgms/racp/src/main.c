@@ -0,0 +1,732 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/ztest.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/sys/byteorder.h>
+
+#include "cgms_internal.h"
+#include "test_host_time.h"
+
+LOG_MODULE_REGISTER(cgms, CONFIG_BT_CGMS_LOG_LEVEL);
+
+#define RACP_LENGTH			20
+#define RACP_TIMEOUT			K_SECONDS(30)
+#define NOTIFY_MAX_PENDING		CONFIG_BT_CGMS_RACP_NOTIFY_MAX_PENDING
+#define HISTORY_RECORD_CNT		(CONFIG_TEST_CGMS_HISTORY_DAYS * 24 * 60)
+
+/* Number of records appended to make the storage drop the oldest ones. */
+#define WRAP_RECORD_CNT			25000
+
+#define OPCODE_REPORT_RECS		0x01
+#define OPCODE_ABORT_OPERATION		0x03
+#define OPCODE_REPORT_NUM_RECS		0x04
+#define OPCODE_NUM_RECS_RESPONSE	0x05
+#define OPCODE_RESPONSE_CODE		0x06
+
+#define OPERATOR_NULL			0x00
+#define OPERATOR_ALL			0x01
+#define OPERATOR_LESS_OR_EQUAL		0x02
+#define OPERATOR_GREATER_OR_EQUAL	0x03
+#define OPERATOR_RANGE			0x04
+#define OPERATOR_FIRST			0x05
+#define OPERATOR_LAST			0x06
+
+#define FILTER_TIME_OFFSET		0x01
+#define FILTER_FACING_TIME		0x02
+
+#define RESPONSE_SUCCESS		0x01
+#define RESPONSE_OPCODE_UNSUPPORTED	0x02
+#define RESPONSE_INVALID_OPERATOR	0x03
+#define RESPONSE_OPERATOR_UNSUPPORTED	0x04
+#define RESPONSE_INVALID_OPERAND	0x05
+#define RESPONSE_NO_RECORDS_FOUND	0x06
+#define RESPONSE_OPERAND_UNSUPPORTED	0x09
+
+/* Layout of the flash storage, used to simulate a power loss. */
+#define FLASH_SLOT_SIZE			12
+#define FLASH_SECTOR_SIZE		4096
+
+struct racp_rsp {
+	uint8_t len;
+	uint8_t data[RACP_LENGTH];
+};
+
+/* Time offsets of the records added by the tests. */
+static const uint16_t time_offsets[] = {5, 10, 15, 15, 20, 25, 30, 35, 40, 45};
+
+K_MSGQ_DEFINE(rsp_msgq, sizeof(struct racp_rsp), 4, 4);
+
+static struct cgms_meas reported[ARRAY_SIZE(time_offsets)];
+static uint32_t reported_cnt;
+
+/* Notifications are completed by the test when deferred. */
+static bool notify_deferred;
+static bt_gatt_complete_func_t notify_done;
+static uint32_t notify_pending;
+static uint32_t notify_pending_max;
+
+/* Number of reported records after which the client aborts the procedure. */
+static uint32_t abort_after;
+
+int cgms_racp_send_response(struct bt_conn *peer, struct net_buf_simple *rsp)
+{
+	struct racp_rsp msg = {
+		.len = rsp->len,
+	};
+
+	zassert_true(rsp->len <= sizeof(msg.data), "Response too long");
+	memcpy(msg.data, rsp->data, rsp->len);
+
+	return k_msgq_put(&rsp_msgq, &msg, K_NO_WAIT);
+}
+
+int cgms_racp_send_record(struct bt_conn *peer, struct cgms_meas *entry,
+			  bt_gatt_complete_func_t done)
+{
+	static const uint8_t abort_req[] = {OPCODE_ABORT_OPERATION, OPERATOR_NULL};
+
+	if (reported_cnt < ARRAY_SIZE(reported)) {
+		reported[reported_cnt] = *entry;
+	}
+	reported_cnt++;
+
+	if (notify_deferred) {
+		notify_done = done;
+		notify_pending++;
+		notify_pending_max = MAX(notify_pending, notify_pending_max);
+	} else {
+		done(NULL, NULL);
+	}
+
+	if (reported_cnt == abort_after) {
+		zassert_ok(cgms_racp_recv_request(NULL, abort_req, sizeof(abort_req)));
+	}
+
+	return 0;
+}
+
+static void meas_add(uint16_t time_offset)
+{
+	struct cgms_meas meas = {
+		.glucose_concentration = time_offset * 3,
+		.time_offset = time_offset,
+	};
+
+	zassert_ok(cgms_racp_meas_add(meas));
+}
+
+static void records_add(void)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(time_offsets); i++) {
+		meas_add(time_offsets[i]);
+	}
+}
+
+static void request_send(const uint8_t *req, size_t len)
+{
+	int rc = cgms_racp_recv_request(NULL, req, len);
+
+	zassert_true(rc >= 0, "Request rejected: %d", rc);
+}
+
+static void response_wait(struct racp_rsp *rsp)
+{
+	zassert_ok(k_msgq_get(&rsp_msgq, rsp, RACP_TIMEOUT), "No RACP response");
+}
+
+static void response_check(uint8_t opcode, uint8_t rsp_code)
+{
+	struct racp_rsp rsp;
+	const uint8_t expected[] = {OPCODE_RESPONSE_CODE, OPERATOR_NULL, opcode, rsp_code};
+
+	response_wait(&rsp);
+	zassert_equal(rsp.len, sizeof(expected));
+	zassert_mem_equal(rsp.data, expected, sizeof(expected),
+			  "Unexpected response, code: %u", rsp.data[3]);
+}
+
+static void num_response_check(uint16_t count)
+{
+	struct racp_rsp rsp;
+	const uint8_t expected[] = {OPCODE_NUM_RECS_RESPONSE, OPERATOR_NULL,
+				    count & 0xFF, count >> 8};
+
+	response_wait(&rsp);
+	zassert_equal(rsp.len, sizeof(expected));
+	zassert_mem_equal(rsp.data, expected, sizeof(expected),
+			  "Unexpected number of records: %u", sys_get_le16(&rsp.data[2]));
+}
+
+/* Checks that the records with the given time offsets were reported in order. */
+static void reported_check(uint16_t min, uint16_t max)
+{
+	uint32_t cnt = 0;
+
+	for (size_t i = 0; i < ARRAY_SIZE(time_offsets); i++) {
+		if ((time_offsets[i] < min) || (time_offsets[i] > max)) {
+			continue;
+		}
+
+		zassert_true(cnt < reported_cnt, "Record not reported");
+		zassert_equal(reported[cnt].time_offset, time_offsets[i]);
+		zassert_equal(reported[cnt].glucose_concentration, time_offsets[i] * 3);
+		cnt++;
+	}
+
+	zassert_equal(cnt, reported_cnt, "Unexpected number of reported records");
+}
+
+static void report_check(const uint8_t *req, size_t len, uint16_t min, uint16_t max)
+{
+	reported_cnt = 0;
+	request_send(req, len);
+	response_check(OPCODE_REPORT_RECS, RESPONSE_SUCCESS);
+	reported_check(min, max);
+}
+
+static void report_fail_check(const uint8_t *req, size_t len, uint8_t rsp_code)
+{
+	reported_cnt = 0;
+	request_send(req, len);
+	response_check(req[0], rsp_code);
+	zassert_equal(reported_cnt, 0, "Records reported");
+}
+
+static void num_check(const uint8_t *req, size_t len, uint16_t count)
+{
+	uint8_t num_req[RACP_LENGTH];
+
+	memcpy(num_req, req, len);
+	num_req[0] = OPCODE_REPORT_NUM_RECS;
+
+	request_send(num_req, len);
+	num_response_check(count);
+}
+
+static void storage_clear(void)
+{
+#if defined(CONFIG_BT_CGMS_STORAGE_FLASH)
+	const struct flash_area *fa;
+
+	zassert_ok(flash_area_open(FIXED_PARTITION_ID(cgms_storage), &fa));
+	zassert_ok(flash_area_erase(fa, 0, fa->fa_size));
+	flash_area_close(fa);
+#endif
+
+	zassert_ok(cgms_storage_init());
+}
+
+static void *setup_fn(void)
+{
+	storage_clear();
+	zassert_ok(cgms_racp_init());
+
+	return NULL;
+}
+
+static void before_fn(void *f)
+{
+	ARG_UNUSED(f);
+
+	storage_clear();
+	k_msgq_purge(&rsp_msgq);
+
+	reported_cnt = 0;
+	notify_deferred = false;
+	notify_pending = 0;
+	notify_pending_max = 0;
+	abort_after = 0;
+}
+
+static void after_fn(void *f)
+{
+	struct racp_rsp rsp;
+
+	ARG_UNUSED(f);
+
+	zassert_not_equal(k_msgq_get(&rsp_msgq, &rsp, K_MSEC(100)), 0,
+			  "Unexpected RACP response");
+}
+
+ZTEST(suite_cgms_racp, test_report_all)
+{
+	const uint8_t req[] = {OPCODE_REPORT_RECS, OPERATOR_ALL};
+
+	report_fail_check(req, sizeof(req), RESPONSE_NO_RECORDS_FOUND);
+	num_check(req, sizeof(req), 0);
+
+	records_add();
+
+	report_check(req, sizeof(req), 0, UINT16_MAX);
+	num_check(req, sizeof(req), ARRAY_SIZE(time_offsets));
+}
+
+ZTEST(suite_cgms_racp, test_report_less_or_equal)
+{
+	const uint8_t req[] = {OPCODE_REPORT_RECS, OPERATOR_LESS_OR_EQUAL,
+			       FILTER_TIME_OFFSET, 15, 0};
+	const uint8_t req_last[] = {OPCODE_REPORT_RECS, OPERATOR_LESS_OR_EQUAL,
+				    FILTER_TIME_OFFSET, 45, 0};
+	const uint8_t req_none[] = {OPCODE_REPORT_RECS, OPERATOR_LESS_OR_EQUAL,
+				    FILTER_TIME_OFFSET, 4, 0};
+
+	records_add();
+
+	report_check(req, sizeof(req), 0, 15);
+	num_check(req, sizeof(req), 4);
+
+	report_check(req_last, sizeof(req_last), 0, 45);
+	num_check(req_last, sizeof(req_last), ARRAY_SIZE(time_offsets));
+
+	report_fail_check(req_none, sizeof(req_none), RESPONSE_NO_RECORDS_FOUND);
+	num_check(req_none, sizeof(req_none), 0);
+}
+
+ZTEST(suite_cgms_racp, test_report_greater_or_equal)
+{
+	const uint8_t req[] = {OPCODE_REPORT_RECS, OPERATOR_GREATER_OR_EQUAL,
+			       FILTER_TIME_OFFSET, 15, 0};
+	const uint8_t req_between[] = {OPCODE_REPORT_RECS, OPERATOR_GREATER_OR_EQUAL,
+				       FILTER_TIME_OFFSET, 31, 0};
+	const uint8_t req_none[] = {OPCODE_REPORT_RECS, OPERATOR_GREATER_OR_EQUAL,
+				    FILTER_TIME_OFFSET, 46, 0};
+
+	records_add();
+
+	report_check(req, sizeof(req), 15, UINT16_MAX);
+	num_check(req, sizeof(req), 8);
+
+	report_check(req_between, sizeof(req_between), 31, UINT16_MAX);
+	num_check(req_between, sizeof(req_between), 3);
+
+	report_fail_check(req_none, sizeof(req_none), RESPONSE_NO_RECORDS_FOUND);
+	num_check(req_none, sizeof(req_none), 0);
+}
+
+ZTEST(suite_cgms_racp, test_report_range)
+{
+	const uint8_t req[] = {OPCODE_REPORT_RECS, OPERATOR_RANGE,
+			       FILTER_TIME_OFFSET, 15, 0, 30, 0};
+	const uint8_t req_single[] = {OPCODE_REPORT_RECS, OPERATOR_RANGE,
+				      FILTER_TIME_OFFSET, 20, 0, 20, 0};
+	const uint8_t req_none[] = {OPCODE_REPORT_RECS, OPERATOR_RANGE,
+				    FILTER_TIME_OFFSET, 16, 0, 19, 0};
+	const uint8_t req_reversed[] = {OPCODE_REPORT_RECS, OPERATOR_RANGE,
+					FILTER_TIME_OFFSET, 30, 0, 15, 0};
+
+	records_add();
+
+	report_check(req, sizeof(req), 15, 30);
+	num_check(req, sizeof(req), 5);
+
+	report_check(req_single, sizeof(req_single), 20, 20);
+	num_check(req_single, sizeof(req_single), 1);
+
+	report_fail_check(req_none, sizeof(req_none), RESPONSE_NO_RECORDS_FOUND);
+	num_check(req_none, sizeof(req_none), 0);
+
+	report_fail_check(req_reversed, sizeof(req_reversed), RESPONSE_INVALID_OPERAND);
+}
+
+ZTEST(suite_cgms_racp, test_report_first_last)
+{
+	const uint8_t req_first[] = {OPCODE_REPORT_RECS, OPERATOR_FIRST};
+	const uint8_t req_last[] = {OPCODE_REPORT_RECS, OPERATOR_LAST};
+
+	report_fail_check(req_first, sizeof(req_first), RESPONSE_NO_RECORDS_FOUND);
+	report_fail_check(req_last, sizeof(req_last), RESPONSE_NO_RECORDS_FOUND);
+	num_check(req_first, sizeof(req_first), 0);
+	num_check(req_last, sizeof(req_last), 0);
+
+	records_add();
+
+	report_check(req_first, sizeof(req_first), 0, time_offsets[0]);
+	num_check(req_first, sizeof(req_first), 1);
+
+	report_check(req_last, sizeof(req_last), time_offsets[ARRAY_SIZE(time_offsets) - 1],
+		     UINT16_MAX);
+	num_check(req_last, sizeof(req_last), 1);
+}
+
+ZTEST(suite_cgms_racp, test_invalid_requests)
+{
+	const uint8_t req_no_operator[] = {OPCODE_REPORT_RECS};
+	const uint8_t req_null_operator[] = {OPCODE_REPORT_RECS, OPERATOR_NULL};
+	const uint8_t req_rfu_operator[] = {OPCODE_REPORT_RECS, 0x07};
+	const uint8_t req_no_operand[] = {OPCODE_REPORT_RECS, OPERATOR_GREATER_OR_EQUAL};
+	const uint8_t req_short_range[] = {OPCODE_REPORT_RECS, OPERATOR_RANGE,
+					   FILTER_TIME_OFFSET, 15, 0};
+	const uint8_t req_facing_time[] = {OPCODE_REPORT_RECS, OPERATOR_LESS_OR_EQUAL,
+					   FILTER_FACING_TIME, 15, 0};
+	const uint8_t req_num_rfu_operator[] = {OPCODE_REPORT_NUM_RECS, 0x07};
+	const uint8_t req_unsupported[] = {0x02, OPERATOR_ALL};
+
+	records_add();
+
+	report_fail_check(req_no_operator, sizeof(req_no_operator), RESPONSE_INVALID_OPERATOR);
+	report_fail_check(req_null_operator, sizeof(req_null_operator),
+			  RESPONSE_INVALID_OPERATOR);
+	report_fail_check(req_rfu_operator, sizeof(req_rfu_operator),
+			  RESPONSE_OPERATOR_UNSUPPORTED);
+	report_fail_check(req_no_operand, sizeof(req_no_operand), RESPONSE_INVALID_OPERAND);
+	report_fail_check(req_short_range, sizeof(req_short_range), RESPONSE_INVALID_OPERAND);
+	report_fail_check(req_facing_time, sizeof(req_facing_time),
+			  RESPONSE_OPERAND_UNSUPPORTED);
+	report_fail_check(req_num_rfu_operator, sizeof(req_num_rfu_operator),
+			  RESPONSE_OPERATOR_UNSUPPORTED);
+	report_fail_check(req_unsupported, sizeof(req_unsupported),
+			  RESPONSE_OPCODE_UNSUPPORTED);
+}
+
+ZTEST(suite_cgms_racp, test_time_offset_order)
+{
+	struct cgms_meas meas = {
+		.time_offset = time_offsets[ARRAY_SIZE(time_offsets) - 1] - 1,
+	};
+
+	records_add();
+
+	zassert_equal(cgms_racp_meas_add(meas), -EINVAL,
+		      "Record with a decreasing time offset added");
+
+	meas.time_offset++;
+	zassert_ok(cgms_racp_meas_add(meas));
+}
+
+ZTEST(suite_cgms_racp, test_session_time_offset_wrap)
+{
+	const uint8_t req[] = {OPCODE_REPORT_RECS, OPERATOR_ALL};
+	const uint8_t req_num[] = {OPCODE_REPORT_NUM_RECS, OPERATOR_ALL};
+	/* Enough records to fill more than one flash sector. */
+	const uint16_t session_records = 1000;
+	const uint16_t latest = UINT16_MAX - 60;
+	uint16_t time_offset;
+	uint32_t first_id;
+	uint32_t next_id;
+
+	zassert_ok(cgms_racp_session_start(60, &time_offset));
+	zassert_equal(time_offset, 0);
+
+	/* The session continues from the latest record. */
+	for (uint32_t i = 0; i < session_records; i++) {
+		meas_add(latest - session_records + 1 + i);
+	}
+
+	zassert_ok(cgms_racp_session_start(60, &time_offset));
+	zassert_equal(time_offset, latest);
+	num_check(req_num, sizeof(req_num), session_records);
+
+	/* The time offsets of the session would cross 65535 minutes. */
+	zassert_ok(cgms_racp_session_start(61, &time_offset));
+	zassert_equal(time_offset, 0);
+	num_check(req_num, sizeof(req_num), 0);
+
+	cgms_storage_ids_get(&first_id, &next_id);
+	zassert_equal(first_id, next_id);
+	zassert_equal(next_id, session_records);
+
+	/* The records of the new session start from time offset zero. */
+	records_add();
+	report_check(req, sizeof(req), 0, UINT16_MAX);
+
+	if (IS_ENABLED(CONFIG_BT_CGMS_STORAGE_FLASH)) {
+		/* The deleted records are not restored. */
+		zassert_ok(cgms_storage_init());
+
+		cgms_storage_ids_get(&first_id, &next_id);
+		zassert_equal(first_id, session_records);
+		zassert_equal(next_id, session_records + ARRAY_SIZE(time_offsets));
+		report_check(req, sizeof(req), 0, UINT16_MAX);
+	}
+}
+
+ZTEST(suite_cgms_racp, test_notify_flow_control)
+{
+	const uint8_t req[] = {OPCODE_REPORT_RECS, OPERATOR_ALL};
+	struct racp_rsp rsp;
+
+	records_add();
+
+	notify_deferred = true;
+	request_send(req, sizeof(req));
+
+	/* Complete the notifications one by one, until the procedure is done. */
+	while (k_msgq_get(&rsp_msgq, &rsp, K_MSEC(10)) != 0) {
+		zassert_true(notify_pending <= NOTIFY_MAX_PENDING, "Too many notifications");
+		if (notify_pending > 0) {
+			notify_pending--;
+			notify_done(NULL, NULL);
+		}
+	}
+
+	zassert_equal(rsp.data[3], RESPONSE_SUCCESS);
+	zassert_equal(notify_pending_max, NOTIFY_MAX_PENDING);
+	reported_check(0, UINT16_MAX);
+}
+
+ZTEST(suite_cgms_racp, test_procedure_in_progress)
+{
+	const uint8_t req[] = {OPCODE_REPORT_RECS, OPERATOR_ALL};
+	const uint8_t req_num[] = {OPCODE_REPORT_NUM_RECS, OPERATOR_ALL};
+
+	records_add();
+
+	/* The procedure waits for the notifications, which are not completed. */
+	notify_deferred = true;
+	request_send(req, sizeof(req));
+	k_sleep(K_MSEC(10));
+
+	zassert_equal(cgms_racp_recv_request(NULL, req_num, sizeof(req_num)), -EBUSY,
+		      "Second procedure started");
+
+	notify_deferred = false;
+	while (notify_pending > 0) {
+		notify_pending--;
+		notify_done(NULL, NULL);
+	}
+
+	response_check(OPCODE_REPORT_RECS, RESPONSE_SUCCESS);
+	reported_check(0, UINT16_MAX);
+
+	num_check(req, sizeof(req), ARRAY_SIZE(time_offsets));
+}
+
+ZTEST(suite_cgms_racp, test_abort)
+{
+	const uint8_t req[] = {OPCODE_REPORT_RECS, OPERATOR_ALL};
+	const uint8_t req_abort[] = {OPCODE_ABORT_OPERATION, OPERATOR_NULL};
+	const uint8_t req_abort_invalid[] = {OPCODE_ABORT_OPERATION, OPERATOR_ALL};
+
+	/* Abort without a procedure in progress. */
+	request_send(req_abort, sizeof(req_abort));
+	response_check(OPCODE_ABORT_OPERATION, RESPONSE_SUCCESS);
+
+	report_fail_check(req_abort_invalid, sizeof(req_abort_invalid),
+			  RESPONSE_INVALID_OPERATOR);
+
+	records_add();
+
+	/* The procedure is completed by the response to the abortion. */
+	abort_after = 3;
+	request_send(req, sizeof(req));
+	response_check(OPCODE_ABORT_OPERATION, RESPONSE_SUCCESS);
+	zassert_equal(reported_cnt, abort_after, "Records reported after abortion");
+
+	/* The next procedure is not affected. */
+	abort_after = 0;
+	report_check(req, sizeof(req), 0, UINT16_MAX);
+}
+
+ZTEST(suite_cgms_racp, test_storage_wrap)
+{
+	const uint8_t req_num[] = {OPCODE_REPORT_NUM_RECS, OPERATOR_ALL};
+	const uint8_t req_ge[] = {OPCODE_REPORT_NUM_RECS, OPERATOR_GREATER_OR_EQUAL,
+				  FILTER_TIME_OFFSET, 0, 0};
+	const uint8_t req_recent[] = {OPCODE_REPORT_NUM_RECS, OPERATOR_GREATER_OR_EQUAL,
+				      FILTER_TIME_OFFSET,
+				      (WRAP_RECORD_CNT - 1000) & 0xFF,
+				      (WRAP_RECORD_CNT - 1000) >> 8};
+	uint32_t first_id;
+	uint32_t next_id;
+	struct cgms_meas meas;
+
+	/* The time offset is equal to the record id. */
+	for (uint32_t i = 0; i < WRAP_RECORD_CNT; i++) {
+		meas_add(i);
+	}
+
+	cgms_storage_ids_get(&first_id, &next_id);
+	zassert_true(first_id > 0, "No record dropped");
+	zassert_equal(next_id, WRAP_RECORD_CNT);
+	zassert_equal(cgms_storage_get(first_id - 1, &meas), -ENOENT);
+	zassert_ok(cgms_storage_get(first_id, &meas));
+	zassert_equal(meas.time_offset, first_id);
+
+	num_check(req_num, sizeof(req_num), next_id - first_id);
+	num_check(req_ge, sizeof(req_ge), next_id - first_id);
+	num_check(req_recent, sizeof(req_recent), 1000);
+
+	zassert_ok(cgms_racp_meas_get_latest(&meas));
+	zassert_equal(meas.time_offset, WRAP_RECORD_CNT - 1);
+}
+
+ZTEST(suite_cgms_racp, test_flash_restore)
+{
+	const uint8_t req[] = {OPCODE_REPORT_RECS, OPERATOR_ALL};
+	uint32_t first_id;
+	uint32_t next_id;
+	uint32_t restored_first_id;
+	uint32_t restored_next_id;
+
+	Z_TEST_SKIP_IFNDEF(CONFIG_BT_CGMS_STORAGE_FLASH);
+
+	records_add();
+
+	zassert_ok(cgms_storage_init());
+
+	cgms_storage_ids_get(&first_id, &next_id);
+	zassert_equal(first_id, 0);
+	zassert_equal(next_id, ARRAY_SIZE(time_offsets));
+	report_check(req, sizeof(req), 0, UINT16_MAX);
+
+	/* Restore a log that spans many sectors and has wrapped around the partition. */
+	for (uint32_t i = 0; i < WRAP_RECORD_CNT; i++) {
+		meas_add(time_offsets[ARRAY_SIZE(time_offsets) - 1] + i);
+	}
+
+	cgms_storage_ids_get(&first_id, &next_id);
+	zassert_true(first_id > 0, "No record dropped");
+	zassert_ok(cgms_storage_init());
+
+	cgms_storage_ids_get(&restored_first_id, &restored_next_id);
+	zassert_equal(restored_first_id, first_id);
+	zassert_equal(restored_next_id, next_id);
+}
+
+ZTEST(suite_cgms_racp, test_flash_power_loss)
+{
+	const uint8_t req[] = {OPCODE_REPORT_RECS, OPERATOR_ALL};
+	const uint8_t torn[FLASH_SLOT_SIZE / 2] = {0};
+	const struct flash_area *fa;
+	uint32_t first_id;
+	uint32_t next_id;
+	struct cgms_meas meas;
+
+	Z_TEST_SKIP_IFNDEF(CONFIG_BT_CGMS_STORAGE_FLASH);
+
+	zassert_ok(flash_area_open(FIXED_PARTITION_ID(cgms_storage), &fa));
+	zassert_equal(flash_area_align(fa), 1, "Unexpected flash layout");
+
+	records_add();
+
+	/* The power is lost when the next record is half written to the first sector. */
+	zassert_ok(flash_area_write(fa, (ARRAY_SIZE(time_offsets) + 1) * FLASH_SLOT_SIZE,
+				    torn, sizeof(torn)));
+	/* The power is lost when the header of the second sector is half written. */
+	zassert_ok(flash_area_write(fa, FLASH_SECTOR_SIZE, torn, sizeof(torn)));
+	flash_area_close(fa);
+
+	zassert_ok(cgms_storage_init());
+
+	cgms_storage_ids_get(&first_id, &next_id);
+	zassert_equal(first_id, 0);
+	zassert_equal(next_id, ARRAY_SIZE(time_offsets), "Incomplete record restored");
+	report_check(req, sizeof(req), 0, UINT16_MAX);
+
+	/* The log continues in the next sector. */
+	meas.time_offset = time_offsets[ARRAY_SIZE(time_offsets) - 1];
+	meas.glucose_concentration = meas.time_offset * 3;
+	zassert_ok(cgms_storage_append(&meas));
+	zassert_ok(cgms_storage_init());
+
+	cgms_storage_ids_get(&first_id, &next_id);
+	zassert_equal(first_id, 0);
+	zassert_equal(next_id, ARRAY_SIZE(time_offsets) + 1);
+	zassert_ok(cgms_racp_meas_get_latest(&meas));
+	zassert_equal(meas.time_offset, time_offsets[ARRAY_SIZE(time_offsets) - 1]);
+	zassert_equal(meas.glucose_concentration, meas.time_offset * 3);
+}
+
+static uint32_t racp_time_ns(const uint8_t *req, size_t len, struct racp_rsp *rsp)
+{
+	uint64_t start = test_timestamp_get();
+
+	request_send(req, len);
+	response_wait(rsp);
+
+	return test_elapsed_ns_get(start);
+}
+
+/* Counts the records by walking all of them, as the previous database did. */
+static uint32_t count_reference(uint16_t time_offset_limit)
+{
+	uint32_t first_id;
+	uint32_t next_id;
+	uint32_t count = 0;
+	struct cgms_meas meas;
+
+	cgms_storage_ids_get(&first_id, &next_id);
+	for (uint32_t id = first_id; id != next_id; id++) {
+		zassert_ok(cgms_storage_get(id, &meas));
+		if (meas.time_offset >= time_offset_limit) {
+			count++;
+		}
+	}
+
+	return count;
+}
+
+ZTEST(suite_cgms_racp, test_long_history)
+{
+	const uint16_t last_hour = HISTORY_RECORD_CNT - 60;
+	const uint16_t last_day = HISTORY_RECORD_CNT - 24 * 60;
+	const uint8_t req_num_hour[] = {OPCODE_REPORT_NUM_RECS, OPERATOR_GREATER_OR_EQUAL,
+					FILTER_TIME_OFFSET, last_hour & 0xFF, last_hour >> 8};
+	const uint8_t req_hour[] = {OPCODE_REPORT_RECS, OPERATOR_GREATER_OR_EQUAL,
+				    FILTER_TIME_OFFSET, last_hour & 0xFF, last_hour >> 8};
+	const uint8_t req_day[] = {OPCODE_REPORT_RECS, OPERATOR_GREATER_OR_EQUAL,
+				   FILTER_TIME_OFFSET, last_day & 0xFF, last_day >> 8};
+	const uint8_t req_last[] = {OPCODE_REPORT_RECS, OPERATOR_LAST};
+	struct racp_rsp rsp;
+	uint64_t start;
+	uint32_t append_ns;
+	uint32_t init_ns;
+	uint32_t num_ns;
+	uint32_t num_reference_ns;
+	uint32_t count;
+
+	start = test_timestamp_get();
+	for (uint32_t i = 0; i < HISTORY_RECORD_CNT; i++) {
+		meas_add(i);
+	}
+	append_ns = test_elapsed_ns_get(start) / HISTORY_RECORD_CNT;
+
+	/* The index is rebuilt from the stored records. */
+	start = test_timestamp_get();
+	zassert_ok(cgms_storage_init());
+	init_ns = test_elapsed_ns_get(start);
+
+	num_ns = racp_time_ns(req_num_hour, sizeof(req_num_hour), &rsp);
+	zassert_equal(rsp.data[0], OPCODE_NUM_RECS_RESPONSE);
+	zassert_equal(sys_get_le16(&rsp.data[2]), 60);
+
+	start = test_timestamp_get();
+	count = count_reference(last_hour);
+	num_reference_ns = test_elapsed_ns_get(start);
+	zassert_equal(count, 60);
+
+	TC_PRINT("%u records of %u days at 1-minute cadence\n", HISTORY_RECORD_CNT,
+		 CONFIG_TEST_CGMS_HISTORY_DAYS);
+	TC_PRINT("record append [ns]: %u (average)\n", append_ns);
+	TC_PRINT("storage init [ns]: %u\n", init_ns);
+	TC_PRINT("number of records >= last hour [ns]: %u (full scan: %u)\n",
+		 num_ns, num_reference_ns);
+
+	/* The binary search reads a few records instead of all of them. */
+	zassert_true(num_ns < num_reference_ns,
+		     "Number of records found slower than with a full scan");
+
+	reported_cnt = 0;
+	TC_PRINT("report last record [ns]: %u\n", racp_time_ns(req_last, sizeof(req_last), &rsp));
+	zassert_equal(reported_cnt, 1);
+	zassert_equal(reported[0].time_offset, HISTORY_RECORD_CNT - 1);
+
+	reported_cnt = 0;
+	TC_PRINT("report records >= last hour [ns]: %u\n",
+		 racp_time_ns(req_hour, sizeof(req_hour), &rsp));
+	zassert_equal(reported_cnt, 60);
+	zassert_equal(rsp.data[3], RESPONSE_SUCCESS);
+
+	reported_cnt = 0;
+	TC_PRINT("report records >= last day [ns]: %u\n",
+		 racp_time_ns(req_day, sizeof(req_day), &rsp));
+	zassert_equal(reported_cnt, 24 * 60);
+	zassert_equal(rsp.data[3], RESPONSE_SUCCESS);
+}
+
+ZTEST_SUITE(suite_cgms_racp, NULL, setup_fn, before_fn, after_fn, NULL);
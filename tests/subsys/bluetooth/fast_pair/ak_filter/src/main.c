@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/ztest.h>
+#include <zephyr/random/random.h>
+
+#include "fp_activation.h"
+#include "fp_ak_filter.h"
+#include "fp_common.h"
+#include "fp_crypto.h"
+
+#define ACCOUNT_KEY_MAX_CNT	CONFIG_BT_FAST_PAIR_STORAGE_ACCOUNT_KEY_MAX
+#define AK_FILTER_MAX_SIZE	15
+#define RANDOM_INPUT_CNT	500
+
+struct ak_filter_input {
+	struct fp_account_key account_keys[ACCOUNT_KEY_MAX_CNT];
+	size_t n;
+	uint8_t battery_info[FP_CRYPTO_BATTERY_INFO_LEN];
+	bool has_battery_info;
+};
+
+static void random_input_generate(struct ak_filter_input *input)
+{
+	input->n = 1 + (sys_rand32_get() % ACCOUNT_KEY_MAX_CNT);
+	sys_rand_get(input->account_keys, sizeof(input->account_keys));
+
+	input->has_battery_info = (sys_rand32_get() % 2);
+	sys_rand_get(input->battery_info, sizeof(input->battery_info));
+}
+
+static const uint8_t *battery_info_get(const struct ak_filter_input *input)
+{
+	return input->has_battery_info ? input->battery_info : NULL;
+}
+
+/* Get the filter from the engine and compare it with the reference implementation. */
+static void ak_filter_check(const struct ak_filter_input *input)
+{
+	int err;
+	uint16_t salt;
+	uint8_t filter[AK_FILTER_MAX_SIZE];
+	uint8_t expected[AK_FILTER_MAX_SIZE];
+	size_t filter_size = fp_crypto_account_key_filter_size(input->n);
+
+	zassert_true(filter_size <= sizeof(filter), "Invalid Account Key Filter size");
+
+	err = fp_ak_filter_get(filter, &salt, input->account_keys, input->n,
+			       battery_info_get(input));
+	zassert_ok(err, "Failed to get Account Key Filter");
+
+	err = fp_crypto_account_key_filter(expected, input->account_keys, input->n, salt,
+					   battery_info_get(input));
+	zassert_ok(err, "Failed to compute reference Account Key Filter");
+
+	zassert_mem_equal(filter, expected, filter_size, "Invalid Account Key Filter");
+}
+
+static void precompute_wait(void)
+{
+	/* Let the system workqueue precompute the next filter. */
+	k_sleep(K_MSEC(1));
+}
+
+static void before_fn(void *f)
+{
+	ARG_UNUSED(f);
+
+	/* Drop the precomputed filter left by the previous test. */
+	STRUCT_SECTION_FOREACH(fp_activation_module, module) {
+		zassert_ok(module->module_uninit(), "Failed to uninitialize module");
+		zassert_ok(module->module_init(), "Failed to initialize module");
+	}
+}
+
+ZTEST(suite_fast_pair_ak_filter, test_random_inputs)
+{
+	struct ak_filter_input input;
+	struct fp_ak_filter_stats stats_before;
+	struct fp_ak_filter_stats stats_after;
+
+	fp_ak_filter_stats_get(&stats_before);
+
+	random_input_generate(&input);
+
+	for (size_t i = 0; i < RANDOM_INPUT_CNT; i++) {
+		uint32_t action = sys_rand32_get() % 4;
+
+		if (action == 0) {
+			/* New Account Keys and battery info. */
+			random_input_generate(&input);
+		} else if (action == 1) {
+			/* New battery info. */
+			input.has_battery_info = !input.has_battery_info;
+			sys_rand_get(input.battery_info, sizeof(input.battery_info));
+		}
+
+		if (sys_rand32_get() % 2) {
+			precompute_wait();
+		}
+
+		ak_filter_check(&input);
+	}
+
+	fp_ak_filter_stats_get(&stats_after);
+
+	zassert_true(stats_after.hits > stats_before.hits, "Precomputed filter never used");
+	zassert_true(stats_after.misses > stats_before.misses, "Filter never computed");
+}
+
+ZTEST(suite_fast_pair_ak_filter, test_precomputed_used_once)
+{
+	struct ak_filter_input input;
+	struct fp_ak_filter_stats stats_before;
+	struct fp_ak_filter_stats stats_after;
+
+	random_input_generate(&input);
+	ak_filter_check(&input);
+	precompute_wait();
+
+	fp_ak_filter_stats_get(&stats_before);
+
+	/* The first request uses the precomputed filter. */
+	ak_filter_check(&input);
+	fp_ak_filter_stats_get(&stats_after);
+	zassert_equal(stats_after.hits, stats_before.hits + 1, "Precomputed filter not used");
+
+	/* The precomputed filter and its Salt are not used again. */
+	ak_filter_check(&input);
+	fp_ak_filter_stats_get(&stats_after);
+	zassert_equal(stats_after.hits, stats_before.hits + 1, "Precomputed filter used twice");
+	zassert_equal(stats_after.misses, stats_before.misses + 1, "Filter not computed");
+}
+
+ZTEST(suite_fast_pair_ak_filter, test_precomputed_input_change)
+{
+	struct ak_filter_input input;
+	struct fp_ak_filter_stats stats_before;
+	struct fp_ak_filter_stats stats_after;
+
+	random_input_generate(&input);
+	input.n = ACCOUNT_KEY_MAX_CNT - 1;
+	input.has_battery_info = true;
+	ak_filter_check(&input);
+
+	fp_ak_filter_stats_get(&stats_before);
+
+	/* Changed Account Key. */
+	precompute_wait();
+	input.account_keys[0].key[0] ^= 0x01;
+	ak_filter_check(&input);
+
+	/* Added Account Key. */
+	precompute_wait();
+	input.n++;
+	ak_filter_check(&input);
+
+	/* Changed battery info. */
+	precompute_wait();
+	input.battery_info[FP_CRYPTO_BATTERY_INFO_LEN - 1] ^= 0x01;
+	ak_filter_check(&input);
+
+	/* Removed battery info. */
+	precompute_wait();
+	input.has_battery_info = false;
+	ak_filter_check(&input);
+
+	fp_ak_filter_stats_get(&stats_after);
+	zassert_equal(stats_after.hits, stats_before.hits, "Outdated filter used");
+	zassert_equal(stats_after.misses, stats_before.misses + 4, "Filter not computed");
+}
+
+ZTEST_SUITE(suite_fast_pair_ak_filter, NULL, NULL, before_fn, NULL, NULL);
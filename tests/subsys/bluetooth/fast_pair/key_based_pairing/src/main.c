@@ -0,0 +1,291 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/ztest.h>
+#include <zephyr/settings/settings.h>
+
+#include "fp_common.h"
+#include "fp_crypto.h"
+#include "fp_storage.h"
+#include "fp_storage_ak.h"
+#include "fp_storage_ak_priv.h"
+#include "fp_storage_manager_priv.h"
+
+#include "storage_mock.h"
+#include "test_host_time.h"
+
+#define ACCOUNT_KEY_MAX_CNT	CONFIG_BT_FAST_PAIR_STORAGE_ACCOUNT_KEY_MAX
+#define BENCHMARK_ROUNDS	CONFIG_TEST_KBP_BENCHMARK_ROUNDS
+
+#define KBP_REQ_MSG_TYPE	0x00
+#define KBP_REQ_ADDR_POS	2
+#define KBP_REQ_SALT_POS	(KBP_REQ_ADDR_POS + sizeof(provider_addr))
+
+/* Seed of the Account Key that is not stored. */
+#define UNKNOWN_SEED		(ACCOUNT_KEY_MAX_CNT + 1)
+
+struct prepared_account_key {
+	struct fp_account_key account_key;
+	struct fp_crypto_aes128_dec_key dec_key;
+};
+
+static const uint8_t provider_addr[] = {0xC0, 0x11, 0x22, 0x33, 0x44, 0x55};
+
+static struct prepared_account_key prepared_keys[ACCOUNT_KEY_MAX_CNT];
+static size_t prepared_key_cnt;
+
+static void account_key_generate(uint8_t seed, struct fp_account_key *account_key)
+{
+	memset(account_key->key, seed, sizeof(account_key->key));
+}
+
+static void kbp_request_generate(uint8_t seed, uint8_t *req_enc)
+{
+	int err;
+	struct fp_account_key account_key;
+	uint8_t req[FP_CRYPTO_AES128_BLOCK_LEN];
+
+	req[0] = KBP_REQ_MSG_TYPE;
+	req[1] = 0;
+	memcpy(&req[KBP_REQ_ADDR_POS], provider_addr, sizeof(provider_addr));
+	for (size_t i = KBP_REQ_SALT_POS; i < sizeof(req); i++) {
+		req[i] = seed ^ i;
+	}
+
+	account_key_generate(seed, &account_key);
+	err = fp_crypto_aes128_ecb_encrypt(req_enc, req, account_key.key);
+	zassert_ok(err, "Failed to encrypt request");
+}
+
+static bool kbp_request_validate(const uint8_t *req)
+{
+	return (req[0] == KBP_REQ_MSG_TYPE) &&
+	       !memcmp(&req[KBP_REQ_ADDR_POS], provider_addr, sizeof(provider_addr));
+}
+
+static void prepared_keys_free(void)
+{
+	for (size_t i = 0; i < prepared_key_cnt; i++) {
+		fp_crypto_aes128_dec_key_free(&prepared_keys[i].dec_key);
+	}
+
+	prepared_key_cnt = 0;
+}
+
+static void prepared_keys_update(void)
+{
+	int err;
+	struct fp_account_key account_keys[ACCOUNT_KEY_MAX_CNT];
+	size_t account_key_cnt = ARRAY_SIZE(account_keys);
+
+	prepared_keys_free();
+
+	err = fp_storage_ak_get(account_keys, &account_key_cnt);
+	zassert_ok(err, "Getting Account Keys failed");
+
+	for (size_t i = 0; i < account_key_cnt; i++) {
+		struct prepared_account_key *prepared_key = &prepared_keys[i];
+
+		prepared_key->account_key = account_keys[i];
+		err = fp_crypto_aes128_dec_key_prepare(&prepared_key->dec_key,
+						       account_keys[i].key);
+		zassert_ok(err, "Failed to prepare Account Key");
+		prepared_key_cnt++;
+	}
+}
+
+/* Account Key lookup done before the prepared keys and the most recently used first order were
+ * introduced: the keys are checked in the storage order and every check prepares the AES key.
+ */
+static int kbp_lookup_reference(const uint8_t *req_enc, struct fp_account_key *found_key)
+{
+	int err;
+	struct fp_account_key account_keys[ACCOUNT_KEY_MAX_CNT];
+	size_t account_key_cnt = ARRAY_SIZE(account_keys);
+	uint8_t req[FP_CRYPTO_AES128_BLOCK_LEN];
+
+	err = fp_storage_ak_get(account_keys, &account_key_cnt);
+	zassert_ok(err, "Getting Account Keys failed");
+
+	for (size_t i = 0; i < account_key_cnt; i++) {
+		err = fp_crypto_aes128_ecb_decrypt(req, req_enc, account_keys[i].key);
+		zassert_ok(err, "Failed to decrypt request");
+
+		if (kbp_request_validate(req)) {
+			*found_key = account_keys[i];
+			return 0;
+		}
+	}
+
+	return -ESRCH;
+}
+
+static bool kbp_account_key_check(const struct fp_account_key *account_key, void *context)
+{
+	int err;
+	const uint8_t *req_enc = context;
+	uint8_t req[FP_CRYPTO_AES128_BLOCK_LEN];
+
+	for (size_t i = 0; i < prepared_key_cnt; i++) {
+		struct prepared_account_key *prepared_key = &prepared_keys[i];
+
+		if (memcmp(prepared_key->account_key.key, account_key->key,
+			   sizeof(account_key->key))) {
+			continue;
+		}
+
+		err = fp_crypto_aes128_ecb_decrypt_prepared(req, req_enc, &prepared_key->dec_key);
+		zassert_ok(err, "Failed to decrypt request");
+
+		return kbp_request_validate(req);
+	}
+
+	zassert_unreachable("Account Key not prepared");
+
+	return false;
+}
+
+/* Account Key lookup as done by the Fast Pair keys module. */
+static int kbp_lookup(const uint8_t *req_enc, struct fp_account_key *found_key)
+{
+	return fp_storage_ak_find(found_key, kbp_account_key_check, (void *)req_enc);
+}
+
+static void account_keys_setup(uint8_t key_cnt)
+{
+	int err;
+	struct fp_account_key account_key;
+
+	for (uint8_t seed = 1; seed <= key_cnt; seed++) {
+		account_key_generate(seed, &account_key);
+
+		err = fp_storage_ak_save(&account_key);
+		zassert_ok(err, "Failed to store Account Key");
+	}
+
+	prepared_keys_update();
+}
+
+static void lookup_compare(uint8_t seed)
+{
+	int err;
+	int err_reference;
+	struct fp_account_key found_key = {0};
+	struct fp_account_key found_key_reference = {0};
+	uint8_t req_enc[FP_CRYPTO_AES128_BLOCK_LEN];
+
+	kbp_request_generate(seed, req_enc);
+
+	err_reference = kbp_lookup_reference(req_enc, &found_key_reference);
+	err = kbp_lookup(req_enc, &found_key);
+
+	zassert_equal(err, err_reference, "Different lookup result for seed %u", seed);
+	zassert_mem_equal(found_key.key, found_key_reference.key, sizeof(found_key.key),
+			  "Different Account Key found for seed %u", seed);
+}
+
+static uint32_t lookup_time_ns(int (*lookup)(const uint8_t *, struct fp_account_key *),
+			       const uint8_t *req_enc)
+{
+	struct fp_account_key found_key;
+	uint64_t start = test_timestamp_get();
+
+	for (size_t i = 0; i < BENCHMARK_ROUNDS; i++) {
+		(void)lookup(req_enc, &found_key);
+	}
+
+	return test_elapsed_ns_get(start) / BENCHMARK_ROUNDS;
+}
+
+static void before_fn(void *f)
+{
+	ARG_UNUSED(f);
+
+	int err;
+
+	err = settings_load();
+	zassert_ok(err, "Settings load failed");
+
+	err = fp_storage_init();
+	zassert_ok(err, "Failed to initialize module");
+}
+
+static void after_fn(void *f)
+{
+	ARG_UNUSED(f);
+
+	prepared_keys_free();
+	fp_storage_ak_ram_clear();
+	fp_storage_manager_ram_clear();
+	storage_mock_clear();
+}
+
+ZTEST(suite_fast_pair_kbp, test_identical_results)
+{
+	for (uint8_t key_cnt = 1; key_cnt <= ACCOUNT_KEY_MAX_CNT; key_cnt++) {
+		if (key_cnt > 1) {
+			after_fn(NULL);
+			before_fn(NULL);
+		}
+
+		account_keys_setup(key_cnt);
+
+		/* Use the keys in different orders to change the lookup order. */
+		for (uint8_t seed = 1; seed <= key_cnt; seed++) {
+			lookup_compare(seed);
+		}
+		for (uint8_t seed = key_cnt; seed >= 1; seed--) {
+			lookup_compare(seed);
+			lookup_compare(seed);
+		}
+		for (uint8_t seed = 1; seed <= key_cnt; seed += 2) {
+			lookup_compare(seed);
+		}
+
+		lookup_compare(UNKNOWN_SEED);
+	}
+}
+
+ZTEST(suite_fast_pair_kbp, test_benchmark)
+{
+	uint8_t req_enc_unknown[FP_CRYPTO_AES128_BLOCK_LEN];
+
+	kbp_request_generate(UNKNOWN_SEED, req_enc_unknown);
+
+	TC_PRINT("Account Key lookup time [ns], average of %u requests\n", BENCHMARK_ROUNDS);
+	TC_PRINT("keys | last key: reference | last key: new | unknown: reference | "
+		 "unknown: new\n");
+
+	for (uint8_t key_cnt = 1; key_cnt <= ACCOUNT_KEY_MAX_CNT; key_cnt++) {
+		uint8_t req_enc[FP_CRYPTO_AES128_BLOCK_LEN];
+		uint32_t match_reference;
+		uint32_t match;
+		uint32_t unknown_reference;
+		uint32_t unknown;
+
+		if (key_cnt > 1) {
+			after_fn(NULL);
+			before_fn(NULL);
+		}
+
+		account_keys_setup(key_cnt);
+
+		/* The Seeker that uses the Account Key stored in the last slot connects
+		 * repeatedly. It is the worst case for the storage order lookup.
+		 */
+		kbp_request_generate(key_cnt, req_enc);
+
+		match_reference = lookup_time_ns(kbp_lookup_reference, req_enc);
+		match = lookup_time_ns(kbp_lookup, req_enc);
+		unknown_reference = lookup_time_ns(kbp_lookup_reference, req_enc_unknown);
+		unknown = lookup_time_ns(kbp_lookup, req_enc_unknown);
+
+		TC_PRINT("%4u | %19u | %13u | %18u | %12u\n", key_cnt, match_reference, match,
+			 unknown_reference, unknown);
+	}
+}
+
+ZTEST_SUITE(suite_fast_pair_kbp, NULL, NULL, before_fn, after_fn, NULL);
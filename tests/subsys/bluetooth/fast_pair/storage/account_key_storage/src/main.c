@@ -18,6 +18,12 @@
 
 #define ACCOUNT_KEY_MAX_CNT	CONFIG_BT_FAST_PAIR_STORAGE_ACCOUNT_KEY_MAX
 
+#ifdef CONFIG_BT_FAST_PAIR_STORAGE_AK_ORDER_SAVE_DELAY
+#define AK_ORDER_SAVE_DELAY	CONFIG_BT_FAST_PAIR_STORAGE_AK_ORDER_SAVE_DELAY
+#else
+#define AK_ORDER_SAVE_DELAY	0
+#endif
+
 
 static void reload_keys_from_storage(void)
 {
@@ -252,6 +258,133 @@ ZTEST(suite_fast_pair_storage_common, test_find)
 	zassert_equal(err, -ESRCH, "Expected error when key cannot be found");
 }
 
+struct probe_order_context {
+	uint8_t seeds[ACCOUNT_KEY_MAX_CNT];
+	size_t cnt;
+};
+
+static bool account_key_probe_order_cb(const struct fp_account_key *account_key, void *context)
+{
+	struct probe_order_context *ctx = context;
+
+	zassert_true(ctx->cnt < ARRAY_SIZE(ctx->seeds), "Too many Account Keys checked");
+	ctx->seeds[ctx->cnt++] = account_key->key[0];
+
+	return false;
+}
+
+static void probe_order_validate(const uint8_t *expected_seeds, size_t cnt)
+{
+	int err;
+	struct probe_order_context ctx = {0};
+
+	err = fp_storage_ak_find(NULL, account_key_probe_order_cb, &ctx);
+	zassert_equal(err, -ESRCH, "Expected error when key cannot be found");
+	zassert_equal(ctx.cnt, cnt, "Invalid number of checked Account Keys");
+	zassert_mem_equal(ctx.seeds, expected_seeds, cnt, "Invalid Account Key check order");
+}
+
+static void account_key_use(uint8_t seed)
+{
+	int err;
+
+	err = fp_storage_ak_find(NULL, account_key_find_cb, &seed);
+	zassert_ok(err, "Failed to find Account Key");
+}
+
+ZTEST(suite_fast_pair_storage_common, test_find_mru_order)
+{
+	if (!IS_ENABLED(CONFIG_BT_FAST_PAIR_STORAGE_AK_BACKEND_STANDARD)) {
+		ztest_test_skip();
+	}
+
+	static const uint8_t first_seed;
+	static const size_t test_key_cnt = MIN(ACCOUNT_KEY_MAX_CNT, 4);
+	uint8_t expected_seeds[ACCOUNT_KEY_MAX_CNT];
+
+	cu_account_keys_generate_and_store(first_seed, test_key_cnt);
+
+	/* The most recently saved Account Key is checked first. */
+	for (size_t i = 0; i < test_key_cnt; i++) {
+		expected_seeds[i] = first_seed + test_key_cnt - 1 - i;
+	}
+	probe_order_validate(expected_seeds, test_key_cnt);
+
+	/* The found Account Key is moved to the front. */
+	account_key_use(first_seed);
+	expected_seeds[0] = first_seed;
+	for (size_t i = 1; i < test_key_cnt; i++) {
+		expected_seeds[i] = first_seed + test_key_cnt - i;
+	}
+	probe_order_validate(expected_seeds, test_key_cnt);
+
+	/* Finding the most recently used Account Key does not change the order. */
+	account_key_use(first_seed);
+	probe_order_validate(expected_seeds, test_key_cnt);
+}
+
+ZTEST(suite_fast_pair_storage_common, test_order_lazy_save)
+{
+	if (!IS_ENABLED(CONFIG_BT_FAST_PAIR_STORAGE_AK_BACKEND_STANDARD) ||
+	    (AK_ORDER_SAVE_DELAY == 0)) {
+		ztest_test_skip();
+	}
+
+	static const uint8_t first_seed;
+	static const size_t test_key_cnt = MIN(ACCOUNT_KEY_MAX_CNT, 3);
+	uint8_t saved_order_seeds[ACCOUNT_KEY_MAX_CNT];
+	uint8_t used_order_seeds[ACCOUNT_KEY_MAX_CNT];
+
+	cu_account_keys_generate_and_store(first_seed, test_key_cnt);
+
+	for (size_t i = 0; i < test_key_cnt; i++) {
+		saved_order_seeds[i] = first_seed + test_key_cnt - 1 - i;
+		used_order_seeds[i] = first_seed + i;
+	}
+
+	/* The updated order is lost if the device resets before the order is saved. */
+	for (size_t i = 0; i < test_key_cnt; i++) {
+		account_key_use(first_seed + test_key_cnt - 1 - i);
+	}
+	reload_keys_from_storage();
+	probe_order_validate(saved_order_seeds, test_key_cnt);
+
+	/* The subsequent updates are saved together after the delay. */
+	for (size_t i = 0; i < test_key_cnt; i++) {
+		account_key_use(first_seed + test_key_cnt - 1 - i);
+	}
+	k_sleep(K_MSEC(AK_ORDER_SAVE_DELAY + 10));
+	reload_keys_from_storage();
+	probe_order_validate(used_order_seeds, test_key_cnt);
+}
+
+ZTEST(suite_fast_pair_storage_common, test_order_save_on_uninit)
+{
+	if (!IS_ENABLED(CONFIG_BT_FAST_PAIR_STORAGE_AK_BACKEND_STANDARD)) {
+		ztest_test_skip();
+	}
+
+	static const uint8_t first_seed;
+	static const size_t test_key_cnt = MIN(ACCOUNT_KEY_MAX_CNT, 3);
+	uint8_t expected_seeds[ACCOUNT_KEY_MAX_CNT];
+	int err;
+
+	cu_account_keys_generate_and_store(first_seed, test_key_cnt);
+
+	expected_seeds[0] = first_seed;
+	for (size_t i = 1; i < test_key_cnt; i++) {
+		expected_seeds[i] = first_seed + test_key_cnt - i;
+	}
+
+	/* The pending order is saved when the storage is uninitialized. */
+	account_key_use(first_seed);
+	err = fp_storage_uninit();
+	zassert_ok(err, "Uninitialization failed");
+
+	reload_keys_from_storage();
+	probe_order_validate(expected_seeds, test_key_cnt);
+}
+
 ZTEST(suite_fast_pair_storage_common, test_bt_has_ak)
 {
 	static const uint8_t first_seed;
@@ -0,0 +1,286 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <math.h>
+#include <zephyr/ztest.h>
+#include <bluetooth/mesh/light_ctrl_reg_spec.h>
+
+#include "reg_spec_float.h"
+
+#define REG_CNT FLOAT_REG_CNT
+#define REG_INT CONFIG_BT_MESH_LIGHT_CTRL_REG_SPEC_INTERVAL
+#define STEP_CNT 600
+/* Delay between the starts of two regulators, as if their Light LC Servers received the first
+ * ambient light level at different times.
+ */
+#define START_STAGGER_MS 7
+
+#define TARGET_LUX 500.0f
+
+/* Largest difference in output between the fixed-point and the floating point regulator, in
+ * lightness units.
+ */
+#define OUTPUT_TOLERANCE 4.0f
+
+struct engine;
+
+/* A luminaire lighting a room, and an ambient light sensor that measures the light of the
+ * luminaire and the daylight.
+ */
+struct plant {
+	struct engine *engine;
+	struct bt_mesh_light_ctrl_reg *reg;
+	int id;
+	/* Illuminance at the sensor per lightness unit */
+	float lux_per_lightness;
+	uint16_t lightness;
+	uint32_t step_cnt;
+	float outputs[STEP_CNT];
+};
+
+struct engine {
+	const char *name;
+	struct plant plants[REG_CNT];
+	uint32_t wakeup_cnt;
+	int64_t last_wakeup;
+};
+
+static struct bt_mesh_light_ctrl_reg_spec fixed_regs[REG_CNT] = {
+	[0 ... REG_CNT - 1] = BT_MESH_LIGHT_CTRL_REG_SPEC_INIT
+};
+
+static struct engine fixed_engine = { .name = "fixed-point" };
+static struct engine float_engine = { .name = "floating point" };
+
+/* Daylight at the sensor of a plant after a number of regulator steps: a cloudy morning, then
+ * the sun comes out, then dusk and night.
+ */
+static float ambient_get(const struct plant *plant, uint32_t step)
+{
+	float lux = 40.0f + 25.0f * plant->id;
+
+	if (step < 150) {
+		return lux;
+	} else if (step < 300) {
+		return lux + 320.0f;
+	} else if (step < 450) {
+		return lux + 320.0f - 2.4f * (step - 300);
+	}
+
+	return 0.0f;
+}
+
+static void plant_update(struct bt_mesh_light_ctrl_reg *reg, float output)
+{
+	struct plant *plant = reg->user_data;
+	struct engine *engine = plant->engine;
+	int64_t now = k_uptime_ticks();
+
+	/* Regulator steps at the same tick are handled in a single wakeup. */
+	if (now != engine->last_wakeup) {
+		engine->wakeup_cnt++;
+		engine->last_wakeup = now;
+	}
+
+	if (plant->step_cnt < STEP_CNT) {
+		plant->outputs[plant->step_cnt] = output;
+	}
+
+	plant->step_cnt++;
+	plant->lightness = CLAMP(output, 0, UINT16_MAX);
+	reg->measured = ambient_get(plant, plant->step_cnt) +
+			plant->lux_per_lightness * plant->lightness;
+}
+
+static void plant_init(struct engine *engine, int id, struct bt_mesh_light_ctrl_reg *reg)
+{
+	struct plant *plant = &engine->plants[id];
+
+	memset(plant, 0, sizeof(*plant));
+	plant->engine = engine;
+	plant->reg = reg;
+	plant->id = id;
+	plant->lux_per_lightness = 0.008f + 0.002f * id;
+
+	reg->user_data = plant;
+	reg->updated = plant_update;
+	/* Configurations of the Light LC Server, with different upwards and downwards
+	 * coefficients.
+	 */
+	reg->cfg = (struct bt_mesh_light_ctrl_reg_cfg){
+		.ki = { .up = 250.0f - 50.0f * id, .down = 25.0f + 10.0f * id },
+		.kp = { .up = 80.0f, .down = 80.0f - 15.0f * id },
+		.accuracy = 2.0f + id,
+	};
+	reg->measured = ambient_get(plant, 0);
+	reg->init(reg);
+	bt_mesh_light_ctrl_reg_target_set(reg, TARGET_LUX, 0);
+
+	engine->wakeup_cnt = 0;
+	engine->last_wakeup = -1;
+}
+
+static void engines_init(void)
+{
+	for (int i = 0; i < REG_CNT; i++) {
+		plant_init(&float_engine, i, float_reg_get(i));
+		plant_init(&fixed_engine, i, &fixed_regs[i].reg);
+	}
+}
+
+static void engines_start(void)
+{
+	for (int i = 0; i < REG_CNT; i++) {
+		float_engine.plants[i].reg->start(float_engine.plants[i].reg, 0);
+		fixed_engine.plants[i].reg->start(fixed_engine.plants[i].reg, 0);
+		k_sleep(K_MSEC(START_STAGGER_MS));
+	}
+}
+
+static void engines_stop(void)
+{
+	for (int i = 0; i < REG_CNT; i++) {
+		float_engine.plants[i].reg->stop(float_engine.plants[i].reg);
+		fixed_engine.plants[i].reg->stop(fixed_engine.plants[i].reg);
+	}
+}
+
+static uint32_t wakeups_per_sec(const struct engine *engine, uint32_t duration_ms)
+{
+	return engine->wakeup_cnt * MSEC_PER_SEC / duration_ms;
+}
+
+static void reg_before(void *f)
+{
+	ARG_UNUSED(f);
+
+	engines_init();
+}
+
+static void reg_after(void *f)
+{
+	ARG_UNUSED(f);
+
+	engines_stop();
+}
+
+ZTEST(light_ctrl_reg_test, test_closed_loop_trajectory)
+{
+	const uint32_t duration_ms = STEP_CNT * REG_INT;
+	float max_diff = 0.0f;
+	float diff;
+
+	engines_start();
+	k_sleep(K_MSEC(duration_ms));
+	engines_stop();
+
+	for (int i = 0; i < REG_CNT; i++) {
+		struct plant *float_plant = &float_engine.plants[i];
+		struct plant *fixed_plant = &fixed_engine.plants[i];
+
+		zassert_true(float_plant->step_cnt >= STEP_CNT - 1, "Only %u steps",
+			     float_plant->step_cnt);
+		zassert_true(fixed_plant->step_cnt >= STEP_CNT - 1, "Only %u steps",
+			     fixed_plant->step_cnt);
+
+		for (int step = 0; step < MIN(MIN(float_plant->step_cnt, fixed_plant->step_cnt),
+					      STEP_CNT); step++) {
+			diff = fabsf(float_plant->outputs[step] - fixed_plant->outputs[step]);
+			zassert_true(diff <= OUTPUT_TOLERANCE,
+				     "Regulator %d step %d: output %d, expected %d", i, step,
+				     (int)fixed_plant->outputs[step],
+				     (int)float_plant->outputs[step]);
+			max_diff = MAX(max_diff, diff);
+		}
+
+		/* The regulator has settled within the accuracy band after the dusk. */
+		zassert_within(fixed_plant->reg->measured, TARGET_LUX,
+			       TARGET_LUX * fixed_plant->reg->cfg.accuracy / 100.0f);
+	}
+
+	TC_PRINT("Largest output difference: %d.%03d lightness units\n", (int)max_diff,
+		 (int)(max_diff * 1000) % 1000);
+	TC_PRINT("Wakeups per second: %s %u, %s %u\n",
+		 float_engine.name, wakeups_per_sec(&float_engine, duration_ms),
+		 fixed_engine.name, wakeups_per_sec(&fixed_engine, duration_ms));
+
+	/* All fixed-point regulators are stepped in one wakeup per interval. */
+	zassert_true(wakeups_per_sec(&fixed_engine, duration_ms) <= MSEC_PER_SEC / REG_INT + 1);
+	zassert_true(wakeups_per_sec(&float_engine, duration_ms) >=
+		     REG_CNT * (MSEC_PER_SEC / REG_INT) - 1);
+}
+
+ZTEST(light_ctrl_reg_test, test_output_unchanged_in_band)
+{
+	struct plant *plant = &fixed_engine.plants[0];
+	struct bt_mesh_light_ctrl_reg *reg = plant->reg;
+	uint32_t step_cnt;
+	float output;
+
+	reg->start(reg, 0);
+	k_sleep(K_MSEC(140 * REG_INT));
+	zassert_within(reg->measured, TARGET_LUX, TARGET_LUX * reg->cfg.accuracy / 100.0f);
+
+	/* The output is still reported on every step, and stays the same. */
+	output = plant->outputs[plant->step_cnt - 1];
+	step_cnt = plant->step_cnt;
+	k_sleep(K_MSEC(5 * REG_INT));
+	zassert_true(plant->step_cnt >= step_cnt + 4);
+	for (int step = step_cnt; step < plant->step_cnt; step++) {
+		zassert_equal(plant->outputs[step], output);
+	}
+
+	/* A change of the target outside of the accuracy band is followed. */
+	bt_mesh_light_ctrl_reg_target_set(reg, 2 * TARGET_LUX, 0);
+	k_sleep(K_MSEC(2 * REG_INT));
+	zassert_true(plant->outputs[plant->step_cnt - 1] > output);
+}
+
+ZTEST(light_ctrl_reg_test, test_stop)
+{
+	uint32_t step_cnt[REG_CNT];
+
+	for (int i = 0; i < REG_CNT; i++) {
+		fixed_engine.plants[i].reg->start(fixed_engine.plants[i].reg, 0);
+	}
+
+	k_sleep(K_MSEC(10 * REG_INT));
+	fixed_engine.plants[1].reg->stop(fixed_engine.plants[1].reg);
+
+	for (int i = 0; i < REG_CNT; i++) {
+		step_cnt[i] = fixed_engine.plants[i].step_cnt;
+	}
+
+	/* The other regulators keep running. */
+	k_sleep(K_MSEC(10 * REG_INT));
+	for (int i = 0; i < REG_CNT; i++) {
+		if (i == 1) {
+			zassert_equal(fixed_engine.plants[i].step_cnt, step_cnt[i]);
+		} else {
+			zassert_true(fixed_engine.plants[i].step_cnt >= step_cnt[i] + 9);
+		}
+	}
+
+	/* A regulator can be restarted. */
+	fixed_engine.plants[1].reg->start(fixed_engine.plants[1].reg, 0);
+	k_sleep(K_MSEC(10 * REG_INT));
+	zassert_true(fixed_engine.plants[1].step_cnt >= step_cnt[1] + 9);
+
+	for (int i = 0; i < REG_CNT; i++) {
+		fixed_engine.plants[i].reg->stop(fixed_engine.plants[i].reg);
+		step_cnt[i] = fixed_engine.plants[i].step_cnt;
+	}
+
+	/* No steps are run after all regulators have been stopped. */
+	fixed_engine.wakeup_cnt = 0;
+	k_sleep(K_MSEC(10 * REG_INT));
+	zassert_equal(fixed_engine.wakeup_cnt, 0);
+	for (int i = 0; i < REG_CNT; i++) {
+		zassert_equal(fixed_engine.plants[i].step_cnt, step_cnt[i]);
+	}
+}
+
+ZTEST_SUITE(light_ctrl_reg_test, NULL, NULL, reg_before, reg_after, NULL);
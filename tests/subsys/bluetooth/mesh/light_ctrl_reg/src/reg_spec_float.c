@@ -0,0 +1,27 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* Builds the floating point implementation of the specification-defined regulator next to the
+ * fixed-point one under test, so that both can be run in the same closed loop.
+ */
+#undef CONFIG_BT_MESH_LIGHT_CTRL_REG_SPEC_FIXED_POINT
+
+#define bt_mesh_light_ctrl_reg_spec_init float_reg_spec_init
+#define bt_mesh_light_ctrl_reg_spec_start float_reg_spec_start
+#define bt_mesh_light_ctrl_reg_spec_stop float_reg_spec_stop
+
+#include "light_ctrl_reg_spec.c"
+
+#include "reg_spec_float.h"
+
+static struct bt_mesh_light_ctrl_reg_spec float_regs[FLOAT_REG_CNT] = {
+	[0 ... FLOAT_REG_CNT - 1] = BT_MESH_LIGHT_CTRL_REG_SPEC_INIT
+};
+
+struct bt_mesh_light_ctrl_reg *float_reg_get(int idx)
+{
+	return &float_regs[idx].reg;
+}
@@ -0,0 +1,17 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef REG_SPEC_FLOAT_H__
+#define REG_SPEC_FLOAT_H__
+
+#include <bluetooth/mesh/light_ctrl_reg.h>
+
+#define FLOAT_REG_CNT 4
+
+/* Returns an instance of the floating point specification-defined regulator. */
+struct bt_mesh_light_ctrl_reg *float_reg_get(int idx);
+
+#endif /* REG_SPEC_FLOAT_H__ */
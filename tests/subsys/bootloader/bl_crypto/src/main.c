@@ -139,6 +139,30 @@ void test_sha256_string(const uint8_t * input, uint32_t input_len, const uint8_t
 		}
 	}
 
+	/* Hashing in chunks, as when validating while copying, must give the
+	 * same digest as hashing in one go.
+	 */
+	static const uint32_t chunk_lens[] = {1, 3, 63, 64, 65, 512};
+
+	for (size_t i = 0; i < ARRAY_SIZE(chunk_lens); i++) {
+		uint8_t chunked_output[32] = {0};
+
+		rc = bl_sha256_init(&ctx);
+		zassert_equal(0, rc, "bl_sha256_init failed retval was: %d", rc);
+
+		for (uint32_t offset = 0; offset < input_len; offset += chunk_lens[i]) {
+			rc = bl_sha256_update(&ctx, &input[offset],
+					      MIN(chunk_lens[i], input_len - offset));
+			zassert_equal(0, rc, "bl_sha256_update failed retval was: %d", rc);
+		}
+
+		rc = bl_sha256_finalize(&ctx, chunked_output);
+		zassert_equal(0, rc, "bl_sha256_finalize failed retval was: %d", rc);
+		zassert_mem_equal(output, chunked_output, sizeof(output),
+				  "chunked hash differs (run no. %d, chunk %d)", run_count,
+				  chunk_lens[i]);
+	}
+
 	rc = bl_sha256_verify(input, input_len, test_vector);
 
 	int expected_rc = eq ? 0 : -EHASHINV;
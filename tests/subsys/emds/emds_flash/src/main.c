@@ -516,6 +516,55 @@ ZTEST(emds_flash_tests, test_permission)
 
 }
 
+ZTEST(emds_flash_tests, test_background_write)
+{
+	char data_in1[8] = "Deadbee";
+	char data_in2[8] = "Beafded";
+	char data_out[8] = {0};
+
+	flash_clear();
+	device_reset();
+
+	zassert_false(emds_flash_init(&ctx), "Error when initializing");
+	zassert_true(emds_flash_background_write(&ctx, 1, data_in1, sizeof(data_in1)) == -EACCES,
+		     "Should not be able to write before prepare");
+	zassert_false(emds_flash_prepare(&ctx, 2 * (sizeof(data_in1) + ctx.ate_size)),
+		      "Prepare failed");
+
+	zassert_equal(emds_flash_background_write(&ctx, 1, data_in1, sizeof(data_in1)),
+		      sizeof(data_in1), "Error when write");
+	zassert_false(ctx.ate_reserved, "Entry should not be reserved after write");
+	zassert_equal(emds_flash_read(&ctx, 1, data_out, sizeof(data_out)), sizeof(data_out),
+		      "Error when read");
+	zassert_false(memcmp(data_out, data_in1, sizeof(data_out)), "Retrived wrong value");
+
+	/* Simulate a store that interrupts a background write. */
+	uint32_t reserved_ate_addr = ctx.ate_wra;
+
+	ctx.ate_wra -= ctx.ate_size;
+	ctx.data_wra_offset += align_size(sizeof(data_in2));
+	ctx.reserved_ate_addr = reserved_ate_addr;
+	ctx.ate_reserved = true;
+
+	zassert_equal(emds_flash_write(&ctx, 2, data_in2, sizeof(data_in2)), sizeof(data_in2),
+		      "Error when write");
+	zassert_false(ctx.ate_reserved, "Reserved entry should be discarded");
+	zassert_false(flash_cmp_const(reserved_ate_addr, 0, ctx.ate_size),
+		      "Reserved entry not invalidated");
+	zassert_equal(emds_flash_background_write(&ctx, 3, data_in1, sizeof(data_in1)), -EBUSY,
+		      "Background write should fail after store");
+
+	/* Entries written after the discarded one can be found after reboot. */
+	device_reset();
+	zassert_false(emds_flash_init(&ctx), "Error when initializing");
+	zassert_equal(emds_flash_read(&ctx, 2, data_out, sizeof(data_out)), sizeof(data_out),
+		      "Error when read");
+	zassert_false(memcmp(data_out, data_in2, sizeof(data_out)), "Retrived wrong value");
+	zassert_equal(emds_flash_read(&ctx, 1, data_out, sizeof(data_out)), sizeof(data_out),
+		      "Error when read");
+	zassert_false(memcmp(data_out, data_in1, sizeof(data_out)), "Retrived wrong value");
+}
+
 ZTEST(emds_flash_tests, test_overflow)
 {
 	char data_in[8] = "Deadbee";
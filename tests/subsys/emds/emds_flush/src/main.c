@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <stdint.h>
+#include <zephyr/ztest.h>
+#include <emds/emds.h>
+
+#define ENTRY_COUNT 40
+#define ENTRY_LEN   16
+
+static uint8_t d_data[ENTRY_COUNT][ENTRY_LEN];
+static struct emds_dynamic_entry d_entries[ENTRY_COUNT];
+
+static uint8_t s_data[256];
+
+EMDS_STATIC_ENTRY_DEFINE(s_entry, 0x100, s_data, sizeof(s_data));
+
+static void data_fill(uint8_t seed)
+{
+	for (int i = 0; i < ENTRY_COUNT; i++) {
+		memset(d_data[i], seed + i, ENTRY_LEN);
+	}
+
+	memset(s_data, seed, sizeof(s_data));
+}
+
+static void data_check(uint8_t seed)
+{
+	for (int i = 0; i < ENTRY_COUNT; i++) {
+		for (int j = 0; j < ENTRY_LEN; j++) {
+			zassert_equal(d_data[i][j], (uint8_t)(seed + i), "Entry %d has changed", i);
+		}
+	}
+
+	for (int j = 0; j < sizeof(s_data); j++) {
+		zassert_equal(s_data[j], seed, "Static entry has changed");
+	}
+}
+
+static void data_clear(void)
+{
+	memset(d_data, 0, sizeof(d_data));
+	memset(s_data, 0, sizeof(s_data));
+}
+
+static void dirty_set(int count)
+{
+	for (int i = 0; i < count; i++) {
+		d_data[i][0]++;
+	}
+}
+
+static void dirty_clear(int count)
+{
+	for (int i = 0; i < count; i++) {
+		d_data[i][0]--;
+	}
+}
+
+static void flushed_prepare(uint8_t seed)
+{
+	zassert_equal(emds_clear(), 0, "Clear failed");
+	zassert_equal(emds_prepare(), 0, "Prepare failed");
+
+	data_fill(seed);
+
+	/* Entries are written once they have not changed between two flushes. */
+	zassert_equal(emds_flush(), 0, "Flush failed");
+	zassert_equal(emds_flush(), 0, "Flush failed");
+}
+
+static void store_changed(int dirty_percent)
+{
+	int dirty_count = ENTRY_COUNT * dirty_percent / 100;
+	uint32_t flushed_time_us = emds_store_time_current_get();
+	uint32_t estimate_time_us;
+	uint32_t worst_time_us;
+
+	dirty_set(dirty_count);
+
+	estimate_time_us = emds_store_time_current_get();
+	worst_time_us = emds_store_time_get();
+
+	TC_PRINT("Store time with %d%% of entries changed: Estimate %uus, Worst case: %uus\n",
+		 dirty_percent, estimate_time_us, worst_time_us);
+
+	/* Only the entries changed since the flush count towards the store time. */
+	zassert_true(estimate_time_us > flushed_time_us, "Changes not detected");
+	zassert_true(estimate_time_us <= worst_time_us, "Estimate above worst case");
+
+	zassert_equal(emds_store(), 0, "Store failed");
+}
+
+static void *setup(void)
+{
+	zassert_false(emds_init(NULL), "Initializing failed");
+
+	for (int i = 0; i < ENTRY_COUNT; i++) {
+		d_entries[i].entry.id = 0x1000 + i;
+		d_entries[i].entry.data = d_data[i];
+		d_entries[i].entry.len = ENTRY_LEN;
+		zassert_false(emds_entry_add(&d_entries[i]), "Add entry failed");
+	}
+
+	return NULL;
+}
+
+ZTEST(emds_flush, test_reserved_id)
+{
+	static uint8_t data[4];
+	static struct emds_dynamic_entry entry = {{EMDS_FLUSH_MARKER_ID, data, sizeof(data)}};
+
+	zassert_equal(emds_entry_add(&entry), -EINVAL, "Reserved ID accepted");
+}
+
+ZTEST(emds_flush, test_store_5_percent_changed)
+{
+	flushed_prepare(10);
+	store_changed(5);
+
+	data_clear();
+	zassert_equal(emds_load(), 0, "Load failed");
+	dirty_clear(ENTRY_COUNT * 5 / 100);
+	data_check(10);
+}
+
+ZTEST(emds_flush, test_store_all_changed)
+{
+	flushed_prepare(20);
+	store_changed(100);
+
+	data_clear();
+	zassert_equal(emds_load(), 0, "Load failed");
+	dirty_clear(ENTRY_COUNT);
+	data_check(20);
+}
+
+ZTEST(emds_flush, test_flush_without_store)
+{
+	flushed_prepare(30);
+
+	/* Flushed entries are not loaded unless a store has committed them. */
+	data_clear();
+	zassert_equal(emds_load(), 0, "Load failed");
+
+	for (int i = 0; i < ENTRY_COUNT; i++) {
+		zassert_equal(d_data[i][0], 0, "Uncommitted entry %d loaded", i);
+	}
+}
+
+ZTEST(emds_flush, test_flush_reset_after_store)
+{
+	zassert_equal(emds_clear(), 0, "Clear failed");
+	zassert_equal(emds_prepare(), 0, "Prepare failed");
+	data_fill(50);
+	zassert_equal(emds_store(), 0, "Store failed");
+
+	/* Next boot, reset after flushing and before the store. */
+	zassert_equal(emds_prepare(), 0, "Prepare failed");
+	data_fill(60);
+	zassert_equal(emds_flush(), 0, "Flush failed");
+	zassert_equal(emds_flush(), 0, "Flush failed");
+
+	/* The entries of the last store are loaded. */
+	data_clear();
+	zassert_equal(emds_load(), 0, "Load failed");
+	data_check(50);
+}
+
+ZTEST(emds_flush, test_flush_after_store)
+{
+	flushed_prepare(40);
+	zassert_equal(emds_store(), 0, "Store failed");
+	zassert_equal(emds_flush(), -ECANCELED, "Flush should fail after store");
+}
+
+ZTEST_SUITE(emds_flush, NULL, setup, NULL, NULL, NULL);
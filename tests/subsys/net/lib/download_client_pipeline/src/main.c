@@ -0,0 +1,292 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <zephyr/posix/unistd.h>
+#include <zephyr/posix/sys/socket.h>
+#include <zephyr/posix/arpa/inet.h>
+#include <net/download_client.h>
+
+#define SERVER_PORT	4242
+#define SERVER_URL	"http://127.0.0.1:4242"
+#define FILE_NAME	"file.bin"
+#define FILE_SIZE	(32 * 1024)
+/* Time between the arrival of a request at the server and the start of its response */
+#define LATENCY_MS	50
+#define STACK_SIZE	2048
+#define THREAD_PRIO	5
+
+/* A request received by the server, or a marker to close the connection. */
+struct request {
+	int fd;
+	uint32_t start;
+	uint32_t end;
+	int64_t due;
+	bool close;
+};
+
+K_MSGQ_DEFINE(request_queue, sizeof(struct request), 16, 4);
+static K_SEM_DEFINE(server_ready, 0, 1);
+static K_SEM_DEFINE(download_done, 0, 1);
+static K_SEM_DEFINE(download_closed, 0, 1);
+
+static struct download_client client;
+static const struct download_client_cfg config = {
+	.family = AF_INET,
+};
+
+/* Close the connection when the request with this number arrives, 0 to never drop it. */
+static atomic_t drop_at;
+static atomic_t requests;
+static size_t received;
+static bool corrupted;
+static int errors;
+
+static uint8_t file_byte(size_t off)
+{
+	return (uint8_t)(off * 31 + 7);
+}
+
+static int request_parse(const char *req, uint32_t *start, uint32_t *end)
+{
+	const char *range = strstr(req, "Range: bytes=");
+
+	if (!range || sscanf(range, "Range: bytes=%u-%u", start, end) != 2) {
+		return -EBADMSG;
+	}
+
+	*end = MIN(*end, FILE_SIZE - 1);
+
+	return 0;
+}
+
+/* Reads requests as they arrive, possibly several in one read. */
+static void server_reader(void *a, void *b, void *c)
+{
+	int listen_fd;
+	struct sockaddr_in addr = {
+		.sin_family = AF_INET,
+		.sin_port = htons(SERVER_PORT),
+	};
+
+	inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+
+	listen_fd = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	if ((listen_fd < 0) || bind(listen_fd, (struct sockaddr *)&addr, sizeof(addr)) ||
+	    listen(listen_fd, 1)) {
+		printk("Failed to start server, errno %d\n", errno);
+		return;
+	}
+
+	k_sem_give(&server_ready);
+
+	while (true) {
+		char buf[512];
+		size_t len = 0;
+		char *hdr_end;
+		struct request req = {0};
+
+		req.fd = accept(listen_fd, NULL, NULL);
+		if (req.fd < 0) {
+			continue;
+		}
+
+		while (true) {
+			ssize_t n = recv(req.fd, buf + len, sizeof(buf) - 1 - len, 0);
+
+			if (n <= 0) {
+				break;
+			}
+
+			len += n;
+			buf[len] = '\0';
+
+			while ((hdr_end = strstr(buf, "\r\n\r\n")) != NULL) {
+				hdr_end += strlen("\r\n\r\n");
+
+				if (atomic_inc(&requests) + 1 == atomic_get(&drop_at)) {
+					/* Drop the connection with requests in flight */
+					goto close;
+				}
+
+				if (request_parse(buf, &req.start, &req.end) == 0) {
+					req.due = k_uptime_get() + LATENCY_MS;
+					k_msgq_put(&request_queue, &req, K_FOREVER);
+				}
+
+				len -= hdr_end - buf;
+				memmove(buf, hdr_end, len + 1);
+			}
+		}
+
+close:
+		/* The writer owns the connection, it is closed after the responses
+		 * to the requests that have been queued.
+		 */
+		req.close = true;
+		k_msgq_put(&request_queue, &req, K_FOREVER);
+	}
+}
+
+static void send_all(int fd, const char *buf, size_t len)
+{
+	while (len) {
+		ssize_t sent = send(fd, buf, len, 0);
+
+		if (sent < 0) {
+			return;
+		}
+
+		buf += sent;
+		len -= sent;
+	}
+}
+
+/* Sends the responses back to back, each after the latency has elapsed. */
+static void server_writer(void *a, void *b, void *c)
+{
+	struct request req;
+	char buf[256];
+	int len;
+
+	while (k_msgq_get(&request_queue, &req, K_FOREVER) == 0) {
+		if (req.close) {
+			(void)close(req.fd);
+			continue;
+		}
+
+		k_sleep(K_TIMEOUT_ABS_MS(req.due));
+
+		len = snprintf(buf, sizeof(buf),
+			       "HTTP/1.1 206 Partial Content\r\n"
+			       "Content-Range: bytes %u-%u/%u\r\n"
+			       "Content-Length: %u\r\n"
+			       "Connection: keep-alive\r\n"
+			       "\r\n",
+			       req.start, req.end, FILE_SIZE, req.end - req.start + 1);
+		send_all(req.fd, buf, len);
+
+		for (uint32_t off = req.start; off <= req.end; off += sizeof(buf)) {
+			len = MIN(sizeof(buf), req.end - off + 1);
+
+			for (int i = 0; i < len; i++) {
+				buf[i] = file_byte(off + i);
+			}
+
+			send_all(req.fd, buf, len);
+		}
+	}
+}
+
+K_THREAD_DEFINE(server_reader_tid, STACK_SIZE, server_reader, NULL, NULL, NULL, THREAD_PRIO, 0,
+		0);
+K_THREAD_DEFINE(server_writer_tid, STACK_SIZE, server_writer, NULL, NULL, NULL, THREAD_PRIO, 0,
+		0);
+
+static int download_client_callback(const struct download_client_evt *event)
+{
+	switch (event->id) {
+	case DOWNLOAD_CLIENT_EVT_FRAGMENT:
+		for (size_t i = 0; i < event->fragment.len; i++) {
+			if (((const uint8_t *)event->fragment.buf)[i] != file_byte(received + i)) {
+				corrupted = true;
+			}
+		}
+		received += event->fragment.len;
+		break;
+	case DOWNLOAD_CLIENT_EVT_ERROR:
+		/* Resume the download */
+		errors++;
+		break;
+	case DOWNLOAD_CLIENT_EVT_DONE:
+		k_sem_give(&download_done);
+		break;
+	case DOWNLOAD_CLIENT_EVT_CLOSED:
+		k_sem_give(&download_closed);
+		break;
+	default:
+		break;
+	}
+
+	return 0;
+}
+
+static int64_t download(void)
+{
+	int64_t start;
+	int err;
+
+	received = 0;
+	corrupted = false;
+	errors = 0;
+	atomic_set(&requests, 0);
+
+	start = k_uptime_get();
+
+	err = download_client_start(&client, FILE_NAME, 0);
+	zassert_ok(err, "Failed to start download: %d", err);
+	zassert_ok(k_sem_take(&download_done, K_SECONDS(60)), "Download timed out");
+
+	zassert_false(corrupted, "Received data is corrupted");
+	zassert_equal(received, FILE_SIZE, "Received %zu bytes", received);
+
+	return k_uptime_get() - start;
+}
+
+static void *suite_setup(void)
+{
+	zassert_ok(k_sem_take(&server_ready, K_SECONDS(5)), "Server not started");
+	zassert_ok(download_client_init(&client, download_client_callback));
+
+	return NULL;
+}
+
+static void test_before(void *f)
+{
+	atomic_set(&drop_at, 0);
+	zassert_ok(download_client_set_host(&client, SERVER_URL, &config));
+}
+
+static void test_after(void *f)
+{
+	/* Each test starts on a new connection */
+	zassert_ok(download_client_disconnect(&client));
+	zassert_ok(k_sem_take(&download_closed, K_SECONDS(5)), "Client not closed");
+}
+
+ZTEST_SUITE(download_client_pipeline, NULL, suite_setup, test_before, test_after, NULL);
+
+ZTEST(download_client_pipeline, test_throughput)
+{
+	const size_t fragments = DIV_ROUND_UP(FILE_SIZE, CONFIG_DOWNLOAD_CLIENT_HTTP_FRAG_SIZE);
+	int64_t elapsed = download();
+
+	TC_PRINT("Pipeline depth %d: %d bytes in %lld ms, %lld bytes/s, %ld requests\n",
+		 CONFIG_DOWNLOAD_CLIENT_HTTP_PIPELINE_DEPTH, FILE_SIZE, elapsed,
+		 (FILE_SIZE * 1000LL) / MAX(elapsed, 1), atomic_get(&requests));
+
+	zassert_equal(errors, 0, "Unexpected errors");
+	zassert_equal(atomic_get(&requests), fragments, "Unexpected number of requests");
+
+	if (CONFIG_DOWNLOAD_CLIENT_HTTP_PIPELINE_DEPTH > 1) {
+		/* Only the first request waits for a whole round trip alone */
+		zassert_true(elapsed < fragments * LATENCY_MS, "No gain from pipelining");
+	}
+}
+
+ZTEST(download_client_pipeline, test_resume_after_drop)
+{
+	/* Drop the connection while requests are in flight */
+	atomic_set(&drop_at, 4);
+
+	(void)download();
+
+	zassert_equal(errors, 1, "Expected one error for the dropped connection");
+}
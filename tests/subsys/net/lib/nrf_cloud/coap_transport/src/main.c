@@ -0,0 +1,300 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <unity.h>
+#include <stdlib.h>
+#include <zephyr/kernel.h>
+#include <zephyr/net/coap.h>
+#include <zephyr/net/coap_client.h>
+
+#include "cmock_coap_client.h"
+
+#include "nrf_cloud_codec_internal.h"
+#include "nrf_cloud_mem.h"
+#include "nrfc_dtls.h"
+#include "nrf_cloud_coap_transport.h"
+
+#define SERVER_RTT_MS 200
+#define REQUEST_COUNT 8
+#define NSTART CONFIG_NRF_CLOUD_COAP_NSTART
+
+/* Stand-in for the CoAP server and the CoAP client: each request gets its response
+ * after SERVER_RTT_MS, and at most CONFIG_COAP_CLIENT_MAX_REQUESTS requests are held.
+ */
+static struct server_req {
+	struct k_work_delayable work;
+	struct coap_client_request req;
+	bool in_use;
+} server_reqs[CONFIG_COAP_CLIENT_MAX_REQUESTS];
+
+static int16_t server_result_code = COAP_RESPONSE_CODE_CHANGED;
+static atomic_t server_max_outstanding;
+static atomic_t server_outstanding;
+
+static void server_respond(struct k_work *work)
+{
+	struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+	struct server_req *sreq = CONTAINER_OF(dwork, struct server_req, work);
+	struct coap_client_request req = sreq->req;
+
+	sreq->in_use = false;
+	atomic_dec(&server_outstanding);
+
+	req.cb(server_result_code, 0, NULL, 0, true, req.user_data);
+}
+
+static int coap_client_req_stub(struct coap_client *client, int sock,
+				const struct sockaddr *addr, struct coap_client_request *req,
+				struct coap_transmission_parameters *params, int cmock_num_calls)
+{
+	atomic_val_t outstanding;
+
+	for (int i = 0; i < ARRAY_SIZE(server_reqs); i++) {
+		if (!server_reqs[i].in_use) {
+			server_reqs[i].in_use = true;
+			server_reqs[i].req = *req;
+
+			outstanding = atomic_inc(&server_outstanding) + 1;
+			if (outstanding > atomic_get(&server_max_outstanding)) {
+				atomic_set(&server_max_outstanding, outstanding);
+			}
+
+			k_work_schedule(&server_reqs[i].work, K_MSEC(SERVER_RTT_MS));
+			return 0;
+		}
+	}
+
+	return -EAGAIN;
+}
+
+/* Dependencies of the unit under test, not used by the tests. */
+int nrfc_dtls_setup(int sock)
+{
+	return 0;
+}
+
+bool nrfc_dtls_cid_is_active(int sock)
+{
+	return false;
+}
+
+int nrfc_dtls_session_save(int sock)
+{
+	return 0;
+}
+
+int nrfc_dtls_session_load(int sock)
+{
+	return 0;
+}
+
+void *nrf_cloud_malloc(size_t size)
+{
+	return malloc(size);
+}
+
+void nrf_cloud_free(void *memory)
+{
+	free(memory);
+}
+
+int nrf_cloud_jwt_generate(uint32_t time_valid_s, char * const jwt_buf, size_t jwt_buf_sz)
+{
+	return -ENOTSUP;
+}
+
+int nrf_cloud_codec_init(struct nrf_cloud_os_mem_hooks *hooks)
+{
+	return 0;
+}
+
+int nrf_cloud_obj_init(struct nrf_cloud_obj *const obj)
+{
+	return -ENOTSUP;
+}
+
+int nrf_cloud_obj_free(struct nrf_cloud_obj *const obj)
+{
+	return 0;
+}
+
+int nrf_cloud_obj_cloud_encode(struct nrf_cloud_obj *const obj)
+{
+	return -ENOTSUP;
+}
+
+int nrf_cloud_obj_cloud_encoded_free(struct nrf_cloud_obj *const obj)
+{
+	return 0;
+}
+
+int nrf_cloud_enabled_info_sections_json_encode(cJSON * const obj, const char * const app_ver)
+{
+	return -ENODEV;
+}
+
+int nrf_cloud_coap_shadow_state_update(const char * const shadow_json)
+{
+	return -ENOTSUP;
+}
+
+void nrf_cloud_device_control_get(struct nrf_cloud_ctrl_data *const ctrl)
+{
+}
+
+int nrf_cloud_shadow_control_response_encode(struct nrf_cloud_ctrl_data const *const data,
+					     bool accept,
+					     struct nrf_cloud_data *const output)
+{
+	return -ENOTSUP;
+}
+
+static K_SEM_DEFINE(done_sem, 0, REQUEST_COUNT);
+static int done_result;
+
+static void request_done(int result, void *user)
+{
+	ARG_UNUSED(user);
+
+	done_result = result;
+	k_sem_give(&done_sem);
+}
+
+static int async_post(bool reliable, nrf_cloud_coap_done_cb_t done_cb)
+{
+	static const uint8_t payload[] = "{\"appId\":\"TEMP\",\"data\":\"21.5\"}";
+
+	return nrf_cloud_coap_async_req(COAP_METHOD_POST, "msg/d2c", NULL,
+					payload, sizeof(payload) - 1,
+					COAP_CONTENT_FORMAT_APP_JSON, COAP_CONTENT_FORMAT_APP_JSON,
+					false, reliable, NULL, done_cb, NULL);
+}
+
+void setUp(void)
+{
+	for (int i = 0; i < ARRAY_SIZE(server_reqs); i++) {
+		k_work_init_delayable(&server_reqs[i].work, server_respond);
+		server_reqs[i].in_use = false;
+	}
+
+	server_result_code = COAP_RESPONSE_CODE_CHANGED;
+	atomic_set(&server_outstanding, 0);
+	atomic_set(&server_max_outstanding, 0);
+	done_result = 0;
+	k_sem_reset(&done_sem);
+
+	__cmock_coap_client_req_Stub(coap_client_req_stub);
+}
+
+void tearDown(void)
+{
+}
+
+void test_blocking_requests_are_serialized(void)
+{
+	static const uint8_t payload[] = "{\"appId\":\"TEMP\",\"data\":\"21.5\"}";
+	int64_t start = k_uptime_get();
+	int64_t elapsed;
+	int err;
+
+	for (int i = 0; i < REQUEST_COUNT; i++) {
+		err = nrf_cloud_coap_post("msg/d2c", NULL, payload, sizeof(payload) - 1,
+					  COAP_CONTENT_FORMAT_APP_JSON, true, NULL, NULL);
+		TEST_ASSERT_EQUAL(0, err);
+	}
+
+	elapsed = k_uptime_get() - start;
+	printk("%d blocking requests: %lld ms\n", REQUEST_COUNT, elapsed);
+
+	TEST_ASSERT_EQUAL(1, atomic_get(&server_max_outstanding));
+	TEST_ASSERT_GREATER_OR_EQUAL(REQUEST_COUNT * SERVER_RTT_MS, elapsed);
+}
+
+void test_async_requests_are_pipelined(void)
+{
+	int64_t start = k_uptime_get();
+	int64_t elapsed;
+	int completed = 0;
+	int queued = 0;
+	int err;
+
+	while (queued < REQUEST_COUNT) {
+		err = async_post(true, request_done);
+		if (err == -EAGAIN) {
+			/* NSTART reached, wait for a request to complete. */
+			TEST_ASSERT_EQUAL(0, k_sem_take(&done_sem, K_SECONDS(10)));
+			completed++;
+			continue;
+		}
+		TEST_ASSERT_EQUAL(0, err);
+		queued++;
+	}
+
+	while (completed < REQUEST_COUNT) {
+		TEST_ASSERT_EQUAL(0, k_sem_take(&done_sem, K_SECONDS(10)));
+		completed++;
+	}
+
+	elapsed = k_uptime_get() - start;
+	printk("%d pipelined requests, NSTART %d: %lld ms\n", REQUEST_COUNT, NSTART, elapsed);
+
+	TEST_ASSERT_EQUAL(NSTART, atomic_get(&server_max_outstanding));
+	TEST_ASSERT_LESS_THAN(REQUEST_COUNT * SERVER_RTT_MS, elapsed);
+	TEST_ASSERT_EQUAL(0, done_result);
+}
+
+void test_async_nstart_limit(void)
+{
+	for (int i = 0; i < NSTART; i++) {
+		TEST_ASSERT_EQUAL(0, async_post(true, request_done));
+	}
+
+	TEST_ASSERT_EQUAL(-EAGAIN, async_post(true, request_done));
+
+	for (int i = 0; i < NSTART; i++) {
+		TEST_ASSERT_EQUAL(0, k_sem_take(&done_sem, K_SECONDS(10)));
+	}
+
+	/* Contexts are released again once the requests complete. */
+	TEST_ASSERT_EQUAL(0, async_post(true, request_done));
+	TEST_ASSERT_EQUAL(0, k_sem_take(&done_sem, K_SECONDS(10)));
+}
+
+void test_async_non_fire_and_forget(void)
+{
+	for (int i = 0; i < NSTART; i++) {
+		TEST_ASSERT_EQUAL(0, async_post(false, NULL));
+	}
+
+	/* Nobody waits for the requests, but they still complete. */
+	k_sleep(K_MSEC(2 * SERVER_RTT_MS));
+
+	TEST_ASSERT_EQUAL(0, atomic_get(&server_outstanding));
+	TEST_ASSERT_EQUAL(0, async_post(false, request_done));
+	TEST_ASSERT_EQUAL(0, k_sem_take(&done_sem, K_SECONDS(10)));
+}
+
+void test_async_non_bad_result(void)
+{
+	server_result_code = COAP_RESPONSE_CODE_BAD_REQUEST;
+
+	TEST_ASSERT_EQUAL(0, async_post(false, request_done));
+	TEST_ASSERT_EQUAL(0, k_sem_take(&done_sem, K_SECONDS(10)));
+	TEST_ASSERT_EQUAL(COAP_RESPONSE_CODE_BAD_REQUEST, done_result);
+}
+
+/* It is required to be added to each test. That is because unity's
+ * main may return nonzero, while zephyr's main currently must
+ * return 0 in all cases (other values are reserved).
+ */
+extern int unity_main(void);
+
+int main(void)
+{
+	(void)unity_main();
+
+	return 0;
+}
@@ -0,0 +1,20 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef FLASH_MAP_PM_H_
+#define FLASH_MAP_PM_H_
+
+#include <zephyr/device.h>
+
+/* All flash areas are the simulated flash of the test. */
+extern const struct device sim_flash_dev;
+
+#undef FLASH_AREA_ID
+#undef FLASH_AREA_DEVICE
+#define FLASH_AREA_ID(label) 0
+#define FLASH_AREA_DEVICE(label) (&sim_flash_dev)
+
+#endif /* FLASH_MAP_PM_H_ */
@@ -0,0 +1,500 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/fff.h>
+#include <zephyr/ztest.h>
+#include <zephyr/settings/settings.h>
+
+#include "nrf_cloud_pgps.c"
+
+DEFINE_FFF_GLOBALS;
+
+#define SIM_FLASH_BASE		0x80000
+#define PERIOD_SEC		(PREDICTION_PERIOD * SEC_PER_MIN)
+#define START_GPS_DAY		16000
+#define START_GPS_SEC		((int64_t)START_GPS_DAY * SEC_PER_DAY)
+
+FAKE_VALUE_FUNC(int, date_time_now, int64_t *);
+FAKE_VALUE_FUNC(int, nrf_cloud_agnss_process, const char *, size_t);
+FAKE_VOID_FUNC(nrf_cloud_agnss_processed, struct nrf_modem_gnss_agnss_data_frame *);
+FAKE_VALUE_FUNC(int, download_client_init, struct download_client *, download_client_callback_t);
+FAKE_VALUE_FUNC(int, download_client_disconnect, struct download_client *);
+FAKE_VALUE_FUNC(int, nrf_cloud_download_start, struct nrf_cloud_download_data *const);
+FAKE_VOID_FUNC(nrf_cloud_download_end);
+FAKE_VALUE_FUNC(enum nfsm_state, nfsm_get_current_state);
+FAKE_VALUE_FUNC(int, flash_area_open, uint8_t, const struct flash_area **);
+FAKE_VALUE_FUNC(int, flash_area_read, const struct flash_area *, off_t, void *, size_t);
+FAKE_VALUE_FUNC(int, stream_flash_init, struct stream_flash_ctx *, const struct device *,
+		uint8_t *, size_t, size_t, size_t, stream_flash_callback_t);
+FAKE_VALUE_FUNC(int, stream_flash_buffered_write, struct stream_flash_ctx *, const uint8_t *,
+		size_t, bool);
+
+const struct device sim_flash_dev = {
+	.name = "sim_flash",
+};
+
+/* Simulated flash holding the predictions */
+static uint8_t sim_flash[NUM_BLOCKS * BLOCK_SIZE];
+static const struct flash_area sim_flash_area = {
+	.fa_off = SIM_FLASH_BASE,
+	.fa_size = sizeof(sim_flash),
+	.fa_dev = &sim_flash_dev,
+};
+
+static int64_t gps_now;
+
+/* Snapshot of the state rebuilt from the stored predictions at initialization */
+struct pgps_snapshot {
+	enum pgps_state state;
+	struct nrf_cloud_pgps_prediction *predictions[NUM_PREDICTIONS];
+	int num_free;
+	int next_block;
+	uint8_t cur_pnum;
+	uint8_t pnum_offset;
+	uint16_t expected_count;
+	bool partial_request;
+};
+
+static int fake_date_time_now(int64_t *unix_time_ms)
+{
+	*unix_time_ms = (gps_now + GPS_TO_UNIX_UTC_OFFSET_SECONDS - GPS_TO_UTC_LEAP_SECONDS) *
+			MSEC_PER_SEC;
+	return 0;
+}
+
+static int fake_flash_area_open(uint8_t id, const struct flash_area **fa)
+{
+	*fa = &sim_flash_area;
+	return 0;
+}
+
+static int fake_flash_area_read(const struct flash_area *fa, off_t off, void *dst, size_t len)
+{
+	zassert_true(off + len <= sizeof(sim_flash), "Read out of simulated flash");
+	memcpy(dst, &sim_flash[off], len);
+	return 0;
+}
+
+static int fake_stream_flash_init(struct stream_flash_ctx *ctx, const struct device *fdev,
+				  uint8_t *buf, size_t buf_len, size_t offset, size_t size,
+				  stream_flash_callback_t cb)
+{
+	memset(ctx, 0, sizeof(*ctx));
+	ctx->fdev = fdev;
+	ctx->buf = buf;
+	ctx->buf_len = buf_len;
+	ctx->offset = offset;
+	ctx->available = size;
+	ctx->callback = cb;
+	return 0;
+}
+
+static void sim_flash_program(struct stream_flash_ctx *ctx)
+{
+	size_t off = ctx->offset + ctx->bytes_written - SIM_FLASH_BASE;
+
+	zassert_true(off + ctx->buf_bytes <= sizeof(sim_flash), "Write out of simulated flash");
+	memcpy(&sim_flash[off], ctx->buf, ctx->buf_bytes);
+	ctx->bytes_written += ctx->buf_bytes;
+	ctx->buf_bytes = 0;
+}
+
+/* Data stays in the write buffer until a full page is collected or it is flushed,
+ * as with the real stream_flash.
+ */
+static int fake_stream_flash_buffered_write(struct stream_flash_ctx *ctx, const uint8_t *data,
+					    size_t len, bool flush)
+{
+	while (len) {
+		size_t chunk = MIN(len, ctx->buf_len - ctx->buf_bytes);
+
+		memcpy(ctx->buf + ctx->buf_bytes, data, chunk);
+		ctx->buf_bytes += chunk;
+		data += chunk;
+		len -= chunk;
+
+		if (ctx->buf_bytes == ctx->buf_len) {
+			sim_flash_program(ctx);
+		}
+	}
+
+	if (flush && ctx->buf_bytes) {
+		sim_flash_program(ctx);
+	}
+	return 0;
+}
+
+/* RAM settings backend */
+struct ram_setting {
+	char name[SETTINGS_MAX_NAME_LEN + 1];
+	uint8_t value[256];
+	size_t len;
+};
+
+static struct ram_setting ram_settings[8];
+/* Number of times the catalog has been written */
+static uint32_t catalog_saves;
+
+static ssize_t ram_setting_read(void *cb_arg, void *data, size_t len)
+{
+	struct ram_setting *setting = cb_arg;
+
+	len = MIN(len, setting->len);
+	memcpy(data, setting->value, len);
+	return len;
+}
+
+static int ram_settings_load(struct settings_store *cs, const struct settings_load_arg *arg)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(ram_settings); i++) {
+		if (ram_settings[i].len) {
+			settings_call_set_handler(ram_settings[i].name, ram_settings[i].len,
+						  ram_setting_read, &ram_settings[i], arg);
+		}
+	}
+	return 0;
+}
+
+static struct ram_setting *ram_setting_find(const char *name)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(ram_settings); i++) {
+		if (ram_settings[i].len && !strcmp(ram_settings[i].name, name)) {
+			return &ram_settings[i];
+		}
+	}
+	return NULL;
+}
+
+static int ram_settings_save(struct settings_store *cs, const char *name, const char *value,
+			     size_t val_len)
+{
+	struct ram_setting *setting = ram_setting_find(name);
+
+	if (!value || !val_len) {
+		if (setting) {
+			setting->len = 0;
+		}
+		return 0;
+	}
+
+	if (!setting) {
+		for (size_t i = 0; !setting && i < ARRAY_SIZE(ram_settings); i++) {
+			if (!ram_settings[i].len) {
+				setting = &ram_settings[i];
+			}
+		}
+	}
+	if (!setting || val_len > sizeof(setting->value)) {
+		return -ENOMEM;
+	}
+
+	if (!strcmp(name, "nrf_cloud_pgps/catalog")) {
+		catalog_saves++;
+	}
+
+	strncpy(setting->name, name, sizeof(setting->name) - 1);
+	memcpy(setting->value, value, val_len);
+	setting->len = val_len;
+	return 0;
+}
+
+static const struct settings_store_itf ram_settings_itf = {
+	.csi_load = ram_settings_load,
+	.csi_save = ram_settings_save,
+};
+
+static struct settings_store ram_settings_store = {
+	.cs_itf = &ram_settings_itf,
+};
+
+int settings_backend_init(void)
+{
+	settings_dst_register(&ram_settings_store);
+	settings_src_register(&ram_settings_store);
+	return 0;
+}
+
+static void set_gps_time(int64_t gps_sec)
+{
+	gps_now = gps_sec;
+}
+
+/* Simulates a reset of the device followed by initialization of P-GPS. */
+static int reboot(void)
+{
+	struct nrf_cloud_pgps_init_param param = {
+		.storage_base = SIM_FLASH_BASE,
+		.storage_size = sizeof(sim_flash),
+	};
+
+	(void)k_timer_stop(&prediction_timer);
+	npgps_download_unlock();
+	state = PGPS_NONE;
+	flash_area_read_fake.call_count = 0;
+
+	return nrf_cloud_pgps_init(&param);
+}
+
+static void take_snapshot(struct pgps_snapshot *snapshot)
+{
+	memset(snapshot, 0, sizeof(*snapshot));
+	snapshot->state = state;
+	memcpy(snapshot->predictions, index.predictions, sizeof(snapshot->predictions));
+	snapshot->num_free = npgps_num_free();
+	snapshot->cur_pnum = index.cur_pnum;
+	snapshot->pnum_offset = index.pnum_offset;
+	snapshot->expected_count = index.expected_count;
+	snapshot->partial_request = index.partial_request;
+
+	/* where the next download would be stored */
+	snapshot->next_block = npgps_alloc_block();
+	if (snapshot->next_block != NO_BLOCK) {
+		npgps_undo_alloc_block(snapshot->next_block);
+	}
+}
+
+static void assert_snapshots_equal(const struct pgps_snapshot *a, const struct pgps_snapshot *b)
+{
+	zassert_equal(a->state, b->state);
+	zassert_mem_equal(a->predictions, b->predictions, sizeof(a->predictions));
+	zassert_equal(a->num_free, b->num_free);
+	zassert_equal(a->next_block, b->next_block);
+	zassert_equal(a->cur_pnum, b->cur_pnum);
+	zassert_equal(a->pnum_offset, b->pnum_offset);
+	zassert_equal(a->expected_count, b->expected_count);
+	zassert_equal(a->partial_request, b->partial_request);
+}
+
+/* Prediction as received from the cloud, without schema version and sentinel */
+static void make_prediction(uint8_t *buf, int64_t gps_sec)
+{
+	struct nrf_cloud_pgps_prediction p = {
+		.time_type = NRF_CLOUD_AGNSS_GPS_SYSTEM_CLOCK,
+		.time_count = 1,
+		.ephemeris_type = NRF_CLOUD_AGNSS_GPS_EPHEMERIDES,
+		.ephemeris_count = NRF_CLOUD_PGPS_NUM_SV,
+	};
+	size_t schema_offset = offsetof(struct nrf_cloud_pgps_prediction, schema_version);
+	uint16_t day;
+	uint32_t time;
+
+	npgps_gps_sec_to_day_time(gps_sec, &day, &time);
+	p.time.date_day = day;
+	p.time.time_full_s = time;
+
+	for (int i = 0; i < NRF_CLOUD_PGPS_NUM_SV; i++) {
+		p.ephemerii[i].sv_id = i + 1;
+		p.ephemerii[i].toe = (uint16_t)(gps_sec / 16);
+	}
+
+	memcpy(buf, &p, schema_offset);
+	memcpy(buf + schema_offset, (uint8_t *)&p + schema_offset + PGPS_SCHEMA_SIZE,
+	       PGPS_PREDICTION_DL_SIZE - schema_offset);
+}
+
+/* Answers the pending request for predictions, storing the first 'count' of them. */
+static void load_predictions(int count, bool finish)
+{
+	static uint8_t buf[PGPS_PREDICTION_DL_SIZE];
+	struct nrf_cloud_pgps_header header = {
+		.schema_version = NRF_CLOUD_PGPS_BIN_SCHEMA_VERSION,
+		.array_type = NRF_CLOUD_PGPS_PREDICTION_HEADER,
+		.num_items = 1,
+		.prediction_count = index.expected_count,
+		.prediction_size = PGPS_PREDICTION_DL_SIZE,
+		.prediction_period_min = PREDICTION_PERIOD,
+	};
+	int64_t start_sec = START_GPS_SEC;
+	uint16_t day;
+	uint32_t time;
+
+	zassert_equal(state, PGPS_REQUESTING, "No predictions requested");
+
+	if (index.partial_request) {
+		start_sec = index.start_sec + (int64_t)index.pnum_offset * PERIOD_SEC;
+	}
+	npgps_gps_sec_to_day_time(start_sec, &day, &time);
+	header.gps_day = day;
+	header.gps_time_of_day = time;
+
+	zassert_ok(nrf_cloud_pgps_begin_update());
+	zassert_ok(nrf_cloud_pgps_process_update((uint8_t *)&header, sizeof(header)));
+
+	for (int i = 0; i < count; i++) {
+		make_prediction(buf, start_sec + (int64_t)i * PERIOD_SEC);
+		zassert_ok(nrf_cloud_pgps_process_update(buf, sizeof(buf)));
+	}
+
+	if (finish) {
+		zassert_equal(state, PGPS_READY, "Not all predictions loaded");
+		zassert_ok(nrf_cloud_pgps_finish_update());
+	}
+}
+
+/* Initializes from the catalog and then from a full scan of the stored
+ * predictions, and checks that both give the same result.
+ */
+static void check_catalog_against_scan(struct pgps_snapshot *snapshot)
+{
+	struct pgps_snapshot scanned;
+	uint32_t catalog_reads;
+	uint32_t scan_reads;
+
+	(void)reboot();
+	take_snapshot(snapshot);
+	catalog_reads = flash_area_read_fake.call_count;
+
+	zassert_ok(npgps_catalog_invalidate());
+	(void)reboot();
+	take_snapshot(&scanned);
+	scan_reads = flash_area_read_fake.call_count;
+
+	TC_PRINT("Flash reads at init: %u with catalog, %u with scan\n",
+		 catalog_reads, scan_reads);
+
+	assert_snapshots_equal(snapshot, &scanned);
+	/* only the current prediction is read when the catalog is used */
+	zassert_true(catalog_reads <= 1, "%u reads with catalog", catalog_reads);
+	zassert_true(scan_reads >= index.header.prediction_count, "%u reads with scan",
+		     scan_reads);
+
+	/* the scan saved a new catalog */
+	(void)reboot();
+	take_snapshot(&scanned);
+	assert_snapshots_equal(snapshot, &scanned);
+	zassert_true(flash_area_read_fake.call_count <= 1);
+}
+
+static void *suite_setup(void)
+{
+	zassert_ok(settings_subsys_init());
+	return NULL;
+}
+
+static void test_before(void *f)
+{
+	RESET_FAKE(date_time_now);
+	RESET_FAKE(flash_area_open);
+	RESET_FAKE(flash_area_read);
+	RESET_FAKE(stream_flash_init);
+	RESET_FAKE(stream_flash_buffered_write);
+	FFF_RESET_HISTORY();
+
+	date_time_now_fake.custom_fake = fake_date_time_now;
+	flash_area_open_fake.custom_fake = fake_flash_area_open;
+	flash_area_read_fake.custom_fake = fake_flash_area_read;
+	stream_flash_init_fake.custom_fake = fake_stream_flash_init;
+	stream_flash_buffered_write_fake.custom_fake = fake_stream_flash_buffered_write;
+
+	memset(sim_flash, 0xff, sizeof(sim_flash));
+	memset(ram_settings, 0, sizeof(ram_settings));
+	set_gps_time(START_GPS_SEC + SEC_PER_HOUR);
+
+	/* nothing stored; all predictions are requested */
+	zassert_ok(reboot());
+}
+
+ZTEST_SUITE(nrf_cloud_pgps_catalog, NULL, suite_setup, test_before, NULL, NULL);
+
+ZTEST(nrf_cloud_pgps_catalog, test_full_set)
+{
+	struct pgps_snapshot snapshot;
+
+	catalog_saves = 0;
+	load_predictions(NUM_PREDICTIONS, true);
+	/* the catalog is written once per download */
+	zassert_equal(catalog_saves, 1, "Catalog written %u times", catalog_saves);
+
+	check_catalog_against_scan(&snapshot);
+	zassert_equal(snapshot.state, PGPS_READY);
+	zassert_equal(snapshot.num_free, 0);
+	for (int pnum = 0; pnum < NUM_PREDICTIONS; pnum++) {
+		zassert_not_null(snapshot.predictions[pnum]);
+	}
+}
+
+ZTEST(nrf_cloud_pgps_catalog, test_interrupted_download)
+{
+	struct pgps_snapshot snapshot;
+
+	/* the last prediction is still in the flash write buffer when the device resets */
+	catalog_saves = 0;
+	load_predictions(5, false);
+	zassert_equal(catalog_saves, 0, "Catalog written during the download");
+
+	/* no catalog is saved for an incomplete download; the predictions are scanned */
+	(void)reboot();
+	zassert_true(flash_area_read_fake.call_count >= 4, "Catalog was used");
+
+	check_catalog_against_scan(&snapshot);
+	zassert_equal(snapshot.state, PGPS_REQUESTING);
+	zassert_true(snapshot.partial_request);
+	zassert_equal(snapshot.pnum_offset, 4);
+	zassert_equal(snapshot.expected_count, NUM_PREDICTIONS - 4);
+}
+
+ZTEST(nrf_cloud_pgps_catalog, test_preemptive_update)
+{
+	struct pgps_snapshot snapshot;
+	int64_t start_sec;
+	int discarded;
+
+	load_predictions(NUM_PREDICTIONS, true);
+
+	/* oldest predictions expired; they are discarded and replaced */
+	set_gps_time(START_GPS_SEC + 5 * PERIOD_SEC - SEC_PER_HOUR);
+	(void)reboot();
+	zassert_equal(state, PGPS_REQUESTING);
+	zassert_true(index.partial_request);
+	discarded = index.expected_count;
+	zassert_true(discarded >= NUM_PREDICTIONS - REPLACEMENT_THRESHOLD);
+	start_sec = index.start_sec;
+
+	load_predictions(discarded, true);
+
+	check_catalog_against_scan(&snapshot);
+	zassert_equal(snapshot.state, PGPS_READY);
+	zassert_equal(snapshot.num_free, 0);
+	zassert_equal(index.start_sec, start_sec);
+}
+
+ZTEST(nrf_cloud_pgps_catalog, test_corrupted_catalog)
+{
+	struct pgps_snapshot snapshot;
+	struct pgps_snapshot scanned;
+	struct ram_setting *setting;
+
+	load_predictions(NUM_PREDICTIONS, true);
+	(void)reboot();
+	take_snapshot(&snapshot);
+
+	setting = ram_setting_find("nrf_cloud_pgps/catalog");
+	zassert_not_null(setting);
+	setting->value[setting->len / 2] ^= 0x01;
+
+	(void)reboot();
+	take_snapshot(&scanned);
+	assert_snapshots_equal(&snapshot, &scanned);
+	zassert_true(flash_area_read_fake.call_count >= NUM_PREDICTIONS,
+		     "Corrupted catalog was used");
+}
+
+ZTEST(nrf_cloud_pgps_catalog, test_corrupted_prediction)
+{
+	load_predictions(NUM_PREDICTIONS, true);
+
+	/* change an ephemeris of the current prediction behind the catalog's back */
+	sim_flash[offsetof(struct nrf_cloud_pgps_prediction, ephemerii)] ^= 0x01;
+
+	zassert_ok(reboot());
+	zassert_equal(state, PGPS_REQUESTING, "Corrupted prediction was used");
+
+	/* the catalog is not used again */
+	(void)reboot();
+	zassert_true(flash_area_read_fake.call_count >= NUM_PREDICTIONS);
+}
@@ -0,0 +1,19 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef NRFX_NVMC_H__
+#define NRFX_NVMC_H__
+
+#include <stdint.h>
+
+#define SIM_FLASH_PAGE_SIZE 4096
+
+static inline uint32_t nrfx_nvmc_flash_page_size_get(void)
+{
+	return SIM_FLASH_PAGE_SIZE;
+}
+
+#endif /* NRFX_NVMC_H__ */
@@ -69,6 +69,7 @@ static uint32_t test_performance_core(void (*profiler_func)(struct log_event_buf
 	uint32_t start_time;
 	uint32_t elapsed_ticks;
 	uint32_t elapsed_time_us;
+	uint32_t dropped = nrf_profiler_dropped_events_count();
 
 	/* Profiling no data event */
 	start_time = k_cycle_get_32();
@@ -83,6 +84,12 @@ static uint32_t test_performance_core(void (*profiler_func)(struct log_event_buf
 	}
 	elapsed_ticks = k_cycle_get_32() - start_time;
 	elapsed_time_us = k_cyc_to_us_near32(elapsed_ticks);
+
+	printk("Per-event overhead [cycles]: %u\n", elapsed_ticks / PROFILED_EVENTS_NB);
+	if (IS_ENABLED(CONFIG_NRF_PROFILER_NORDIC_STAGING)) {
+		printk("Dropped events: %u\n", nrf_profiler_dropped_events_count() - dropped);
+	}
+
 	return elapsed_time_us;
 }
 
@@ -120,4 +127,27 @@ ZTEST(suite_nrf_profiler, test_performance_03)
 	       "Elapsed time [us]: %d\n", PROFILED_EVENTS_NB, elapsed_time_us);
 }
 
+ZTEST(suite_nrf_profiler, test_staging_overflow_04)
+{
+	uint32_t dropped = nrf_profiler_dropped_events_count();
+
+	if (!IS_ENABLED(CONFIG_NRF_PROFILER_NORDIC_STAGING) ||
+	    IS_ENABLED(CONFIG_NRF_PROFILER_NORDIC_STAGING_BLOCK)) {
+		ztest_test_skip();
+	}
+
+	/* Wait until previously profiled events are passed to the transport. */
+	k_sleep(K_MSEC(10 * CONFIG_NRF_PROFILER_NORDIC_STAGING_DRAIN_INTERVAL_MS));
+
+	/* The staged events are not drained until the test thread sleeps, as the
+	 * nrf_profiler thread has lower priority. Overflowing the ring buffer must
+	 * not be fatal.
+	 */
+	(void)test_performance_core(profile_data_event, data_event_id);
+
+	zassert_equal(nrf_profiler_dropped_events_count() - dropped,
+		      PROFILED_EVENTS_NB - CONFIG_NRF_PROFILER_NORDIC_STAGING_SLOTS,
+		      "Unexpected number of dropped events");
+}
+
 ZTEST_SUITE(suite_nrf_profiler, NULL, test_init, NULL, NULL, NULL);
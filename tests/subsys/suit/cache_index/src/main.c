@@ -0,0 +1,196 @@
+/*
+ * Copyright (c) 2024 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <stdio.h>
+#include <zephyr/ztest.h>
+#include <zephyr/sys/byteorder.h>
+#include <suit_dfu_cache.h>
+
+#define MAX_SLOTS	 128
+#define URI_FORMAT	 "http://payload.com/%03u"
+#define URI_LENGTH	 (sizeof("http://payload.com/000") - 1)
+#define PAYLOAD_SIZE	 sizeof(uint32_t)
+/* tstr header + URI + bstr header with 4-byte length + payload */
+#define SLOT_SIZE	 (1 + URI_LENGTH + 5 + PAYLOAD_SIZE)
+#define BENCHMARK_ROUNDS 100
+
+/* Indefinite map header + slots + end marker */
+static uint8_t cache[1 + (MAX_SLOTS + 1) * SLOT_SIZE + 1];
+
+static void uri_get(unsigned int n, char *uri)
+{
+	snprintf(uri, URI_LENGTH + 1, URI_FORMAT, n);
+}
+
+static uint8_t *slot_add(uint8_t *pos, unsigned int n, uint32_t value)
+{
+	*pos++ = 0x60 + URI_LENGTH;
+	uri_get(n, (char *)pos);
+	pos += URI_LENGTH;
+
+	*pos++ = 0x5A;
+	sys_put_be32(PAYLOAD_SIZE, pos);
+	pos += sizeof(uint32_t);
+
+	sys_put_le32(value, pos);
+	pos += PAYLOAD_SIZE;
+
+	return pos;
+}
+
+/* Build a cache with the given number of slots, with the slot number as payload, and initialize
+ * the SUIT cache with it.
+ */
+static void cache_setup(size_t slots, bool duplicate_last)
+{
+	struct dfu_cache dfu_caches = {0};
+	uint8_t *pos = cache;
+
+	zassert_true(slots <= MAX_SLOTS, "Too many slots");
+
+	suit_dfu_cache_deinitialize();
+
+	*pos++ = 0xBF;
+
+	for (unsigned int i = 0; i < slots; i++) {
+		pos = slot_add(pos, i, i);
+	}
+
+	if (duplicate_last) {
+		/* Same URI as the last slot, different payload. */
+		pos = slot_add(pos, slots - 1, UINT32_MAX);
+	}
+
+	*pos++ = 0xFF;
+
+	dfu_caches.pools[0].address = cache;
+	dfu_caches.pools[0].size = pos - cache;
+	dfu_caches.pools_count = 1;
+
+	zassert_equal(suit_dfu_cache_initialize(&dfu_caches), SUIT_PLAT_SUCCESS,
+		      "Failed to initialize cache");
+}
+
+static suit_plat_err_t search(const char *uri, size_t uri_size, const uint8_t **payload,
+			      size_t *payload_size)
+{
+	return suit_dfu_cache_search((const uint8_t *)uri, uri_size, payload, payload_size);
+}
+
+static void search_check(unsigned int n)
+{
+	char uri[URI_LENGTH + 1];
+	const uint8_t *payload = NULL;
+	size_t payload_size = 0;
+
+	uri_get(n, uri);
+
+	zassert_equal(search(uri, sizeof(uri), &payload, &payload_size),
+		      SUIT_PLAT_SUCCESS, "Slot %u not found", n);
+	zassert_equal(payload_size, PAYLOAD_SIZE, "Invalid payload size");
+	zassert_equal(sys_get_le32(payload), n, "Invalid payload");
+}
+
+static uint32_t search_time(const char *uri, size_t uri_size)
+{
+	const uint8_t *payload;
+	size_t payload_size;
+	uint32_t start = k_cycle_get_32();
+
+	for (size_t i = 0; i < BENCHMARK_ROUNDS; i++) {
+		(void)search(uri, uri_size, &payload, &payload_size);
+	}
+
+	return (k_cycle_get_32() - start) / BENCHMARK_ROUNDS;
+}
+
+static void test_after(void *f)
+{
+	suit_dfu_cache_deinitialize();
+}
+
+ZTEST_SUITE(cache_index_tests, NULL, NULL, NULL, test_after, NULL);
+
+ZTEST(cache_index_tests, test_search_all_slots)
+{
+	const unsigned int counts[] = {1, 16, MAX_SLOTS};
+
+	for (size_t i = 0; i < ARRAY_SIZE(counts); i++) {
+		cache_setup(counts[i], false);
+
+		for (unsigned int n = 0; n < counts[i]; n++) {
+			search_check(n);
+		}
+	}
+}
+
+ZTEST(cache_index_tests, test_search_miss)
+{
+	const uint8_t *payload = NULL;
+	size_t payload_size = 0;
+	char uri[URI_LENGTH + 1];
+
+	cache_setup(16, false);
+	uri_get(16, uri);
+
+	zassert_equal(search(uri, sizeof(uri), &payload, &payload_size),
+		      SUIT_PLAT_ERR_NOT_FOUND, "Missing slot found");
+
+	/* A prefix of a cached URI. */
+	zassert_equal(search(uri, URI_LENGTH - 1, &payload, &payload_size),
+		      SUIT_PLAT_ERR_NOT_FOUND, "URI prefix found");
+}
+
+ZTEST(cache_index_tests, test_search_first_match)
+{
+	cache_setup(16, true);
+
+	/* The first slot with the URI is returned, as when walking the cache. */
+	search_check(15);
+}
+
+ZTEST(cache_index_tests, test_search_after_reinitialize)
+{
+	const uint8_t *payload = NULL;
+	size_t payload_size = 0;
+	char uri[URI_LENGTH + 1];
+
+	cache_setup(MAX_SLOTS, false);
+	search_check(MAX_SLOTS - 1);
+
+	cache_setup(1, false);
+	uri_get(MAX_SLOTS - 1, uri);
+
+	zassert_equal(search(uri, sizeof(uri), &payload, &payload_size),
+		      SUIT_PLAT_ERR_NOT_FOUND, "Stale slot found");
+	search_check(0);
+}
+
+ZTEST(cache_index_tests, test_search_benchmark)
+{
+	const unsigned int counts[] = {1, 16, MAX_SLOTS};
+	char uri[URI_LENGTH + 1];
+
+	TC_PRINT("Index size: %d\n", CONFIG_SUIT_CACHE_INDEX_SIZE);
+
+	for (size_t i = 0; i < ARRAY_SIZE(counts); i++) {
+		uint32_t first;
+		uint32_t last;
+		uint32_t miss;
+
+		cache_setup(counts[i], false);
+
+		uri_get(0, uri);
+		first = search_time(uri, sizeof(uri));
+		uri_get(counts[i] - 1, uri);
+		last = search_time(uri, sizeof(uri));
+		uri_get(MAX_SLOTS, uri);
+		miss = search_time(uri, sizeof(uri));
+
+		TC_PRINT("%3u slots: first %u, last %u, miss %u cycles per search\n", counts[i],
+			 first, last, miss);
+	}
+}